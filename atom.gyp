@@ -5,6 +5,9 @@
     ],
     'project_name%': 'atom',
     'product_name%': 'Atom',
+    # The order file written by tools/asar_layout.py, which lays out atom.asar
+    # in the order its files are read at startup.
+    'atom_asar_layout%': '',
     'app_sources': [
       'atom/app/atom_main.cc',
       'atom/app/atom_main.h',
@@ -18,6 +21,7 @@
       'atom/browser/api/lib/auto-updater.coffee',
       'atom/browser/api/lib/browser-window.coffee',
       'atom/browser/api/lib/content-tracing.coffee',
+      'atom/browser/api/lib/desktop-capturer.coffee',
       'atom/browser/api/lib/dialog.coffee',
       'atom/browser/api/lib/global-shortcut.coffee',
       'atom/browser/api/lib/ipc.coffee',
@@ -28,7 +32,9 @@
       'atom/browser/api/lib/screen.coffee',
       'atom/browser/api/lib/tray.coffee',
       'atom/browser/api/lib/web-contents.coffee',
+      'atom/browser/api/lib/worker.coffee',
       'atom/browser/lib/chrome-extension.coffee',
+      'atom/browser/lib/fork-pool.coffee',
       'atom/browser/lib/guest-view-manager.coffee',
       'atom/browser/lib/guest-window-manager.coffee',
       'atom/browser/lib/init.coffee',
@@ -38,9 +44,11 @@
       'atom/common/api/lib/clipboard.coffee',
       'atom/common/api/lib/crash-reporter.coffee',
       'atom/common/api/lib/id-weak-map.coffee',
+      'atom/common/api/lib/logger.coffee',
       'atom/common/api/lib/native-image.coffee',
       'atom/common/api/lib/original-fs.coffee',
       'atom/common/api/lib/shell.coffee',
+      'atom/common/lib/code-cache.coffee',
       'atom/common/lib/init.coffee',
       'atom/renderer/lib/chrome-api.coffee',
       'atom/renderer/lib/init.coffee',
@@ -50,7 +58,9 @@
       'atom/renderer/lib/web-view/web-view.coffee',
       'atom/renderer/lib/web-view/web-view-attributes.coffee',
       'atom/renderer/lib/web-view/web-view-constants.coffee',
+      'atom/renderer/api/lib/content-tracing.coffee',
       'atom/renderer/api/lib/ipc.coffee',
+      'atom/renderer/api/lib/node-worker.coffee',
       'atom/renderer/api/lib/remote.coffee',
       'atom/renderer/api/lib/screen.coffee',
       'atom/renderer/api/lib/web-frame.coffee',
@@ -74,6 +84,8 @@
       'atom/browser/api/atom_api_auto_updater.cc',
       'atom/browser/api/atom_api_auto_updater.h',
       'atom/browser/api/atom_api_content_tracing.cc',
+      'atom/browser/api/atom_api_desktop_capturer.cc',
+      'atom/browser/api/atom_api_desktop_capturer.h',
       'atom/browser/api/atom_api_dialog.cc',
       'atom/browser/api/atom_api_global_shortcut.cc',
       'atom/browser/api/atom_api_global_shortcut.h',
@@ -96,10 +108,17 @@
       'atom/browser/api/atom_api_web_view_manager.cc',
       'atom/browser/api/atom_api_window.cc',
       'atom/browser/api/atom_api_window.h',
+      'atom/browser/api/atom_api_worker.cc',
+      'atom/browser/api/atom_api_worker.h',
+      'atom/browser/api/atom_api_worker_channel.cc',
       'atom/browser/api/event.cc',
       'atom/browser/api/event.h',
       'atom/browser/api/event_emitter.cc',
       'atom/browser/api/event_emitter.h',
+      'atom/browser/api/frame_subscriber.cc',
+      'atom/browser/api/frame_subscriber.h',
+      'atom/browser/asar_header_message_filter.cc',
+      'atom/browser/asar_header_message_filter.h',
       'atom/browser/auto_updater.cc',
       'atom/browser/auto_updater.h',
       'atom/browser/auto_updater_delegate.h',
@@ -128,12 +147,26 @@
       'atom/browser/browser_mac.mm',
       'atom/browser/browser_win.cc',
       'atom/browser/browser_observer.h',
+      'atom/browser/delta_updater.cc',
+      'atom/browser/delta_updater.h',
+      'atom/browser/desktop_media_list.cc',
+      'atom/browser/desktop_media_list.h',
+      'atom/browser/frame_stats_recorder.cc',
+      'atom/browser/frame_stats_recorder.h',
+      'atom/browser/geolocation_position_cache.cc',
+      'atom/browser/geolocation_position_cache.h',
+      'atom/browser/jank_watchdog.cc',
+      'atom/browser/jank_watchdog.h',
       'atom/browser/javascript_environment.cc',
       'atom/browser/javascript_environment.h',
       'atom/browser/mac/atom_application.h',
       'atom/browser/mac/atom_application.mm',
       'atom/browser/mac/atom_application_delegate.h',
       'atom/browser/mac/atom_application_delegate.mm',
+      'atom/browser/media_device_cache.cc',
+      'atom/browser/media_device_cache.h',
+      'atom/browser/message_port_message_filter.cc',
+      'atom/browser/message_port_message_filter.h',
       'atom/browser/native_window.cc',
       'atom/browser/native_window.h',
       'atom/browser/native_window_views.cc',
@@ -149,12 +182,38 @@
       'atom/browser/net/asar/url_request_asar_job.h',
       'atom/browser/net/atom_url_request_job_factory.cc',
       'atom/browser/net/atom_url_request_job_factory.h',
+      'atom/browser/net/file_mapping_protocol_handler.cc',
+      'atom/browser/net/file_mapping_protocol_handler.h',
+      'atom/browser/net/network_observer.cc',
+      'atom/browser/net/network_observer.h',
+      'atom/browser/net/offline_store_protocol_handler.cc',
+      'atom/browser/net/offline_store_protocol_handler.h',
+      'atom/browser/net/preconnect.cc',
+      'atom/browser/net/preconnect.h',
+      'atom/browser/net/protocol_response_cache.cc',
+      'atom/browser/net/protocol_response_cache.h',
+      'atom/browser/net/protocol_worker.cc',
+      'atom/browser/net/protocol_worker.h',
       'atom/browser/net/url_request_string_job.cc',
       'atom/browser/net/url_request_string_job.h',
       'atom/browser/net/url_request_buffer_job.cc',
       'atom/browser/net/url_request_buffer_job.h',
+      'atom/browser/net/url_request_stream_job.cc',
+      'atom/browser/net/url_request_stream_job.h',
+      'atom/browser/net/worker_protocol_handler.cc',
+      'atom/browser/net/worker_protocol_handler.h',
       'atom/browser/node_debugger.cc',
       'atom/browser/node_debugger.h',
+      'atom/browser/power_policy.cc',
+      'atom/browser/power_policy.h',
+      'atom/browser/print_to_pdf_manager.cc',
+      'atom/browser/print_to_pdf_manager.h',
+      'atom/browser/process_metrics_collector.cc',
+      'atom/browser/process_metrics_collector.h',
+      'atom/browser/renderer_process_pool.cc',
+      'atom/browser/renderer_process_pool.h',
+      'atom/browser/script_worker.cc',
+      'atom/browser/script_worker.h',
       'atom/browser/ui/accelerator_util.cc',
       'atom/browser/ui/accelerator_util.h',
       'atom/browser/ui/accelerator_util_mac.mm',
@@ -163,10 +222,14 @@
       'atom/browser/ui/cocoa/atom_menu_controller.mm',
       'atom/browser/ui/cocoa/event_processing_window.h',
       'atom/browser/ui/cocoa/event_processing_window.mm',
+      'atom/browser/ui/draggable_region_index.cc',
+      'atom/browser/ui/draggable_region_index.h',
       'atom/browser/ui/file_dialog.h',
       'atom/browser/ui/file_dialog_gtk.cc',
       'atom/browser/ui/file_dialog_mac.mm',
       'atom/browser/ui/file_dialog_win.cc',
+      'atom/browser/ui/menu_model_observer.cc',
+      'atom/browser/ui/menu_model_observer.h',
       'atom/browser/ui/message_box.h',
       'atom/browser/ui/message_box_mac.mm',
       'atom/browser/ui/message_box_views.cc',
@@ -207,19 +270,31 @@
       'atom/browser/window_list.cc',
       'atom/browser/window_list.h',
       'atom/browser/window_list_observer.h',
+      'atom/browser/window_pool.cc',
+      'atom/browser/window_pool.h',
+      'atom/browser/worker_channel.cc',
+      'atom/browser/worker_channel.h',
+      'atom/browser/worker_channel_message_filter.cc',
+      'atom/browser/worker_channel_message_filter.h',
+      'atom/browser/worker_host.cc',
+      'atom/browser/worker_host.h',
       'atom/common/api/api_messages.h',
       'atom/common/api/atom_api_asar.cc',
       'atom/common/api/atom_api_clipboard.cc',
       'atom/common/api/atom_api_crash_reporter.cc',
       'atom/common/api/atom_api_id_weak_map.cc',
       'atom/common/api/atom_api_id_weak_map.h',
+      'atom/common/api/atom_api_logger.cc',
       'atom/common/api/atom_api_native_image.cc',
       'atom/common/api/atom_api_native_image.h',
       'atom/common/api/atom_api_native_image_mac.mm',
       'atom/common/api/atom_api_shell.cc',
+      'atom/common/api/atom_api_trace_event.cc',
       'atom/common/api/atom_api_v8_util.cc',
       'atom/common/api/atom_bindings.cc',
       'atom/common/api/atom_bindings.h',
+      'atom/common/api/channel_name_cache.cc',
+      'atom/common/api/channel_name_cache.h',
       'atom/common/api/object_life_monitor.cc',
       'atom/common/api/object_life_monitor.h',
       'atom/common/asar/archive.cc',
@@ -228,8 +303,14 @@
       'atom/common/asar/asar_util.h',
       'atom/common/asar/scoped_temporary_file.cc',
       'atom/common/asar/scoped_temporary_file.h',
+      'atom/common/async_logger.cc',
+      'atom/common/async_logger.h',
+      'atom/common/code_cache.cc',
+      'atom/common/code_cache.h',
       'atom/common/common_message_generator.cc',
       'atom/common/common_message_generator.h',
+      'atom/common/crash_reporter/breadcrumbs.cc',
+      'atom/common/crash_reporter/breadcrumbs.h',
       'atom/common/crash_reporter/crash_reporter.cc',
       'atom/common/crash_reporter/crash_reporter.h',
       'atom/common/crash_reporter/crash_reporter_linux.cc',
@@ -248,6 +329,8 @@
       'atom/common/draggable_region.h',
       'atom/common/google_api_key.h',
       'atom/common/linux/application_info.cc',
+      'atom/common/loop_stats.cc',
+      'atom/common/loop_stats.h',
       'atom/common/native_mate_converters/accelerator_converter.cc',
       'atom/common/native_mate_converters/accelerator_converter.h',
       'atom/common/native_mate_converters/file_path_converter.h',
@@ -259,6 +342,8 @@
       'atom/common/native_mate_converters/string16_converter.h',
       'atom/common/native_mate_converters/v8_value_converter.cc',
       'atom/common/native_mate_converters/v8_value_converter.h',
+      'atom/common/native_mate_converters/v8_value_serializer.cc',
+      'atom/common/native_mate_converters/v8_value_serializer.h',
       'atom/common/native_mate_converters/value_converter.cc',
       'atom/common/native_mate_converters/value_converter.h',
       'atom/common/node_bindings.cc',
@@ -273,20 +358,32 @@
       'atom/common/options_switches.cc',
       'atom/common/options_switches.h',
       'atom/common/platform_util.h',
+      'atom/common/purge_memory.cc',
+      'atom/common/purge_memory.h',
       'atom/common/platform_util_linux.cc',
       'atom/common/platform_util_mac.mm',
       'atom/common/platform_util_win.cc',
+      'atom/common/ring_buffer.cc',
+      'atom/common/ring_buffer.h',
+      'atom/common/startup_timings.cc',
+      'atom/common/startup_timings.h',
       'atom/renderer/api/atom_api_renderer_ipc.cc',
       'atom/renderer/api/atom_api_spell_check_client.cc',
       'atom/renderer/api/atom_api_spell_check_client.h',
       'atom/renderer/api/atom_api_web_frame.cc',
       'atom/renderer/api/atom_api_web_frame.h',
+      'atom/renderer/atom_render_frame_observer.cc',
+      'atom/renderer/atom_render_frame_observer.h',
       'atom/renderer/atom_render_view_observer.cc',
       'atom/renderer/atom_render_view_observer.h',
       'atom/renderer/atom_renderer_client.cc',
       'atom/renderer/atom_renderer_client.h',
       'atom/renderer/guest_view_container.cc',
       'atom/renderer/guest_view_container.h',
+      'atom/renderer/renderer_message_port.cc',
+      'atom/renderer/renderer_message_port.h',
+      'atom/renderer/spell_check_dictionary.cc',
+      'atom/renderer/spell_check_dictionary.h',
       'chromium_src/chrome/browser/browser_process.cc',
       'chromium_src/chrome/browser/browser_process.h',
       'chromium_src/chrome/browser/chrome_notification_types.h',
@@ -298,6 +395,8 @@
       'chromium_src/chrome/browser/extensions/global_shortcut_listener_x11.h',
       'chromium_src/chrome/browser/extensions/global_shortcut_listener_win.cc',
       'chromium_src/chrome/browser/extensions/global_shortcut_listener_win.h',
+      'chromium_src/chrome/browser/printing/pdf_to_emf_converter_win.cc',
+      'chromium_src/chrome/browser/printing/pdf_to_emf_converter_win.h',
       'chromium_src/chrome/browser/printing/print_job.cc',
       'chromium_src/chrome/browser/printing/print_job.h',
       'chromium_src/chrome/browser/printing/print_job_manager.cc',
@@ -574,6 +673,8 @@
         'vendor/node/src',
         'vendor/node/deps/http_parser',
         'vendor/node/deps/uv/include',
+        # Include zlib.h, which is built into node.
+        'vendor/node/deps/zlib',
         # The `node.h` is using `#include"v8.h"`.
         'vendor/brightray/vendor/download/libchromiumcontent/src/v8/include',
         # The `node.h` is using `#include"ares.h"`.
@@ -663,6 +764,7 @@
           'action': [
             'python',
             'tools/coffee2asar.py',
+            '--layout=<(atom_asar_layout)',
             '<@(_outputs)',
             '<@(_inputs)',
           ],
@@ -792,6 +894,49 @@
         }],  # OS=="linux"
       ],
     },  # target <(project_name>_dump_symbols
+    {
+      'target_name': '<(project_name)_code_cache',
+      'type': 'none',
+      'dependencies': [
+        '<(project_name)',
+      ],
+      'actions': [
+        {
+          'action_name': 'Generate Code Cache',
+          'variables': {
+            'conditions': [
+              ['OS=="mac"', {
+                'atom_binary': '<(PRODUCT_DIR)/<(product_name).app/Contents/MacOS/<(product_name)',
+                'resources_path': '<(PRODUCT_DIR)/<(product_name).app/Contents/Resources',
+              }],
+              ['OS=="win"', {
+                'atom_binary': '<(PRODUCT_DIR)/<(project_name).exe',
+                'resources_path': '<(PRODUCT_DIR)/resources',
+              }],
+              ['OS=="linux"', {
+                'atom_binary': '<(PRODUCT_DIR)/<(project_name)',
+                'resources_path': '<(PRODUCT_DIR)/resources',
+              }],
+            ],
+          },
+          'inputs': [
+            '<(atom_binary)',
+            '<(resources_path)/atom.asar',
+            'tools/code_cache/index.html',
+            'tools/code_cache/main.js',
+          ],
+          'outputs': [
+            '<(resources_path)/code-cache',
+          ],
+          'action': [
+            'python',
+            'tools/generate_code_cache.py',
+            '--binary=<(atom_binary)',
+            '--cache-dir=<(resources_path)/code-cache',
+          ],
+        },
+      ],
+    },  # target <(project_name)_code_cache
     {
       'target_name': 'copy_chromedriver',
       'type': 'none',
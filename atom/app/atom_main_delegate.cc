@@ -4,17 +4,21 @@
 
 #include "atom/app/atom_main_delegate.h"
 
+#include <algorithm>
 #include <string>
+#include <vector>
 
 #include "atom/app/atom_content_client.h"
 #include "atom/browser/atom_browser_client.h"
 #include "atom/common/google_api_key.h"
+#include "atom/common/startup_timings.h"
 #include "atom/renderer/atom_renderer_client.h"
 #include "base/command_line.h"
 #include "base/debug/stack_trace.h"
 #include "base/environment.h"
 #include "base/logging.h"
 #include "content/public/common/content_switches.h"
+#include "ui/base/layout.h"
 #include "ui/base/resource/resource_bundle.h"
 
 namespace atom {
@@ -26,6 +30,8 @@ AtomMainDelegate::~AtomMainDelegate() {
 }
 
 bool AtomMainDelegate::BasicStartupComplete(int* exit_code) {
+  StartupTimings::GetInstance()->Record("basic-startup-complete");
+
   // Disable logging out to debug.log on Windows
   logging::LoggingSettings settings;
 #if defined(OS_WIN)
@@ -52,6 +58,8 @@ bool AtomMainDelegate::BasicStartupComplete(int* exit_code) {
 }
 
 void AtomMainDelegate::PreSandboxStartup() {
+  StartupTimings::GetInstance()->Record("pre-sandbox-startup");
+
   brightray::MainDelegate::PreSandboxStartup();
 
   // Set google API key.
@@ -101,6 +109,14 @@ scoped_ptr<brightray::ContentClient> AtomMainDelegate::CreateContentClient() {
 void AtomMainDelegate::AddDataPackFromPath(
     ui::ResourceBundle* bundle, const base::FilePath& pak_dir) {
 #if defined(OS_WIN)
+  // The 200% resources are only used on high DPI displays, don't map them
+  // otherwise.
+  const std::vector<ui::ScaleFactor>& scale_factors =
+      ui::GetSupportedScaleFactors();
+  if (std::find(scale_factors.begin(), scale_factors.end(),
+                ui::SCALE_FACTOR_200P) == scale_factors.end())
+    return;
+
   bundle->AddDataPackFromPath(
       pak_dir.Append(FILE_PATH_LITERAL("ui_resources_200_percent.pak")),
       ui::SCALE_FACTOR_200P);
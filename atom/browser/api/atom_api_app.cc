@@ -4,12 +4,19 @@
 
 #include "atom/browser/api/atom_api_app.h"
 
+#include <algorithm>
 #include <string>
 #include <vector>
 
 #include "atom/browser/api/atom_api_menu.h"
 #include "atom/browser/atom_browser_context.h"
 #include "atom/browser/browser.h"
+#include "atom/browser/jank_watchdog.h"
+#include "atom/browser/net/network_observer.h"
+#include "atom/browser/net/preconnect.h"
+#include "atom/browser/power_policy.h"
+#include "atom/browser/process_metrics_collector.h"
+#include "atom/browser/renderer_process_pool.h"
 #include "atom/common/native_mate_converters/file_path_converter.h"
 #include "atom/common/native_mate_converters/gurl_converter.h"
 #include "base/command_line.h"
@@ -17,6 +24,9 @@
 #include "base/files/file_path.h"
 #include "base/path_service.h"
 #include "brightray/browser/brightray_paths.h"
+#include "chrome/browser/browser_process.h"
+#include "chrome/browser/printing/print_job_manager.h"
+#include "content/public/browser/browser_thread.h"
 #include "native_mate/callback.h"
 #include "native_mate/dictionary.h"
 #include "native_mate/object_template_builder.h"
@@ -28,6 +38,7 @@
 #include "atom/common/node_includes.h"
 
 using atom::Browser;
+using content::BrowserThread;
 
 namespace mate {
 
@@ -52,6 +63,67 @@ struct Converter<Browser::UserTask> {
 };
 #endif
 
+template<>
+struct Converter<atom::JankWatchdog::Report> {
+  static v8::Handle<v8::Value> ToV8(v8::Isolate* isolate,
+                                    const atom::JankWatchdog::Report& val) {
+    mate::Dictionary dict(isolate, v8::Object::New(isolate));
+    dict.Set("time", val.time.ToJsTime());
+    dict.Set("duration", val.duration.InMillisecondsF());
+    dict.Set("postedFrom", val.posted_from);
+    dict.Set("jsStack", val.js_stack);
+    dict.Set("nativeStack", val.native_stack);
+    return dict.GetHandle();
+  }
+};
+
+template<>
+struct Converter<atom::ProcessMetricsCollector::Metrics> {
+  static v8::Handle<v8::Value> ToV8(
+      v8::Isolate* isolate,
+      const atom::ProcessMetricsCollector::Metrics& val) {
+    mate::Dictionary dict(isolate, v8::Object::New(isolate));
+    dict.Set("processId", val.process_id);
+    dict.Set("pid", static_cast<int>(val.pid));
+    if (val.guest_instance_id != -1)
+      dict.Set("guestInstanceId", val.guest_instance_id);
+    dict.Set("workingSetSize", static_cast<double>(val.working_set_size));
+    dict.Set("privateBytes", static_cast<double>(val.private_bytes));
+    dict.Set("cpuUsage", val.cpu_usage);
+    if (val.has_heap_stats) {
+      dict.Set("heapUsed", static_cast<double>(val.heap_used));
+      dict.Set("heapTotal", static_cast<double>(val.heap_total));
+    }
+    return dict.GetHandle();
+  }
+};
+
+template<>
+struct Converter<atom::NetworkObserver::RequestMetrics> {
+  static v8::Handle<v8::Value> ToV8(
+      v8::Isolate* isolate,
+      const atom::NetworkObserver::RequestMetrics& val) {
+    mate::Dictionary dict(isolate, v8::Object::New(isolate));
+    dict.Set("url", val.url);
+    dict.Set("method", val.method);
+    dict.Set("resourceType", val.resource_type);
+    dict.Set("processId", val.process_id);
+    dict.Set("frameRoutingId", val.frame_routing_id);
+    dict.Set("statusCode", val.status_code);
+    dict.Set("error", val.error);
+    dict.Set("wasCached", val.was_cached);
+    dict.Set("socketReused", val.socket_reused);
+    dict.Set("startTime", val.start_time.ToJsTime());
+    dict.Set("dnsTime", val.dns_time);
+    dict.Set("connectTime", val.connect_time);
+    dict.Set("sslTime", val.ssl_time);
+    dict.Set("timeToFirstByte", val.time_to_first_byte);
+    dict.Set("totalTime", val.total_time);
+    dict.Set("receivedBytes", static_cast<double>(val.received_bytes));
+    return dict.GetHandle();
+  }
+};
+
 }  // namespace mate
 
 
@@ -61,6 +133,9 @@ namespace api {
 
 namespace {
 
+// Chrome does not keep more than 6 sockets to one host.
+const int kMaxPreconnectSockets = 6;
+
 // Return the path constant from string.
 int GetPathConstant(const std::string& name) {
   if (name == "appData")
@@ -159,6 +234,13 @@ void App::OnActivateWithNoOpenWindows() {
   Emit("activate-with-no-open-windows");
 }
 
+void App::OnMemoryPressure(
+    base::MemoryPressureListener::MemoryPressureLevel level) {
+  bool critical =
+      level == base::MemoryPressureListener::MEMORY_PRESSURE_LEVEL_CRITICAL;
+  Emit("memory-pressure", critical ? "critical" : "moderate");
+}
+
 void App::OnWillFinishLaunching() {
   Emit("will-finish-launching");
 }
@@ -193,6 +275,31 @@ void App::ResolveProxy(const GURL& url, ResolveProxyCallback callback) {
   new ResolveProxyHelper(url, callback);
 }
 
+void App::Preconnect(const GURL& url, int num_sockets) {
+  scoped_refptr<net::URLRequestContextGetter> getter =
+      AtomBrowserContext::Get()->url_request_context_getter();
+  BrowserThread::PostTask(
+      BrowserThread::IO, FROM_HERE,
+      base::Bind(&PreconnectOnIOThread, getter, url,
+                 std::min(std::max(num_sockets, 1), kMaxPreconnectSockets)));
+}
+
+void App::PrefetchDNS(const std::vector<std::string>& hosts) {
+  scoped_refptr<net::URLRequestContextGetter> getter =
+      AtomBrowserContext::Get()->url_request_context_getter();
+  BrowserThread::PostTask(
+      BrowserThread::IO, FROM_HERE,
+      base::Bind(&PrefetchDNSOnIOThread, getter, hosts));
+}
+
+void App::SetZoomLevelForHost(const std::string& host, double level) {
+  AtomBrowserContext::Get()->SetZoomLevelForHost(host, level);
+}
+
+double App::GetZoomLevelForHost(const std::string& host) {
+  return AtomBrowserContext::Get()->GetZoomLevelForHost(host);
+}
+
 void App::SetDesktopName(const std::string& desktop_name) {
 #if defined(OS_LINUX)
   scoped_ptr<base::Environment> env(base::Environment::Create());
@@ -200,6 +307,61 @@ void App::SetDesktopName(const std::string& desktop_name) {
 #endif
 }
 
+void App::SetRendererProcessPoolSize(int size) {
+  RendererProcessPool::GetInstance()->SetSize(std::max(size, 0));
+}
+
+int App::GetRendererProcessPoolSize() {
+  return RendererProcessPool::GetInstance()->size();
+}
+
+void App::SetMaxConcurrentPrintJobs(int count) {
+  g_browser_process->print_job_manager()->set_max_concurrent_jobs(count);
+}
+
+int App::GetMaxConcurrentPrintJobs() {
+  return g_browser_process->print_job_manager()->max_concurrent_jobs();
+}
+
+void App::SetPowerPolicy(const mate::Dictionary& options) {
+  PowerPolicy::Options policy;
+  options.Get("throttleBackgroundWindows", &policy.throttle_background_windows);
+  options.Get("pauseAsarPrefetch", &policy.pause_asar_prefetch);
+  int timer_slack = 0;
+  if (options.Get("timerSlack", &timer_slack))
+    policy.timer_slack = base::TimeDelta::FromMilliseconds(timer_slack);
+  PowerPolicy::GetInstance()->SetOptions(policy);
+}
+
+void App::SetQuitOptions(const mate::Dictionary& options) {
+  int timeout = 0;
+  options.Get("timeout", &timeout);
+  bool suppress_dialogs = false;
+  options.Get("suppressDialogs", &suppress_dialogs);
+  bool fast_shutdown = false;
+  options.Get("fastShutdown", &fast_shutdown);
+  Browser::Get()->SetQuitOptions(
+      base::TimeDelta::FromMilliseconds(std::max(timeout, 0)),
+      suppress_dialogs,
+      fast_shutdown);
+}
+
+void App::SetJankThreshold(int ms) {
+  JankWatchdog::GetInstance()->SetThreshold(
+      base::TimeDelta::FromMilliseconds(std::max(ms, 0)));
+}
+
+int App::GetJankThreshold() {
+  return JankWatchdog::GetInstance()->threshold().InMilliseconds();
+}
+
+v8::Handle<v8::Value> App::GetJankReports(v8::Isolate* isolate) {
+  const std::deque<JankWatchdog::Report>& reports =
+      JankWatchdog::GetInstance()->reports();
+  std::vector<JankWatchdog::Report> result(reports.begin(), reports.end());
+  return mate::ConvertToV8(isolate, result);
+}
+
 mate::ObjectTemplateBuilder App::GetObjectTemplateBuilder(
     v8::Isolate* isolate) {
   auto browser = base::Unretained(Browser::Get());
@@ -222,7 +384,24 @@ mate::ObjectTemplateBuilder App::GetObjectTemplateBuilder(
       .SetMethod("setPath", &App::SetPath)
       .SetMethod("getPath", &App::GetPath)
       .SetMethod("resolveProxy", &App::ResolveProxy)
-      .SetMethod("setDesktopName", &App::SetDesktopName);
+      .SetMethod("_preconnect", &App::Preconnect)
+      .SetMethod("_prefetchDNS", &App::PrefetchDNS)
+      .SetMethod("_setZoomLevelForHost", &App::SetZoomLevelForHost)
+      .SetMethod("_getZoomLevelForHost", &App::GetZoomLevelForHost)
+      .SetMethod("setDesktopName", &App::SetDesktopName)
+      .SetMethod("setRendererProcessPoolSize",
+                 &App::SetRendererProcessPoolSize)
+      .SetMethod("getRendererProcessPoolSize",
+                 &App::GetRendererProcessPoolSize)
+      .SetMethod("setMaxConcurrentPrintJobs",
+                 &App::SetMaxConcurrentPrintJobs)
+      .SetMethod("getMaxConcurrentPrintJobs",
+                 &App::GetMaxConcurrentPrintJobs)
+      .SetMethod("setPowerPolicy", &App::SetPowerPolicy)
+      .SetMethod("setQuitOptions", &App::SetQuitOptions)
+      .SetMethod("setJankThreshold", &App::SetJankThreshold)
+      .SetMethod("getJankThreshold", &App::GetJankThreshold)
+      .SetMethod("getJankReports", &App::GetJankReports);
 }
 
 // static
@@ -237,6 +416,21 @@ mate::Handle<App> App::Create(v8::Isolate* isolate) {
 
 namespace {
 
+void GetProcessMetrics(
+    const atom::ProcessMetricsCollector::MetricsCallback& callback) {
+  atom::ProcessMetricsCollector::GetInstance()->Collect(callback);
+}
+
+void StartNetworkObserver(
+    const atom::NetworkObserver::MetricsCallback& callback, int interval) {
+  atom::NetworkObserver::GetInstance()->Start(
+      callback, base::TimeDelta::FromMilliseconds(std::max(interval, 0)));
+}
+
+void StopNetworkObserver() {
+  atom::NetworkObserver::GetInstance()->Stop();
+}
+
 void AppendSwitch(const std::string& switch_string, mate::Arguments* args) {
   auto command_line = base::CommandLine::ForCurrentProcess();
   std::string value;
@@ -269,6 +463,9 @@ void Initialize(v8::Handle<v8::Object> exports, v8::Handle<v8::Value> unused,
   mate::Dictionary dict(isolate, exports);
   dict.Set("app", atom::api::App::Create(isolate));
   dict.SetMethod("appendSwitch", &AppendSwitch);
+  dict.SetMethod("getProcessMetrics", &GetProcessMetrics);
+  dict.SetMethod("startNetworkObserver", &StartNetworkObserver);
+  dict.SetMethod("stopNetworkObserver", &StopNetworkObserver);
   dict.SetMethod("appendArgument",
                  base::Bind(&base::CommandLine::AppendArg,
                             base::Unretained(command_line)));
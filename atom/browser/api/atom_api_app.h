@@ -6,6 +6,7 @@
 #define ATOM_BROWSER_API_ATOM_API_APP_H_
 
 #include <string>
+#include <vector>
 
 #include "atom/browser/api/event_emitter.h"
 #include "atom/browser/browser_observer.h"
@@ -20,6 +21,7 @@ class FilePath;
 
 namespace mate {
 class Arguments;
+class Dictionary;
 }
 
 namespace atom {
@@ -45,6 +47,8 @@ class App : public mate::EventEmitter,
   void OnOpenFile(bool* prevent_default, const std::string& file_path) override;
   void OnOpenURL(const std::string& url) override;
   void OnActivateWithNoOpenWindows() override;
+  void OnMemoryPressure(
+      base::MemoryPressureListener::MemoryPressureLevel level) override;
   void OnWillFinishLaunching() override;
   void OnFinishLaunching() override;
 
@@ -60,7 +64,20 @@ class App : public mate::EventEmitter,
                const base::FilePath& path);
 
   void ResolveProxy(const GURL& url, ResolveProxyCallback callback);
+  void Preconnect(const GURL& url, int num_sockets);
+  void PrefetchDNS(const std::vector<std::string>& hosts);
+  void SetZoomLevelForHost(const std::string& host, double level);
+  double GetZoomLevelForHost(const std::string& host);
   void SetDesktopName(const std::string& desktop_name);
+  void SetRendererProcessPoolSize(int size);
+  int GetRendererProcessPoolSize();
+  void SetMaxConcurrentPrintJobs(int count);
+  int GetMaxConcurrentPrintJobs();
+  void SetPowerPolicy(const mate::Dictionary& options);
+  void SetQuitOptions(const mate::Dictionary& options);
+  void SetJankThreshold(int ms);
+  int GetJankThreshold();
+  v8::Handle<v8::Value> GetJankReports(v8::Isolate* isolate);
 
   DISALLOW_COPY_AND_ASSIGN(App);
 };
@@ -40,6 +40,13 @@ void AutoUpdater::OnUpdateNotAvailable() {
   Emit("update-not-available");
 }
 
+void AutoUpdater::OnUpdateDownloadProgress(int64 received,
+                                           int64 total,
+                                           int64 bytes_per_second) {
+  Emit("download-progress", static_cast<double>(received),
+       static_cast<double>(total), static_cast<double>(bytes_per_second));
+}
+
 void AutoUpdater::OnUpdateDownloaded(const std::string& release_notes,
                                      const std::string& release_name,
                                      const base::Time& release_date,
@@ -55,6 +62,10 @@ mate::ObjectTemplateBuilder AutoUpdater::GetObjectTemplateBuilder(
   return mate::ObjectTemplateBuilder(isolate)
       .SetMethod("setFeedUrl", &auto_updater::AutoUpdater::SetFeedURL)
       .SetMethod("checkForUpdates", &auto_updater::AutoUpdater::CheckForUpdates)
+      .SetMethod("checkForDeltaUpdates",
+                 &auto_updater::AutoUpdater::CheckForDeltaUpdates)
+      .SetMethod("setBandwidthLimit",
+                 &auto_updater::AutoUpdater::SetBandwidthLimit)
       .SetMethod("_quitAndInstall", &AutoUpdater::QuitAndInstall);
 }
 
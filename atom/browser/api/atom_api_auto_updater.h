@@ -30,6 +30,9 @@ class AutoUpdater : public mate::EventEmitter,
   void OnCheckingForUpdate() override;
   void OnUpdateAvailable() override;
   void OnUpdateNotAvailable() override;
+  void OnUpdateDownloadProgress(int64 received,
+                                int64 total,
+                                int64 bytes_per_second) override;
   void OnUpdateDownloaded(
       const std::string& release_notes,
       const std::string& release_name,
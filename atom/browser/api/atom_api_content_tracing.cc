@@ -7,7 +7,10 @@
 
 #include "atom/common/native_mate_converters/file_path_converter.h"
 #include "base/bind.h"
+#include "base/files/file_util.h"
+#include "base/message_loop/message_loop.h"
 #include "content/public/browser/tracing_controller.h"
+#include "native_mate/arguments.h"
 #include "native_mate/callback.h"
 #include "native_mate/dictionary.h"
 
@@ -60,6 +63,51 @@ struct Converter<base::debug::TraceOptions> {
 
 namespace {
 
+typedef base::Callback<void(const base::FilePath&)> CompletionCallback;
+
+void RunCompletionCallback(const CompletionCallback& callback,
+                           const base::FilePath& path) {
+  if (!callback.is_null())
+    callback.Run(path);
+}
+
+// Returns a sink that appends the trace chunks to |path| as they are collected
+// from child processes, so the whole trace is never kept in memory. A
+// temporary file is used when |path| is empty, and when it can not be created
+// there is no sink, the data is dropped and |callback| gets an empty path.
+scoped_refptr<TracingController::TraceDataSink> GetTraceDataSink(
+    const base::FilePath& path, const CompletionCallback& callback) {
+  base::FilePath result_file_path = path;
+  if (result_file_path.empty() &&
+      !base::CreateTemporaryFile(&result_file_path)) {
+    LOG(ERROR) << "Creating temporary file failed";
+    base::MessageLoop::current()->PostTask(
+        FROM_HERE,
+        base::Bind(&RunCompletionCallback, callback, base::FilePath()));
+    return nullptr;
+  }
+
+  return TracingController::CreateFileSink(
+      result_file_path,
+      base::Bind(&RunCompletionCallback, callback, result_file_path));
+}
+
+// The |callback| of the following methods is optional.
+bool StopRecording(mate::Arguments* args, const base::FilePath& path) {
+  CompletionCallback callback;
+  args->GetNext(&callback);
+  return TracingController::GetInstance()->DisableRecording(
+      GetTraceDataSink(path, callback));
+}
+
+bool CaptureMonitoringSnapshot(mate::Arguments* args,
+                               const base::FilePath& path) {
+  CompletionCallback callback;
+  args->GetNext(&callback);
+  return TracingController::GetInstance()->CaptureMonitoringSnapshot(
+      GetTraceDataSink(path, callback));
+}
+
 void Initialize(v8::Handle<v8::Object> exports, v8::Handle<v8::Value> unused,
                 v8::Handle<v8::Context> context, void* priv) {
   auto controller = base::Unretained(TracingController::GetInstance());
@@ -68,14 +116,12 @@ void Initialize(v8::Handle<v8::Object> exports, v8::Handle<v8::Value> unused,
       &TracingController::GetCategories, controller));
   dict.SetMethod("startRecording", base::Bind(
       &TracingController::EnableRecording, controller));
-  dict.SetMethod("stopRecording", base::Bind(
-      &TracingController::DisableRecording, controller, nullptr));
+  dict.SetMethod("stopRecording", &StopRecording);
   dict.SetMethod("startMonitoring", base::Bind(
       &TracingController::EnableMonitoring, controller));
   dict.SetMethod("stopMonitoring", base::Bind(
       &TracingController::DisableMonitoring, controller));
-  dict.SetMethod("captureMonitoringSnapshot", base::Bind(
-      &TracingController::CaptureMonitoringSnapshot, controller, nullptr));
+  dict.SetMethod("captureMonitoringSnapshot", &CaptureMonitoringSnapshot);
   dict.SetMethod("getTraceBufferUsage", base::Bind(
       &TracingController::GetTraceBufferUsage, controller));
   dict.SetMethod("setWatchEvent", base::Bind(
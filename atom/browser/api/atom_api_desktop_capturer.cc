@@ -0,0 +1,149 @@
+// Copyright (c) 2015 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#include "atom/browser/api/atom_api_desktop_capturer.h"
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "atom/common/native_mate_converters/image_converter.h"
+#include "atom/common/native_mate_converters/string16_converter.h"
+#include "native_mate/dictionary.h"
+#include "native_mate/object_template_builder.h"
+
+#include "atom/common/node_includes.h"
+
+namespace atom {
+
+namespace api {
+
+DesktopCapturer::DesktopCapturer() {
+}
+
+DesktopCapturer::~DesktopCapturer() {
+}
+
+void DesktopCapturer::OnSourceAdded(int index) {
+  v8::Isolate* isolate = v8::Isolate::GetCurrent();
+  v8::Locker locker(isolate);
+  v8::HandleScope handle_scope(isolate);
+  Emit("source-added", index, SourceToV8(isolate, index));
+}
+
+void DesktopCapturer::OnSourceRemoved(int index) {
+  Emit("source-removed", index);
+}
+
+void DesktopCapturer::OnSourceMoved(int old_index, int new_index) {
+  Emit("source-moved", old_index, new_index);
+}
+
+void DesktopCapturer::OnSourceNameChanged(int index) {
+  v8::Isolate* isolate = v8::Isolate::GetCurrent();
+  v8::Locker locker(isolate);
+  v8::HandleScope handle_scope(isolate);
+  Emit("source-name-changed", index, SourceToV8(isolate, index));
+}
+
+void DesktopCapturer::OnSourceThumbnailChanged(int index) {
+  v8::Isolate* isolate = v8::Isolate::GetCurrent();
+  v8::Locker locker(isolate);
+  v8::HandleScope handle_scope(isolate);
+  Emit("source-thumbnail-changed", index, SourceToV8(isolate, index));
+}
+
+void DesktopCapturer::OnRefreshFinished() {
+  Emit("refresh-finished");
+}
+
+mate::ObjectTemplateBuilder DesktopCapturer::GetObjectTemplateBuilder(
+    v8::Isolate* isolate) {
+  return mate::ObjectTemplateBuilder(isolate)
+      .SetMethod("startUpdating", &DesktopCapturer::StartUpdating)
+      .SetMethod("stopUpdating", &DesktopCapturer::StopUpdating)
+      .SetMethod("getSources", &DesktopCapturer::GetSources);
+}
+
+void DesktopCapturer::StartUpdating(mate::Arguments* args) {
+  mate::Dictionary options;
+  args->GetNext(&options);
+
+  bool screens = true, windows = true;
+  std::vector<std::string> types;
+  if (options.Get("types", &types)) {
+    screens = std::find(types.begin(), types.end(), "screen") != types.end();
+    windows = std::find(types.begin(), types.end(), "window") != types.end();
+  }
+  if (!screens && !windows) {
+    args->ThrowError("types should have \"screen\" or \"window\"");
+    return;
+  }
+
+  // The new list starts from scratch, so the old sources are removed first.
+  StopUpdating();
+  media_list_.reset(new DesktopMediaList(screens, windows, this));
+
+  mate::Dictionary size;
+  int width = 0, height = 0;
+  if (options.Get("thumbnailSize", &size) && size.Get("width", &width) &&
+      size.Get("height", &height) && width > 0 && height > 0)
+    media_list_->set_thumbnail_size(gfx::Size(width, height));
+  int update_period = 0;
+  if (options.Get("updatePeriod", &update_period) && update_period > 0)
+    media_list_->set_update_period(
+        base::TimeDelta::FromMilliseconds(update_period));
+
+  media_list_->StartUpdating();
+}
+
+void DesktopCapturer::StopUpdating() {
+  if (!media_list_)
+    return;
+
+  scoped_ptr<DesktopMediaList> media_list(media_list_.Pass());
+  for (int i = media_list->sources().size() - 1; i >= 0; --i)
+    Emit("source-removed", i);
+}
+
+v8::Handle<v8::Value> DesktopCapturer::GetSources(v8::Isolate* isolate) {
+  size_t count = media_list_ ? media_list_->sources().size() : 0;
+  v8::Handle<v8::Array> sources = v8::Array::New(isolate, count);
+  for (size_t i = 0; i < count; ++i)
+    sources->Set(i, SourceToV8(isolate, i));
+  return sources;
+}
+
+v8::Handle<v8::Value> DesktopCapturer::SourceToV8(v8::Isolate* isolate,
+                                                  int index) {
+  const DesktopMediaList::Source& source = media_list_->sources()[index];
+  mate::Dictionary dict = mate::Dictionary::CreateEmpty(isolate);
+  dict.Set("id", source.id);
+  dict.Set("name", source.name);
+  dict.Set("thumbnail", gfx::Image(source.thumbnail));
+  return dict.GetHandle();
+}
+
+// static
+mate::Handle<DesktopCapturer> DesktopCapturer::Create(v8::Isolate* isolate) {
+  return CreateHandle(isolate, new DesktopCapturer);
+}
+
+}  // namespace api
+
+}  // namespace atom
+
+
+namespace {
+
+void Initialize(v8::Handle<v8::Object> exports, v8::Handle<v8::Value> unused,
+                v8::Handle<v8::Context> context, void* priv) {
+  v8::Isolate* isolate = context->GetIsolate();
+  mate::Dictionary dict(isolate, exports);
+  dict.Set("desktopCapturer", atom::api::DesktopCapturer::Create(isolate));
+}
+
+}  // namespace
+
+NODE_MODULE_CONTEXT_AWARE_BUILTIN(atom_browser_desktop_capturer, Initialize)
@@ -0,0 +1,58 @@
+// Copyright (c) 2015 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#ifndef ATOM_BROWSER_API_ATOM_API_DESKTOP_CAPTURER_H_
+#define ATOM_BROWSER_API_ATOM_API_DESKTOP_CAPTURER_H_
+
+#include "atom/browser/api/event_emitter.h"
+#include "atom/browser/desktop_media_list.h"
+#include "base/memory/scoped_ptr.h"
+#include "native_mate/handle.h"
+
+namespace mate {
+class Arguments;
+}
+
+namespace atom {
+
+namespace api {
+
+class DesktopCapturer : public mate::EventEmitter,
+                        public DesktopMediaList::Observer {
+ public:
+  static mate::Handle<DesktopCapturer> Create(v8::Isolate* isolate);
+
+ protected:
+  DesktopCapturer();
+  virtual ~DesktopCapturer();
+
+  // DesktopMediaList::Observer:
+  void OnSourceAdded(int index) override;
+  void OnSourceRemoved(int index) override;
+  void OnSourceMoved(int old_index, int new_index) override;
+  void OnSourceNameChanged(int index) override;
+  void OnSourceThumbnailChanged(int index) override;
+  void OnRefreshFinished() override;
+
+  // mate::Wrappable:
+  mate::ObjectTemplateBuilder GetObjectTemplateBuilder(
+      v8::Isolate* isolate) override;
+
+ private:
+  void StartUpdating(mate::Arguments* args);
+  void StopUpdating();
+  v8::Handle<v8::Value> GetSources(v8::Isolate* isolate);
+
+  v8::Handle<v8::Value> SourceToV8(v8::Isolate* isolate, int index);
+
+  scoped_ptr<DesktopMediaList> media_list_;
+
+  DISALLOW_COPY_AND_ASSIGN(DesktopCapturer);
+};
+
+}  // namespace api
+
+}  // namespace atom
+
+#endif  // ATOM_BROWSER_API_ATOM_API_DESKTOP_CAPTURER_H_
@@ -12,6 +12,8 @@
 #include "atom/browser/ui/message_box.h"
 #include "atom/common/native_mate_converters/file_path_converter.h"
 #include "atom/common/native_mate_converters/image_converter.h"
+#include "atom/common/options_switches.h"
+#include "base/command_line.h"
 #include "native_mate/callback.h"
 #include "native_mate/dictionary.h"
 
@@ -39,6 +41,16 @@ struct Converter<file_dialog::Filter> {
 
 namespace {
 
+// The dialogs without callback block in a nested message loop, which can be
+// turned off by --disable-sync-dialogs.
+bool CanShowSyncDialog(mate::Arguments* args) {
+  if (!base::CommandLine::ForCurrentProcess()->HasSwitch(
+          atom::switches::kDisableSyncDialogs))
+    return true;
+  args->ThrowError("Synchronous dialogs are disabled, pass a callback");
+  return false;
+}
+
 void ShowMessageBox(int type,
                     const std::vector<std::string>& buttons,
                     const std::vector<std::string>& texts,
@@ -59,7 +71,7 @@ void ShowMessageBox(int type,
                                                         &callback)) {
     atom::ShowMessageBox(window, (atom::MessageBoxType)type, buttons, title,
                          message, detail, icon, callback);
-  } else {
+  } else if (CanShowSyncDialog(args)) {
     int chosen = atom::ShowMessageBox(window, (atom::MessageBoxType)type,
                                       buttons, title, message, detail, icon);
     args->Return(chosen);
@@ -79,7 +91,7 @@ void ShowOpenDialog(const std::string& title,
                                                                &callback)) {
     file_dialog::ShowOpenDialog(window, title, default_path, filters,
                                 properties, callback);
-  } else {
+  } else if (CanShowSyncDialog(args)) {
     std::vector<base::FilePath> paths;
     if (file_dialog::ShowOpenDialog(window, title, default_path, filters,
                                     properties, &paths))
@@ -98,7 +110,7 @@ void ShowSaveDialog(const std::string& title,
                                                                peek,
                                                                &callback)) {
     file_dialog::ShowSaveDialog(window, title, default_path, filters, callback);
-  } else {
+  } else if (CanShowSyncDialog(args)) {
     base::FilePath path;
     if (file_dialog::ShowSaveDialog(window, title, default_path, filters,
                                     &path))
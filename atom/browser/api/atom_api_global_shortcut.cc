@@ -6,6 +6,7 @@
 
 #include <string>
 
+#include "atom/browser/ui/accelerator_util.h"
 #include "atom/common/native_mate_converters/accelerator_converter.h"
 #include "base/stl_util.h"
 #include "native_mate/callback.h"
@@ -48,6 +49,32 @@ bool GlobalShortcut::Register(const ui::Accelerator& accelerator,
   return true;
 }
 
+std::vector<bool> GlobalShortcut::RegisterAll(
+    const std::vector<std::string>& accelerators,
+    const std::vector<base::Closure>& callbacks) {
+  // The invalid accelerators are not passed to the listener.
+  std::vector<ui::Accelerator> parsed;
+  std::vector<size_t> indexes;
+  for (size_t i = 0; i < accelerators.size() && i < callbacks.size(); ++i) {
+    ui::Accelerator accelerator;
+    if (accelerator_util::StringToAccelerator(accelerators[i], &accelerator)) {
+      parsed.push_back(accelerator);
+      indexes.push_back(i);
+    }
+  }
+
+  std::vector<bool> registered =
+      GlobalShortcutListener::GetInstance()->RegisterAccelerators(parsed, this);
+  std::vector<bool> results(accelerators.size(), false);
+  for (size_t i = 0; i < parsed.size(); ++i) {
+    if (!registered[i])
+      continue;
+    accelerator_callback_map_[parsed[i]] = callbacks[indexes[i]];
+    results[indexes[i]] = true;
+  }
+  return results;
+}
+
 void GlobalShortcut::Unregister(const ui::Accelerator& accelerator) {
   if (!ContainsKey(accelerator_callback_map_, accelerator))
     return;
@@ -70,6 +97,7 @@ mate::ObjectTemplateBuilder GlobalShortcut::GetObjectTemplateBuilder(
     v8::Isolate* isolate) {
   return mate::ObjectTemplateBuilder(isolate)
       .SetMethod("register", &GlobalShortcut::Register)
+      .SetMethod("_registerAll", &GlobalShortcut::RegisterAll)
       .SetMethod("isRegistered", &GlobalShortcut::IsRegistered)
       .SetMethod("unregister", &GlobalShortcut::Unregister)
       .SetMethod("unregisterAll", &GlobalShortcut::UnregisterAll);
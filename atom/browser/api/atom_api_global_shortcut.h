@@ -7,6 +7,7 @@
 
 #include <map>
 #include <string>
+#include <vector>
 
 #include "base/callback.h"
 #include "chrome/browser/extensions/global_shortcut_listener.h"
@@ -36,6 +37,10 @@ class GlobalShortcut : public extensions::GlobalShortcutListener::Observer,
 
   bool Register(const ui::Accelerator& accelerator,
                 const base::Closure& callback);
+  // Registers the shortcuts of |accelerators| with the |callbacks| of the same
+  // index in one go, returns whether each of them has been registered.
+  std::vector<bool> RegisterAll(const std::vector<std::string>& accelerators,
+                                const std::vector<base::Closure>& callbacks);
   bool IsRegistered(const ui::Accelerator& accelerator);
   void Unregister(const ui::Accelerator& accelerator);
   void UnregisterAll();
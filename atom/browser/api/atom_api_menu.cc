@@ -5,6 +5,8 @@
 #include "atom/browser/api/atom_api_menu.h"
 
 #include "atom/browser/native_window.h"
+#include "atom/browser/ui/accelerator_util.h"
+#include "atom/browser/ui/menu_model_observer.h"
 #include "atom/common/native_mate_converters/accelerator_converter.h"
 #include "atom/common/native_mate_converters/image_converter.h"
 #include "atom/common/native_mate_converters/string16_converter.h"
@@ -53,8 +55,25 @@ bool Menu::IsCommandIdVisible(int command_id) const {
   return is_visible_.Run(command_id);
 }
 
+bool Menu::IsItemForCommandIdDynamic(int command_id) const {
+  return dynamic_labels_.find(command_id) != dynamic_labels_.end();
+}
+
+base::string16 Menu::GetLabelForCommandId(int command_id) const {
+  std::map<int, base::string16>::const_iterator it =
+      dynamic_labels_.find(command_id);
+  return it == dynamic_labels_.end() ? base::string16() : it->second;
+}
+
 bool Menu::GetAcceleratorForCommandId(int command_id,
                                       ui::Accelerator* accelerator) {
+  std::map<int, ui::Accelerator>::const_iterator it =
+      accelerators_.find(command_id);
+  if (it != accelerators_.end()) {
+    *accelerator = it->second;
+    return true;
+  }
+
   v8::Isolate* isolate = v8::Isolate::GetCurrent();
   v8::Locker locker(isolate);
   v8::HandleScope handle_scope(isolate);
@@ -104,6 +123,49 @@ void Menu::InsertSubMenuAt(int index,
   model_->InsertSubMenuAt(index, command_id, label, menu->model_.get());
 }
 
+void Menu::InsertItemsAt(int index,
+                         const std::vector<mate::Dictionary>& items) {
+  for (const mate::Dictionary& item : items) {
+    std::string type;
+    int command_id = 0;
+    base::string16 label;
+    item.Get("type", &type);
+    item.Get("commandId", &command_id);
+    item.Get("label", &label);
+
+    if (type == "separator") {
+      InsertSeparatorAt(index);
+    } else if (type == "checkbox") {
+      InsertCheckItemAt(index, command_id, label);
+    } else if (type == "radio") {
+      int group_id = 0;
+      item.Get("groupId", &group_id);
+      InsertRadioItemAt(index, command_id, label, group_id);
+    } else if (type == "submenu") {
+      Menu* submenu = NULL;
+      if (!item.Get("submenu", &submenu) || !submenu)
+        continue;
+      InsertSubMenuAt(index, command_id, label, submenu);
+    } else {
+      InsertItemAt(index, command_id, label);
+    }
+
+    base::string16 sublabel;
+    if (item.Get("sublabel", &sublabel) && !sublabel.empty())
+      SetSublabel(index, sublabel);
+    gfx::Image icon;
+    if (item.Get("icon", &icon) && !icon.IsEmpty())
+      SetIcon(index, icon);
+    std::string description;
+    ui::Accelerator accelerator;
+    if (item.Get("accelerator", &description) &&
+        accelerator_util::StringToAccelerator(description, &accelerator))
+      accelerators_[command_id] = accelerator;
+
+    ++index;
+  }
+}
+
 void Menu::SetIcon(int index, const gfx::Image& image) {
   model_->SetIcon(index, image);
 }
@@ -112,8 +174,20 @@ void Menu::SetSublabel(int index, const base::string16& sublabel) {
   model_->SetSublabel(index, sublabel);
 }
 
+void Menu::SetLabel(int command_id, const base::string16& label) {
+  dynamic_labels_[command_id] = label;
+}
+
+void Menu::ItemChanged(int command_id) {
+  int index = model_->GetIndexOfCommandId(command_id);
+  if (index >= 0)
+    MenuModelObserver::NotifyItemChanged(model_.get(), index);
+}
+
 void Menu::Clear() {
   model_->Clear();
+  accelerators_.clear();
+  dynamic_labels_.clear();
 }
 
 int Menu::GetIndexOfCommandId(int command_id) {
@@ -157,8 +231,11 @@ void Menu::BuildPrototype(v8::Isolate* isolate,
       .SetMethod("insertRadioItem", &Menu::InsertRadioItemAt)
       .SetMethod("insertSeparator", &Menu::InsertSeparatorAt)
       .SetMethod("insertSubMenu", &Menu::InsertSubMenuAt)
+      .SetMethod("_insertItems", &Menu::InsertItemsAt)
       .SetMethod("setIcon", &Menu::SetIcon)
       .SetMethod("setSublabel", &Menu::SetSublabel)
+      .SetMethod("_setLabel", &Menu::SetLabel)
+      .SetMethod("_itemChanged", &Menu::ItemChanged)
       .SetMethod("clear", &Menu::Clear)
       .SetMethod("getIndexOfCommandId", &Menu::GetIndexOfCommandId)
       .SetMethod("getItemCount", &Menu::GetItemCount)
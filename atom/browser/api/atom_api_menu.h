@@ -5,12 +5,15 @@
 #ifndef ATOM_BROWSER_API_ATOM_API_MENU_H_
 #define ATOM_BROWSER_API_ATOM_API_MENU_H_
 
+#include <map>
 #include <string>
+#include <vector>
 
 #include "atom/browser/api/atom_api_window.h"
 #include "base/callback.h"
 #include "base/memory/scoped_ptr.h"
 #include "ui/base/models/simple_menu_model.h"
+#include "native_mate/dictionary.h"
 #include "native_mate/wrappable.h"
 
 namespace atom {
@@ -46,6 +49,8 @@ class Menu : public mate::Wrappable,
   bool IsCommandIdChecked(int command_id) const override;
   bool IsCommandIdEnabled(int command_id) const override;
   bool IsCommandIdVisible(int command_id) const override;
+  bool IsItemForCommandIdDynamic(int command_id) const override;
+  base::string16 GetLabelForCommandId(int command_id) const override;
   bool GetAcceleratorForCommandId(int command_id,
                                   ui::Accelerator* accelerator) override;
   void ExecuteCommand(int command_id, int event_flags) override;
@@ -72,8 +77,15 @@ class Menu : public mate::Wrappable,
                        int command_id,
                        const base::string16& label,
                        Menu* menu);
+  // Inserts the |items| built by JS in one call, the accelerators are parsed
+  // here and remembered, so they need no call into JS when the menu is shown.
+  void InsertItemsAt(int index, const std::vector<mate::Dictionary>& items);
   void SetIcon(int index, const gfx::Image& image);
   void SetSublabel(int index, const base::string16& sublabel);
+  // Changes the label of the item of |command_id| after it is inserted.
+  void SetLabel(int command_id, const base::string16& label);
+  // Patches the native menus showing the item of |command_id|.
+  void ItemChanged(int command_id);
   void Clear();
   int GetIndexOfCommandId(int command_id);
   int GetItemCount() const;
@@ -92,6 +104,12 @@ class Menu : public mate::Wrappable,
   base::Callback<void(int)> execute_command_;
   base::Callback<void()> menu_will_show_;
 
+  // The accelerators of the items inserted by InsertItemsAt.
+  std::map<int, ui::Accelerator> accelerators_;
+
+  // The labels changed by SetLabel.
+  std::map<int, base::string16> dynamic_labels_;
+
   DISALLOW_COPY_AND_ASSIGN(Menu);
 };
 
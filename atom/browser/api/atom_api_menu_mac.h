@@ -10,18 +10,24 @@
 #include <string>
 
 #import "atom/browser/ui/cocoa/atom_menu_controller.h"
+#include "atom/browser/ui/menu_model_observer.h"
 
 namespace atom {
 
 namespace api {
 
-class MenuMac : public Menu {
+class MenuMac : public Menu,
+                public MenuModelObserver {
  protected:
   MenuMac();
+  virtual ~MenuMac();
 
   void Popup(Window* window) override;
   void PopupAt(Window* window, int x, int y) override;
 
+  // MenuModelObserver:
+  void OnMenuItemChanged(ui::MenuModel* model, int index) override;
+
   base::scoped_nsobject<AtomMenuController> menu_controller_;
 
  private:
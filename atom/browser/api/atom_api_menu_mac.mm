@@ -16,6 +16,11 @@ namespace atom {
 namespace api {
 
 MenuMac::MenuMac() {
+  MenuModelObserver::AddObserver(this);
+}
+
+MenuMac::~MenuMac() {
+  MenuModelObserver::RemoveObserver(this);
 }
 
 void MenuMac::Popup(Window* window) {
@@ -69,6 +74,13 @@ void MenuMac::PopupAt(Window* window, int x, int y) {
                           inView:view];
 }
 
+void MenuMac::OnMenuItemChanged(ui::MenuModel* model, int index) {
+  // Only the application menu is kept, the popup menus validate their items
+  // each time they are shown.
+  if (menu_controller_)
+    [menu_controller_ updateItemAtIndex:index ofModel:model];
+}
+
 // static
 void Menu::SetApplicationMenu(Menu* base_menu) {
   MenuMac* menu = static_cast<MenuMac*>(base_menu);
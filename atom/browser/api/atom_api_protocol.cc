@@ -4,13 +4,28 @@
 
 #include "atom/browser/api/atom_api_protocol.h"
 
+#include <algorithm>
+#include <map>
+#include <vector>
+
 #include "atom/browser/atom_browser_context.h"
 #include "atom/browser/net/adapter_request_job.h"
 #include "atom/browser/net/atom_url_request_job_factory.h"
+#include "atom/browser/net/file_mapping_protocol_handler.h"
+#include "atom/browser/net/offline_store_protocol_handler.h"
+#include "atom/browser/net/protocol_response_cache.h"
+#include "atom/browser/net/protocol_worker.h"
+#include "atom/browser/net/url_request_buffer_job.h"
+#include "atom/browser/net/url_request_stream_job.h"
+#include "atom/browser/net/worker_protocol_handler.h"
 #include "atom/common/native_mate_converters/file_path_converter.h"
+#include "base/task_runner_util.h"
+#include "base/threading/sequenced_worker_pool.h"
 #include "content/public/browser/browser_thread.h"
 #include "native_mate/callback.h"
 #include "native_mate/dictionary.h"
+#include "native_mate/wrappable.h"
+#include "net/url_request/url_request.h"
 #include "net/url_request/url_request_context.h"
 
 #include "atom/common/node_includes.h"
@@ -42,14 +57,101 @@ namespace {
 
 typedef net::URLRequestJobFactory::ProtocolHandler ProtocolHandler;
 
+// The default size of the response cache of a protocol.
+const size_t kDefaultCacheSize = 32 * 1024 * 1024;
+
+// The most threads a worker protocol can use.
+const int kMaxProtocolWorkers = 16;
+
+// The sink of RequestStreamJob, JS writes chunks into it and gets called back
+// when the chunk has been read by the request, which is how the backpressure
+// of the writable stream works.
+class RequestStream : public mate::Wrappable {
+ public:
+  RequestStream() : next_id_(0), weak_factory_(this) {
+    buffer_ = new RequestStreamBuffer(base::Bind(&RequestStream::OnConsumed,
+                                                 weak_factory_.GetWeakPtr()));
+  }
+
+  scoped_refptr<RequestStreamBuffer> buffer() const { return buffer_; }
+
+ protected:
+  // mate::Wrappable:
+  mate::ObjectTemplateBuilder GetObjectTemplateBuilder(
+      v8::Isolate* isolate) override {
+    return mate::ObjectTemplateBuilder(isolate)
+        .SetMethod("write", base::Bind(&RequestStream::Write,
+                                       base::Unretained(this)))
+        .SetMethod("end", base::Bind(&RequestStream::End,
+                                     base::Unretained(this)));
+  }
+
+ private:
+  typedef base::Callback<void(bool)> WriteCallback;
+
+  void Write(v8::Local<v8::Value> chunk, const WriteCallback& callback) {
+    if (!node::Buffer::HasInstance(chunk))
+      return node::ThrowTypeError("The chunk should be a Buffer");
+
+    int id = next_id_++;
+    callbacks_[id] = callback;
+    buffer_->Write(id, std::string(node::Buffer::Data(chunk),
+                                   node::Buffer::Length(chunk)));
+  }
+
+  void End() {
+    buffer_->End();
+  }
+
+  void OnConsumed(int id, bool read) {
+    std::map<int, WriteCallback>::iterator it = callbacks_.find(id);
+    if (it == callbacks_.end())
+      return;
+    WriteCallback callback = it->second;
+    callbacks_.erase(it);
+    callback.Run(read);
+  }
+
+  scoped_refptr<RequestStreamBuffer> buffer_;
+
+  int next_id_;
+  std::map<int, WriteCallback> callbacks_;
+
+  base::WeakPtrFactory<RequestStream> weak_factory_;
+
+  DISALLOW_COPY_AND_ASSIGN(RequestStream);
+};
+
+// Starts the stream job of |job|, or aborts |buffer| when the request has gone
+// before that, so the writes of JS are not kept waiting forever.
+void CreateStreamJobOrAbort(base::WeakPtr<AdapterRequestJob> job,
+                            const std::string& mime_type,
+                            const std::string& charset,
+                            scoped_refptr<RequestStreamBuffer> buffer) {
+  if (job)
+    job->CreateStreamJobAndStart(mime_type, charset, buffer);
+  else
+    buffer->Abort();
+}
+
 class CustomProtocolRequestJob : public AdapterRequestJob {
  public:
   CustomProtocolRequestJob(Protocol* registry,
                            ProtocolHandler* protocol_handler,
+                           scoped_refptr<ProtocolResponseCache> cache,
                            net::URLRequest* request,
                            net::NetworkDelegate* network_delegate)
       : AdapterRequestJob(protocol_handler, request, network_delegate),
-        registry_(registry) {
+        registry_(registry),
+        cache_(cache) {
+  }
+
+  ~CustomProtocolRequestJob() override {
+    if (registry_->IsRequestTimingEnabled() && !timing().job_start.is_null())
+      BrowserThread::PostTask(BrowserThread::UI, FROM_HERE,
+          base::Bind(&Protocol::EmitRequestTimingInUI,
+                     base::Unretained(registry_), request()->url(), timing(),
+                     base::TimeTicks::Now()));
   }
 
   // AdapterRequestJob:
@@ -70,32 +172,64 @@ class CustomProtocolRequestJob : public AdapterRequestJob {
       std::string data = mate::V8ToString(result);
       BrowserThread::PostTask(BrowserThread::IO, FROM_HERE,
           base::Bind(&AdapterRequestJob::CreateStringJobAndStart,
-                     GetWeakPtr(), "text/plain", "UTF-8", data));
+                     GetWeakPtr(), "text/plain", "UTF-8", "", data));
       return;
     } else if (result->IsObject()) {
       v8::Handle<v8::Object> obj = result->ToObject();
       mate::Dictionary dict(isolate, obj);
       std::string name = mate::V8ToString(obj->GetConstructorName());
       if (name == "RequestStringJob") {
-        std::string mime_type, charset, data;
+        std::string mime_type, charset, content_encoding, data;
+        v8::Handle<v8::Value> buffer;
         dict.Get("mimeType", &mime_type);
         dict.Get("charset", &charset);
+        dict.Get("contentEncoding", &content_encoding);
+
+        // A Buffer, like compressed data, is sent as is.
+        if (dict.Get("data", &buffer) && node::Buffer::HasInstance(buffer)) {
+          scoped_refptr<base::RefCountedMemory> bytes(
+              new NodeBufferMemory(isolate, buffer->ToObject()));
+          if (ShouldCacheResponse(dict))
+            CacheResponse(dict, mime_type, charset, bytes);
+          BrowserThread::PostTask(BrowserThread::IO, FROM_HERE,
+              base::Bind(&AdapterRequestJob::CreateBufferJobAndStart,
+                         GetWeakPtr(), mime_type, charset, content_encoding,
+                         bytes));
+          return;
+        }
         dict.Get("data", &data);
 
+        if (ShouldCacheResponse(dict)) {
+          std::string copy(data);
+          CacheResponse(dict, mime_type, charset,
+                        base::RefCountedString::TakeString(&copy));
+        }
         BrowserThread::PostTask(BrowserThread::IO, FROM_HERE,
             base::Bind(&AdapterRequestJob::CreateStringJobAndStart,
-                       GetWeakPtr(), mime_type, charset, data));
+                       GetWeakPtr(), mime_type, charset, content_encoding,
+                       data));
         return;
       } else if (name == "RequestBufferJob") {
-        std::string mime_type, encoding;
+        std::string mime_type, encoding, content_encoding;
         v8::Handle<v8::Value> buffer;
         dict.Get("mimeType", &mime_type);
         dict.Get("encoding", &encoding);
+        dict.Get("contentEncoding", &content_encoding);
         dict.Get("data", &buffer);
 
+        if (!node::Buffer::HasInstance(buffer))
+          buffer = node::Buffer::New(isolate, 0);
+
+        // Pin the Buffer of the handler instead of copying it, so one Buffer
+        // can answer many requests without being copied for each of them.
+        scoped_refptr<base::RefCountedMemory> data(
+            new NodeBufferMemory(isolate, buffer->ToObject()));
+        if (ShouldCacheResponse(dict))
+          CacheResponse(dict, mime_type, encoding, data);
         BrowserThread::PostTask(BrowserThread::IO, FROM_HERE,
             base::Bind(&AdapterRequestJob::CreateBufferJobAndStart,
-                       GetWeakPtr(), mime_type, encoding, buffer->ToObject()));
+                       GetWeakPtr(), mime_type, encoding, content_encoding,
+                       data));
         return;
       } else if (name == "RequestFileJob") {
         base::FilePath path;
@@ -105,6 +239,23 @@ class CustomProtocolRequestJob : public AdapterRequestJob {
             base::Bind(&AdapterRequestJob::CreateFileJobAndStart,
                        GetWeakPtr(), path));
         return;
+      } else if (name == "RequestStreamJob") {
+        std::string mime_type, charset;
+        dict.Get("mimeType", &mime_type);
+        dict.Get("charset", &charset);
+
+        // Hand the sink to JS, the chunks written before the job is started
+        // on IO thread are kept in the buffer.
+        mate::Handle<RequestStream> stream =
+            mate::CreateHandle(isolate, new RequestStream);
+        v8::Handle<v8::Value> sink = stream.ToV8();
+        node::MakeCallback(isolate, obj, "_attach", 1, &sink);
+
+        BrowserThread::PostTask(BrowserThread::IO, FROM_HERE,
+            base::Bind(&CreateStreamJobOrAbort,
+                       GetWeakPtr(), mime_type, charset,
+                       stream->buffer()));
+        return;
       }
     }
 
@@ -123,7 +274,42 @@ class CustomProtocolRequestJob : public AdapterRequestJob {
   }
 
  private:
+  // Whether the job returned by the handler allows caching its response.
+  bool ShouldCacheResponse(const mate::Dictionary& dict) {
+    if (!cache_.get() || !ProtocolResponseCache::IsCacheable(request()))
+      return false;
+    bool immutable = false;
+    double max_age = 0;
+    dict.Get("immutable", &immutable);
+    dict.Get("maxAge", &max_age);
+    return immutable || max_age > 0;
+  }
+
+  void CacheResponse(const mate::Dictionary& dict,
+                     const std::string& mime_type,
+                     const std::string& charset,
+                     scoped_refptr<base::RefCountedMemory> data) {
+    ProtocolResponseCache::Entry entry;
+    entry.mime_type = mime_type;
+    entry.charset = charset;
+    entry.data = data;
+    dict.Get("contentEncoding", &entry.content_encoding);
+
+    bool immutable = false;
+    if (!dict.Get("immutable", &immutable) || !immutable) {
+      double max_age = 0;
+      dict.Get("maxAge", &max_age);
+      entry.expires = base::TimeTicks::Now() +
+          base::TimeDelta::FromMilliseconds(static_cast<int64>(max_age * 1000));
+    }
+
+    BrowserThread::PostTask(BrowserThread::IO, FROM_HERE,
+        base::Bind(&ProtocolResponseCache::Put,
+                   cache_, request()->url(), entry));
+  }
+
   Protocol* registry_;  // Weak, the Protocol class is expected to live forever.
+  scoped_refptr<ProtocolResponseCache> cache_;
 };
 
 // Always return the same CustomProtocolRequestJob for all requests, because
@@ -135,15 +321,24 @@ class CustomProtocolRequestJob : public AdapterRequestJob {
 class CustomProtocolHandler : public ProtocolHandler {
  public:
   CustomProtocolHandler(api::Protocol* registry,
-                        ProtocolHandler* protocol_handler = NULL)
+                        ProtocolHandler* protocol_handler = NULL,
+                        size_t cache_size = 0)
       : registry_(registry), protocol_handler_(protocol_handler) {
+    if (cache_size > 0)
+      cache_ = new ProtocolResponseCache(cache_size);
   }
 
   net::URLRequestJob* MaybeCreateJob(
       net::URLRequest* request,
       net::NetworkDelegate* network_delegate) const override {
+    if (cache_.get()) {
+      net::URLRequestJob* job = cache_->MaybeCreateJob(request,
+                                                       network_delegate);
+      if (job)
+        return job;
+    }
     return new CustomProtocolRequestJob(registry_, protocol_handler_.get(),
-                                        request, network_delegate);
+                                        cache_, request, network_delegate);
   }
 
   ProtocolHandler* ReleaseDefaultProtocolHandler() {
@@ -155,6 +350,7 @@ class CustomProtocolHandler : public ProtocolHandler {
  private:
   Protocol* registry_;  // Weak, the Protocol class is expected to live forever.
   scoped_ptr<ProtocolHandler> protocol_handler_;
+  scoped_refptr<ProtocolResponseCache> cache_;
 
   DISALLOW_COPY_AND_ASSIGN(CustomProtocolHandler);
 };
@@ -162,10 +358,33 @@ class CustomProtocolHandler : public ProtocolHandler {
 }  // namespace
 
 Protocol::Protocol()
-    : job_factory_(AtomBrowserContext::Get()->job_factory()) {
+    : job_factory_(AtomBrowserContext::Get()->job_factory()),
+      request_timing_enabled_(0) {
   CHECK(job_factory_);
 }
 
+bool Protocol::IsRequestTimingEnabled() const {
+  return base::subtle::NoBarrier_Load(&request_timing_enabled_) != 0;
+}
+
+void Protocol::EmitRequestTimingInUI(const GURL& url,
+                                     const RequestJobTiming& timing,
+                                     base::TimeTicks end) {
+  v8::Isolate* isolate = v8::Isolate::GetCurrent();
+  v8::Locker locker(isolate);
+  v8::HandleScope handle_scope(isolate);
+
+  mate::Dictionary dict = mate::Dictionary::CreateEmpty(isolate);
+  dict.Set("url", url.spec());
+  dict.Set("queueTime", (timing.handler_start - timing.start).InMillisecondsF());
+  dict.Set("handlerTime",
+           (timing.handler_end - timing.handler_start).InMillisecondsF());
+  dict.Set("replyTime",
+           (timing.job_start - timing.handler_end).InMillisecondsF());
+  dict.Set("responseTime", (end - timing.job_start).InMillisecondsF());
+  Emit("request-timing", dict);
+}
+
 Protocol::JsProtocolHandler Protocol::GetProtocolHandler(
     const std::string& scheme) {
   return protocol_handlers_[scheme];
@@ -177,6 +396,12 @@ mate::ObjectTemplateBuilder Protocol::GetObjectTemplateBuilder(
       .SetMethod("registerProtocol",
                  base::Bind(&Protocol::RegisterProtocol,
                             base::Unretained(this)))
+      .SetMethod("registerFileMapping",
+                 base::Bind(&Protocol::RegisterFileMapping,
+                            base::Unretained(this)))
+      .SetMethod("registerWorkerProtocol",
+                 base::Bind(&Protocol::RegisterWorkerProtocol,
+                            base::Unretained(this)))
       .SetMethod("unregisterProtocol",
                  base::Bind(&Protocol::UnregisterProtocol,
                             base::Unretained(this)))
@@ -188,23 +413,105 @@ mate::ObjectTemplateBuilder Protocol::GetObjectTemplateBuilder(
                             base::Unretained(this)))
       .SetMethod("uninterceptProtocol",
                  base::Bind(&Protocol::UninterceptProtocol,
+                            base::Unretained(this)))
+      .SetMethod("registerOfflineStore",
+                 base::Bind(&Protocol::RegisterOfflineStore,
+                            base::Unretained(this)))
+      .SetMethod("unregisterOfflineStore",
+                 base::Bind(&Protocol::UnregisterOfflineStore,
+                            base::Unretained(this)))
+      .SetMethod("_setRequestTimingEnabled",
+                 base::Bind(&Protocol::SetRequestTimingEnabled,
                             base::Unretained(this)));
 }
 
 void Protocol::RegisterProtocol(const std::string& scheme,
-                                const JsProtocolHandler& callback) {
+                                const JsProtocolHandler& callback,
+                                mate::Arguments* args) {
   if (ContainsKey(protocol_handlers_, scheme) ||
-      job_factory_->IsHandledProtocol(scheme))
+      IsHandledProtocolInUI(scheme))
     return node::ThrowError("The scheme is already registered");
 
+  size_t cache_size = 0;
+  mate::Dictionary options;
+  bool cache = false;
+  if (args->GetNext(&options) && options.Get("cache", &cache) && cache) {
+    double size = kDefaultCacheSize;
+    options.Get("cacheSize", &size);
+    cache_size = static_cast<size_t>(std::max(size, 0.0));
+  }
+
   protocol_handlers_[scheme] = callback;
   BrowserThread::PostTask(BrowserThread::IO,
                           FROM_HERE,
                           base::Bind(&Protocol::RegisterProtocolInIO,
-                                     base::Unretained(this), scheme));
+                                     base::Unretained(this), scheme,
+                                     cache_size));
+}
+
+void Protocol::RegisterFileMapping(const std::string& scheme,
+                                   v8::Handle<v8::Object> mappings) {
+  if (ContainsKey(protocol_handlers_, scheme) ||
+      ContainsKey(native_handler_schemes_, scheme) ||
+      IsHandledProtocolInUI(scheme))
+    return node::ThrowError("The scheme is already registered");
+
+  FileMappingProtocolHandler::Mappings paths;
+  v8::Isolate* isolate = v8::Isolate::GetCurrent();
+  v8::Handle<v8::Array> prefixes = mappings->GetOwnPropertyNames();
+  for (uint32_t i = 0; i < prefixes->Length(); ++i) {
+    v8::Handle<v8::Value> prefix = prefixes->Get(i);
+    base::FilePath path;
+    if (!mate::ConvertFromV8(isolate, mappings->Get(prefix), &path))
+      return node::ThrowTypeError("The mapped path should be a string");
+    paths[mate::V8ToString(prefix)] = path;
+  }
+
+  native_handler_schemes_.insert(scheme);
+  BrowserThread::PostTask(BrowserThread::IO,
+                          FROM_HERE,
+                          base::Bind(&Protocol::RegisterFileMappingInIO,
+                                     base::Unretained(this), scheme, paths));
+}
+
+void Protocol::RegisterWorkerProtocol(const std::string& scheme,
+                                      const base::FilePath& script,
+                                      mate::Arguments* args) {
+  if (ContainsKey(protocol_handlers_, scheme) ||
+      ContainsKey(native_handler_schemes_, scheme) ||
+      IsHandledProtocolInUI(scheme))
+    return node::ThrowError("The scheme is already registered");
+
+  int threads = 1;
+  mate::Dictionary options;
+  if (args->GetNext(&options))
+    options.Get("threads", &threads);
+  threads = std::max(1, std::min(threads, kMaxProtocolWorkers));
+
+  std::vector<scoped_refptr<ProtocolWorker>> workers;
+  for (int i = 0; i < threads; ++i) {
+    scoped_refptr<ProtocolWorker> worker(new ProtocolWorker(script));
+    if (!worker->Start())
+      return node::ThrowError("Unable to start the protocol worker");
+    workers.push_back(worker);
+  }
+
+  native_handler_schemes_.insert(scheme);
+  BrowserThread::PostTask(BrowserThread::IO,
+                          FROM_HERE,
+                          base::Bind(&Protocol::RegisterWorkerProtocolInIO,
+                                     base::Unretained(this), scheme, workers));
 }
 
 void Protocol::UnregisterProtocol(const std::string& scheme) {
+  if (native_handler_schemes_.erase(scheme) > 0) {
+    BrowserThread::PostTask(BrowserThread::IO,
+                            FROM_HERE,
+                            base::Bind(&Protocol::UnregisterProtocolInIO,
+                                       base::Unretained(this), scheme));
+    return;
+  }
+
   ProtocolHandlersMap::iterator it(protocol_handlers_.find(scheme));
   if (it == protocol_handlers_.end())
     return node::ThrowError("The scheme has not been registered");
@@ -216,7 +523,29 @@ void Protocol::UnregisterProtocol(const std::string& scheme) {
                                      base::Unretained(this), scheme));
 }
 
-bool Protocol::IsHandledProtocol(const std::string& scheme) {
+v8::Handle<v8::Value> Protocol::IsHandledProtocol(const std::string& scheme,
+                                                  mate::Arguments* args) {
+  v8::Isolate* isolate = args->isolate();
+  base::Callback<void(bool)> callback;
+  if (!args->GetNext(&callback))
+    return mate::ConvertToV8(isolate, IsHandledProtocolInUI(scheme));
+
+  base::PostTaskAndReplyWithResult(
+      BrowserThread::GetMessageLoopProxyForThread(BrowserThread::IO).get(),
+      FROM_HERE,
+      base::Bind(&Protocol::IsHandledProtocolInIO,
+                 base::Unretained(this), scheme),
+      callback);
+  return v8::Undefined(isolate);
+}
+
+bool Protocol::IsHandledProtocolInUI(const std::string& scheme) {
+  return job_factory_->HasProtocolHandler(scheme) ||
+      net::URLRequest::IsHandledProtocol(scheme);
+}
+
+bool Protocol::IsHandledProtocolInIO(const std::string& scheme) {
+  DCHECK(BrowserThread::CurrentlyOn(BrowserThread::IO));
   return job_factory_->IsHandledProtocol(scheme);
 }
 
@@ -225,9 +554,13 @@ void Protocol::InterceptProtocol(const std::string& scheme,
   if (!job_factory_->HasProtocolHandler(scheme))
     return node::ThrowError("Scheme does not exist.");
 
-  if (ContainsKey(protocol_handlers_, scheme))
+  if (ContainsKey(protocol_handlers_, scheme) ||
+      ContainsKey(native_handler_schemes_, scheme))
     return node::ThrowError("Cannot intercept custom procotols");
 
+  if (ContainsKey(offline_store_schemes_, scheme))
+    return node::ThrowError("Cannot intercept protocols with offline store");
+
   protocol_handlers_[scheme] = callback;
   BrowserThread::PostTask(BrowserThread::IO,
                           FROM_HERE,
@@ -247,10 +580,115 @@ void Protocol::UninterceptProtocol(const std::string& scheme) {
                                      base::Unretained(this), scheme));
 }
 
-void Protocol::RegisterProtocolInIO(const std::string& scheme) {
+void Protocol::RegisterOfflineStore(const std::string& scheme,
+                                    const base::FilePath& archive_path) {
+  if (!IsHandledProtocolInUI(scheme))
+    return node::ThrowError("Scheme does not exist.");
+
+  if (ContainsKey(protocol_handlers_, scheme) ||
+      ContainsKey(native_handler_schemes_, scheme))
+    return node::ThrowError("Cannot use offline store for custom protocols");
+
+  if (ContainsKey(offline_store_schemes_, scheme))
+    return node::ThrowError("The scheme already has an offline store");
+
+  offline_store_schemes_.insert(scheme);
+  BrowserThread::PostTask(BrowserThread::IO,
+                          FROM_HERE,
+                          base::Bind(&Protocol::RegisterOfflineStoreInIO,
+                                     base::Unretained(this), scheme,
+                                     archive_path));
+}
+
+void Protocol::UnregisterOfflineStore(const std::string& scheme) {
+  if (offline_store_schemes_.erase(scheme) == 0)
+    return node::ThrowError("The scheme does not have an offline store");
+
+  BrowserThread::PostTask(BrowserThread::IO,
+                          FROM_HERE,
+                          base::Bind(&Protocol::UnregisterOfflineStoreInIO,
+                                     base::Unretained(this), scheme));
+}
+
+void Protocol::SetRequestTimingEnabled(bool enabled) {
+  base::subtle::NoBarrier_Store(&request_timing_enabled_, enabled ? 1 : 0);
+}
+
+void Protocol::RegisterProtocolInIO(const std::string& scheme,
+                                    size_t cache_size) {
+  DCHECK(BrowserThread::CurrentlyOn(BrowserThread::IO));
+
+  job_factory_->SetProtocolHandler(
+      scheme, new CustomProtocolHandler(this, NULL, cache_size));
+  BrowserThread::PostTask(BrowserThread::UI,
+                          FROM_HERE,
+                          base::Bind(&Protocol::EmitEventInUI,
+                                     base::Unretained(this),
+                                     "registered", scheme));
+}
+
+void Protocol::RegisterFileMappingInIO(
+    const std::string& scheme,
+    const std::map<std::string, base::FilePath>& mappings) {
+  DCHECK(BrowserThread::CurrentlyOn(BrowserThread::IO));
+
+  job_factory_->SetProtocolHandler(scheme, new FileMappingProtocolHandler(
+      mappings,
+      BrowserThread::GetBlockingPool()->GetTaskRunnerWithShutdownBehavior(
+          base::SequencedWorkerPool::SKIP_ON_SHUTDOWN)));
+  BrowserThread::PostTask(BrowserThread::UI,
+                          FROM_HERE,
+                          base::Bind(&Protocol::EmitEventInUI,
+                                     base::Unretained(this),
+                                     "registered", scheme));
+}
+
+void Protocol::RegisterOfflineStoreInIO(const std::string& scheme,
+                                        const base::FilePath& archive_path) {
+  DCHECK(BrowserThread::CurrentlyOn(BrowserThread::IO));
+
+  // Schemes like http and https have no protocol handler and are handled by
+  // the network stack directly, which is also where the missed requests go.
+  ProtocolHandler* original_handler = job_factory_->GetProtocolHandler(scheme);
+  ProtocolHandler* handler = new OfflineStoreProtocolHandler(
+      archive_path, original_handler,
+      BrowserThread::GetBlockingPool()->GetTaskRunnerWithShutdownBehavior(
+          base::SequencedWorkerPool::SKIP_ON_SHUTDOWN));
+  if (original_handler)
+    job_factory_->ReplaceProtocol(scheme, handler);
+  else
+    job_factory_->SetProtocolHandler(scheme, handler);
+  BrowserThread::PostTask(BrowserThread::UI,
+                          FROM_HERE,
+                          base::Bind(&Protocol::EmitEventInUI,
+                                     base::Unretained(this),
+                                     "offline-store-registered", scheme));
+}
+
+void Protocol::UnregisterOfflineStoreInIO(const std::string& scheme) {
+  DCHECK(BrowserThread::CurrentlyOn(BrowserThread::IO));
+
+  OfflineStoreProtocolHandler* handler =
+      static_cast<OfflineStoreProtocolHandler*>(
+          job_factory_->GetProtocolHandler(scheme));
+  ProtocolHandler* original_handler = handler->ReleaseOriginalHandler();
+  if (original_handler)
+    delete job_factory_->ReplaceProtocol(scheme, original_handler);
+  else
+    job_factory_->SetProtocolHandler(scheme, NULL);
+  BrowserThread::PostTask(BrowserThread::UI,
+                          FROM_HERE,
+                          base::Bind(&Protocol::EmitEventInUI,
+                                     base::Unretained(this),
+                                     "offline-store-unregistered", scheme));
+}
+
+void Protocol::RegisterWorkerProtocolInIO(
+    const std::string& scheme,
+    const std::vector<scoped_refptr<ProtocolWorker>>& workers) {
   DCHECK(BrowserThread::CurrentlyOn(BrowserThread::IO));
 
-  job_factory_->SetProtocolHandler(scheme, new CustomProtocolHandler(this));
+  job_factory_->SetProtocolHandler(scheme, new WorkerProtocolHandler(workers));
   BrowserThread::PostTask(BrowserThread::UI,
                           FROM_HERE,
                           base::Bind(&Protocol::EmitEventInUI,
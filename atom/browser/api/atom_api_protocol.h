@@ -7,11 +7,26 @@
 
 #include <string>
 #include <map>
+#include <set>
+#include <vector>
 
 #include "atom/browser/api/event_emitter.h"
+#include "base/atomicops.h"
 #include "base/callback.h"
+#include "base/memory/ref_counted.h"
+#include "base/time/time.h"
 #include "native_mate/handle.h"
 
+class GURL;
+
+namespace base {
+class FilePath;
+}
+
+namespace mate {
+class Arguments;
+}
+
 namespace net {
 class URLRequest;
 }
@@ -19,6 +34,8 @@ class URLRequest;
 namespace atom {
 
 class AtomURLRequestJobFactory;
+class ProtocolWorker;
+struct RequestJobTiming;
 
 namespace api {
 
@@ -31,6 +48,15 @@ class Protocol : public mate::EventEmitter {
 
   JsProtocolHandler GetProtocolHandler(const std::string& scheme);
 
+  // Whether JS listens to the "request-timing" event, can be called on any
+  // thread.
+  bool IsRequestTimingEnabled() const;
+
+  // Emits the phases of a finished request.
+  void EmitRequestTimingInUI(const GURL& url,
+                             const RequestJobTiming& timing,
+                             base::TimeTicks end);
+
  protected:
   Protocol();
 
@@ -42,24 +68,57 @@ class Protocol : public mate::EventEmitter {
   typedef std::map<std::string, JsProtocolHandler> ProtocolHandlersMap;
 
   // Register/unregister an networking |scheme| which would be handled by
-  // |callback|.
+  // |callback|, the responses can be cached when |options.cache| is set.
   void RegisterProtocol(const std::string& scheme,
-                        const JsProtocolHandler& callback);
+                        const JsProtocolHandler& callback,
+                        mate::Arguments* args);
   void UnregisterProtocol(const std::string& scheme);
 
-  // Returns whether a scheme has been registered.
-  // FIXME Should accept a callback and be asynchronous so we do not have to use
-  // locks.
-  bool IsHandledProtocol(const std::string& scheme);
+  // Register a |scheme| whose URLs are mapped to files by |mappings| of
+  // prefixes to directories, which is resolved in IO thread without calling
+  // JS. It is unregistered by UnregisterProtocol.
+  void RegisterFileMapping(const std::string& scheme,
+                           v8::Handle<v8::Object> mappings);
+
+  // Register a |scheme| whose requests are answered by |script| running on
+  // |options.threads| worker threads, which never involves the UI thread.
+  // It is unregistered by UnregisterProtocol.
+  void RegisterWorkerProtocol(const std::string& scheme,
+                              const base::FilePath& script,
+                              mate::Arguments* args);
+
+  // Returns whether a scheme has been registered. When a callback is passed
+  // the job factory is asked in IO thread and the result is passed to it.
+  v8::Handle<v8::Value> IsHandledProtocol(const std::string& scheme,
+                                          mate::Arguments* args);
+  bool IsHandledProtocolInUI(const std::string& scheme);
+  bool IsHandledProtocolInIO(const std::string& scheme);
 
   // Intercept/unintercept an existing protocol handler.
   void InterceptProtocol(const std::string& scheme,
                          const JsProtocolHandler& callback);
   void UninterceptProtocol(const std::string& scheme);
 
+  // Serve the requests of an existing |scheme| from the asar archive at
+  // |archive_path| when it has a copy of the URL.
+  void RegisterOfflineStore(const std::string& scheme,
+                            const base::FilePath& archive_path);
+  void UnregisterOfflineStore(const std::string& scheme);
+
+  void SetRequestTimingEnabled(bool enabled);
+
   // The networking related operations have to be done in IO thread.
-  void RegisterProtocolInIO(const std::string& scheme);
+  void RegisterProtocolInIO(const std::string& scheme, size_t cache_size);
+  void RegisterFileMappingInIO(
+      const std::string& scheme,
+      const std::map<std::string, base::FilePath>& mappings);
+  void RegisterWorkerProtocolInIO(
+      const std::string& scheme,
+      const std::vector<scoped_refptr<ProtocolWorker>>& workers);
   void UnregisterProtocolInIO(const std::string& scheme);
+  void RegisterOfflineStoreInIO(const std::string& scheme,
+                                const base::FilePath& archive_path);
+  void UnregisterOfflineStoreInIO(const std::string& scheme);
   void InterceptProtocolInIO(const std::string& scheme);
   void UninterceptProtocolInIO(const std::string& scheme);
 
@@ -68,6 +127,12 @@ class Protocol : public mate::EventEmitter {
 
   AtomURLRequestJobFactory* job_factory_;
   ProtocolHandlersMap protocol_handlers_;
+  // The schemes registered by RegisterFileMapping and
+  // RegisterWorkerProtocol, which are not handled by JS in UI thread.
+  std::set<std::string> native_handler_schemes_;
+  std::set<std::string> offline_store_schemes_;
+
+  base::subtle::Atomic32 request_timing_enabled_;
 
   DISALLOW_COPY_AND_ASSIGN(Protocol);
 };
@@ -47,7 +47,10 @@ std::vector<std::string> MetricsToArray(uint32_t metrics) {
 
 }  // namespace
 
-Screen::Screen(gfx::Screen* screen) : screen_(screen) {
+Screen::Screen(gfx::Screen* screen)
+    : screen_(screen),
+      primary_display_valid_(false),
+      generation_(0) {
   screen_->AddObserver(this);
 }
 
@@ -60,7 +63,11 @@ gfx::Point Screen::GetCursorScreenPoint() {
 }
 
 gfx::Display Screen::GetPrimaryDisplay() {
-  return screen_->GetPrimaryDisplay();
+  if (!primary_display_valid_) {
+    primary_display_ = screen_->GetPrimaryDisplay();
+    primary_display_valid_ = true;
+  }
+  return primary_display_;
 }
 
 std::vector<gfx::Display> Screen::GetAllDisplays() {
@@ -81,11 +88,15 @@ gfx::Display Screen::GetDisplayMatching(const gfx::Rect& match_rect) {
 }
 
 void Screen::OnDisplayAdded(const gfx::Display& new_display) {
+  primary_display_valid_ = false;
+  ++generation_;
   displays_.push_back(new_display);
   Emit("display-added", new_display);
 }
 
 void Screen::OnDisplayRemoved(const gfx::Display& old_display) {
+  primary_display_valid_ = false;
+  ++generation_;
   auto iter = FindById(&displays_, old_display.id());
   if (iter == displays_.end())
     return;
@@ -96,6 +107,8 @@ void Screen::OnDisplayRemoved(const gfx::Display& old_display) {
 
 void Screen::OnDisplayMetricsChanged(const gfx::Display& display,
                                      uint32_t changed_metrics) {
+  primary_display_valid_ = false;
+  ++generation_;
   auto iter = FindById(&displays_, display.id());
   if (iter == displays_.end())
     return;
@@ -111,7 +124,8 @@ mate::ObjectTemplateBuilder Screen::GetObjectTemplateBuilder(
       .SetMethod("getPrimaryDisplay", &Screen::GetPrimaryDisplay)
       .SetMethod("getAllDisplays", &Screen::GetAllDisplays)
       .SetMethod("getDisplayNearestPoint", &Screen::GetDisplayNearestPoint)
-      .SetMethod("getDisplayMatching", &Screen::GetDisplayMatching);
+      .SetMethod("getDisplayMatching", &Screen::GetDisplayMatching)
+      .SetMethod("_getGeneration", &Screen::GetGeneration);
 }
 
 // static
@@ -9,6 +9,7 @@
 
 #include "atom/browser/api/event_emitter.h"
 #include "native_mate/handle.h"
+#include "ui/gfx/display.h"
 #include "ui/gfx/display_observer.h"
 
 namespace gfx {
@@ -35,6 +36,7 @@ class Screen : public mate::EventEmitter,
   std::vector<gfx::Display> GetAllDisplays();
   gfx::Display GetDisplayNearestPoint(const gfx::Point& point);
   gfx::Display GetDisplayMatching(const gfx::Rect& match_rect);
+  int GetGeneration() const { return generation_; }
 
   // gfx::DisplayObserver:
   void OnDisplayAdded(const gfx::Display& new_display) override;
@@ -50,6 +52,14 @@ class Screen : public mate::EventEmitter,
   gfx::Screen* screen_;
   std::vector<gfx::Display> displays_;
 
+  // Cleared whenever the configuration of displays changes.
+  gfx::Display primary_display_;
+  bool primary_display_valid_;
+
+  // Increased whenever the configuration of displays changes, so JavaScript
+  // knows when the displays it converted are stale.
+  int generation_;
+
   DISALLOW_COPY_AND_ASSIGN(Screen);
 };
 
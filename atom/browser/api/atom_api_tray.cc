@@ -66,9 +66,28 @@ void Tray::Destroy() {
 void Tray::SetImage(mate::Arguments* args, const gfx::Image& image) {
   if (!CheckTrayLife(args))
     return;
+  tray_icon_->StopAnimation();
   tray_icon_->SetImage(image);
 }
 
+void Tray::SetAnimation(mate::Arguments* args,
+                        const std::vector<gfx::Image>& frames,
+                        int interval) {
+  if (!CheckTrayLife(args))
+    return;
+  if (interval <= 0) {
+    args->ThrowError("Interval must be positive");
+    return;
+  }
+  tray_icon_->SetAnimation(frames, base::TimeDelta::FromMilliseconds(interval));
+}
+
+void Tray::StopAnimation(mate::Arguments* args) {
+  if (!CheckTrayLife(args))
+    return;
+  tray_icon_->StopAnimation();
+}
+
 void Tray::SetPressedImage(mate::Arguments* args, const gfx::Image& image) {
   if (!CheckTrayLife(args))
     return;
@@ -132,6 +151,8 @@ void Tray::BuildPrototype(v8::Isolate* isolate,
       .SetMethod("destroy", &Tray::Destroy)
       .SetMethod("setImage", &Tray::SetImage)
       .SetMethod("setPressedImage", &Tray::SetPressedImage)
+      .SetMethod("setAnimation", &Tray::SetAnimation)
+      .SetMethod("stopAnimation", &Tray::StopAnimation)
       .SetMethod("setToolTip", &Tray::SetToolTip)
       .SetMethod("setTitle", &Tray::SetTitle)
       .SetMethod("setHighlightMode", &Tray::SetHighlightMode)
@@ -4,15 +4,30 @@
 
 #include "atom/browser/api/atom_api_web_contents.h"
 
+#include <algorithm>
+#include <vector>
+
 #include "atom/browser/atom_browser_context.h"
+#include "atom/browser/message_port_message_filter.h"
 #include "atom/browser/native_window.h"
+#include "atom/browser/print_to_pdf_manager.h"
 #include "atom/browser/web_dialog_helper.h"
 #include "atom/browser/web_view_manager.h"
 #include "atom/common/api/api_messages.h"
+#include "atom/common/api/channel_name_cache.h"
+#include "atom/common/crash_reporter/breadcrumbs.h"
+#include "atom/common/native_mate_converters/file_path_converter.h"
 #include "atom/common/native_mate_converters/gfx_converter.h"
 #include "atom/common/native_mate_converters/gurl_converter.h"
 #include "atom/common/native_mate_converters/string16_converter.h"
+#include "atom/common/native_mate_converters/v8_value_serializer.h"
 #include "atom/common/native_mate_converters/value_converter.h"
+#include "atom/common/ring_buffer.h"
+#include "base/bind.h"
+#include "base/debug/trace_event.h"
+#include "base/message_loop/message_loop.h"
+#include "base/strings/string_util.h"
+#include "base/strings/stringprintf.h"
 #include "base/strings/utf_string_conversions.h"
 #include "brightray/browser/inspectable_web_contents.h"
 #include "content/public/browser/navigation_details.h"
@@ -24,8 +39,10 @@
 #include "content/public/browser/resource_request_details.h"
 #include "content/public/browser/site_instance.h"
 #include "content/public/browser/web_contents.h"
+#include "native_mate/callback.h"
 #include "native_mate/dictionary.h"
 #include "native_mate/object_template_builder.h"
+#include "net/base/escape.h"
 #include "vendor/brightray/browser/media/media_stream_devices_controller.h"
 
 #include "atom/common/node_includes.h"
@@ -34,6 +51,12 @@ namespace atom {
 
 namespace api {
 
+struct WebContents::IPCStream {
+  base::string16 channel;
+  base::SharedMemory memory;
+  scoped_ptr<RingBuffer> ring;
+};
+
 namespace {
 
 v8::Persistent<v8::ObjectTemplate> template_;
@@ -41,7 +64,8 @@ v8::Persistent<v8::ObjectTemplate> template_;
 // Get the window that has the |guest| embedded.
 NativeWindow* GetWindowFromGuest(const content::WebContents* guest) {
   WebViewManager::WebViewInfo info;
-  if (WebViewManager::GetInfoForProcess(guest->GetRenderProcessHost(), &info))
+  if (WebViewManager::GetInfoForProcess(guest->GetRenderProcessHost(), &info) &&
+      info.embedder)
     return NativeWindow::FromRenderView(
         info.embedder->GetRenderProcessHost()->GetID(),
         info.embedder->GetRoutingID());
@@ -49,6 +73,59 @@ NativeWindow* GetWindowFromGuest(const content::WebContents* guest) {
     return nullptr;
 }
 
+// Encodes the partition of a guest in its site URL, which is decoded by
+// AtomBrowserClient::GetStoragePartitionConfigForSite. Partitions starting
+// with "persist:" are kept on disk, the others only live in memory.
+GURL GetGuestSiteURL(const std::string& partition) {
+  const char kPersistPrefix[] = "persist:";
+  std::string name = partition;
+  bool persist = StartsWithASCII(name, kPersistPrefix, true);
+  if (persist)
+    name = name.substr(arraysize(kPersistPrefix) - 1);
+  if (name.empty())
+    return GURL("chrome-guest://fake-host");
+
+  std::string query = net::EscapeQueryParamValue(name, false);
+  return GURL(base::StringPrintf("chrome-guest://fake-host/?%s%s",
+                                 query.c_str(), persist ? "#persist" : ""));
+}
+
+// The bulk messages emitted in one task.
+const int kBulkMessagesPerTask = 16;
+
+// The shared memory all the streams of one page can take together.
+const size_t kMaxStreamMemory = 256 * 1024 * 1024;
+
+// Ignore the page ranges going beyond any reasonable document.
+const int kMaxPageNumber = 100000;
+
+// The paper sizes in microns that can be passed by name.
+struct PageSize {
+  const char* name;
+  int width;
+  int height;
+} kPageSizes[] = {
+  { "A3", 297000, 420000 },
+  { "A4", 210000, 297000 },
+  { "A5", 148000, 210000 },
+  { "Legal", 215900, 355600 },
+  { "Letter", 215900, 279400 },
+  { "Tabloid", 279400, 431800 },
+};
+
+void OnPrintToPDFDone(v8::Isolate* isolate,
+                      const WebContents::PrintToPDFCallback& callback,
+                      bool success,
+                      const std::vector<base::FilePath>& files) {
+  v8::Locker locker(isolate);
+  v8::HandleScope handle_scope(isolate);
+  if (success)
+    callback.Run(v8::Null(isolate), files);
+  else
+    callback.Run(v8::Exception::Error(mate::StringToV8(
+        isolate, "Failed to print to PDF")), files);
+}
+
 }  // namespace
 
 WebContents::WebContents(content::WebContents* web_contents)
@@ -56,21 +133,32 @@ WebContents::WebContents(content::WebContents* web_contents)
       guest_instance_id_(-1),
       element_instance_id_(-1),
       guest_opaque_(true),
+      next_stream_id_(0),
+      bulk_messages_scheduled_(false),
+      next_scripts_id_(0),
       guest_sizer_(nullptr),
-      auto_size_enabled_(false) {
+      auto_size_enabled_(false),
+      weak_factory_(this) {
 }
 
 WebContents::WebContents(const mate::Dictionary& options)
     : guest_instance_id_(-1),
       element_instance_id_(-1),
       guest_opaque_(true),
+      next_stream_id_(0),
+      bulk_messages_scheduled_(false),
+      next_scripts_id_(0),
       guest_sizer_(nullptr),
-      auto_size_enabled_(false) {
+      auto_size_enabled_(false),
+      weak_factory_(this) {
   options.Get("guestInstanceId", &guest_instance_id_);
 
+  std::string partition;
+  options.Get("storagePartitionId", &partition);
+
   auto browser_context = AtomBrowserContext::Get();
   content::SiteInstance* site_instance = content::SiteInstance::CreateForURL(
-      browser_context, GURL("chrome-guest://fake-host"));
+      browser_context, GetGuestSiteURL(partition));
 
   content::WebContents::CreateParams params(browser_context, site_instance);
   bool is_guest;
@@ -182,12 +270,25 @@ void WebContents::HandleKeyboardEvent(
 }
 
 void WebContents::RenderViewDeleted(content::RenderViewHost* render_view_host) {
+  streams_.clear();
+  CancelPendingScripts();
   Emit("render-view-deleted",
        render_view_host->GetProcess()->GetID(),
        render_view_host->GetRoutingID());
 }
 
+void WebContents::RenderViewHostChanged(content::RenderViewHost* old_host,
+                                        content::RenderViewHost* new_host) {
+  // The scripts were sent to the old page, which will never reply after a
+  // cross-process navigation.
+  if (old_host)
+    CancelPendingScripts();
+}
+
 void WebContents::RenderProcessGone(base::TerminationStatus status) {
+  crash_reporter::Breadcrumbs::Add("renderer-gone", GetURL().spec());
+  streams_.clear();
+  CancelPendingScripts();
   Emit("crashed");
 }
 
@@ -236,6 +337,7 @@ void WebContents::DidGetRedirectForResourceRequest(
 void WebContents::DidNavigateMainFrame(
     const content::LoadCommittedDetails& details,
     const content::FrameNavigateParams& params) {
+  crash_reporter::Breadcrumbs::Add("navigate", params.url.spec());
   if (details.is_navigation_to_different_page())
     Emit("did-navigate-to-different-page");
 }
@@ -249,8 +351,16 @@ bool WebContents::OnMessageReceived(const IPC::Message& message) {
   bool handled = true;
   IPC_BEGIN_MESSAGE_MAP(WebContents, message)
     IPC_MESSAGE_HANDLER(AtomViewHostMsg_Message, OnRendererMessage)
+    IPC_MESSAGE_HANDLER(AtomViewHostMsg_SharedMessage,
+                        OnRendererSharedMessage)
+    IPC_MESSAGE_HANDLER(AtomViewHostMsg_BulkMessage, OnRendererBulkMessage)
     IPC_MESSAGE_HANDLER_DELAY_REPLY(AtomViewHostMsg_Message_Sync,
                                     OnRendererMessageSync)
+    IPC_MESSAGE_HANDLER(AtomViewHostMsg_OpenStream, OnOpenStream)
+    IPC_MESSAGE_HANDLER(AtomViewHostMsg_StreamDoorbell, OnStreamDoorbell)
+    IPC_MESSAGE_HANDLER(AtomViewHostMsg_CloseStream, OnCloseStream)
+    IPC_MESSAGE_HANDLER(AtomViewHostMsg_ExecuteScriptsResult,
+                        OnExecuteScriptsResult)
     IPC_MESSAGE_UNHANDLED(handled = false)
   IPC_END_MESSAGE_MAP()
 
@@ -341,6 +451,19 @@ void WebContents::Destroy() {
   }
 }
 
+void WebContents::Detach() {
+  if (!web_contents() || storage_)
+    return;
+
+  WebContentsDestroyed();
+  Observe(nullptr);
+}
+
+void WebContents::StartRenderProcess() {
+  if (web_contents())
+    web_contents()->GetRenderProcessHost()->Init();
+}
+
 bool WebContents::IsAlive() const {
   return web_contents() != NULL;
 }
@@ -442,6 +565,19 @@ void WebContents::ExecuteJavaScript(const base::string16& code) {
   web_contents()->GetMainFrame()->ExecuteJavaScript(code);
 }
 
+void WebContents::ExecuteJavaScriptBatch(
+    const std::vector<base::string16>& scripts,
+    const ExecuteScriptsCallback& callback) {
+  int request_id = next_scripts_id_++;
+  if (!Send(new AtomViewMsg_ExecuteScripts(routing_id(), request_id,
+                                           scripts))) {
+    v8::Isolate* isolate = v8::Isolate::GetCurrent();
+    callback.Run(v8::Null(isolate));
+    return;
+  }
+  pending_scripts_[request_id] = callback;
+}
+
 void WebContents::OpenDevTools() {
   storage_->SetCanDock(false);
   storage_->ShowDevTools();
@@ -495,9 +631,81 @@ void WebContents::ReplaceMisspelling(const base::string16& word) {
   web_contents()->ReplaceMisspelling(word);
 }
 
-bool WebContents::SendIPCMessage(const base::string16& channel,
-                                 const base::ListValue& args) {
-  return Send(new AtomViewMsg_Message(routing_id(), channel, args));
+bool WebContents::SendIPCMessage(v8::Isolate* isolate,
+                                 const base::string16& channel,
+                                 v8::Handle<v8::Value> args) {
+  SerializedValue serialized;
+  SerializeV8Value(isolate, args, &serialized);
+  if (serialized.size() > kSharedMemoryThreshold) {
+    base::SharedMemoryHandle handle;
+    if (serialized.ShareToProcess(
+            web_contents()->GetRenderProcessHost()->GetHandle(), &handle))
+      return Send(new AtomViewMsg_SharedMessage(
+          routing_id(), channel, handle,
+          static_cast<uint32>(serialized.size())));
+  }
+  return Send(new AtomViewMsg_Message(routing_id(), channel, serialized));
+}
+
+bool WebContents::SendBulkIPCMessage(v8::Isolate* isolate,
+                                     const base::string16& channel,
+                                     v8::Handle<v8::Value> args) {
+  SerializedValue serialized;
+  SerializeV8Value(isolate, args, &serialized);
+  return Send(new AtomViewMsg_BulkMessage(routing_id(), channel, serialized));
+}
+
+// static
+int WebContents::Broadcast(v8::Isolate* isolate,
+                           const base::string16& channel,
+                           v8::Handle<v8::Value> args,
+                           const std::vector<WebContents*>& targets) {
+  SerializedValue serialized;
+  SerializeV8Value(isolate, args, &serialized);
+
+  // Large values are copied into shared memory once, and its handle is shared
+  // with every target like SendIPCMessage.
+  base::SharedMemory memory;
+  bool shared = serialized.size() > kSharedMemoryThreshold &&
+                serialized.CopyToSharedMemory(&memory);
+
+  // Otherwise the message is pickled once, the copies only differ in the
+  // routing id.
+  scoped_ptr<AtomViewMsg_Message> message;
+  int sent = 0;
+  for (WebContents* target : targets) {
+    if (!target || !target->IsAlive())
+      continue;
+    base::SharedMemoryHandle handle;
+    IPC::Message* copy;
+    if (shared && memory.ShareToProcess(
+            target->web_contents()->GetRenderProcessHost()->GetHandle(),
+            &handle)) {
+      copy = new AtomViewMsg_SharedMessage(
+          target->routing_id(), channel, handle,
+          static_cast<uint32>(serialized.size()));
+    } else {
+      if (!message)
+        message.reset(new AtomViewMsg_Message(MSG_ROUTING_NONE, channel,
+                                              serialized));
+      copy = new IPC::Message(*message);
+      copy->set_routing_id(target->routing_id());
+    }
+    if (target->Send(copy))
+      ++sent;
+  }
+  return sent;
+}
+
+bool WebContents::ConnectPort(WebContents* other,
+                              const base::string16& channel,
+                              uint32 capacity) {
+  if (!other || !other->IsAlive())
+    return false;
+  return MessagePortMessageFilter::Connect(
+      web_contents()->GetRenderViewHost(),
+      other->web_contents()->GetRenderViewHost(),
+      channel, capacity);
 }
 
 void WebContents::SetAutoSize(bool enabled,
@@ -527,6 +735,51 @@ void WebContents::SetAutoSize(bool enabled,
   }
 }
 
+void WebContents::PrintToPDF(const base::FilePath& path,
+                             const mate::Dictionary& options,
+                             const PrintToPDFCallback& callback) {
+  PrintToPDFManager::Settings settings;
+  std::string page_size_name;
+  mate::Dictionary page_size;
+  if (options.Get("pageSize", &page_size_name)) {
+    for (size_t i = 0; i < arraysize(kPageSizes); ++i)
+      if (page_size_name == kPageSizes[i].name)
+        settings.page_size.SetSize(kPageSizes[i].width, kPageSizes[i].height);
+  } else if (options.Get("pageSize", &page_size)) {
+    int width = 0, height = 0;
+    if (page_size.Get("width", &width) && page_size.Get("height", &height) &&
+        width > 0 && height > 0)
+      settings.page_size.SetSize(width, height);
+  }
+  int margins_type = printing::DEFAULT_MARGINS;
+  if (options.Get("marginsType", &margins_type) &&
+      margins_type >= printing::DEFAULT_MARGINS &&
+      margins_type <= printing::PRINTABLE_AREA_MARGINS)
+    settings.margins_type = static_cast<printing::MarginType>(margins_type);
+  options.Get("landscape", &settings.landscape);
+  options.Get("printBackground", &settings.print_background);
+  int pages_per_file = 0;
+  if (options.Get("pagesPerFile", &pages_per_file) && pages_per_file > 0)
+    settings.pages_per_file = pages_per_file;
+  std::vector<mate::Dictionary> ranges;
+  if (options.Get("pageRanges", &ranges)) {
+    for (const mate::Dictionary& range : ranges) {
+      int from = 0, to = 0;
+      if (!range.Get("from", &from) || !range.Get("to", &to))
+        continue;
+      to = std::min(to, kMaxPageNumber);
+      for (int page = std::max(from, 0); page <= to; ++page)
+        settings.pages.push_back(page);
+    }
+  }
+
+  content::WebContents* contents = web_contents();
+  PrintToPDFManager::CreateForWebContents(contents);
+  PrintToPDFManager::FromWebContents(contents)->PrintToPDF(
+      settings, path,
+      base::Bind(&OnPrintToPDFDone, isolate(), callback));
+}
+
 void WebContents::SetAllowTransparency(bool allow) {
   if (guest_opaque_ != allow)
     return;
@@ -551,6 +804,8 @@ mate::ObjectTemplateBuilder WebContents::GetObjectTemplateBuilder(
   if (template_.IsEmpty())
     template_.Reset(isolate, mate::ObjectTemplateBuilder(isolate)
         .SetMethod("destroy", &WebContents::Destroy)
+        .SetMethod("_detach", &WebContents::Detach)
+        .SetMethod("_startRenderProcess", &WebContents::StartRenderProcess)
         .SetMethod("isAlive", &WebContents::IsAlive)
         .SetMethod("_loadUrl", &WebContents::LoadURL)
         .SetMethod("getUrl", &WebContents::GetURL)
@@ -573,6 +828,8 @@ mate::ObjectTemplateBuilder WebContents::GetObjectTemplateBuilder(
         .SetMethod("setUserAgent", &WebContents::SetUserAgent)
         .SetMethod("insertCSS", &WebContents::InsertCSS)
         .SetMethod("_executeJavaScript", &WebContents::ExecuteJavaScript)
+        .SetMethod("_executeJavaScriptBatch",
+                   &WebContents::ExecuteJavaScriptBatch)
         .SetMethod("openDevTools", &WebContents::OpenDevTools)
         .SetMethod("closeDevTools", &WebContents::CloseDevTools)
         .SetMethod("isDevToolsOpened", &WebContents::IsDevToolsOpened)
@@ -587,8 +844,12 @@ mate::ObjectTemplateBuilder WebContents::GetObjectTemplateBuilder(
         .SetMethod("replace", &WebContents::Replace)
         .SetMethod("replaceMisspelling", &WebContents::ReplaceMisspelling)
         .SetMethod("_send", &WebContents::SendIPCMessage)
+        .SetMethod("_sendBulk", &WebContents::SendBulkIPCMessage)
+        .SetMethod("_setEventListened", &WebContents::SetEventListened)
+        .SetMethod("_connectPort", &WebContents::ConnectPort)
         .SetMethod("setAutoSize", &WebContents::SetAutoSize)
         .SetMethod("setAllowTransparency", &WebContents::SetAllowTransparency)
+        .SetMethod("_printToPDF", &WebContents::PrintToPDF)
         .SetMethod("isGuest", &WebContents::is_guest)
         .Build());
 
@@ -597,16 +858,193 @@ mate::ObjectTemplateBuilder WebContents::GetObjectTemplateBuilder(
 }
 
 void WebContents::OnRendererMessage(const base::string16& channel,
-                                    const base::ListValue& args) {
+                                    const SerializedValue& args) {
+  TRACE_EVENT1("atom", "WebContents::OnRendererMessage",
+               "channel", base::UTF16ToUTF8(channel));
+  crash_reporter::Breadcrumbs::Add("ipc", channel);
+  v8::Isolate* isolate = v8::Isolate::GetCurrent();
+  v8::Locker locker(isolate);
+  v8::HandleScope handle_scope(isolate);
+  v8::Local<v8::Value> arguments = DeserializeV8Value(isolate, args);
+  if (arguments.IsEmpty())
+    return;
+
   // webContents.emit(channel, new Event(), args...);
-  Emit(base::UTF16ToUTF8(channel), args);
+  Emit(GetChannelName(isolate, channel), arguments);
+}
+
+void WebContents::OnRendererSharedMessage(const base::string16& channel,
+                                          base::SharedMemoryHandle handle,
+                                          uint32 size) {
+#if defined(OS_WIN)
+  // The renderer shares the memory with itself, take the handle over from it.
+  HANDLE duplicated = NULL;
+  if (!::DuplicateHandle(web_contents()->GetRenderProcessHost()->GetHandle(),
+                         handle, ::GetCurrentProcess(), &duplicated, 0, FALSE,
+                         DUPLICATE_SAME_ACCESS | DUPLICATE_CLOSE_SOURCE))
+    return;
+  handle = duplicated;
+#endif
+  scoped_ptr<base::SharedMemory> memory(new base::SharedMemory(handle, true));
+  // The renderer can still write to the memory, so it is copied before being
+  // parsed.
+  SerializedValue args;
+  if (!args.CopyFromSharedMemory(memory.Pass(), size))
+    return;
+  OnRendererMessage(channel, args);
+}
+
+void WebContents::OnRendererBulkMessage(const base::string16& channel,
+                                        const SerializedValue& args) {
+  // The |args| only refers to the message, which is gone after dispatching.
+  linked_ptr<BulkMessage> message(new BulkMessage);
+  message->channel = channel;
+  message->args.CopyFrom(args);
+  bulk_messages_.push_back(message);
+  if (bulk_messages_scheduled_)
+    return;
+
+  // The messages already posted to UI thread, like the ones sent right after
+  // the bulk messages, are emitted first.
+  bulk_messages_scheduled_ = true;
+  base::MessageLoop::current()->PostTask(
+      FROM_HERE,
+      base::Bind(&WebContents::EmitBulkMessages, weak_factory_.GetWeakPtr()));
+}
+
+void WebContents::EmitBulkMessages() {
+  bulk_messages_scheduled_ = false;
+
+  // Only emit a few messages in one task so the other messages can still get
+  // in between them.
+  for (int i = 0; i < kBulkMessagesPerTask && !bulk_messages_.empty(); ++i) {
+    linked_ptr<BulkMessage> message = bulk_messages_.front();
+    bulk_messages_.pop_front();
+    OnRendererMessage(message->channel, message->args);
+  }
+
+  if (!bulk_messages_.empty() && !bulk_messages_scheduled_) {
+    bulk_messages_scheduled_ = true;
+    base::MessageLoop::current()->PostTask(
+        FROM_HERE,
+        base::Bind(&WebContents::EmitBulkMessages,
+                   weak_factory_.GetWeakPtr()));
+  }
+}
+
+void WebContents::OnExecuteScriptsResult(int request_id,
+                                         const SerializedValue& results) {
+  auto it = pending_scripts_.find(request_id);
+  if (it == pending_scripts_.end())
+    return;
+  ExecuteScriptsCallback callback = it->second;
+  pending_scripts_.erase(it);
+
+  v8::Isolate* isolate = v8::Isolate::GetCurrent();
+  v8::Locker locker(isolate);
+  v8::HandleScope handle_scope(isolate);
+  v8::Local<v8::Value> value = DeserializeV8Value(isolate, results);
+  if (value.IsEmpty())
+    value = v8::Null(isolate);
+  callback.Run(value);
+}
+
+void WebContents::CancelPendingScripts() {
+  if (pending_scripts_.empty())
+    return;
+
+  v8::Isolate* isolate = v8::Isolate::GetCurrent();
+  v8::Locker locker(isolate);
+  v8::HandleScope handle_scope(isolate);
+  std::map<int, ExecuteScriptsCallback> pending;
+  pending.swap(pending_scripts_);
+  for (const auto& it : pending)
+    it.second.Run(v8::Null(isolate));
 }
 
 void WebContents::OnRendererMessageSync(const base::string16& channel,
-                                        const base::ListValue& args,
+                                        const SerializedValue& args,
                                         IPC::Message* message) {
+  TRACE_EVENT1("atom", "WebContents::OnRendererMessageSync",
+               "channel", base::UTF16ToUTF8(channel));
+  crash_reporter::Breadcrumbs::Add("ipc-sync", channel);
+  v8::Isolate* isolate = v8::Isolate::GetCurrent();
+  v8::Locker locker(isolate);
+  v8::HandleScope handle_scope(isolate);
+  v8::Local<v8::Value> arguments = DeserializeV8Value(isolate, args);
+  if (arguments.IsEmpty()) {
+    // Do not leave the renderer blocked on a malformed message.
+    AtomViewHostMsg_Message_Sync::WriteReplyParams(message, base::string16());
+    Send(message);
+    return;
+  }
+
   // webContents.emit(channel, new Event(sender, message), args...);
-  EmitWithSender(base::UTF16ToUTF8(channel), web_contents(), message, args);
+  EmitWithSender(GetChannelName(isolate, channel), web_contents(), message,
+                 arguments);
+}
+
+void WebContents::OnOpenStream(const base::string16& channel,
+                               uint32 capacity,
+                               int* id,
+                               base::SharedMemoryHandle* handle,
+                               uint32* size) {
+  *id = -1;
+  *size = RingBuffer::RequiredMemorySize(capacity);
+
+  // Each stream can take 64MB, so a renderer must not open them without
+  // limit.
+  size_t used = *size;
+  for (auto it = streams_.begin(); it != streams_.end(); ++it)
+    used += it->second->memory.mapped_size();
+  if (used > kMaxStreamMemory)
+    return;
+
+  scoped_ptr<IPCStream> stream(new IPCStream);
+  stream->channel = channel;
+  if (!stream->memory.CreateAndMapAnonymous(*size) ||
+      !stream->memory.ShareToProcess(
+          web_contents()->GetRenderProcessHost()->GetHandle(), handle))
+    return;
+  stream->ring.reset(new RingBuffer(stream->memory.memory(), *size));
+  stream->ring->Initialize();
+
+  *id = next_stream_id_++;
+  streams_.set(*id, stream.Pass());
+}
+
+void WebContents::OnStreamDoorbell(int id) {
+  IPCStream* stream = streams_.get(id);
+  if (!stream)
+    return;
+
+  // Drain all records written since last doorbell into one event.
+  v8::Isolate* isolate = v8::Isolate::GetCurrent();
+  v8::Locker locker(isolate);
+  v8::HandleScope handle_scope(isolate);
+  v8::Local<v8::Array> chunks = v8::Array::New(isolate);
+  do {
+    const char* data;
+    uint32 size;
+    while (stream->ring->Peek(&data, &size)) {
+      chunks->Set(chunks->Length(), node::Buffer::New(isolate, data, size));
+      stream->ring->Consume();
+    }
+  } while (!stream->ring->corrupted() && !stream->ring->WaitForDoorbell());
+
+  if (stream->ring->corrupted()) {
+    LOG(ERROR) << "Closing corrupted stream " << id;
+    streams_.erase(id);
+    return;
+  }
+
+  // webContents.emit('ipc-stream', new Event(), channel, chunks);
+  if (chunks->Length() > 0)
+    Emit("ipc-stream", stream->channel, chunks);
+}
+
+void WebContents::OnCloseStream(int id) {
+  streams_.erase(id);
 }
 
 void WebContents::GuestSizeChangedDueToAutoSize(const gfx::Size& old_size,
@@ -640,6 +1078,7 @@ void Initialize(v8::Handle<v8::Object> exports, v8::Handle<v8::Value> unused,
   v8::Isolate* isolate = context->GetIsolate();
   mate::Dictionary dict(isolate, exports);
   dict.SetMethod("create", &atom::api::WebContents::Create);
+  dict.SetMethod("_broadcast", &atom::api::WebContents::Broadcast);
 }
 
 }  // namespace
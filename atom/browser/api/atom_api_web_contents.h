@@ -5,15 +5,28 @@
 #ifndef ATOM_BROWSER_API_ATOM_API_WEB_CONTENTS_H_
 #define ATOM_BROWSER_API_ATOM_API_WEB_CONTENTS_H_
 
+#include <deque>
+#include <map>
 #include <string>
+#include <vector>
 
 #include "atom/browser/api/event_emitter.h"
+#include "atom/common/native_mate_converters/v8_value_serializer.h"
+#include "base/callback.h"
+#include "base/containers/scoped_ptr_hash_map.h"
+#include "base/memory/linked_ptr.h"
+#include "base/memory/shared_memory.h"
+#include "base/memory/weak_ptr.h"
 #include "brightray/browser/default_web_contents_delegate.h"
 #include "content/public/browser/browser_plugin_guest_delegate.h"
 #include "content/public/browser/web_contents_delegate.h"
 #include "content/public/browser/web_contents_observer.h"
 #include "native_mate/handle.h"
 
+namespace base {
+class FilePath;
+}
+
 namespace brightray {
 class InspectableWebContents;
 }
@@ -41,7 +54,20 @@ class WebContents : public mate::EventEmitter,
   static mate::Handle<WebContents> Create(
       v8::Isolate* isolate, const mate::Dictionary& options);
 
+  // Sends the same message to all of |targets|, |args| is only serialized
+  // once. Returns the number of pages the message was sent to.
+  static int Broadcast(v8::Isolate* isolate,
+                       const base::string16& channel,
+                       v8::Handle<v8::Value> args,
+                       const std::vector<WebContents*>& targets);
+
   void Destroy();
+  // Stops following the WebContents, which is given to a new window when its
+  // window is recycled.
+  void Detach();
+  // Launches the render process before anything is loaded, used by the guests
+  // created ahead of time.
+  void StartRenderProcess();
   bool IsAlive() const;
   void LoadURL(const GURL& url, const mate::Dictionary& options);
   GURL GetURL() const;
@@ -64,6 +90,12 @@ class WebContents : public mate::EventEmitter,
   void SetUserAgent(const std::string& user_agent);
   void InsertCSS(const std::string& css);
   void ExecuteJavaScript(const base::string16& code);
+
+  // Runs |scripts| in page with one round trip, |callback| gets an array with
+  // the result or error of each script, or null when the page has gone.
+  typedef base::Callback<void(v8::Handle<v8::Value>)> ExecuteScriptsCallback;
+  void ExecuteJavaScriptBatch(const std::vector<base::string16>& scripts,
+                              const ExecuteScriptsCallback& callback);
   void OpenDevTools();
   void CloseDevTools();
   bool IsDevToolsOpened();
@@ -81,8 +113,17 @@ class WebContents : public mate::EventEmitter,
   void ReplaceMisspelling(const base::string16& word);
 
   // Sending messages to browser.
-  bool SendIPCMessage(const base::string16& channel,
-                      const base::ListValue& args);
+  bool SendIPCMessage(v8::Isolate* isolate,
+                      const base::string16& channel,
+                      v8::Handle<v8::Value> args);
+  bool SendBulkIPCMessage(v8::Isolate* isolate,
+                          const base::string16& channel,
+                          v8::Handle<v8::Value> args);
+
+  // Creates a message port between renderers of this and |other|.
+  bool ConnectPort(WebContents* other,
+                   const base::string16& channel,
+                   uint32 capacity);
 
   // Toggles autosize mode for corresponding <webview>.
   void SetAutoSize(bool enabled,
@@ -92,6 +133,14 @@ class WebContents : public mate::EventEmitter,
   // Sets the transparency of the guest.
   void SetAllowTransparency(bool allow);
 
+  // Prints the page into a PDF file at |path| without showing any dialog.
+  typedef base::Callback<void(v8::Handle<v8::Value>,
+                              const std::vector<base::FilePath>&)>
+      PrintToPDFCallback;
+  void PrintToPDF(const base::FilePath& path,
+                  const mate::Dictionary& options,
+                  const PrintToPDFCallback& callback);
+
   // Returns whether this is a guest view.
   bool is_guest() const { return guest_instance_id_ != -1; }
 
@@ -148,6 +197,8 @@ class WebContents : public mate::EventEmitter,
 
   // content::WebContentsObserver:
   void RenderViewDeleted(content::RenderViewHost*) override;
+  void RenderViewHostChanged(content::RenderViewHost* old_host,
+                             content::RenderViewHost* new_host) override;
   void RenderProcessGone(base::TerminationStatus status) override;
   void DidFinishLoad(content::RenderFrameHost* render_frame_host,
                      const GURL& validated_url) override;
@@ -189,18 +240,61 @@ class WebContents : public mate::EventEmitter,
  private:
   // Called when received a message from renderer.
   void OnRendererMessage(const base::string16& channel,
-                         const base::ListValue& args);
+                         const SerializedValue& args);
+
+  // Called when received a message with arguments in shared memory.
+  void OnRendererSharedMessage(const base::string16& channel,
+                               base::SharedMemoryHandle handle,
+                               uint32 size);
+
+  // Queues the bulk message from renderer, which is emitted after the other
+  // messages that have arrived.
+  void OnRendererBulkMessage(const base::string16& channel,
+                             const SerializedValue& args);
+  void EmitBulkMessages();
 
   // Called when received a synchronous message from renderer.
   void OnRendererMessageSync(const base::string16& channel,
-                             const base::ListValue& args,
+                             const SerializedValue& args,
                              IPC::Message* message);
 
+  // Called when renderer opens, writes to and closes a stream.
+  void OnOpenStream(const base::string16& channel,
+                    uint32 capacity,
+                    int* id,
+                    base::SharedMemoryHandle* handle,
+                    uint32* size);
+  void OnStreamDoorbell(int id);
+  void OnCloseStream(int id);
+
+  // Called when the renderer has run the scripts of |request_id|.
+  void OnExecuteScriptsResult(int request_id, const SerializedValue& results);
+
+  // Runs the callbacks of scripts that would never get results with null.
+  void CancelPendingScripts();
+
   void GuestSizeChangedDueToAutoSize(const gfx::Size& old_size,
                                      const gfx::Size& new_size);
 
   scoped_ptr<WebDialogHelper> web_dialog_helper_;
 
+  // Streams opened by the renderer, keyed by their IDs.
+  struct IPCStream;
+  base::ScopedPtrHashMap<int, IPCStream> streams_;
+  int next_stream_id_;
+
+  // Bulk messages from renderer waiting to be emitted.
+  struct BulkMessage {
+    base::string16 channel;
+    SerializedValue args;
+  };
+  std::deque<linked_ptr<BulkMessage>> bulk_messages_;
+  bool bulk_messages_scheduled_;
+
+  // Callbacks of executeJavaScriptBatch waiting for results.
+  std::map<int, ExecuteScriptsCallback> pending_scripts_;
+  int next_scripts_id_;
+
   // Unique ID for a guest WebContents.
   int guest_instance_id_;
 
@@ -238,6 +332,8 @@ class WebContents : public mate::EventEmitter,
   // The minimum size constraints of the container element in autosize mode.
   gfx::Size min_auto_size_;
 
+  base::WeakPtrFactory<WebContents> weak_factory_;
+
   DISALLOW_COPY_AND_ASSIGN(WebContents);
 };
 
@@ -75,6 +75,20 @@ void AddGuest(int guest_instance_id,
   }
 }
 
+// Registers a guest that is created ahead of time and not attached yet, so its
+// render process can be started with the right switches.
+void AddSpareGuest(int guest_instance_id,
+                   content::WebContents* guest_web_contents,
+                   atom::WebViewManager::WebViewInfo info) {
+  auto manager = GetWebViewManager(guest_web_contents);
+  if (manager) {
+    info.guest_instance_id = guest_instance_id;
+    info.embedder = nullptr;
+    manager->AddGuest(guest_instance_id, -1, nullptr, guest_web_contents,
+                      info);
+  }
+}
+
 void RemoveGuest(content::WebContents* embedder, int guest_instance_id) {
   auto manager = GetWebViewManager(embedder);
   if (manager)
@@ -85,6 +99,7 @@ void Initialize(v8::Handle<v8::Object> exports, v8::Handle<v8::Value> unused,
                 v8::Handle<v8::Context> context, void* priv) {
   mate::Dictionary dict(context->GetIsolate(), exports);
   dict.SetMethod("addGuest", &AddGuest);
+  dict.SetMethod("addSpareGuest", &AddSpareGuest);
   dict.SetMethod("removeGuest", &RemoveGuest);
 }
 
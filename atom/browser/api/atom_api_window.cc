@@ -4,17 +4,36 @@
 
 #include "atom/browser/api/atom_api_window.h"
 
+#include <map>
+#include <utility>
+
 #include "atom/browser/api/atom_api_web_contents.h"
+#include "atom/browser/api/frame_subscriber.h"
 #include "atom/browser/browser.h"
 #include "atom/browser/native_window.h"
+#include "atom/browser/window_list.h"
+#include "atom/browser/window_pool.h"
+#include "atom/common/crash_reporter/breadcrumbs.h"
+#include "atom/common/native_mate_converters/file_path_converter.h"
 #include "atom/common/native_mate_converters/gfx_converter.h"
 #include "atom/common/native_mate_converters/gurl_converter.h"
 #include "atom/common/native_mate_converters/image_converter.h"
 #include "atom/common/native_mate_converters/string16_converter.h"
+#include "base/files/file_util.h"
+#include "base/lazy_instance.h"
+#include "base/strings/string_util.h"
+#include "base/task_runner_util.h"
+#include "chrome/browser/browser_process.h"
+#include "chrome/browser/printing/print_job_manager.h"
+#include "content/public/browser/browser_thread.h"
 #include "content/public/browser/render_process_host.h"
+#include "content/public/browser/render_widget_host_view.h"
+#include "content/public/browser/web_contents.h"
 #include "native_mate/callback.h"
 #include "native_mate/constructor.h"
 #include "native_mate/dictionary.h"
+#include "ui/gfx/codec/jpeg_codec.h"
+#include "ui/gfx/codec/png_codec.h"
 
 #include "atom/common/node_includes.h"
 
@@ -42,6 +61,19 @@ struct Converter<PrintSettings> {
   }
 };
 
+template<>
+struct Converter<atom::FrameStats> {
+  static v8::Handle<v8::Value> ToV8(v8::Isolate* isolate,
+                                    const atom::FrameStats& val) {
+    mate::Dictionary dict(isolate, v8::Object::New(isolate));
+    dict.Set("framesPresented", static_cast<double>(val.frames_presented));
+    dict.Set("framesDropped", static_cast<double>(val.frames_dropped));
+    dict.Set("averageFrameTime", val.average_frame_time.InMillisecondsF());
+    dict.Set("worstFrameTime", val.worst_frame_time.InMillisecondsF());
+    return dict.GetHandle();
+  }
+};
+
 }  // namespace mate
 
 namespace atom {
@@ -50,6 +82,14 @@ namespace api {
 
 namespace {
 
+// The frame rate of subscriptions when it is not specified.
+const int kDefaultMaxFps = 30;
+const int kMaxFps = 60;
+
+// The JS objects of the native windows that have not been closed.
+typedef std::map<NativeWindow*, Window*> WindowMap;
+base::LazyInstance<WindowMap>::Leaky g_windows = LAZY_INSTANCE_INITIALIZER;
+
 void OnCapturePageDone(
     v8::Isolate* isolate,
     const base::Callback<void(const gfx::Image&)>& callback,
@@ -59,18 +99,141 @@ void OnCapturePageDone(
   callback.Run(gfx::Image::CreateFrom1xBitmap(bitmap));
 }
 
+typedef base::Callback<void(v8::Handle<v8::Value>)> CaptureToFileCallback;
+
+// Runs on the blocking pool, the encoded data never reaches JS.
+bool WriteBitmapToFile(const SkBitmap& bitmap,
+                       const base::FilePath& path,
+                       bool jpeg,
+                       int quality) {
+  std::vector<unsigned char> output;
+  if (jpeg) {
+    SkAutoLockPixels lock(bitmap);
+    if (!bitmap.getPixels() ||
+        !gfx::JPEGCodec::Encode(
+            static_cast<const unsigned char*>(bitmap.getPixels()),
+            gfx::JPEGCodec::FORMAT_SkBitmap, bitmap.width(), bitmap.height(),
+            static_cast<int>(bitmap.rowBytes()), quality, &output))
+      return false;
+  } else if (!gfx::PNGCodec::EncodeBGRASkBitmap(bitmap, false, &output)) {
+    return false;
+  }
+
+  int size = static_cast<int>(output.size());
+  return base::WriteFile(path, reinterpret_cast<const char*>(output.data()),
+                         size) == size;
+}
+
+void OnCaptureWritten(v8::Isolate* isolate,
+                      const CaptureToFileCallback& callback,
+                      bool success) {
+  v8::Locker locker(isolate);
+  v8::HandleScope handle_scope(isolate);
+  if (success)
+    callback.Run(v8::Null(isolate));
+  else
+    callback.Run(v8::Exception::Error(mate::StringToV8(
+        isolate, "Failed to write the captured page")));
+}
+
+typedef base::Callback<void(v8::Handle<v8::Value>)> PrintCallback;
+
+void OnPrintDone(v8::Isolate* isolate,
+                 const PrintCallback& callback,
+                 bool success) {
+  v8::Locker locker(isolate);
+  v8::HandleScope handle_scope(isolate);
+  if (success)
+    callback.Run(v8::Null(isolate));
+  else
+    callback.Run(v8::Exception::Error(mate::StringToV8(
+        isolate, "Printing failed or was canceled")));
+}
+
+void OnCapturePageToFileDone(v8::Isolate* isolate,
+                             const base::FilePath& path,
+                             bool jpeg,
+                             int quality,
+                             const CaptureToFileCallback& callback,
+                             const SkBitmap& bitmap) {
+  if (bitmap.isNull()) {
+    OnCaptureWritten(isolate, callback, false);
+    return;
+  }
+
+  base::PostTaskAndReplyWithResult(
+      content::BrowserThread::GetBlockingPool()->
+          GetTaskRunnerWithShutdownBehavior(
+              base::SequencedWorkerPool::CONTINUE_ON_SHUTDOWN).get(),
+      FROM_HERE,
+      base::Bind(&WriteBitmapToFile, bitmap, path, jpeg, quality),
+      base::Bind(&OnCaptureWritten, isolate, callback));
+}
+
 }  // namespace
 
 
-Window::Window(const mate::Dictionary& options)
-    : window_(NativeWindow::Create(options)) {
+Window::Window(const mate::Dictionary& options) {
+  // Reuse a recycled window with the same options if there is any.
+  if (WindowPool::GetProfile(options, &pool_profile_)) {
+    window_ = WindowPool::GetInstance()->Take(pool_profile_);
+    if (window_)
+      window_->Reopen(options);
+  }
+  if (!window_)
+    window_.reset(NativeWindow::Create(options));
+
+  window_->set_recyclable(!pool_profile_.empty());
   window_->InitFromOptions(options);
   window_->AddObserver(this);
+  g_windows.Get()[window_.get()] = this;
+
+  // A recycled window already has the view of its page.
+  if (window_->is_offscreen())
+    SubscribeOffscreenFrames();
 }
 
 Window::~Window() {
   if (window_)
     Destroy();
+  if (window_)
+    g_windows.Get().erase(window_.get());
+}
+
+// static
+v8::Handle<v8::Value> Window::FromWebContents(v8::Isolate* isolate,
+                                              WebContents* web_contents) {
+  WindowMap& windows = g_windows.Get();
+  auto it = windows.find(
+      NativeWindow::FromWebContents(web_contents->web_contents()));
+  if (it == windows.end())
+    return v8::Null(isolate);
+  return it->second->GetWrapper(isolate);
+}
+
+// static
+v8::Handle<v8::Value> Window::GetFocusedWindow(v8::Isolate* isolate) {
+  WindowMap& windows = g_windows.Get();
+  WindowList* window_list = WindowList::GetInstance();
+  for (auto w = window_list->begin(); w != window_list->end(); ++w) {
+    if (!(*w)->IsFocused())
+      continue;
+    auto it = windows.find(*w);
+    if (it != windows.end())
+      return it->second->GetWrapper(isolate);
+  }
+  return v8::Null(isolate);
+}
+
+// static
+void Window::SetBoundsForWindows(const std::vector<NativeWindow*>& windows,
+                                 const std::vector<gfx::Rect>& bounds,
+                                 bool animate) {
+  NativeWindow::BoundsList bounds_list;
+  for (size_t i = 0; i < windows.size() && i < bounds.size(); ++i)
+    if (windows[i])
+      bounds_list.push_back(std::make_pair(windows[i], bounds[i]));
+  NativeWindow::SetBoundsForWindows(bounds_list, animate);
 }
 
 void Window::OnPageTitleUpdated(bool* prevent_default,
@@ -94,9 +257,18 @@ void Window::WillCloseWindow(bool* prevent_default) {
 }
 
 void Window::OnWindowClosed() {
+  crash_reporter::Breadcrumbs::Add("window", "closed");
   Emit("closed");
 
+  // The page may still draw before it is destroyed.
+  if (window_->is_offscreen() && window_->GetWebContents())
+    EndFrameSubscription();
   window_->RemoveObserver(this);
+  g_windows.Get().erase(window_.get());
+
+  // The recycled window belongs to the pool now.
+  if (window_->is_recycled())
+    WindowPool::GetInstance()->Add(pool_profile_, window_.Pass());
 }
 
 void Window::OnWindowBlur() {
@@ -131,6 +303,14 @@ void Window::OnWindowLeaveFullScreen() {
   Emit("leave-full-screen");
 }
 
+void Window::OnWindowMove(const gfx::Rect& bounds) {
+  Emit("move", bounds);
+}
+
+void Window::OnWindowResize(const gfx::Rect& bounds) {
+  Emit("resize", bounds);
+}
+
 void Window::OnRendererUnresponsive() {
   Emit("unresponsive");
 }
@@ -143,6 +323,33 @@ void Window::OnDevToolsFocus() {
   Emit("devtools-focused");
 }
 
+void Window::OnFrameStats(const FrameStats& stats) {
+  Emit("frame-stats", stats);
+}
+
+void Window::OnRenderViewCreated() {
+  if (window_->is_offscreen())
+    SubscribeOffscreenFrames();
+}
+
+void Window::SubscribeOffscreenFrames() {
+  content::RenderWidgetHostView* view =
+      window_->GetWebContents()->GetRenderWidgetHostView();
+  if (!view)
+    return;
+
+  // The subscriber is owned by the view, which goes away with the window.
+  view->BeginFrameSubscription(make_scoped_ptr(new FrameSubscriber(
+      v8::Isolate::GetCurrent(), view, gfx::Size(),
+      window_->offscreen_frame_rate(),
+      base::Bind(&Window::OnOffscreenFrame, base::Unretained(this)))));
+}
+
+void Window::OnOffscreenFrame(v8::Handle<v8::Value> frame,
+                              v8::Handle<v8::Value> info) {
+  Emit("paint", frame, info);
+}
+
 // static
 mate::Wrappable* Window::New(v8::Isolate* isolate,
                              const mate::Dictionary& options) {
@@ -154,19 +361,24 @@ mate::Wrappable* Window::New(v8::Isolate* isolate,
 }
 
 void Window::Destroy() {
+  if (!window_)
+    return;
+
   window_->DestroyWebContents();
   window_->CloseImmediately();
 }
 
 void Window::Close() {
+  crash_reporter::Breadcrumbs::Add("window", "close");
   window_->Close();
 }
 
 bool Window::IsClosed() {
-  return window_->IsClosed();
+  return !window_ || window_->IsClosed();
 }
 
 void Window::Focus() {
+  crash_reporter::Breadcrumbs::Add("window", "focus");
   window_->Focus(true);
 }
 
@@ -175,15 +387,21 @@ bool Window::IsFocused() {
 }
 
 void Window::Show() {
+  crash_reporter::Breadcrumbs::Add("window", "show");
   window_->Show();
+  window_->UpdateBackgroundThrottling();
 }
 
 void Window::ShowInactive() {
+  crash_reporter::Breadcrumbs::Add("window", "show-inactive");
   window_->ShowInactive();
+  window_->UpdateBackgroundThrottling();
 }
 
 void Window::Hide() {
+  crash_reporter::Breadcrumbs::Add("window", "hide");
   window_->Hide();
+  window_->UpdateBackgroundThrottling();
 }
 
 bool Window::IsVisible() {
@@ -191,10 +409,12 @@ bool Window::IsVisible() {
 }
 
 void Window::Maximize() {
+  crash_reporter::Breadcrumbs::Add("window", "maximize");
   window_->Maximize();
 }
 
 void Window::Unmaximize() {
+  crash_reporter::Breadcrumbs::Add("window", "unmaximize");
   window_->Unmaximize();
 }
 
@@ -203,10 +423,12 @@ bool Window::IsMaximized() {
 }
 
 void Window::Minimize() {
+  crash_reporter::Breadcrumbs::Add("window", "minimize");
   window_->Minimize();
 }
 
 void Window::Restore() {
+  crash_reporter::Breadcrumbs::Add("window", "restore");
   window_->Restore();
 }
 
@@ -215,6 +437,8 @@ bool Window::IsMinimized() {
 }
 
 void Window::SetFullScreen(bool fullscreen) {
+  crash_reporter::Breadcrumbs::Add(
+      "window", fullscreen ? "enter-full-screen" : "leave-full-screen");
   window_->SetFullScreen(fullscreen);
 }
 
@@ -302,6 +526,14 @@ std::vector<int> Window::GetPosition() {
   return result;
 }
 
+void Window::SetBounds(const gfx::Rect& bounds, bool animate) {
+  window_->SetBounds(bounds, animate);
+}
+
+gfx::Rect Window::GetBounds() {
+  return gfx::Rect(window_->GetPosition(), window_->GetSize());
+}
+
 void Window::SetTitle(const std::string& title) {
   window_->SetTitle(title);
 }
@@ -371,34 +603,174 @@ bool Window::IsDocumentEdited() {
 }
 
 void Window::CapturePage(mate::Arguments* args) {
+  int length = args->Length();
   gfx::Rect rect;
+  mate::Dictionary options;
   base::Callback<void(const gfx::Image&)> callback;
 
-  if (!(args->Length() == 1 && args->GetNext(&callback)) &&
-      !(args->Length() == 2 && args->GetNext(&rect)
-                            && args->GetNext(&callback))) {
+  // The |rect| and |options| are optional.
+  int consumed = args->GetNext(&rect) ? 1 : 0;
+  bool has_options = length - consumed == 2;
+  if (length - consumed > 2 ||
+      (has_options && !args->GetNext(&options)) ||
+      !args->GetNext(&callback)) {
     args->ThrowError();
     return;
   }
 
+  gfx::Size size;
+  if (has_options)
+    options.Get("size", &size);
+
   window_->CapturePage(
-      rect, base::Bind(&OnCapturePageDone, args->isolate(), callback));
+      rect, size, base::Bind(&OnCapturePageDone, args->isolate(), callback));
 }
 
-void Window::Print(mate::Arguments* args) {
-  PrintSettings settings = { false, false };;
-  if (args->Length() == 1 && !args->GetNext(&settings)) {
+void Window::CapturePageToFile(mate::Arguments* args) {
+  int length = args->Length();
+  gfx::Rect rect;
+  base::FilePath path;
+  mate::Dictionary options;
+  CaptureToFileCallback callback;
+
+  // The |rect| and |options| are optional.
+  int consumed = args->GetNext(&rect) ? 1 : 0;
+  bool has_options = length - consumed == 3;
+  if (!args->GetNext(&path) ||
+      (has_options && !args->GetNext(&options)) ||
+      !args->GetNext(&callback)) {
     args->ThrowError();
     return;
   }
 
-  window_->Print(settings.silent, settings.print_background);
+  std::string format;
+  int quality = 90;
+  gfx::Size size;
+  if (has_options) {
+    options.Get("format", &format);
+    options.Get("quality", &quality);
+    options.Get("size", &size);
+  }
+  if (format.empty()) {
+    base::FilePath::StringType extension =
+        base::StringToLowerASCII(path.Extension());
+    format = (extension == FILE_PATH_LITERAL(".jpg") ||
+              extension == FILE_PATH_LITERAL(".jpeg")) ? "jpeg" : "png";
+  }
+  if (format != "png" && format != "jpeg") {
+    args->ThrowError("The format should be png or jpeg");
+    return;
+  }
+
+  window_->CapturePage(rect, size, base::Bind(
+      &OnCapturePageToFileDone, args->isolate(), path, format == "jpeg",
+      quality, callback));
+}
+
+void Window::BeginFrameSubscription(mate::Arguments* args) {
+  mate::Dictionary options;
+  FrameSubscriber::FrameCaptureCallback callback;
+  if (!(args->Length() == 1 && args->GetNext(&callback)) &&
+      !(args->Length() == 2 && args->GetNext(&options)
+                            && args->GetNext(&callback))) {
+    args->ThrowError();
+    return;
+  }
+
+  gfx::Size size;
+  int max_fps = kDefaultMaxFps;
+  if (args->Length() == 2) {
+    options.Get("size", &size);
+    options.Get("maxFps", &max_fps);
+  }
+  if (max_fps <= 0 || max_fps > kMaxFps) {
+    args->ThrowError("maxFps must be between 1 and 60");
+    return;
+  }
+
+  content::RenderWidgetHostView* view =
+      window_->GetWebContents()->GetRenderWidgetHostView();
+  if (!view) {
+    args->ThrowError("The page has no view to capture");
+    return;
+  }
+
+  // The view owns the subscriber, and replaces the old one if there was any.
+  view->BeginFrameSubscription(make_scoped_ptr(new FrameSubscriber(
+      args->isolate(), view, size, max_fps, callback)));
+}
+
+void Window::EndFrameSubscription() {
+  content::RenderWidgetHostView* view =
+      window_->GetWebContents()->GetRenderWidgetHostView();
+  if (view)
+    view->EndFrameSubscription();
+}
+
+int Window::Print(mate::Arguments* args) {
+  PrintSettings settings = { false, false };
+  printing::PrintProgressCallback progress;
+  PrintCallback callback;
+  if (!args->GetNext(&settings) || !args->GetNext(&progress) ||
+      !args->GetNext(&callback)) {
+    args->ThrowError();
+    return -1;
+  }
+
+  return g_browser_process->print_job_manager()->QueuePrintJob(
+      window_->GetWebContents(),
+      settings.silent,
+      settings.print_background,
+      progress,
+      base::Bind(&OnPrintDone, args->isolate(), callback));
+}
+
+bool Window::CancelPrint(int job_id) {
+  return g_browser_process->print_job_manager()->CancelPrintJob(job_id);
+}
+
+void Window::SetBackgroundThrottling(mate::Arguments* args,
+                                     const std::string& mode) {
+  if (mode == "full")
+    window_->SetBackgroundThrottling(NativeWindow::BACKGROUND_THROTTLING_FULL);
+  else if (mode == "throttled")
+    window_->SetBackgroundThrottling(
+        NativeWindow::BACKGROUND_THROTTLING_THROTTLED);
+  else if (mode == "suspended")
+    window_->SetBackgroundThrottling(
+        NativeWindow::BACKGROUND_THROTTLING_SUSPENDED);
+  else
+    args->ThrowError("Unknown throttling mode: " + mode);
+}
+
+FrameStats Window::GetFrameStats() {
+  return window_->GetFrameStats();
+}
+
+void Window::SetFrameStatsInterval(int interval_ms) {
+  window_->SetFrameStatsInterval(
+      base::TimeDelta::FromMilliseconds(interval_ms));
+}
+
+std::string Window::GetBackgroundThrottling() {
+  switch (window_->background_throttling()) {
+    case NativeWindow::BACKGROUND_THROTTLING_THROTTLED:
+      return "throttled";
+    case NativeWindow::BACKGROUND_THROTTLING_SUSPENDED:
+      return "suspended";
+    default:
+      return "full";
+  }
 }
 
 void Window::SetProgressBar(double progress) {
   window_->SetProgressBar(progress);
 }
 
+void Window::SetInterceptNewWindow(bool intercept) {
+  window_->set_intercept_new_window(intercept);
+}
+
 void Window::SetOverlayIcon(const gfx::Image& overlay,
                             const std::string& description) {
   window_->SetOverlayIcon(overlay, description);
@@ -479,6 +851,8 @@ void Window::BuildPrototype(v8::Isolate* isolate,
       .SetMethod("center", &Window::Center)
       .SetMethod("setPosition", &Window::SetPosition)
       .SetMethod("getPosition", &Window::GetPosition)
+      .SetMethod("_setBounds", &Window::SetBounds)
+      .SetMethod("getBounds", &Window::GetBounds)
       .SetMethod("setTitle", &Window::SetTitle)
       .SetMethod("getTitle", &Window::GetTitle)
       .SetMethod("flashFrame", &Window::FlashFrame)
@@ -490,6 +864,7 @@ void Window::BuildPrototype(v8::Isolate* isolate,
       .SetMethod("setDocumentEdited", &Window::SetDocumentEdited)
       .SetMethod("isDocumentEdited", &Window::IsDocumentEdited)
       .SetMethod("_openDevTools", &Window::OpenDevTools)
+      .SetMethod("_setInterceptNewWindow", &Window::SetInterceptNewWindow)
       .SetMethod("closeDevTools", &Window::CloseDevTools)
       .SetMethod("isDevToolsOpened", &Window::IsDevToolsOpened)
       .SetMethod("inspectElement", &Window::InspectElement)
@@ -497,7 +872,15 @@ void Window::BuildPrototype(v8::Isolate* isolate,
       .SetMethod("blurWebView", &Window::BlurWebView)
       .SetMethod("isWebViewFocused", &Window::IsWebViewFocused)
       .SetMethod("capturePage", &Window::CapturePage)
-      .SetMethod("print", &Window::Print)
+      .SetMethod("capturePageToFile", &Window::CapturePageToFile)
+      .SetMethod("beginFrameSubscription", &Window::BeginFrameSubscription)
+      .SetMethod("endFrameSubscription", &Window::EndFrameSubscription)
+      .SetMethod("_print", &Window::Print)
+      .SetMethod("cancelPrint", &Window::CancelPrint)
+      .SetMethod("setBackgroundThrottling", &Window::SetBackgroundThrottling)
+      .SetMethod("getBackgroundThrottling", &Window::GetBackgroundThrottling)
+      .SetMethod("getFrameStats", &Window::GetFrameStats)
+      .SetMethod("setFrameStatsInterval", &Window::SetFrameStatsInterval)
       .SetMethod("setProgressBar", &Window::SetProgressBar)
       .SetMethod("setOverlayIcon", &Window::SetOverlayIcon)
       .SetMethod("setAutoHideMenuBar", &Window::SetAutoHideMenuBar)
@@ -531,6 +914,9 @@ void Initialize(v8::Handle<v8::Object> exports, v8::Handle<v8::Value> unused,
       isolate, "BrowserWindow", base::Bind(&Window::New));
   mate::Dictionary dict(isolate, exports);
   dict.Set("BrowserWindow", static_cast<v8::Handle<v8::Value>>(constructor));
+  dict.SetMethod("_fromWebContents", &Window::FromWebContents);
+  dict.SetMethod("_getFocusedWindow", &Window::GetFocusedWindow);
+  dict.SetMethod("_setBoundsForWindows", &Window::SetBoundsForWindows);
 }
 
 }  // namespace
@@ -38,6 +38,18 @@ class Window : public mate::EventEmitter,
   static void BuildPrototype(v8::Isolate* isolate,
                              v8::Handle<v8::ObjectTemplate> prototype);
 
+  // Returns the JS object of the window showing |web_contents|, or null.
+  static v8::Handle<v8::Value> FromWebContents(v8::Isolate* isolate,
+                                               WebContents* web_contents);
+
+  // Returns the JS object of the focused window, or null.
+  static v8::Handle<v8::Value> GetFocusedWindow(v8::Isolate* isolate);
+
+  // Sets the bounds of |windows| to |bounds| of the same index together.
+  static void SetBoundsForWindows(const std::vector<NativeWindow*>& windows,
+                                  const std::vector<gfx::Rect>& bounds,
+                                  bool animate);
+
   NativeWindow* window() const { return window_.get(); }
 
  protected:
@@ -62,11 +74,21 @@ class Window : public mate::EventEmitter,
   void OnWindowRestore() override;
   void OnWindowEnterFullScreen() override;
   void OnWindowLeaveFullScreen() override;
+  void OnWindowMove(const gfx::Rect& bounds) override;
+  void OnWindowResize(const gfx::Rect& bounds) override;
   void OnRendererUnresponsive() override;
   void OnRendererResponsive() override;
   void OnDevToolsFocus() override;
+  void OnFrameStats(const FrameStats& stats) override;
+  void OnRenderViewCreated() override;
 
  private:
+  // Delivers the frames of an offscreen window with "paint" events, the
+  // subscription is made again for each new view of page.
+  void SubscribeOffscreenFrames();
+  void OnOffscreenFrame(v8::Handle<v8::Value> frame,
+                        v8::Handle<v8::Value> info);
+
   // APIs for NativeWindow.
   void Destroy();
   void Close();
@@ -100,6 +122,8 @@ class Window : public mate::EventEmitter,
   void Center();
   void SetPosition(int x, int y);
   std::vector<int> GetPosition();
+  void SetBounds(const gfx::Rect& bounds, bool animate);
+  gfx::Rect GetBounds();
   void SetTitle(const std::string& title);
   std::string GetTitle();
   void FlashFrame(bool flash);
@@ -118,8 +142,17 @@ class Window : public mate::EventEmitter,
   void SetDocumentEdited(bool edited);
   bool IsDocumentEdited();
   void CapturePage(mate::Arguments* args);
-  void Print(mate::Arguments* args);
+  void CapturePageToFile(mate::Arguments* args);
+  void BeginFrameSubscription(mate::Arguments* args);
+  void EndFrameSubscription();
+  int Print(mate::Arguments* args);
+  bool CancelPrint(int job_id);
+  void SetBackgroundThrottling(mate::Arguments* args, const std::string& mode);
+  std::string GetBackgroundThrottling();
+  FrameStats GetFrameStats();
+  void SetFrameStatsInterval(int interval_ms);
   void SetProgressBar(double progress);
+  void SetInterceptNewWindow(bool intercept);
   void SetOverlayIcon(const gfx::Image& overlay,
                       const std::string& description);
   void SetAutoHideMenuBar(bool auto_hide);
@@ -140,6 +173,9 @@ class Window : public mate::EventEmitter,
 
   scoped_ptr<NativeWindow> window_;
 
+  // The profile in WindowPool, empty if the window can not be recycled.
+  std::string pool_profile_;
+
   DISALLOW_COPY_AND_ASSIGN(Window);
 };
 
@@ -0,0 +1,98 @@
+// Copyright (c) 2015 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#include "atom/browser/api/atom_api_worker.h"
+
+#include "atom/browser/script_worker.h"
+#include "atom/common/native_mate_converters/file_path_converter.h"
+#include "atom/common/native_mate_converters/v8_value_serializer.h"
+#include "base/bind.h"
+#include "native_mate/constructor.h"
+#include "native_mate/dictionary.h"
+
+#include "atom/common/node_includes.h"
+
+namespace atom {
+
+namespace api {
+
+Worker::Worker(const base::FilePath& script)
+    : weak_factory_(this) {
+  worker_ = new ScriptWorker(
+      script,
+      base::Bind(&Worker::OnMessage, weak_factory_.GetWeakPtr()),
+      base::Bind(&Worker::OnError, weak_factory_.GetWeakPtr()));
+}
+
+Worker::~Worker() {
+  worker_->Terminate();
+}
+
+// static
+mate::Wrappable* Worker::New(const base::FilePath& script) {
+  Worker* worker = new Worker(script);
+  if (!worker->worker_->Start()) {
+    delete worker;
+    node::ThrowError(
+        "Unable to start the worker, only one worker can run at a time");
+    return nullptr;
+  }
+  return worker;
+}
+
+void Worker::PostMessage(v8::Isolate* isolate, v8::Handle<v8::Value> args) {
+  scoped_ptr<SerializedValue> serialized(new SerializedValue);
+  SerializeV8Value(isolate, args, serialized.get());
+  worker_->PostMessage(serialized.Pass());
+}
+
+void Worker::Terminate() {
+  worker_->Terminate();
+}
+
+void Worker::OnMessage(scoped_ptr<SerializedValue> args) {
+  v8::Isolate* isolate = v8::Isolate::GetCurrent();
+  v8::Locker locker(isolate);
+  v8::HandleScope handle_scope(isolate);
+  v8::Local<v8::Value> arguments = DeserializeV8Value(isolate, *args);
+  if (arguments.IsEmpty())
+    return;
+
+  // worker.emit('-message', new Event(), args);
+  Emit("-message", arguments);
+}
+
+void Worker::OnError(const std::string& message) {
+  // worker.emit('-error', new Event(), message);
+  Emit("-error", message);
+}
+
+// static
+void Worker::BuildPrototype(v8::Isolate* isolate,
+                            v8::Handle<v8::ObjectTemplate> prototype) {
+  mate::ObjectTemplateBuilder(isolate, prototype)
+      .SetMethod("_postMessage", &Worker::PostMessage)
+      .SetMethod("terminate", &Worker::Terminate);
+}
+
+}  // namespace api
+
+}  // namespace atom
+
+
+namespace {
+
+void Initialize(v8::Handle<v8::Object> exports, v8::Handle<v8::Value> unused,
+                v8::Handle<v8::Context> context, void* priv) {
+  using atom::api::Worker;
+  v8::Isolate* isolate = context->GetIsolate();
+  v8::Handle<v8::Function> constructor = mate::CreateConstructor<Worker>(
+      isolate, "Worker", base::Bind(&Worker::New));
+  mate::Dictionary dict(isolate, exports);
+  dict.Set("Worker", static_cast<v8::Handle<v8::Value>>(constructor));
+}
+
+}  // namespace
+
+NODE_MODULE_CONTEXT_AWARE_BUILTIN(atom_browser_worker, Initialize)
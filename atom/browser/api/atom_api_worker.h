@@ -0,0 +1,55 @@
+// Copyright (c) 2015 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#ifndef ATOM_BROWSER_API_ATOM_API_WORKER_H_
+#define ATOM_BROWSER_API_ATOM_API_WORKER_H_
+
+#include <string>
+
+#include "atom/browser/api/event_emitter.h"
+#include "base/memory/ref_counted.h"
+#include "base/memory/scoped_ptr.h"
+#include "base/memory/weak_ptr.h"
+
+namespace base {
+class FilePath;
+}
+
+namespace atom {
+
+class ScriptWorker;
+class SerializedValue;
+
+namespace api {
+
+class Worker : public mate::EventEmitter {
+ public:
+  static mate::Wrappable* New(const base::FilePath& script);
+
+  static void BuildPrototype(v8::Isolate* isolate,
+                             v8::Handle<v8::ObjectTemplate> prototype);
+
+ protected:
+  explicit Worker(const base::FilePath& script);
+  virtual ~Worker();
+
+ private:
+  void PostMessage(v8::Isolate* isolate, v8::Handle<v8::Value> args);
+  void Terminate();
+
+  void OnMessage(scoped_ptr<SerializedValue> args);
+  void OnError(const std::string& message);
+
+  scoped_refptr<ScriptWorker> worker_;
+
+  base::WeakPtrFactory<Worker> weak_factory_;
+
+  DISALLOW_COPY_AND_ASSIGN(Worker);
+};
+
+}  // namespace api
+
+}  // namespace atom
+
+#endif  // ATOM_BROWSER_API_ATOM_API_WORKER_H_
@@ -19,7 +19,8 @@ v8::Persistent<v8::ObjectTemplate> template_;
 
 Event::Event()
     : sender_(NULL),
-      message_(NULL) {
+      message_(NULL),
+      default_prevented_(false) {
 }
 
 Event::~Event() {
@@ -52,6 +53,7 @@ void Event::WebContentsDestroyed() {
 }
 
 void Event::PreventDefault(v8::Isolate* isolate) {
+  default_prevented_ = true;
   GetWrapper(isolate)->Set(StringToV8(isolate, "defaultPrevented"),
                            v8::True(isolate));
 }
@@ -29,6 +29,8 @@ class Event : public Wrappable,
   // event.sendReply(json), used for replying synchronous message.
   bool SendReply(const base::string16& json);
 
+  bool default_prevented() const { return default_prevented_; }
+
  protected:
   Event();
   virtual ~Event();
@@ -44,6 +46,8 @@ class Event : public Wrappable,
   content::WebContents* sender_;
   IPC::Message* message_;
 
+  bool default_prevented_;
+
   DISALLOW_COPY_AND_ASSIGN(Event);
 };
 
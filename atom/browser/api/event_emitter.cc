@@ -5,6 +5,7 @@
 #include "atom/browser/api/event_emitter.h"
 
 #include "atom/browser/api/event.h"
+#include "base/debug/trace_event.h"
 #include "native_mate/arguments.h"
 #include "native_mate/object_template_builder.h"
 
@@ -15,9 +16,21 @@ namespace mate {
 namespace {
 
 v8::Persistent<v8::ObjectTemplate> event_template;
+v8::Persistent<v8::String> emit_key;
+v8::Persistent<v8::String> default_prevented_key;
+
+v8::Local<v8::String> GetKey(v8::Isolate* isolate,
+                             v8::Persistent<v8::String>* key,
+                             const char* name) {
+  if (key->IsEmpty())
+    key->Reset(isolate, v8::String::NewFromUtf8(
+        isolate, name, v8::String::kInternalizedString));
+  return v8::Local<v8::String>::New(isolate, *key);
+}
 
 void PreventDefault(mate::Arguments* args) {
-  args->GetThis()->Set(StringToV8(args->isolate(), "defaultPrevented"),
+  args->GetThis()->Set(GetKey(args->isolate(), &default_prevented_key,
+                              "defaultPrevented"),
                        v8::True(args->isolate()));
 }
 
@@ -35,34 +48,50 @@ v8::Local<v8::Object> CreateEventObject(v8::Isolate* isolate) {
 
 }  // namespace
 
-EventEmitter::EventEmitter() {
+EventEmitter::EventEmitter() : tracks_listeners_(false) {
+}
+
+void EventEmitter::SetEventListened(const std::string& name, bool listened) {
+  tracks_listeners_ = true;
+  if (listened)
+    listened_events_.insert(name);
+  else
+    listened_events_.erase(name);
+}
+
+bool EventEmitter::IsEventListened(const base::StringPiece& name) const {
+  return !tracks_listeners_ ||
+         listened_events_.find(name.as_string()) != listened_events_.end();
 }
 
 bool EventEmitter::CallEmit(v8::Isolate* isolate,
-                            const base::StringPiece& name,
                             content::WebContents* sender,
                             IPC::Message* message,
-                            ValueArray args) {
-  v8::Handle<v8::Object> event;
-  bool use_native_event = sender && message;
-
-  if (use_native_event) {
+                            ValueArray* args) {
+  TRACE_EVENT0("atom", "EventEmitter::CallEmit");
+  v8::Handle<v8::Object> wrapper = GetWrapper(isolate);
+  v8::Local<v8::Value> emit =
+      wrapper->Get(GetKey(isolate, &emit_key, "emit"));
+  if (!emit->IsFunction())
+    return false;
+
+  // this.emit(name, event, args...);
+  if (sender && message) {
     mate::Handle<mate::Event> native_event = mate::Event::Create(isolate);
     native_event->SetSenderAndMessage(sender, message);
-    event = v8::Handle<v8::Object>::Cast(native_event.ToV8());
-  } else {
-    event = CreateEventObject(isolate);
+    (*args)[1] = native_event.ToV8();
+    node::MakeCallback(isolate, wrapper, v8::Local<v8::Function>::Cast(emit),
+                       args->size(), &args->front());
+    // Native events keep the flag themselves, no property lookup is needed.
+    return native_event->default_prevented();
   }
 
-  // args = [name, event, args...];
-  args.insert(args.begin(), event);
-  args.insert(args.begin(), mate::StringToV8(isolate, name));
-
-  // this.emit.apply(this, args);
-  node::MakeCallback(isolate, GetWrapper(isolate), "emit", args.size(),
-                     &args[0]);
-
-  return event->Get(StringToV8(isolate, "defaultPrevented"))->BooleanValue();
+  v8::Local<v8::Object> event = CreateEventObject(isolate);
+  (*args)[1] = event;
+  node::MakeCallback(isolate, wrapper, v8::Local<v8::Function>::Cast(emit),
+                     args->size(), &args->front());
+  return event->Get(GetKey(isolate, &default_prevented_key,
+                           "defaultPrevented"))->BooleanValue();
 }
 
 }  // namespace mate
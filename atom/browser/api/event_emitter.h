@@ -5,6 +5,8 @@
 #ifndef ATOM_BROWSER_API_EVENT_EMITTER_H_
 #define ATOM_BROWSER_API_EVENT_EMITTER_H_
 
+#include <set>
+#include <string>
 #include <vector>
 
 #include "native_mate/wrappable.h"
@@ -24,14 +26,26 @@ class EventEmitter : public Wrappable {
  public:
   typedef std::vector<v8::Handle<v8::Value>> ValueArray;
 
+  // Called by JS when |name| gets its first listener or loses its last one.
+  // Once called, the events emitted by name are dropped before any V8 work
+  // when they have no listener.
+  void SetEventListened(const std::string& name, bool listened);
+
  protected:
   EventEmitter();
 
+  // Whether emitting |name| could reach a listener.
+  bool IsEventListened(const base::StringPiece& name) const;
+
   // this.emit(name, new Event(), args...);
   template<typename... Args>
   bool Emit(const base::StringPiece& name, const Args&... args) {
     return EmitWithSender(name, nullptr, nullptr, args...);
   }
+  template<typename... Args>
+  bool Emit(v8::Handle<v8::String> name, const Args&... args) {
+    return EmitWithSender(name, nullptr, nullptr, args...);
+  }
 
   // this.emit(name, new Event(sender, message), args...);
   template<typename... Args>
@@ -39,21 +53,42 @@ class EventEmitter : public Wrappable {
                       content::WebContents* sender,
                       IPC::Message* message,
                       const Args&... args) {
+    if (!IsEventListened(name))
+      return false;
     v8::Isolate* isolate = v8::Isolate::GetCurrent();
     v8::Locker locker(isolate);
     v8::HandleScope handle_scope(isolate);
+    return EmitWithSender(StringToV8(isolate, name), sender, message, args...);
+  }
 
-    ValueArray converted = { ConvertToV8(isolate, args)... };
-    return CallEmit(isolate, name, sender, message, converted);
+  // Same with above but takes a V8 string, which can be cached by callers
+  // that emit the same event frequently.
+  template<typename... Args>
+  bool EmitWithSender(v8::Handle<v8::String> name,
+                      content::WebContents* sender,
+                      IPC::Message* message,
+                      const Args&... args) {
+    v8::Isolate* isolate = v8::Isolate::GetCurrent();
+    v8::Locker locker(isolate);
+    v8::HandleScope handle_scope(isolate);
+
+    // The slot after name is filled with the event by CallEmit, so arguments
+    // do not need to be inserted at front.
+    ValueArray converted = {
+        name, v8::Handle<v8::Value>(), ConvertToV8(isolate, args)... };
+    return CallEmit(isolate, sender, message, &converted);
   }
 
  private:
-  // Lower level implementations.
+  // Lower level implementations, |args| is [name, <event>, args...].
   bool CallEmit(v8::Isolate* isolate,
-                const base::StringPiece& name,
                 content::WebContents* sender,
                 IPC::Message* message,
-                ValueArray args);
+                ValueArray* args);
+
+  // Only set after SetEventListened has been called.
+  bool tracks_listeners_;
+  std::set<std::string> listened_events_;
 
   DISALLOW_COPY_AND_ASSIGN(EventEmitter);
 };
@@ -0,0 +1,119 @@
+// Copyright (c) 2015 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#include "atom/browser/api/frame_subscriber.h"
+
+#include "atom/common/native_mate_converters/gfx_converter.h"
+#include "base/bind.h"
+#include "content/public/browser/browser_thread.h"
+#include "content/public/browser/render_widget_host_view.h"
+#include "media/base/video_frame.h"
+#include "media/base/yuv_convert.h"
+#include "native_mate/dictionary.h"
+#include "ui/gfx/geometry/rect_conversions.h"
+
+#include "atom/common/node_includes.h"
+
+using content::BrowserThread;
+
+namespace atom {
+
+namespace api {
+
+namespace {
+
+bool g_yuv_conversions_initialized = false;
+
+}  // namespace
+
+FrameSubscriber::FrameSubscriber(v8::Isolate* isolate,
+                                 content::RenderWidgetHostView* view,
+                                 const gfx::Size& size,
+                                 int max_fps,
+                                 const FrameCaptureCallback& callback)
+    : isolate_(isolate),
+      view_(view),
+      size_(size),
+      min_interval_(base::TimeDelta::FromSeconds(1) / max_fps),
+      callback_(callback),
+      weak_factory_(this) {
+  if (!g_yuv_conversions_initialized) {
+    media::InitializeCPUSpecificYUVConversions();
+    g_yuv_conversions_initialized = true;
+  }
+}
+
+FrameSubscriber::~FrameSubscriber() {
+}
+
+bool FrameSubscriber::ShouldCaptureFrame(
+    const gfx::Rect& damage_rect,
+    base::TimeTicks present_time,
+    scoped_refptr<media::VideoFrame>* storage,
+    DeliverFrameCallback* callback) {
+  DCHECK(BrowserThread::CurrentlyOn(BrowserThread::UI));
+  if (!last_present_time_.is_null() &&
+      present_time - last_present_time_ < min_interval_)
+    return false;
+
+  gfx::Size view_size = view_->GetViewBounds().size();
+  gfx::Size size = size_.IsEmpty() ? view_size : size_;
+  if (size.IsEmpty() || view_size.IsEmpty())
+    return false;
+  last_present_time_ = present_time;
+
+  // The damaged region is in the coordinates of view, report it in the ones
+  // of frame.
+  gfx::Rect damage = gfx::ToEnclosingRect(gfx::ScaleRect(
+      gfx::RectF(damage_rect),
+      static_cast<float>(size.width()) / view_size.width(),
+      static_cast<float>(size.height()) / view_size.height()));
+  damage.Intersect(gfx::Rect(size));
+
+  *storage = frame_pool_.CreateFrame(media::VideoFrame::YV12, size,
+                                     gfx::Rect(size), size,
+                                     base::TimeDelta());
+  *callback = base::Bind(&FrameSubscriber::OnFrameDelivered,
+                         weak_factory_.GetWeakPtr(), *storage, damage);
+  return true;
+}
+
+void FrameSubscriber::OnFrameDelivered(scoped_refptr<media::VideoFrame> frame,
+                                       const gfx::Rect& damage_rect,
+                                       base::TimeTicks present_time,
+                                       bool success) {
+  DCHECK(BrowserThread::CurrentlyOn(BrowserThread::UI));
+  if (!success)
+    return;
+
+  v8::Locker locker(isolate_);
+  v8::HandleScope handle_scope(isolate_);
+
+  // Convert the YUV frame into BGRA pixels straight in the memory of Buffer,
+  // so the pixels are copied only once.
+  const gfx::Size& size = frame->visible_rect().size();
+  int row_bytes = size.width() * 4;
+  v8::Local<v8::Object> buffer =
+      node::Buffer::New(isolate_, row_bytes * size.height());
+  media::ConvertYUVToRGB32(
+      frame->data(media::VideoFrame::kYPlane),
+      frame->data(media::VideoFrame::kUPlane),
+      frame->data(media::VideoFrame::kVPlane),
+      reinterpret_cast<uint8*>(node::Buffer::Data(buffer)),
+      size.width(), size.height(),
+      frame->stride(media::VideoFrame::kYPlane),
+      frame->stride(media::VideoFrame::kUPlane),
+      row_bytes,
+      media::YV12);
+
+  mate::Dictionary info = mate::Dictionary::CreateEmpty(isolate_);
+  info.Set("width", size.width());
+  info.Set("height", size.height());
+  info.Set("damageRect", damage_rect);
+  callback_.Run(buffer, info.GetHandle());
+}
+
+}  // namespace api
+
+}  // namespace atom
@@ -0,0 +1,73 @@
+// Copyright (c) 2015 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#ifndef ATOM_BROWSER_API_FRAME_SUBSCRIBER_H_
+#define ATOM_BROWSER_API_FRAME_SUBSCRIBER_H_
+
+#include "base/callback.h"
+#include "base/memory/weak_ptr.h"
+#include "base/time/time.h"
+#include "content/public/browser/render_widget_host_view_frame_subscriber.h"
+#include "media/base/video_frame_pool.h"
+#include "ui/gfx/geometry/size.h"
+#include "v8/include/v8.h"
+
+namespace content {
+class RenderWidgetHostView;
+}
+
+namespace atom {
+
+namespace api {
+
+// Receives the frames composited by a RenderWidgetHostView, and passes them to
+// JS as Buffers of BGRA pixels together with the damaged region.
+class FrameSubscriber : public content::RenderWidgetHostViewFrameSubscriber {
+ public:
+  // Called with |frame| and an object with |width|, |height| and |damageRect|.
+  typedef base::Callback<void(v8::Handle<v8::Value>, v8::Handle<v8::Value>)>
+      FrameCaptureCallback;
+
+  // Frames are scaled to |size|, or to the size of |view| when it is empty,
+  // and are dropped when they come faster than |max_fps|.
+  FrameSubscriber(v8::Isolate* isolate,
+                  content::RenderWidgetHostView* view,
+                  const gfx::Size& size,
+                  int max_fps,
+                  const FrameCaptureCallback& callback);
+  ~FrameSubscriber() override;
+
+  // content::RenderWidgetHostViewFrameSubscriber:
+  bool ShouldCaptureFrame(const gfx::Rect& damage_rect,
+                          base::TimeTicks present_time,
+                          scoped_refptr<media::VideoFrame>* storage,
+                          DeliverFrameCallback* callback) override;
+
+ private:
+  void OnFrameDelivered(scoped_refptr<media::VideoFrame> frame,
+                        const gfx::Rect& damage_rect,
+                        base::TimeTicks present_time,
+                        bool success);
+
+  v8::Isolate* isolate_;
+  content::RenderWidgetHostView* view_;
+  gfx::Size size_;
+  base::TimeDelta min_interval_;
+  FrameCaptureCallback callback_;
+
+  base::TimeTicks last_present_time_;
+
+  // The frames are recycled once the Buffers are filled.
+  media::VideoFramePool frame_pool_;
+
+  base::WeakPtrFactory<FrameSubscriber> weak_factory_;
+
+  DISALLOW_COPY_AND_ASSIGN(FrameSubscriber);
+};
+
+}  // namespace api
+
+}  // namespace atom
+
+#endif  // ATOM_BROWSER_API_FRAME_SUBSCRIBER_H_
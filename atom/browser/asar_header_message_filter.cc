@@ -0,0 +1,83 @@
+// Copyright (c) 2015 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#include "atom/browser/asar_header_message_filter.h"
+
+#include <map>
+
+#include "atom/common/api/api_messages.h"
+#include "atom/common/asar/archive.h"
+#include "atom/common/asar/asar_util.h"
+#include "base/lazy_instance.h"
+#include "base/memory/shared_memory.h"
+#include "base/pickle.h"
+#include "content/public/browser/browser_thread.h"
+
+using content::BrowserThread;
+
+namespace atom {
+
+namespace {
+
+// Archives are read-only, so the snapshot of each archive is only written once
+// and then shared with all render processes.
+typedef std::map<base::FilePath, std::shared_ptr<base::SharedMemory>>
+    SnapshotMap;
+base::LazyInstance<SnapshotMap> g_snapshots = LAZY_INSTANCE_INITIALIZER;
+
+std::shared_ptr<base::SharedMemory> GetOrCreateSnapshot(
+    const asar::Archive& archive) {
+  SnapshotMap& snapshots = g_snapshots.Get();
+  SnapshotMap::iterator iter = snapshots.find(archive.path());
+  if (iter != snapshots.end())
+    return iter->second;
+
+  Pickle pickle;
+  archive.WriteSnapshot(&pickle);
+
+  std::shared_ptr<base::SharedMemory> memory(new base::SharedMemory);
+  if (!memory->CreateAndMapAnonymous(pickle.size()))
+    return nullptr;
+  memcpy(memory->memory(), pickle.data(), pickle.size());
+  memory->Unmap();
+
+  snapshots[archive.path()] = memory;
+  return memory;
+}
+
+}  // namespace
+
+AsarHeaderMessageFilter::AsarHeaderMessageFilter()
+    : BrowserMessageFilter(ShellMsgStart) {
+  DCHECK(BrowserThread::CurrentlyOn(BrowserThread::UI));
+  for (const auto& archive : asar::GetOpenedAsarArchives()) {
+    Snapshot snapshot;
+    snapshot.path = archive->path();
+    snapshot.memory = GetOrCreateSnapshot(*archive);
+    if (snapshot.memory)
+      snapshots_.push_back(snapshot);
+  }
+}
+
+AsarHeaderMessageFilter::~AsarHeaderMessageFilter() {
+}
+
+void AsarHeaderMessageFilter::OnChannelConnected(int32 peer_pid) {
+  BrowserMessageFilter::OnChannelConnected(peer_pid);
+
+  // The handle of renderer is only available after the channel is connected.
+  for (const Snapshot& snapshot : snapshots_) {
+    base::SharedMemoryHandle handle;
+    if (snapshot.memory->ShareToProcess(PeerHandle(), &handle))
+      Send(new AtomMsg_AsarHeader(snapshot.path, handle,
+                                  snapshot.memory->requested_size()));
+  }
+  snapshots_.clear();
+}
+
+bool AsarHeaderMessageFilter::OnMessageReceived(const IPC::Message& message) {
+  return false;
+}
+
+}  // namespace atom
@@ -0,0 +1,46 @@
+// Copyright (c) 2015 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#ifndef ATOM_BROWSER_ASAR_HEADER_MESSAGE_FILTER_H_
+#define ATOM_BROWSER_ASAR_HEADER_MESSAGE_FILTER_H_
+
+#include <memory>
+#include <vector>
+
+#include "base/files/file_path.h"
+#include "content/public/browser/browser_message_filter.h"
+
+namespace base {
+class SharedMemory;
+}
+
+namespace atom {
+
+// Shares the headers of asar archives opened by the browser process with a
+// new render process, so the renderer does not need to parse them again.
+class AsarHeaderMessageFilter : public content::BrowserMessageFilter {
+ public:
+  // Should be called on UI thread before the render process is launched.
+  AsarHeaderMessageFilter();
+
+  // content::BrowserMessageFilter:
+  void OnChannelConnected(int32 peer_pid) override;
+  bool OnMessageReceived(const IPC::Message& message) override;
+
+ private:
+  struct Snapshot {
+    base::FilePath path;
+    std::shared_ptr<base::SharedMemory> memory;
+  };
+
+  virtual ~AsarHeaderMessageFilter();
+
+  std::vector<Snapshot> snapshots_;
+
+  DISALLOW_COPY_AND_ASSIGN(AsarHeaderMessageFilter);
+};
+
+}  // namespace atom
+
+#endif  // ATOM_BROWSER_ASAR_HEADER_MESSAGE_FILTER_H_
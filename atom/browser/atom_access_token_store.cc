@@ -7,7 +7,18 @@
 #include <utility>
 
 #include "atom/browser/atom_browser_context.h"
+#include "atom/browser/geolocation_position_cache.h"
 #include "atom/common/google_api_key.h"
+#include "base/bind.h"
+#include "base/memory/ref_counted.h"
+#include "base/prefs/pref_registry_simple.h"
+#include "base/prefs/pref_service.h"
+#include "base/prefs/scoped_user_pref_update.h"
+#include "base/values.h"
+#include "content/public/browser/browser_thread.h"
+#include "net/url_request/url_request_context_getter.h"
+
+using content::BrowserThread;
 
 namespace atom {
 
@@ -20,6 +31,72 @@ const char* kGeolocationProviderUrl =
     "https://www.googleapis.com/geolocation/v1/geolocate?key="
     GOOGLEAPIS_API_KEY;
 
+// The dictionary of the access tokens keyed by the URLs of the providers.
+const char kGeolocationAccessTokens[] = "geolocation.access_tokens";
+
+// Reads the tokens on UI thread, where the prefs live, and hands them to the
+// thread asking for them.
+class TokenLoadingJob : public base::RefCountedThreadSafe<TokenLoadingJob> {
+ public:
+  explicit TokenLoadingJob(
+      const content::AccessTokenStore::LoadAccessTokensCallbackType& callback)
+      : callback_(callback) {
+  }
+
+  void Run() {
+    BrowserThread::PostTaskAndReply(
+        BrowserThread::UI,
+        FROM_HERE,
+        base::Bind(&TokenLoadingJob::PerformWorkOnUIThread, this),
+        base::Bind(&TokenLoadingJob::RespondOnOriginatingThread, this));
+  }
+
+ private:
+  friend class base::RefCountedThreadSafe<TokenLoadingJob>;
+
+  ~TokenLoadingJob() {}
+
+  void PerformWorkOnUIThread() {
+    AtomBrowserContext* browser_context = AtomBrowserContext::Get();
+
+    // Only the provider we know is used, the tokens of the URLs used by
+    // older versions would start providers of their own.
+    base::string16 token;
+    browser_context->prefs()->GetDictionary(kGeolocationAccessTokens)->
+        GetStringWithoutPathExpansion(kGeolocationProviderUrl, &token);
+
+    // Equivelent to access_token_set[kGeolocationProviderUrl].
+    // Somehow base::string16 is causing compilation errors when used in a pair
+    // of std::map on Linux, this can work around it.
+    std::pair<GURL, base::string16> token_pair;
+    token_pair.first = GURL(kGeolocationProviderUrl);
+    token_pair.second = token;
+    access_token_set_.insert(token_pair);
+
+    request_context_getter_ = browser_context->url_request_context_getter();
+
+    // The tokens are loaded each time the providers start.
+    browser_context->geolocation_position_cache()->Hold();
+  }
+
+  void RespondOnOriginatingThread() {
+    callback_.Run(access_token_set_, request_context_getter_.get());
+  }
+
+  content::AccessTokenStore::LoadAccessTokensCallbackType callback_;
+  content::AccessTokenStore::AccessTokenSet access_token_set_;
+  scoped_refptr<net::URLRequestContextGetter> request_context_getter_;
+
+  DISALLOW_COPY_AND_ASSIGN(TokenLoadingJob);
+};
+
+void SaveAccessTokenOnUIThread(const GURL& server_url,
+                               const base::string16& access_token) {
+  DictionaryPrefUpdate update(AtomBrowserContext::Get()->prefs(),
+                              kGeolocationAccessTokens);
+  update->SetStringWithoutPathExpansion(server_url.spec(), access_token);
+}
+
 }  // namespace
 
 AtomAccessTokenStore::AtomAccessTokenStore() {
@@ -28,23 +105,22 @@ AtomAccessTokenStore::AtomAccessTokenStore() {
 AtomAccessTokenStore::~AtomAccessTokenStore() {
 }
 
+// static
+void AtomAccessTokenStore::RegisterPrefs(PrefRegistrySimple* registry) {
+  registry->RegisterDictionaryPref(kGeolocationAccessTokens);
+}
+
 void AtomAccessTokenStore::LoadAccessTokens(
     const LoadAccessTokensCallbackType& callback) {
-  AccessTokenSet access_token_set;
-
-  // Equivelent to access_token_set[kGeolocationProviderUrl].
-  // Somehow base::string16 is causing compilation errors when used in a pair
-  // of std::map on Linux, this can work around it.
-  std::pair<GURL, base::string16> token_pair;
-  token_pair.first = GURL(kGeolocationProviderUrl);
-  access_token_set.insert(token_pair);
-
-  callback.Run(access_token_set,
-               AtomBrowserContext::Get()->url_request_context_getter());
+  scoped_refptr<TokenLoadingJob> job(new TokenLoadingJob(callback));
+  job->Run();
 }
 
 void AtomAccessTokenStore::SaveAccessToken(const GURL& server_url,
                                            const base::string16& access_token) {
+  BrowserThread::PostTask(
+      BrowserThread::UI, FROM_HERE,
+      base::Bind(&SaveAccessTokenOnUIThread, server_url, access_token));
 }
 
 }  // namespace atom
@@ -7,15 +7,22 @@
 
 #include "content/public/browser/access_token_store.h"
 
+class PrefRegistrySimple;
+
 namespace atom {
 
 class AtomBrowserContext;
 
+// Keeps the access tokens given by the network location providers in the
+// prefs of the browser context, keyed by the URLs of the providers, so a
+// provider does not have to ask for a new token after each start.
 class AtomAccessTokenStore : public content::AccessTokenStore {
  public:
   AtomAccessTokenStore();
   virtual ~AtomAccessTokenStore();
 
+  static void RegisterPrefs(PrefRegistrySimple* registry);
+
   // content::AccessTokenStore:
   void LoadAccessTokens(
       const LoadAccessTokensCallbackType& callback) override;
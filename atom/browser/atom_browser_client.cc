@@ -4,16 +4,22 @@
 
 #include "atom/browser/atom_browser_client.h"
 
+#include "atom/browser/asar_header_message_filter.h"
 #include "atom/browser/atom_access_token_store.h"
 #include "atom/browser/atom_browser_context.h"
 #include "atom/browser/atom_browser_main_parts.h"
 #include "atom/browser/atom_resource_dispatcher_host_delegate.h"
 #include "atom/browser/atom_speech_recognition_manager_delegate.h"
+#include "atom/browser/message_port_message_filter.h"
 #include "atom/browser/native_window.h"
+#include "atom/browser/process_metrics_collector.h"
+#include "atom/browser/renderer_process_pool.h"
 #include "atom/browser/web_view_manager.h"
 #include "atom/browser/window_list.h"
+#include "atom/browser/worker_channel_message_filter.h"
 #include "atom/common/options_switches.h"
 #include "base/command_line.h"
+#include "base/stl_util.h"
 #include "base/strings/string_number_conversions.h"
 #include "chrome/browser/printing/printing_message_filter.h"
 #include "chrome/browser/speech/tts_message_filter.h"
@@ -22,7 +28,9 @@
 #include "content/public/browser/resource_dispatcher_host.h"
 #include "content/public/browser/site_instance.h"
 #include "content/public/browser/web_contents.h"
+#include "content/public/common/url_constants.h"
 #include "content/public/common/web_preferences.h"
+#include "net/base/escape.h"
 #include "ui/base/l10n/l10n_util.h"
 
 namespace atom {
@@ -60,6 +68,10 @@ void AtomBrowserClient::RenderProcessWillLaunch(
   int id = host->GetID();
   host->AddFilter(new printing::PrintingMessageFilter(host->GetID()));
   host->AddFilter(new TtsMessageFilter(id, host->GetBrowserContext()));
+  host->AddFilter(new AsarHeaderMessageFilter);
+  host->AddFilter(new WorkerChannelMessageFilter);
+  host->AddFilter(new MessagePortMessageFilter(id));
+  host->AddFilter(ProcessMetricsCollector::CreateMessageFilter(id));
 }
 
 content::SpeechRecognitionManagerDelegate*
@@ -122,14 +134,96 @@ bool AtomBrowserClient::ShouldSwapBrowsingInstancesForNavigation(
     content::SiteInstance* site_instance,
     const GURL& current_url,
     const GURL& new_url) {
-  if (site_instance->HasProcess())
+  if (site_instance->HasProcess()) {
     dying_render_process_ = site_instance->GetProcess();
 
+    // Let the window use a pre-started process if there is one.
+    WindowList* list = WindowList::GetInstance();
+    WindowList::const_iterator iter = std::find_if(
+        list->begin(), list->end(),
+        FindByProcessId(dying_render_process_->GetID()));
+    if (iter != list->end()) {
+      pending_process_group_ = (*iter)->process_group();
+      if (pending_process_group_.empty())
+        RendererProcessPool::GetInstance()->ReserveProcessForWindow(*iter);
+    }
+  }
+
   // Restart renderer process for all navigations, this relies on a patch to
   // Chromium: http://git.io/_PaNyg.
   return true;
 }
 
+bool AtomBrowserClient::ShouldTryToUseExistingProcessHost(
+    content::BrowserContext* browser_context, const GURL& url) {
+  return !pending_process_group_.empty() ||
+         RendererProcessPool::GetInstance()->ShouldUseReservedProcess();
+}
+
+bool AtomBrowserClient::IsSuitableHost(content::RenderProcessHost* process_host,
+                                       const GURL& site_url) {
+  // Windows of a process group only go to the process of their group.
+  if (!pending_process_group_.empty()) {
+    auto iter = process_groups_.find(process_host->GetID());
+    return iter != process_groups_.end() &&
+           iter->second == pending_process_group_;
+  }
+
+  // And the other windows never go to the processes of groups.
+  if (ContainsKey(process_groups_, process_host->GetID()))
+    return false;
+
+  return RendererProcessPool::GetInstance()->IsSuitableHost(process_host);
+}
+
+void AtomBrowserClient::SiteInstanceGotProcess(
+    content::SiteInstance* site_instance) {
+  // No process would be launched for the navigation when it uses a spare.
+  if (RendererProcessPool::GetInstance()->SiteInstanceGotProcess(site_instance))
+    dying_render_process_ = NULL;
+
+  if (pending_process_group_.empty())
+    return;
+
+  // Forget the processes that are gone.
+  for (auto iter = process_groups_.begin(); iter != process_groups_.end();) {
+    if (content::RenderProcessHost::FromID(iter->first))
+      ++iter;
+    else
+      process_groups_.erase(iter++);
+  }
+
+  // Neither would a process be launched when the group already has one.
+  content::RenderProcessHost* host = site_instance->GetProcess();
+  if (ContainsKey(process_groups_, host->GetID()))
+    dying_render_process_ = NULL;
+  else
+    process_groups_[host->GetID()] = pending_process_group_;
+  pending_process_group_.clear();
+}
+
+void AtomBrowserClient::GetStoragePartitionConfigForSite(
+    content::BrowserContext* browser_context,
+    const GURL& site,
+    bool can_be_default,
+    std::string* partition_domain,
+    std::string* partition_name,
+    bool* in_memory) {
+  // The partition of a guest is encoded in its site URL, the guests without
+  // partition use the default one.
+  if (site.SchemeIs(content::kGuestScheme) && site.has_query()) {
+    *partition_domain = site.host();
+    *partition_name = net::UnescapeURLComponent(site.query(),
+                                                net::UnescapeRule::NORMAL);
+    *in_memory = site.ref() != "persist";
+    return;
+  }
+
+  brightray::BrowserClient::GetStoragePartitionConfigForSite(
+      browser_context, site, can_be_default, partition_domain, partition_name,
+      in_memory);
+}
+
 std::string AtomBrowserClient::GetApplicationLocale() {
   return l10n_util::GetApplicationLocale("");
 }
@@ -137,6 +231,32 @@ std::string AtomBrowserClient::GetApplicationLocale() {
 void AtomBrowserClient::AppendExtraCommandLineSwitches(
     base::CommandLine* command_line,
     int child_process_id) {
+  // Renderers share the same asar extraction cache and code cache with
+  // browser.
+  base::CommandLine* browser_command_line =
+      base::CommandLine::ForCurrentProcess();
+  if (browser_command_line->HasSwitch(switches::kAsarCacheDir))
+    command_line->AppendSwitchPath(
+        switches::kAsarCacheDir,
+        browser_command_line->GetSwitchValuePath(switches::kAsarCacheDir));
+  if (browser_command_line->HasSwitch(switches::kJsCodeCacheDir))
+    command_line->AppendSwitchPath(
+        switches::kJsCodeCacheDir,
+        browser_command_line->GetSwitchValuePath(switches::kJsCodeCacheDir));
+  if (browser_command_line->HasSwitch(switches::kAsarCodeCache))
+    command_line->AppendSwitch(switches::kAsarCodeCache);
+  if (browser_command_line->HasSwitch(switches::kAsarResolveCache))
+    command_line->AppendSwitch(switches::kAsarResolveCache);
+
+  // The alert() and confirm() of pages use the synchronous dialogs.
+  if (browser_command_line->HasSwitch(switches::kDisableSyncDialogs))
+    command_line->AppendSwitch(switches::kDisableSyncDialogs);
+
+  // The spare processes have no window yet.
+  if (RendererProcessPool::GetInstance()->AppendExtraCommandLineSwitches(
+          command_line, child_process_id))
+    return;
+
   WindowList* list = WindowList::GetInstance();
   NativeWindow* window = NULL;
 
@@ -5,6 +5,7 @@
 #ifndef ATOM_BROWSER_ATOM_BROWSER_CLIENT_H_
 #define ATOM_BROWSER_ATOM_BROWSER_CLIENT_H_
 
+#include <map>
 #include <string>
 
 #include "brightray/browser/browser_client.h"
@@ -32,6 +33,18 @@ class AtomBrowserClient : public brightray::BrowserClient {
       content::SiteInstance* site_instance,
       const GURL& current_url,
       const GURL& new_url) override;
+  bool ShouldTryToUseExistingProcessHost(
+      content::BrowserContext* browser_context, const GURL& url) override;
+  bool IsSuitableHost(content::RenderProcessHost* process_host,
+                      const GURL& site_url) override;
+  void SiteInstanceGotProcess(content::SiteInstance* site_instance) override;
+  void GetStoragePartitionConfigForSite(
+      content::BrowserContext* browser_context,
+      const GURL& site,
+      bool can_be_default,
+      std::string* partition_domain,
+      std::string* partition_name,
+      bool* in_memory) override;
   std::string GetApplicationLocale() override;
   void AppendExtraCommandLineSwitches(base::CommandLine* command_line,
                                       int child_process_id) override;
@@ -45,6 +58,12 @@ class AtomBrowserClient : public brightray::BrowserClient {
   // The render process which would be swapped out soon.
   content::RenderProcessHost* dying_render_process_;
 
+  // The process group of the window that is going to get a new site instance.
+  std::string pending_process_group_;
+
+  // The process groups of render processes, keyed by process ID.
+  std::map<int, std::string> process_groups_;
+
   DISALLOW_COPY_AND_ASSIGN(AtomBrowserClient);
 };
 
@@ -4,17 +4,24 @@
 
 #include "atom/browser/atom_browser_context.h"
 
+#include "atom/browser/atom_access_token_store.h"
 #include "atom/browser/atom_browser_main_parts.h"
+#include "atom/browser/geolocation_position_cache.h"
 #include "atom/browser/net/atom_url_request_job_factory.h"
 #include "atom/browser/net/asar/asar_protocol_handler.h"
 #include "atom/browser/web_view_manager.h"
 #include "atom/common/options_switches.h"
 #include "base/command_line.h"
+#include "base/strings/string_number_conversions.h"
 #include "base/threading/sequenced_worker_pool.h"
 #include "base/threading/worker_pool.h"
+#include "brightray/browser/browser_client.h"
+#include "brightray/browser/net_log.h"
 #include "chrome/browser/browser_process.h"
 #include "content/public/browser/browser_thread.h"
+#include "content/public/browser/host_zoom_map.h"
 #include "content/public/common/url_constants.h"
+#include "net/base/cache_type.h"
 #include "net/url_request/data_protocol_handler.h"
 #include "net/url_request/url_request_intercepting_job_factory.h"
 #include "url/url_constants.h"
@@ -33,21 +40,12 @@ class NoCacheBackend : public net::HttpCache::BackendFactory {
   }
 };
 
-}  // namespace
-
-AtomBrowserContext::AtomBrowserContext()
-    : fake_browser_process_(new BrowserProcess),
-      job_factory_(new AtomURLRequestJobFactory) {
-}
-
-AtomBrowserContext::~AtomBrowserContext() {
-}
-
-net::URLRequestJobFactory* AtomBrowserContext::CreateURLRequestJobFactory(
+// Adds the handlers of Chromium and the built-in protocols to |job_factory|,
+// and wraps it with |interceptors|.
+net::URLRequestJobFactory* SetUpJobFactory(
+    scoped_ptr<AtomURLRequestJobFactory> job_factory,
     content::ProtocolHandlerMap* handlers,
     content::URLRequestInterceptorScopedVector* interceptors) {
-  scoped_ptr<AtomURLRequestJobFactory> job_factory(job_factory_);
-
   for (content::ProtocolHandlerMap::iterator it = handlers->begin();
        it != handlers->end(); ++it)
     job_factory->SetProtocolHandler(it->first, it->second.release());
@@ -71,14 +69,117 @@ net::URLRequestJobFactory* AtomBrowserContext::CreateURLRequestJobFactory(
   return top_job_factory.release();
 }
 
+// Builds the network stack of a storage partition other than the default
+// one. The partition has its own job factory, so the protocols registered by
+// the protocol module only work in the default partition.
+class PartitionDelegate : public brightray::URLRequestContextGetter::Delegate {
+ public:
+  explicit PartitionDelegate(bool in_memory) : in_memory_(in_memory) {}
+
+  // brightray::URLRequestContextGetter::Delegate:
+  net::URLRequestJobFactory* CreateURLRequestJobFactory(
+      content::ProtocolHandlerMap* handlers,
+      content::URLRequestInterceptorScopedVector* interceptors) override {
+    return SetUpJobFactory(make_scoped_ptr(new AtomURLRequestJobFactory),
+                           handlers, interceptors);
+  }
+
+  net::HttpCache::BackendFactory* CreateHttpCacheBackendFactory(
+      const base::FilePath& base_path) override {
+    if (in_memory_)
+      return net::HttpCache::DefaultBackend::InMemory(0);
+    return new net::HttpCache::DefaultBackend(
+        net::DISK_CACHE, net::CACHE_BACKEND_DEFAULT,
+        base_path.Append(FILE_PATH_LITERAL("Cache")), 0,
+        BrowserThread::GetMessageLoopProxyForThread(BrowserThread::CACHE));
+  }
+
+ private:
+  bool in_memory_;
+
+  DISALLOW_COPY_AND_ASSIGN(PartitionDelegate);
+};
+
+}  // namespace
+
+AtomBrowserContext::AtomBrowserContext()
+    : fake_browser_process_(new BrowserProcess),
+      geolocation_position_cache_(new GeolocationPositionCache),
+      job_factory_(new AtomURLRequestJobFactory) {
+}
+
+AtomBrowserContext::~AtomBrowserContext() {
+}
+
+net::URLRequestJobFactory* AtomBrowserContext::CreateURLRequestJobFactory(
+    content::ProtocolHandlerMap* handlers,
+    content::URLRequestInterceptorScopedVector* interceptors) {
+  return SetUpJobFactory(make_scoped_ptr(job_factory_), handlers,
+                         interceptors);
+}
+
 net::HttpCache::BackendFactory*
 AtomBrowserContext::CreateHttpCacheBackendFactory(
     const base::FilePath& base_path) {
   base::CommandLine* command_line = base::CommandLine::ForCurrentProcess();
   if (command_line->HasSwitch(switches::kDisableHttpCache))
     return new NoCacheBackend;
-  else
+
+  // Zero lets the cache choose its size.
+  int max_size = 0;
+  if (command_line->HasSwitch(switches::kDiskCacheSize))
+    base::StringToInt(
+        command_line->GetSwitchValueASCII(switches::kDiskCacheSize), &max_size);
+
+  if (command_line->HasSwitch(switches::kInMemoryHttpCache))
+    return net::HttpCache::DefaultBackend::InMemory(max_size);
+
+  if (max_size == 0 && !command_line->HasSwitch(switches::kDiskCacheDir))
     return brightray::BrowserContext::CreateHttpCacheBackendFactory(base_path);
+
+  base::FilePath cache_path = base_path.Append(FILE_PATH_LITERAL("Cache"));
+  if (command_line->HasSwitch(switches::kDiskCacheDir))
+    cache_path = command_line->GetSwitchValuePath(switches::kDiskCacheDir);
+  return new net::HttpCache::DefaultBackend(
+      net::DISK_CACHE, net::CACHE_BACKEND_DEFAULT, cache_path, max_size,
+      BrowserThread::GetMessageLoopProxyForThread(BrowserThread::CACHE));
+}
+
+net::URLRequestContextGetter*
+AtomBrowserContext::CreateRequestContextForStoragePartition(
+    const base::FilePath& partition_path,
+    bool in_memory,
+    content::ProtocolHandlerMap* protocol_handlers,
+    content::URLRequestInterceptorScopedVector request_interceptors) {
+  DCHECK(BrowserThread::CurrentlyOn(BrowserThread::UI));
+  PartitionDelegate* delegate = new PartitionDelegate(in_memory);
+  partition_delegates_.push_back(delegate);
+
+  // Each partition gets its own URLRequestContext, so the requests of
+  // different partitions share no cookies, cache or connections.
+  scoped_refptr<net::URLRequestContextGetter> getter(
+      new brightray::URLRequestContextGetter(
+          delegate,
+          static_cast<brightray::NetLog*>(
+              brightray::BrowserClient::Get()->GetNetLog()),
+          partition_path,
+          BrowserThread::UnsafeGetMessageLoopForThread(BrowserThread::IO),
+          BrowserThread::UnsafeGetMessageLoopForThread(BrowserThread::FILE),
+          protocol_handlers,
+          request_interceptors.Pass()));
+  partition_request_contexts_[partition_path] = getter;
+  return getter.get();
+}
+
+net::URLRequestContextGetter*
+AtomBrowserContext::CreateMediaRequestContextForStoragePartition(
+    const base::FilePath& partition_path,
+    bool in_memory) {
+  // Media shares the request context of its partition.
+  auto it = partition_request_contexts_.find(partition_path);
+  if (it == partition_request_contexts_.end())
+    return NULL;
+  return it->second.get();
 }
 
 content::BrowserPluginGuestManager* AtomBrowserContext::GetGuestManager() {
@@ -87,6 +188,26 @@ content::BrowserPluginGuestManager* AtomBrowserContext::GetGuestManager() {
   return guest_manager_.get();
 }
 
+void AtomBrowserContext::SetZoomLevelForHost(const std::string& host,
+                                             double level) {
+  DCHECK(BrowserThread::CurrentlyOn(BrowserThread::UI));
+  content::HostZoomMap* zoom_map =
+      content::HostZoomMap::GetDefaultForBrowserContext(this);
+  zoom_map->SetZoomLevelForHost(host, level);
+}
+
+double AtomBrowserContext::GetZoomLevelForHost(const std::string& host) {
+  DCHECK(BrowserThread::CurrentlyOn(BrowserThread::UI));
+  // No scheme has its own zoom level, so any gives the one of |host|.
+  content::HostZoomMap* zoom_map =
+      content::HostZoomMap::GetDefaultForBrowserContext(this);
+  return zoom_map->GetZoomLevelForHostAndScheme(url::kHttpScheme, host);
+}
+
+void AtomBrowserContext::RegisterPrefs(PrefRegistrySimple* pref_registry) {
+  AtomAccessTokenStore::RegisterPrefs(pref_registry);
+}
+
 // static
 AtomBrowserContext* AtomBrowserContext::Get() {
   return static_cast<AtomBrowserContext*>(
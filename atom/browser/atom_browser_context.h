@@ -5,13 +5,21 @@
 #ifndef ATOM_BROWSER_ATOM_BROWSER_CONTEXT_H_
 #define ATOM_BROWSER_ATOM_BROWSER_CONTEXT_H_
 
+#include <map>
+#include <string>
+
+#include "base/files/file_path.h"
+#include "base/memory/scoped_vector.h"
 #include "brightray/browser/browser_context.h"
+#include "brightray/browser/url_request_context_getter.h"
 
 class BrowserProcess;
+class PrefRegistrySimple;
 
 namespace atom {
 
 class AtomURLRequestJobFactory;
+class GeolocationPositionCache;
 class WebViewManager;
 
 class AtomBrowserContext : public brightray::BrowserContext {
@@ -31,16 +39,46 @@ class AtomBrowserContext : public brightray::BrowserContext {
 
   // content::BrowserContext:
   content::BrowserPluginGuestManager* GetGuestManager() override;
+  net::URLRequestContextGetter* CreateRequestContextForStoragePartition(
+      const base::FilePath& partition_path,
+      bool in_memory,
+      content::ProtocolHandlerMap* protocol_handlers,
+      content::URLRequestInterceptorScopedVector request_interceptors)
+      override;
+  net::URLRequestContextGetter* CreateMediaRequestContextForStoragePartition(
+      const base::FilePath& partition_path,
+      bool in_memory) override;
 
   AtomURLRequestJobFactory* job_factory() const { return job_factory_; }
 
+  GeolocationPositionCache* geolocation_position_cache() const {
+    return geolocation_position_cache_.get();
+  }
+
+  // The zoom levels of hosts are kept by browser, which sends the changes to
+  // all renderers and gives new pages their zoom before the first layout.
+  // For file: URLs the |host| is the URL itself.
+  void SetZoomLevelForHost(const std::string& host, double level);
+  double GetZoomLevelForHost(const std::string& host);
+
+ protected:
+  // brightray::BrowserContext:
+  void RegisterPrefs(PrefRegistrySimple* pref_registry) override;
+
  private:
   // A fake BrowserProcess object that used to feed the source code from chrome.
   scoped_ptr<BrowserProcess> fake_browser_process_;
   scoped_ptr<WebViewManager> guest_manager_;
+  scoped_ptr<GeolocationPositionCache> geolocation_position_cache_;
 
   AtomURLRequestJobFactory* job_factory_;  // Weak reference.
 
+  // The network stacks of the storage partitions other than the default one.
+  ScopedVector<brightray::URLRequestContextGetter::Delegate>
+      partition_delegates_;
+  std::map<base::FilePath, scoped_refptr<net::URLRequestContextGetter>>
+      partition_request_contexts_;
+
   DISALLOW_COPY_AND_ASSIGN(AtomBrowserContext);
 };
 
@@ -7,21 +7,68 @@
 #include "atom/browser/atom_browser_client.h"
 #include "atom/browser/atom_browser_context.h"
 #include "atom/browser/browser.h"
+#include "atom/browser/delta_updater.h"
+#include "atom/browser/jank_watchdog.h"
 #include "atom/browser/javascript_environment.h"
+#include "atom/browser/media_device_cache.h"
+#include "atom/browser/net/protocol_response_cache.h"
 #include "atom/browser/node_debugger.h"
+#include "atom/browser/window_pool.h"
+#include "atom/common/api/api_messages.h"
 #include "atom/common/api/atom_bindings.h"
+#include "atom/common/asar/asar_util.h"
+#include "atom/common/async_logger.h"
 #include "atom/common/node_bindings.h"
+#include "atom/common/options_switches.h"
+#include "atom/common/purge_memory.h"
+#include "atom/common/startup_timings.h"
+#include "base/bind.h"
 #include "base/command_line.h"
+#include "base/message_loop/message_loop.h"
+#include "base/path_service.h"
+#include "base/sys_info.h"
+#include "base/task_runner_util.h"
+#include "base/threading/thread_restrictions.h"
+#include "brightray/browser/brightray_paths.h"
+#include "chrome/browser/speech/tts_controller_impl.h"
+#include "content/public/browser/browser_thread.h"
+#include "content/public/browser/render_process_host.h"
 #include "v8/include/v8-debug.h"
 
+#if defined(OS_WIN)
+#include <windows.h>
+#else
+#include <unistd.h>
+#endif
+
 #if defined(USE_X11)
 #include "chrome/browser/ui/libgtk2ui/gtk2_util.h"
 #endif
 
 #include "atom/common/node_includes.h"
 
+using content::BrowserThread;
+
 namespace atom {
 
+namespace {
+
+// Where the fast shutdown lists the files to delete on next start.
+const base::FilePath::CharType kPendingDeletionsFileName[] =
+    FILE_PATH_LITERAL("Pending Deletions");
+
+#if !defined(OS_MACOSX)
+// How often the available physical memory is checked.
+const int kMemoryPressureCheckIntervalSeconds = 5;
+
+// The pressure is moderate or critical when less than these percentages of
+// physical memory are available.
+const int64 kModeratePressureMemoryPercent = 10;
+const int64 kCriticalPressureMemoryPercent = 5;
+#endif
+
+}  // namespace
+
 // static
 AtomBrowserMainParts* AtomBrowserMainParts::self_ = NULL;
 
@@ -29,7 +76,12 @@ AtomBrowserMainParts::AtomBrowserMainParts()
     : browser_(new Browser),
       node_bindings_(NodeBindings::Create(true)),
       atom_bindings_(new AtomBindings),
-      gc_timer_(true, true) {
+      gc_timer_(true, true),
+#if defined(OS_MACOSX)
+      memory_pressure_source_(NULL) {
+#else
+      memory_pressure_severity_(0) {
+#endif
   DCHECK(!self_) << "Cannot have two AtomBrowserMainParts";
   self_ = this;
 }
@@ -43,17 +95,28 @@ AtomBrowserMainParts* AtomBrowserMainParts::Get() {
   return self_;
 }
 
+void AtomBrowserMainParts::DeferTemporaryFilesDeletion() {
+  base::ThreadRestrictions::ScopedAllowIO allow_io;
+  asar::DeferAsarExternalFilesDeletion(GetPendingDeletionsPath());
+}
+
 brightray::BrowserContext* AtomBrowserMainParts::CreateBrowserContext() {
   return new AtomBrowserContext();
 }
 
 void AtomBrowserMainParts::PostEarlyInitialization() {
+  StartupTimings::GetInstance()->Record("post-early-initialization");
   brightray::BrowserMainParts::PostEarlyInitialization();
 
 #if defined(USE_X11)
   SetDPIFromGSettings();
 #endif
 
+  // Install the update downloaded by DeltaUpdater before the archives in
+  // resources are opened by node.
+  auto_updater::DeltaUpdater::ApplyPendingUpdates(
+      NodeBindings::GetResourcesPath(true));
+
   // The ProxyResolverV8 has setup a complete V8 environment, in order to avoid
   // conflicts we only initialize our V8 environment after that.
   js_env_.reset(new JavascriptEnvironment);
@@ -78,6 +141,8 @@ void AtomBrowserMainParts::PostEarlyInitialization() {
 }
 
 void AtomBrowserMainParts::PreMainMessageLoopRun() {
+  StartupTimings::GetInstance()->Record("pre-main-message-loop-run");
+
   // Run user's main script before most things get initialized, so we can have
   // a chance to setup everything.
   node_bindings_->PrepareMessageLoop();
@@ -90,8 +155,37 @@ void AtomBrowserMainParts::PreMainMessageLoopRun() {
                  base::Unretained(js_env_->isolate()),
                  1000));
 
+  // Remember the slow tasks of main thread, including the runs of node's
+  // event loop.
+  JankWatchdog::GetInstance()->Start(js_env_->isolate());
+
+  // Purge the caches when the system is low on memory.
+  memory_pressure_listener_.reset(new base::MemoryPressureListener(
+      base::Bind(&AtomBrowserMainParts::OnMemoryPressure,
+                 base::Unretained(this))));
+  StartMemoryPressureMonitor();
+
   brightray::BrowserMainParts::PreMainMessageLoopRun();
 
+  // Enumerate the capture devices in background now, instead of when a page
+  // asks for media.
+  MediaDeviceCache::GetInstance()->Start();
+
+  // Clean up after the last fast shutdown, the main script has had its chance
+  // to change the userData path.
+  BrowserThread::PostTask(
+      BrowserThread::FILE, FROM_HERE,
+      base::Bind(&asar::DeletePendingAsarExternalFiles,
+                 GetPendingDeletionsPath()));
+
+  // Get the voices of speech synthesis ready once the startup is done.
+  if (base::CommandLine::ForCurrentProcess()->HasSwitch(
+          switches::kPrewarmSpeechSynthesis))
+    base::MessageLoop::current()->PostTask(
+        FROM_HERE,
+        base::Bind(&TtsControllerImpl::Prewarm,
+                   base::Unretained(TtsControllerImpl::GetInstance())));
+
 #if defined(USE_X11)
   libgtk2ui::GtkInitFromCommandLine(*base::CommandLine::ForCurrentProcess());
 #endif
@@ -103,4 +197,124 @@ void AtomBrowserMainParts::PreMainMessageLoopRun() {
 #endif
 }
 
+void AtomBrowserMainParts::PostMainMessageLoopRun() {
+  base::CommandLine* command_line = base::CommandLine::ForCurrentProcess();
+  if (command_line->HasSwitch(switches::kRecordAsarPrefetchManifest)) {
+    base::ThreadRestrictions::ScopedAllowIO allow_io;
+    asar::WriteAsarPrefetchManifest(command_line->GetSwitchValuePath(
+        switches::kRecordAsarPrefetchManifest));
+  }
+
+  JankWatchdog::GetInstance()->Stop();
+
+  // The records still in the buffers would be lost on exit.
+  AsyncLogger::GetInstance()->Flush();
+
+  StopMemoryPressureMonitor();
+  memory_pressure_listener_.reset();
+
+  // The recycled windows must go before the browser context.
+  WindowPool::GetInstance()->Clear();
+
+  // The renderers have nothing left to save, so they are killed instead of
+  // being waited for.
+  if (browser_->fast_shutdown()) {
+    for (content::RenderProcessHost::iterator it(
+             content::RenderProcessHost::AllHostsIterator());
+         !it.IsAtEnd(); it.Advance())
+      it.GetCurrentValue()->FastShutdownIfPossible();
+  }
+
+  brightray::BrowserMainParts::PostMainMessageLoopRun();
+}
+
+void AtomBrowserMainParts::PostDestroyThreads() {
+#if defined(OS_MACOSX)
+  FreeAppDelegate();
+#endif
+
+  // The threads have finished writing the session data, what is left only
+  // frees memory.
+  if (browser_->fast_shutdown()) {
+#if defined(OS_WIN)
+    ::TerminateProcess(::GetCurrentProcess(), 0);
+#else
+    _exit(0);
+#endif
+  }
+}
+
+// static
+base::FilePath AtomBrowserMainParts::GetPendingDeletionsPath() {
+  base::FilePath path;
+  PathService::Get(brightray::DIR_USER_DATA, &path);
+  return path.Append(kPendingDeletionsFileName);
+}
+
+void AtomBrowserMainParts::OnMemoryPressure(
+    base::MemoryPressureListener::MemoryPressureLevel level) {
+  bool critical =
+      level == base::MemoryPressureListener::MEMORY_PRESSURE_LEVEL_CRITICAL;
+  PurgeMemory(level);
+  BrowserThread::PostTask(
+      BrowserThread::IO, FROM_HERE,
+      base::Bind(&ProtocolResponseCache::PurgeAll, critical));
+
+  for (content::RenderProcessHost::iterator it(
+           content::RenderProcessHost::AllHostsIterator());
+       !it.IsAtEnd(); it.Advance())
+    it.GetCurrentValue()->Send(new AtomMsg_MemoryPressure(level));
+
+  browser_->MemoryPressure(level);
+
+  // Collect what the app has just dropped.
+  if (critical)
+    js_env_->isolate()->LowMemoryNotification();
+}
+
+#if !defined(OS_MACOSX)
+void AtomBrowserMainParts::StartMemoryPressureMonitor() {
+  memory_pressure_timer_.Start(
+      FROM_HERE,
+      base::TimeDelta::FromSeconds(kMemoryPressureCheckIntervalSeconds),
+      this, &AtomBrowserMainParts::CheckMemoryPressure);
+}
+
+void AtomBrowserMainParts::StopMemoryPressureMonitor() {
+  memory_pressure_timer_.Stop();
+}
+
+void AtomBrowserMainParts::CheckMemoryPressure() {
+  // Reading the available memory is file IO on Linux.
+  base::PostTaskAndReplyWithResult(
+      BrowserThread::GetMessageLoopProxyForThread(BrowserThread::FILE).get(),
+      FROM_HERE,
+      base::Bind(&base::SysInfo::AmountOfAvailablePhysicalMemory),
+      base::Bind(&AtomBrowserMainParts::OnAvailablePhysicalMemory,
+                 base::Unretained(this)));
+}
+
+void AtomBrowserMainParts::OnAvailablePhysicalMemory(int64 available) {
+  int64 total = base::SysInfo::AmountOfPhysicalMemory();
+  if (total <= 0 || !memory_pressure_timer_.IsRunning())
+    return;
+
+  int64 percent = available * 100 / total;
+  int severity = 0;
+  if (percent < kCriticalPressureMemoryPercent)
+    severity = 2;
+  else if (percent < kModeratePressureMemoryPercent)
+    severity = 1;
+
+  // Only notify when the pressure rises, purging again would not help.
+  bool rising = severity > memory_pressure_severity_;
+  memory_pressure_severity_ = severity;
+  if (rising)
+    base::MemoryPressureListener::NotifyMemoryPressure(
+        severity == 2 ?
+            base::MemoryPressureListener::MEMORY_PRESSURE_LEVEL_CRITICAL :
+            base::MemoryPressureListener::MEMORY_PRESSURE_LEVEL_MODERATE);
+}
+#endif
+
 }  // namespace atom
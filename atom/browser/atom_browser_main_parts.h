@@ -5,6 +5,12 @@
 #ifndef ATOM_BROWSER_ATOM_BROWSER_MAIN_PARTS_H_
 #define ATOM_BROWSER_ATOM_BROWSER_MAIN_PARTS_H_
 
+#if defined(OS_MACOSX)
+#include <dispatch/dispatch.h>
+#endif
+
+#include "base/files/file_path.h"
+#include "base/memory/memory_pressure_listener.h"
 #include "base/timer/timer.h"
 #include "brightray/browser/browser_main_parts.h"
 
@@ -25,6 +31,10 @@ class AtomBrowserMainParts : public brightray::BrowserMainParts {
 
   Browser* browser() { return browser_.get(); }
 
+  // Gives up the temporary files copied out of asar archives, they are deleted
+  // on the next start instead. Used by the fast shutdown.
+  void DeferTemporaryFilesDeletion();
+
  protected:
   // Implementations of brightray::BrowserMainParts.
   brightray::BrowserContext* CreateBrowserContext() override;
@@ -32,9 +42,10 @@ class AtomBrowserMainParts : public brightray::BrowserMainParts {
   // Implementations of content::BrowserMainParts.
   void PostEarlyInitialization() override;
   void PreMainMessageLoopRun() override;
+  void PostMainMessageLoopRun() override;
+  void PostDestroyThreads() override;
 #if defined(OS_MACOSX)
   void PreMainMessageLoopStart() override;
-  void PostDestroyThreads() override;
 #endif
 
  private:
@@ -42,6 +53,25 @@ class AtomBrowserMainParts : public brightray::BrowserMainParts {
   void SetDPIFromGSettings();
 #endif
 
+#if defined(OS_MACOSX)
+  void FreeAppDelegate();
+#endif
+
+  // The list of files left by the last fast shutdown.
+  static base::FilePath GetPendingDeletionsPath();
+
+  // Purges the caches of browser, and tells the renderers and the app.
+  void OnMemoryPressure(
+      base::MemoryPressureListener::MemoryPressureLevel level);
+
+  // Watches the memory of system and notifies the pressure.
+  void StartMemoryPressureMonitor();
+  void StopMemoryPressureMonitor();
+#if !defined(OS_MACOSX)
+  void CheckMemoryPressure();
+  void OnAvailablePhysicalMemory(int64 available);
+#endif
+
   scoped_ptr<Browser> browser_;
   scoped_ptr<JavascriptEnvironment> js_env_;
   scoped_ptr<NodeBindings> node_bindings_;
@@ -50,6 +80,15 @@ class AtomBrowserMainParts : public brightray::BrowserMainParts {
 
   base::Timer gc_timer_;
 
+  scoped_ptr<base::MemoryPressureListener> memory_pressure_listener_;
+#if defined(OS_MACOSX)
+  dispatch_source_t memory_pressure_source_;
+#else
+  base::RepeatingTimer<AtomBrowserMainParts> memory_pressure_timer_;
+  // 0 for no pressure, 1 for moderate and 2 for critical.
+  int memory_pressure_severity_;
+#endif
+
   static AtomBrowserMainParts* self_;
 
   DISALLOW_COPY_AND_ASSIGN(AtomBrowserMainParts);
@@ -8,6 +8,7 @@
 #import "atom/browser/mac/atom_application_delegate.h"
 #include "base/files/file_path.h"
 #import "base/mac/foundation_util.h"
+#include "base/mac/mac_util.h"
 #include "ui/base/l10n/l10n_util_mac.h"
 #import "vendor/brightray/common/mac/main_application_bundle.h"
 
@@ -40,7 +41,37 @@ void AtomBrowserMainParts::PreMainMessageLoopStart() {
       setObject:@"NO" forKey:@"NSTreatUnknownArgumentsAsOpen"];
 }
 
-void AtomBrowserMainParts::PostDestroyThreads() {
+void AtomBrowserMainParts::StartMemoryPressureMonitor() {
+  // The memory pressure of system is only reported on 10.9 and later.
+  if (!base::mac::IsOSMavericksOrLater())
+    return;
+
+  memory_pressure_source_ = dispatch_source_create(
+      DISPATCH_SOURCE_TYPE_MEMORYPRESSURE, 0,
+      DISPATCH_MEMORYPRESSURE_WARN | DISPATCH_MEMORYPRESSURE_CRITICAL,
+      dispatch_get_main_queue());
+  dispatch_source_t source = memory_pressure_source_;
+  dispatch_source_set_event_handler(source, ^{
+    unsigned long pressure = dispatch_source_get_data(source);
+    if (pressure & DISPATCH_MEMORYPRESSURE_CRITICAL)
+      base::MemoryPressureListener::NotifyMemoryPressure(
+          base::MemoryPressureListener::MEMORY_PRESSURE_LEVEL_CRITICAL);
+    else if (pressure & DISPATCH_MEMORYPRESSURE_WARN)
+      base::MemoryPressureListener::NotifyMemoryPressure(
+          base::MemoryPressureListener::MEMORY_PRESSURE_LEVEL_MODERATE);
+  });
+  dispatch_resume(source);
+}
+
+void AtomBrowserMainParts::StopMemoryPressureMonitor() {
+  if (!memory_pressure_source_)
+    return;
+  dispatch_source_cancel(memory_pressure_source_);
+  dispatch_release(memory_pressure_source_);
+  memory_pressure_source_ = NULL;
+}
+
+void AtomBrowserMainParts::FreeAppDelegate() {
   [[NSApp delegate] release];
   [NSApp setDelegate:nil];
 }
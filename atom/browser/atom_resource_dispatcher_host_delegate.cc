@@ -6,6 +6,7 @@
 
 #include <string>
 
+#include "atom/browser/net/network_observer.h"
 #include "base/logging.h"
 #include "content/public/browser/render_frame_host.h"
 #include "content/public/browser/resource_request_info.h"
@@ -30,4 +31,9 @@ void AtomResourceDispatcherHostDelegate::OnResponseStarted(
   }
 }
 
+void AtomResourceDispatcherHostDelegate::RequestComplete(
+    net::URLRequest* url_request) {
+  NetworkObserver::GetInstance()->OnRequestComplete(url_request);
+}
+
 }  // namespace atom
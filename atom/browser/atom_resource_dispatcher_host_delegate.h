@@ -20,6 +20,7 @@ class AtomResourceDispatcherHostDelegate
                          content::ResourceContext* resource_context,
                          content::ResourceResponse* response,
                          IPC::Sender* sender) override;
+  void RequestComplete(net::URLRequest* url_request) override;
 
  private:
   DISALLOW_COPY_AND_ASSIGN(AtomResourceDispatcherHostDelegate);
@@ -4,6 +4,10 @@
 
 #include "atom/browser/auto_updater.h"
 
+#include "atom/browser/delta_updater.h"
+#include "atom/common/node_bindings.h"
+#include "url/gurl.h"
+
 namespace auto_updater {
 
 AutoUpdaterDelegate* AutoUpdater::delegate_ = NULL;
@@ -16,4 +20,16 @@ void AutoUpdater::SetDelegate(AutoUpdaterDelegate* delegate) {
   delegate_ = delegate;
 }
 
+// static
+void AutoUpdater::CheckForDeltaUpdates(const std::string& url,
+                                       const std::string& public_key) {
+  DeltaUpdater::CheckForUpdates(GURL(url), public_key,
+                                atom::NodeBindings::GetResourcesPath(true));
+}
+
+// static
+void AutoUpdater::SetBandwidthLimit(int bytes_per_second) {
+  DeltaUpdater::SetBandwidthLimit(bytes_per_second);
+}
+
 }  // namespace auto_updater
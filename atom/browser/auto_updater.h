@@ -22,6 +22,15 @@ class AutoUpdater {
   static void SetFeedURL(const std::string& url);
   static void CheckForUpdates();
 
+  // Downloads the update described by the delta manifest at |url|, which
+  // works on all platforms, see DeltaUpdater. The manifest has to be signed
+  // by the key of |public_key|, a base64 encoded DER SubjectPublicKeyInfo.
+  static void CheckForDeltaUpdates(const std::string& url,
+                                   const std::string& public_key);
+
+  // Limits the average speed of the delta downloads, 0 for no limit.
+  static void SetBandwidthLimit(int bytes_per_second);
+
  private:
   static AutoUpdaterDelegate* delegate_;
 
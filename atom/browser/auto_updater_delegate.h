@@ -7,6 +7,7 @@
 
 #include <string>
 
+#include "base/basictypes.h"
 #include "base/callback_forward.h"
 
 namespace base {
@@ -29,6 +30,12 @@ class AutoUpdaterDelegate {
   // There is no available update.
   virtual void OnUpdateNotAvailable() {}
 
+  // |received| of |total| bytes of the update have been downloaded, at
+  // |bytes_per_second| on average.
+  virtual void OnUpdateDownloadProgress(int64 received,
+                                        int64 total,
+                                        int64 bytes_per_second) {}
+
   // There is a new update which has been downloaded.
   virtual void OnUpdateDownloaded(const std::string& release_notes,
                                   const std::string& release_name,
@@ -8,13 +8,16 @@
 
 #include "atom/browser/atom_browser_main_parts.h"
 #include "atom/browser/window_list.h"
+#include "atom/common/startup_timings.h"
 #include "base/message_loop/message_loop.h"
 
 namespace atom {
 
 Browser::Browser()
     : is_quiting_(false),
-      is_ready_(false) {
+      is_ready_(false),
+      suppress_dialogs_on_quit_(false),
+      fast_shutdown_(false) {
   WindowList::AddObserver(this);
 }
 
@@ -36,10 +39,35 @@ void Browser::Quit() {
   if (window_list->size() == 0)
     NotifyAndShutdown();
 
+  // No page can stop the quitting, so there is nothing to wait for.
+  if (fast_shutdown_ && suppress_dialogs_on_quit_) {
+    WindowList::DestroyAllWindows();
+    return;
+  }
+
   window_list->CloseAllWindows();
+
+  // Closing the windows may have finished quitting already.
+  if (is_quiting_ && quit_timeout_ > base::TimeDelta() &&
+      window_list->size() > 0)
+    quit_timer_.Start(FROM_HERE, quit_timeout_, this,
+                      &Browser::OnQuitTimeout);
+}
+
+void Browser::SetQuitOptions(base::TimeDelta timeout,
+                             bool suppress_dialogs,
+                             bool fast_shutdown) {
+  quit_timeout_ = timeout;
+  suppress_dialogs_on_quit_ = suppress_dialogs;
+  fast_shutdown_ = fast_shutdown;
 }
 
 void Browser::Shutdown() {
+  // The files must be given up before the "exit" handlers destroy the
+  // archives.
+  if (fast_shutdown_)
+    AtomBrowserMainParts::Get()->DeferTemporaryFilesDeletion();
+
   FOR_EACH_OBSERVER(BrowserObserver, observers_, OnQuit());
 
   is_quiting_ = true;
@@ -95,11 +123,17 @@ void Browser::ActivateWithNoOpenWindows() {
   FOR_EACH_OBSERVER(BrowserObserver, observers_, OnActivateWithNoOpenWindows());
 }
 
+void Browser::MemoryPressure(
+    base::MemoryPressureListener::MemoryPressureLevel level) {
+  FOR_EACH_OBSERVER(BrowserObserver, observers_, OnMemoryPressure(level));
+}
+
 void Browser::WillFinishLaunching() {
   FOR_EACH_OBSERVER(BrowserObserver, observers_, OnWillFinishLaunching());
 }
 
 void Browser::DidFinishLaunching() {
+  StartupTimings::GetInstance()->Record("ready");
   is_ready_ = true;
   FOR_EACH_OBSERVER(BrowserObserver, observers_, OnFinishLaunching());
 }
@@ -125,11 +159,18 @@ bool Browser::HandleBeforeQuit() {
   return !prevent_default;
 }
 
-void Browser::OnWindowCloseCancelled(NativeWindow* window) {
+void Browser::OnQuitTimeout() {
   if (is_quiting_)
+    WindowList::DestroyAllWindows();
+}
+
+void Browser::OnWindowCloseCancelled(NativeWindow* window) {
+  if (is_quiting_) {
     // Once a beforeunload handler has prevented the closing, we think the quit
     // is cancelled too.
     is_quiting_ = false;
+    quit_timer_.Stop();
+  }
 }
 
 void Browser::OnWindowAllClosed() {
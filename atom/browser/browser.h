@@ -11,6 +11,8 @@
 #include "base/basictypes.h"
 #include "base/compiler_specific.h"
 #include "base/observer_list.h"
+#include "base/time/time.h"
+#include "base/timer/timer.h"
 #include "atom/browser/browser_observer.h"
 #include "atom/browser/window_list_observer.h"
 
@@ -40,6 +42,19 @@ class Browser : public WindowListObserver {
   // Try to close all windows and quit the application.
   void Quit();
 
+  // All windows are asked to close at the same time when quitting, those still
+  // open after |timeout| are destroyed without waiting for their pages, an
+  // empty |timeout| waits for them forever. With |suppress_dialogs| the
+  // beforeunload handlers are skipped, so pages can neither show dialogs nor
+  // cancel the quitting. With |fast_shutdown| the windows are destroyed at
+  // once when the dialogs are suppressed, and the teardown after quitting is
+  // cut down to what keeps the user's data.
+  void SetQuitOptions(base::TimeDelta timeout,
+                      bool suppress_dialogs,
+                      bool fast_shutdown);
+  bool suppress_dialogs_on_quit() const { return suppress_dialogs_on_quit_; }
+  bool fast_shutdown() const { return fast_shutdown_; }
+
   // Cleanup everything and shutdown the application gracefully.
   void Shutdown();
 
@@ -111,6 +126,9 @@ class Browser : public WindowListObserver {
   // Tell the application that application is activated with no open windows.
   void ActivateWithNoOpenWindows();
 
+  // Tell the application that the system is under memory pressure.
+  void MemoryPressure(base::MemoryPressureListener::MemoryPressureLevel level);
+
   // Tell the application the loading has been done.
   void WillFinishLaunching();
   void DidFinishLaunching();
@@ -139,6 +157,9 @@ class Browser : public WindowListObserver {
   // Send the before-quit message and start closing windows.
   bool HandleBeforeQuit();
 
+  // Destroys the windows that have not closed in the quit timeout.
+  void OnQuitTimeout();
+
   bool is_quiting_;
 
  private:
@@ -152,6 +173,11 @@ class Browser : public WindowListObserver {
   // Whether "ready" event has been emitted.
   bool is_ready_;
 
+  base::TimeDelta quit_timeout_;
+  bool suppress_dialogs_on_quit_;
+  bool fast_shutdown_;
+  base::OneShotTimer<Browser> quit_timer_;
+
   std::string version_override_;
   std::string name_override_;
 
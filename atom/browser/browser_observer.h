@@ -7,6 +7,8 @@
 
 #include <string>
 
+#include "base/memory/memory_pressure_listener.h"
+
 namespace atom {
 
 class BrowserObserver {
@@ -36,6 +38,10 @@ class BrowserObserver {
   // dock icon).
   virtual void OnActivateWithNoOpenWindows() {}
 
+  // The system is low on memory, the caches of browser have been purged.
+  virtual void OnMemoryPressure(
+      base::MemoryPressureListener::MemoryPressureLevel level) {}
+
   // The browser has finished loading.
   virtual void OnWillFinishLaunching() {}
   virtual void OnFinishLaunching() {}
@@ -0,0 +1,725 @@
+// Copyright (c) 2015 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#include "atom/browser/delta_updater.h"
+
+#include <algorithm>
+
+#include "atom/browser/atom_browser_context.h"
+#include "atom/browser/auto_updater.h"
+#include "atom/browser/auto_updater_delegate.h"
+#include "atom/browser/browser.h"
+#include "base/base64.h"
+#include "base/bind.h"
+#include "base/containers/hash_tables.h"
+#include "base/files/file.h"
+#include "base/files/file_enumerator.h"
+#include "base/files/file_util.h"
+#include "base/files/important_file_writer.h"
+#include "base/files/memory_mapped_file.h"
+#include "base/json/json_reader.h"
+#include "base/message_loop/message_loop.h"
+#include "base/strings/string_number_conversions.h"
+#include "base/strings/string_piece.h"
+#include "base/strings/string_split.h"
+#include "base/strings/string_util.h"
+#include "base/task_runner_util.h"
+#include "base/values.h"
+#include "content/public/browser/browser_thread.h"
+#include "crypto/sha2.h"
+#include "crypto/signature_verifier.h"
+#include "net/base/load_flags.h"
+#include "net/url_request/url_fetcher.h"
+#include "net/url_request/url_request_status.h"
+
+using content::BrowserThread;
+
+namespace auto_updater {
+
+namespace {
+
+const int kMinBlockSize = 1024;
+const int kMaxBlockSize = 16 * 1024 * 1024;
+
+// The largest range requested at once, the response is kept in memory.
+const int64 kMaxRangeSize = 4 * 1024 * 1024;
+
+// The new file is written to "<name>.download" and renamed to
+// "<name>.update" once verified, which is moved over the installed file on
+// next launch.
+const base::FilePath::CharType kDownloadExtension[] =
+    FILE_PATH_LITERAL(".download");
+const base::FilePath::CharType kPendingExtension[] =
+    FILE_PATH_LITERAL(".update");
+
+// The installed files are moved to "<name>.old" while the update is applied,
+// and moved back if it fails.
+const base::FilePath::CharType kBackupExtension[] =
+    FILE_PATH_LITERAL(".old");
+
+// Lists the names of the files of a verified update, one per line. It is
+// written after all of them have been renamed to "<name>.update", and removed
+// once they are all installed, so only complete updates are applied.
+const base::FilePath::CharType kPendingList[] =
+    FILE_PATH_LITERAL("update.pending");
+
+// The signature of the manifest is fetched from "<manifest url>.sig".
+const char kSignatureSuffix[] = ".sig";
+
+// The DER encoded AlgorithmIdentifier of sha256WithRSAEncryption.
+const uint8 kSignatureAlgorithm[] = {
+  0x30, 0x0d, 0x06, 0x09, 0x2a, 0x86, 0x48, 0x86, 0xf7, 0x0d, 0x01, 0x01,
+  0x0b, 0x05, 0x00,
+};
+
+// How many times a request is retried when the network changes.
+const int kMaxRetriesOnNetworkChange = 3;
+
+// The running check.
+DeltaUpdater* g_delta_updater = nullptr;
+
+// In bytes per second, 0 for no limit.
+int64 g_bandwidth_limit = 0;
+
+// Whether the block of |file| at |offset| has been written by an interrupted
+// download.
+bool HasBlock(base::File* file, int64 offset, int size,
+              const std::string& strong) {
+  std::vector<char> buffer(size);
+  return file->Read(offset, buffer.data(), size) == size &&
+         crypto::SHA256HashString(base::StringPiece(buffer.data(), size)) ==
+             strong;
+}
+
+bool HexToSHA256(const std::string& hex, std::string* out) {
+  std::vector<uint8> bytes;
+  if (!base::HexStringToBytes(hex, &bytes) ||
+      bytes.size() != crypto::kSHA256Length)
+    return false;
+  out->assign(bytes.begin(), bytes.end());
+  return true;
+}
+
+std::string SHA256(const uint8* data, size_t length) {
+  return crypto::SHA256HashString(
+      base::StringPiece(reinterpret_cast<const char*>(data), length));
+}
+
+// Puts |moved| of the files being installed back, the new files go back to
+// "<name>.update" so the next launch can try again.
+void RollBackUpdate(const std::vector<base::FilePath>& moved) {
+  for (auto it = moved.rbegin(); it != moved.rend(); ++it) {
+    base::FilePath backup = it->AddExtension(kBackupExtension);
+    if (!base::ReplaceFile(*it, it->AddExtension(kPendingExtension), nullptr) ||
+        (base::PathExists(backup) && !base::ReplaceFile(backup, *it, nullptr)))
+      LOG(ERROR) << "Failed to roll back the update of " << it->value();
+  }
+}
+
+}  // namespace
+
+DeltaUpdater::File::File() : size(0), up_to_date(false) {
+}
+
+DeltaUpdater::File::~File() {
+}
+
+DeltaUpdater::Plan::Plan() : success(false), up_to_date(false) {
+}
+
+DeltaUpdater::Plan::~Plan() {
+}
+
+// static
+void DeltaUpdater::CheckForUpdates(const GURL& manifest_url,
+                                   const std::string& public_key,
+                                   const base::FilePath& resources_path) {
+  DCHECK(BrowserThread::CurrentlyOn(BrowserThread::UI));
+  if (g_delta_updater)
+    return;
+
+  g_delta_updater = new DeltaUpdater(manifest_url, public_key, resources_path);
+  g_delta_updater->Start();
+}
+
+// static
+void DeltaUpdater::ApplyPendingUpdates(const base::FilePath& resources_path) {
+  base::FilePath list_path = resources_path.Append(kPendingList);
+  std::string list;
+  if (!base::ReadFileToString(list_path, &list))
+    return;
+
+  std::vector<std::string> names;
+  base::SplitString(list, '\n', &names);
+  std::vector<base::FilePath> moved;
+  for (const std::string& name : names) {
+    if (name.empty())
+      continue;
+    base::FilePath target =
+        resources_path.Append(base::FilePath::FromUTF8Unsafe(name));
+    base::FilePath pending = target.AddExtension(kPendingExtension);
+    base::FilePath backup = target.AddExtension(kBackupExtension);
+
+    // Installed by a launch that was interrupted before finishing.
+    if (!base::PathExists(pending) && base::PathExists(target)) {
+      moved.push_back(target);
+      continue;
+    }
+
+    base::File::Error error = base::File::FILE_ERROR_NOT_FOUND;
+    if (!base::PathExists(pending) ||
+        (base::PathExists(target) &&
+         !base::ReplaceFile(target, backup, &error))) {
+      LOG(ERROR) << "Failed to install update " << pending.value() << ": "
+                 << base::File::ErrorToString(error);
+      RollBackUpdate(moved);
+      return;
+    }
+    if (!base::ReplaceFile(pending, target, &error)) {
+      LOG(ERROR) << "Failed to install update " << pending.value() << ": "
+                 << base::File::ErrorToString(error);
+      if (base::PathExists(backup))
+        base::ReplaceFile(backup, target, nullptr);
+      RollBackUpdate(moved);
+      return;
+    }
+    moved.push_back(target);
+  }
+
+  // All files are in place, the old ones are no longer needed.
+  base::DeleteFile(list_path, false);
+  for (const base::FilePath& target : moved)
+    base::DeleteFile(target.AddExtension(kBackupExtension), false);
+}
+
+// static
+void DeltaUpdater::SetBandwidthLimit(int64 bytes_per_second) {
+  g_bandwidth_limit = std::max<int64>(bytes_per_second, 0);
+}
+
+// static
+uint32 DeltaUpdater::WeakChecksum(const uint8* data, size_t length) {
+  uint32 a = 0, b = 0;
+  for (size_t i = 0; i < length; ++i) {
+    a += data[i];
+    b += (length - i) * data[i];
+  }
+  return (a & 0xffff) | ((b & 0xffff) << 16);
+}
+
+DeltaUpdater::DeltaUpdater(const GURL& manifest_url,
+                           const std::string& public_key,
+                           const base::FilePath& resources_path)
+    : manifest_url_(manifest_url),
+      public_key_(public_key),
+      resources_path_(resources_path),
+      manifest_fetched_(false),
+      block_size_(0),
+      next_file_(0),
+      next_range_(0),
+      received_bytes_(0),
+      total_bytes_(0),
+      weak_factory_(this) {
+}
+
+DeltaUpdater::~DeltaUpdater() {
+}
+
+void DeltaUpdater::Start() {
+  AutoUpdaterDelegate* delegate = AutoUpdater::GetDelegate();
+  if (delegate)
+    delegate->OnCheckingForUpdate();
+
+  Fetch(manifest_url_);
+  fetcher_->Start();
+}
+
+void DeltaUpdater::Fetch(const GURL& url) {
+  fetcher_.reset(net::URLFetcher::Create(url, net::URLFetcher::GET, this));
+  fetcher_->SetRequestContext(
+      atom::AtomBrowserContext::Get()->url_request_context_getter());
+  fetcher_->SetLoadFlags(net::LOAD_DISABLE_CACHE |
+                         net::LOAD_DO_NOT_SAVE_COOKIES |
+                         net::LOAD_DO_NOT_SEND_COOKIES);
+}
+
+bool DeltaUpdater::VerifyManifest(const std::string& signature) const {
+  std::string key, decoded;
+  if (!base::Base64Decode(public_key_, &key) ||
+      !base::Base64Decode(base::CollapseWhitespaceASCII(signature, true),
+                          &decoded) ||
+      key.empty() || decoded.empty())
+    return false;
+
+  crypto::SignatureVerifier verifier;
+  if (!verifier.VerifyInit(
+          kSignatureAlgorithm, sizeof(kSignatureAlgorithm),
+          reinterpret_cast<const uint8*>(decoded.data()), decoded.size(),
+          reinterpret_cast<const uint8*>(key.data()), key.size()))
+    return false;
+  verifier.VerifyUpdate(reinterpret_cast<const uint8*>(manifest_.data()),
+                        manifest_.size());
+  return verifier.VerifyFinal();
+}
+
+bool DeltaUpdater::ParseManifest(const std::string& json) {
+  scoped_ptr<base::Value> value(base::JSONReader::Read(json));
+  base::DictionaryValue* manifest;
+  if (!value || !value->GetAsDictionary(&manifest))
+    return false;
+
+  manifest->GetString("name", &release_name_);
+  manifest->GetString("notes", &release_notes_);
+  std::string pub_date;
+  if (manifest->GetString("pub_date", &pub_date))
+    base::Time::FromString(pub_date.c_str(), &release_date_);
+
+  base::ListValue* files;
+  if (!manifest->GetInteger("blockSize", &block_size_) ||
+      block_size_ < kMinBlockSize || block_size_ > kMaxBlockSize ||
+      !manifest->GetList("files", &files) || files->empty())
+    return false;
+
+  for (size_t i = 0; i < files->GetSize(); ++i) {
+    base::DictionaryValue* dict;
+    std::string path, url, sha256;
+    double size;
+    base::ListValue* blocks;
+    if (!files->GetDictionary(i, &dict) ||
+        !dict->GetString("path", &path) ||
+        !dict->GetString("url", &url) ||
+        !dict->GetDouble("size", &size) ||
+        !dict->GetString("sha256", &sha256) ||
+        !dict->GetList("blocks", &blocks))
+      return false;
+
+    // Only the files directly in the resources directory can be updated.
+    base::FilePath name = base::FilePath::FromUTF8Unsafe(path);
+    if (name.empty() || name.BaseName() != name || name.ReferencesParent() ||
+        name.value() == kPendingList)
+      return false;
+
+    File file;
+    file.path = resources_path_.Append(name);
+    file.url = manifest_url_.Resolve(url);
+    file.size = static_cast<int64>(size);
+    if (!file.url.is_valid() || file.size < 0 ||
+        !HexToSHA256(sha256, &file.sha256))
+      return false;
+
+    size_t block_count = (file.size + block_size_ - 1) / block_size_;
+    if (blocks->GetSize() != block_count)
+      return false;
+    for (size_t j = 0; j < block_count; ++j) {
+      base::ListValue* entry;
+      double weak;
+      std::string strong;
+      Block block;
+      if (!blocks->GetList(j, &entry) ||
+          !entry->GetDouble(0, &weak) ||
+          !entry->GetString(1, &strong) ||
+          !HexToSHA256(strong, &block.strong))
+        return false;
+      block.weak = static_cast<uint32>(weak);
+      file.blocks.push_back(block);
+    }
+    files_.push_back(file);
+  }
+  return true;
+}
+
+void DeltaUpdater::PlanNextFile() {
+  if (next_file_ < files_.size()) {
+    base::PostTaskAndReplyWithResult(
+        BrowserThread::GetMessageLoopProxyForThread(BrowserThread::FILE).get(),
+        FROM_HERE,
+        base::Bind(&DeltaUpdater::PlanFile,
+                   files_[next_file_], next_file_, block_size_,
+                   g_bandwidth_limit > 0 ?
+                       std::min(g_bandwidth_limit, kMaxRangeSize) :
+                       kMaxRangeSize),
+        base::Bind(&DeltaUpdater::OnFilePlanned,
+                   weak_factory_.GetWeakPtr()));
+    return;
+  }
+
+  bool up_to_date = true;
+  for (const File& file : files_)
+    up_to_date &= file.up_to_date;
+
+  AutoUpdaterDelegate* delegate = AutoUpdater::GetDelegate();
+  if (up_to_date) {
+    if (delegate)
+      delegate->OnUpdateNotAvailable();
+    Done();
+    return;
+  }
+
+  if (delegate)
+    delegate->OnUpdateAvailable();
+  for (const Range& range : ranges_)
+    total_bytes_ += range.length;
+  download_start_ = base::TimeTicks::Now();
+  FetchNextRange();
+}
+
+void DeltaUpdater::OnFilePlanned(const Plan& plan) {
+  if (!plan.success) {
+    Fail("Failed to write the update to " +
+         files_[next_file_].path.AsUTF8Unsafe());
+    return;
+  }
+
+  files_[next_file_].up_to_date = plan.up_to_date;
+  ranges_.insert(ranges_.end(), plan.ranges.begin(), plan.ranges.end());
+  ++next_file_;
+  PlanNextFile();
+}
+
+void DeltaUpdater::FetchNextRange() {
+  if (next_range_ == ranges_.size()) {
+    base::PostTaskAndReplyWithResult(
+        BrowserThread::GetMessageLoopProxyForThread(BrowserThread::FILE).get(),
+        FROM_HERE,
+        base::Bind(&DeltaUpdater::FinishFiles, resources_path_, files_),
+        base::Bind(&DeltaUpdater::OnFilesFinished,
+                   weak_factory_.GetWeakPtr()));
+    return;
+  }
+
+  // Wait until the average speed is under the limit.
+  if (g_bandwidth_limit > 0) {
+    base::TimeDelta expected = base::TimeDelta::FromMicroseconds(
+        received_bytes_ * base::Time::kMicrosecondsPerSecond /
+        g_bandwidth_limit);
+    base::TimeDelta elapsed = base::TimeTicks::Now() - download_start_;
+    if (elapsed < expected) {
+      base::MessageLoop::current()->PostDelayedTask(
+          FROM_HERE,
+          base::Bind(&DeltaUpdater::FetchNextRange,
+                     weak_factory_.GetWeakPtr()),
+          expected - elapsed);
+      return;
+    }
+  }
+
+  const Range& range = ranges_[next_range_];
+  Fetch(files_[range.file_index].url);
+  fetcher_->SetAutomaticallyRetryOnNetworkChanges(kMaxRetriesOnNetworkChange);
+  fetcher_->AddExtraRequestHeader(
+      "Range: bytes=" + base::Int64ToString(range.offset) + "-" +
+      base::Int64ToString(range.offset + range.length - 1));
+  fetcher_->Start();
+}
+
+void DeltaUpdater::OnRangeWritten(bool success) {
+  if (!success) {
+    Fail("The downloaded update is corrupted");
+    return;
+  }
+
+  received_bytes_ += ranges_[next_range_].length;
+  ++next_range_;
+  FetchNextRange();
+}
+
+void DeltaUpdater::OnFilesFinished(bool success) {
+  if (!success) {
+    Fail("Failed to verify the downloaded update");
+    return;
+  }
+
+  // The files are moved into place on next launch.
+  AutoUpdaterDelegate* delegate = AutoUpdater::GetDelegate();
+  if (delegate)
+    delegate->OnUpdateDownloaded(
+        release_notes_, release_name_, release_date_, manifest_url_.spec(),
+        base::Bind(&atom::Browser::Quit,
+                   base::Unretained(atom::Browser::Get())));
+  Done();
+}
+
+void DeltaUpdater::Fail(const std::string& error) {
+  AutoUpdaterDelegate* delegate = AutoUpdater::GetDelegate();
+  if (delegate)
+    delegate->OnError(error);
+  Done();
+}
+
+void DeltaUpdater::Done() {
+  DCHECK_EQ(g_delta_updater, this);
+  g_delta_updater = nullptr;
+  delete this;
+}
+
+void DeltaUpdater::OnURLFetchComplete(const net::URLFetcher* source) {
+  scoped_ptr<net::URLFetcher> fetcher(fetcher_.Pass());
+  int response_code = source->GetResponseCode();
+  std::string data;
+  if (!source->GetStatus().is_success() || !source->GetResponseAsString(&data))
+    response_code = -1;
+
+  // The manifest is the first thing fetched, followed by its signature.
+  if (!manifest_fetched_) {
+    if (response_code != 200) {
+      Fail("Failed to download the update manifest from " +
+           manifest_url_.spec());
+      return;
+    }
+    manifest_fetched_ = true;
+    manifest_.swap(data);
+    Fetch(GURL(manifest_url_.spec() + kSignatureSuffix));
+    fetcher_->Start();
+    return;
+  }
+  if (files_.empty()) {
+    if (response_code != 200) {
+      Fail("Failed to download the signature of the update manifest");
+    } else if (!VerifyManifest(data)) {
+      Fail("The update manifest is not signed by the public key");
+    } else if (!ParseManifest(manifest_)) {
+      Fail("Invalid update manifest");
+    } else {
+      manifest_.clear();
+      PlanNextFile();
+    }
+    return;
+  }
+
+  const Range& range = ranges_[next_range_];
+  if (response_code != 206) {
+    Fail("Failed to download the range of " +
+         files_[range.file_index].url.spec());
+    return;
+  }
+
+  base::PostTaskAndReplyWithResult(
+      BrowserThread::GetMessageLoopProxyForThread(BrowserThread::FILE).get(),
+      FROM_HERE,
+      base::Bind(&DeltaUpdater::WriteRange,
+                 files_[range.file_index], block_size_, range, data),
+      base::Bind(&DeltaUpdater::OnRangeWritten, weak_factory_.GetWeakPtr()));
+}
+
+void DeltaUpdater::OnURLFetchDownloadProgress(const net::URLFetcher* source,
+                                              int64 current,
+                                              int64 total) {
+  if (files_.empty())
+    return;
+
+  int64 received = received_bytes_ + current;
+  int64 elapsed_ms =
+      (base::TimeTicks::Now() - download_start_).InMilliseconds();
+  int64 bytes_per_second = elapsed_ms > 0 ? received * 1000 / elapsed_ms : 0;
+  AutoUpdaterDelegate* delegate = AutoUpdater::GetDelegate();
+  if (delegate)
+    delegate->OnUpdateDownloadProgress(received, total_bytes_,
+                                       bytes_per_second);
+}
+
+// static
+void DeltaUpdater::FindBlocks(const uint8* data,
+                              size_t length,
+                              const File& file,
+                              int block_size,
+                              std::vector<int64>* found) {
+  size_t window = static_cast<size_t>(block_size);
+  if (!data || length < window)
+    return;
+
+  // Only the full blocks are searched, a short last block is downloaded.
+  base::hash_map<uint32, std::vector<size_t>> blocks_of_weak;
+  for (size_t i = 0; i < file.blocks.size(); ++i)
+    if (static_cast<int64>((i + 1) * window) <= file.size)
+      blocks_of_weak[file.blocks[i].weak].push_back(i);
+
+  uint32 weak = WeakChecksum(data, window);
+  uint32 a = weak & 0xffff, b = weak >> 16;
+  size_t pos = 0;
+  while (true) {
+    bool matched = false;
+    auto it = blocks_of_weak.find(a | (b << 16));
+    if (it != blocks_of_weak.end()) {
+      std::string strong = SHA256(data + pos, window);
+      for (size_t index : it->second) {
+        if (file.blocks[index].strong != strong)
+          continue;
+        matched = true;
+        if ((*found)[index] < 0)
+          (*found)[index] = pos;
+      }
+    }
+
+    if (matched) {
+      // Blocks do not overlap, so the search goes on after the match.
+      pos += window;
+      if (pos + window > length)
+        break;
+      weak = WeakChecksum(data + pos, window);
+      a = weak & 0xffff;
+      b = weak >> 16;
+    } else {
+      if (pos + window >= length)
+        break;
+      uint32 out = data[pos], in = data[pos + window];
+      a = (a - out + in) & 0xffff;
+      b = (b - window * out + a) & 0xffff;
+      ++pos;
+    }
+  }
+}
+
+// static
+DeltaUpdater::Plan DeltaUpdater::PlanFile(const File& file,
+                                          size_t file_index,
+                                          int block_size,
+                                          int64 max_range_size) {
+  DCHECK(BrowserThread::CurrentlyOn(BrowserThread::FILE));
+  Plan plan;
+
+  // An empty or missing file is downloaded as a whole.
+  base::MemoryMappedFile installed;
+  const uint8* data = nullptr;
+  size_t length = 0;
+  if (base::PathExists(file.path) && installed.Initialize(file.path)) {
+    data = installed.data();
+    length = installed.length();
+  }
+  if (data && static_cast<int64>(length) == file.size &&
+      SHA256(data, length) == file.sha256) {
+    plan.success = true;
+    plan.up_to_date = true;
+    return plan;
+  }
+
+  std::vector<int64> found(file.blocks.size(), -1);
+  FindBlocks(data, length, file, block_size, &found);
+
+  // The file left by an interrupted download is kept for resuming.
+  base::File output(file.path.AddExtension(kDownloadExtension),
+                    base::File::FLAG_OPEN_ALWAYS | base::File::FLAG_READ |
+                    base::File::FLAG_WRITE);
+  if (!output.IsValid())
+    return plan;
+  bool resuming = output.GetLength() == file.size;
+  if (!resuming && !output.SetLength(file.size))
+    return plan;
+
+  // The blocks found are copied, the others are merged into ranges.
+  int64 max_range = std::max<int64>(max_range_size / block_size, 1) *
+                    block_size;
+  for (size_t i = 0; i < file.blocks.size(); ++i) {
+    int64 offset = static_cast<int64>(i) * block_size;
+    int size = static_cast<int>(
+        std::min<int64>(block_size, file.size - offset));
+    if (found[i] >= 0) {
+      if (output.Write(offset, reinterpret_cast<const char*>(data + found[i]),
+                       size) != size)
+        return plan;
+      continue;
+    }
+    if (resuming && HasBlock(&output, offset, size, file.blocks[i].strong))
+      continue;
+
+    if (!plan.ranges.empty()) {
+      Range& last = plan.ranges.back();
+      if (last.offset + last.length == offset &&
+          last.length + size <= max_range) {
+        last.length += size;
+        continue;
+      }
+    }
+    Range range = { file_index, offset, size };
+    plan.ranges.push_back(range);
+  }
+
+  plan.success = true;
+  return plan;
+}
+
+// static
+bool DeltaUpdater::WriteRange(const File& file,
+                              int block_size,
+                              const Range& range,
+                              const std::string& data) {
+  DCHECK(BrowserThread::CurrentlyOn(BrowserThread::FILE));
+  if (static_cast<int64>(data.size()) != range.length)
+    return false;
+
+  // The ranges start at block boundaries.
+  for (int64 offset = 0; offset < range.length; offset += block_size) {
+    size_t index = static_cast<size_t>((range.offset + offset) / block_size);
+    size_t size = static_cast<size_t>(
+        std::min<int64>(block_size, range.length - offset));
+    if (index >= file.blocks.size() ||
+        SHA256(reinterpret_cast<const uint8*>(data.data() + offset), size) !=
+            file.blocks[index].strong)
+      return false;
+  }
+
+  base::File output(file.path.AddExtension(kDownloadExtension),
+                    base::File::FLAG_OPEN | base::File::FLAG_WRITE);
+  return output.IsValid() &&
+         output.Write(range.offset, data.data(), data.size()) ==
+             static_cast<int>(data.size());
+}
+
+// static
+bool DeltaUpdater::FinishFiles(const base::FilePath& resources_path,
+                               const std::vector<File>& files) {
+  DCHECK(BrowserThread::CurrentlyOn(BrowserThread::FILE));
+  for (const File& file : files) {
+    if (file.up_to_date)
+      continue;
+
+    base::FilePath download = file.path.AddExtension(kDownloadExtension);
+    std::string sha256;
+    if (file.size == 0) {
+      sha256 = SHA256(nullptr, 0);
+    } else {
+      base::MemoryMappedFile mapped;
+      if (!mapped.Initialize(download))
+        return false;
+      sha256 = SHA256(mapped.data(), mapped.length());
+    }
+    if (sha256 != file.sha256) {
+      base::DeleteFile(download, false);
+      return false;
+    }
+  }
+
+  // A previous update that was never installed is replaced by this one.
+  base::FilePath list_path = resources_path.Append(kPendingList);
+  if (!base::DeleteFile(list_path, false))
+    return false;
+  base::FileEnumerator enumerator(
+      resources_path, false, base::FileEnumerator::FILES,
+      base::FilePath::StringType(FILE_PATH_LITERAL("*")) + kPendingExtension);
+  for (base::FilePath stale = enumerator.Next(); !stale.empty();
+       stale = enumerator.Next())
+    base::DeleteFile(stale, false);
+
+  // Only list the files as pending when all of them are good, so they are
+  // installed together.
+  std::string list;
+  std::vector<const File*> renamed;
+  for (const File& file : files) {
+    if (file.up_to_date)
+      continue;
+    if (!base::ReplaceFile(file.path.AddExtension(kDownloadExtension),
+                           file.path.AddExtension(kPendingExtension),
+                           nullptr)) {
+      for (const File* done : renamed)
+        base::ReplaceFile(done->path.AddExtension(kPendingExtension),
+                          done->path.AddExtension(kDownloadExtension),
+                          nullptr);
+      return false;
+    }
+    renamed.push_back(&file);
+    list += file.path.BaseName().AsUTF8Unsafe() + "\n";
+  }
+  return base::ImportantFileWriter::WriteFileAtomically(list_path, list);
+}
+
+}  // namespace auto_updater
@@ -0,0 +1,171 @@
+// Copyright (c) 2015 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#ifndef ATOM_BROWSER_DELTA_UPDATER_H_
+#define ATOM_BROWSER_DELTA_UPDATER_H_
+
+#include <string>
+#include <vector>
+
+#include "base/files/file_path.h"
+#include "base/memory/scoped_ptr.h"
+#include "base/memory/weak_ptr.h"
+#include "base/time/time.h"
+#include "net/url_request/url_fetcher_delegate.h"
+#include "url/gurl.h"
+
+namespace auto_updater {
+
+// Updates the files in the resources directory, like app.asar and atom.asar,
+// by only downloading the blocks that are not in the installed files.
+//
+// The manifest describes each new file as blocks with the rolling checksum of
+// rsync and the SHA-256 of each block. Like zsync, the installed file is
+// scanned for the blocks at any offset, so the data inserted in the new file
+// only costs the blocks around it. The missing blocks are fetched with HTTP
+// range requests, and the new files are verified and then moved over the
+// installed ones on next launch. The manifest is only trusted when its
+// detached RSA signature, fetched from "<manifest url>.sig", is made by the
+// key given by the app.
+//
+// The blocks already in a ".download" file left by an interrupted check are
+// kept, so downloads resume where they stopped. With a bandwidth limit the
+// ranges are made smaller and their requests are spaced out, keeping the
+// average speed under it.
+class DeltaUpdater : public net::URLFetcherDelegate {
+ public:
+  // Checks |manifest_url| for the new versions of the files in
+  // |resources_path|, the results are sent to the delegate of AutoUpdater.
+  // |public_key| is the base64 encoded DER SubjectPublicKeyInfo of the RSA
+  // key signing the manifest. Nothing is done when a check is already
+  // running.
+  static void CheckForUpdates(const GURL& manifest_url,
+                              const std::string& public_key,
+                              const base::FilePath& resources_path);
+
+  // Moves the files downloaded by the last update over the installed ones,
+  // should be called before any of them is opened. The installed files are
+  // kept until all of the new ones are in place, and are moved back when one
+  // of them can not be, so the files are never left from different updates.
+  static void ApplyPendingUpdates(const base::FilePath& resources_path);
+
+  // Limits the average speed of downloading, 0 for no limit.
+  static void SetBandwidthLimit(int64 bytes_per_second);
+
+  // The rolling checksum of |length| bytes in |data|, the low 16 bits are the
+  // sum of the bytes and the high 16 bits are the sum of the running sums.
+  static uint32 WeakChecksum(const uint8* data, size_t length);
+
+ private:
+  struct Block {
+    uint32 weak;
+    // The SHA-256 of the block, in bytes.
+    std::string strong;
+  };
+
+  struct File {
+    File();
+    ~File();
+
+    base::FilePath path;
+    GURL url;
+    int64 size;
+    std::string sha256;
+    std::vector<Block> blocks;
+    bool up_to_date;
+  };
+
+  // The contiguous blocks of a file that have to be downloaded.
+  struct Range {
+    size_t file_index;
+    int64 offset;
+    int64 length;
+  };
+
+  struct Plan {
+    Plan();
+    ~Plan();
+
+    bool success;
+    bool up_to_date;
+    std::vector<Range> ranges;
+  };
+
+  DeltaUpdater(const GURL& manifest_url,
+               const std::string& public_key,
+               const base::FilePath& resources_path);
+  ~DeltaUpdater() override;
+
+  void Start();
+  void Fetch(const GURL& url);
+  bool VerifyManifest(const std::string& signature) const;
+  bool ParseManifest(const std::string& json);
+
+  // Compares the files with the installed ones one by one.
+  void PlanNextFile();
+  void OnFilePlanned(const Plan& plan);
+
+  void FetchNextRange();
+  void OnRangeWritten(bool success);
+  void OnFilesFinished(bool success);
+
+  // Reports the result and deletes |this|.
+  void Fail(const std::string& error);
+  void Done();
+
+  // net::URLFetcherDelegate:
+  void OnURLFetchComplete(const net::URLFetcher* source) override;
+  void OnURLFetchDownloadProgress(const net::URLFetcher* source,
+                                  int64 current,
+                                  int64 total) override;
+
+  // Run on FILE thread.
+  static void FindBlocks(const uint8* data,
+                         size_t length,
+                         const File& file,
+                         int block_size,
+                         std::vector<int64>* found);
+  static Plan PlanFile(const File& file,
+                       size_t file_index,
+                       int block_size,
+                       int64 max_range_size);
+  static bool WriteRange(const File& file, int block_size, const Range& range,
+                         const std::string& data);
+  static bool FinishFiles(const base::FilePath& resources_path,
+                          const std::vector<File>& files);
+
+  GURL manifest_url_;
+  std::string public_key_;
+  base::FilePath resources_path_;
+
+  // Kept until its signature has been fetched.
+  std::string manifest_;
+  bool manifest_fetched_;
+
+  // Read from the manifest.
+  std::string release_name_;
+  std::string release_notes_;
+  base::Time release_date_;
+  int block_size_;
+  std::vector<File> files_;
+
+  size_t next_file_;
+  std::vector<Range> ranges_;
+  size_t next_range_;
+  int64 received_bytes_;
+  int64 total_bytes_;
+
+  // When the ranges started to download, for the speed.
+  base::TimeTicks download_start_;
+
+  scoped_ptr<net::URLFetcher> fetcher_;
+
+  base::WeakPtrFactory<DeltaUpdater> weak_factory_;
+
+  DISALLOW_COPY_AND_ASSIGN(DeltaUpdater);
+};
+
+}  // namespace auto_updater
+
+#endif  // ATOM_BROWSER_DELTA_UPDATER_H_
@@ -0,0 +1,292 @@
+// Copyright (c) 2015 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#include "atom/browser/desktop_media_list.h"
+
+#include <algorithm>
+#include <set>
+
+#include "base/bind.h"
+#include "base/hash.h"
+#include "base/message_loop/message_loop.h"
+#include "base/sequenced_task_runner.h"
+#include "base/strings/string_number_conversions.h"
+#include "base/strings/utf_string_conversions.h"
+#include "base/task_runner_util.h"
+#include "base/threading/sequenced_worker_pool.h"
+#include "content/public/browser/browser_thread.h"
+#include "third_party/libyuv/include/libyuv/scale_argb.h"
+#include "third_party/webrtc/modules/desktop_capture/desktop_capture_options.h"
+#include "third_party/webrtc/modules/desktop_capture/desktop_frame.h"
+#include "third_party/webrtc/modules/desktop_capture/screen_capturer.h"
+#include "third_party/webrtc/modules/desktop_capture/window_capturer.h"
+
+using content::BrowserThread;
+
+namespace atom {
+
+namespace {
+
+// The defaults when they are not set.
+const int kDefaultThumbnailWidth = 150;
+const int kDefaultThumbnailHeight = 150;
+const int kDefaultUpdatePeriodMs = 1000;
+
+const char kScreenPrefix[] = "screen:";
+const char kWindowPrefix[] = "window:";
+
+// Scales |frame| to fit in |size| keeping its aspect ratio.
+SkBitmap ScaleDesktopFrame(const webrtc::DesktopFrame& frame,
+                           const gfx::Size& size) {
+  int width = frame.size().width(), height = frame.size().height();
+  gfx::Size scaled(width, height);
+  if (width > size.width() || height > size.height()) {
+    double scale = std::min(static_cast<double>(size.width()) / width,
+                            static_cast<double>(size.height()) / height);
+    scaled.SetSize(std::max(1, static_cast<int>(width * scale)),
+                   std::max(1, static_cast<int>(height * scale)));
+  }
+
+  SkBitmap result;
+  result.allocN32Pixels(scaled.width(), scaled.height(), true);
+  result.lockPixels();
+  libyuv::ARGBScale(frame.data(), frame.stride(), width, height,
+                    reinterpret_cast<uint8*>(result.getPixels()),
+                    result.rowBytes(), scaled.width(), scaled.height(),
+                    libyuv::kFilterBilinear);
+  result.unlockPixels();
+  return result;
+}
+
+}  // namespace
+
+// Owns the platform capturers, lives on the worker thread.
+class DesktopMediaList::Worker : public webrtc::DesktopCapturer::Callback {
+ public:
+  Worker(bool screens, bool windows) : started_(false) {
+    webrtc::DesktopCaptureOptions options =
+        webrtc::DesktopCaptureOptions::CreateDefault();
+    if (screens)
+      screen_capturer_.reset(webrtc::ScreenCapturer::Create(options));
+    if (windows)
+      window_capturer_.reset(webrtc::WindowCapturer::Create(options));
+  }
+
+  ~Worker() override {}
+
+  RefreshResult Refresh(const gfx::Size& thumbnail_size) {
+    // The capturers start on the thread they capture on.
+    if (!started_) {
+      started_ = true;
+      if (screen_capturer_)
+        screen_capturer_->Start(this);
+      if (window_capturer_)
+        window_capturer_->Start(this);
+    }
+
+    RefreshResult result;
+    std::map<std::string, uint32> hashes;
+
+    if (screen_capturer_) {
+      webrtc::ScreenCapturer::ScreenList screens;
+      if (screen_capturer_->GetScreenList(&screens)) {
+        for (size_t i = 0; i < screens.size(); ++i) {
+          SourceDescription source;
+          source.id = kScreenPrefix + base::Int64ToString(screens[i].id);
+          source.name = screens.size() == 1 ?
+              base::ASCIIToUTF16("Entire screen") :
+              base::ASCIIToUTF16("Screen " + base::SizeTToString(i + 1));
+          result.sources.push_back(source);
+          if (screen_capturer_->SelectScreen(screens[i].id))
+            CaptureThumbnail(screen_capturer_.get(), source.id,
+                             thumbnail_size, &hashes, &result);
+        }
+      }
+    }
+
+    if (window_capturer_) {
+      webrtc::WindowCapturer::WindowList windows;
+      if (window_capturer_->GetWindowList(&windows)) {
+        for (const auto& window : windows) {
+          SourceDescription source;
+          source.id = kWindowPrefix + base::Int64ToString(window.id);
+          source.name = base::UTF8ToUTF16(window.title);
+          result.sources.push_back(source);
+          if (window_capturer_->SelectWindow(window.id))
+            CaptureThumbnail(window_capturer_.get(), source.id,
+                             thumbnail_size, &hashes, &result);
+        }
+      }
+    }
+
+    // The sources that have gone are forgotten.
+    hashes_.swap(hashes);
+    return result;
+  }
+
+ private:
+  // Captures the selected source of |capturer|, the thumbnail is only made
+  // when the content is different from last time.
+  void CaptureThumbnail(webrtc::DesktopCapturer* capturer,
+                        const std::string& id,
+                        const gfx::Size& thumbnail_size,
+                        std::map<std::string, uint32>* hashes,
+                        RefreshResult* result) {
+    current_frame_.reset();
+    capturer->Capture(webrtc::DesktopRegion());
+    if (!current_frame_)
+      return;
+
+    uint32 hash = base::Hash(
+        reinterpret_cast<const char*>(current_frame_->data()),
+        current_frame_->stride() * current_frame_->size().height());
+    (*hashes)[id] = hash;
+    auto it = hashes_.find(id);
+    if (it != hashes_.end() && it->second == hash)
+      return;
+
+    result->thumbnails[id] = ScaleDesktopFrame(*current_frame_,
+                                               thumbnail_size);
+  }
+
+  // webrtc::DesktopCapturer::Callback:
+  webrtc::SharedMemory* CreateSharedMemory(size_t size) override {
+    return NULL;
+  }
+
+  void OnCaptureCompleted(webrtc::DesktopFrame* frame) override {
+    current_frame_.reset(frame);
+  }
+
+  scoped_ptr<webrtc::ScreenCapturer> screen_capturer_;
+  scoped_ptr<webrtc::WindowCapturer> window_capturer_;
+
+  bool started_;
+  scoped_ptr<webrtc::DesktopFrame> current_frame_;
+
+  // The hashes of the frames of last refresh, keyed by source IDs.
+  std::map<std::string, uint32> hashes_;
+
+  DISALLOW_COPY_AND_ASSIGN(Worker);
+};
+
+DesktopMediaList::Source::Source() {
+}
+
+DesktopMediaList::Source::~Source() {
+}
+
+DesktopMediaList::RefreshResult::RefreshResult() {
+}
+
+DesktopMediaList::RefreshResult::~RefreshResult() {
+}
+
+DesktopMediaList::DesktopMediaList(bool screens,
+                                   bool windows,
+                                   Observer* observer)
+    : observer_(observer),
+      thumbnail_size_(kDefaultThumbnailWidth, kDefaultThumbnailHeight),
+      update_period_(
+          base::TimeDelta::FromMilliseconds(kDefaultUpdatePeriodMs)),
+      weak_factory_(this) {
+  base::SequencedWorkerPool* pool = BrowserThread::GetBlockingPool();
+  task_runner_ = pool->GetSequencedTaskRunnerWithShutdownBehavior(
+      pool->GetSequenceToken(),
+      base::SequencedWorkerPool::SKIP_ON_SHUTDOWN);
+  worker_.reset(new Worker(screens, windows));
+}
+
+DesktopMediaList::~DesktopMediaList() {
+  // The refreshes already posted use the worker until they finish.
+  task_runner_->DeleteSoon(FROM_HERE, worker_.release());
+}
+
+void DesktopMediaList::StartUpdating() {
+  DCHECK(BrowserThread::CurrentlyOn(BrowserThread::UI));
+  Refresh();
+}
+
+void DesktopMediaList::Refresh() {
+  base::PostTaskAndReplyWithResult(
+      task_runner_.get(),
+      FROM_HERE,
+      base::Bind(&Worker::Refresh, base::Unretained(worker_.get()),
+                 thumbnail_size_),
+      base::Bind(&DesktopMediaList::OnRefreshFinished,
+                 weak_factory_.GetWeakPtr()));
+}
+
+void DesktopMediaList::OnRefreshFinished(const RefreshResult& result) {
+  DCHECK(BrowserThread::CurrentlyOn(BrowserThread::UI));
+  UpdateSourcesList(result.sources);
+
+  for (const auto& thumbnail : result.thumbnails) {
+    for (size_t i = 0; i < sources_.size(); ++i) {
+      if (sources_[i].id != thumbnail.first)
+        continue;
+      sources_[i].thumbnail =
+          gfx::ImageSkia::CreateFrom1xBitmap(thumbnail.second);
+      observer_->OnSourceThumbnailChanged(i);
+      break;
+    }
+  }
+  observer_->OnRefreshFinished();
+
+  base::MessageLoop::current()->PostDelayedTask(
+      FROM_HERE,
+      base::Bind(&DesktopMediaList::Refresh, weak_factory_.GetWeakPtr()),
+      update_period_);
+}
+
+void DesktopMediaList::UpdateSourcesList(
+    const std::vector<SourceDescription>& new_sources) {
+  std::set<std::string> new_ids;
+  for (const auto& source : new_sources)
+    new_ids.insert(source.id);
+
+  // Remove the sources that have gone.
+  for (int i = sources_.size() - 1; i >= 0; --i) {
+    if (new_ids.find(sources_[i].id) == new_ids.end()) {
+      sources_.erase(sources_.begin() + i);
+      observer_->OnSourceRemoved(i);
+    }
+  }
+
+  // Then add the new ones and move the old ones to their new places, the
+  // sources before |pos| are in the order of |new_sources| after each step.
+  for (size_t pos = 0; pos < new_sources.size(); ++pos) {
+    const SourceDescription& source = new_sources[pos];
+    if (pos < sources_.size() && sources_[pos].id == source.id) {
+      if (sources_[pos].name != source.name) {
+        sources_[pos].name = source.name;
+        observer_->OnSourceNameChanged(pos);
+      }
+      continue;
+    }
+
+    size_t old_pos = pos + 1;
+    while (old_pos < sources_.size() && sources_[old_pos].id != source.id)
+      ++old_pos;
+
+    if (old_pos >= sources_.size()) {
+      Source added;
+      added.id = source.id;
+      added.name = source.name;
+      sources_.insert(sources_.begin() + pos, added);
+      observer_->OnSourceAdded(pos);
+    } else {
+      Source moved = sources_[old_pos];
+      sources_.erase(sources_.begin() + old_pos);
+      sources_.insert(sources_.begin() + pos, moved);
+      observer_->OnSourceMoved(old_pos, pos);
+      if (sources_[pos].name != source.name) {
+        sources_[pos].name = source.name;
+        observer_->OnSourceNameChanged(pos);
+      }
+    }
+  }
+}
+
+}  // namespace atom
@@ -0,0 +1,109 @@
+// Copyright (c) 2015 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#ifndef ATOM_BROWSER_DESKTOP_MEDIA_LIST_H_
+#define ATOM_BROWSER_DESKTOP_MEDIA_LIST_H_
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include "base/memory/ref_counted.h"
+#include "base/memory/scoped_ptr.h"
+#include "base/memory/weak_ptr.h"
+#include "base/strings/string16.h"
+#include "base/time/time.h"
+#include "third_party/skia/include/core/SkBitmap.h"
+#include "ui/gfx/geometry/size.h"
+#include "ui/gfx/image/image_skia.h"
+
+namespace base {
+class SequencedTaskRunner;
+}
+
+namespace atom {
+
+// Enumerates the screens and windows that can be captured, and keeps their
+// thumbnails up to date by refreshing them periodically. The platform
+// capturers run on a sequenced worker thread, and only the sources whose
+// content has changed since the last refresh get new thumbnails, so a picker
+// showing them is cheap to keep fresh. Should be used on UI thread.
+class DesktopMediaList {
+ public:
+  struct Source {
+    Source();
+    ~Source();
+
+    // "screen:<id>" or "window:<id>", which stays the same between refreshes.
+    std::string id;
+    base::string16 name;
+    // Empty until the first capture of the source.
+    gfx::ImageSkia thumbnail;
+  };
+
+  class Observer {
+   public:
+    virtual void OnSourceAdded(int index) = 0;
+    virtual void OnSourceRemoved(int index) = 0;
+    virtual void OnSourceMoved(int old_index, int new_index) = 0;
+    virtual void OnSourceNameChanged(int index) = 0;
+    virtual void OnSourceThumbnailChanged(int index) = 0;
+    virtual void OnRefreshFinished() = 0;
+
+   protected:
+    virtual ~Observer() {}
+  };
+
+  DesktopMediaList(bool screens, bool windows, Observer* observer);
+  ~DesktopMediaList();
+
+  // Should be set before StartUpdating.
+  void set_thumbnail_size(const gfx::Size& size) { thumbnail_size_ = size; }
+  void set_update_period(base::TimeDelta period) { update_period_ = period; }
+
+  // Refreshes the sources now and then every update period.
+  void StartUpdating();
+
+  const std::vector<Source>& sources() const { return sources_; }
+
+ private:
+  class Worker;
+
+  struct SourceDescription {
+    std::string id;
+    base::string16 name;
+  };
+
+  // What a refresh has found, with the thumbnails of the changed sources.
+  struct RefreshResult {
+    RefreshResult();
+    ~RefreshResult();
+
+    std::vector<SourceDescription> sources;
+    std::map<std::string, SkBitmap> thumbnails;
+  };
+
+  void Refresh();
+  void OnRefreshFinished(const RefreshResult& result);
+  void UpdateSourcesList(const std::vector<SourceDescription>& new_sources);
+
+  Observer* observer_;
+  gfx::Size thumbnail_size_;
+  base::TimeDelta update_period_;
+
+  scoped_refptr<base::SequencedTaskRunner> task_runner_;
+
+  // Used on |task_runner_| and deleted there.
+  scoped_ptr<Worker> worker_;
+
+  std::vector<Source> sources_;
+
+  base::WeakPtrFactory<DesktopMediaList> weak_factory_;
+
+  DISALLOW_COPY_AND_ASSIGN(DesktopMediaList);
+};
+
+}  // namespace atom
+
+#endif  // ATOM_BROWSER_DESKTOP_MEDIA_LIST_H_
@@ -0,0 +1,86 @@
+// Copyright (c) 2015 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#include "atom/browser/frame_stats_recorder.h"
+
+#include <algorithm>
+
+namespace atom {
+
+namespace {
+
+// The budget of a frame on a 60Hz screen.
+const int64 kFrameBudgetUs = base::Time::kMicrosecondsPerSecond / 60;
+
+// Do not keep the start times forever when the ends are never reported.
+const size_t kMaxPendingFrames = 8;
+
+}  // namespace
+
+FrameStats::FrameStats()
+    : frames_presented(0),
+      frames_dropped(0) {
+}
+
+FrameStatsRecorder::Counters::Counters()
+    : presented(0),
+      dropped(0) {
+}
+
+void FrameStatsRecorder::Counters::AddFrame(base::TimeDelta frame_time) {
+  ++presented;
+  if (frame_time.InMicroseconds() > kFrameBudgetUs)
+    ++dropped;
+  total_time += frame_time;
+  worst_time = std::max(worst_time, frame_time);
+}
+
+FrameStats FrameStatsRecorder::Counters::ToFrameStats() const {
+  FrameStats stats;
+  stats.frames_presented = presented;
+  stats.frames_dropped = dropped;
+  if (presented > 0)
+    stats.average_frame_time = total_time / presented;
+  stats.worst_frame_time = worst_time;
+  return stats;
+}
+
+FrameStatsRecorder::FrameStatsRecorder() {
+}
+
+FrameStatsRecorder::~FrameStatsRecorder() {
+}
+
+void FrameStatsRecorder::OnFrameStarted(base::TimeTicks start_time) {
+  if (pending_frames_.size() == kMaxPendingFrames)
+    pending_frames_.pop_front();
+  pending_frames_.push_back(start_time);
+}
+
+void FrameStatsRecorder::OnFramePresented(base::TimeTicks end_time) {
+  if (pending_frames_.empty())
+    return;
+  base::TimeDelta frame_time = end_time - pending_frames_.front();
+  pending_frames_.pop_front();
+  total_.AddFrame(frame_time);
+  period_.AddFrame(frame_time);
+}
+
+void FrameStatsRecorder::OnFramesAborted() {
+  total_.dropped += pending_frames_.size();
+  period_.dropped += pending_frames_.size();
+  pending_frames_.clear();
+}
+
+FrameStats FrameStatsRecorder::GetTotal() const {
+  return total_.ToFrameStats();
+}
+
+FrameStats FrameStatsRecorder::TakePeriod() {
+  FrameStats stats = period_.ToFrameStats();
+  period_ = Counters();
+  return stats;
+}
+
+}  // namespace atom
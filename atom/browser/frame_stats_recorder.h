@@ -0,0 +1,68 @@
+// Copyright (c) 2015 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#ifndef ATOM_BROWSER_FRAME_STATS_RECORDER_H_
+#define ATOM_BROWSER_FRAME_STATS_RECORDER_H_
+
+#include <deque>
+
+#include "base/time/time.h"
+
+namespace atom {
+
+struct FrameStats {
+  FrameStats();
+
+  // The frames that reached the screen.
+  int64 frames_presented;
+  // The frames that took longer than a refresh of the screen, or that were
+  // aborted.
+  int64 frames_dropped;
+  // From starting to composite a frame to having swapped it.
+  base::TimeDelta average_frame_time;
+  base::TimeDelta worst_frame_time;
+};
+
+// Records the frames composited for a window, the platform code reports when
+// each of them is started and presented.
+class FrameStatsRecorder {
+ public:
+  FrameStatsRecorder();
+  ~FrameStatsRecorder();
+
+  void OnFrameStarted(base::TimeTicks start_time);
+  void OnFramePresented(base::TimeTicks end_time);
+  void OnFramesAborted();
+
+  // The statistics since the window was created.
+  FrameStats GetTotal() const;
+
+  // The statistics since the last call, for reporting them periodically.
+  FrameStats TakePeriod();
+
+ private:
+  struct Counters {
+    Counters();
+
+    void AddFrame(base::TimeDelta frame_time);
+    FrameStats ToFrameStats() const;
+
+    int64 presented;
+    int64 dropped;
+    base::TimeDelta total_time;
+    base::TimeDelta worst_time;
+  };
+
+  // Frames may be pipelined, so there can be more than one started.
+  std::deque<base::TimeTicks> pending_frames_;
+
+  Counters total_;
+  Counters period_;
+
+  DISALLOW_COPY_AND_ASSIGN(FrameStatsRecorder);
+};
+
+}  // namespace atom
+
+#endif  // ATOM_BROWSER_FRAME_STATS_RECORDER_H_
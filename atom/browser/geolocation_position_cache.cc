@@ -0,0 +1,53 @@
+// Copyright (c) 2015 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#include "atom/browser/geolocation_position_cache.h"
+
+#include "base/bind.h"
+#include "content/public/browser/browser_thread.h"
+
+using content::BrowserThread;
+
+namespace atom {
+
+namespace {
+
+// How long the position is kept after the providers have been started.
+const int kPositionCacheSeconds = 30;
+
+}  // namespace
+
+GeolocationPositionCache::GeolocationPositionCache() {
+}
+
+GeolocationPositionCache::~GeolocationPositionCache() {
+}
+
+void GeolocationPositionCache::Hold() {
+  DCHECK(BrowserThread::CurrentlyOn(BrowserThread::UI));
+  // Being a client of the provider is what keeps it running, a low accuracy
+  // one does not change the options the pages have asked for.
+  if (!subscription_)
+    subscription_ =
+        content::GeolocationProvider::GetInstance()->AddLocationUpdateCallback(
+            base::Bind(&GeolocationPositionCache::OnLocationUpdate,
+                       base::Unretained(this)),
+            false);
+  timer_.Start(FROM_HERE,
+               base::TimeDelta::FromSeconds(kPositionCacheSeconds),
+               this, &GeolocationPositionCache::Release);
+}
+
+void GeolocationPositionCache::OnLocationUpdate(
+    const content::Geoposition& position) {
+  // The provider keeps the position itself and gives it to new clients.
+}
+
+void GeolocationPositionCache::Release() {
+  DCHECK(BrowserThread::CurrentlyOn(BrowserThread::UI));
+  // The providers keep running if pages are still watching the position.
+  subscription_.reset();
+}
+
+}  // namespace atom
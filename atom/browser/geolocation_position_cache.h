@@ -0,0 +1,40 @@
+// Copyright (c) 2015 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#ifndef ATOM_BROWSER_GEOLOCATION_POSITION_CACHE_H_
+#define ATOM_BROWSER_GEOLOCATION_POSITION_CACHE_H_
+
+#include "base/memory/scoped_ptr.h"
+#include "base/timer/timer.h"
+#include "content/public/browser/geolocation_provider.h"
+
+namespace atom {
+
+// Keeps the geolocation providers running for a while after they have been
+// started. The provider drops its position when its last client goes away,
+// so without this every request of a page would wait for a new lookup, while
+// with it the requests of all windows in the meantime get the last position
+// at once. Only used on UI thread.
+class GeolocationPositionCache {
+ public:
+  GeolocationPositionCache();
+  ~GeolocationPositionCache();
+
+  // Called when the providers are started, keeps them running until the
+  // cache expires.
+  void Hold();
+
+ private:
+  void OnLocationUpdate(const content::Geoposition& position);
+  void Release();
+
+  scoped_ptr<content::GeolocationProvider::Subscription> subscription_;
+  base::OneShotTimer<GeolocationPositionCache> timer_;
+
+  DISALLOW_COPY_AND_ASSIGN(GeolocationPositionCache);
+};
+
+}  // namespace atom
+
+#endif  // ATOM_BROWSER_GEOLOCATION_POSITION_CACHE_H_
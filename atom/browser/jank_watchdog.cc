@@ -0,0 +1,230 @@
+// Copyright (c) 2015 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#include "atom/browser/jank_watchdog.h"
+
+#include <algorithm>
+
+#include "base/bind.h"
+#include "base/debug/stack_trace.h"
+#include "base/strings/stringprintf.h"
+
+namespace atom {
+
+namespace {
+
+// Reports tasks longer than this by default.
+const int kDefaultThresholdMs = 200;
+
+// The shortest interval between two checks of the watchdog thread.
+const int kMinCheckIntervalMs = 10;
+
+// How many frames of JS are captured.
+const int kMaxJSFrames = 16;
+
+base::LazyInstance<JankWatchdog>::Leaky g_jank_watchdog =
+    LAZY_INSTANCE_INITIALIZER;
+
+std::string V8ToString(v8::Handle<v8::String> value) {
+  v8::String::Utf8Value utf8(value);
+  return *utf8 ? std::string(*utf8, utf8.length()) : std::string();
+}
+
+}  // namespace
+
+const size_t JankWatchdog::kMaxReports;
+
+JankWatchdog::Report::Report() {
+}
+
+JankWatchdog::Report::~Report() {
+}
+
+// static
+JankWatchdog* JankWatchdog::GetInstance() {
+  return g_jank_watchdog.Pointer();
+}
+
+JankWatchdog::JankWatchdog()
+    : isolate_(NULL),
+      thread_("JankWatchdog"),
+      started_(false),
+      threshold_(base::TimeDelta::FromMilliseconds(kDefaultThresholdMs)),
+      nesting_depth_(0),
+      ran_nested_task_(false),
+      captured_sequence_(-1),
+      task_sequence_(0),
+      check_threshold_(threshold_),
+      interrupted_sequence_(-1),
+      check_scheduled_(false) {
+}
+
+JankWatchdog::~JankWatchdog() {
+}
+
+void JankWatchdog::Start(v8::Isolate* isolate) {
+  if (started_)
+    return;
+  started_ = true;
+  isolate_ = isolate;
+  base::MessageLoop::current()->AddTaskObserver(this);
+
+  thread_.Start();
+  thread_.message_loop()->PostTask(
+      FROM_HERE,
+      base::Bind(&JankWatchdog::ScheduleCheck, base::Unretained(this)));
+}
+
+void JankWatchdog::Stop() {
+  if (!started_)
+    return;
+  started_ = false;
+  base::MessageLoop::current()->RemoveTaskObserver(this);
+  thread_.Stop();
+
+  base::AutoLock auto_lock(lock_);
+  task_start_ = base::TimeTicks();
+}
+
+void JankWatchdog::SetThreshold(base::TimeDelta threshold) {
+  threshold_ = threshold;
+  {
+    base::AutoLock auto_lock(lock_);
+    check_threshold_ = threshold;
+  }
+  if (started_)
+    thread_.message_loop()->PostTask(
+        FROM_HERE,
+        base::Bind(&JankWatchdog::ScheduleCheck, base::Unretained(this)));
+}
+
+void JankWatchdog::WillProcessTask(const base::PendingTask& pending_task) {
+  // Tasks of nested message loops, like the ones of menus and dialogs, are
+  // not counted separately, the outer task is not reported either.
+  if (++nesting_depth_ > 1) {
+    ran_nested_task_ = true;
+    return;
+  }
+
+  ran_nested_task_ = false;
+  base::AutoLock auto_lock(lock_);
+  task_start_ = base::TimeTicks::Now();
+  ++task_sequence_;
+}
+
+void JankWatchdog::DidProcessTask(const base::PendingTask& pending_task) {
+  if (--nesting_depth_ > 0)
+    return;
+
+  base::TimeTicks start;
+  int64 sequence;
+  {
+    base::AutoLock auto_lock(lock_);
+    start = task_start_;
+    sequence = task_sequence_;
+    task_start_ = base::TimeTicks();
+  }
+
+  base::TimeDelta duration = base::TimeTicks::Now() - start;
+  if (threshold_ == base::TimeDelta() || duration < threshold_ ||
+      ran_nested_task_)
+    return;
+
+  Report report;
+  report.time = base::Time::Now() - duration;
+  report.duration = duration;
+  report.posted_from = base::StringPrintf(
+      "%s@%s:%d",
+      pending_task.posted_from.function_name(),
+      pending_task.posted_from.file_name(),
+      pending_task.posted_from.line_number());
+  if (captured_sequence_ == sequence) {
+    report.js_stack.swap(captured_js_stack_);
+    report.native_stack.swap(captured_native_stack_);
+  }
+  captured_sequence_ = -1;
+
+  reports_.push_back(report);
+  if (reports_.size() > kMaxReports)
+    reports_.pop_front();
+}
+
+void JankWatchdog::ScheduleCheck() {
+  if (check_scheduled_)
+    return;
+
+  base::TimeDelta interval;
+  {
+    base::AutoLock auto_lock(lock_);
+    interval = check_threshold_ / 2;
+  }
+  if (interval == base::TimeDelta())
+    return;
+
+  check_scheduled_ = true;
+  interval = std::max(interval,
+                      base::TimeDelta::FromMilliseconds(kMinCheckIntervalMs));
+  base::MessageLoop::current()->PostDelayedTask(
+      FROM_HERE,
+      base::Bind(&JankWatchdog::Check, base::Unretained(this)),
+      interval);
+}
+
+void JankWatchdog::Check() {
+  check_scheduled_ = false;
+
+  bool interrupt = false;
+  {
+    base::AutoLock auto_lock(lock_);
+    if (!task_start_.is_null() && task_sequence_ != interrupted_sequence_ &&
+        base::TimeTicks::Now() - task_start_ >= check_threshold_) {
+      interrupted_sequence_ = task_sequence_;
+      interrupt = true;
+    }
+  }
+
+  // The stacks are captured when the main thread next runs JS.
+  if (interrupt)
+    isolate_->RequestInterrupt(&JankWatchdog::CaptureStacks, this);
+
+  ScheduleCheck();
+}
+
+// static
+void JankWatchdog::CaptureStacks(v8::Isolate* isolate, void* data) {
+  JankWatchdog* self = static_cast<JankWatchdog*>(data);
+
+  // The interrupt may arrive after the slow task, in which case the stacks
+  // would be of another task.
+  int64 sequence;
+  {
+    base::AutoLock auto_lock(self->lock_);
+    if (self->task_start_.is_null() ||
+        base::TimeTicks::Now() - self->task_start_ < self->threshold_)
+      return;
+    sequence = self->task_sequence_;
+  }
+  if (self->captured_sequence_ == sequence)
+    return;
+
+  self->captured_sequence_ = sequence;
+  self->captured_js_stack_.clear();
+  self->captured_native_stack_ = base::debug::StackTrace().ToString();
+
+  v8::HandleScope handle_scope(isolate);
+  v8::Local<v8::StackTrace> stack = v8::StackTrace::CurrentStackTrace(
+      isolate, kMaxJSFrames);
+  for (int i = 0; i < stack->GetFrameCount(); ++i) {
+    v8::Local<v8::StackFrame> frame = stack->GetFrame(i);
+    std::string function = V8ToString(frame->GetFunctionName());
+    self->captured_js_stack_.push_back(base::StringPrintf(
+        "%s (%s:%d:%d)",
+        function.empty() ? "<anonymous>" : function.c_str(),
+        V8ToString(frame->GetScriptName()).c_str(),
+        frame->GetLineNumber(),
+        frame->GetColumn()));
+  }
+}
+
+}  // namespace atom
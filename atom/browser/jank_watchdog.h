@@ -0,0 +1,108 @@
+// Copyright (c) 2015 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#ifndef ATOM_BROWSER_JANK_WATCHDOG_H_
+#define ATOM_BROWSER_JANK_WATCHDOG_H_
+
+#include <deque>
+#include <string>
+#include <vector>
+
+#include "base/lazy_instance.h"
+#include "base/message_loop/message_loop.h"
+#include "base/synchronization/lock.h"
+#include "base/threading/thread.h"
+#include "base/time/time.h"
+#include "v8/include/v8.h"
+
+namespace atom {
+
+// Watches the tasks of the main thread of browser, which include the runs of
+// node's event loop, and remembers the ones that took longer than a threshold.
+//
+// A thread checks the running task periodically, and once it has run past the
+// threshold the JS and native stacks are captured on the main thread by
+// interrupting V8, so stalls in JS show where they are. When nothing is slow
+// the cost is two locked stores in each task.
+class JankWatchdog : public base::MessageLoop::TaskObserver {
+ public:
+  // How many reports are kept, the oldest ones are dropped.
+  static const size_t kMaxReports = 32;
+
+  struct Report {
+    Report();
+    ~Report();
+
+    base::Time time;
+    base::TimeDelta duration;
+    // Where the task was posted from.
+    std::string posted_from;
+    // Empty if the main thread was not running JS when the stacks were about
+    // to be captured.
+    std::vector<std::string> js_stack;
+    std::string native_stack;
+  };
+
+  static JankWatchdog* GetInstance();
+
+  // Starts watching the current message loop, should be called on the main
+  // thread which runs |isolate|.
+  void Start(v8::Isolate* isolate);
+  void Stop();
+
+  // Tasks running longer than |threshold| are reported, zero stops checking.
+  void SetThreshold(base::TimeDelta threshold);
+  base::TimeDelta threshold() const { return threshold_; }
+
+  // Returns the recorded reports, oldest first.
+  const std::deque<Report>& reports() const { return reports_; }
+
+ private:
+  friend struct base::DefaultLazyInstanceTraits<JankWatchdog>;
+
+  JankWatchdog();
+  virtual ~JankWatchdog();
+
+  // base::MessageLoop::TaskObserver:
+  void WillProcessTask(const base::PendingTask& pending_task) override;
+  void DidProcessTask(const base::PendingTask& pending_task) override;
+
+  // Runs on the watchdog thread.
+  void ScheduleCheck();
+  void Check();
+
+  // Runs on the main thread while it runs JS.
+  static void CaptureStacks(v8::Isolate* isolate, void* data);
+
+  v8::Isolate* isolate_;
+  base::Thread thread_;
+  bool started_;
+
+  // Only accessed on the main thread.
+  base::TimeDelta threshold_;
+  int nesting_depth_;
+  bool ran_nested_task_;
+  std::deque<Report> reports_;
+  // The stacks captured for the running task.
+  int64 captured_sequence_;
+  std::vector<std::string> captured_js_stack_;
+  std::string captured_native_stack_;
+
+  // Shared with the watchdog thread.
+  base::Lock lock_;
+  // The outermost running task, |task_start_| is null when idle.
+  base::TimeTicks task_start_;
+  int64 task_sequence_;
+  base::TimeDelta check_threshold_;
+
+  // Only accessed on the watchdog thread.
+  int64 interrupted_sequence_;
+  bool check_scheduled_;
+
+  DISALLOW_COPY_AND_ASSIGN(JankWatchdog);
+};
+
+}  // namespace atom
+
+#endif  // ATOM_BROWSER_JANK_WATCHDOG_H_
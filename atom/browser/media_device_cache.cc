@@ -0,0 +1,43 @@
+// Copyright (c) 2015 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#include "atom/browser/media_device_cache.h"
+
+#include "content/public/browser/browser_thread.h"
+#include "content/public/browser/media_capture_devices.h"
+
+using content::BrowserThread;
+
+namespace atom {
+
+namespace {
+
+base::LazyInstance<MediaDeviceCache>::Leaky g_media_device_cache =
+    LAZY_INSTANCE_INITIALIZER;
+
+}  // namespace
+
+// static
+MediaDeviceCache* MediaDeviceCache::GetInstance() {
+  return g_media_device_cache.Pointer();
+}
+
+MediaDeviceCache::MediaDeviceCache() : started_(false) {
+}
+
+MediaDeviceCache::~MediaDeviceCache() {
+}
+
+void MediaDeviceCache::Start() {
+  DCHECK(BrowserThread::CurrentlyOn(BrowserThread::UI));
+  if (started_)
+    return;
+  started_ = true;
+
+  // The first read starts the monitoring of content, the lists are filled
+  // once it has enumerated the devices.
+  content::MediaCaptureDevices::GetInstance()->GetAudioCaptureDevices();
+}
+
+}  // namespace atom
@@ -0,0 +1,41 @@
+// Copyright (c) 2015 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#ifndef ATOM_BROWSER_MEDIA_DEVICE_CACHE_H_
+#define ATOM_BROWSER_MEDIA_DEVICE_CACHE_H_
+
+#include "base/lazy_instance.h"
+
+namespace atom {
+
+// Keeps the lists of capture devices cached, so the media requests of pages
+// do not wait for the devices to be enumerated from the OS.
+//
+// Starting the cache makes content monitor the capture devices, so the lists
+// of MediaCaptureDevices and MediaStreamManager stay valid between requests,
+// and are only enumerated again when the system reports that the devices
+// have changed. The requests are still answered by brightray's
+// MediaStreamDevicesController, which reads the same lists. Should be used on
+// UI thread.
+class MediaDeviceCache {
+ public:
+  static MediaDeviceCache* GetInstance();
+
+  // Starts monitoring the devices, the first enumeration runs in background.
+  void Start();
+
+ private:
+  friend struct base::DefaultLazyInstanceTraits<MediaDeviceCache>;
+
+  MediaDeviceCache();
+  ~MediaDeviceCache();
+
+  bool started_;
+
+  DISALLOW_COPY_AND_ASSIGN(MediaDeviceCache);
+};
+
+}  // namespace atom
+
+#endif  // ATOM_BROWSER_MEDIA_DEVICE_CACHE_H_
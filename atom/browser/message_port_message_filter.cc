@@ -0,0 +1,186 @@
+// Copyright (c) 2015 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#include "atom/browser/message_port_message_filter.h"
+
+#include <map>
+#include <vector>
+
+#include "atom/common/api/api_messages.h"
+#include "atom/common/ring_buffer.h"
+#include "base/lazy_instance.h"
+#include "base/memory/shared_memory.h"
+#include "base/synchronization/lock.h"
+#include "content/public/browser/browser_thread.h"
+#include "content/public/browser/render_process_host.h"
+#include "content/public/browser/render_view_host.h"
+
+using content::BrowserThread;
+
+namespace atom {
+
+namespace {
+
+struct PortEnd {
+  int render_process_id;
+  int routing_id;
+};
+
+// The ends of all ports keyed by ID, and the filters of render processes keyed
+// by process ID, both guarded by |g_lock|.
+typedef std::map<int, PortEnd> PortEndMap;
+typedef std::map<int, MessagePortMessageFilter*> FilterMap;
+base::LazyInstance<PortEndMap>::Leaky g_port_ends = LAZY_INSTANCE_INITIALIZER;
+base::LazyInstance<FilterMap>::Leaky g_filters = LAZY_INSTANCE_INITIALIZER;
+base::LazyInstance<base::Lock>::Leaky g_lock = LAZY_INSTANCE_INITIALIZER;
+
+int g_next_port_id = 0;
+
+// Should be called with |g_lock| held.
+void SendToPortEnd(int id, IPC::Message* message) {
+  PortEndMap::iterator end = g_port_ends.Get().find(id);
+  if (end != g_port_ends.Get().end()) {
+    FilterMap::iterator filter =
+        g_filters.Get().find(end->second.render_process_id);
+    if (filter != g_filters.Get().end()) {
+      filter->second->Send(message);
+      return;
+    }
+  }
+  delete message;
+}
+
+bool SharePortMemory(base::SharedMemory* memory,
+                     content::RenderViewHost* rvh,
+                     int id,
+                     const base::string16& channel,
+                     uint32 size) {
+  base::SharedMemoryHandle handle;
+  if (!memory->ShareToProcess(rvh->GetProcess()->GetHandle(), &handle))
+    return false;
+  return rvh->Send(new AtomViewMsg_OpenPort(
+      rvh->GetRoutingID(), id, channel, handle, size));
+}
+
+}  // namespace
+
+MessagePortMessageFilter::MessagePortMessageFilter(int render_process_id)
+    : BrowserMessageFilter(ShellMsgStart),
+      render_process_id_(render_process_id) {
+}
+
+MessagePortMessageFilter::~MessagePortMessageFilter() {
+}
+
+// static
+bool MessagePortMessageFilter::Connect(content::RenderViewHost* a,
+                                       content::RenderViewHost* b,
+                                       const base::string16& channel,
+                                       uint32 capacity) {
+  DCHECK(BrowserThread::CurrentlyOn(BrowserThread::UI));
+  if (!a || !b)
+    return false;
+
+  // One RingBuffer for each direction, end 0 writes into the first one.
+  uint32 ring_size = RingBuffer::RequiredMemorySize(capacity);
+  base::SharedMemory memory;
+  if (!memory.CreateAndMapAnonymous(ring_size * 2))
+    return false;
+  RingBuffer(memory.memory(), ring_size).Initialize();
+  RingBuffer(static_cast<char*>(memory.memory()) + ring_size,
+             ring_size).Initialize();
+
+  int id;
+  {
+    base::AutoLock auto_lock(g_lock.Get());
+    id = g_next_port_id;
+    g_next_port_id += 2;
+    PortEnd end_a = { a->GetProcess()->GetID(), a->GetRoutingID() };
+    PortEnd end_b = { b->GetProcess()->GetID(), b->GetRoutingID() };
+    g_port_ends.Get()[id] = end_a;
+    g_port_ends.Get()[id + 1] = end_b;
+  }
+
+  if (!SharePortMemory(&memory, a, id, channel, ring_size * 2) ||
+      !SharePortMemory(&memory, b, id + 1, channel, ring_size * 2)) {
+    base::AutoLock auto_lock(g_lock.Get());
+    SendToPortEnd(id, new AtomViewMsg_ClosePort(a->GetRoutingID(), id));
+    g_port_ends.Get().erase(id);
+    g_port_ends.Get().erase(id + 1);
+    return false;
+  }
+  return true;
+}
+
+void MessagePortMessageFilter::OnFilterAdded(IPC::Sender* sender) {
+  BrowserMessageFilter::OnFilterAdded(sender);
+  base::AutoLock auto_lock(g_lock.Get());
+  g_filters.Get()[render_process_id_] = this;
+}
+
+void MessagePortMessageFilter::OnChannelClosing() {
+  BrowserMessageFilter::OnChannelClosing();
+
+  // Close the ports this process was part of.
+  base::AutoLock auto_lock(g_lock.Get());
+  g_filters.Get().erase(render_process_id_);
+  PortEndMap& ends = g_port_ends.Get();
+  std::vector<int> closed;
+  for (const auto& end : ends)
+    if (end.second.render_process_id == render_process_id_)
+      closed.push_back(end.first);
+  for (int id : closed) {
+    int peer = id ^ 1;
+    PortEndMap::iterator peer_end = ends.find(peer);
+    if (peer_end != ends.end()) {
+      SendToPortEnd(peer, new AtomViewMsg_ClosePort(
+          peer_end->second.routing_id, peer));
+      ends.erase(peer_end);
+    }
+    ends.erase(id);
+  }
+}
+
+bool MessagePortMessageFilter::OnMessageReceived(const IPC::Message& message) {
+  bool handled = true;
+  IPC_BEGIN_MESSAGE_MAP(MessagePortMessageFilter, message)
+    IPC_MESSAGE_HANDLER(AtomViewHostMsg_PortDoorbell, OnPortDoorbell)
+    IPC_MESSAGE_HANDLER(AtomViewHostMsg_ClosePort, OnClosePort)
+    IPC_MESSAGE_UNHANDLED(handled = false)
+  IPC_END_MESSAGE_MAP()
+  return handled;
+}
+
+void MessagePortMessageFilter::OnPortDoorbell(int id) {
+  base::AutoLock auto_lock(g_lock.Get());
+  PortEndMap& ends = g_port_ends.Get();
+  PortEndMap::iterator end = ends.find(id);
+  if (end == ends.end() || end->second.render_process_id != render_process_id_)
+    return;
+
+  int peer = id ^ 1;
+  PortEndMap::iterator peer_end = ends.find(peer);
+  if (peer_end != ends.end())
+    SendToPortEnd(peer, new AtomViewMsg_PortDoorbell(
+        peer_end->second.routing_id, peer));
+}
+
+void MessagePortMessageFilter::OnClosePort(int id) {
+  base::AutoLock auto_lock(g_lock.Get());
+  PortEndMap& ends = g_port_ends.Get();
+  PortEndMap::iterator end = ends.find(id);
+  if (end == ends.end() || end->second.render_process_id != render_process_id_)
+    return;
+
+  int peer = id ^ 1;
+  PortEndMap::iterator peer_end = ends.find(peer);
+  if (peer_end != ends.end()) {
+    SendToPortEnd(peer, new AtomViewMsg_ClosePort(
+        peer_end->second.routing_id, peer));
+    ends.erase(peer_end);
+  }
+  ends.erase(id);
+}
+
+}  // namespace atom
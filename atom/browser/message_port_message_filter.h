@@ -0,0 +1,53 @@
+// Copyright (c) 2015 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#ifndef ATOM_BROWSER_MESSAGE_PORT_MESSAGE_FILTER_H_
+#define ATOM_BROWSER_MESSAGE_PORT_MESSAGE_FILTER_H_
+
+#include "base/strings/string16.h"
+#include "content/public/browser/browser_message_filter.h"
+
+namespace content {
+class RenderViewHost;
+}
+
+namespace atom {
+
+// Brokers message ports between two render views. Messages are written by the
+// renderers into a pair of RingBuffers in memory shared by both of them, and
+// the doorbells are relayed by this filter on IO thread, so the UI thread of
+// browser is never involved after the port is created.
+//
+// The two ends of a port have consecutive IDs, the peer of end |id| is always
+// |id ^ 1|.
+class MessagePortMessageFilter : public content::BrowserMessageFilter {
+ public:
+  explicit MessagePortMessageFilter(int render_process_id);
+
+  // Creates a port between |a| and |b|, each direction can hold |capacity|
+  // bytes of pending messages. Should be called on UI thread.
+  static bool Connect(content::RenderViewHost* a,
+                      content::RenderViewHost* b,
+                      const base::string16& channel,
+                      uint32 capacity);
+
+  // content::BrowserMessageFilter:
+  void OnFilterAdded(IPC::Sender* sender) override;
+  void OnChannelClosing() override;
+  bool OnMessageReceived(const IPC::Message& message) override;
+
+ private:
+  virtual ~MessagePortMessageFilter();
+
+  void OnPortDoorbell(int id);
+  void OnClosePort(int id);
+
+  int render_process_id_;
+
+  DISALLOW_COPY_AND_ASSIGN(MessagePortMessageFilter);
+};
+
+}  // namespace atom
+
+#endif  // ATOM_BROWSER_MESSAGE_PORT_MESSAGE_FILTER_H_
@@ -4,6 +4,8 @@
 
 #include "atom/browser/native_window.h"
 
+#include <algorithm>
+#include <map>
 #include <string>
 #include <utility>
 #include <vector>
@@ -11,6 +13,7 @@
 #include "atom/browser/atom_browser_context.h"
 #include "atom/browser/atom_javascript_dialog_manager.h"
 #include "atom/browser/browser.h"
+#include "atom/browser/power_policy.h"
 #include "atom/browser/ui/file_dialog.h"
 #include "atom/browser/web_dialog_helper.h"
 #include "atom/browser/window_list.h"
@@ -20,9 +23,12 @@
 #include "atom/common/native_mate_converters/image_converter.h"
 #include "atom/common/native_mate_converters/file_path_converter.h"
 #include "atom/common/options_switches.h"
+#include "atom/common/startup_timings.h"
 #include "base/command_line.h"
+#include "base/debug/trace_event.h"
 #include "base/files/file_util.h"
 #include "base/json/json_writer.h"
+#include "base/lazy_instance.h"
 #include "base/prefs/pref_service.h"
 #include "base/message_loop/message_loop.h"
 #include "base/strings/string_number_conversions.h"
@@ -35,6 +41,7 @@
 #include "content/browser/renderer_host/render_widget_host_impl.h"
 #include "content/public/browser/devtools_agent_host.h"
 #include "content/public/browser/invalidate_type.h"
+#include "content/public/browser/navigation_controller.h"
 #include "content/public/browser/navigation_entry.h"
 #include "content/public/browser/notification_details.h"
 #include "content/public/browser/notification_source.h"
@@ -45,17 +52,21 @@
 #include "content/public/browser/render_view_host.h"
 #include "content/public/browser/render_widget_host_view.h"
 #include "content/public/common/content_switches.h"
+#include "content/public/common/referrer.h"
 #include "content/public/common/renderer_preferences.h"
 #include "content/public/common/user_agent.h"
 #include "content/public/common/web_preferences.h"
 #include "ipc/ipc_message_macros.h"
 #include "native_mate/dictionary.h"
+#include "ui/base/page_transition_types.h"
 #include "ui/gfx/codec/png_codec.h"
+#include "ui/gfx/display.h"
 #include "ui/gfx/geometry/size_conversions.h"
 #include "ui/gfx/geometry/point.h"
 #include "ui/gfx/geometry/rect.h"
 #include "ui/gfx/screen.h"
 #include "ui/gfx/geometry/size.h"
+#include "url/url_constants.h"
 
 #if defined(OS_WIN)
 #include "ui/gfx/switches.h"
@@ -73,6 +84,12 @@ namespace atom {
 
 namespace {
 
+// The windows keyed by their WebContents, for the lookups that happen for
+// every render view and every IPC message.
+typedef std::map<const content::WebContents*, NativeWindow*> WebContentsMap;
+base::LazyInstance<WebContentsMap>::Leaky g_windows_by_web_contents =
+    LAZY_INSTANCE_INITIALIZER;
+
 // Array of available web runtime features.
 const char* kWebRuntimeFeatures[] = {
   switches::kExperimentalFeatures,
@@ -83,6 +100,16 @@ const char* kWebRuntimeFeatures[] = {
   switches::kSharedWorker,
 };
 
+// The interval of coalesced bounds events, which is about one frame.
+const int kBoundsEventsIntervalMs = 16;
+
+// The frame rates of offscreen windows.
+const int kDefaultOffscreenFrameRate = 30;
+const int kMaxOffscreenFrameRate = 60;
+
+// How far offscreen windows are from the displays.
+const int kOffscreenMargin = 100;
+
 std::string RemoveWhitespace(const std::string& str) {
   std::string trimmed;
   if (base::RemoveChars(str, " ", &trimmed))
@@ -91,6 +118,27 @@ std::string RemoveWhitespace(const std::string& str) {
     return str;
 }
 
+// Owns a window adopted from window.open, which has no BrowserWindow to free
+// it.
+class PopupWindowOwner : public NativeWindowObserver {
+ public:
+  explicit PopupWindowOwner(NativeWindow* window) : window_(window) {
+    window_->AddObserver(this);
+  }
+
+  // NativeWindowObserver:
+  void OnWindowClosed() override {
+    window_->RemoveObserver(this);
+    base::MessageLoop::current()->DeleteSoon(FROM_HERE, window_);
+    delete this;
+  }
+
+ private:
+  NativeWindow* window_;
+
+  DISALLOW_COPY_AND_ASSIGN(PopupWindowOwner);
+};
+
 }  // namespace
 
 NativeWindow::NativeWindow(content::WebContents* web_contents,
@@ -100,9 +148,22 @@ NativeWindow::NativeWindow(content::WebContents* web_contents,
       transparent_(false),
       enable_larger_than_screen_(false),
       is_closed_(false),
+      recyclable_(false),
+      is_recycled_(false),
       node_integration_(true),
+      lazy_node_integration_(false),
+      native_window_open_(false),
+      intercept_new_window_(false),
       has_dialog_attached_(false),
       zoom_factor_(1.0),
+      max_heap_size_(0),
+      offscreen_(false),
+      offscreen_frame_rate_(kDefaultOffscreenFrameRate),
+      background_throttling_(BACKGROUND_THROTTLING_FULL),
+      is_backgrounded_(false),
+      is_page_suspended_(false),
+      coalesce_bounds_events_(false),
+      bounds_events_pending_(false),
       weak_factory_(this),
       inspectable_web_contents_(
           brightray::InspectableWebContents::Create(web_contents)) {
@@ -112,6 +173,9 @@ NativeWindow::NativeWindow(content::WebContents* web_contents,
   options.Get(switches::kTransparent, &transparent_);
   options.Get(switches::kEnableLargerThanScreen, &enable_larger_than_screen_);
   options.Get(switches::kNodeIntegration, &node_integration_);
+  options.Get(switches::kLazyNodeIntegration, &lazy_node_integration_);
+  options.Get(switches::kNativeWindowOpen, &native_window_open_);
+  InitReopenableOptions(options);
 
   // Tell the content module to initialize renderer widget with transparent
   // mode.
@@ -133,16 +197,26 @@ NativeWindow::NativeWindow(content::WebContents* web_contents,
       old_string_token != "disable")
     node_integration_ = true;
 
+  // Read the process group, which is kept for the whole life of window.
+  options.Get(switches::kProcessGroup, &process_group_);
+
+  // Offscreen windows are placed off all displays when shown.
+  options.Get(switches::kOffscreen, &offscreen_);
+  options.Get(switches::kOffscreenFrameRate, &offscreen_frame_rate_);
+  offscreen_frame_rate_ =
+      std::max(1, std::min(offscreen_frame_rate_, kMaxOffscreenFrameRate));
+
+  // Read the heap limit, which only applies when the renderer starts.
+  options.Get(switches::kMaxHeapSize, &max_heap_size_);
+
   // Read the web preferences.
   options.Get(switches::kWebPreferences, &web_preferences_);
 
-  // Read the zoom factor before any navigation.
-  options.Get(switches::kZoomFactor, &zoom_factor_);
-
   web_contents->SetDelegate(this);
   inspectable_web_contents()->SetDelegate(this);
 
   WindowList::AddWindow(this);
+  g_windows_by_web_contents.Get()[web_contents] = this;
 
   // Override the user agent to contain application and atom-shell's version.
   Browser* browser = Browser::Get();
@@ -163,6 +237,8 @@ NativeWindow::~NativeWindow() {
   // It's possible that the windows gets destroyed before it's closed, in that
   // case we need to ensure the OnWindowClosed message is still notified.
   NotifyWindowClosed();
+  if (inspectable_web_contents_)
+    g_windows_by_web_contents.Get().erase(GetWebContents());
 }
 
 // static
@@ -173,18 +249,22 @@ NativeWindow* NativeWindow::Create(const mate::Dictionary& options) {
 
 // static
 NativeWindow* NativeWindow::FromRenderView(int process_id, int routing_id) {
-  // Stupid iterating.
-  WindowList& window_list = *WindowList::GetInstance();
-  for (auto w = window_list.begin(); w != window_list.end(); ++w) {
-    auto& window = *w;
-    content::WebContents* web_contents = window->GetWebContents();
-    int window_process_id = web_contents->GetRenderProcessHost()->GetID();
-    int window_routing_id = web_contents->GetRoutingID();
-    if (window_routing_id == routing_id && window_process_id == process_id)
-      return window;
-  }
+  // The render view hosts know their WebContents, including the pending ones
+  // of cross-process navigations.
+  content::RenderViewHost* render_view_host =
+      content::RenderViewHost::FromID(process_id, routing_id);
+  if (!render_view_host)
+    return nullptr;
+  return FromWebContents(
+      content::WebContents::FromRenderViewHost(render_view_host));
+}
 
-  return nullptr;
+// static
+NativeWindow* NativeWindow::FromWebContents(
+    const content::WebContents* web_contents) {
+  WebContentsMap& windows = g_windows_by_web_contents.Get();
+  auto it = windows.find(web_contents);
+  return it == windows.end() ? nullptr : it->second;
 }
 
 void NativeWindow::InitFromOptions(const mate::Dictionary& options) {
@@ -233,6 +313,13 @@ void NativeWindow::InitFromOptions(const mate::Dictionary& options) {
   options.Get(switches::kTitle, &title);
   SetTitle(title);
 
+  // The page of a hidden window is not composited, so an offscreen window is
+  // shown where it can not be seen.
+  if (offscreen_) {
+    ShowOffscreen();
+    return;
+  }
+
   // Then show it.
   bool show = true;
   options.Get(switches::kShow, &show);
@@ -240,6 +327,54 @@ void NativeWindow::InitFromOptions(const mate::Dictionary& options) {
     Show();
 }
 
+void NativeWindow::ShowOffscreen() {
+  gfx::Rect displays;
+  gfx::Screen* screen = gfx::Screen::GetNativeScreen();
+  for (const gfx::Display& display : screen->GetAllDisplays())
+    displays.Union(display.bounds());
+
+  SetSkipTaskbar(true);
+  Move(gfx::Rect(gfx::Point(displays.right() + kOffscreenMargin, displays.y()),
+                 GetSize()));
+  ShowInactive();
+}
+
+void NativeWindow::Reopen(const mate::Dictionary& options) {
+  DCHECK(is_recycled_);
+  is_recycled_ = false;
+  is_closed_ = false;
+  recyclable_ = false;
+  intercept_new_window_ = false;
+
+  // Forget the pages of the old owner.
+  content::NavigationController& controller = GetWebContents()->GetController();
+  if (controller.CanPruneAllButLastCommitted())
+    controller.PruneAllButLastCommitted();
+
+  zoom_factor_ = 1.0;
+  coalesce_bounds_events_ = false;
+  background_throttling_ = BACKGROUND_THROTTLING_FULL;
+  InitReopenableOptions(options);
+
+  // Undo the states that can not be set by options.
+  SetResizable(true);
+  if (IsAlwaysOnTop())
+    SetAlwaysOnTop(false);
+  SetSkipTaskbar(false);
+
+  // A new window is centered in the screen, InitFromOptions would move it if
+  // there is a position in |options|.
+  int width = 800, height = 600;
+  options.Get(switches::kWidth, &width);
+  options.Get(switches::kHeight, &height);
+  SetSize(gfx::Size(width, height));
+  Center();
+
+  registrar_.Add(this, content::NOTIFICATION_WEB_CONTENTS_TITLE_UPDATED,
+      content::Source<content::WebContents>(GetWebContents()));
+  WindowList::AddWindow(this);
+}
+
 void NativeWindow::SetRepresentedFilename(const std::string& filename) {
 }
 
@@ -257,11 +392,6 @@ bool NativeWindow::IsDocumentEdited() {
 void NativeWindow::SetMenu(ui::MenuModel* menu) {
 }
 
-void NativeWindow::Print(bool silent, bool print_background) {
-  printing::PrintViewManagerBasic::FromWebContents(GetWebContents())->
-      PrintNow(silent, print_background);
-}
-
 void NativeWindow::ShowDefinitionForSelection() {
   NOTIMPLEMENTED();
 }
@@ -319,7 +449,9 @@ bool NativeWindow::IsWebViewFocused() {
 }
 
 void NativeWindow::CapturePage(const gfx::Rect& rect,
+                               const gfx::Size& output_size,
                                const CapturePageCallback& callback) {
+  TRACE_EVENT0("atom", "NativeWindow::CapturePage");
   content::WebContents* contents = GetWebContents();
   RenderWidgetHostView* const view = contents->GetRenderWidgetHostView();
   RenderWidgetHost* const host = view ? view->GetRenderWidgetHost() : nullptr;
@@ -343,6 +475,20 @@ void NativeWindow::CapturePage(const gfx::Rect& rect,
   if (scale > 1.0f)
     bitmap_size = gfx::ToCeiledSize(gfx::ScaleSize(view_size, scale));
 
+  // Let the compositor do the scaling when only a thumbnail is wanted, which
+  // also avoids reading back the full resolution pixels.
+  if (!output_size.IsEmpty() && !view_size.IsEmpty()) {
+    float fit = std::min(
+        static_cast<float>(output_size.width()) / view_size.width(),
+        static_cast<float>(output_size.height()) / view_size.height());
+    gfx::Size scaled = gfx::ToFlooredSize(gfx::ScaleSize(view_size, fit));
+    scaled.SetToMax(gfx::Size(1, 1));
+    bitmap_size.SetToMin(scaled);
+  }
+
+  TRACE_EVENT_ASYNC_BEGIN2("atom", "NativeWindow::CapturePage::Readback",
+                           this, "width", bitmap_size.width(),
+                           "height", bitmap_size.height());
   host->CopyFromBackingStore(
       rect.IsEmpty() ? gfx::Rect(view_size) : rect,
       bitmap_size,
@@ -356,6 +502,7 @@ void NativeWindow::DestroyWebContents() {
   if (!inspectable_web_contents_)
     return;
 
+  g_windows_by_web_contents.Get().erase(GetWebContents());
   inspectable_web_contents_.reset();
 }
 
@@ -382,7 +529,11 @@ void NativeWindow::CloseWebContents() {
   if (window_unresposive_closure_.IsCancelled())
     ScheduleUnresponsiveEvent(5000);
 
-  if (web_contents->NeedToFireBeforeUnload())
+  // The page can not keep the application from quitting.
+  Browser* browser = Browser::Get();
+  bool skip_before_unload = browser->is_quiting() &&
+                            browser->suppress_dialogs_on_quit();
+  if (!skip_before_unload && web_contents->NeedToFireBeforeUnload())
     web_contents->DispatchBeforeUnload(false);
   else
     web_contents->Close();
@@ -406,15 +557,38 @@ void NativeWindow::AppendExtraCommandLineSwitches(
   command_line->AppendSwitchASCII(switches::kNodeIntegration,
                                   node_integration_ ? "true" : "false");
 
+  // Append --lazy-node-integration.
+  if (lazy_node_integration_)
+    command_line->AppendSwitch(switches::kLazyNodeIntegration);
+
+  // Append --native-window-open, so window.open is not replaced.
+  if (native_window_open_)
+    command_line->AppendSwitch(switches::kNativeWindowOpen);
+
   // Append --preload.
   if (!preload_script_.empty())
     command_line->AppendSwitchPath(switches::kPreloadScript, preload_script_);
 
+  // Append --process-group, the renderer only needs to know it is shared.
+  if (!process_group_.empty())
+    command_line->AppendSwitch(switches::kProcessGroup);
+
   // Append --zoom-factor.
   if (zoom_factor_ != 1.0)
     command_line->AppendSwitchASCII(switches::kZoomFactor,
                                     base::DoubleToString(zoom_factor_));
 
+  // Limit the old generation of V8's heap, the --js-flags passed to the
+  // browser are already copied to the renderer so the flag is merged in.
+  if (max_heap_size_ > 0) {
+    std::string js_flags = base::StringPrintf("--max-old-space-size=%d",
+                                              max_heap_size_);
+    if (command_line->HasSwitch(::switches::kJavaScriptFlags))
+      js_flags = command_line->GetSwitchValueASCII(
+          ::switches::kJavaScriptFlags) + " " + js_flags;
+    command_line->AppendSwitchASCII(::switches::kJavaScriptFlags, js_flags);
+  }
+
   if (web_preferences_.IsEmpty())
     return;
 
@@ -479,6 +653,7 @@ void NativeWindow::NotifyWindowClosed() {
   // Do not receive any notification after window has been closed, there is a
   // crash that seems to be caused by this: http://git.io/YqMG5g.
   registrar_.RemoveAll();
+  frame_stats_timer_.Stop();
 
   WindowList::RemoveWindow(this);
 }
@@ -500,10 +675,12 @@ void NativeWindow::NotifyWindowUnmaximize() {
 }
 
 void NativeWindow::NotifyWindowMinimize() {
+  UpdateBackgroundThrottling();
   FOR_EACH_OBSERVER(NativeWindowObserver, observers_, OnWindowMinimize());
 }
 
 void NativeWindow::NotifyWindowRestore() {
+  UpdateBackgroundThrottling();
   FOR_EACH_OBSERVER(NativeWindowObserver, observers_, OnWindowRestore());
 }
 
@@ -517,6 +694,70 @@ void NativeWindow::NotifyWindowLeaveFullScreen() {
                     OnWindowLeaveFullScreen());
 }
 
+void NativeWindow::SetBackgroundThrottling(BackgroundThrottling mode) {
+  background_throttling_ = mode;
+  UpdateBackgroundThrottling();
+}
+
+void NativeWindow::UpdateBackgroundThrottling() {
+  content::WebContents* web_contents = GetWebContents();
+  if (is_closed_ || !web_contents)
+    return;
+
+  // The power policy may throttle the windows that are not throttled.
+  PowerPolicy* power_policy = PowerPolicy::GetInstance();
+  bool throttled = background_throttling_ != BACKGROUND_THROTTLING_FULL ||
+                   power_policy->ShouldThrottleBackgroundWindows();
+  bool backgrounded = throttled && (!IsVisible() || IsMinimized());
+  if (backgrounded != is_backgrounded_) {
+    is_backgrounded_ = backgrounded;
+    // Blink throttles the timers of hidden pages and stops their animation
+    // frames by itself.
+    if (backgrounded)
+      web_contents->WasHidden();
+    else
+      web_contents->WasShown();
+  }
+
+  bool suspended = backgrounded &&
+                   background_throttling_ == BACKGROUND_THROTTLING_SUSPENDED;
+  if (suspended != is_page_suspended_) {
+    is_page_suspended_ = suspended;
+    Send(new AtomViewMsg_SetPageSuspended(routing_id(), suspended));
+  }
+}
+
+FrameStats NativeWindow::GetFrameStats() const {
+  return frame_stats_recorder_.GetTotal();
+}
+
+void NativeWindow::SetFrameStatsInterval(base::TimeDelta interval) {
+  frame_stats_timer_.Stop();
+  if (interval <= base::TimeDelta())
+    return;
+
+  // Only the frames of the new interval are reported.
+  frame_stats_recorder_.TakePeriod();
+  frame_stats_timer_.Start(FROM_HERE, interval, this,
+                           &NativeWindow::EmitFrameStats);
+}
+
+void NativeWindow::NotifyWindowBoundsChanged() {
+  if (!coalesce_bounds_events_) {
+    EmitBoundsEvents();
+    return;
+  }
+
+  // Only the final bounds of a frame are reported.
+  if (bounds_events_pending_)
+    return;
+  bounds_events_pending_ = true;
+  base::MessageLoop::current()->PostDelayedTask(
+      FROM_HERE,
+      base::Bind(&NativeWindow::EmitBoundsEvents, weak_factory_.GetWeakPtr()),
+      base::TimeDelta::FromMilliseconds(kBoundsEventsIntervalMs));
+}
+
 bool NativeWindow::ShouldCreateWebContents(
     content::WebContents* web_contents,
     int route_id,
@@ -526,6 +767,10 @@ bool NativeWindow::ShouldCreateWebContents(
     const GURL& target_url,
     const std::string& partition_id,
     content::SessionStorageNamespace* session_storage_namespace) {
+  // The popup is adopted by AddNewContents.
+  if (native_window_open_ && !intercept_new_window_)
+    return true;
+
   FOR_EACH_OBSERVER(NativeWindowObserver,
                     observers_,
                     WillCreatePopupWindow(frame_name,
@@ -535,6 +780,38 @@ bool NativeWindow::ShouldCreateWebContents(
   return false;
 }
 
+void NativeWindow::AddNewContents(content::WebContents* source,
+                                  content::WebContents* new_contents,
+                                  WindowOpenDisposition disposition,
+                                  const gfx::Rect& initial_pos,
+                                  bool user_gesture,
+                                  bool* was_blocked) {
+  // The popup shares the renderer process with this window, so it gets the
+  // same renderer options.
+  v8::Isolate* isolate = v8::Isolate::GetCurrent();
+  v8::Locker locker(isolate);
+  v8::HandleScope handle_scope(isolate);
+  mate::Dictionary options = mate::Dictionary::CreateEmpty(isolate);
+  options.Set(switches::kNodeIntegration, node_integration_);
+  options.Set(switches::kNativeWindowOpen, true);
+  if (!preload_script_.empty())
+    options.Set(switches::kPreloadScript, preload_script_);
+  if (!web_preferences_.IsEmpty())
+    options.Set(switches::kWebPreferences, web_preferences_.GetHandle());
+  options.Set(switches::kWidth,
+              initial_pos.width() > 0 ? initial_pos.width() : 800);
+  options.Set(switches::kHeight,
+              initial_pos.height() > 0 ? initial_pos.height() : 600);
+  if (initial_pos.x() != 0 || initial_pos.y() != 0) {
+    options.Set(switches::kX, initial_pos.x());
+    options.Set(switches::kY, initial_pos.y());
+  }
+
+  NativeWindow* window = Create(new_contents, options);
+  window->InitFromOptions(options);
+  new PopupWindowOwner(window);
+}
+
 // In atom-shell all reloads and navigations started by renderer process would
 // be redirected to this method, so we can have precise control of how we
 // would open the url (in our case, is to restart the renderer process). See
@@ -584,6 +861,16 @@ content::JavaScriptDialogManager* NativeWindow::GetJavaScriptDialogManager(
 
 void NativeWindow::RenderViewCreated(
     content::RenderViewHost* render_view_host) {
+  // The new renderer sends its draggable regions from scratch.
+  draggable_regions_.clear();
+
+  FOR_EACH_OBSERVER(NativeWindowObserver, observers_, OnRenderViewCreated());
+
+  // The new renderer starts running, suspend it again.
+  if (is_page_suspended_)
+    render_view_host->Send(new AtomViewMsg_SetPageSuspended(
+        render_view_host->GetRoutingID(), true));
+
   if (!transparent_)
     return;
 
@@ -594,6 +881,18 @@ void NativeWindow::RenderViewCreated(
     impl->SetBackgroundOpaque(false);
 }
 
+void NativeWindow::DidFirstVisuallyNonEmptyPaint() {
+  // The startup ends when the first window shows its page.
+  StartupTimings* timings = StartupTimings::GetInstance();
+  if (!timings->Record("first-window-paint"))
+    return;
+
+  base::FilePath path = base::CommandLine::ForCurrentProcess()->
+      GetSwitchValuePath(switches::kTraceStartup);
+  if (!path.empty())
+    timings->WriteTraceFile(path);
+}
+
 void NativeWindow::BeforeUnloadFired(content::WebContents* tab,
                                      bool proceed,
                                      bool* proceed_to_fire_unload) {
@@ -649,11 +948,17 @@ void NativeWindow::DeactivateContents(content::WebContents* contents) {
 
 void NativeWindow::MoveContents(content::WebContents* source,
                                 const gfx::Rect& pos) {
-  SetPosition(pos.origin());
-  SetSize(pos.size());
+  SetBounds(pos, false);
 }
 
 void NativeWindow::CloseContents(content::WebContents* source) {
+  // Keep the window and its WebContents for the next window with the same
+  // options, unless the app is quitting.
+  if (recyclable_ && !Browser::Get()->is_quiting()) {
+    Recycle();
+    return;
+  }
+
   // Destroy the WebContents before we close the window.
   DestroyWebContents();
 
@@ -668,6 +973,30 @@ void NativeWindow::CloseContents(content::WebContents* source) {
   window_unresposive_closure_.Cancel();
 }
 
+void NativeWindow::Recycle() {
+  window_unresposive_closure_.Cancel();
+  weak_factory_.InvalidateWeakPtrs();
+  bounds_events_pending_ = false;
+
+  CloseDevTools();
+  if (IsKiosk())
+    SetKiosk(false);
+  if (IsFullscreen())
+    SetFullScreen(false);
+  Hide();
+  SetBackgroundThrottling(BACKGROUND_THROTTLING_FULL);
+
+  // Unload the page, so nothing of the old owner keeps running.
+  GetWebContents()->GetController().LoadURL(
+      GURL(url::kAboutBlankURL), content::Referrer(),
+      ui::PAGE_TRANSITION_AUTO_TOPLEVEL, std::string());
+
+  // The observers see the window as closed, the owner would then give it to
+  // WindowPool.
+  is_recycled_ = true;
+  NotifyWindowClosed();
+}
+
 bool NativeWindow::IsPopupOrPanel(const content::WebContents* source) const {
   // Only popup window can use things like window.moveTo.
   return true;
@@ -698,7 +1027,7 @@ bool NativeWindow::OnMessageReceived(const IPC::Message& message) {
   bool handled = true;
   IPC_BEGIN_MESSAGE_MAP(NativeWindow, message)
     IPC_MESSAGE_HANDLER(AtomViewHostMsg_UpdateDraggableRegions,
-                        UpdateDraggableRegions)
+                        OnUpdateDraggableRegions)
     IPC_MESSAGE_UNHANDLED(handled = false)
   IPC_END_MESSAGE_MAP()
 
@@ -766,6 +1095,20 @@ void NativeWindow::DevToolsFocused() {
   FOR_EACH_OBSERVER(NativeWindowObserver, observers_, OnDevToolsFocus());
 }
 
+void NativeWindow::InitReopenableOptions(const mate::Dictionary& options) {
+  // Read the zoom factor before any navigation.
+  options.Get(switches::kZoomFactor, &zoom_factor_);
+
+  options.Get(switches::kCoalesceBoundsEvents, &coalesce_bounds_events_);
+  std::string throttling;
+  if (options.Get(switches::kBackgroundThrottling, &throttling)) {
+    if (throttling == "throttled")
+      background_throttling_ = BACKGROUND_THROTTLING_THROTTLED;
+    else if (throttling == "suspended")
+      background_throttling_ = BACKGROUND_THROTTLING_SUSPENDED;
+  }
+}
+
 void NativeWindow::ScheduleUnresponsiveEvent(int ms) {
   if (!window_unresposive_closure_.IsCancelled())
     return;
@@ -788,9 +1131,47 @@ void NativeWindow::NotifyWindowUnresponsive() {
                       OnRendererUnresponsive());
 }
 
+void NativeWindow::OnUpdateDraggableRegions(
+    uint32 kept,
+    const std::vector<DraggableRegion>& changed) {
+  kept = std::min(kept, static_cast<uint32>(draggable_regions_.size()));
+  if (kept == draggable_regions_.size() && changed.empty())
+    return;
+
+  draggable_regions_.resize(kept);
+  draggable_regions_.insert(draggable_regions_.end(),
+                            changed.begin(), changed.end());
+  UpdateDraggableRegions(draggable_regions_);
+}
+
+void NativeWindow::EmitBoundsEvents() {
+  bounds_events_pending_ = false;
+  if (is_closed_)
+    return;
+
+  gfx::Rect bounds(GetPosition(), GetSize());
+  bool moved = bounds.origin() != last_bounds_.origin();
+  bool resized = bounds.size() != last_bounds_.size();
+  last_bounds_ = bounds;
+  if (moved)
+    FOR_EACH_OBSERVER(NativeWindowObserver, observers_, OnWindowMove(bounds));
+  if (resized)
+    FOR_EACH_OBSERVER(NativeWindowObserver, observers_,
+                      OnWindowResize(bounds));
+}
+
+void NativeWindow::EmitFrameStats() {
+  if (is_closed_)
+    return;
+
+  FrameStats stats = frame_stats_recorder_.TakePeriod();
+  FOR_EACH_OBSERVER(NativeWindowObserver, observers_, OnFrameStats(stats));
+}
+
 void NativeWindow::OnCapturePageDone(const CapturePageCallback& callback,
                                      const SkBitmap& bitmap,
                                      content::ReadbackResponse response) {
+  TRACE_EVENT_ASYNC_END0("atom", "NativeWindow::CapturePage::Readback", this);
   callback.Run(bitmap);
 }
 
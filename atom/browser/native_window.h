@@ -7,14 +7,17 @@
 
 #include <map>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "atom/browser/native_window_observer.h"
 #include "atom/browser/ui/accelerator_util.h"
+#include "atom/common/draggable_region.h"
 #include "base/cancelable_callback.h"
 #include "base/memory/scoped_ptr.h"
 #include "base/memory/weak_ptr.h"
 #include "base/observer_list.h"
+#include "base/timer/timer.h"
 #include "brightray/browser/default_web_contents_delegate.h"
 #include "brightray/browser/inspectable_web_contents_delegate.h"
 #include "brightray/browser/inspectable_web_contents_impl.h"
@@ -51,7 +54,6 @@ class MenuModel;
 namespace atom {
 
 class AtomJavaScriptDialogManager;
-struct DraggableRegion;
 class WebDialogHelper;
 
 class NativeWindow : public brightray::DefaultWebContentsDelegate,
@@ -61,6 +63,17 @@ class NativeWindow : public brightray::DefaultWebContentsDelegate,
  public:
   typedef base::Callback<void(const SkBitmap& bitmap)> CapturePageCallback;
 
+  // How the page runs when the window is hidden or minimized.
+  enum BackgroundThrottling {
+    // Runs as if the window is visible.
+    BACKGROUND_THROTTLING_FULL,
+    // The page is marked as hidden, so its timers are throttled and
+    // animation frames stop.
+    BACKGROUND_THROTTLING_THROTTLED,
+    // Timers and loaders of the page are also suspended.
+    BACKGROUND_THROTTLING_SUSPENDED,
+  };
+
   class DialogScope {
    public:
     explicit DialogScope(NativeWindow* window)
@@ -94,8 +107,24 @@ class NativeWindow : public brightray::DefaultWebContentsDelegate,
   // Find a window from its process id and routing id.
   static NativeWindow* FromRenderView(int process_id, int routing_id);
 
+  // Find a window from its WebContents, the devtools are not counted.
+  static NativeWindow* FromWebContents(
+      const content::WebContents* web_contents);
+
+  // Changes the bounds of many windows together, like when tiling them, so
+  // the system only relayouts and repaints once for all of them.
+  typedef std::vector<std::pair<NativeWindow*, gfx::Rect>> BoundsList;
+  static void SetBoundsForWindows(const BoundsList& bounds_list, bool animate);
+
   void InitFromOptions(const mate::Dictionary& options);
 
+  // Makes a recycled window look like a new one created with |options|, it
+  // should be followed by InitFromOptions.
+  void Reopen(const mate::Dictionary& options);
+
+  // Shows the window outside of all displays without activating it.
+  void ShowOffscreen();
+
   virtual void Close() = 0;
   virtual void CloseImmediately() = 0;
   virtual void Move(const gfx::Rect& pos) = 0;
@@ -113,6 +142,9 @@ class NativeWindow : public brightray::DefaultWebContentsDelegate,
   virtual bool IsMinimized() = 0;
   virtual void SetFullScreen(bool fullscreen) = 0;
   virtual bool IsFullscreen() = 0;
+  // Changes the position and size in one step, with animation when the
+  // platform supports it.
+  virtual void SetBounds(const gfx::Rect& bounds, bool animate) = 0;
   virtual void SetSize(const gfx::Size& size) = 0;
   virtual gfx::Size GetSize() = 0;
   virtual void SetContentSize(const gfx::Size& size) = 0;
@@ -158,13 +190,12 @@ class NativeWindow : public brightray::DefaultWebContentsDelegate,
   virtual bool IsWebViewFocused();
 
   // Captures the page with |rect|, |callback| would be called when capturing is
-  // done.
+  // done. When |output_size| is not empty the page is scaled down to fit in it
+  // during readback, otherwise it is captured at full device resolution.
   virtual void CapturePage(const gfx::Rect& rect,
+                           const gfx::Size& output_size,
                            const CapturePageCallback& callback);
 
-  // Print current page.
-  virtual void Print(bool silent, bool print_background);
-
   // Show popup dictionary.
   virtual void ShowDefinitionForSelection();
 
@@ -205,6 +236,24 @@ class NativeWindow : public brightray::DefaultWebContentsDelegate,
   void NotifyWindowRestore();
   void NotifyWindowEnterFullScreen();
   void NotifyWindowLeaveFullScreen();
+  // Called on every native move or resize, the events may be coalesced.
+  void NotifyWindowBoundsChanged();
+
+  // Applies |mode| when the window is in background, and updates the page
+  // after the window is shown, hidden, minimized or restored.
+  void SetBackgroundThrottling(BackgroundThrottling mode);
+  BackgroundThrottling background_throttling() const {
+    return background_throttling_;
+  }
+  void UpdateBackgroundThrottling();
+
+  // The statistics of the frames drawn in the window since it was created,
+  // they are only recorded on Windows and Linux.
+  FrameStats GetFrameStats() const;
+
+  // Reports the statistics of the frames drawn in each |interval| to the
+  // observers, an empty |interval| stops reporting.
+  void SetFrameStatsInterval(base::TimeDelta interval);
 
   void AddObserver(NativeWindowObserver* obs) {
     observers_.AddObserver(obs);
@@ -216,6 +265,26 @@ class NativeWindow : public brightray::DefaultWebContentsDelegate,
 
   bool has_frame() const { return has_frame_; }
 
+  // The windows with the same non-empty process group share renderer process.
+  const std::string& process_group() const { return process_group_; }
+
+  // An offscreen window is never visible on screen, its page is delivered as
+  // frames with the "paint" event instead.
+  bool is_offscreen() const { return offscreen_; }
+  int offscreen_frame_rate() const { return offscreen_frame_rate_; }
+
+  // A recyclable window is hidden instead of destroyed when its page is
+  // closed, and is then owned by WindowPool.
+  void set_recyclable(bool recyclable) { recyclable_ = recyclable; }
+  bool is_recycled() const { return is_recycled_; }
+
+  // With the "native-window-open" option, popups of window.open are only
+  // reported to JS when it is intercepting them, otherwise they are opened in
+  // native windows directly.
+  void set_intercept_new_window(bool intercept) {
+    intercept_new_window_ = intercept;
+  }
+
   void set_has_dialog_attached(bool has_dialog_attached) {
     has_dialog_attached_ = has_dialog_attached;
   }
@@ -229,6 +298,9 @@ class NativeWindow : public brightray::DefaultWebContentsDelegate,
         inspectable_web_contents_.get());
   }
 
+  // The platform code reports the frames of window to it.
+  FrameStatsRecorder* frame_stats_recorder() { return &frame_stats_recorder_; }
+
   // Called when the window needs to update its draggable region.
   virtual void UpdateDraggableRegions(
       const std::vector<DraggableRegion>& regions) = 0;
@@ -246,6 +318,12 @@ class NativeWindow : public brightray::DefaultWebContentsDelegate,
   content::WebContents* OpenURLFromTab(
       content::WebContents* source,
       const content::OpenURLParams& params) override;
+  void AddNewContents(content::WebContents* source,
+                      content::WebContents* new_contents,
+                      WindowOpenDisposition disposition,
+                      const gfx::Rect& initial_pos,
+                      bool user_gesture,
+                      bool* was_blocked) override;
   content::JavaScriptDialogManager* GetJavaScriptDialogManager(
       content::WebContents* source) override;
   void BeforeUnloadFired(content::WebContents* tab,
@@ -276,6 +354,7 @@ class NativeWindow : public brightray::DefaultWebContentsDelegate,
 
   // Implementations of content::WebContentsObserver.
   void RenderViewCreated(content::RenderViewHost* render_view_host) override;
+  void DidFirstVisuallyNonEmptyPaint() override;
   void BeforeUnloadFired(const base::TimeTicks& proceed_time) override;
   bool OnMessageReceived(const IPC::Message& message) override;
 
@@ -317,6 +396,23 @@ class NativeWindow : public brightray::DefaultWebContentsDelegate,
                             const base::Value* arg2 = NULL,
                             const base::Value* arg3 = NULL);
 
+  // Applies the changes of draggable regions sent by the renderer.
+  void OnUpdateDraggableRegions(uint32 kept,
+                                const std::vector<DraggableRegion>& changed);
+
+  // Emits the move and resize events for the current bounds.
+  void EmitBoundsEvents();
+
+  // Reports the frames drawn since the last report.
+  void EmitFrameStats();
+
+  // Reads the options that Reopen can apply again.
+  void InitReopenableOptions(const mate::Dictionary& options);
+
+  // Resets the window and its page after the page is closed, and notifies the
+  // observers that it is closed.
+  void Recycle();
+
   // Called when CapturePage has done.
   void OnCapturePageDone(const CapturePageCallback& callback,
                          const SkBitmap& bitmap,
@@ -331,9 +427,21 @@ class NativeWindow : public brightray::DefaultWebContentsDelegate,
   // The windows has been closed.
   bool is_closed_;
 
+  // Whether the window would be recycled when closed, and has been.
+  bool recyclable_;
+  bool is_recycled_;
+
   // Whether node integration is enabled.
   bool node_integration_;
 
+  // Whether node environment is created when page first uses it.
+  bool lazy_node_integration_;
+
+  // Whether window.open is left to Chromium, and whether its popups are
+  // still sent to JS.
+  bool native_window_open_;
+  bool intercept_new_window_;
+
   // There is a dialog that has been attached to window.
   bool has_dialog_attached_;
 
@@ -347,9 +455,36 @@ class NativeWindow : public brightray::DefaultWebContentsDelegate,
   // The script to load before page's JavaScript starts to run.
   base::FilePath preload_script_;
 
+  // The group of windows sharing the renderer process.
+  std::string process_group_;
+
+  bool offscreen_;
+  int offscreen_frame_rate_;
+
   // Page's default zoom factor.
   double zoom_factor_;
 
+  // The limit of V8's old generation in MB of the renderer, 0 for default.
+  int max_heap_size_;
+
+  // The throttling applied in background, and whether it is in effect.
+  BackgroundThrottling background_throttling_;
+  bool is_backgrounded_;
+  bool is_page_suspended_;
+
+  // Whether the bounds events are emitted at most once for each frame.
+  bool coalesce_bounds_events_;
+  bool bounds_events_pending_;
+
+  // The bounds when the bounds events were last emitted.
+  gfx::Rect last_bounds_;
+
+  // The draggable regions of page, kept to apply the changes to.
+  std::vector<DraggableRegion> draggable_regions_;
+
+  FrameStatsRecorder frame_stats_recorder_;
+  base::RepeatingTimer<NativeWindow> frame_stats_timer_;
+
   base::WeakPtrFactory<NativeWindow> weak_factory_;
 
   scoped_ptr<WebDialogHelper> web_dialog_helper_;
@@ -104,6 +104,11 @@ static const CGFloat kAtomWindowCornerRadius = 4.0;
 - (void)windowDidResize:(NSNotification*)notification {
   if (!shell_->has_frame())
     shell_->ClipWebView();
+  shell_->NotifyWindowBoundsChanged();
+}
+
+- (void)windowDidMove:(NSNotification*)notification {
+  shell_->NotifyWindowBoundsChanged();
 }
 
 - (void)windowDidMiniaturize:(NSNotification*)notification {
@@ -386,15 +391,7 @@ void NativeWindowMac::CloseImmediately() {
 }
 
 void NativeWindowMac::Move(const gfx::Rect& pos) {
-  NSRect cocoa_bounds = NSMakeRect(pos.x(), 0,
-                                   pos.width(),
-                                   pos.height());
-  // Flip coordinates based on the primary screen.
-  NSScreen* screen = [[NSScreen screens] objectAtIndex:0];
-  cocoa_bounds.origin.y =
-      NSHeight([screen frame]) - pos.height() - pos.y();
-
-  [window_ setFrame:cocoa_bounds display:YES];
+  SetBounds(pos, false);
 }
 
 void NativeWindowMac::Focus(bool focus) {
@@ -473,6 +470,23 @@ bool NativeWindowMac::IsFullscreen() {
   return [window_ styleMask] & NSFullScreenWindowMask;
 }
 
+void NativeWindowMac::SetBounds(const gfx::Rect& bounds, bool animate) {
+  NSRect cocoa_bounds = NSMakeRect(bounds.x(), 0,
+                                   bounds.width(),
+                                   bounds.height());
+  // Flip coordinates based on the primary screen.
+  NSScreen* screen = [[NSScreen screens] objectAtIndex:0];
+  cocoa_bounds.origin.y =
+      NSHeight([screen frame]) - bounds.height() - bounds.y();
+
+  // The animator does not block until the animation finishes, unlike
+  // setFrame:display:animate:.
+  if (animate)
+    [[window_ animator] setFrame:cocoa_bounds display:YES];
+  else
+    [window_ setFrame:cocoa_bounds display:YES];
+}
+
 void NativeWindowMac::SetSize(const gfx::Size& size) {
   NSRect frame = [window_ frame];
   frame.origin.y -= size.height() - frame.size.height;
@@ -844,4 +858,21 @@ NativeWindow* NativeWindow::Create(content::WebContents* web_contents,
   return new NativeWindowMac(web_contents, options);
 }
 
+// static
+void NativeWindow::SetBoundsForWindows(const BoundsList& bounds_list,
+                                       bool animate) {
+  // The animations of all windows run together in one group, and without
+  // animation the screen is updated once after all windows are moved.
+  if (animate)
+    [NSAnimationContext beginGrouping];
+  else
+    NSDisableScreenUpdates();
+  for (const auto& item : bounds_list)
+    item.first->SetBounds(item.second, animate);
+  if (animate)
+    [NSAnimationContext endGrouping];
+  else
+    NSEnableScreenUpdates();
+}
+
 }  // namespace atom
@@ -7,8 +7,10 @@
 
 #include <string>
 
+#include "atom/browser/frame_stats_recorder.h"
 #include "base/strings/string16.h"
 #include "ui/base/window_open_disposition.h"
+#include "ui/gfx/geometry/rect.h"
 #include "url/gurl.h"
 
 namespace atom {
@@ -50,6 +52,10 @@ class NativeWindowObserver {
   virtual void OnWindowEnterFullScreen() {}
   virtual void OnWindowLeaveFullScreen() {}
 
+  // Called when window is moved or resized.
+  virtual void OnWindowMove(const gfx::Rect& bounds) {}
+  virtual void OnWindowResize(const gfx::Rect& bounds) {}
+
   // Called when devtools window gets focused.
   virtual void OnDevToolsFocus() {}
 
@@ -58,6 +64,14 @@ class NativeWindowObserver {
 
   // Called when renderer recovers.
   virtual void OnRendererResponsive() {}
+
+  // Called when a new render view is created for the page, which comes with a
+  // new RenderWidgetHostView.
+  virtual void OnRenderViewCreated() {}
+
+  // Called periodically with the statistics of the frames drawn since the
+  // last time, see NativeWindow::SetFrameStatsInterval.
+  virtual void OnFrameStats(const FrameStats& stats) {}
 };
 
 }  // namespace atom
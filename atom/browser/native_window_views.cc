@@ -11,6 +11,7 @@
 #include <string>
 #include <vector>
 
+#include "atom/browser/ui/draggable_region_index.h"
 #include "atom/browser/ui/views/menu_bar.h"
 #include "atom/browser/ui/views/menu_layout.h"
 #include "atom/common/draggable_region.h"
@@ -19,9 +20,11 @@
 #include "browser/inspectable_web_contents_view.h"
 #include "content/public/browser/native_web_keyboard_event.h"
 #include "native_mate/dictionary.h"
+#include "third_party/skia/include/core/SkRegion.h"
 #include "ui/aura/window.h"
 #include "ui/aura/window_tree_host.h"
 #include "ui/base/hit_test.h"
+#include "ui/compositor/compositor.h"
 #include "ui/gfx/image/image.h"
 #include "ui/views/background.h"
 #include "ui/views/controls/webview/unhandled_keyboard_event_handler.h"
@@ -147,6 +150,7 @@ NativeWindowViews::NativeWindowViews(content::WebContents* web_contents,
     : NativeWindow(web_contents, options),
       window_(new views::Widget),
       web_view_(inspectable_web_contents()->GetView()->GetView()),
+      compositor_(NULL),
       menu_bar_autohide_(false),
       menu_bar_visible_(false),
       menu_bar_alt_pressed_(false),
@@ -200,6 +204,10 @@ NativeWindowViews::NativeWindowViews(content::WebContents* web_contents,
 
   window_->Init(params);
 
+  // Record the frames drawn by the window.
+  compositor_ = GetNativeWindow()->GetHost()->compositor();
+  compositor_->AddObserver(this);
+
 #if defined(USE_X11)
   // Start monitoring window states.
   window_state_watcher_.reset(new WindowStateWatcher(this));
@@ -281,6 +289,8 @@ NativeWindowViews::NativeWindowViews(content::WebContents* web_contents,
 
 NativeWindowViews::~NativeWindowViews() {
   window_->RemoveObserver(this);
+  if (compositor_)
+    compositor_->RemoveObserver(this);
 }
 
 void NativeWindowViews::Close() {
@@ -373,6 +383,18 @@ bool NativeWindowViews::IsFullscreen() {
   return window_->IsFullscreen();
 }
 
+void NativeWindowViews::SetBounds(const gfx::Rect& bounds, bool animate) {
+#if defined(USE_X11)
+  if (!resizable_) {
+    SetMaximumSize(bounds.size());
+    SetMinimumSize(bounds.size());
+  }
+#endif
+
+  // Views windows do not animate their bounds.
+  window_->SetBounds(bounds);
+}
+
 void NativeWindowViews::SetSize(const gfx::Size& size) {
 #if defined(USE_X11)
   // On Linux the minimum and maximum size should be updated with window size
@@ -700,14 +722,14 @@ void NativeWindowViews::UpdateDraggableRegions(
   if (has_frame_)
     return;
 
-  SkRegion* draggable_region = new SkRegion;
+  SkRegion draggable_region;
 
   // By default, the whole window is non-draggable. We need to explicitly
   // include those draggable regions.
   for (std::vector<DraggableRegion>::const_iterator iter = regions.begin();
        iter != regions.end(); ++iter) {
     const DraggableRegion& region = *iter;
-    draggable_region->op(
+    draggable_region.op(
         region.bounds.x(),
         region.bounds.y(),
         region.bounds.right(),
@@ -715,7 +737,7 @@ void NativeWindowViews::UpdateDraggableRegions(
         region.draggable ? SkRegion::kUnion_Op : SkRegion::kDifference_Op);
   }
 
-  draggable_region_.reset(draggable_region);
+  draggable_region_.reset(new DraggableRegionIndex(draggable_region));
 }
 
 void NativeWindowViews::OnWidgetActivationChanged(
@@ -736,6 +758,40 @@ void NativeWindowViews::OnWidgetActivationChanged(
     SetMenuBarVisibility(false);
 }
 
+void NativeWindowViews::OnWidgetBoundsChanged(
+    views::Widget* widget, const gfx::Rect& new_bounds) {
+  if (widget == window_.get())
+    NotifyWindowBoundsChanged();
+}
+
+void NativeWindowViews::OnWidgetDestroying(views::Widget* widget) {
+  // The compositor goes away with the native widget.
+  if (widget == window_.get() && compositor_) {
+    compositor_->RemoveObserver(this);
+    compositor_ = NULL;
+  }
+}
+
+void NativeWindowViews::OnCompositingDidCommit(ui::Compositor* compositor) {
+}
+
+void NativeWindowViews::OnCompositingStarted(ui::Compositor* compositor,
+                                             base::TimeTicks start_time) {
+  frame_stats_recorder()->OnFrameStarted(start_time);
+}
+
+void NativeWindowViews::OnCompositingEnded(ui::Compositor* compositor) {
+  frame_stats_recorder()->OnFramePresented(base::TimeTicks::Now());
+}
+
+void NativeWindowViews::OnCompositingAborted(ui::Compositor* compositor) {
+  frame_stats_recorder()->OnFramesAborted();
+}
+
+void NativeWindowViews::OnCompositingLockStateChanged(
+    ui::Compositor* compositor) {
+}
+
 void NativeWindowViews::DeleteDelegate() {
   NotifyWindowClosed();
 }
@@ -789,7 +845,7 @@ bool NativeWindowViews::ShouldDescendIntoChildForEventHandling(
     const gfx::Point& location) {
   // App window should claim mouse events that fall within the draggable region.
   if (draggable_region_ &&
-      draggable_region_->contains(location.x(), location.y()))
+      draggable_region_->Contains(location.x(), location.y()))
     return false;
 
   // And the events on border for dragging resizable frameless window.
@@ -959,4 +1015,35 @@ NativeWindow* NativeWindow::Create(content::WebContents* web_contents,
   return new NativeWindowViews(web_contents, options);
 }
 
+// static
+void NativeWindow::SetBoundsForWindows(const BoundsList& bounds_list,
+                                       bool animate) {
+#if defined(OS_WIN)
+  // The windows are moved together when EndDeferWindowPos is called.
+  HDWP hdwp = ::BeginDeferWindowPos(static_cast<int>(bounds_list.size()));
+  for (const auto& item : bounds_list) {
+    NativeWindowViews* window = static_cast<NativeWindowViews*>(item.first);
+    if (!hdwp)
+      break;
+    if (window->IsMinimized() || window->IsMaximized() ||
+        window->IsFullscreen()) {
+      window->SetBounds(item.second, animate);
+      continue;
+    }
+    gfx::Rect bounds = gfx::win::DIPToScreenRect(item.second);
+    hdwp = ::DeferWindowPos(hdwp, window->GetAcceleratedWidget(), NULL,
+                            bounds.x(), bounds.y(),
+                            bounds.width(), bounds.height(),
+                            SWP_NOZORDER | SWP_NOACTIVATE);
+  }
+  if (hdwp) {
+    ::EndDeferWindowPos(hdwp);
+    return;
+  }
+#endif
+
+  for (const auto& item : bounds_list)
+    item.first->SetBounds(item.second, animate);
+}
+
 }  // namespace atom
@@ -11,6 +11,7 @@
 #include <vector>
 
 #include "atom/browser/ui/accelerator_util.h"
+#include "ui/compositor/compositor_observer.h"
 #include "ui/views/widget/widget_delegate.h"
 #include "ui/views/widget/widget_observer.h"
 
@@ -20,13 +21,15 @@ class UnhandledKeyboardEventHandler;
 
 namespace atom {
 
+class DraggableRegionIndex;
 class GlobalMenuBarX11;
 class MenuBar;
 class WindowStateWatcher;
 
 class NativeWindowViews : public NativeWindow,
                           public views::WidgetDelegateView,
-                          public views::WidgetObserver {
+                          public views::WidgetObserver,
+                          public ui::CompositorObserver {
  public:
   explicit NativeWindowViews(content::WebContents* web_contents,
                             const mate::Dictionary& options);
@@ -50,6 +53,7 @@ class NativeWindowViews : public NativeWindow,
   bool IsMinimized() override;
   void SetFullScreen(bool fullscreen) override;
   bool IsFullscreen() override;
+  void SetBounds(const gfx::Rect& bounds, bool animate) override;
   void SetSize(const gfx::Size& size) override;
   gfx::Size GetSize() override;
   void SetContentSize(const gfx::Size& size) override;
@@ -85,7 +89,9 @@ class NativeWindowViews : public NativeWindow,
 
   gfx::AcceleratedWidget GetAcceleratedWidget();
 
-  SkRegion* draggable_region() const { return draggable_region_.get(); }
+  DraggableRegionIndex* draggable_region() const {
+    return draggable_region_.get();
+  }
   views::Widget* widget() const { return window_.get(); }
 
  private:
@@ -96,6 +102,17 @@ class NativeWindowViews : public NativeWindow,
   // views::WidgetObserver:
   void OnWidgetActivationChanged(
       views::Widget* widget, bool active) override;
+  void OnWidgetBoundsChanged(
+      views::Widget* widget, const gfx::Rect& new_bounds) override;
+  void OnWidgetDestroying(views::Widget* widget) override;
+
+  // ui::CompositorObserver:
+  void OnCompositingDidCommit(ui::Compositor* compositor) override;
+  void OnCompositingStarted(ui::Compositor* compositor,
+                            base::TimeTicks start_time) override;
+  void OnCompositingEnded(ui::Compositor* compositor) override;
+  void OnCompositingAborted(ui::Compositor* compositor) override;
+  void OnCompositingLockStateChanged(ui::Compositor* compositor) override;
 
   // views::WidgetDelegate:
   void DeleteDelegate() override;
@@ -149,6 +166,9 @@ class NativeWindowViews : public NativeWindow,
   scoped_ptr<views::Widget> window_;
   views::View* web_view_;  // Managed by inspectable_web_contents_.
 
+  // The compositor of window, observed until the widget is destroyed.
+  ui::Compositor* compositor_;
+
   scoped_ptr<MenuBar> menu_bar_;
   bool menu_bar_autohide_;
   bool menu_bar_visible_;
@@ -177,7 +197,7 @@ class NativeWindowViews : public NativeWindow,
   gfx::Size minimum_size_;
   gfx::Size maximum_size_;
 
-  scoped_ptr<SkRegion> draggable_region_;
+  scoped_ptr<DraggableRegionIndex> draggable_region_;
 
   DISALLOW_COPY_AND_ASSIGN(NativeWindowViews);
 };
@@ -4,11 +4,13 @@
 
 #include "atom/browser/net/adapter_request_job.h"
 
+#include "base/debug/trace_event.h"
 #include "base/threading/sequenced_worker_pool.h"
 #include "atom/browser/net/url_request_string_job.h"
 #include "atom/browser/net/asar/url_request_asar_job.h"
 #include "atom/common/asar/asar_util.h"
 #include "atom/browser/net/url_request_buffer_job.h"
+#include "atom/browser/net/url_request_stream_job.h"
 #include "content/public/browser/browser_thread.h"
 #include "net/base/net_errors.h"
 #include "net/url_request/url_request_error_job.h"
@@ -24,12 +26,20 @@ AdapterRequestJob::AdapterRequestJob(ProtocolHandler* protocol_handler,
       weak_factory_(this) {
 }
 
+AdapterRequestJob::~AdapterRequestJob() {
+  TRACE_EVENT_ASYNC_END0("atom", "AdapterRequestJob", this);
+}
+
 void AdapterRequestJob::Start() {
   DCHECK(!real_job_.get());
+  timing_.start = base::TimeTicks::Now();
+  TRACE_EVENT_ASYNC_BEGIN1("atom", "AdapterRequestJob", this,
+                           "url", request()->url().possibly_invalid_spec());
+  TRACE_EVENT_ASYNC_STEP_INTO0("atom", "AdapterRequestJob", this, "WaitForUI");
   content::BrowserThread::PostTask(
       content::BrowserThread::UI,
       FROM_HERE,
-      base::Bind(&AdapterRequestJob::GetJobTypeInUI,
+      base::Bind(&AdapterRequestJob::RunGetJobTypeInUI,
                  weak_factory_.GetWeakPtr()));
 }
 
@@ -70,32 +80,52 @@ base::WeakPtr<AdapterRequestJob> AdapterRequestJob::GetWeakPtr() {
   return weak_factory_.GetWeakPtr();
 }
 
+void AdapterRequestJob::RunGetJobTypeInUI() {
+  timing_.handler_start = base::TimeTicks::Now();
+  TRACE_EVENT_ASYNC_STEP_INTO0("atom", "AdapterRequestJob", this, "Handler");
+  GetJobTypeInUI();
+  timing_.handler_end = base::TimeTicks::Now();
+  TRACE_EVENT_ASYNC_STEP_INTO0("atom", "AdapterRequestJob", this, "WaitForIO");
+}
+
+void AdapterRequestJob::StartRealJob() {
+  timing_.job_start = base::TimeTicks::Now();
+  TRACE_EVENT_ASYNC_STEP_INTO0("atom", "AdapterRequestJob", this, "Response");
+  real_job_->Start();
+}
+
 void AdapterRequestJob::CreateErrorJobAndStart(int error_code) {
   DCHECK(content::BrowserThread::CurrentlyOn(content::BrowserThread::IO));
 
   real_job_ = new net::URLRequestErrorJob(
       request(), network_delegate(), error_code);
-  real_job_->Start();
+  StartRealJob();
 }
 
-void AdapterRequestJob::CreateStringJobAndStart(const std::string& mime_type,
-                                                const std::string& charset,
-                                                const std::string& data) {
+void AdapterRequestJob::CreateStringJobAndStart(
+    const std::string& mime_type,
+    const std::string& charset,
+    const std::string& content_encoding,
+    const std::string& data) {
   DCHECK(content::BrowserThread::CurrentlyOn(content::BrowserThread::IO));
 
   real_job_ = new URLRequestStringJob(
-      request(), network_delegate(), mime_type, charset, data);
-  real_job_->Start();
+      request(), network_delegate(), mime_type, charset, content_encoding,
+      data);
+  StartRealJob();
 }
 
-void AdapterRequestJob::CreateBufferJobAndStart(const std::string& mime_type,
-                                                const std::string& charset,
-                                                v8::Local<v8::Object> buffer) {
+void AdapterRequestJob::CreateBufferJobAndStart(
+    const std::string& mime_type,
+    const std::string& charset,
+    const std::string& content_encoding,
+    scoped_refptr<base::RefCountedMemory> data) {
   DCHECK(content::BrowserThread::CurrentlyOn(content::BrowserThread::IO));
 
   real_job_ = new URLRequestBufferJob(
-      request(), network_delegate(), mime_type, charset, buffer);
-  real_job_->Start();
+      request(), network_delegate(), mime_type, charset, content_encoding,
+      data);
+  StartRealJob();
 }
 
 void AdapterRequestJob::CreateFileJobAndStart(const base::FilePath& path) {
@@ -107,7 +137,18 @@ void AdapterRequestJob::CreateFileJobAndStart(const base::FilePath& path) {
       content::BrowserThread::GetBlockingPool()->
           GetTaskRunnerWithShutdownBehavior(
               base::SequencedWorkerPool::SKIP_ON_SHUTDOWN));
-  real_job_->Start();
+  StartRealJob();
+}
+
+void AdapterRequestJob::CreateStreamJobAndStart(
+    const std::string& mime_type,
+    const std::string& charset,
+    scoped_refptr<RequestStreamBuffer> buffer) {
+  DCHECK(content::BrowserThread::CurrentlyOn(content::BrowserThread::IO));
+
+  real_job_ = new URLRequestStreamJob(
+      request(), network_delegate(), mime_type, charset, buffer);
+  StartRealJob();
 }
 
 void AdapterRequestJob::CreateJobFromProtocolHandlerAndStart() {
@@ -118,7 +159,7 @@ void AdapterRequestJob::CreateJobFromProtocolHandlerAndStart() {
   if (!real_job_.get())
     CreateErrorJobAndStart(net::ERR_NOT_IMPLEMENTED);
   else
-    real_job_->Start();
+    StartRealJob();
 }
 
 }  // namespace atom
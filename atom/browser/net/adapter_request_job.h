@@ -7,17 +7,32 @@
 
 #include <string>
 
+#include "base/memory/ref_counted.h"
 #include "base/memory/weak_ptr.h"
+#include "base/time/time.h"
 #include "net/url_request/url_request_job.h"
 #include "net/url_request/url_request_job_factory.h"
-#include "v8/include/v8.h"
 
 namespace base {
 class FilePath;
+class RefCountedMemory;
 }
 
 namespace atom {
 
+class RequestStreamBuffer;
+
+// The phases of an AdapterRequestJob.
+struct RequestJobTiming {
+  // Start() is called on IO thread.
+  base::TimeTicks start;
+  // The UI thread begins and finishes asking JS for the job.
+  base::TimeTicks handler_start;
+  base::TimeTicks handler_end;
+  // The real job is started on IO thread.
+  base::TimeTicks job_start;
+};
+
 // Ask JS which type of job it wants, and then delegate corresponding methods.
 class AdapterRequestJob : public net::URLRequestJob {
  public:
@@ -44,26 +59,43 @@ class AdapterRequestJob : public net::URLRequestJob {
 
   ProtocolHandler* default_protocol_handler() { return protocol_handler_; }
 
+  const RequestJobTiming& timing() const { return timing_; }
+
   // Override this function to determine which job should be started.
   virtual void GetJobTypeInUI() = 0;
 
   void CreateErrorJobAndStart(int error_code);
   void CreateStringJobAndStart(const std::string& mime_type,
                                const std::string& charset,
+                               const std::string& content_encoding,
                                const std::string& data);
   void CreateBufferJobAndStart(const std::string& mime_type,
                                const std::string& charset,
-                               v8::Local<v8::Object> buffer);
+                               const std::string& content_encoding,
+                               scoped_refptr<base::RefCountedMemory> data);
   void CreateFileJobAndStart(const base::FilePath& path);
+  void CreateStreamJobAndStart(const std::string& mime_type,
+                               const std::string& charset,
+                               scoped_refptr<RequestStreamBuffer> buffer);
   void CreateJobFromProtocolHandlerAndStart();
 
+ protected:
+  ~AdapterRequestJob() override;
+
  private:
+  // Runs GetJobTypeInUI and records how long it takes.
+  void RunGetJobTypeInUI();
+
+  void StartRealJob();
+
   // The delegated request job.
   scoped_refptr<net::URLRequestJob> real_job_;
 
   // Default protocol handler.
   ProtocolHandler* protocol_handler_;
 
+  RequestJobTiming timing_;
+
   base::WeakPtrFactory<AdapterRequestJob> weak_factory_;
 
   DISALLOW_COPY_AND_ASSIGN(AdapterRequestJob);
@@ -5,15 +5,43 @@
 #include "atom/browser/net/asar/url_request_asar_job.h"
 
 #include <string>
+#include <vector>
 
-#include "net/base/file_stream.h"
+#include "base/format_macros.h"
+#include "base/message_loop/message_loop.h"
+#include "base/strings/stringprintf.h"
+#include "base/task_runner_util.h"
 #include "net/base/io_buffer.h"
 #include "net/base/mime_util.h"
 #include "net/base/net_errors.h"
+#include "net/http/http_request_headers.h"
+#include "net/http/http_response_headers.h"
+#include "net/http/http_response_info.h"
+#include "net/http/http_util.h"
 #include "net/url_request/url_request_status.h"
 
 namespace asar {
 
+namespace {
+
+// Reads from the shared file of |archive| on the file thread.
+int ReadFromArchive(std::shared_ptr<Archive> archive,
+                    int64 offset,
+                    scoped_refptr<net::IOBuffer> buf,
+                    int size) {
+  int rv = archive->ReadAt(offset, buf->data(), size);
+  return rv < 0 ? net::ERR_FAILED : rv;
+}
+
+// Reads, verifies and decompresses the whole file on the file thread.
+bool ReadContentsFromArchive(std::shared_ptr<Archive> archive,
+                           const Archive::FileInfo& info,
+                           scoped_refptr<base::RefCountedString> contents) {
+  return archive->ReadContents(info, &contents->data());
+}
+
+}  // namespace
+
 URLRequestAsarJob::URLRequestAsarJob(
     net::URLRequest* request,
     net::NetworkDelegate* network_delegate,
@@ -25,7 +53,10 @@ URLRequestAsarJob::URLRequestAsarJob(
       archive_(archive),
       file_path_(file_path),
       file_info_(file_info),
-      stream_(new net::FileStream(file_task_runner)),
+      mapped_data_(NULL),
+      is_range_request_(false),
+      range_parse_result_(net::OK),
+      read_offset_(0),
       remaining_bytes_(0),
       file_task_runner_(file_task_runner),
       weak_ptr_factory_(this) {}
@@ -33,16 +64,44 @@ URLRequestAsarJob::URLRequestAsarJob(
 URLRequestAsarJob::~URLRequestAsarJob() {}
 
 void URLRequestAsarJob::Start() {
-  remaining_bytes_ = static_cast<int64>(file_info_.size);
-
-  int flags = base::File::FLAG_OPEN |
-              base::File::FLAG_READ |
-              base::File::FLAG_ASYNC;
-  int rv = stream_->Open(archive_->path(), flags,
-                         base::Bind(&URLRequestAsarJob::DidOpen,
-                                    weak_ptr_factory_.GetWeakPtr()));
-  if (rv != net::ERR_IO_PENDING)
-    DidOpen(rv);
+  int result = net::OK;
+  if (range_parse_result_ != net::OK ||
+      !byte_range_.ComputeBounds(file_info_.size)) {
+    result = net::ERR_REQUEST_RANGE_NOT_SATISFIABLE;
+  } else {
+    remaining_bytes_ = byte_range_.last_byte_position() -
+                       byte_range_.first_byte_position() + 1;
+    read_offset_ = file_info_.offset + byte_range_.first_byte_position();
+
+    // Serve the contents from the mapped memory when possible, otherwise the
+    // contents are read with the file shared by all jobs of the archive, so
+    // there is no need to open and seek the file for each request.
+    //
+    // Compressed files and files with integrity hash have to be read as a
+    // whole before serving any range.
+    if (!archive_->GetMappedContents(file_info_, &mapped_data_) &&
+        (file_info_.compressed_size > 0 ||
+         archive_->HasIntegrityHash(file_info_))) {
+      scoped_refptr<base::RefCountedString> contents(
+          new base::RefCountedString);
+      base::PostTaskAndReplyWithResult(
+          file_task_runner_.get(),
+          FROM_HERE,
+          base::Bind(&ReadContentsFromArchive, archive_, file_info_, contents),
+          base::Bind(&URLRequestAsarJob::DidReadContents,
+                     weak_ptr_factory_.GetWeakPtr(),
+                     contents));
+      return;
+    }
+  }
+
+  // Notify the result asynchronously, since the consumer does not expect
+  // headers to be ready before Start returns.
+  base::MessageLoop::current()->PostTask(
+      FROM_HERE,
+      base::Bind(&URLRequestAsarJob::DidStart,
+                 weak_ptr_factory_.GetWeakPtr(),
+                 result));
 }
 
 void URLRequestAsarJob::Kill() {
@@ -63,25 +122,25 @@ bool URLRequestAsarJob::ReadRawData(net::IOBuffer* dest,
     return true;
   }
 
-  int rv = stream_->Read(dest,
-                         dest_size,
-                         base::Bind(&URLRequestAsarJob::DidRead,
-                                    weak_ptr_factory_.GetWeakPtr(),
-                                    make_scoped_refptr(dest)));
-  if (rv >= 0) {
-    // Data is immediately available.
-    *bytes_read = rv;
-    remaining_bytes_ -= rv;
-    DCHECK_GE(remaining_bytes_, 0);
+  if (mapped_data_) {
+    memcpy(dest->data(),
+           mapped_data_ + (read_offset_ - file_info_.offset),
+           dest_size);
+    *bytes_read = dest_size;
+    read_offset_ += dest_size;
+    remaining_bytes_ -= dest_size;
     return true;
   }
 
-  // Otherwise, a read error occured.  We may just need to wait...
-  if (rv == net::ERR_IO_PENDING) {
-    SetStatus(net::URLRequestStatus(net::URLRequestStatus::IO_PENDING, 0));
-  } else {
-    NotifyDone(net::URLRequestStatus(net::URLRequestStatus::FAILED, rv));
-  }
+  base::PostTaskAndReplyWithResult(
+      file_task_runner_.get(),
+      FROM_HERE,
+      base::Bind(&ReadFromArchive,
+                 archive_, read_offset_, make_scoped_refptr(dest), dest_size),
+      base::Bind(&URLRequestAsarJob::DidRead,
+                 weak_ptr_factory_.GetWeakPtr(),
+                 make_scoped_refptr(dest)));
+  SetStatus(net::URLRequestStatus(net::URLRequestStatus::IO_PENDING, 0));
   return false;
 }
 
@@ -89,27 +148,57 @@ bool URLRequestAsarJob::GetMimeType(std::string* mime_type) const {
   return net::GetMimeTypeFromFile(file_path_, mime_type);
 }
 
-void URLRequestAsarJob::DidOpen(int result) {
-  if (result != net::OK) {
-    NotifyDone(net::URLRequestStatus(net::URLRequestStatus::FAILED, result));
+void URLRequestAsarJob::SetExtraRequestHeaders(
+    const net::HttpRequestHeaders& headers) {
+  std::string range_header;
+  if (!headers.GetHeader(net::HttpRequestHeaders::kRange, &range_header))
     return;
-  }
 
-  int rv = stream_->Seek(base::File::FROM_BEGIN,
-                         file_info_.offset,
-                         base::Bind(&URLRequestAsarJob::DidSeek,
-                                    weak_ptr_factory_.GetWeakPtr()));
-  if (rv != net::ERR_IO_PENDING) {
-    // stream_->Seek() failed, so pass an intentionally erroneous value
-    // into DidSeek().
-    DidSeek(-1);
+  std::vector<net::HttpByteRange> ranges;
+  if (!net::HttpUtil::ParseRangeHeader(range_header, &ranges))
+    return;
+
+  if (ranges.size() == 1) {
+    byte_range_ = ranges[0];
+    is_range_request_ = true;
+  } else {
+    // We don't support multiple range requests.
+    range_parse_result_ = net::ERR_REQUEST_RANGE_NOT_SATISFIABLE;
   }
 }
 
-void URLRequestAsarJob::DidSeek(int64 result) {
-  if (result != static_cast<int64>(file_info_.offset)) {
-    NotifyDone(net::URLRequestStatus(net::URLRequestStatus::FAILED,
-                                     net::ERR_REQUEST_RANGE_NOT_SATISFIABLE));
+void URLRequestAsarJob::GetResponseInfo(net::HttpResponseInfo* info) {
+  // Media elements need a 206 response to be able to seek.
+  if (!is_range_request_ || !byte_range_.IsValid())
+    return;
+
+  std::string raw_headers = base::StringPrintf(
+      "HTTP/1.1 206 Partial Content\n"
+      "Accept-Ranges: bytes\n"
+      "Content-Range: bytes %" PRId64 "-%" PRId64 "/%u\n"
+      "Content-Length: %" PRId64 "\n",
+      byte_range_.first_byte_position(),
+      byte_range_.last_byte_position(),
+      file_info_.size,
+      byte_range_.last_byte_position() - byte_range_.first_byte_position() + 1);
+  std::string mime_type;
+  if (GetMimeType(&mime_type))
+    raw_headers += "Content-Type: " + mime_type + "\n";
+
+  info->headers = new net::HttpResponseHeaders(
+      net::HttpUtil::AssembleRawHeaders(raw_headers.c_str(),
+                                        raw_headers.size()));
+}
+
+int URLRequestAsarJob::GetResponseCode() const {
+  if (!is_range_request_ || !byte_range_.IsValid())
+    return URLRequestJob::GetResponseCode();
+  return 206;
+}
+
+void URLRequestAsarJob::DidStart(int result) {
+  if (result != net::OK) {
+    NotifyDone(net::URLRequestStatus(net::URLRequestStatus::FAILED, result));
     return;
   }
 
@@ -117,9 +206,23 @@ void URLRequestAsarJob::DidSeek(int64 result) {
   NotifyHeadersComplete();
 }
 
+void URLRequestAsarJob::DidReadContents(
+    scoped_refptr<base::RefCountedString> contents,
+    bool success) {
+  if (!success) {
+    DidStart(net::ERR_FAILED);
+    return;
+  }
+
+  contents_ = contents;
+  mapped_data_ = contents_->front();
+  DidStart(net::OK);
+}
+
 void URLRequestAsarJob::DidRead(scoped_refptr<net::IOBuffer> buf, int result) {
   if (result > 0) {
     SetStatus(net::URLRequestStatus());  // Clear the IO_PENDING status
+    read_offset_ += result;
     remaining_bytes_ -= result;
     DCHECK_GE(remaining_bytes_, 0);
   }
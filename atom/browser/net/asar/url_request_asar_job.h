@@ -11,17 +11,15 @@
 #include "atom/common/asar/archive.h"
 #include "base/files/file_path.h"
 #include "base/memory/ref_counted.h"
+#include "base/memory/ref_counted_memory.h"
 #include "base/memory/weak_ptr.h"
+#include "net/http/http_byte_range.h"
 #include "net/url_request/url_request_job.h"
 
 namespace base {
 class TaskRunner;
 }
 
-namespace net {
-class FileStream;
-}
-
 namespace asar {
 
 // Createa a request job according to the file path.
@@ -47,17 +45,21 @@ class URLRequestAsarJob : public net::URLRequestJob {
                    int buf_size,
                    int* bytes_read) override;
   bool GetMimeType(std::string* mime_type) const override;
+  void SetExtraRequestHeaders(const net::HttpRequestHeaders& headers) override;
+  void GetResponseInfo(net::HttpResponseInfo* info) override;
+  int GetResponseCode() const override;
 
  protected:
   virtual ~URLRequestAsarJob();
 
  private:
-  // Callback after opening file on a background thread.
-  void DidOpen(int result);
+  // Callback after the requested range is validated, |result| is a net error
+  // code.
+  void DidStart(int result);
 
-  // Callback after seeking to the beginning of |byte_range_| in the file
-  // on a background thread.
-  void DidSeek(int64 result);
+  // Callback after the whole file is read into |contents| on the file thread.
+  void DidReadContents(scoped_refptr<base::RefCountedString> contents,
+                       bool success);
 
   // Callback after data is asynchronously read from the file into |buf|.
   void DidRead(scoped_refptr<net::IOBuffer> buf, int result);
@@ -66,7 +68,20 @@ class URLRequestAsarJob : public net::URLRequestJob {
   base::FilePath file_path_;
   Archive::FileInfo file_info_;
 
-  scoped_ptr<net::FileStream> stream_;
+  // The contents of file when they are in memory, which happens when the
+  // archive is mapped or the file has to be read as a whole.
+  const uint8* mapped_data_;
+  scoped_refptr<base::RefCountedString> contents_;
+
+  // The requested range, the whole file is served when there is no Range
+  // header.
+  net::HttpByteRange byte_range_;
+  bool is_range_request_;
+  int range_parse_result_;
+
+  // Where the next read begins in the archive.
+  int64 read_offset_;
+
   int64 remaining_bytes_;
 
   const scoped_refptr<base::TaskRunner> file_task_runner_;
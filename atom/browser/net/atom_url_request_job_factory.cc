@@ -13,7 +13,9 @@ namespace atom {
 
 typedef net::URLRequestJobFactory::ProtocolHandler ProtocolHandler;
 
-AtomURLRequestJobFactory::AtomURLRequestJobFactory() {}
+AtomURLRequestJobFactory::AtomURLRequestJobFactory()
+    : schemes_(new SchemeSet) {
+}
 
 AtomURLRequestJobFactory::~AtomURLRequestJobFactory() {
   STLDeleteValues(&protocol_handler_map_);
@@ -24,8 +26,6 @@ bool AtomURLRequestJobFactory::SetProtocolHandler(
     ProtocolHandler* protocol_handler) {
   DCHECK(CalledOnValidThread());
 
-  base::AutoLock locked(lock_);
-
   if (!protocol_handler) {
     ProtocolHandlerMap::iterator it = protocol_handler_map_.find(scheme);
     if (it == protocol_handler_map_.end())
@@ -33,12 +33,14 @@ bool AtomURLRequestJobFactory::SetProtocolHandler(
 
     delete it->second;
     protocol_handler_map_.erase(it);
+    UpdateSchemes();
     return true;
   }
 
   if (ContainsKey(protocol_handler_map_, scheme))
     return false;
   protocol_handler_map_[scheme] = protocol_handler;
+  UpdateSchemes();
   return true;
 }
 
@@ -48,7 +50,6 @@ ProtocolHandler* AtomURLRequestJobFactory::ReplaceProtocol(
   DCHECK(CalledOnValidThread());
   DCHECK(protocol_handler);
 
-  base::AutoLock locked(lock_);
   if (!ContainsKey(protocol_handler_map_, scheme))
     return nullptr;
   ProtocolHandler* original_protocol_handler = protocol_handler_map_[scheme];
@@ -60,7 +61,6 @@ ProtocolHandler* AtomURLRequestJobFactory::GetProtocolHandler(
     const std::string& scheme) const {
   DCHECK(CalledOnValidThread());
 
-  base::AutoLock locked(lock_);
   ProtocolHandlerMap::const_iterator it = protocol_handler_map_.find(scheme);
   if (it == protocol_handler_map_.end())
     return nullptr;
@@ -69,8 +69,12 @@ ProtocolHandler* AtomURLRequestJobFactory::GetProtocolHandler(
 
 bool AtomURLRequestJobFactory::HasProtocolHandler(
     const std::string& scheme) const {
-  base::AutoLock locked(lock_);
-  return ContainsKey(protocol_handler_map_, scheme);
+  scoped_refptr<const SchemeSet> schemes;
+  {
+    base::AutoLock locked(schemes_lock_);
+    schemes = schemes_;
+  }
+  return ContainsKey(schemes->data, scheme);
 }
 
 net::URLRequestJob* AtomURLRequestJobFactory::MaybeCreateJobWithProtocolHandler(
@@ -79,7 +83,6 @@ net::URLRequestJob* AtomURLRequestJobFactory::MaybeCreateJobWithProtocolHandler(
     net::NetworkDelegate* network_delegate) const {
   DCHECK(CalledOnValidThread());
 
-  base::AutoLock locked(lock_);
   ProtocolHandlerMap::const_iterator it = protocol_handler_map_.find(scheme);
   if (it == protocol_handler_map_.end())
     return nullptr;
@@ -102,7 +105,7 @@ net::URLRequestJob* AtomURLRequestJobFactory::MaybeInterceptResponse(
 bool AtomURLRequestJobFactory::IsHandledProtocol(
     const std::string& scheme) const {
   DCHECK(CalledOnValidThread());
-  return HasProtocolHandler(scheme) ||
+  return ContainsKey(protocol_handler_map_, scheme) ||
       net::URLRequest::IsHandledProtocol(scheme);
 }
 
@@ -119,4 +122,13 @@ bool AtomURLRequestJobFactory::IsSafeRedirectTarget(
   return IsHandledURL(location);
 }
 
+void AtomURLRequestJobFactory::UpdateSchemes() {
+  scoped_refptr<SchemeSet> schemes(new SchemeSet);
+  for (const auto& handler : protocol_handler_map_)
+    schemes->data.insert(handler.first);
+
+  base::AutoLock locked(schemes_lock_);
+  schemes_ = schemes;
+}
+
 }  // namespace atom
@@ -7,16 +7,22 @@
 #define ATOM_BROWSER_NET_ATOM_URL_REQUEST_JOB_FACTORY_H_
 
 #include <map>
+#include <set>
 #include <string>
 #include <vector>
 
 #include "base/basictypes.h"
 #include "base/compiler_specific.h"
+#include "base/memory/ref_counted.h"
 #include "base/synchronization/lock.h"
 #include "net/url_request/url_request_job_factory.h"
 
 namespace atom {
 
+// The protocol handlers are only changed and used on IO thread, so looking up
+// the handler of a request needs no lock. Other threads can only ask whether a
+// scheme has a handler, which reads an immutable snapshot of the schemes that
+// is replaced on every change.
 class AtomURLRequestJobFactory : public net::URLRequestJobFactory {
  public:
   AtomURLRequestJobFactory();
@@ -36,7 +42,8 @@ class AtomURLRequestJobFactory : public net::URLRequestJobFactory {
   // Returns the protocol handler registered with scheme.
   ProtocolHandler* GetProtocolHandler(const std::string& scheme) const;
 
-  // Whether the protocol handler is registered by the job factory.
+  // Whether the protocol handler is registered by the job factory, can be
+  // called on any thread.
   bool HasProtocolHandler(const std::string& scheme) const;
 
   // URLRequestJobFactory implementation
@@ -57,10 +64,17 @@ class AtomURLRequestJobFactory : public net::URLRequestJobFactory {
 
  private:
   typedef std::map<std::string, ProtocolHandler*> ProtocolHandlerMap;
+  typedef base::RefCountedData<std::set<std::string>> SchemeSet;
 
+  // Publishes the schemes of |protocol_handler_map_| to other threads.
+  void UpdateSchemes();
+
+  // Only accessed on IO thread.
   ProtocolHandlerMap protocol_handler_map_;
 
-  mutable base::Lock lock_;
+  // Never modified once published, guarded by |schemes_lock_|.
+  scoped_refptr<const SchemeSet> schemes_;
+  mutable base::Lock schemes_lock_;
 
   DISALLOW_COPY_AND_ASSIGN(AtomURLRequestJobFactory);
 };
@@ -0,0 +1,72 @@
+// Copyright (c) 2015 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#include "atom/browser/net/file_mapping_protocol_handler.h"
+
+#include "atom/browser/net/asar/url_request_asar_job.h"
+#include "base/strings/string_util.h"
+#include "net/base/escape.h"
+#include "net/base/net_errors.h"
+#include "net/url_request/url_request.h"
+#include "net/url_request/url_request_error_job.h"
+
+namespace atom {
+
+FileMappingProtocolHandler::FileMappingProtocolHandler(
+    const Mappings& mappings,
+    const scoped_refptr<base::TaskRunner>& file_task_runner)
+    : mappings_(mappings),
+      file_task_runner_(file_task_runner) {
+}
+
+FileMappingProtocolHandler::~FileMappingProtocolHandler() {
+}
+
+bool FileMappingProtocolHandler::GetFilePath(const GURL& url,
+                                             base::FilePath* path) const {
+  // The URL without "scheme://", query and ref.
+  std::string content = url.GetContent();
+  if (StartsWithASCII(content, "//", true))
+    content = content.substr(2);
+  size_t end = content.find_first_of("?#");
+  if (end != std::string::npos)
+    content = content.substr(0, end);
+
+  // Keys are sorted, so the first match from the end is the longest one.
+  for (Mappings::const_reverse_iterator it = mappings_.rbegin();
+       it != mappings_.rend(); ++it) {
+    if (!StartsWithASCII(content, it->first, true))
+      continue;
+
+    std::string relative = net::UnescapeURLComponent(
+        content.substr(it->first.size()),
+        net::UnescapeRule::SPACES | net::UnescapeRule::URL_SPECIAL_CHARS);
+    TrimString(relative, "/", &relative);
+    base::FilePath relative_path = base::FilePath::FromUTF8Unsafe(relative);
+    if (relative_path.ReferencesParent() || relative_path.IsAbsolute())
+      return false;
+
+    *path = relative.empty() ? it->second : it->second.Append(relative_path);
+    return true;
+  }
+  return false;
+}
+
+net::URLRequestJob* FileMappingProtocolHandler::MaybeCreateJob(
+    net::URLRequest* request,
+    net::NetworkDelegate* network_delegate) const {
+  base::FilePath path;
+  if (!GetFilePath(request->url(), &path))
+    return new net::URLRequestErrorJob(request, network_delegate,
+                                       net::ERR_FILE_NOT_FOUND);
+  return asar::CreateJobFromPath(path, request, network_delegate,
+                                 file_task_runner_);
+}
+
+bool FileMappingProtocolHandler::IsSafeRedirectTarget(
+    const GURL& location) const {
+  return false;
+}
+
+}  // namespace atom
@@ -0,0 +1,53 @@
+// Copyright (c) 2015 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#ifndef ATOM_BROWSER_NET_FILE_MAPPING_PROTOCOL_HANDLER_H_
+#define ATOM_BROWSER_NET_FILE_MAPPING_PROTOCOL_HANDLER_H_
+
+#include <map>
+#include <string>
+
+#include "base/files/file_path.h"
+#include "base/memory/ref_counted.h"
+#include "net/url_request/url_request_job_factory.h"
+
+namespace base {
+class TaskRunner;
+}
+
+namespace atom {
+
+// Maps the URLs of a scheme to files by their prefixes, the requests are
+// resolved on IO thread without asking JS.
+class FileMappingProtocolHandler
+    : public net::URLRequestJobFactory::ProtocolHandler {
+ public:
+  // Maps the part of URL after "scheme://" to directories, the longest
+  // matching prefix wins.
+  typedef std::map<std::string, base::FilePath> Mappings;
+
+  FileMappingProtocolHandler(
+      const Mappings& mappings,
+      const scoped_refptr<base::TaskRunner>& file_task_runner);
+  virtual ~FileMappingProtocolHandler();
+
+  // Returns the file |url| is mapped to.
+  bool GetFilePath(const GURL& url, base::FilePath* path) const;
+
+  // net::URLRequestJobFactory::ProtocolHandler:
+  net::URLRequestJob* MaybeCreateJob(
+      net::URLRequest* request,
+      net::NetworkDelegate* network_delegate) const override;
+  bool IsSafeRedirectTarget(const GURL& location) const override;
+
+ private:
+  const Mappings mappings_;
+  const scoped_refptr<base::TaskRunner> file_task_runner_;
+
+  DISALLOW_COPY_AND_ASSIGN(FileMappingProtocolHandler);
+};
+
+}  // namespace atom
+
+#endif  // ATOM_BROWSER_NET_FILE_MAPPING_PROTOCOL_HANDLER_H_
@@ -0,0 +1,170 @@
+// Copyright (c) 2015 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#include "atom/browser/net/network_observer.h"
+
+#include "base/bind.h"
+#include "content/public/browser/browser_thread.h"
+#include "content/public/browser/resource_request_info.h"
+#include "net/base/load_timing_info.h"
+#include "net/http/http_response_headers.h"
+#include "net/url_request/url_request.h"
+
+using content::BrowserThread;
+
+namespace atom {
+
+namespace {
+
+// A batch is delivered right away when it grows this large.
+const size_t kMaxBatchSize = 500;
+
+double Duration(base::TimeTicks start, base::TimeTicks end) {
+  if (start.is_null() || end.is_null())
+    return -1;
+  return (end - start).InMillisecondsF();
+}
+
+const char* ResourceTypeToString(content::ResourceType type) {
+  switch (type) {
+    case content::RESOURCE_TYPE_MAIN_FRAME: return "mainFrame";
+    case content::RESOURCE_TYPE_SUB_FRAME: return "subFrame";
+    case content::RESOURCE_TYPE_STYLESHEET: return "stylesheet";
+    case content::RESOURCE_TYPE_SCRIPT: return "script";
+    case content::RESOURCE_TYPE_IMAGE: return "image";
+    case content::RESOURCE_TYPE_FONT_RESOURCE: return "font";
+    case content::RESOURCE_TYPE_MEDIA: return "media";
+    case content::RESOURCE_TYPE_XHR: return "xhr";
+    default: return "other";
+  }
+}
+
+}  // namespace
+
+NetworkObserver::RequestMetrics::RequestMetrics()
+    : process_id(-1),
+      frame_routing_id(-1),
+      status_code(0),
+      error(0),
+      was_cached(false),
+      socket_reused(false),
+      dns_time(-1),
+      connect_time(-1),
+      ssl_time(-1),
+      time_to_first_byte(-1),
+      total_time(-1),
+      received_bytes(0) {
+}
+
+NetworkObserver::RequestMetrics::~RequestMetrics() {
+}
+
+// static
+NetworkObserver* NetworkObserver::GetInstance() {
+  return Singleton<NetworkObserver,
+                   LeakySingletonTraits<NetworkObserver>>::get();
+}
+
+NetworkObserver::NetworkObserver()
+    : enabled_(false),
+      flush_scheduled_(false) {
+}
+
+NetworkObserver::~NetworkObserver() {
+}
+
+void NetworkObserver::Start(const MetricsCallback& callback,
+                            base::TimeDelta interval) {
+  DCHECK(BrowserThread::CurrentlyOn(BrowserThread::UI));
+  callback_ = callback;
+  BrowserThread::PostTask(
+      BrowserThread::IO, FROM_HERE,
+      base::Bind(&NetworkObserver::SetEnabledOnIO, base::Unretained(this),
+                 true, interval));
+}
+
+void NetworkObserver::Stop() {
+  DCHECK(BrowserThread::CurrentlyOn(BrowserThread::UI));
+  callback_.Reset();
+  BrowserThread::PostTask(
+      BrowserThread::IO, FROM_HERE,
+      base::Bind(&NetworkObserver::SetEnabledOnIO, base::Unretained(this),
+                 false, base::TimeDelta()));
+}
+
+void NetworkObserver::OnRequestComplete(net::URLRequest* request) {
+  DCHECK(BrowserThread::CurrentlyOn(BrowserThread::IO));
+  if (!enabled_)
+    return;
+
+  RequestMetrics metrics;
+  metrics.url = request->url().spec();
+  metrics.method = request->method();
+  metrics.error = request->status().error();
+  metrics.was_cached = request->was_cached();
+  metrics.received_bytes = request->GetTotalReceivedBytes();
+  if (request->response_headers())
+    metrics.status_code = request->response_headers()->response_code();
+
+  const content::ResourceRequestInfo* info =
+      content::ResourceRequestInfo::ForRequest(request);
+  if (info) {
+    info->GetAssociatedRenderFrame(&metrics.process_id,
+                                   &metrics.frame_routing_id);
+    metrics.resource_type = ResourceTypeToString(info->GetResourceType());
+  }
+
+  net::LoadTimingInfo timing;
+  request->GetLoadTimingInfo(&timing);
+  const net::LoadTimingInfo::ConnectTiming& connect = timing.connect_timing;
+  metrics.socket_reused = timing.socket_reused;
+  metrics.start_time = timing.request_start_time;
+  metrics.dns_time = Duration(connect.dns_start, connect.dns_end);
+  metrics.connect_time = Duration(connect.connect_start, connect.connect_end);
+  metrics.ssl_time = Duration(connect.ssl_start, connect.ssl_end);
+  metrics.time_to_first_byte = Duration(timing.request_start,
+                                        timing.receive_headers_end);
+  metrics.total_time = Duration(timing.request_start, base::TimeTicks::Now());
+  pending_.push_back(metrics);
+
+  if (pending_.size() >= kMaxBatchSize) {
+    FlushOnIO();
+  } else if (!flush_scheduled_) {
+    flush_scheduled_ = true;
+    BrowserThread::PostDelayedTask(
+        BrowserThread::IO, FROM_HERE,
+        base::Bind(&NetworkObserver::FlushOnIO, base::Unretained(this)),
+        interval_);
+  }
+}
+
+void NetworkObserver::SetEnabledOnIO(bool enabled, base::TimeDelta interval) {
+  DCHECK(BrowserThread::CurrentlyOn(BrowserThread::IO));
+  enabled_ = enabled;
+  interval_ = interval;
+  if (!enabled)
+    pending_.clear();
+}
+
+void NetworkObserver::FlushOnIO() {
+  DCHECK(BrowserThread::CurrentlyOn(BrowserThread::IO));
+  flush_scheduled_ = false;
+  if (pending_.empty())
+    return;
+
+  std::vector<RequestMetrics> batch;
+  batch.swap(pending_);
+  BrowserThread::PostTask(
+      BrowserThread::UI, FROM_HERE,
+      base::Bind(&NetworkObserver::DeliverOnUI, base::Unretained(this),
+                 batch));
+}
+
+void NetworkObserver::DeliverOnUI(const std::vector<RequestMetrics>& batch) {
+  DCHECK(BrowserThread::CurrentlyOn(BrowserThread::UI));
+  if (!callback_.is_null())
+    callback_.Run(batch);
+}
+
+}  // namespace atom
@@ -0,0 +1,92 @@
+// Copyright (c) 2015 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#ifndef ATOM_BROWSER_NET_NETWORK_OBSERVER_H_
+#define ATOM_BROWSER_NET_NETWORK_OBSERVER_H_
+
+#include <string>
+#include <vector>
+
+#include "base/callback.h"
+#include "base/memory/singleton.h"
+#include "base/time/time.h"
+
+namespace net {
+class URLRequest;
+}
+
+namespace atom {
+
+// Records the timing of the finished requests of all render processes on IO
+// thread, and delivers them to UI thread in batches, so observing the network
+// costs no thread hop for each request.
+class NetworkObserver {
+ public:
+  // The durations are in milliseconds, -1 when the phase did not happen, like
+  // the DNS lookup of a reused connection.
+  struct RequestMetrics {
+    RequestMetrics();
+    ~RequestMetrics();
+
+    std::string url;
+    std::string method;
+    std::string resource_type;
+    int process_id;
+    int frame_routing_id;
+    int status_code;
+    // The net error code, 0 for success.
+    int error;
+    bool was_cached;
+    bool socket_reused;
+
+    base::Time start_time;
+    double dns_time;
+    double connect_time;
+    double ssl_time;
+    // From the start of the request to the arrival of the response headers.
+    double time_to_first_byte;
+    double total_time;
+    int64 received_bytes;
+  };
+
+  typedef base::Callback<void(const std::vector<RequestMetrics>&)>
+      MetricsCallback;
+
+  static NetworkObserver* GetInstance();
+
+  // Starts delivering the metrics to |callback| every |interval| on UI thread,
+  // replacing the previous callback.
+  void Start(const MetricsCallback& callback, base::TimeDelta interval);
+  void Stop();
+
+  // Called by the ResourceDispatcherHostDelegate on IO thread.
+  void OnRequestComplete(net::URLRequest* request);
+
+ private:
+  friend struct DefaultSingletonTraits<NetworkObserver>;
+
+  NetworkObserver();
+  ~NetworkObserver();
+
+  // Run on IO thread.
+  void SetEnabledOnIO(bool enabled, base::TimeDelta interval);
+  void FlushOnIO();
+
+  void DeliverOnUI(const std::vector<RequestMetrics>& batch);
+
+  // Only accessed on UI thread.
+  MetricsCallback callback_;
+
+  // Only accessed on IO thread.
+  bool enabled_;
+  base::TimeDelta interval_;
+  bool flush_scheduled_;
+  std::vector<RequestMetrics> pending_;
+
+  DISALLOW_COPY_AND_ASSIGN(NetworkObserver);
+};
+
+}  // namespace atom
+
+#endif  // ATOM_BROWSER_NET_NETWORK_OBSERVER_H_
@@ -0,0 +1,79 @@
+// Copyright (c) 2015 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#include "atom/browser/net/offline_store_protocol_handler.h"
+
+#include "atom/browser/net/asar/url_request_asar_job.h"
+#include "atom/common/asar/archive.h"
+#include "atom/common/asar/asar_util.h"
+#include "base/sha1.h"
+#include "base/strings/string_number_conversions.h"
+#include "base/strings/string_util.h"
+#include "net/url_request/url_request.h"
+
+namespace atom {
+
+OfflineStoreProtocolHandler::OfflineStoreProtocolHandler(
+    const base::FilePath& archive_path,
+    ProtocolHandler* original_handler,
+    const scoped_refptr<base::TaskRunner>& file_task_runner)
+    : archive_path_(archive_path),
+      original_handler_(original_handler),
+      file_task_runner_(file_task_runner) {
+}
+
+OfflineStoreProtocolHandler::~OfflineStoreProtocolHandler() {
+}
+
+// static
+std::string OfflineStoreProtocolHandler::GetEntryName(const GURL& url) {
+  GURL::Replacements replacements;
+  replacements.ClearRef();
+  std::string spec = url.ReplaceComponents(replacements).spec();
+  std::string hash = base::SHA1HashString(spec);
+  std::string name = base::StringToLowerASCII(
+      base::HexEncode(hash.data(), hash.size()));
+
+  std::string extension = base::FilePath::FromUTF8Unsafe(url.path())
+      .BaseName().Extension();
+  // Only keep sane extensions, they are only used to decide mime types.
+  if (extension.size() <= 16 && base::IsStringASCII(extension))
+    name += extension;
+  return name;
+}
+
+net::URLRequestJobFactory::ProtocolHandler*
+OfflineStoreProtocolHandler::ReleaseOriginalHandler() {
+  return original_handler_.release();
+}
+
+net::URLRequestJob* OfflineStoreProtocolHandler::MaybeCreateJob(
+    net::URLRequest* request,
+    net::NetworkDelegate* network_delegate) const {
+  if (request->method() == "GET") {
+    if (!archive_)
+      archive_ = asar::GetOrCreateAsarArchive(archive_path_);
+
+    std::string name = GetEntryName(request->url());
+    asar::Archive::FileInfo info;
+    if (archive_ &&
+        archive_->GetFileInfo(base::FilePath::FromUTF8Unsafe(name), &info))
+      return asar::CreateJobFromPath(archive_path_.AppendASCII(name),
+                                     request, network_delegate,
+                                     file_task_runner_);
+  }
+
+  if (original_handler_)
+    return original_handler_->MaybeCreateJob(request, network_delegate);
+  return nullptr;
+}
+
+bool OfflineStoreProtocolHandler::IsSafeRedirectTarget(
+    const GURL& location) const {
+  if (original_handler_)
+    return original_handler_->IsSafeRedirectTarget(location);
+  return true;
+}
+
+}  // namespace atom
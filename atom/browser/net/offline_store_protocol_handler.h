@@ -0,0 +1,67 @@
+// Copyright (c) 2015 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#ifndef ATOM_BROWSER_NET_OFFLINE_STORE_PROTOCOL_HANDLER_H_
+#define ATOM_BROWSER_NET_OFFLINE_STORE_PROTOCOL_HANDLER_H_
+
+#include <memory>
+#include <string>
+
+#include "base/files/file_path.h"
+#include "base/memory/ref_counted.h"
+#include "base/memory/scoped_ptr.h"
+#include "net/url_request/url_request_job_factory.h"
+
+namespace asar {
+class Archive;
+}
+
+namespace base {
+class TaskRunner;
+}
+
+namespace atom {
+
+// Serves the GET requests of a scheme from an asar archive when it has a copy
+// of the URL, otherwise the request goes to the original handler, or to the
+// network stack when there is none.
+//
+// The archive is keyed by URL: the copy of a URL is stored at the root as the
+// lowercase hex SHA-1 of the URL without ref, followed by the extension of the
+// URL's path, which decides the mime type.
+class OfflineStoreProtocolHandler
+    : public net::URLRequestJobFactory::ProtocolHandler {
+ public:
+  // Takes the ownership of |original_handler|, which can be NULL.
+  OfflineStoreProtocolHandler(
+      const base::FilePath& archive_path,
+      ProtocolHandler* original_handler,
+      const scoped_refptr<base::TaskRunner>& file_task_runner);
+  virtual ~OfflineStoreProtocolHandler();
+
+  // Returns the name of the entry storing |url|.
+  static std::string GetEntryName(const GURL& url);
+
+  ProtocolHandler* ReleaseOriginalHandler();
+
+  // net::URLRequestJobFactory::ProtocolHandler:
+  net::URLRequestJob* MaybeCreateJob(
+      net::URLRequest* request,
+      net::NetworkDelegate* network_delegate) const override;
+  bool IsSafeRedirectTarget(const GURL& location) const override;
+
+ private:
+  const base::FilePath archive_path_;
+  scoped_ptr<ProtocolHandler> original_handler_;
+  const scoped_refptr<base::TaskRunner> file_task_runner_;
+
+  // Opened on the first request.
+  mutable std::shared_ptr<asar::Archive> archive_;
+
+  DISALLOW_COPY_AND_ASSIGN(OfflineStoreProtocolHandler);
+};
+
+}  // namespace atom
+
+#endif  // ATOM_BROWSER_NET_OFFLINE_STORE_PROTOCOL_HANDLER_H_
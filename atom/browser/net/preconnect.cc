@@ -0,0 +1,92 @@
+// Copyright (c) 2015 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#include "atom/browser/net/preconnect.h"
+
+#include "base/bind.h"
+#include "base/bind_helpers.h"
+#include "content/public/browser/browser_thread.h"
+#include "net/base/address_list.h"
+#include "net/base/load_flags.h"
+#include "net/dns/host_resolver.h"
+#include "net/http/http_network_session.h"
+#include "net/http/http_request_info.h"
+#include "net/http/http_stream_factory.h"
+#include "net/http/http_transaction_factory.h"
+#include "net/ssl/ssl_config_service.h"
+#include "net/url_request/http_user_agent_settings.h"
+#include "net/url_request/url_request_context.h"
+#include "net/url_request/url_request_context_getter.h"
+#include "url/gurl.h"
+
+using content::BrowserThread;
+
+namespace atom {
+
+namespace {
+
+// The resolved addresses are only kept in the host cache.
+void OnHostResolved(net::AddressList* addresses, int result) {
+}
+
+}  // namespace
+
+void PreconnectOnIOThread(net::URLRequestContextGetter* getter,
+                          const GURL& url,
+                          int num_sockets) {
+  DCHECK(BrowserThread::CurrentlyOn(BrowserThread::IO));
+  if (!url.is_valid() || !url.SchemeIsHTTPOrHTTPS() || num_sockets <= 0)
+    return;
+
+  net::URLRequestContext* context = getter->GetURLRequestContext();
+  net::HttpTransactionFactory* factory = context->http_transaction_factory();
+  net::HttpNetworkSession* session = factory ? factory->GetSession() : NULL;
+  if (!session)
+    return;
+
+  // The request is the same with the one that would be sent later so the
+  // sockets would be picked from the same pool.
+  net::HttpRequestInfo request_info;
+  request_info.url = url;
+  request_info.method = "GET";
+  request_info.load_flags = net::LOAD_NORMAL;
+  if (context->http_user_agent_settings())
+    request_info.extra_headers.SetHeader(
+        net::HttpRequestHeaders::kUserAgent,
+        context->http_user_agent_settings()->GetUserAgent());
+
+  net::SSLConfig ssl_config;
+  session->ssl_config_service()->GetSSLConfig(&ssl_config);
+  session->GetNextProtos(&ssl_config.next_protos);
+
+  session->http_stream_factory()->PreconnectStreams(
+      num_sockets, request_info, ssl_config, ssl_config);
+}
+
+void PrefetchDNSOnIOThread(net::URLRequestContextGetter* getter,
+                           const std::vector<std::string>& hosts) {
+  DCHECK(BrowserThread::CurrentlyOn(BrowserThread::IO));
+  net::HostResolver* resolver = getter->GetURLRequestContext()->host_resolver();
+  if (!resolver)
+    return;
+
+  for (const std::string& host : hosts) {
+    if (host.empty())
+      continue;
+
+    net::HostResolver::RequestInfo info(net::HostPortPair(host, 80));
+    info.set_is_speculative(true);
+
+    // The pending request keeps the callback, and with it the addresses,
+    // alive until it is done.
+    net::AddressList* addresses = new net::AddressList;
+    net::CompletionCallback callback =
+        base::Bind(&OnHostResolved, base::Owned(addresses));
+    net::HostResolver::RequestHandle handle;
+    resolver->Resolve(info, net::IDLE, addresses, callback, &handle,
+                      net::BoundNetLog());
+  }
+}
+
+}  // namespace atom
@@ -0,0 +1,33 @@
+// Copyright (c) 2015 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#ifndef ATOM_BROWSER_NET_PRECONNECT_H_
+#define ATOM_BROWSER_NET_PRECONNECT_H_
+
+#include <string>
+#include <vector>
+
+class GURL;
+
+namespace net {
+class URLRequestContextGetter;
+}
+
+namespace atom {
+
+// Opens |num_sockets| connections to the origin of |url| in the context of
+// |getter|, including the TLS handshake for https, so later requests to it do
+// not have to wait for them. Should be called on IO thread.
+void PreconnectOnIOThread(net::URLRequestContextGetter* getter,
+                          const GURL& url,
+                          int num_sockets);
+
+// Resolves |hosts| into the host cache of |getter| without waiting for the
+// results. Should be called on IO thread.
+void PrefetchDNSOnIOThread(net::URLRequestContextGetter* getter,
+                           const std::vector<std::string>& hosts);
+
+}  // namespace atom
+
+#endif  // ATOM_BROWSER_NET_PRECONNECT_H_
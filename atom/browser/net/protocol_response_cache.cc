@@ -0,0 +1,102 @@
+// Copyright (c) 2015 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#include "atom/browser/net/protocol_response_cache.h"
+
+#include <set>
+
+#include "atom/browser/net/url_request_buffer_job.h"
+#include "base/lazy_instance.h"
+#include "content/public/browser/browser_thread.h"
+#include "net/url_request/url_request.h"
+
+using content::BrowserThread;
+
+namespace atom {
+
+namespace {
+
+// All living caches, only accessed on IO thread.
+base::LazyInstance<std::set<ProtocolResponseCache*>>::Leaky g_caches =
+    LAZY_INSTANCE_INITIALIZER;
+
+}  // namespace
+
+ProtocolResponseCache::ProtocolResponseCache(size_t max_bytes)
+    : entries_(base::MRUCache<std::string, Entry>::NO_AUTO_EVICT),
+      max_bytes_(max_bytes),
+      total_bytes_(0) {
+  DCHECK(BrowserThread::CurrentlyOn(BrowserThread::IO));
+  g_caches.Get().insert(this);
+}
+
+ProtocolResponseCache::~ProtocolResponseCache() {
+  DCHECK(BrowserThread::CurrentlyOn(BrowserThread::IO));
+  g_caches.Get().erase(this);
+}
+
+net::URLRequestJob* ProtocolResponseCache::MaybeCreateJob(
+    net::URLRequest* request, net::NetworkDelegate* network_delegate) {
+  DCHECK(BrowserThread::CurrentlyOn(BrowserThread::IO));
+  if (!IsCacheable(request))
+    return nullptr;
+
+  base::MRUCache<std::string, Entry>::iterator it =
+      entries_.Get(request->url().spec());
+  if (it == entries_.end())
+    return nullptr;
+
+  const Entry& entry = it->second;
+  if (!entry.expires.is_null() && entry.expires <= base::TimeTicks::Now()) {
+    Evict(it);
+    return nullptr;
+  }
+
+  return new URLRequestBufferJob(request, network_delegate,
+                                 entry.mime_type, entry.charset,
+                                 entry.content_encoding, entry.data);
+}
+
+void ProtocolResponseCache::Put(const GURL& url, const Entry& entry) {
+  DCHECK(BrowserThread::CurrentlyOn(BrowserThread::IO));
+  size_t size = entry.data->size();
+  if (size > max_bytes_)
+    return;
+
+  base::MRUCache<std::string, Entry>::iterator old = entries_.Peek(url.spec());
+  if (old != entries_.end())
+    Evict(old);
+
+  while (total_bytes_ + size > max_bytes_ && !entries_.empty())
+    Evict(--entries_.end());
+
+  entries_.Put(url.spec(), entry);
+  total_bytes_ += size;
+}
+
+// static
+bool ProtocolResponseCache::IsCacheable(const net::URLRequest* request) {
+  return request->method() == "GET";
+}
+
+// static
+void ProtocolResponseCache::PurgeAll(bool all) {
+  DCHECK(BrowserThread::CurrentlyOn(BrowserThread::IO));
+  for (ProtocolResponseCache* cache : g_caches.Get())
+    cache->Purge(all);
+}
+
+void ProtocolResponseCache::Purge(bool all) {
+  size_t max_bytes = all ? 0 : max_bytes_ / 2;
+  while (total_bytes_ > max_bytes && !entries_.empty())
+    Evict(--entries_.end());
+}
+
+void ProtocolResponseCache::Evict(
+    base::MRUCache<std::string, Entry>::iterator it) {
+  total_bytes_ -= it->second.data->size();
+  entries_.Erase(it);
+}
+
+}  // namespace atom
@@ -0,0 +1,77 @@
+// Copyright (c) 2015 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#ifndef ATOM_BROWSER_NET_PROTOCOL_RESPONSE_CACHE_H_
+#define ATOM_BROWSER_NET_PROTOCOL_RESPONSE_CACHE_H_
+
+#include <string>
+
+#include "base/containers/mru_cache.h"
+#include "base/memory/ref_counted.h"
+#include "base/memory/ref_counted_memory.h"
+#include "base/time/time.h"
+#include "content/public/browser/browser_thread.h"
+
+class GURL;
+
+namespace net {
+class NetworkDelegate;
+class URLRequest;
+class URLRequestJob;
+}
+
+namespace atom {
+
+// An in-memory LRU cache of the responses of a custom protocol, so requests
+// of cached URLs are served on IO thread without asking JS. Only accessed on
+// IO thread.
+class ProtocolResponseCache
+    : public base::RefCountedThreadSafe<
+          ProtocolResponseCache,
+          content::BrowserThread::DeleteOnIOThread> {
+ public:
+  struct Entry {
+    std::string mime_type;
+    std::string charset;
+    std::string content_encoding;
+    scoped_refptr<base::RefCountedMemory> data;
+    // Null for immutable responses, which never expire.
+    base::TimeTicks expires;
+  };
+
+  // Keeps at most |max_bytes| of response data.
+  explicit ProtocolResponseCache(size_t max_bytes);
+
+  // Returns a job sending the cached response of |request|, or NULL.
+  net::URLRequestJob* MaybeCreateJob(
+      net::URLRequest* request, net::NetworkDelegate* network_delegate);
+
+  void Put(const GURL& url, const Entry& entry);
+
+  // Whether the response of |request| can be put into the cache.
+  static bool IsCacheable(const net::URLRequest* request);
+
+  // Drops the responses of all caches, |all| drops all of them, otherwise the
+  // least recently used ones are dropped until each cache is half full.
+  static void PurgeAll(bool all);
+
+ private:
+  friend struct content::BrowserThread::DeleteOnThread<
+      content::BrowserThread::IO>;
+  friend class base::DeleteHelper<ProtocolResponseCache>;
+  ~ProtocolResponseCache();
+
+  void Evict(base::MRUCache<std::string, Entry>::iterator it);
+  void Purge(bool all);
+
+  base::MRUCache<std::string, Entry> entries_;
+  size_t max_bytes_;
+  size_t total_bytes_;
+
+  DISALLOW_COPY_AND_ASSIGN(ProtocolResponseCache);
+};
+
+}  // namespace atom
+
+#endif  // ATOM_BROWSER_NET_PROTOCOL_RESPONSE_CACHE_H_
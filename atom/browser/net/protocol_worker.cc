@@ -0,0 +1,134 @@
+// Copyright (c) 2015 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#include "atom/browser/net/protocol_worker.h"
+
+#include <vector>
+
+#include "base/bind.h"
+
+using content::BrowserThread;
+
+namespace atom {
+
+namespace {
+
+std::string GetStringProperty(v8::Isolate* isolate,
+                              v8::Local<v8::Object> object,
+                              const char* name) {
+  v8::Local<v8::Value> value =
+      object->Get(v8::String::NewFromUtf8(isolate, name));
+  if (value.IsEmpty() || value->IsUndefined() || value->IsNull())
+    return std::string();
+  v8::String::Utf8Value utf8(value);
+  return *utf8 ? std::string(*utf8, utf8.length()) : std::string();
+}
+
+}  // namespace
+
+ProtocolWorkerResponse::ProtocolWorkerResponse() : type(NONE) {
+}
+
+ProtocolWorkerResponse::~ProtocolWorkerResponse() {
+}
+
+ProtocolWorker::ProtocolWorker(const base::FilePath& script)
+    : script_(script),
+      host_("ProtocolWorker_" + script.BaseName().AsUTF8Unsafe(), script,
+            false, this) {
+}
+
+ProtocolWorker::~ProtocolWorker() {
+  DCHECK(BrowserThread::CurrentlyOn(BrowserThread::UI));
+  host_.Stop();
+}
+
+bool ProtocolWorker::Start() {
+  DCHECK(BrowserThread::CurrentlyOn(BrowserThread::UI));
+  return host_.Start();
+}
+
+void ProtocolWorker::HandleRequest(const std::string& method,
+                                   const GURL& url,
+                                   const std::string& referrer,
+                                   const ResponseCallback& callback) {
+  if (!host_.PostTask(base::Bind(&ProtocolWorker::HandleRequestOnWorkerThread,
+                                 this, method, url, referrer, callback))) {
+    BrowserThread::PostTask(BrowserThread::IO, FROM_HERE,
+                            base::Bind(callback, ProtocolWorkerResponse()));
+  }
+}
+
+void ProtocolWorker::SetUpGlobal(v8::Isolate* isolate,
+                                 v8::Local<v8::Object> global) {
+}
+
+void ProtocolWorker::OnScriptError(const std::string& message) {
+  LOG(ERROR) << "Uncaught exception in protocol worker " << script_.value()
+             << ": " << message;
+}
+
+void ProtocolWorker::HandleRequestOnWorkerThread(
+    const std::string& method,
+    const GURL& url,
+    const std::string& referrer,
+    const ResponseCallback& callback) {
+  BrowserThread::PostTask(BrowserThread::IO, FROM_HERE,
+                          base::Bind(callback,
+                                     RunHandler(method, url, referrer)));
+}
+
+ProtocolWorkerResponse ProtocolWorker::RunHandler(
+    const std::string& method,
+    const GURL& url,
+    const std::string& referrer) {
+  ProtocolWorkerResponse response;
+  WorkerHost::Scope scope(&host_);
+  v8::Isolate* isolate = host_.isolate();
+  v8::Local<v8::Function> handler = host_.GetFunction("handleRequest");
+  if (handler.IsEmpty()) {
+    LOG(ERROR) << "Protocol worker " << script_.value()
+               << " does not define handleRequest";
+    return response;
+  }
+
+  v8::Local<v8::Object> request = v8::Object::New(isolate);
+  request->Set(v8::String::NewFromUtf8(isolate, "method"),
+               v8::String::NewFromUtf8(isolate, method.c_str()));
+  request->Set(v8::String::NewFromUtf8(isolate, "url"),
+               v8::String::NewFromUtf8(isolate, url.spec().c_str()));
+  request->Set(v8::String::NewFromUtf8(isolate, "referrer"),
+               v8::String::NewFromUtf8(isolate, referrer.c_str()));
+
+  std::vector<v8::Local<v8::Value>> argv(1, request);
+  v8::Local<v8::Value> result = host_.Call(handler, argv);
+  if (result.IsEmpty()) {
+    return response;
+  } else if (result->IsString()) {
+    v8::String::Utf8Value data(result);
+    response.type = ProtocolWorkerResponse::STRING;
+    response.mime_type = "text/plain";
+    response.charset = "UTF-8";
+    response.data.assign(*data, data.length());
+  } else if (result->IsObject()) {
+    v8::Local<v8::Object> object = result->ToObject();
+    std::string path = GetStringProperty(isolate, object, "path");
+    if (!path.empty()) {
+      response.type = ProtocolWorkerResponse::FILE;
+      response.path = base::FilePath::FromUTF8Unsafe(path);
+    } else {
+      response.type = ProtocolWorkerResponse::STRING;
+      response.mime_type = GetStringProperty(isolate, object, "mimeType");
+      response.charset = GetStringProperty(isolate, object, "charset");
+      response.data = GetStringProperty(isolate, object, "data");
+      if (response.mime_type.empty())
+        response.mime_type = "text/plain";
+      if (response.charset.empty())
+        response.charset = "UTF-8";
+    }
+  }
+  return response;
+}
+
+}  // namespace atom
@@ -0,0 +1,92 @@
+// Copyright (c) 2015 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#ifndef ATOM_BROWSER_NET_PROTOCOL_WORKER_H_
+#define ATOM_BROWSER_NET_PROTOCOL_WORKER_H_
+
+#include <string>
+
+#include "atom/browser/worker_host.h"
+#include "base/callback.h"
+#include "base/files/file_path.h"
+#include "base/memory/ref_counted.h"
+#include "content/public/browser/browser_thread.h"
+#include "url/gurl.h"
+#include "v8/include/v8.h"
+
+namespace atom {
+
+// What the |handleRequest| function of a worker script returned.
+struct ProtocolWorkerResponse {
+  enum Type {
+    // The script did not handle the request.
+    NONE,
+    STRING,
+    FILE,
+  };
+
+  ProtocolWorkerResponse();
+  ~ProtocolWorkerResponse();
+
+  Type type;
+  std::string mime_type;
+  std::string charset;
+  std::string data;
+  base::FilePath path;
+};
+
+// Runs the |handleRequest(request)| function of a script on its own thread
+// with a plain V8 isolate, so responses of a protocol can be generated without
+// the UI thread. The function returns a string, an object with |mimeType|,
+// |charset| and |data|, or an object with |path| to send a file.
+class ProtocolWorker : public base::RefCountedThreadSafe<
+                           ProtocolWorker,
+                           content::BrowserThread::DeleteOnUIThread>,
+                       public WorkerHost::Delegate {
+ public:
+  // Called on IO thread.
+  typedef base::Callback<void(const ProtocolWorkerResponse&)>
+      ResponseCallback;
+
+  explicit ProtocolWorker(const base::FilePath& script);
+
+  // Starts the thread and runs the script. Should be called on UI thread.
+  bool Start();
+
+  // Asks the script for the response of a request, can be called on any
+  // thread.
+  void HandleRequest(const std::string& method,
+                     const GURL& url,
+                     const std::string& referrer,
+                     const ResponseCallback& callback);
+
+ private:
+  friend struct content::BrowserThread::DeleteOnThread<
+      content::BrowserThread::UI>;
+  friend class base::DeleteHelper<ProtocolWorker>;
+
+  ~ProtocolWorker() override;
+
+  // WorkerHost::Delegate:
+  void SetUpGlobal(v8::Isolate* isolate,
+                   v8::Local<v8::Object> global) override;
+  void OnScriptError(const std::string& message) override;
+
+  void HandleRequestOnWorkerThread(const std::string& method,
+                                   const GURL& url,
+                                   const std::string& referrer,
+                                   const ResponseCallback& callback);
+  ProtocolWorkerResponse RunHandler(const std::string& method,
+                                    const GURL& url,
+                                    const std::string& referrer);
+
+  base::FilePath script_;
+  WorkerHost host_;
+
+  DISALLOW_COPY_AND_ASSIGN(ProtocolWorker);
+};
+
+}  // namespace atom
+
+#endif  // ATOM_BROWSER_NET_PROTOCOL_WORKER_H_
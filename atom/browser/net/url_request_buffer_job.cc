@@ -6,22 +6,58 @@
 
 #include <string>
 
+#include "base/strings/string_util.h"
+#include "content/public/browser/browser_thread.h"
+#include "net/base/filter.h"
 #include "net/base/net_errors.h"
 
+#include "atom/common/node_includes.h"
+
+using content::BrowserThread;
+
 namespace atom {
 
-URLRequestBufferJob::URLRequestBufferJob(net::URLRequest* request,
-                                         net::NetworkDelegate* network_delegate,
-                                         const std::string& mime_type,
-                                         const std::string& charset,
-                                         v8::Local<v8::Object> data)
+struct NodeBufferMemory::Holder {
+  ~Holder() { buffer.Reset(); }
+
+  v8::Persistent<v8::Object> buffer;
+};
+
+NodeBufferMemory::NodeBufferMemory(v8::Isolate* isolate,
+                                   v8::Local<v8::Object> buffer)
+    : holder_(new Holder),
+      data_(reinterpret_cast<const unsigned char*>(node::Buffer::Data(buffer))),
+      length_(node::Buffer::Length(buffer)) {
+  DCHECK(BrowserThread::CurrentlyOn(BrowserThread::UI));
+  holder_->buffer.Reset(isolate, buffer);
+}
+
+NodeBufferMemory::~NodeBufferMemory() {
+  // The last reference is usually dropped by the job on IO thread.
+  if (!BrowserThread::CurrentlyOn(BrowserThread::UI))
+    BrowserThread::DeleteSoon(BrowserThread::UI, FROM_HERE, holder_.release());
+}
+
+const unsigned char* NodeBufferMemory::front() const {
+  return data_;
+}
+
+size_t NodeBufferMemory::size() const {
+  return length_;
+}
+
+URLRequestBufferJob::URLRequestBufferJob(
+    net::URLRequest* request,
+    net::NetworkDelegate* network_delegate,
+    const std::string& mime_type,
+    const std::string& charset,
+    const std::string& content_encoding,
+    scoped_refptr<base::RefCountedMemory> data)
     : net::URLRequestSimpleJob(request, network_delegate),
       mime_type_(mime_type),
       charset_(charset),
-      buffer_data_(new base::RefCountedBytes()) {
-  auto input = reinterpret_cast<const unsigned char*>(node::Buffer::Data(data));
-  size_t length = node::Buffer::Length(data);
-  buffer_data_->data().assign(input, input + length);
+      content_encoding_(content_encoding),
+      buffer_data_(data) {
 }
 
 int URLRequestBufferJob::GetRefCountedData(
@@ -35,4 +71,9 @@ int URLRequestBufferJob::GetRefCountedData(
   return net::OK;
 }
 
+net::Filter* URLRequestBufferJob::SetupFilter() const {
+  return LowerCaseEqualsASCII(content_encoding_, "gzip") ?
+      net::Filter::GZipFactory() : NULL;
+}
+
 }  // namespace atom
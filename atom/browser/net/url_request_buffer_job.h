@@ -8,29 +8,57 @@
 #include <string>
 
 #include "base/memory/ref_counted_memory.h"
+#include "base/memory/scoped_ptr.h"
 #include "net/url_request/url_request_simple_job.h"
-#include "atom/common/node_includes.h"
+#include "v8/include/v8.h"
 
 namespace atom {
 
+// Keeps a Node Buffer alive and exposes its memory without copying, so it can
+// be passed to IO thread. The Buffer is released on UI thread.
+class NodeBufferMemory : public base::RefCountedMemory {
+ public:
+  // Should be called on UI thread.
+  NodeBufferMemory(v8::Isolate* isolate, v8::Local<v8::Object> buffer);
+
+  // base::RefCountedMemory:
+  const unsigned char* front() const override;
+  size_t size() const override;
+
+ private:
+  struct Holder;
+
+  ~NodeBufferMemory() override;
+
+  scoped_ptr<Holder> holder_;
+  const unsigned char* data_;
+  size_t length_;
+
+  DISALLOW_COPY_AND_ASSIGN(NodeBufferMemory);
+};
+
 class URLRequestBufferJob : public net::URLRequestSimpleJob {
  public:
   URLRequestBufferJob(net::URLRequest* request,
                       net::NetworkDelegate* network_delegate,
                       const std::string& mime_type,
                       const std::string& charset,
-                      v8::Local<v8::Object> buffer);
+                      const std::string& content_encoding,
+                      scoped_refptr<base::RefCountedMemory> data);
 
   // URLRequestSimpleJob:
   int GetRefCountedData(std::string* mime_type,
                         std::string* charset,
                         scoped_refptr<base::RefCountedMemory>* data,
                         const net::CompletionCallback& callback) const override;
+  net::Filter* SetupFilter() const override;
 
  private:
   std::string mime_type_;
   std::string charset_;
-  scoped_refptr<base::RefCountedBytes> buffer_data_;
+  // The data is decoded by the network stack when it is "gzip".
+  std::string content_encoding_;
+  scoped_refptr<base::RefCountedMemory> buffer_data_;
 
   DISALLOW_COPY_AND_ASSIGN(URLRequestBufferJob);
 };
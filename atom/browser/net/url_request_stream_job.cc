@@ -0,0 +1,188 @@
+// Copyright (c) 2015 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#include "atom/browser/net/url_request_stream_job.h"
+
+#include <algorithm>
+#include <vector>
+
+#include "base/bind.h"
+#include "base/message_loop/message_loop.h"
+#include "content/public/browser/browser_thread.h"
+#include "net/url_request/url_request_status.h"
+
+using content::BrowserThread;
+
+namespace atom {
+
+RequestStreamBuffer::RequestStreamBuffer(const ConsumedCallback& consumed)
+    : consumed_(consumed),
+      ended_(false),
+      aborted_(false) {
+}
+
+RequestStreamBuffer::~RequestStreamBuffer() {
+}
+
+void RequestStreamBuffer::Write(int id, const std::string& data) {
+  DCHECK(BrowserThread::CurrentlyOn(BrowserThread::UI));
+  {
+    base::AutoLock auto_lock(lock_);
+    if (!aborted_ && !ended_) {
+      Chunk chunk = { id, data, 0 };
+      chunks_.push_back(chunk);
+      BrowserThread::PostTask(BrowserThread::IO, FROM_HERE,
+          base::Bind(&RequestStreamBuffer::NotifyJob, this));
+      return;
+    }
+  }
+
+  // Nobody is going to read it.
+  base::MessageLoop::current()->PostTask(FROM_HERE,
+                                         base::Bind(consumed_, id, false));
+}
+
+void RequestStreamBuffer::End() {
+  DCHECK(BrowserThread::CurrentlyOn(BrowserThread::UI));
+  base::AutoLock auto_lock(lock_);
+  ended_ = true;
+  BrowserThread::PostTask(BrowserThread::IO, FROM_HERE,
+      base::Bind(&RequestStreamBuffer::NotifyJob, this));
+}
+
+void RequestStreamBuffer::SetJob(
+    const base::WeakPtr<URLRequestStreamJob>& job) {
+  DCHECK(BrowserThread::CurrentlyOn(BrowserThread::IO));
+  job_ = job;
+}
+
+int RequestStreamBuffer::Read(char* buf, int size) {
+  DCHECK(BrowserThread::CurrentlyOn(BrowserThread::IO));
+  std::vector<int> consumed;
+  int bytes_read = 0;
+  {
+    base::AutoLock auto_lock(lock_);
+    while (bytes_read < size && !chunks_.empty()) {
+      Chunk& chunk = chunks_.front();
+      size_t length = std::min(chunk.data.size() - chunk.offset,
+                               static_cast<size_t>(size - bytes_read));
+      memcpy(buf + bytes_read, chunk.data.data() + chunk.offset, length);
+      bytes_read += length;
+      chunk.offset += length;
+      if (chunk.offset == chunk.data.size()) {
+        consumed.push_back(chunk.id);
+        chunks_.pop_front();
+      }
+    }
+    if (bytes_read == 0 && !ended_)
+      bytes_read = kWouldBlock;
+  }
+
+  // Let JS write more data.
+  for (int id : consumed)
+    BrowserThread::PostTask(BrowserThread::UI, FROM_HERE,
+                            base::Bind(consumed_, id, true));
+  return bytes_read;
+}
+
+void RequestStreamBuffer::Abort() {
+  DCHECK(BrowserThread::CurrentlyOn(BrowserThread::IO));
+  job_.reset();
+
+  std::deque<Chunk> chunks;
+  {
+    base::AutoLock auto_lock(lock_);
+    aborted_ = true;
+    chunks.swap(chunks_);
+  }
+  for (const Chunk& chunk : chunks)
+    BrowserThread::PostTask(BrowserThread::UI, FROM_HERE,
+                            base::Bind(consumed_, chunk.id, false));
+}
+
+void RequestStreamBuffer::NotifyJob() {
+  DCHECK(BrowserThread::CurrentlyOn(BrowserThread::IO));
+  if (job_)
+    job_->OnDataAvailable();
+}
+
+URLRequestStreamJob::URLRequestStreamJob(
+    net::URLRequest* request,
+    net::NetworkDelegate* network_delegate,
+    const std::string& mime_type,
+    const std::string& charset,
+    scoped_refptr<RequestStreamBuffer> buffer)
+    : net::URLRequestJob(request, network_delegate),
+      mime_type_(mime_type),
+      charset_(charset),
+      buffer_(buffer),
+      pending_buf_size_(0),
+      weak_factory_(this) {
+}
+
+URLRequestStreamJob::~URLRequestStreamJob() {
+  buffer_->Abort();
+}
+
+void URLRequestStreamJob::OnDataAvailable() {
+  if (!pending_buf_.get())
+    return;
+
+  int result = buffer_->Read(pending_buf_->data(), pending_buf_size_);
+  if (result == RequestStreamBuffer::kWouldBlock)
+    return;
+
+  pending_buf_ = nullptr;
+  pending_buf_size_ = 0;
+  SetStatus(net::URLRequestStatus());
+  NotifyReadComplete(result);
+}
+
+void URLRequestStreamJob::Start() {
+  // Start reading asynchronously so that all error reporting and data
+  // callbacks happen as they would for network requests.
+  base::MessageLoop::current()->PostTask(
+      FROM_HERE,
+      base::Bind(&URLRequestStreamJob::StartAsync,
+                 weak_factory_.GetWeakPtr()));
+}
+
+void URLRequestStreamJob::Kill() {
+  weak_factory_.InvalidateWeakPtrs();
+  pending_buf_ = nullptr;
+  buffer_->Abort();
+  net::URLRequestJob::Kill();
+}
+
+bool URLRequestStreamJob::ReadRawData(net::IOBuffer* buf,
+                                      int buf_size,
+                                      int *bytes_read) {
+  int result = buffer_->Read(buf->data(), buf_size);
+  if (result == RequestStreamBuffer::kWouldBlock) {
+    pending_buf_ = buf;
+    pending_buf_size_ = buf_size;
+    SetStatus(net::URLRequestStatus(net::URLRequestStatus::IO_PENDING, 0));
+    return false;
+  }
+
+  *bytes_read = result;
+  return true;
+}
+
+bool URLRequestStreamJob::GetMimeType(std::string* mime_type) const {
+  *mime_type = mime_type_;
+  return true;
+}
+
+bool URLRequestStreamJob::GetCharset(std::string* charset) {
+  *charset = charset_;
+  return true;
+}
+
+void URLRequestStreamJob::StartAsync() {
+  buffer_->SetJob(weak_factory_.GetWeakPtr());
+  NotifyHeadersComplete();
+}
+
+}  // namespace atom
@@ -0,0 +1,118 @@
+// Copyright (c) 2015 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#ifndef ATOM_BROWSER_NET_URL_REQUEST_STREAM_JOB_H_
+#define ATOM_BROWSER_NET_URL_REQUEST_STREAM_JOB_H_
+
+#include <deque>
+#include <string>
+
+#include "base/callback.h"
+#include "base/memory/ref_counted.h"
+#include "base/memory/weak_ptr.h"
+#include "base/synchronization/lock.h"
+#include "net/base/io_buffer.h"
+#include "net/url_request/url_request_job.h"
+
+namespace atom {
+
+class URLRequestStreamJob;
+
+// The chunks written by JS on UI thread and waiting to be read by the
+// URLRequestStreamJob on IO thread.
+class RequestStreamBuffer
+    : public base::RefCountedThreadSafe<RequestStreamBuffer> {
+ public:
+  // Called on UI thread with the ID of a chunk once it has been read, or with
+  // |read| being false when it is dropped because the request is gone.
+  typedef base::Callback<void(int id, bool read)> ConsumedCallback;
+
+  enum {
+    // Returned by Read when there is no data but the stream has not ended.
+    kWouldBlock = -1,
+  };
+
+  explicit RequestStreamBuffer(const ConsumedCallback& consumed);
+
+  // Should be called on UI thread.
+  void Write(int id, const std::string& data);
+  void End();
+
+  // Should be called on IO thread.
+  void SetJob(const base::WeakPtr<URLRequestStreamJob>& job);
+  // Copies at most |size| bytes into |buf|, returns the number of bytes read,
+  // 0 at the end of stream, or kWouldBlock.
+  int Read(char* buf, int size);
+  // The request is finished or has gone before starting the job, drops all
+  // data written.
+  void Abort();
+
+ private:
+  friend class base::RefCountedThreadSafe<RequestStreamBuffer>;
+  ~RequestStreamBuffer();
+
+  struct Chunk {
+    int id;
+    std::string data;
+    size_t offset;
+  };
+
+  void NotifyJob();
+
+  ConsumedCallback consumed_;
+
+  // Only accessed on IO thread.
+  base::WeakPtr<URLRequestStreamJob> job_;
+
+  base::Lock lock_;
+  std::deque<Chunk> chunks_;
+  bool ended_;
+  bool aborted_;
+
+  DISALLOW_COPY_AND_ASSIGN(RequestStreamBuffer);
+};
+
+// Sends the data of a RequestStreamBuffer as response, the reads are kept
+// pending until JS writes more data.
+class URLRequestStreamJob : public net::URLRequestJob {
+ public:
+  URLRequestStreamJob(net::URLRequest* request,
+                      net::NetworkDelegate* network_delegate,
+                      const std::string& mime_type,
+                      const std::string& charset,
+                      scoped_refptr<RequestStreamBuffer> buffer);
+
+  // Called by the buffer when new data is written or the stream ends.
+  void OnDataAvailable();
+
+  // net::URLRequestJob:
+  void Start() override;
+  void Kill() override;
+  bool ReadRawData(net::IOBuffer* buf,
+                   int buf_size,
+                   int *bytes_read) override;
+  bool GetMimeType(std::string* mime_type) const override;
+  bool GetCharset(std::string* charset) override;
+
+ private:
+  ~URLRequestStreamJob() override;
+
+  void StartAsync();
+
+  std::string mime_type_;
+  std::string charset_;
+  scoped_refptr<RequestStreamBuffer> buffer_;
+
+  // The read waiting for data.
+  scoped_refptr<net::IOBuffer> pending_buf_;
+  int pending_buf_size_;
+
+  base::WeakPtrFactory<URLRequestStreamJob> weak_factory_;
+
+  DISALLOW_COPY_AND_ASSIGN(URLRequestStreamJob);
+};
+
+}  // namespace atom
+
+#endif  // ATOM_BROWSER_NET_URL_REQUEST_STREAM_JOB_H_
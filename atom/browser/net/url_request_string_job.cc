@@ -6,6 +6,8 @@
 
 #include <string>
 
+#include "base/strings/string_util.h"
+#include "net/base/filter.h"
 #include "net/base/net_errors.h"
 
 namespace atom {
@@ -14,10 +16,12 @@ URLRequestStringJob::URLRequestStringJob(net::URLRequest* request,
                                          net::NetworkDelegate* network_delegate,
                                          const std::string& mime_type,
                                          const std::string& charset,
+                                         const std::string& content_encoding,
                                          const std::string& data)
     : net::URLRequestSimpleJob(request, network_delegate),
       mime_type_(mime_type),
       charset_(charset),
+      content_encoding_(content_encoding),
       data_(data) {
 }
 
@@ -32,4 +36,9 @@ int URLRequestStringJob::GetData(
   return net::OK;
 }
 
+net::Filter* URLRequestStringJob::SetupFilter() const {
+  return LowerCaseEqualsASCII(content_encoding_, "gzip") ?
+      net::Filter::GZipFactory() : NULL;
+}
+
 }  // namespace atom
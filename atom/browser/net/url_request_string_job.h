@@ -17,6 +17,7 @@ class URLRequestStringJob : public net::URLRequestSimpleJob {
                       net::NetworkDelegate* network_delegate,
                       const std::string& mime_type,
                       const std::string& charset,
+                      const std::string& content_encoding,
                       const std::string& data);
 
   // URLRequestSimpleJob:
@@ -24,10 +25,13 @@ class URLRequestStringJob : public net::URLRequestSimpleJob {
               std::string* charset,
               std::string* data,
               const net::CompletionCallback& callback) const override;
+  net::Filter* SetupFilter() const override;
 
  private:
   std::string mime_type_;
   std::string charset_;
+  // The data is decoded by the network stack when it is "gzip".
+  std::string content_encoding_;
   std::string data_;
 
   DISALLOW_COPY_AND_ASSIGN(URLRequestStringJob);
@@ -0,0 +1,90 @@
+// Copyright (c) 2015 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#include "atom/browser/net/worker_protocol_handler.h"
+
+#include "atom/browser/net/adapter_request_job.h"
+#include "atom/browser/net/protocol_worker.h"
+#include "base/bind.h"
+#include "net/base/net_errors.h"
+#include "net/url_request/url_request.h"
+
+namespace atom {
+
+namespace {
+
+// Asks a ProtocolWorker instead of the UI thread for the job.
+class WorkerRequestJob : public AdapterRequestJob {
+ public:
+  WorkerRequestJob(scoped_refptr<ProtocolWorker> worker,
+                   net::URLRequest* request,
+                   net::NetworkDelegate* network_delegate)
+      : AdapterRequestJob(NULL, request, network_delegate),
+        worker_(worker),
+        weak_factory_(this) {
+  }
+
+  // AdapterRequestJob:
+  void Start() override {
+    worker_->HandleRequest(
+        request()->method(),
+        request()->url(),
+        request()->referrer(),
+        base::Bind(&WorkerRequestJob::OnResponse,
+                   weak_factory_.GetWeakPtr()));
+  }
+
+  void Kill() override {
+    weak_factory_.InvalidateWeakPtrs();
+    AdapterRequestJob::Kill();
+  }
+
+  void GetJobTypeInUI() override {
+    NOTREACHED();
+  }
+
+ private:
+  void OnResponse(const ProtocolWorkerResponse& response) {
+    switch (response.type) {
+      case ProtocolWorkerResponse::STRING:
+        CreateStringJobAndStart(response.mime_type, response.charset, "",
+                                response.data);
+        break;
+      case ProtocolWorkerResponse::FILE:
+        CreateFileJobAndStart(response.path);
+        break;
+      case ProtocolWorkerResponse::NONE:
+        CreateErrorJobAndStart(net::ERR_NOT_IMPLEMENTED);
+        break;
+    }
+  }
+
+  scoped_refptr<ProtocolWorker> worker_;
+
+  base::WeakPtrFactory<WorkerRequestJob> weak_factory_;
+
+  DISALLOW_COPY_AND_ASSIGN(WorkerRequestJob);
+};
+
+}  // namespace
+
+WorkerProtocolHandler::WorkerProtocolHandler(
+    const std::vector<scoped_refptr<ProtocolWorker>>& workers)
+    : workers_(workers),
+      next_worker_(0) {
+  DCHECK(!workers_.empty());
+}
+
+WorkerProtocolHandler::~WorkerProtocolHandler() {
+}
+
+net::URLRequestJob* WorkerProtocolHandler::MaybeCreateJob(
+    net::URLRequest* request,
+    net::NetworkDelegate* network_delegate) const {
+  scoped_refptr<ProtocolWorker> worker = workers_[next_worker_];
+  next_worker_ = (next_worker_ + 1) % workers_.size();
+  return new WorkerRequestJob(worker, request, network_delegate);
+}
+
+}  // namespace atom
@@ -0,0 +1,40 @@
+// Copyright (c) 2015 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#ifndef ATOM_BROWSER_NET_WORKER_PROTOCOL_HANDLER_H_
+#define ATOM_BROWSER_NET_WORKER_PROTOCOL_HANDLER_H_
+
+#include <vector>
+
+#include "base/memory/ref_counted.h"
+#include "net/url_request/url_request_job_factory.h"
+
+namespace atom {
+
+class ProtocolWorker;
+
+// Answers the requests of a scheme with ProtocolWorkers, the requests are
+// spread over the workers so each of them runs on a different thread.
+class WorkerProtocolHandler
+    : public net::URLRequestJobFactory::ProtocolHandler {
+ public:
+  explicit WorkerProtocolHandler(
+      const std::vector<scoped_refptr<ProtocolWorker>>& workers);
+  virtual ~WorkerProtocolHandler();
+
+  // net::URLRequestJobFactory::ProtocolHandler:
+  net::URLRequestJob* MaybeCreateJob(
+      net::URLRequest* request,
+      net::NetworkDelegate* network_delegate) const override;
+
+ private:
+  std::vector<scoped_refptr<ProtocolWorker>> workers_;
+  mutable size_t next_worker_;
+
+  DISALLOW_COPY_AND_ASSIGN(WorkerProtocolHandler);
+};
+
+}  // namespace atom
+
+#endif  // ATOM_BROWSER_NET_WORKER_PROTOCOL_HANDLER_H_
@@ -4,15 +4,20 @@
 
 #include "atom/browser/node_debugger.h"
 
+#include <algorithm>
 #include <string>
 
 #include "base/bind.h"
 #include "base/command_line.h"
+#include "base/json/json_reader.h"
+#include "base/json/json_writer.h"
 #include "base/strings/string_number_conversions.h"
 #include "base/strings/stringprintf.h"
 #include "base/strings/utf_string_conversions.h"
+#include "base/values.h"
 #include "content/public/browser/browser_thread.h"
 #include "net/socket/tcp_listen_socket.h"
+#include "v8/include/v8-profiler.h"
 
 #include "atom/common/node_includes.h"
 
@@ -26,12 +31,63 @@ const int kIsolateSlot = 2;
 
 const char* kContentLength = "Content-Length";
 
+// The "Content-Length" comes from the client, so at most this much is reserved
+// for a message before its data arrives.
+const int kMaxReservedMessageSize = 1024 * 1024;
+
+const char kCpuProfileTitle[] = "atom-shell-debugger";
+
+std::string V8ToString(v8::Handle<v8::String> value) {
+  v8::String::Utf8Value utf8(value);
+  return *utf8 ? std::string(*utf8, utf8.length()) : std::string();
+}
+
+// Converts the profile to the format of the .cpuprofile files of devtools.
+base::DictionaryValue* CpuProfileNodeToValue(const v8::CpuProfileNode* node) {
+  base::DictionaryValue* dict = new base::DictionaryValue;
+  dict->SetString("functionName", V8ToString(node->GetFunctionName()));
+  dict->SetInteger("scriptId", node->GetScriptId());
+  dict->SetString("url", V8ToString(node->GetScriptResourceName()));
+  dict->SetInteger("lineNumber", node->GetLineNumber());
+  dict->SetInteger("columnNumber", node->GetColumnNumber());
+  dict->SetInteger("hitCount", node->GetHitCount());
+  dict->SetDouble("callUID", node->GetCallUid());
+  dict->SetInteger("id", node->GetNodeId());
+  dict->SetString("bailoutReason", node->GetBailoutReason());
+  base::ListValue* children = new base::ListValue;
+  for (int i = 0; i < node->GetChildrenCount(); ++i)
+    children->Append(CpuProfileNodeToValue(node->GetChild(i)));
+  dict->Set("children", children);
+  return dict;
+}
+
+base::DictionaryValue* CpuProfileToValue(const v8::CpuProfile* profile) {
+  base::DictionaryValue* dict = new base::DictionaryValue;
+  dict->Set("head", CpuProfileNodeToValue(profile->GetTopDownRoot()));
+  // The times of V8 are in microseconds, devtools wants seconds.
+  dict->SetDouble("startTime", profile->GetStartTime() / 1000000.0);
+  dict->SetDouble("endTime", profile->GetEndTime() / 1000000.0);
+  base::ListValue* samples = new base::ListValue;
+  base::ListValue* timestamps = new base::ListValue;
+  for (int i = 0; i < profile->GetSamplesCount(); ++i) {
+    samples->AppendInteger(profile->GetSample(i)->GetNodeId());
+    timestamps->AppendDouble(
+        static_cast<double>(profile->GetSampleTimestamp(i)));
+  }
+  dict->Set("samples", samples);
+  dict->Set("timestamps", timestamps);
+  return dict;
+}
+
 }  // namespace
 
 NodeDebugger::NodeDebugger(v8::Isolate* isolate)
     : isolate_(isolate),
       thread_("NodeDebugger"),
       content_length_(-1),
+      flush_scheduled_(false),
+      cpu_profiling_(false),
+      ui_weak_factory_(this),
       weak_factory_(this) {
   bool use_debug_agent = false;
   int port = 5858;
@@ -93,6 +149,12 @@ void NodeDebugger::StartServer(int port) {
 
 void NodeDebugger::CloseSession() {
   accepted_socket_.reset();
+
+  // The profile would never be retrieved.
+  content::BrowserThread::PostTask(
+      content::BrowserThread::UI, FROM_HERE,
+      base::Bind(&NodeDebugger::StopCpuProfiling,
+                 ui_weak_factory_.GetWeakPtr(), -1));
 }
 
 void NodeDebugger::OnMessage(const std::string& message) {
@@ -100,6 +162,9 @@ void NodeDebugger::OnMessage(const std::string& message) {
           std::string::npos)
     CloseSession();
 
+  if (HandleProfilerCommand(message))
+    return;
+
   base::string16 message16 = base::UTF8ToUTF16(message);
   v8::Debug::SendCommand(
       isolate_,
@@ -110,13 +175,143 @@ void NodeDebugger::OnMessage(const std::string& message) {
       base::Bind(&v8::Debug::ProcessDebugMessages));
 }
 
-void NodeDebugger::SendMessage(const std::string& message) {
-  if (accepted_socket_) {
-    std::string header = base::StringPrintf(
-        "%s: %d\r\n\r\n", kContentLength, static_cast<int>(message.size()));
-    accepted_socket_->Send(header);
-    accepted_socket_->Send(message);
+void NodeDebugger::QueueMessage(const std::string& message) {
+  std::string header = base::StringPrintf(
+      "%s: %d\r\n\r\n", kContentLength, static_cast<int>(message.size()));
+
+  // Only the first message of a batch posts a task, the others are sent with
+  // it in one write.
+  bool schedule_flush;
+  {
+    base::AutoLock auto_lock(output_lock_);
+    output_.append(header).append(message);
+    schedule_flush = !flush_scheduled_;
+    flush_scheduled_ = true;
+  }
+  if (schedule_flush)
+    thread_.message_loop_proxy()->PostTask(
+        FROM_HERE,
+        base::Bind(&NodeDebugger::FlushMessages, weak_factory_.GetWeakPtr()));
+}
+
+void NodeDebugger::FlushMessages() {
+  std::string output;
+  {
+    base::AutoLock auto_lock(output_lock_);
+    output.swap(output_);
+    flush_scheduled_ = false;
+  }
+  if (accepted_socket_ && !output.empty())
+    accepted_socket_->Send(output);
+}
+
+bool NodeDebugger::HandleProfilerCommand(const std::string& message) {
+  // Do not parse the messages of V8's own commands, which can be large.
+  if (message.find("CpuProfiling") == std::string::npos)
+    return false;
+
+  scoped_ptr<base::Value> value(base::JSONReader::Read(message));
+  base::DictionaryValue* dict;
+  std::string type, command;
+  if (!value || !value->GetAsDictionary(&dict) ||
+      !dict->GetString("type", &type) || type != "request" ||
+      !dict->GetString("command", &command))
+    return false;
+
+  int seq = 0;
+  dict->GetInteger("seq", &seq);
+  if (command == "startCpuProfiling") {
+    int interval = 0;
+    dict->GetInteger("arguments.samplingInterval", &interval);
+    content::BrowserThread::PostTask(
+        content::BrowserThread::UI, FROM_HERE,
+        base::Bind(&NodeDebugger::StartCpuProfiling,
+                   ui_weak_factory_.GetWeakPtr(), seq, interval));
+  } else if (command == "stopCpuProfiling") {
+    content::BrowserThread::PostTask(
+        content::BrowserThread::UI, FROM_HERE,
+        base::Bind(&NodeDebugger::StopCpuProfiling,
+                   ui_weak_factory_.GetWeakPtr(), seq));
+  } else {
+    return false;
   }
+  return true;
+}
+
+void NodeDebugger::StartCpuProfiling(int request_seq, int interval) {
+  DCHECK(content::BrowserThread::CurrentlyOn(content::BrowserThread::UI));
+  if (cpu_profiling_) {
+    SendResponse(request_seq, "startCpuProfiling", "Already profiling",
+                 scoped_ptr<base::Value>());
+    return;
+  }
+
+  v8::Locker locker(isolate_);
+  v8::HandleScope handle_scope(isolate_);
+  v8::CpuProfiler* profiler = isolate_->GetCpuProfiler();
+  // The interval is in microseconds, and can only be changed before starting.
+  if (interval > 0)
+    profiler->SetSamplingInterval(interval);
+  profiler->StartProfiling(
+      v8::String::NewFromUtf8(isolate_, kCpuProfileTitle), true);
+  cpu_profiling_ = true;
+  SendResponse(request_seq, "startCpuProfiling", std::string(),
+               scoped_ptr<base::Value>());
+}
+
+void NodeDebugger::StopCpuProfiling(int request_seq) {
+  DCHECK(content::BrowserThread::CurrentlyOn(content::BrowserThread::UI));
+  if (!cpu_profiling_) {
+    if (request_seq >= 0)
+      SendResponse(request_seq, "stopCpuProfiling", "Not profiling",
+                   scoped_ptr<base::Value>());
+    return;
+  }
+
+  cpu_profiling_ = false;
+  v8::Locker locker(isolate_);
+  v8::HandleScope handle_scope(isolate_);
+  v8::CpuProfile* profile = isolate_->GetCpuProfiler()->StopProfiling(
+      v8::String::NewFromUtf8(isolate_, kCpuProfileTitle));
+  if (!profile)
+    return;
+
+  scoped_ptr<base::Value> body;
+  if (request_seq >= 0)
+    body.reset(CpuProfileToValue(profile));
+  profile->Delete();
+  if (body)
+    SendResponse(request_seq, "stopCpuProfiling", std::string(), body.Pass());
+}
+
+void NodeDebugger::SendResponse(int request_seq,
+                                const std::string& command,
+                                const std::string& error,
+                                scoped_ptr<base::Value> body) {
+  scoped_ptr<base::DictionaryValue> response(new base::DictionaryValue);
+  response->SetInteger("seq", 0);
+  response->SetInteger("request_seq", request_seq);
+  response->SetString("type", "response");
+  response->SetString("command", command);
+  response->SetBoolean("success", error.empty());
+  response->SetBoolean("running", true);
+  if (!error.empty())
+    response->SetString("message", error);
+  if (body)
+    response->Set("body", body.release());
+
+  // Large profiles are serialized off the main thread.
+  scoped_ptr<base::Value> value(response.release());
+  thread_.message_loop_proxy()->PostTask(
+      FROM_HERE,
+      base::Bind(&NodeDebugger::SendValue, weak_factory_.GetWeakPtr(),
+                 base::Passed(&value)));
+}
+
+void NodeDebugger::SendValue(scoped_ptr<base::Value> value) {
+  std::string json;
+  base::JSONWriter::Write(value.get(), &json);
+  QueueMessage(json);
 }
 
 void NodeDebugger::SendConnectMessage() {
@@ -136,10 +331,7 @@ void NodeDebugger::DebugMessageHandler(const v8::Debug::Message& message) {
 
   if (self) {
     std::string message8(*v8::String::Utf8Value(message.GetJSON()));
-    self->thread_.message_loop()->PostTask(
-        FROM_HERE,
-        base::Bind(&NodeDebugger::SendMessage, self->weak_factory_.GetWeakPtr(),
-                   message8));
+    self->QueueMessage(message8);
   }
 }
 
@@ -160,38 +352,44 @@ void NodeDebugger::DidRead(net::StreamListenSocket* socket,
                            int len) {
   buffer_.append(data, len);
 
-  do {
-    if (buffer_.size() == 0)
-      return;
-
+  // The consumed data is only stripped once after parsing, so a large message
+  // arriving in many reads is not copied again for each of them.
+  size_t offset = 0;
+  while (offset < buffer_.size()) {
     // Read the "Content-Length" header.
     if (content_length_ < 0) {
-      size_t pos = buffer_.find("\r\n\r\n");
+      size_t pos = buffer_.find("\r\n\r\n", offset);
       if (pos == std::string::npos)
-        return;
+        break;
 
       // We can be sure that the header is "Content-Length: xxx\r\n".
-      std::string content_length = buffer_.substr(16, pos - 16);
-      if (!base::StringToInt(content_length, &content_length_)) {
+      std::string content_length;
+      if (pos - offset > 16)
+        content_length = buffer_.substr(offset + 16, pos - offset - 16);
+      if (!base::StringToInt(content_length, &content_length_) ||
+          content_length_ < 0) {
+        buffer_.clear();
+        content_length_ = -1;
         DidClose(accepted_socket_.get());
         return;
       }
 
-      // Strip header from buffer.
-      buffer_ = buffer_.substr(pos + 4);
+      offset = pos + 4;
+      buffer_.reserve(
+          offset + std::min(content_length_, kMaxReservedMessageSize));
     }
 
     // Read the message.
-    if (buffer_.size() >= static_cast<size_t>(content_length_)) {
-      std::string message = buffer_.substr(0, content_length_);
-      buffer_ = buffer_.substr(content_length_);
+    if (buffer_.size() - offset < static_cast<size_t>(content_length_))
+      break;
 
-      OnMessage(message);
+    OnMessage(buffer_.substr(offset, content_length_));
+    offset += content_length_;
 
-      // Get ready for next message.
-      content_length_ = -1;
-    }
-  } while (true);
+    // Get ready for next message.
+    content_length_ = -1;
+  }
+  buffer_.erase(0, offset);
 }
 
 void NodeDebugger::DidClose(net::StreamListenSocket* socket) {
@@ -9,13 +9,23 @@
 
 #include "base/memory/scoped_ptr.h"
 #include "base/memory/weak_ptr.h"
+#include "base/synchronization/lock.h"
 #include "base/threading/thread.h"
 #include "net/socket/stream_listen_socket.h"
 #include "v8/include/v8-debug.h"
 
+namespace base {
+class Value;
+}
+
 namespace atom {
 
 // Add support for node's "--debug" switch.
+//
+// The protocol is handled on a dedicated IO thread, the messages of V8 are
+// framed and queued from the thread they are generated on, and sent in one
+// write per batch. Besides V8's commands, the "startCpuProfiling" and
+// "stopCpuProfiling" commands run the sampling CPU profiler of V8.
 class NodeDebugger : public net::StreamListenSocket::Delegate {
  public:
   explicit NodeDebugger(v8::Isolate* isolate);
@@ -27,9 +37,24 @@ class NodeDebugger : public net::StreamListenSocket::Delegate {
   void StartServer(int port);
   void CloseSession();
   void OnMessage(const std::string& message);
-  void SendMessage(const std::string& message);
   void SendConnectMessage();
 
+  // Frames |message| and queues it for sending, can be called on any thread.
+  void QueueMessage(const std::string& message);
+  void FlushMessages();
+
+  // Handles the profiler commands by running the profiler on the main thread,
+  // returns false for the other commands.
+  bool HandleProfilerCommand(const std::string& message);
+  void StartCpuProfiling(int request_seq, int interval);
+  // The profile is dropped when |request_seq| is negative.
+  void StopCpuProfiling(int request_seq);
+  void SendResponse(int request_seq,
+                    const std::string& command,
+                    const std::string& error,
+                    scoped_ptr<base::Value> body);
+  void SendValue(scoped_ptr<base::Value> value);
+
   static void DebugMessageHandler(const v8::Debug::Message& message);
 
   // net::StreamListenSocket::Delegate:
@@ -49,6 +74,16 @@ class NodeDebugger : public net::StreamListenSocket::Delegate {
   std::string buffer_;
   int content_length_;
 
+  // The framed messages waiting to be sent by the IO thread.
+  base::Lock output_lock_;
+  std::string output_;
+  bool flush_scheduled_;
+
+  // Only accessed on the main thread.
+  bool cpu_profiling_;
+
+  // The weak pointers dereferenced on the main thread.
+  base::WeakPtrFactory<NodeDebugger> ui_weak_factory_;
   base::WeakPtrFactory<NodeDebugger> weak_factory_;
 
   DISALLOW_COPY_AND_ASSIGN(NodeDebugger);
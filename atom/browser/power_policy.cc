@@ -0,0 +1,69 @@
+// Copyright (c) 2015 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#include "atom/browser/power_policy.h"
+
+#include "atom/browser/native_window.h"
+#include "atom/browser/window_list.h"
+#include "atom/common/asar/asar_util.h"
+#include "atom/common/node_bindings.h"
+#include "base/power_monitor/power_monitor.h"
+#include "content/public/browser/browser_thread.h"
+
+using content::BrowserThread;
+
+namespace atom {
+
+PowerPolicy::Options::Options()
+    : throttle_background_windows(false),
+      pause_asar_prefetch(false) {
+}
+
+// static
+PowerPolicy* PowerPolicy::GetInstance() {
+  return Singleton<PowerPolicy, LeakySingletonTraits<PowerPolicy>>::get();
+}
+
+PowerPolicy::PowerPolicy()
+    : observing_(false),
+      on_battery_(false) {
+}
+
+PowerPolicy::~PowerPolicy() {
+}
+
+void PowerPolicy::SetOptions(const Options& options) {
+  DCHECK(BrowserThread::CurrentlyOn(BrowserThread::UI));
+  options_ = options;
+
+  // Nothing is watched until a policy is set.
+  base::PowerMonitor* power_monitor = base::PowerMonitor::Get();
+  if (!observing_ && power_monitor) {
+    observing_ = true;
+    power_monitor->AddObserver(this);
+    on_battery_ = power_monitor->IsOnBatteryPower();
+  }
+  Apply();
+}
+
+bool PowerPolicy::ShouldThrottleBackgroundWindows() const {
+  return on_battery_ && options_.throttle_background_windows;
+}
+
+void PowerPolicy::OnPowerStateChange(bool on_battery_power) {
+  on_battery_ = on_battery_power;
+  Apply();
+}
+
+void PowerPolicy::Apply() {
+  asar::SetAsarPrefetchPaused(on_battery_ && options_.pause_asar_prefetch);
+  NodeBindings::SetPowerPolicyTimerSlack(
+      on_battery_ ? options_.timer_slack : base::TimeDelta());
+
+  WindowList* window_list = WindowList::GetInstance();
+  for (NativeWindow* window : *window_list)
+    window->UpdateBackgroundThrottling();
+}
+
+}  // namespace atom
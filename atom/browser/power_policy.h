@@ -0,0 +1,58 @@
+// Copyright (c) 2015 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#ifndef ATOM_BROWSER_POWER_POLICY_H_
+#define ATOM_BROWSER_POWER_POLICY_H_
+
+#include "base/memory/singleton.h"
+#include "base/power_monitor/power_observer.h"
+#include "base/time/time.h"
+
+namespace atom {
+
+// Makes the framework itself save power while the system runs on battery, by
+// throttling background windows, pausing asar prefetching and lengthening the
+// timer slack of node. Should be used on UI thread.
+class PowerPolicy : public base::PowerObserver {
+ public:
+  struct Options {
+    Options();
+
+    // Windows that would run fully in background are throttled.
+    bool throttle_background_windows;
+    bool pause_asar_prefetch;
+    // Zero keeps the timer slack set by process.setTimerSlack.
+    base::TimeDelta timer_slack;
+  };
+
+  static PowerPolicy* GetInstance();
+
+  // Applies |options| whenever the system is on battery.
+  void SetOptions(const Options& options);
+
+  // Whether the background windows should be throttled now.
+  bool ShouldThrottleBackgroundWindows() const;
+
+ private:
+  friend struct DefaultSingletonTraits<PowerPolicy>;
+
+  PowerPolicy();
+  virtual ~PowerPolicy();
+
+  // base::PowerObserver:
+  void OnPowerStateChange(bool on_battery_power) override;
+
+  // Applies the options for the current power state.
+  void Apply();
+
+  Options options_;
+  bool observing_;
+  bool on_battery_;
+
+  DISALLOW_COPY_AND_ASSIGN(PowerPolicy);
+};
+
+}  // namespace atom
+
+#endif  // ATOM_BROWSER_POWER_POLICY_H_
@@ -0,0 +1,207 @@
+// Copyright (c) 2015 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#include "atom/browser/print_to_pdf_manager.h"
+
+#include <algorithm>
+
+#include "base/bind.h"
+#include "base/files/file_util.h"
+#include "base/memory/scoped_ptr.h"
+#include "base/stl_util.h"
+#include "base/strings/stringprintf.h"
+#include "base/task_runner_util.h"
+#include "base/threading/sequenced_worker_pool.h"
+#include "chrome/common/print_messages.h"
+#include "content/public/browser/browser_thread.h"
+#include "content/public/browser/render_view_host.h"
+#include "content/public/browser/web_contents.h"
+#include "printing/print_settings.h"
+#include "printing/units.h"
+
+DEFINE_WEB_CONTENTS_USER_DATA_KEY(atom::PrintToPDFManager);
+
+namespace atom {
+
+namespace {
+
+// The margins in points, the default one is close to what Chrome uses.
+const int kDefaultMarginInPoints = 28;  // 1cm.
+const int kMinimumMarginInPoints = 7;   // 0.25cm.
+
+// Builds the print params in points, which is the unit of PDF.
+PrintMsg_PrintPages_Params GetPrintParams(
+    const PrintToPDFManager::Settings& settings) {
+  gfx::Size paper(
+      printing::ConvertUnit(settings.page_size.width(),
+                            printing::kMicronsPerInch,
+                            printing::kPointsPerInch),
+      printing::ConvertUnit(settings.page_size.height(),
+                            printing::kMicronsPerInch,
+                            printing::kPointsPerInch));
+  if (settings.landscape)
+    paper.SetSize(paper.height(), paper.width());
+
+  int margin = 0;
+  if (settings.margins_type == printing::DEFAULT_MARGINS)
+    margin = kDefaultMarginInPoints;
+  else if (settings.margins_type == printing::PRINTABLE_AREA_MARGINS)
+    margin = kMinimumMarginInPoints;
+
+  PrintMsg_PrintPages_Params result;
+  PrintMsg_Print_Params& params = result.params;
+  params.page_size = paper;
+  params.content_size = gfx::Size(std::max(paper.width() - margin * 2, 1),
+                                  std::max(paper.height() - margin * 2, 1));
+  params.printable_area = gfx::Rect(paper);
+  params.margin_top = margin;
+  params.margin_left = margin;
+  params.dpi = printing::kPointsPerInch;
+  params.desired_dpi = printing::kPointsPerInch;
+  params.min_shrink = 1.25;
+  params.max_shrink = 2.0;
+  params.document_cookie = printing::PrintSettings::NewCookie();
+  params.selection_only = false;
+  params.supports_alpha_blend = true;
+  params.print_scaling_option = blink::WebPrintScalingOptionSourceSize;
+  params.should_print_backgrounds = settings.print_background;
+  result.pages = settings.pages;
+  return result;
+}
+
+// Runs on the blocking pool.
+bool WritePDF(scoped_ptr<base::SharedMemory> data,
+              uint32 data_size,
+              const base::FilePath& path) {
+  int size = static_cast<int>(data_size);
+  return base::WriteFile(path, static_cast<const char*>(data->memory()),
+                         size) == size;
+}
+
+}  // namespace
+
+PrintToPDFManager::Settings::Settings()
+    : page_size(210000, 297000),  // A4.
+      margins_type(printing::DEFAULT_MARGINS),
+      landscape(false),
+      print_background(false),
+      pages_per_file(0) {
+}
+
+PrintToPDFManager::Settings::~Settings() {
+}
+
+PrintToPDFManager::Request::Request()
+    : split(false),
+      pending_writes(0),
+      received_last(false) {
+}
+
+PrintToPDFManager::Request::~Request() {
+}
+
+PrintToPDFManager::PrintToPDFManager(content::WebContents* web_contents)
+    : content::WebContentsObserver(web_contents),
+      next_request_id_(0),
+      weak_factory_(this) {
+}
+
+PrintToPDFManager::~PrintToPDFManager() {
+}
+
+void PrintToPDFManager::PrintToPDF(const Settings& settings,
+                                   const base::FilePath& path,
+                                   const PrintToPDFCallback& callback) {
+  content::RenderViewHost* rvh = web_contents()->GetRenderViewHost();
+  if (!rvh || !rvh->IsRenderViewLive()) {
+    callback.Run(false, std::vector<base::FilePath>());
+    return;
+  }
+
+  int request_id = next_request_id_++;
+  Request& request = requests_[request_id];
+  request.path = path;
+  request.split = settings.pages_per_file > 0;
+  request.callback = callback;
+  rvh->Send(new PrintMsg_PrintToPDF(rvh->GetRoutingID(), request_id,
+                                    GetPrintParams(settings),
+                                    settings.pages_per_file));
+}
+
+bool PrintToPDFManager::OnMessageReceived(const IPC::Message& message) {
+  bool handled = true;
+  IPC_BEGIN_MESSAGE_MAP(PrintToPDFManager, message)
+    IPC_MESSAGE_HANDLER(PrintHostMsg_DidPrintToPDF, OnDidPrintToPDF)
+    IPC_MESSAGE_UNHANDLED(handled = false)
+  IPC_END_MESSAGE_MAP()
+  return handled;
+}
+
+void PrintToPDFManager::RenderProcessGone(base::TerminationStatus status) {
+  // The pending requests would never be answered.
+  std::map<int, Request> requests;
+  requests.swap(requests_);
+  for (const auto& request : requests)
+    request.second.callback.Run(false, std::vector<base::FilePath>());
+}
+
+void PrintToPDFManager::OnDidPrintToPDF(int request_id,
+                                        base::SharedMemoryHandle handle,
+                                        uint32 data_size,
+                                        bool is_last) {
+  scoped_ptr<base::SharedMemory> data(new base::SharedMemory(handle, true));
+  std::map<int, Request>::iterator iter = requests_.find(request_id);
+  if (iter == requests_.end() || iter->second.received_last)
+    return;
+
+  Request& request = iter->second;
+  request.received_last = is_last;
+  if (data_size == 0 || !data->Map(data_size) ||
+      (!request.split && !request.files.empty())) {
+    FinishRequest(request_id, false);
+    return;
+  }
+
+  base::FilePath path = request.path;
+  if (request.split)
+    path = path.InsertBeforeExtensionASCII(
+        base::StringPrintf("-%d", static_cast<int>(request.files.size()) + 1));
+  request.files.push_back(path);
+  ++request.pending_writes;
+
+  base::PostTaskAndReplyWithResult(
+      content::BrowserThread::GetBlockingPool()->
+          GetTaskRunnerWithShutdownBehavior(
+              base::SequencedWorkerPool::CONTINUE_ON_SHUTDOWN).get(),
+      FROM_HERE,
+      base::Bind(&WritePDF, base::Passed(&data), data_size, path),
+      base::Bind(&PrintToPDFManager::OnPDFWritten,
+                 weak_factory_.GetWeakPtr(), request_id));
+}
+
+void PrintToPDFManager::OnPDFWritten(int request_id, bool success) {
+  std::map<int, Request>::iterator iter = requests_.find(request_id);
+  if (iter == requests_.end())
+    return;
+
+  // The files of a failed request are not waited for.
+  --iter->second.pending_writes;
+  if (!success)
+    FinishRequest(request_id, false);
+  else if (iter->second.received_last && iter->second.pending_writes == 0)
+    FinishRequest(request_id, true);
+}
+
+void PrintToPDFManager::FinishRequest(int request_id, bool success) {
+  std::map<int, Request>::iterator iter = requests_.find(request_id);
+  if (iter == requests_.end())
+    return;
+  PrintToPDFCallback callback = iter->second.callback;
+  std::vector<base::FilePath> files;
+  files.swap(iter->second.files);
+  requests_.erase(iter);
+  callback.Run(success, files);
+}
+
+}  // namespace atom
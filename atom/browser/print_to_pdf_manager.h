@@ -0,0 +1,100 @@
+// Copyright (c) 2015 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#ifndef ATOM_BROWSER_PRINT_TO_PDF_MANAGER_H_
+#define ATOM_BROWSER_PRINT_TO_PDF_MANAGER_H_
+
+#include <map>
+#include <vector>
+
+#include "base/callback.h"
+#include "base/files/file_path.h"
+#include "base/memory/shared_memory.h"
+#include "base/memory/weak_ptr.h"
+#include "content/public/browser/web_contents_observer.h"
+#include "content/public/browser/web_contents_user_data.h"
+#include "printing/print_job_constants.h"
+#include "ui/gfx/geometry/size.h"
+
+namespace atom {
+
+// Prints the page of a WebContents into a PDF file without showing any dialog
+// or going through a printer. The renderer lays out the pages into one PDF,
+// which is then written to the file on the blocking pool, so neither the UI
+// thread nor the PrintJob machinery is involved with the data.
+//
+// When |pages_per_file| is set the document is streamed instead: every
+// |pages_per_file| pages are written into their own file as soon as the
+// renderer sends them, so only a few pages are ever kept in memory.
+class PrintToPDFManager
+    : public content::WebContentsObserver,
+      public content::WebContentsUserData<PrintToPDFManager> {
+ public:
+  struct Settings {
+    Settings();
+    ~Settings();
+
+    // The size of paper in microns.
+    gfx::Size page_size;
+    printing::MarginType margins_type;
+    bool landscape;
+    bool print_background;
+    // The zero-based page numbers to print, empty for all pages.
+    std::vector<int> pages;
+    // Splits the output into files of this many pages, 0 for one file.
+    int pages_per_file;
+  };
+
+  typedef base::Callback<void(bool success,
+                              const std::vector<base::FilePath>& files)>
+      PrintToPDFCallback;
+
+  virtual ~PrintToPDFManager();
+
+  // Prints the page into |path|, |callback| is called on UI thread with the
+  // written files when all of them are written or printing failed. When the
+  // output is split the files are named like "path-1.pdf", "path-2.pdf".
+  void PrintToPDF(const Settings& settings,
+                  const base::FilePath& path,
+                  const PrintToPDFCallback& callback);
+
+  // content::WebContentsObserver:
+  bool OnMessageReceived(const IPC::Message& message) override;
+  void RenderProcessGone(base::TerminationStatus status) override;
+
+ private:
+  explicit PrintToPDFManager(content::WebContents* web_contents);
+  friend class content::WebContentsUserData<PrintToPDFManager>;
+
+  struct Request {
+    Request();
+    ~Request();
+
+    base::FilePath path;
+    bool split;
+    PrintToPDFCallback callback;
+    std::vector<base::FilePath> files;
+    // The files still being written, and whether the last one was received.
+    int pending_writes;
+    bool received_last;
+  };
+
+  void OnDidPrintToPDF(int request_id,
+                       base::SharedMemoryHandle handle,
+                       uint32 data_size,
+                       bool is_last);
+  void OnPDFWritten(int request_id, bool success);
+  void FinishRequest(int request_id, bool success);
+
+  int next_request_id_;
+  std::map<int, Request> requests_;
+
+  base::WeakPtrFactory<PrintToPDFManager> weak_factory_;
+
+  DISALLOW_COPY_AND_ASSIGN(PrintToPDFManager);
+};
+
+}  // namespace atom
+
+#endif  // ATOM_BROWSER_PRINT_TO_PDF_MANAGER_H_
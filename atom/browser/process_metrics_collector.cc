@@ -0,0 +1,250 @@
+// Copyright (c) 2015 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#include "atom/browser/process_metrics_collector.h"
+
+#include "atom/browser/web_view_manager.h"
+#include "atom/common/api/api_messages.h"
+#include "base/bind.h"
+#include "base/message_loop/message_loop.h"
+#include "base/task_runner_util.h"
+#include "content/public/browser/browser_child_process_host.h"
+#include "content/public/browser/browser_message_filter.h"
+#include "content/public/browser/browser_thread.h"
+#include "content/public/browser/render_process_host.h"
+
+using content::BrowserThread;
+
+namespace atom {
+
+namespace {
+
+// How long to wait for the renderers to send their V8 heap statistics, hung
+// renderers are reported without them.
+const int kHeapStatsTimeoutMs = 1000;
+
+class V8HeapStatsMessageFilter : public content::BrowserMessageFilter {
+ public:
+  explicit V8HeapStatsMessageFilter(int render_process_id)
+      : BrowserMessageFilter(ShellMsgStart),
+        render_process_id_(render_process_id) {
+  }
+
+  // content::BrowserMessageFilter:
+  void OverrideThreadForMessage(const IPC::Message& message,
+                                BrowserThread::ID* thread) override {
+    if (message.type() == AtomHostMsg_V8HeapStats::ID)
+      *thread = BrowserThread::UI;
+  }
+
+  bool OnMessageReceived(const IPC::Message& message) override {
+    bool handled = true;
+    IPC_BEGIN_MESSAGE_MAP(V8HeapStatsMessageFilter, message)
+      IPC_MESSAGE_HANDLER(AtomHostMsg_V8HeapStats, OnV8HeapStats)
+      IPC_MESSAGE_UNHANDLED(handled = false)
+    IPC_END_MESSAGE_MAP()
+    return handled;
+  }
+
+ private:
+  virtual ~V8HeapStatsMessageFilter() {}
+
+  void OnV8HeapStats(int request_id, uint64 used, uint64 total) {
+    ProcessMetricsCollector::GetInstance()->OnV8HeapStats(
+        render_process_id_, request_id, used, total);
+  }
+
+  int render_process_id_;
+
+  DISALLOW_COPY_AND_ASSIGN(V8HeapStatsMessageFilter);
+};
+
+}  // namespace
+
+ProcessMetricsCollector::Metrics::Metrics()
+    : process_id(-1),
+      pid(base::kNullProcessId),
+      guest_instance_id(-1),
+      working_set_size(0),
+      private_bytes(0),
+      cpu_usage(0),
+      has_heap_stats(false),
+      heap_used(0),
+      heap_total(0) {
+}
+
+ProcessMetricsCollector::Request::Request()
+    : sampled(false),
+      timed_out(false) {
+}
+
+ProcessMetricsCollector::Request::~Request() {
+}
+
+// static
+ProcessMetricsCollector* ProcessMetricsCollector::GetInstance() {
+  return Singleton<ProcessMetricsCollector,
+                   LeakySingletonTraits<ProcessMetricsCollector>>::get();
+}
+
+// static
+content::BrowserMessageFilter* ProcessMetricsCollector::CreateMessageFilter(
+    int render_process_id) {
+  return new V8HeapStatsMessageFilter(render_process_id);
+}
+
+ProcessMetricsCollector::ProcessMetricsCollector()
+    : next_request_id_(0),
+      weak_factory_(this) {
+}
+
+ProcessMetricsCollector::~ProcessMetricsCollector() {
+}
+
+void ProcessMetricsCollector::Collect(const MetricsCallback& callback) {
+  DCHECK(BrowserThread::CurrentlyOn(BrowserThread::UI));
+
+  int request_id = next_request_id_++;
+  linked_ptr<Request> request(new Request);
+  request->callback = callback;
+
+  std::vector<base::ProcessHandle> handles;
+  for (content::RenderProcessHost::iterator it(
+           content::RenderProcessHost::AllHostsIterator());
+       !it.IsAtEnd(); it.Advance()) {
+    content::RenderProcessHost* host = it.GetCurrentValue();
+    base::ProcessHandle handle = host->GetHandle();
+    if (handle == base::kNullProcessHandle)
+      continue;
+
+    Metrics metrics;
+    metrics.process_id = host->GetID();
+    metrics.pid = base::GetProcId(handle);
+    WebViewManager::WebViewInfo info;
+    if (WebViewManager::GetInfoForProcess(host, &info))
+      metrics.guest_instance_id = info.guest_instance_id;
+    request->metrics.push_back(metrics);
+
+    handles.push_back(handle);
+    if (host->Send(new AtomMsg_GetV8HeapStats(request_id)))
+      request->pending_heap_stats.insert(metrics.process_id);
+  }
+  requests_[request_id] = request;
+
+  // Reading the usage may touch the file system on some platforms.
+  base::PostTaskAndReplyWithResult(
+      BrowserThread::GetMessageLoopProxyForThread(BrowserThread::FILE).get(),
+      FROM_HERE,
+      base::Bind(&ProcessMetricsCollector::SampleOnFileThread,
+                 base::Unretained(this), handles),
+      base::Bind(&ProcessMetricsCollector::OnSampled,
+                 weak_factory_.GetWeakPtr(), request_id));
+
+  base::MessageLoop::current()->PostDelayedTask(
+      FROM_HERE,
+      base::Bind(&ProcessMetricsCollector::OnTimeout,
+                 weak_factory_.GetWeakPtr(), request_id),
+      base::TimeDelta::FromMilliseconds(kHeapStatsTimeoutMs));
+}
+
+void ProcessMetricsCollector::OnV8HeapStats(int process_id,
+                                            int request_id,
+                                            uint64 used,
+                                            uint64 total) {
+  DCHECK(BrowserThread::CurrentlyOn(BrowserThread::UI));
+  auto it = requests_.find(request_id);
+  if (it == requests_.end())
+    return;
+
+  Request* request = it->second.get();
+  if (request->pending_heap_stats.erase(process_id) == 0)
+    return;
+  for (Metrics& metrics : request->metrics) {
+    if (metrics.process_id == process_id) {
+      metrics.has_heap_stats = true;
+      metrics.heap_used = used;
+      metrics.heap_total = total;
+    }
+  }
+  MaybeFinish(request_id);
+}
+
+std::vector<ProcessMetricsCollector::Sample>
+ProcessMetricsCollector::SampleOnFileThread(
+    const std::vector<base::ProcessHandle>& handles) {
+  DCHECK(BrowserThread::CurrentlyOn(BrowserThread::FILE));
+
+  // Forget the processes that have gone.
+  std::map<base::ProcessHandle, linked_ptr<base::ProcessMetrics>> alive;
+  std::vector<Sample> samples;
+  for (base::ProcessHandle handle : handles) {
+    auto it = process_metrics_.find(handle);
+    linked_ptr<base::ProcessMetrics> process_metrics;
+    if (it != process_metrics_.end()) {
+      process_metrics = it->second;
+    } else {
+#if defined(OS_MACOSX)
+      process_metrics.reset(base::ProcessMetrics::CreateProcessMetrics(
+          handle, content::BrowserChildProcessHost::GetPortProvider()));
+#else
+      process_metrics.reset(
+          base::ProcessMetrics::CreateProcessMetrics(handle));
+#endif
+    }
+    alive[handle] = process_metrics;
+
+    Sample sample;
+    sample.working_set_size = process_metrics->GetWorkingSetSize();
+    size_t shared_bytes;
+    if (!process_metrics->GetMemoryBytes(&sample.private_bytes, &shared_bytes))
+      sample.private_bytes = 0;
+    sample.cpu_usage = process_metrics->GetCPUUsage();
+    samples.push_back(sample);
+  }
+  process_metrics_.swap(alive);
+  return samples;
+}
+
+void ProcessMetricsCollector::OnSampled(int request_id,
+                                        const std::vector<Sample>& samples) {
+  auto it = requests_.find(request_id);
+  if (it == requests_.end())
+    return;
+
+  Request* request = it->second.get();
+  DCHECK_EQ(request->metrics.size(), samples.size());
+  for (size_t i = 0; i < samples.size(); ++i) {
+    request->metrics[i].working_set_size = samples[i].working_set_size;
+    request->metrics[i].private_bytes = samples[i].private_bytes;
+    request->metrics[i].cpu_usage = samples[i].cpu_usage;
+  }
+  request->sampled = true;
+  MaybeFinish(request_id);
+}
+
+void ProcessMetricsCollector::OnTimeout(int request_id) {
+  auto it = requests_.find(request_id);
+  if (it == requests_.end())
+    return;
+
+  it->second->timed_out = true;
+  MaybeFinish(request_id);
+}
+
+void ProcessMetricsCollector::MaybeFinish(int request_id) {
+  auto it = requests_.find(request_id);
+  if (it == requests_.end())
+    return;
+
+  // Only the heap statistics are given up on timeout, sampling never hangs.
+  linked_ptr<Request> request = it->second;
+  if (!request->sampled ||
+      (!request->timed_out && !request->pending_heap_stats.empty()))
+    return;
+
+  requests_.erase(it);
+  request->callback.Run(request->metrics);
+}
+
+}  // namespace atom
@@ -0,0 +1,115 @@
+// Copyright (c) 2015 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#ifndef ATOM_BROWSER_PROCESS_METRICS_COLLECTOR_H_
+#define ATOM_BROWSER_PROCESS_METRICS_COLLECTOR_H_
+
+#include <map>
+#include <set>
+#include <vector>
+
+#include "base/callback.h"
+#include "base/memory/linked_ptr.h"
+#include "base/memory/singleton.h"
+#include "base/memory/weak_ptr.h"
+#include "base/process/process_handle.h"
+#include "base/process/process_metrics.h"
+
+namespace content {
+class BrowserMessageFilter;
+}
+
+namespace atom {
+
+// Samples the memory and CPU usage of the render processes, together with the
+// statistics of their V8 heaps. Should be used on UI thread.
+class ProcessMetricsCollector {
+ public:
+  struct Metrics {
+    Metrics();
+
+    // The ID of RenderProcessHost.
+    int process_id;
+    base::ProcessId pid;
+    // The <webview> hosted by the process, -1 for others.
+    int guest_instance_id;
+
+    size_t working_set_size;
+    size_t private_bytes;
+    // Percentage of one CPU used since the last collection, 0 on the first.
+    double cpu_usage;
+
+    // Only set when the renderer replied in time.
+    bool has_heap_stats;
+    uint64 heap_used;
+    uint64 heap_total;
+  };
+
+  typedef base::Callback<void(const std::vector<Metrics>&)> MetricsCallback;
+
+  static ProcessMetricsCollector* GetInstance();
+
+  // Creates the filter receiving the V8 heap statistics of a render process.
+  static content::BrowserMessageFilter* CreateMessageFilter(
+      int render_process_id);
+
+  // Collects the metrics of all render processes and runs |callback| with
+  // them.
+  void Collect(const MetricsCallback& callback);
+
+  // Called by the message filter of |process_id| on UI thread.
+  void OnV8HeapStats(int process_id, int request_id, uint64 used,
+                     uint64 total);
+
+ private:
+  friend struct DefaultSingletonTraits<ProcessMetricsCollector>;
+
+  struct Request {
+    Request();
+    ~Request();
+
+    MetricsCallback callback;
+    std::vector<Metrics> metrics;
+    std::set<int> pending_heap_stats;
+    bool sampled;
+    bool timed_out;
+  };
+
+  // The memory and CPU usage of a process.
+  struct Sample {
+    size_t working_set_size;
+    size_t private_bytes;
+    double cpu_usage;
+  };
+
+  ProcessMetricsCollector();
+  ~ProcessMetricsCollector();
+
+  // Samples |handles| on FILE thread, the ProcessMetrics are kept between
+  // collections so the CPU usage can be computed.
+  std::vector<Sample> SampleOnFileThread(
+      const std::vector<base::ProcessHandle>& handles);
+
+  void OnSampled(int request_id, const std::vector<Sample>& samples);
+  void OnTimeout(int request_id);
+
+  // Runs the callback of |request_id| if it has got everything, or has waited
+  // long enough for the heap statistics.
+  void MaybeFinish(int request_id);
+
+  int next_request_id_;
+  std::map<int, linked_ptr<Request>> requests_;
+
+  // Only accessed on FILE thread.
+  std::map<base::ProcessHandle, linked_ptr<base::ProcessMetrics>>
+      process_metrics_;
+
+  base::WeakPtrFactory<ProcessMetricsCollector> weak_factory_;
+
+  DISALLOW_COPY_AND_ASSIGN(ProcessMetricsCollector);
+};
+
+}  // namespace atom
+
+#endif  // ATOM_BROWSER_PROCESS_METRICS_COLLECTOR_H_
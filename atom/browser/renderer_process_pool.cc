@@ -0,0 +1,191 @@
+// Copyright (c) 2015 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#include "atom/browser/renderer_process_pool.h"
+
+#include "atom/browser/atom_browser_context.h"
+#include "atom/browser/native_window.h"
+#include "atom/common/options_switches.h"
+#include "base/bind.h"
+#include "base/memory/singleton.h"
+#include "base/message_loop/message_loop.h"
+#include "content/public/browser/browser_thread.h"
+#include "content/public/browser/render_process_host.h"
+#include "content/public/browser/site_instance.h"
+#include "content/public/browser/web_contents.h"
+
+using content::BrowserThread;
+
+namespace atom {
+
+namespace {
+
+// Wait a while before starting a spare, so it does not compete with the
+// windows being opened.
+const int kRefillDelayMs = 1000;
+
+base::CommandLine::SwitchMap GetSwitchesForWindow(NativeWindow* window) {
+  base::CommandLine command_line(base::CommandLine::NO_PROGRAM);
+  window->AppendExtraCommandLineSwitches(
+      &command_line,
+      window->GetWebContents()->GetRenderProcessHost()->GetID());
+  return command_line.GetSwitches();
+}
+
+}  // namespace
+
+// static
+RendererProcessPool* RendererProcessPool::GetInstance() {
+  return Singleton<RendererProcessPool>::get();
+}
+
+RendererProcessPool::RendererProcessPool()
+    : size_(0),
+      has_switches_(false),
+      refill_scheduled_(false),
+      weak_factory_(this) {
+}
+
+RendererProcessPool::~RendererProcessPool() {
+}
+
+void RendererProcessPool::SetSize(size_t size) {
+  DCHECK(BrowserThread::CurrentlyOn(BrowserThread::UI));
+  size_ = size;
+  while (spares_.size() > size_)
+    RemoveSpare(spares_.back().site_instance->GetProcess(), true);
+  ScheduleRefill();
+}
+
+void RendererProcessPool::ReserveProcessForWindow(NativeWindow* window) {
+  DCHECK(BrowserThread::CurrentlyOn(BrowserThread::UI));
+  if (size_ == 0 || !window->GetWebContents())
+    return;
+
+  base::CommandLine::SwitchMap switches = GetSwitchesForWindow(window);
+  if (!has_switches_ || switches != switches_) {
+    // The spares can not be used by this kind of windows, start the ones that
+    // can instead.
+    switches_ = switches;
+    has_switches_ = true;
+    while (!spares_.empty())
+      RemoveSpare(spares_.front().site_instance->GetProcess(), true);
+    ScheduleRefill();
+    return;
+  }
+
+  if (spares_.empty())
+    return;
+
+  Spare& spare = spares_.front();
+  spare.site_instance->GetProcess()->RemoveObserver(this);
+  reserved_ = spare.site_instance;
+  spares_.pop_front();
+  ScheduleRefill();
+}
+
+bool RendererProcessPool::IsSuitableHost(
+    content::RenderProcessHost* host) const {
+  if (reserved_.get())
+    return host == reserved_->GetProcess();
+
+  // The spares should only be used by the windows they are reserved for.
+  for (const Spare& spare : spares_)
+    if (spare.site_instance->GetProcess() == host)
+      return false;
+  return true;
+}
+
+bool RendererProcessPool::SiteInstanceGotProcess(
+    content::SiteInstance* site_instance) {
+  if (!reserved_.get())
+    return false;
+
+  // The reserved process might not be picked, it would never be used then.
+  content::RenderProcessHost* host = reserved_->GetProcess();
+  reserved_ = nullptr;
+  if (site_instance->GetProcess() == host)
+    return true;
+  host->Cleanup();
+  return false;
+}
+
+bool RendererProcessPool::AppendExtraCommandLineSwitches(
+    base::CommandLine* command_line,
+    int child_process_id) {
+  for (const Spare& spare : spares_) {
+    if (spare.site_instance->GetProcess()->GetID() != child_process_id)
+      continue;
+
+    for (const auto& pair : spare.switches)
+      command_line->AppendSwitchNative(pair.first, pair.second);
+    command_line->AppendSwitch(switches::kPrewarmedRenderer);
+    return true;
+  }
+  return false;
+}
+
+void RendererProcessPool::RenderProcessExited(
+    content::RenderProcessHost* host,
+    base::ProcessHandle handle,
+    base::TerminationStatus status,
+    int exit_code) {
+  RemoveSpare(host, false);
+  ScheduleRefill();
+}
+
+void RendererProcessPool::RenderProcessHostDestroyed(
+    content::RenderProcessHost* host) {
+  RemoveSpare(host, false);
+}
+
+void RendererProcessPool::ScheduleRefill() {
+  if (refill_scheduled_ || !has_switches_ || spares_.size() >= size_)
+    return;
+
+  refill_scheduled_ = true;
+  base::MessageLoop::current()->PostDelayedTask(
+      FROM_HERE,
+      base::Bind(&RendererProcessPool::Refill, weak_factory_.GetWeakPtr()),
+      base::TimeDelta::FromMilliseconds(kRefillDelayMs));
+}
+
+void RendererProcessPool::Refill() {
+  refill_scheduled_ = false;
+  if (!has_switches_ || spares_.size() >= size_)
+    return;
+
+  Spare spare;
+  spare.site_instance =
+      content::SiteInstance::Create(AtomBrowserContext::Get());
+  spare.switches = switches_;
+  spares_.push_back(spare);
+
+  // The switches are appended by AtomBrowserClient when the process launches,
+  // so the spare must be in the pool before it is initialized.
+  content::RenderProcessHost* host = spare.site_instance->GetProcess();
+  host->AddObserver(this);
+  if (!host->Init()) {
+    RemoveSpare(host, true);
+    return;
+  }
+
+  ScheduleRefill();
+}
+
+void RendererProcessPool::RemoveSpare(content::RenderProcessHost* host,
+                                      bool shutdown) {
+  for (auto iter = spares_.begin(); iter != spares_.end(); ++iter) {
+    if (iter->site_instance->GetProcess() != host)
+      continue;
+
+    host->RemoveObserver(this);
+    spares_.erase(iter);
+    if (shutdown)
+      host->Cleanup();
+    return;
+  }
+}
+
+}  // namespace atom
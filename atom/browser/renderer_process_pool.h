@@ -0,0 +1,101 @@
+// Copyright (c) 2015 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#ifndef ATOM_BROWSER_RENDERER_PROCESS_POOL_H_
+#define ATOM_BROWSER_RENDERER_PROCESS_POOL_H_
+
+#include <deque>
+
+#include "base/command_line.h"
+#include "base/memory/ref_counted.h"
+#include "base/memory/weak_ptr.h"
+#include "content/public/browser/render_process_host_observer.h"
+
+template <typename T> struct DefaultSingletonTraits;
+
+namespace content {
+class SiteInstance;
+}
+
+namespace atom {
+
+class NativeWindow;
+
+// Keeps renderer processes started and initialized in advance, so the first
+// navigation of a window can use one of them instead of waiting for a new
+// renderer to boot.
+//
+// Renderers get the switches of their windows when they are launched, so a
+// spare process can only be used by windows with the same switches. The pool
+// is filled with spares for the switches of the last window that asked for
+// one, which matches apps that open many similar windows.
+//
+// All methods should be called on UI thread.
+class RendererProcessPool : public content::RenderProcessHostObserver {
+ public:
+  static RendererProcessPool* GetInstance();
+
+  // Sets the number of spare processes to keep, 0 disables the pool.
+  void SetSize(size_t size);
+  size_t size() const { return size_; }
+
+  // Called before |window| navigates to a new renderer process, reserves a
+  // spare with matching switches if there is one.
+  void ReserveProcessForWindow(NativeWindow* window);
+
+  // Site instance selection of AtomBrowserClient. While a process is reserved
+  // the next site instance is forced to use it.
+  bool ShouldUseReservedProcess() const { return reserved_.get() != nullptr; }
+  bool IsSuitableHost(content::RenderProcessHost* host) const;
+  // Returns true if |site_instance| got the reserved process.
+  bool SiteInstanceGotProcess(content::SiteInstance* site_instance);
+
+  // Appends the switches of a spare process when it is being launched, returns
+  // false if |child_process_id| is not a spare.
+  bool AppendExtraCommandLineSwitches(base::CommandLine* command_line,
+                                      int child_process_id);
+
+  // content::RenderProcessHostObserver:
+  void RenderProcessExited(content::RenderProcessHost* host,
+                           base::ProcessHandle handle,
+                           base::TerminationStatus status,
+                           int exit_code) override;
+  void RenderProcessHostDestroyed(content::RenderProcessHost* host) override;
+
+ private:
+  friend struct DefaultSingletonTraits<RendererProcessPool>;
+
+  RendererProcessPool();
+  ~RendererProcessPool() override;
+
+  struct Spare {
+    scoped_refptr<content::SiteInstance> site_instance;
+    base::CommandLine::SwitchMap switches;
+  };
+
+  // Starts spare processes until there are |size_| of them, one at a time so
+  // the windows being opened are not slowed down.
+  void ScheduleRefill();
+  void Refill();
+
+  void RemoveSpare(content::RenderProcessHost* host, bool shutdown);
+
+  size_t size_;
+
+  // The switches of the spares to start.
+  base::CommandLine::SwitchMap switches_;
+  bool has_switches_;
+
+  std::deque<Spare> spares_;
+  scoped_refptr<content::SiteInstance> reserved_;
+  bool refill_scheduled_;
+
+  base::WeakPtrFactory<RendererProcessPool> weak_factory_;
+
+  DISALLOW_COPY_AND_ASSIGN(RendererProcessPool);
+};
+
+}  // namespace atom
+
+#endif  // ATOM_BROWSER_RENDERER_PROCESS_POOL_H_
@@ -0,0 +1,108 @@
+// Copyright (c) 2015 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#include "atom/browser/script_worker.h"
+
+#include <vector>
+
+#include "atom/common/native_mate_converters/v8_value_serializer.h"
+#include "base/bind.h"
+
+using content::BrowserThread;
+
+namespace atom {
+
+ScriptWorker::ScriptWorker(const base::FilePath& script,
+                           const MessageCallback& message_callback,
+                           const ErrorCallback& error_callback)
+    : message_callback_(message_callback),
+      error_callback_(error_callback),
+      host_("ScriptWorker_" + script.BaseName().AsUTF8Unsafe(), script, true,
+            this),
+      started_(false),
+      terminated_(false) {
+}
+
+ScriptWorker::~ScriptWorker() {
+  Terminate();
+}
+
+bool ScriptWorker::Start() {
+  DCHECK(BrowserThread::CurrentlyOn(BrowserThread::UI));
+  started_ = host_.Start();
+  return started_;
+}
+
+void ScriptWorker::PostMessage(scoped_ptr<SerializedValue> args) {
+  DCHECK(BrowserThread::CurrentlyOn(BrowserThread::UI));
+  if (terminated_ || !started_)
+    return;
+  host_.PostTask(base::Bind(&ScriptWorker::HandleMessageOnWorkerThread,
+                            this, base::Passed(&args)));
+}
+
+void ScriptWorker::Terminate() {
+  DCHECK(BrowserThread::CurrentlyOn(BrowserThread::UI));
+  terminated_ = true;
+  host_.Stop();
+}
+
+void ScriptWorker::SetUpGlobal(v8::Isolate* isolate,
+                               v8::Local<v8::Object> global) {
+  v8::Local<v8::FunctionTemplate> post_message = v8::FunctionTemplate::New(
+      isolate, &ScriptWorker::PostMessageToUI,
+      v8::External::New(isolate, this));
+  global->Set(v8::String::NewFromUtf8(isolate, "postMessage"),
+              post_message->GetFunction());
+}
+
+void ScriptWorker::OnScriptError(const std::string& message) {
+  BrowserThread::PostTask(
+      BrowserThread::UI, FROM_HERE,
+      base::Bind(&ScriptWorker::RunErrorCallback, this, message));
+}
+
+void ScriptWorker::HandleMessageOnWorkerThread(
+    scoped_ptr<SerializedValue> args) {
+  WorkerHost::Scope scope(&host_);
+  // Looked up for each message, the script may define it asynchronously.
+  v8::Local<v8::Function> onmessage = host_.GetFunction("onmessage");
+  if (onmessage.IsEmpty())
+    return;
+
+  std::vector<v8::Local<v8::Value>> argv;
+  if (host_.DeserializeArguments(*args, &argv))
+    host_.Call(onmessage, argv);
+}
+
+void ScriptWorker::RunMessageCallback(scoped_ptr<SerializedValue> args) {
+  if (!terminated_)
+    message_callback_.Run(args.Pass());
+}
+
+void ScriptWorker::RunErrorCallback(const std::string& message) {
+  if (!terminated_)
+    error_callback_.Run(message);
+}
+
+// static
+void ScriptWorker::PostMessageToUI(
+    const v8::FunctionCallbackInfo<v8::Value>& info) {
+  v8::Isolate* isolate = info.GetIsolate();
+  ScriptWorker* self = static_cast<ScriptWorker*>(
+      v8::Local<v8::External>::Cast(info.Data())->Value());
+
+  v8::Local<v8::Array> array = v8::Array::New(isolate, info.Length());
+  for (int i = 0; i < info.Length(); ++i)
+    array->Set(i, info[i]);
+
+  scoped_ptr<SerializedValue> args(new SerializedValue);
+  SerializeV8Value(isolate, array, args.get());
+  BrowserThread::PostTask(
+      BrowserThread::UI, FROM_HERE,
+      base::Bind(&ScriptWorker::RunMessageCallback, self,
+                 base::Passed(&args)));
+}
+
+}  // namespace atom
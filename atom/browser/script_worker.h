@@ -0,0 +1,82 @@
+// Copyright (c) 2015 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#ifndef ATOM_BROWSER_SCRIPT_WORKER_H_
+#define ATOM_BROWSER_SCRIPT_WORKER_H_
+
+#include <string>
+
+#include "atom/browser/worker_host.h"
+#include "base/callback.h"
+#include "base/files/file_path.h"
+#include "base/memory/ref_counted.h"
+#include "base/memory/scoped_ptr.h"
+#include "content/public/browser/browser_thread.h"
+#include "v8/include/v8.h"
+
+namespace atom {
+
+class SerializedValue;
+
+// Runs a script on its own thread with its own V8 isolate, so CPU bound work
+// does not block the UI thread. The script runs in a Node environment of its
+// own, it defines the global |onmessage| function and talks back with the
+// global |postMessage| function, both taking any number of arguments.
+class ScriptWorker : public base::RefCountedThreadSafe<
+                         ScriptWorker,
+                         content::BrowserThread::DeleteOnUIThread>,
+                     public WorkerHost::Delegate {
+ public:
+  typedef base::Callback<void(scoped_ptr<SerializedValue>)> MessageCallback;
+  typedef base::Callback<void(const std::string&)> ErrorCallback;
+
+  // The callbacks are called on UI thread, |message_callback| receives the
+  // arguments of |postMessage| packed in an array.
+  ScriptWorker(const base::FilePath& script,
+               const MessageCallback& message_callback,
+               const ErrorCallback& error_callback);
+
+  // Starts the thread and runs the script. Should be called on UI thread.
+  bool Start();
+
+  // Runs |onmessage| with |args|, which is an array of arguments.
+  void PostMessage(scoped_ptr<SerializedValue> args);
+
+  // Aborts the running script and joins the thread, no callback is called
+  // after this. Should be called on UI thread.
+  void Terminate();
+
+ private:
+  friend struct content::BrowserThread::DeleteOnThread<
+      content::BrowserThread::UI>;
+  friend class base::DeleteHelper<ScriptWorker>;
+
+  ~ScriptWorker() override;
+
+  // WorkerHost::Delegate:
+  void SetUpGlobal(v8::Isolate* isolate,
+                   v8::Local<v8::Object> global) override;
+  void OnScriptError(const std::string& message) override;
+
+  void HandleMessageOnWorkerThread(scoped_ptr<SerializedValue> args);
+
+  // Called on UI thread, drop the results that arrive after Terminate.
+  void RunMessageCallback(scoped_ptr<SerializedValue> args);
+  void RunErrorCallback(const std::string& message);
+
+  // The |postMessage(args...)| function of the script.
+  static void PostMessageToUI(const v8::FunctionCallbackInfo<v8::Value>& info);
+
+  MessageCallback message_callback_;
+  ErrorCallback error_callback_;
+  WorkerHost host_;
+  bool started_;  // Only accessed on UI thread.
+  bool terminated_;  // Only accessed on UI thread.
+
+  DISALLOW_COPY_AND_ASSIGN(ScriptWorker);
+};
+
+}  // namespace atom
+
+#endif  // ATOM_BROWSER_SCRIPT_WORKER_H_
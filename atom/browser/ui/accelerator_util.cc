@@ -6,9 +6,11 @@
 
 #include <stdio.h>
 
+#include <map>
 #include <string>
 #include <vector>
 
+#include "base/lazy_instance.h"
 #include "base/stl_util.h"
 #include "base/strings/string_number_conversions.h"
 #include "base/strings/string_split.h"
@@ -83,10 +85,23 @@ ui::KeyboardCode KeyboardCodeFromCharCode(char c, bool* shifted) {
   }
 }
 
-}  // namespace
+// The results of parsing, invalid descriptions are remembered too so they are
+// only reported once.
+struct ParsedAccelerator {
+  bool valid;
+  ui::Accelerator accelerator;
+};
 
-bool StringToAccelerator(const std::string& description,
-                         ui::Accelerator* accelerator) {
+typedef std::map<std::string, ParsedAccelerator> AcceleratorCache;
+
+// Menus tend to be rebuilt with the same few accelerators.
+const size_t kMaxCachedAccelerators = 1024;
+
+base::LazyInstance<AcceleratorCache>::Leaky g_accelerator_cache =
+    LAZY_INSTANCE_INITIALIZER;
+
+bool ParseAccelerator(const std::string& description,
+                      ui::Accelerator* accelerator) {
   if (!base::IsStringASCII(description)) {
     LOG(ERROR) << "The accelerator string can only contain ASCII characters";
     return false;
@@ -193,6 +208,27 @@ bool StringToAccelerator(const std::string& description,
   return true;
 }
 
+}  // namespace
+
+bool StringToAccelerator(const std::string& description,
+                         ui::Accelerator* accelerator) {
+  AcceleratorCache& cache = g_accelerator_cache.Get();
+  AcceleratorCache::const_iterator it = cache.find(description);
+  if (it == cache.end()) {
+    if (cache.size() >= kMaxCachedAccelerators)
+      cache.clear();
+
+    ParsedAccelerator parsed;
+    parsed.valid = ParseAccelerator(description, &parsed.accelerator);
+    it = cache.insert(std::make_pair(description, parsed)).first;
+  }
+
+  if (!it->second.valid)
+    return false;
+  *accelerator = it->second.accelerator;
+  return true;
+}
+
 void GenerateAcceleratorTable(AcceleratorTable* table, ui::MenuModel* model) {
   int count = model->GetItemCount();
   for (int i = 0; i < count; ++i) {
@@ -19,7 +19,8 @@ namespace accelerator_util {
 typedef struct { int position; ui::MenuModel* model; } MenuItem;
 typedef std::map<ui::Accelerator, MenuItem> AcceleratorTable;
 
-// Parse a string as an accelerator.
+// Parse a string as an accelerator, the results are cached so parsing the same
+// string again is only a lookup. Should be called on UI thread.
 bool StringToAccelerator(const std::string& description,
                          ui::Accelerator* accelerator);
 
@@ -42,6 +42,10 @@ class MenuModel;
 // Populate current NSMenu with |model|.
 - (void)populateWithModel:(ui::MenuModel*)model;
 
+// Updates the label and states of the item built from the |index| of |model|,
+// which can be in a submenu.
+- (void)updateItemAtIndex:(NSInteger)index ofModel:(ui::MenuModel*)model;
+
 // Programmatically close the constructed menu.
 - (void)cancel;
 
@@ -63,6 +63,10 @@ int EventFlagsFromNSEvent(NSEvent* event) {
 @interface AtomMenuController (Private)
 - (void)addSeparatorToMenu:(NSMenu*)menu
                    atIndex:(int)index;
+- (NSMenuItem*)findItemAtIndex:(NSInteger)index
+                       ofModel:(ui::MenuModel*)model
+                        inMenu:(NSMenu*)menu;
+- (void)clearDelegatesOfMenu:(NSMenu*)menu;
 @end
 
 @implementation AtomMenuController
@@ -85,6 +89,7 @@ int EventFlagsFromNSEvent(NSEvent* event) {
 
 - (void)dealloc {
   [menu_ setDelegate:nil];
+  [self clearDelegatesOfMenu:menu_];
 
   // Close the menu if it is still open. This could happen if a tab gets closed
   // while its context menu is still open.
@@ -110,6 +115,40 @@ int EventFlagsFromNSEvent(NSEvent* event) {
   }
 }
 
+- (void)updateItemAtIndex:(NSInteger)index ofModel:(ui::MenuModel*)model {
+  NSMenuItem* item = [self findItemAtIndex:index ofModel:model inMenu:menu_];
+  if (!item)
+    return;
+
+  NSString* label =
+      l10n_util::FixUpWindowsStyleLabel(model->GetLabelAt(index));
+  [item setTitle:label];
+  if ([item hasSubmenu])
+    [[item submenu] setTitle:label];
+  [item setState:(model->IsItemCheckedAt(index) ? NSOnState : NSOffState)];
+  [item setHidden:!model->IsVisibleAt(index)];
+  [item setEnabled:model->IsEnabledAt(index)];
+}
+
+- (NSMenuItem*)findItemAtIndex:(NSInteger)index
+                       ofModel:(ui::MenuModel*)model
+                        inMenu:(NSMenu*)menu {
+  for (NSMenuItem* item in [menu itemArray]) {
+    id modelObject = [item representedObject];
+    if ([item tag] == index && [modelObject isKindOfClass:[NSValue class]] &&
+        [modelObject pointerValue] == model)
+      return item;
+
+    if ([item hasSubmenu]) {
+      NSMenuItem* found =
+          [self findItemAtIndex:index ofModel:model inMenu:[item submenu]];
+      if (found)
+        return found;
+    }
+  }
+  return nil;
+}
+
 - (void)cancel {
   if (isMenuOpen_) {
     [menu_ cancelTracking];
@@ -165,9 +204,19 @@ int EventFlagsFromNSEvent(NSEvent* event) {
     // Recursively build a submenu from the sub-model at this index.
     [item setTarget:nil];
     [item setAction:nil];
+    // Only used to find the item when updating it.
+    [item setTag:index];
+    [item setRepresentedObject:[NSValue valueWithPointer:model]];
     ui::MenuModel* submenuModel = model->GetSubmenuModelAt(index);
-    NSMenu* submenu =
-        [self menuFromModel:(ui::SimpleMenuModel*)submenuModel];
+    NSMenu* submenu;
+    if (submenuModel->GetItemCount() == 0) {
+      // Empty submenus are filled by the app when they are about to show, and
+      // built in menuNeedsUpdate:.
+      submenu = [[[NSMenu alloc] initWithTitle:@""] autorelease];
+      [submenu setDelegate:self];
+    } else {
+      submenu = [self menuFromModel:(ui::SimpleMenuModel*)submenuModel];
+    }
     [submenu setTitle:[item title]];
     [item setSubmenu:submenu];
 
@@ -266,12 +315,62 @@ int EventFlagsFromNSEvent(NSEvent* event) {
   return isMenuOpen_;
 }
 
+- (void)clearDelegatesOfMenu:(NSMenu*)menu {
+  for (NSMenuItem* item in [menu itemArray]) {
+    if (![item hasSubmenu])
+      continue;
+    if ([[item submenu] delegate] == self)
+      [[item submenu] setDelegate:nil];
+    [self clearDelegatesOfMenu:[item submenu]];
+  }
+}
+
+// Builds the lazily populated submenus each time they are about to show.
+- (void)menuNeedsUpdate:(NSMenu*)menu {
+  NSMenu* supermenu = [menu supermenu];
+  if (menu == menu_.get() || !supermenu)
+    return;
+
+  NSInteger itemIndex = [supermenu indexOfItemWithSubmenu:menu];
+  if (itemIndex < 0)
+    return;
+  NSMenuItem* item = [supermenu itemAtIndex:itemIndex];
+  id modelObject = [item representedObject];
+  if (![modelObject isKindOfClass:[NSValue class]])
+    return;
+
+  ui::MenuModel* model =
+      static_cast<ui::MenuModel*>([modelObject pointerValue]);
+  ui::MenuModel* submenuModel = model->GetSubmenuModelAt([item tag]);
+  if (!submenuModel)
+    return;
+
+  // Let the app fill the submenu first.
+  submenuModel->MenuWillShow();
+
+  [menu removeAllItems];
+  const int count = submenuModel->GetItemCount();
+  for (int index = 0; index < count; index++) {
+    if (submenuModel->GetTypeAt(index) == ui::MenuModel::TYPE_SEPARATOR)
+      [self addSeparatorToMenu:menu atIndex:index];
+    else
+      [self addItemToMenu:menu atIndex:index fromModel:submenuModel];
+  }
+}
+
 - (void)menuWillOpen:(NSMenu*)menu {
+  // The lazily populated submenus have been handled in menuNeedsUpdate:.
+  if (menu != menu_.get())
+    return;
+
   isMenuOpen_ = YES;
   model_->MenuWillShow();
 }
 
 - (void)menuDidClose:(NSMenu*)menu {
+  if (menu != menu_.get())
+    return;
+
   if (isMenuOpen_) {
     model_->MenuClosed();
     isMenuOpen_ = NO;
@@ -0,0 +1,49 @@
+// Copyright (c) 2015 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#include "atom/browser/ui/draggable_region_index.h"
+
+#include <algorithm>
+
+#include "third_party/skia/include/core/SkRegion.h"
+
+namespace atom {
+
+DraggableRegionIndex::Band::Band() : top(0), bottom(0) {
+}
+
+DraggableRegionIndex::Band::~Band() {
+}
+
+DraggableRegionIndex::DraggableRegionIndex(const SkRegion& region) {
+  for (SkRegion::Iterator it(region); !it.done(); it.next()) {
+    const SkIRect& rect = it.rect();
+    if (bands_.empty() || bands_.back().top != rect.fTop) {
+      bands_.push_back(Band());
+      bands_.back().top = rect.fTop;
+      bands_.back().bottom = rect.fBottom;
+    }
+    Span span = { rect.fLeft, rect.fRight };
+    bands_.back().spans.push_back(span);
+  }
+}
+
+DraggableRegionIndex::~DraggableRegionIndex() {
+}
+
+bool DraggableRegionIndex::Contains(int x, int y) const {
+  // The first band ending below |y|.
+  auto band = std::upper_bound(
+      bands_.begin(), bands_.end(), y,
+      [](int value, const Band& item) { return value < item.bottom; });
+  if (band == bands_.end() || y < band->top)
+    return false;
+
+  auto span = std::upper_bound(
+      band->spans.begin(), band->spans.end(), x,
+      [](int value, const Span& item) { return value < item.right; });
+  return span != band->spans.end() && x >= span->left;
+}
+
+}  // namespace atom
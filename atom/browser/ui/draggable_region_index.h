@@ -0,0 +1,53 @@
+// Copyright (c) 2015 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#ifndef ATOM_BROWSER_UI_DRAGGABLE_REGION_INDEX_H_
+#define ATOM_BROWSER_UI_DRAGGABLE_REGION_INDEX_H_
+
+#include <vector>
+
+#include "base/basictypes.h"
+
+class SkRegion;
+
+namespace atom {
+
+// Answers whether a point is in the draggable region in O(log n), which is
+// asked for each mouse move over frameless windows. SkRegion::contains scans
+// all the rectangles before the point, which adds up for toolbars made of
+// hundreds of them.
+//
+// The rectangles of a SkRegion are already split into horizontal bands that
+// do not overlap, each with sorted and disjoint spans, so the bands and then
+// the spans of one band can be binary searched.
+class DraggableRegionIndex {
+ public:
+  explicit DraggableRegionIndex(const SkRegion& region);
+  ~DraggableRegionIndex();
+
+  bool Contains(int x, int y) const;
+
+ private:
+  struct Span {
+    int left;
+    int right;
+  };
+
+  struct Band {
+    Band();
+    ~Band();
+
+    int top;
+    int bottom;
+    std::vector<Span> spans;
+  };
+
+  std::vector<Band> bands_;
+
+  DISALLOW_COPY_AND_ASSIGN(DraggableRegionIndex);
+};
+
+}  // namespace atom
+
+#endif  // ATOM_BROWSER_UI_DRAGGABLE_REGION_INDEX_H_
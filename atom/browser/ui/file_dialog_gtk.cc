@@ -15,8 +15,10 @@
 #undef None
 
 #include "atom/browser/native_window.h"
+#include "base/bind.h"
 #include "base/callback.h"
 #include "base/files/file_util.h"
+#include "base/message_loop/message_loop.h"
 #include "base/strings/string_util.h"
 #include "chrome/browser/ui/libgtk2ui/gtk2_signal.h"
 #include "ui/aura/window.h"
@@ -172,17 +174,20 @@ class FileChooserDialog {
 void FileChooserDialog::OnFileDialogResponse(GtkWidget* widget, int response) {
   gtk_widget_hide_all(dialog_);
 
+  // The result is posted as a task, so the callback does not run inside the
+  // signal emission of GTK.
+  bool accepted = response == GTK_RESPONSE_ACCEPT;
+  base::Closure task;
   if (!save_callback_.is_null()) {
-    if (response == GTK_RESPONSE_ACCEPT)
-      save_callback_.Run(true, GetFileName());
-    else
-      save_callback_.Run(false, base::FilePath());
+    task = base::Bind(save_callback_, accepted,
+                      accepted ? GetFileName() : base::FilePath());
   } else if (!open_callback_.is_null()) {
-    if (response == GTK_RESPONSE_ACCEPT)
-      open_callback_.Run(true, GetFileNames());
-    else
-      open_callback_.Run(false, std::vector<base::FilePath>());
+    task = base::Bind(open_callback_, accepted,
+                      accepted ? GetFileNames() :
+                                 std::vector<base::FilePath>());
   }
+  if (!task.is_null())
+    base::MessageLoop::current()->PostTask(FROM_HERE, task);
   delete this;
 }
 
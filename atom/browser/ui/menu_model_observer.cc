@@ -0,0 +1,35 @@
+// Copyright (c) 2015 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#include "atom/browser/ui/menu_model_observer.h"
+
+#include "base/lazy_instance.h"
+#include "base/observer_list.h"
+
+namespace atom {
+
+namespace {
+
+base::LazyInstance<ObserverList<MenuModelObserver>>::Leaky g_observers =
+    LAZY_INSTANCE_INITIALIZER;
+
+}  // namespace
+
+// static
+void MenuModelObserver::AddObserver(MenuModelObserver* observer) {
+  g_observers.Get().AddObserver(observer);
+}
+
+// static
+void MenuModelObserver::RemoveObserver(MenuModelObserver* observer) {
+  g_observers.Get().RemoveObserver(observer);
+}
+
+// static
+void MenuModelObserver::NotifyItemChanged(ui::MenuModel* model, int index) {
+  FOR_EACH_OBSERVER(MenuModelObserver, g_observers.Get(),
+                    OnMenuItemChanged(model, index));
+}
+
+}  // namespace atom
@@ -0,0 +1,34 @@
+// Copyright (c) 2015 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#ifndef ATOM_BROWSER_UI_MENU_MODEL_OBSERVER_H_
+#define ATOM_BROWSER_UI_MENU_MODEL_OBSERVER_H_
+
+namespace ui {
+class MenuModel;
+}
+
+namespace atom {
+
+// Observes the items of menu models that are changed in place, so the native
+// menus built from a model can patch the changed items instead of being
+// rebuilt. Should be used on UI thread.
+class MenuModelObserver {
+ public:
+  static void AddObserver(MenuModelObserver* observer);
+  static void RemoveObserver(MenuModelObserver* observer);
+
+  // Tells the observers that the label, checked, enabled or visible state of
+  // the item at |index| of |model| has changed.
+  static void NotifyItemChanged(ui::MenuModel* model, int index);
+
+  virtual void OnMenuItemChanged(ui::MenuModel* model, int index) = 0;
+
+ protected:
+  virtual ~MenuModelObserver() {}
+};
+
+}  // namespace atom
+
+#endif  // ATOM_BROWSER_UI_MENU_MODEL_OBSERVER_H_
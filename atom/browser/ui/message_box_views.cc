@@ -9,6 +9,7 @@
 #endif
 
 #include "atom/browser/native_window.h"
+#include "base/bind.h"
 #include "base/callback.h"
 #include "base/message_loop/message_loop.h"
 #include "base/run_loop.h"
@@ -210,7 +211,9 @@ void MessageDialog::Close() {
   dialog_scope_.reset();
 
   if (delete_on_close_) {
-    callback_.Run(GetResult());
+    // Do not run the callback while the widget is being closed.
+    base::MessageLoop::current()->PostTask(
+        FROM_HERE, base::Bind(callback_, GetResult()));
     base::MessageLoop::current()->DeleteSoon(FROM_HERE, this);
   } else if (run_loop_) {
     run_loop_->Quit();
@@ -6,7 +6,9 @@
 
 namespace atom {
 
-TrayIcon::TrayIcon() {
+TrayIcon::TrayIcon()
+    : animation_frame_count_(0),
+      animation_frame_index_(0) {
 }
 
 TrayIcon::~TrayIcon() {
@@ -26,6 +28,44 @@ void TrayIcon::DisplayBalloon(const gfx::Image& icon,
                               const base::string16& contents) {
 }
 
+void TrayIcon::SetAnimation(const std::vector<gfx::Image>& frames,
+                            base::TimeDelta interval) {
+  StopAnimation();
+  if (frames.empty())
+    return;
+
+  SetAnimationFrames(frames);
+  animation_frame_count_ = frames.size();
+  animation_frame_index_ = 0;
+  ShowAnimationFrame(0);
+  if (frames.size() > 1)
+    animation_timer_.Start(FROM_HERE, interval, this,
+                           &TrayIcon::OnAnimationTimer);
+}
+
+void TrayIcon::StopAnimation() {
+  if (animation_frame_count_ == 0)
+    return;
+
+  animation_timer_.Stop();
+  animation_frame_count_ = 0;
+  SetAnimationFrames(std::vector<gfx::Image>());
+}
+
+void TrayIcon::SetAnimationFrames(const std::vector<gfx::Image>& frames) {
+  animation_frames_ = frames;
+}
+
+void TrayIcon::ShowAnimationFrame(size_t index) {
+  SetImage(animation_frames_[index]);
+}
+
+void TrayIcon::OnAnimationTimer() {
+  if (++animation_frame_index_ >= animation_frame_count_)
+    animation_frame_index_ = 0;
+  ShowAnimationFrame(animation_frame_index_);
+}
+
 void TrayIcon::NotifyClicked() {
   FOR_EACH_OBSERVER(TrayIconObserver, observers_, OnClicked());
 }
@@ -6,10 +6,14 @@
 #define ATOM_BROWSER_UI_TRAY_ICON_H_
 
 #include <string>
+#include <vector>
 
 #include "atom/browser/ui/tray_icon_observer.h"
 #include "base/observer_list.h"
+#include "base/time/time.h"
+#include "base/timer/timer.h"
 #include "ui/base/models/simple_menu_model.h"
+#include "ui/gfx/image/image.h"
 
 namespace atom {
 
@@ -48,6 +52,13 @@ class TrayIcon {
   // Set the context menu for this icon.
   virtual void SetContextMenu(ui::SimpleMenuModel* menu_model) = 0;
 
+  // Shows |frames| one after another every |interval|, the frames are
+  // converted to platform icons only once.
+  void SetAnimation(const std::vector<gfx::Image>& frames,
+                    base::TimeDelta interval);
+  void StopAnimation();
+  bool IsAnimating() const { return animation_timer_.IsRunning(); }
+
   void AddObserver(TrayIconObserver* obs) { observers_.AddObserver(obs); }
   void RemoveObserver(TrayIconObserver* obs) { observers_.RemoveObserver(obs); }
   void NotifyClicked();
@@ -59,9 +70,24 @@ class TrayIcon {
  protected:
   TrayIcon();
 
+  // Converts the |frames| of animation to platform icons, an empty |frames|
+  // releases them. The default implementation keeps the images and shows
+  // them with SetImage.
+  virtual void SetAnimationFrames(const std::vector<gfx::Image>& frames);
+
+  // Shows the frame at |index| of the ones passed to SetAnimationFrames.
+  virtual void ShowAnimationFrame(size_t index);
+
  private:
+  void OnAnimationTimer();
+
   ObserverList<TrayIconObserver> observers_;
 
+  std::vector<gfx::Image> animation_frames_;
+  size_t animation_frame_count_;
+  size_t animation_frame_index_;
+  base::RepeatingTimer<TrayIcon> animation_timer_;
+
   DISALLOW_COPY_AND_ASSIGN(TrayIcon);
 };
 
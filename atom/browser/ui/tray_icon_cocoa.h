@@ -8,6 +8,7 @@
 #import <Cocoa/Cocoa.h>
 
 #include <string>
+#include <vector>
 
 #include "atom/browser/ui/tray_icon.h"
 #include "base/mac/scoped_nsobject.h"
@@ -29,6 +30,9 @@ class TrayIconCocoa : public TrayIcon {
   void SetHighlightMode(bool highlight) override;
   void SetContextMenu(ui::SimpleMenuModel* menu_model) override;
 
+ protected:
+  void SetAnimationFrames(const std::vector<gfx::Image>& frames) override;
+
  private:
   base::scoped_nsobject<NSStatusItem> item_;
 
@@ -57,6 +57,15 @@ void TrayIconCocoa::SetImage(const gfx::Image& image) {
   [item_ setImage:image.AsNSImage()];
 }
 
+void TrayIconCocoa::SetAnimationFrames(
+    const std::vector<gfx::Image>& frames) {
+  // gfx::Image caches the NSImage it converts to, so doing it here leaves
+  // nothing to convert when the frames are shown.
+  for (const gfx::Image& frame : frames)
+    frame.AsNSImage();
+  TrayIcon::SetAnimationFrames(frames);
+}
+
 void TrayIconCocoa::SetPressedImage(const gfx::Image& image) {
   [item_ setAlternateImage:image.AsNSImage()];
 }
@@ -5,6 +5,7 @@
 #include "atom/browser/ui/views/frameless_view.h"
 
 #include "atom/browser/native_window_views.h"
+#include "atom/browser/ui/draggable_region_index.h"
 #include "ui/aura/window.h"
 #include "ui/base/hit_test.h"
 #include "ui/views/widget/widget.h"
@@ -70,8 +71,8 @@ int FramelessView::NonClientHitTest(const gfx::Point& cursor) {
 
   // Check for possible draggable region in the client area for the frameless
   // window.
-  SkRegion* draggable_region = window_->draggable_region();
-  if (draggable_region && draggable_region->contains(cursor.x(), cursor.y()))
+  DraggableRegionIndex* draggable_region = window_->draggable_region();
+  if (draggable_region && draggable_region->Contains(cursor.x(), cursor.y()))
     return HTCAPTION;
 
   // Support resizing frameless window by dragging the border.
@@ -163,20 +163,44 @@ void SetMenuItemID(DbusmenuMenuitem* item, int id) {
   g_object_set_data(G_OBJECT(item), "menu-id", GINT_TO_POINTER(id + 1));
 }
 
+// Searches the items built under |parent| for the one of |index| in |model|.
+DbusmenuMenuitem* FindMenuItem(DbusmenuMenuitem* parent,
+                               ui::MenuModel* model,
+                               int index) {
+  for (GList* child = menuitem_get_children(parent); child;
+       child = child->next) {
+    DbusmenuMenuitem* item = static_cast<DbusmenuMenuitem*>(child->data);
+    int id;
+    if (ModelForMenuItem(item) == model && GetMenuItemID(item, &id) &&
+        id == index)
+      return item;
+
+    DbusmenuMenuitem* found = FindMenuItem(item, model, index);
+    if (found)
+      return found;
+  }
+  return NULL;
+}
+
 }  // namespace
 
 GlobalMenuBarX11::GlobalMenuBarX11(NativeWindowViews* window)
     : window_(window),
       xid_(window_->GetNativeWindow()->GetHost()->GetAcceleratedWidget()),
-      server_(NULL) {
+      server_(NULL),
+      root_item_(NULL) {
   EnsureMethodsLoaded();
   if (server_new)
     InitServer(xid_);
 
   GlobalMenuBarRegistrarX11::GetInstance()->OnWindowMapped(xid_);
+  MenuModelObserver::AddObserver(this);
 }
 
 GlobalMenuBarX11::~GlobalMenuBarX11() {
+  MenuModelObserver::RemoveObserver(this);
+  if (root_item_)
+    g_object_unref(root_item_);
   if (IsServerStarted())
     g_object_unref(server_);
 
@@ -198,7 +222,11 @@ void GlobalMenuBarX11::SetMenu(ui::MenuModel* menu_model) {
   BuildMenuFromModel(menu_model, root_item);
 
   server_set_root(server_, root_item);
-  g_object_unref(root_item);
+
+  // Keep the root to find the items to patch.
+  if (root_item_)
+    g_object_unref(root_item_);
+  root_item_ = root_item;
 }
 
 bool GlobalMenuBarX11::IsServerStarted() const {
@@ -255,6 +283,32 @@ void GlobalMenuBarX11::BuildMenuFromModel(ui::MenuModel* model,
   }
 }
 
+void GlobalMenuBarX11::UpdateMenuItem(DbusmenuMenuitem* item,
+                                      ui::MenuModel* model,
+                                      int index) {
+  menuitem_property_set_bool(item, kPropertyVisible, model->IsVisibleAt(index));
+  std::string label = ui::ConvertAcceleratorsFromWindowsStyle(
+      base::UTF16ToUTF8(model->GetLabelAt(index)));
+  menuitem_property_set(item, kPropertyLabel, label.c_str());
+  menuitem_property_set_bool(item, kPropertyEnabled, model->IsEnabledAt(index));
+
+  ui::MenuModel::ItemType type = model->GetTypeAt(index);
+  if (type == ui::MenuModel::TYPE_CHECK || type == ui::MenuModel::TYPE_RADIO)
+    menuitem_property_set_int(item, kPropertyToggleState,
+                              model->IsItemCheckedAt(index));
+}
+
+void GlobalMenuBarX11::OnMenuItemChanged(ui::MenuModel* model, int index) {
+  if (!root_item_)
+    return;
+
+  // Only the items that have been built are patched, submenus are built from
+  // the model again when they are shown.
+  DbusmenuMenuitem* item = FindMenuItem(root_item_, model, index);
+  if (item)
+    UpdateMenuItem(item, model, index);
+}
+
 void GlobalMenuBarX11::RegisterAccelerator(DbusmenuMenuitem* item,
                                            const ui::Accelerator& accelerator) {
   // A translation of libdbusmenu-gtk's menuitem_property_set_shortcut()
@@ -304,8 +358,10 @@ void GlobalMenuBarX11::OnSubMenuShow(DbusmenuMenuitem* item) {
   g_list_foreach(children, reinterpret_cast<GFunc>(g_object_unref), NULL);
   g_list_free(children);
 
-  // Build children.
-  BuildMenuFromModel(model->GetSubmenuModelAt(id), item);
+  // Build children, the app can fill the submenu before it is shown.
+  ui::MenuModel* submenu_model = model->GetSubmenuModelAt(id);
+  submenu_model->MenuWillShow();
+  BuildMenuFromModel(submenu_model, item);
 }
 
 }  // namespace atom
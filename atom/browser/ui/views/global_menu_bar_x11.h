@@ -7,6 +7,7 @@
 
 #include <string>
 
+#include "atom/browser/ui/menu_model_observer.h"
 #include "base/basictypes.h"
 #include "base/compiler_specific.h"
 #include "ui/base/glib/glib_signal.h"
@@ -35,7 +36,7 @@ class NativeWindowViews;
 //
 // This class is like the chrome's corresponding one, but it generates the menu
 // from menu models instead, and it is also per-window specific.
-class GlobalMenuBarX11 {
+class GlobalMenuBarX11 : public MenuModelObserver {
  public:
   explicit GlobalMenuBarX11(NativeWindowViews* window);
   virtual ~GlobalMenuBarX11();
@@ -53,6 +54,12 @@ class GlobalMenuBarX11 {
   // Create a menu from menu model.
   void BuildMenuFromModel(ui::MenuModel* model, DbusmenuMenuitem* parent);
 
+  // Updates the label and states of |item| from the |index| of |model|.
+  void UpdateMenuItem(DbusmenuMenuitem* item, ui::MenuModel* model, int index);
+
+  // MenuModelObserver:
+  void OnMenuItemChanged(ui::MenuModel* model, int index) override;
+
   // Sets the accelerator for |item|.
   void RegisterAccelerator(DbusmenuMenuitem* item,
                            const ui::Accelerator& accelerator);
@@ -65,6 +72,7 @@ class GlobalMenuBarX11 {
   gfx::AcceleratedWidget xid_;
 
   DbusmenuServer* server_;
+  DbusmenuMenuitem* root_item_;
 
   DISALLOW_COPY_AND_ASSIGN(GlobalMenuBarX11);
 };
@@ -60,31 +60,19 @@ MenuBar::MenuBar()
   set_background(views::Background::CreateSolidBackground(background_color_));
   SetLayoutManager(new views::BoxLayout(
       views::BoxLayout::kHorizontal, 0, 0, 0));
+  MenuModelObserver::AddObserver(this);
 }
 
 MenuBar::~MenuBar() {
+  MenuModelObserver::RemoveObserver(this);
 }
 
 void MenuBar::SetMenu(ui::MenuModel* model) {
   menu_model_ = model;
   RemoveAllChildViews(true);
 
-  for (int i = 0; i < model->GetItemCount(); ++i) {
-    SubmenuButton* button = new SubmenuButton(this, model->GetLabelAt(i), this);
-    button->set_tag(i);
-
-#if defined(USE_X11)
-    button->SetTextColor(views::Button::STATE_NORMAL, enabled_color_);
-    button->SetTextColor(views::Button::STATE_DISABLED, disabled_color_);
-    button->SetTextColor(views::Button::STATE_PRESSED, highlight_color_);
-    button->SetTextColor(views::Button::STATE_HOVERED, hover_color_);
-    button->SetUnderlineColor(enabled_color_);
-#elif defined(OS_WIN)
-    button->SetUnderlineColor(color_utils::GetSysSkColor(COLOR_GRAYTEXT));
-#endif
-
-    AddChildView(button);
-  }
+  for (int i = 0; i < model->GetItemCount(); ++i)
+    AddChildView(CreateButton(i));
 }
 
 void MenuBar::SetAcceleratorVisibility(bool visible) {
@@ -134,6 +122,41 @@ bool MenuBar::GetMenuButtonFromScreenPoint(const gfx::Point& point,
   return false;
 }
 
+SubmenuButton* MenuBar::CreateButton(int index) {
+  SubmenuButton* button = new SubmenuButton(
+      this, menu_model_->GetLabelAt(index), this);
+  button->set_tag(index);
+
+#if defined(USE_X11)
+  button->SetTextColor(views::Button::STATE_NORMAL, enabled_color_);
+  button->SetTextColor(views::Button::STATE_DISABLED, disabled_color_);
+  button->SetTextColor(views::Button::STATE_PRESSED, highlight_color_);
+  button->SetTextColor(views::Button::STATE_HOVERED, hover_color_);
+  button->SetUnderlineColor(enabled_color_);
+#elif defined(OS_WIN)
+  button->SetUnderlineColor(color_utils::GetSysSkColor(COLOR_GRAYTEXT));
+#endif
+
+  button->SetEnabled(menu_model_->IsEnabledAt(index));
+  button->SetVisible(menu_model_->IsVisibleAt(index));
+  return button;
+}
+
+void MenuBar::OnMenuItemChanged(ui::MenuModel* model, int index) {
+  // The submenus are built from the model each time they are shown, only the
+  // buttons of the menu bar need patching.
+  if (model != menu_model_ || index >= child_count())
+    return;
+
+  // The button is patched in place, as its submenu may be showing.
+  SubmenuButton* button = static_cast<SubmenuButton*>(child_at(index));
+  button->SetTitle(model->GetLabelAt(index));
+  button->SetEnabled(model->IsEnabledAt(index));
+  button->SetVisible(model->IsVisibleAt(index));
+  Layout();
+  SchedulePaint();
+}
+
 const char* MenuBar::GetClassName() const {
   return kViewClassName;
 }
@@ -5,6 +5,7 @@
 #ifndef ATOM_BROWSER_UI_VIEWS_MENU_BAR_H_
 #define ATOM_BROWSER_UI_VIEWS_MENU_BAR_H_
 
+#include "atom/browser/ui/menu_model_observer.h"
 #include "ui/views/controls/button/button.h"
 #include "ui/views/controls/button/menu_button_listener.h"
 #include "ui/views/view.h"
@@ -20,10 +21,12 @@ class MenuButton;
 namespace atom {
 
 class MenuDelegate;
+class SubmenuButton;
 
 class MenuBar : public views::View,
                 public views::ButtonListener,
-                public views::MenuButtonListener {
+                public views::MenuButtonListener,
+                public MenuModelObserver {
  public:
   MenuBar();
   virtual ~MenuBar();
@@ -61,6 +64,12 @@ class MenuBar : public views::View,
                                    const gfx::Point& point) override;
 
  private:
+  // Creates the button of the |index|th submenu.
+  SubmenuButton* CreateButton(int index);
+
+  // MenuModelObserver:
+  void OnMenuItemChanged(ui::MenuModel* model, int index) override;
+
   SkColor background_color_;
 
 #if defined(USE_X11)
@@ -6,10 +6,13 @@
 
 #include "atom/browser/ui/views/menu_bar.h"
 #include "base/stl_util.h"
+#include "ui/base/models/menu_model.h"
+#include "ui/gfx/image/image.h"
 #include "ui/views/controls/button/menu_button.h"
 #include "ui/views/controls/menu/menu_item_view.h"
 #include "ui/views/controls/menu/menu_model_adapter.h"
 #include "ui/views/controls/menu/menu_runner.h"
+#include "ui/views/controls/menu/submenu_view.h"
 #include "ui/views/widget/widget.h"
 
 namespace atom {
@@ -50,17 +53,52 @@ views::MenuItemView* MenuDelegate::BuildMenu(ui::MenuModel* model) {
   DCHECK_GE(id_, 0);
 
   if (!items_[id_]) {
-    views::MenuModelAdapter* delegate = new views::MenuModelAdapter(model);
-    delegates_[id_] = delegate;
+    // The adapter finds the items by command id, it is only used for the
+    // commands of the items.
+    delegates_[id_] = new views::MenuModelAdapter(model);
 
     views::MenuItemView* item = new views::MenuItemView(this);
-    delegate->BuildMenu(item);
+    models_[item] = model;
+    populated_.insert(item);
+    PopulateMenu(item, model);
     items_[id_] = item;
   }
 
   return items_[id_];
 }
 
+void MenuDelegate::PopulateMenu(views::MenuItemView* menu,
+                                ui::MenuModel* model) {
+  // Empty submenus get a placeholder item when the menu starts running.
+  if (menu->HasSubmenu()) {
+    views::View* empty_item = menu->GetSubmenu()->GetViewByID(
+        views::MenuItemView::kEmptyMenuItemViewID);
+    if (empty_item && model->GetItemCount() > 0) {
+      menu->GetSubmenu()->RemoveChildView(empty_item);
+      delete empty_item;
+    }
+  }
+
+  bool has_icons = false;
+  for (int i = 0; i < model->GetItemCount(); ++i) {
+    views::MenuItemView* item =
+        views::MenuModelAdapter::AppendMenuItemFromModel(
+            model, i, menu, model->GetCommandIdAt(i));
+    if (!item)
+      continue;
+
+    item->SetVisible(model->IsVisibleAt(i));
+    gfx::Image icon;
+    has_icons |= model->GetIconAt(i, &icon);
+    if (model->GetTypeAt(i) == ui::MenuModel::TYPE_SUBMENU) {
+      item->CreateSubmenu();
+      models_[item] = model->GetSubmenuModelAt(i);
+    }
+  }
+  menu->set_has_icons(has_icons);
+  menu->ChildrenChanged();
+}
+
 void MenuDelegate::ExecuteCommand(int id) {
   delegate()->ExecuteCommand(id);
 }
@@ -103,11 +141,22 @@ void MenuDelegate::SelectionChanged(views::MenuItemView* menu) {
 }
 
 void MenuDelegate::WillShowMenu(views::MenuItemView* menu) {
-  delegate()->WillShowMenu(menu);
+  std::map<views::MenuItemView*, ui::MenuModel*>::iterator it =
+      models_.find(menu);
+  if (it == models_.end())
+    return;
+
+  // The app can fill the submenu before its items are created.
+  it->second->MenuWillShow();
+  if (populated_.insert(menu).second)
+    PopulateMenu(menu, it->second);
 }
 
 void MenuDelegate::WillHideMenu(views::MenuItemView* menu) {
-  delegate()->WillHideMenu(menu);
+  std::map<views::MenuItemView*, ui::MenuModel*>::iterator it =
+      models_.find(menu);
+  if (it != models_.end())
+    it->second->MenuClosed();
 }
 
 views::MenuItemView* MenuDelegate::GetSiblingMenu(
@@ -5,6 +5,8 @@
 #ifndef ATOM_BROWSER_UI_VIEWS_MENU_DELEGATE_H_
 #define ATOM_BROWSER_UI_VIEWS_MENU_DELEGATE_H_
 
+#include <map>
+#include <set>
 #include <vector>
 
 #include "ui/views/controls/menu/menu_delegate.h"
@@ -54,6 +56,11 @@ class MenuDelegate : public views::MenuDelegate {
   // Gets the cached menu item view from the model.
   views::MenuItemView* BuildMenu(ui::MenuModel* model);
 
+  // Creates the items of |menu| from |model|. The items of submenus are only
+  // created when the submenus are about to show, so huge menus cost nothing
+  // until the user opens them.
+  void PopulateMenu(views::MenuItemView* menu, ui::MenuModel* model);
+
   // Returns delegate for current item.
   views::MenuDelegate* delegate() const { return delegates_[id_]; }
 
@@ -66,6 +73,11 @@ class MenuDelegate : public views::MenuDelegate {
   // Cached menu delegates for each menu item, managed by us.
   std::vector<views::MenuDelegate*> delegates_;
 
+  // The models of the created menus and submenus.
+  std::map<views::MenuItemView*, ui::MenuModel*> models_;
+  // The menus whose items have been created.
+  std::set<views::MenuItemView*> populated_;
+
   DISALLOW_COPY_AND_ASSIGN(MenuDelegate);
 };
 
@@ -49,6 +49,19 @@ SubmenuButton::SubmenuButton(views::ButtonListener* listener,
 SubmenuButton::~SubmenuButton() {
 }
 
+void SubmenuButton::SetTitle(const base::string16& title) {
+  SetText(FilterAccecelator(title));
+
+  accelerator_ = 0;
+  underline_start_ = underline_end_ = -1;
+  text_width_ = text_height_ = 0;
+  if (GetUnderlinePosition(title, &accelerator_, &underline_start_,
+                           &underline_end_))
+    gfx::Canvas::SizeStringInt(GetText(), GetFontList(), &text_width_,
+                               &text_height_, 0, 0);
+  SchedulePaint();
+}
+
 void SubmenuButton::SetAcceleratorVisibility(bool visible) {
   if (visible == show_underline_)
     return;
@@ -17,6 +17,9 @@ class SubmenuButton : public views::MenuButton {
                 views::MenuButtonListener* menu_button_listener);
   virtual ~SubmenuButton();
 
+  // Changes the label, and the accelerator that comes from it.
+  void SetTitle(const base::string16& title);
+
   void SetAcceleratorVisibility(bool visible);
   void SetUnderlineColor(SkColor color);
 
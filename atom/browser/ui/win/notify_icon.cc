@@ -38,6 +38,8 @@ NotifyIcon::NotifyIcon(NotifyIconHost* host,
 }
 
 NotifyIcon::~NotifyIcon() {
+  SetAnimationFrames(std::vector<gfx::Image>());
+
   // Remove our icon.
   host_->Remove(this);
   NOTIFYICONDATA icon_data;
@@ -146,6 +148,26 @@ void NotifyIcon::SetContextMenu(ui::SimpleMenuModel* menu_model) {
   menu_model_ = menu_model;
 }
 
+void NotifyIcon::SetAnimationFrames(const std::vector<gfx::Image>& frames) {
+  // The shell keeps its own copy of the icons it is given.
+  for (HICON icon : animation_icons_)
+    DestroyIcon(icon);
+  animation_icons_.clear();
+
+  for (const gfx::Image& frame : frames)
+    animation_icons_.push_back(
+        IconUtil::CreateHICONFromSkBitmap(frame.AsBitmap()));
+}
+
+void NotifyIcon::ShowAnimationFrame(size_t index) {
+  NOTIFYICONDATA icon_data;
+  InitIconData(&icon_data);
+  icon_data.uFlags = NIF_ICON;
+  icon_data.hIcon = animation_icons_[index];
+  if (!Shell_NotifyIcon(NIM_MODIFY, &icon_data))
+    LOG(WARNING) << "Error setting status tray icon image";
+}
+
 void NotifyIcon::InitIconData(NOTIFYICONDATA* icon_data) {
   memset(icon_data, 0, sizeof(NOTIFYICONDATA));
   icon_data->cbSize = sizeof(NOTIFYICONDATA);
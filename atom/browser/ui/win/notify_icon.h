@@ -9,6 +9,7 @@
 #include <shellapi.h>
 
 #include <string>
+#include <vector>
 
 #include "atom/browser/ui/tray_icon.h"
 #include "base/basictypes.h"
@@ -51,6 +52,11 @@ class NotifyIcon : public TrayIcon {
                       const base::string16& contents) override;
   void SetContextMenu(ui::SimpleMenuModel* menu_model) override;
 
+ protected:
+  // Overridden from TrayIcon:
+  void SetAnimationFrames(const std::vector<gfx::Image>& frames) override;
+  void ShowAnimationFrame(size_t index) override;
+
  private:
   void InitIconData(NOTIFYICONDATA* icon_data);
 
@@ -69,6 +75,9 @@ class NotifyIcon : public TrayIcon {
   // The currently-displayed icon for the window.
   base::win::ScopedHICON icon_;
 
+  // The frames of animation, converted once when the animation is set.
+  std::vector<HICON> animation_icons_;
+
   // The currently-displayed icon for the notification balloon.
   base::win::ScopedHICON balloon_icon_;
 
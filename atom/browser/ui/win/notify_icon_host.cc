@@ -6,6 +6,8 @@
 
 #include <commctrl.h>
 
+#include <vector>
+
 #include "atom/browser/ui/win/notify_icon.h"
 #include "base/bind.h"
 #include "base/stl_util.h"
@@ -65,22 +67,24 @@ NotifyIconHost::~NotifyIconHost() {
   if (atom_)
     UnregisterClass(MAKEINTATOM(atom_), instance_);
 
-  NotifyIcons copied_container(notify_icons_);
-  STLDeleteContainerPointers(copied_container.begin(), copied_container.end());
+  // The icons remove themselves from |notify_icons_| when deleted.
+  std::vector<NotifyIcon*> copied_container;
+  for (const auto& it : notify_icons_)
+    copied_container.push_back(it.second);
+  STLDeleteElements(&copied_container);
 }
 
 NotifyIcon* NotifyIconHost::CreateNotifyIcon() {
+  UINT icon_id = NextIconId();
   NotifyIcon* notify_icon =
-      new NotifyIcon(this, NextIconId(), window_, kNotifyIconMessage);
-  notify_icons_.push_back(notify_icon);
+      new NotifyIcon(this, icon_id, window_, kNotifyIconMessage);
+  notify_icons_[icon_id] = notify_icon;
   return notify_icon;
 }
 
 void NotifyIconHost::Remove(NotifyIcon* icon) {
-  NotifyIcons::iterator i(
-      std::find(notify_icons_.begin(), notify_icons_.end(), icon));
-
-  if (i == notify_icons_.end()) {
+  NotifyIcons::iterator i(notify_icons_.find(icon->icon_id()));
+  if (i == notify_icons_.end() || i->second != icon) {
     NOTREACHED();
     return;
   }
@@ -107,29 +111,23 @@ LRESULT CALLBACK NotifyIconHost::WndProc(HWND hwnd,
   if (message == taskbar_created_message_) {
     // We need to reset all of our icons because the taskbar went away.
     for (NotifyIcons::const_iterator i(notify_icons_.begin());
-         i != notify_icons_.end(); ++i) {
-      NotifyIcon* win_icon = static_cast<NotifyIcon*>(*i);
-      win_icon->ResetIcon();
-    }
+         i != notify_icons_.end(); ++i)
+      i->second->ResetIcon();
     return TRUE;
   } else if (message == kNotifyIconMessage) {
-    NotifyIcon* win_icon = NULL;
-
-    // Find the selected status icon.
-    for (NotifyIcons::const_iterator i(notify_icons_.begin());
-         i != notify_icons_.end(); ++i) {
-      NotifyIcon* current_win_icon = static_cast<NotifyIcon*>(*i);
-      if (current_win_icon->icon_id() == wparam) {
-        win_icon = current_win_icon;
-        break;
-      }
-    }
+    // The mouse moves over the icons are sent for every pixel and none of
+    // them is handled, so they are dropped before finding the icon.
+    if (lparam == WM_MOUSEMOVE)
+      return TRUE;
 
     // It is possible for this procedure to be called with an obsolete icon
     // id.  In that case we should just return early before handling any
     // actions.
-    if (!win_icon)
+    NotifyIcons::const_iterator it(
+        notify_icons_.find(static_cast<UINT>(wparam)));
+    if (it == notify_icons_.end())
       return TRUE;
+    NotifyIcon* win_icon = it->second;
 
     switch (lparam) {
       case TB_CHECKBUTTON:
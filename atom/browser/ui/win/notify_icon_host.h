@@ -7,9 +7,8 @@
 
 #include <windows.h>
 
-#include <vector>
-
 #include "base/compiler_specific.h"
+#include "base/containers/hash_tables.h"
 #include "base/memory/scoped_ptr.h"
 
 namespace atom {
@@ -25,7 +24,8 @@ class NotifyIconHost {
   void Remove(NotifyIcon* notify_icon);
 
  private:
-  typedef std::vector<NotifyIcon*> NotifyIcons;
+  // Keyed by the icon IDs, which come with every message of the icons.
+  typedef base::hash_map<UINT, NotifyIcon*> NotifyIcons;
 
   // Static callback invoked when a message comes in to our messaging window.
   static LRESULT CALLBACK
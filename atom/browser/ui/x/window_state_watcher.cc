@@ -6,7 +6,12 @@
 
 #include <X11/Xlib.h>
 
+#include <map>
+
+#include "base/lazy_instance.h"
+#include "ui/events/platform/platform_event_observer.h"
 #include "ui/events/platform/platform_event_source.h"
+#include "ui/gfx/x/x11_atom_cache.h"
 
 namespace atom {
 
@@ -17,62 +22,101 @@ const char* kAtomsToCache[] = {
   NULL,
 };
 
+// Observes the X events for all windows, so every event is only examined once
+// however many windows there are. It is only added to PlatformEventSource
+// while there are windows to watch.
+class WindowStateDispatcher : public ui::PlatformEventObserver {
+ public:
+  WindowStateDispatcher()
+      : atom_cache_(gfx::GetXDisplay(), kAtomsToCache) {
+  }
+
+  void AddWatcher(gfx::AcceleratedWidget widget, WindowStateWatcher* watcher) {
+    if (watchers_.empty())
+      ui::PlatformEventSource::GetInstance()->AddPlatformEventObserver(this);
+    watchers_[widget] = watcher;
+  }
+
+  void RemoveWatcher(gfx::AcceleratedWidget widget) {
+    if (watchers_.erase(widget) > 0 && watchers_.empty())
+      ui::PlatformEventSource::GetInstance()->RemovePlatformEventObserver(this);
+  }
+
+  // ui::PlatformEventObserver:
+  void WillProcessEvent(const ui::PlatformEvent& event) override {
+    WindowStateWatcher* watcher = GetWatcherForEvent(event);
+    if (watcher)
+      watcher->WillProcessStateEvent();
+  }
+
+  void DidProcessEvent(const ui::PlatformEvent& event) override {
+    WindowStateWatcher* watcher = GetWatcherForEvent(event);
+    if (watcher)
+      watcher->DidProcessStateEvent();
+  }
+
+ private:
+  WindowStateWatcher* GetWatcherForEvent(const ui::PlatformEvent& event) {
+    if (event->type != PropertyNotify ||
+        event->xproperty.atom != atom_cache_.GetAtom("_NET_WM_STATE"))
+      return NULL;
+    auto it = watchers_.find(event->xproperty.window);
+    return it == watchers_.end() ? NULL : it->second;
+  }
+
+  ui::X11AtomCache atom_cache_;
+  std::map<gfx::AcceleratedWidget, WindowStateWatcher*> watchers_;
+
+  DISALLOW_COPY_AND_ASSIGN(WindowStateDispatcher);
+};
+
+base::LazyInstance<WindowStateDispatcher>::Leaky g_dispatcher =
+    LAZY_INSTANCE_INITIALIZER;
+
 }  // namespace
 
 WindowStateWatcher::WindowStateWatcher(NativeWindowViews* window)
     : window_(window),
       widget_(window->GetAcceleratedWidget()),
-      atom_cache_(gfx::GetXDisplay(), kAtomsToCache),
       was_minimized_(false),
       was_maximized_(false) {
-  ui::PlatformEventSource::GetInstance()->AddPlatformEventObserver(this);
+  g_dispatcher.Get().AddWatcher(widget_, this);
 }
 
 WindowStateWatcher::~WindowStateWatcher() {
-  ui::PlatformEventSource::GetInstance()->RemovePlatformEventObserver(this);
+  g_dispatcher.Get().RemoveWatcher(widget_);
 }
 
-void WindowStateWatcher::WillProcessEvent(const ui::PlatformEvent& event) {
-  if (IsWindowStateEvent(event)) {
-    was_minimized_ = window_->IsMinimized();
-    was_maximized_ = window_->IsMaximized();
-  }
+void WindowStateWatcher::WillProcessStateEvent() {
+  was_minimized_ = window_->IsMinimized();
+  was_maximized_ = window_->IsMaximized();
 }
 
-void WindowStateWatcher::DidProcessEvent(const ui::PlatformEvent& event) {
-  if (IsWindowStateEvent(event)) {
-    bool is_minimized = window_->IsMinimized();
-    bool is_maximized = window_->IsMaximized();
-    bool is_fullscreen = window_->IsFullscreen();
-    if (is_minimized != was_minimized_) {
-      if (is_minimized)
-        window_->NotifyWindowMinimize();
-      else
-        window_->NotifyWindowRestore();
-    } else if (is_maximized != was_maximized_) {
-      if (is_maximized)
-        window_->NotifyWindowMaximize();
-      else
-        window_->NotifyWindowUnmaximize();
-    } else {
-      // If this is neither a "maximize" or "minimize" event, then we think it
-      // is a "fullscreen" event.
-      // The "IsFullscreen()" becomes true immediately before "WillProcessEvent"
-      // is called, so we can not handle this like "maximize" and "minimize" by
-      // watching whether they have changed.
-      if (is_fullscreen)
-        window_->NotifyWindowEnterFullScreen();
-      else
-        window_->NotifyWindowLeaveFullScreen();
-    }
+void WindowStateWatcher::DidProcessStateEvent() {
+  bool is_minimized = window_->IsMinimized();
+  bool is_maximized = window_->IsMaximized();
+  bool is_fullscreen = window_->IsFullscreen();
+  if (is_minimized != was_minimized_) {
+    if (is_minimized)
+      window_->NotifyWindowMinimize();
+    else
+      window_->NotifyWindowRestore();
+  } else if (is_maximized != was_maximized_) {
+    if (is_maximized)
+      window_->NotifyWindowMaximize();
+    else
+      window_->NotifyWindowUnmaximize();
+  } else {
+    // If this is neither a "maximize" or "minimize" event, then we think it
+    // is a "fullscreen" event.
+    // The "IsFullscreen()" becomes true immediately before "WillProcessEvent"
+    // is called, so we can not handle this like "maximize" and "minimize" by
+    // watching whether they have changed.
+    if (is_fullscreen)
+      window_->NotifyWindowEnterFullScreen();
+    else
+      window_->NotifyWindowLeaveFullScreen();
   }
 }
 
-bool WindowStateWatcher::IsWindowStateEvent(const ui::PlatformEvent& event) {
-  ::Atom changed_atom = event->xproperty.atom;
-  return (changed_atom == atom_cache_.GetAtom("_NET_WM_STATE") &&
-          event->type == PropertyNotify &&
-          event->xproperty.window == widget_);
-}
-
 }  // namespace atom
@@ -5,31 +5,27 @@
 #ifndef ATOM_BROWSER_UI_X_WINDOW_STATE_WATCHER_H_
 #define ATOM_BROWSER_UI_X_WINDOW_STATE_WATCHER_H_
 
-#include "ui/events/platform/platform_event_observer.h"
-
 #include "atom/browser/native_window_views.h"
-#include "ui/gfx/x/x11_atom_cache.h"
 
 namespace atom {
 
-class WindowStateWatcher : public ui::PlatformEventObserver {
+// Notifies |window| of the changes of its _NET_WM_STATE property. The
+// watchers of all windows share one PlatformEventObserver, which finds the
+// watcher of each PropertyNotify event by the XID of its window.
+class WindowStateWatcher {
  public:
   explicit WindowStateWatcher(NativeWindowViews* window);
-  virtual ~WindowStateWatcher();
+  ~WindowStateWatcher();
 
- protected:
-  // ui::PlatformEventObserver:
-  void WillProcessEvent(const ui::PlatformEvent& event) override;
-  void DidProcessEvent(const ui::PlatformEvent& event) override;
+  // Called by the shared observer before and after the window processes the
+  // state event.
+  void WillProcessStateEvent();
+  void DidProcessStateEvent();
 
  private:
-  bool IsWindowStateEvent(const ui::PlatformEvent& event);
-
   NativeWindowViews* window_;
   gfx::AcceleratedWidget widget_;
 
-  ui::X11AtomCache atom_cache_;
-
   bool was_minimized_;
   bool was_maximized_;
 
@@ -5,9 +5,14 @@
 #include "atom/browser/web_view_manager.h"
 
 #include "atom/browser/atom_browser_context.h"
+#include "base/bind.h"
+#include "base/stl_util.h"
+#include "content/public/browser/browser_thread.h"
 #include "content/public/browser/render_process_host.h"
 #include "content/public/browser/web_contents.h"
 
+using content::BrowserThread;
+
 namespace atom {
 
 // static
@@ -24,7 +29,8 @@ bool WebViewManager::GetInfoForProcess(content::RenderProcessHost* process,
   return static_cast<WebViewManager*>(manager)->GetInfo(process->GetID(), info);
 }
 
-WebViewManager::WebViewManager(content::BrowserContext* context) {
+WebViewManager::WebViewManager(content::BrowserContext* context)
+    : io_webview_info_map_(new IOThreadInfoMap) {
 }
 
 WebViewManager::~WebViewManager() {
@@ -35,19 +41,25 @@ void WebViewManager::AddGuest(int guest_instance_id,
                               content::WebContents* embedder,
                               content::WebContents* web_contents,
                               const WebViewInfo& info) {
-  base::AutoLock auto_lock(lock_);
+  DCHECK(BrowserThread::CurrentlyOn(BrowserThread::UI));
   web_contents_embdder_map_[guest_instance_id] = { web_contents, embedder };
 
   int guest_process_id = web_contents->GetRenderProcessHost()->GetID();
   webview_info_map_[guest_process_id] = info;
-
-  // Map the element in embedder to guest.
-  ElementInstanceKey key(embedder, element_instance_id);
-  element_instance_id_to_guest_map_[key] = guest_instance_id;
+  BrowserThread::PostTask(
+      BrowserThread::IO, FROM_HERE,
+      base::Bind(&IOThreadInfoMap::Set, io_webview_info_map_,
+                 guest_process_id, info));
+
+  // Map the element in embedder to guest, a spare guest has no element yet.
+  if (embedder) {
+    ElementInstanceKey key(embedder, element_instance_id);
+    element_instance_id_to_guest_map_[key] = guest_instance_id;
+  }
 }
 
 void WebViewManager::RemoveGuest(int guest_instance_id) {
-  base::AutoLock auto_lock(lock_);
+  DCHECK(BrowserThread::CurrentlyOn(BrowserThread::UI));
   if (!ContainsKey(web_contents_embdder_map_, guest_instance_id))
     return;
 
@@ -56,6 +68,10 @@ void WebViewManager::RemoveGuest(int guest_instance_id) {
 
   int guest_process_id = web_contents->GetRenderProcessHost()->GetID();
   webview_info_map_.erase(guest_process_id);
+  BrowserThread::PostTask(
+      BrowserThread::IO, FROM_HERE,
+      base::Bind(&IOThreadInfoMap::Remove, io_webview_info_map_,
+                 guest_process_id));
 
   // Remove the record of element in embedder too.
   for (const auto& element : element_instance_id_to_guest_map_)
@@ -66,13 +82,16 @@ void WebViewManager::RemoveGuest(int guest_instance_id) {
 }
 
 bool WebViewManager::GetInfo(int guest_process_id, WebViewInfo* webview_info) {
-  base::AutoLock auto_lock(lock_);
-  WebViewInfoMap::iterator iter = webview_info_map_.find(guest_process_id);
-  if (iter != webview_info_map_.end()) {
-    *webview_info = iter->second;
-    return true;
-  }
-  return false;
+  if (BrowserThread::CurrentlyOn(BrowserThread::IO))
+    return io_webview_info_map_->Get(guest_process_id, webview_info);
+
+  DCHECK(BrowserThread::CurrentlyOn(BrowserThread::UI));
+  WebViewInfoMap::const_iterator iter =
+      webview_info_map_.find(guest_process_id);
+  if (iter == webview_info_map_.end())
+    return false;
+  *webview_info = iter->second;
+  return true;
 }
 
 content::WebContents* WebViewManager::GetGuestByInstanceID(
@@ -98,4 +117,25 @@ bool WebViewManager::ForEachGuest(content::WebContents* embedder_web_contents,
   return false;
 }
 
+void WebViewManager::IOThreadInfoMap::Set(int guest_process_id,
+                                          const WebViewInfo& info) {
+  DCHECK(BrowserThread::CurrentlyOn(BrowserThread::IO));
+  map_[guest_process_id] = info;
+}
+
+void WebViewManager::IOThreadInfoMap::Remove(int guest_process_id) {
+  DCHECK(BrowserThread::CurrentlyOn(BrowserThread::IO));
+  map_.erase(guest_process_id);
+}
+
+bool WebViewManager::IOThreadInfoMap::Get(int guest_process_id,
+                                          WebViewInfo* info) const {
+  DCHECK(BrowserThread::CurrentlyOn(BrowserThread::IO));
+  WebViewInfoMap::const_iterator iter = map_.find(guest_process_id);
+  if (iter == map_.end())
+    return false;
+  *info = iter->second;
+  return true;
+}
+
 }  // namespace atom
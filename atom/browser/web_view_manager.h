@@ -7,8 +7,9 @@
 
 #include <map>
 
+#include "base/containers/hash_tables.h"
 #include "base/files/file_path.h"
-#include "base/synchronization/lock.h"
+#include "base/memory/ref_counted.h"
 #include "content/public/browser/browser_plugin_guest_manager.h"
 
 namespace content {
@@ -30,13 +31,14 @@ class WebViewManager : public content::BrowserPluginGuestManager {
   };
 
   // Finds the WebViewManager attached with |process| and returns the
-  // WebViewInfo of it.
+  // WebViewInfo of it. Should be called on UI thread.
   static bool GetInfoForProcess(content::RenderProcessHost* process,
                                 WebViewInfo* info);
 
   explicit WebViewManager(content::BrowserContext* context);
   virtual ~WebViewManager();
 
+  // The |embedder| is null for guests that are not attached yet.
   void AddGuest(int guest_instance_id,
                 int element_instance_id,
                 content::WebContents* embedder,
@@ -45,7 +47,8 @@ class WebViewManager : public content::BrowserPluginGuestManager {
   void RemoveGuest(int guest_instance_id);
 
   // Looks up the information for the embedder <webview> for a given render
-  // view, if one exists. Called on the IO thread.
+  // process, if one exists. Can be called on UI or IO thread, each of them
+  // reads its own copy of the table so there is no locking.
   bool GetInfo(int guest_process_id, WebViewInfo* webview_info);
 
  protected:
@@ -87,11 +90,31 @@ class WebViewManager : public content::BrowserPluginGuestManager {
   // (web_contents, element_instance_id) => guest_instance_id
   std::map<ElementInstanceKey, int> element_instance_id_to_guest_map_;
 
-  typedef std::map<int, WebViewInfo> WebViewInfoMap;
-  // guest_process_id => (guest_instance_id, embedder, ...)
-  WebViewInfoMap webview_info_map_;
+  typedef base::hash_map<int, WebViewInfo> WebViewInfoMap;
+
+  // The copy of |webview_info_map_| read on IO thread, it is only changed by
+  // the tasks posted from UI thread.
+  class IOThreadInfoMap : public base::RefCountedThreadSafe<IOThreadInfoMap> {
+   public:
+    IOThreadInfoMap() {}
+
+    void Set(int guest_process_id, const WebViewInfo& info);
+    void Remove(int guest_process_id);
+    bool Get(int guest_process_id, WebViewInfo* info) const;
+
+   private:
+    friend class base::RefCountedThreadSafe<IOThreadInfoMap>;
+    ~IOThreadInfoMap() {}
 
-  base::Lock lock_;
+    WebViewInfoMap map_;
+
+    DISALLOW_COPY_AND_ASSIGN(IOThreadInfoMap);
+  };
+
+  // guest_process_id => (guest_instance_id, embedder, ...), only accessed on
+  // UI thread.
+  WebViewInfoMap webview_info_map_;
+  scoped_refptr<IOThreadInfoMap> io_webview_info_map_;
 
   DISALLOW_COPY_AND_ASSIGN(WebViewManager);
 };
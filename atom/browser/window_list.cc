@@ -74,6 +74,13 @@ void WindowList::CloseAllWindows() {
     windows[i]->Close();
 }
 
+// static
+void WindowList::DestroyAllWindows() {
+  WindowVector windows = GetInstance()->windows_;
+  for (size_t i = 0; i < windows.size(); ++i)
+    windows[i]->CloseImmediately();
+}
+
 WindowList::WindowList() {
 }
 
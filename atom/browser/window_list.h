@@ -48,9 +48,13 @@ class WindowList {
   static void AddObserver(WindowListObserver* observer);
   static void RemoveObserver(WindowListObserver* observer);
 
-  // Closes all windows.
+  // Asks all windows to close, their pages run the unload handlers at the
+  // same time instead of one after another.
   static void CloseAllWindows();
 
+  // Destroys all windows without running the unload handlers of pages.
+  static void DestroyAllWindows();
+
  private:
   WindowList();
   ~WindowList();
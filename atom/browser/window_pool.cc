@@ -0,0 +1,115 @@
+// Copyright (c) 2015 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#include "atom/browser/window_pool.h"
+
+#include "atom/browser/native_window.h"
+#include "atom/common/native_mate_converters/value_converter.h"
+#include "atom/common/options_switches.h"
+#include "base/json/json_writer.h"
+#include "base/memory/singleton.h"
+#include "base/values.h"
+#include "native_mate/dictionary.h"
+
+namespace atom {
+
+namespace {
+
+// The number of windows kept by the pool.
+const size_t kMaxPooledWindows = 4;
+
+// The options that NativeWindow::Reopen and InitFromOptions can apply to a
+// recycled window.
+const char* kReopenableOptions[] = {
+  switches::kX,
+  switches::kY,
+  switches::kWidth,
+  switches::kHeight,
+  switches::kCenter,
+  switches::kTitle,
+  switches::kShow,
+  switches::kAlwaysOnTop,
+  switches::kFullscreen,
+  switches::kSkipTaskbar,
+  switches::kKiosk,
+  switches::kZoomFactor,
+  switches::kCoalesceBoundsEvents,
+  switches::kBackgroundThrottling,
+};
+
+}  // namespace
+
+// static
+WindowPool* WindowPool::GetInstance() {
+  return Singleton<WindowPool>::get();
+}
+
+// static
+bool WindowPool::GetProfile(const mate::Dictionary& options,
+                            std::string* profile) {
+  bool recyclable = false;
+  if (!options.Get(switches::kRecyclable, &recyclable) || !recyclable)
+    return false;
+
+  // An icon given as NativeImage can not be compared.
+  v8::Handle<v8::Value> icon;
+  if (options.Get(switches::kIcon, &icon) && !icon->IsString())
+    return false;
+
+  base::DictionaryValue dict;
+  if (!mate::ConvertFromV8(options.isolate(), options.GetHandle(), &dict))
+    return false;
+  for (size_t i = 0; i < arraysize(kReopenableOptions); ++i)
+    dict.RemoveWithoutPathExpansion(kReopenableOptions[i], nullptr);
+
+  base::JSONWriter::Write(&dict, profile);
+  return true;
+}
+
+WindowPool::WindowPool() {
+}
+
+WindowPool::~WindowPool() {
+  DCHECK(windows_.empty());
+}
+
+scoped_ptr<NativeWindow> WindowPool::Take(const std::string& profile) {
+  for (auto iter = windows_.begin(); iter != windows_.end(); ++iter) {
+    if (iter->profile != profile)
+      continue;
+
+    NativeWindow* window = iter->window;
+    windows_.erase(iter);
+    return make_scoped_ptr(window);
+  }
+  return scoped_ptr<NativeWindow>();
+}
+
+void WindowPool::Add(const std::string& profile,
+                     scoped_ptr<NativeWindow> window) {
+  DCHECK(window->is_recycled());
+  if (windows_.size() >= kMaxPooledWindows) {
+    DestroyWindow(windows_.front().window);
+    windows_.pop_front();
+  }
+
+  Entry entry = { profile, window.release() };
+  windows_.push_back(entry);
+}
+
+void WindowPool::Clear() {
+  std::deque<Entry> windows;
+  windows.swap(windows_);
+  for (const Entry& entry : windows)
+    DestroyWindow(entry.window);
+}
+
+// static
+void WindowPool::DestroyWindow(NativeWindow* window) {
+  window->DestroyWebContents();
+  window->CloseImmediately();
+  delete window;
+}
+
+}  // namespace atom
@@ -0,0 +1,69 @@
+// Copyright (c) 2015 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#ifndef ATOM_BROWSER_WINDOW_POOL_H_
+#define ATOM_BROWSER_WINDOW_POOL_H_
+
+#include <deque>
+#include <string>
+
+#include "base/basictypes.h"
+#include "base/memory/scoped_ptr.h"
+
+template <typename T> struct DefaultSingletonTraits;
+
+namespace mate {
+class Dictionary;
+}
+
+namespace atom {
+
+class NativeWindow;
+
+// Keeps the recycled windows, so a new window can reuse the native window,
+// WebContents and devtools of a closed one instead of creating them again.
+//
+// Windows are matched by a profile made of the options that can not be
+// changed after creation, the others are applied by NativeWindow::Reopen.
+class WindowPool {
+ public:
+  static WindowPool* GetInstance();
+
+  // Computes the profile of windows created with |options|, returns false if
+  // they can not be recycled.
+  static bool GetProfile(const mate::Dictionary& options,
+                         std::string* profile);
+
+  // Takes a recycled window with |profile|, returns nullptr if there is none.
+  scoped_ptr<NativeWindow> Take(const std::string& profile);
+
+  // Keeps a recycled window, the oldest one is destroyed when the pool is
+  // full.
+  void Add(const std::string& profile, scoped_ptr<NativeWindow> window);
+
+  // Destroys all windows, should be called before the browser context is
+  // destroyed.
+  void Clear();
+
+ private:
+  friend struct DefaultSingletonTraits<WindowPool>;
+
+  WindowPool();
+  ~WindowPool();
+
+  struct Entry {
+    std::string profile;
+    NativeWindow* window;
+  };
+
+  static void DestroyWindow(NativeWindow* window);
+
+  std::deque<Entry> windows_;
+
+  DISALLOW_COPY_AND_ASSIGN(WindowPool);
+};
+
+}  // namespace atom
+
+#endif  // ATOM_BROWSER_WINDOW_POOL_H_
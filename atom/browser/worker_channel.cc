@@ -0,0 +1,150 @@
+// Copyright (c) 2015 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#include "atom/browser/worker_channel.h"
+
+#include <map>
+#include <vector>
+
+#include "atom/common/api/api_messages.h"
+#include "atom/common/native_mate_converters/v8_value_serializer.h"
+#include "base/bind.h"
+#include "base/lazy_instance.h"
+#include "base/strings/utf_string_conversions.h"
+#include "base/synchronization/lock.h"
+#include "content/public/browser/browser_message_filter.h"
+
+using content::BrowserThread;
+
+namespace atom {
+
+namespace {
+
+typedef std::map<base::string16, scoped_refptr<WorkerChannel>> WorkerMap;
+
+// Written on UI thread, read on IO thread.
+base::LazyInstance<WorkerMap>::Leaky g_workers = LAZY_INSTANCE_INITIALIZER;
+base::LazyInstance<base::Lock>::Leaky g_workers_lock =
+    LAZY_INSTANCE_INITIALIZER;
+
+}  // namespace
+
+// static
+void WorkerChannel::Register(const base::string16& channel,
+                             const base::FilePath& script) {
+  DCHECK(BrowserThread::CurrentlyOn(BrowserThread::UI));
+  scoped_refptr<WorkerChannel> worker(new WorkerChannel(channel, script));
+  if (!worker->host_.Start())
+    return;
+
+  base::AutoLock auto_lock(g_workers_lock.Get());
+  g_workers.Get()[channel] = worker;
+}
+
+// static
+void WorkerChannel::Unregister(const base::string16& channel) {
+  DCHECK(BrowserThread::CurrentlyOn(BrowserThread::UI));
+  base::AutoLock auto_lock(g_workers_lock.Get());
+  g_workers.Get().erase(channel);
+}
+
+// static
+scoped_refptr<WorkerChannel> WorkerChannel::FromChannel(
+    const base::string16& channel) {
+  base::AutoLock auto_lock(g_workers_lock.Get());
+  WorkerMap& workers = g_workers.Get();
+  WorkerMap::iterator iter = workers.find(channel);
+  if (iter == workers.end())
+    return nullptr;
+  return iter->second;
+}
+
+WorkerChannel::WorkerChannel(const base::string16& channel,
+                             const base::FilePath& script)
+    : host_("WorkerChannel_" + base::UTF16ToUTF8(channel), script, false,
+            this),
+      current_filter_(nullptr),
+      current_routing_id_(MSG_ROUTING_NONE) {
+}
+
+WorkerChannel::~WorkerChannel() {
+  DCHECK(BrowserThread::CurrentlyOn(BrowserThread::UI));
+  // The pending messages hold references to us, so they have all been
+  // handled at this point.
+  host_.Stop();
+}
+
+void WorkerChannel::PostMessage(
+    scoped_refptr<content::BrowserMessageFilter> filter,
+    int routing_id,
+    scoped_ptr<SerializedValue> args) {
+  host_.PostTask(base::Bind(&WorkerChannel::HandleMessageOnWorkerThread,
+                            this, filter, routing_id, base::Passed(&args)));
+}
+
+void WorkerChannel::SetUpGlobal(v8::Isolate* isolate,
+                                v8::Local<v8::Object> global) {
+  v8::Local<v8::FunctionTemplate> reply = v8::FunctionTemplate::New(
+      isolate, &WorkerChannel::Reply, v8::External::New(isolate, this));
+  global->Set(v8::String::NewFromUtf8(isolate, "reply"),
+              reply->GetFunction());
+}
+
+void WorkerChannel::OnScriptError(const std::string& message) {
+  LOG(ERROR) << "Uncaught exception in worker channel: " << message;
+}
+
+void WorkerChannel::HandleMessageOnWorkerThread(
+    scoped_refptr<content::BrowserMessageFilter> filter,
+    int routing_id,
+    scoped_ptr<SerializedValue> args) {
+  WorkerHost::Scope scope(&host_);
+  v8::Local<v8::Function> onmessage = host_.GetFunction("onmessage");
+  if (onmessage.IsEmpty()) {
+    LOG(ERROR) << "Worker channel script does not define onmessage";
+    return;
+  }
+
+  std::vector<v8::Local<v8::Value>> argv;
+  if (!host_.DeserializeArguments(*args, &argv))
+    return;
+
+  current_filter_ = filter.get();
+  current_routing_id_ = routing_id;
+  host_.Call(onmessage, argv);
+  current_filter_ = nullptr;
+  current_routing_id_ = MSG_ROUTING_NONE;
+}
+
+// static
+void WorkerChannel::Reply(const v8::FunctionCallbackInfo<v8::Value>& info) {
+  v8::Isolate* isolate = info.GetIsolate();
+  WorkerChannel* self = static_cast<WorkerChannel*>(
+      v8::Local<v8::External>::Cast(info.Data())->Value());
+  if (!self->current_filter_) {
+    isolate->ThrowException(v8::Exception::Error(v8::String::NewFromUtf8(
+        isolate, "reply can only be called inside onmessage")));
+    return;
+  }
+  if (info.Length() < 1 || !info[0]->IsString()) {
+    isolate->ThrowException(v8::Exception::TypeError(v8::String::NewFromUtf8(
+        isolate, "The channel must be a string")));
+    return;
+  }
+
+  v8::String::Value channel(info[0]);
+  v8::Local<v8::Array> array = v8::Array::New(isolate, info.Length() - 1);
+  for (int i = 1; i < info.Length(); ++i)
+    array->Set(i - 1, info[i]);
+
+  SerializedValue args;
+  SerializeV8Value(isolate, array, &args);
+  self->current_filter_->Send(new AtomViewMsg_Message(
+      self->current_routing_id_,
+      base::string16(reinterpret_cast<const base::char16*>(*channel),
+                     channel.length()),
+      args));
+}
+
+}  // namespace atom
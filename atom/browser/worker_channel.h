@@ -0,0 +1,84 @@
+// Copyright (c) 2015 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#ifndef ATOM_BROWSER_WORKER_CHANNEL_H_
+#define ATOM_BROWSER_WORKER_CHANNEL_H_
+
+#include <string>
+
+#include "atom/browser/worker_host.h"
+#include "base/files/file_path.h"
+#include "base/memory/ref_counted.h"
+#include "base/memory/scoped_ptr.h"
+#include "base/strings/string16.h"
+#include "content/public/browser/browser_thread.h"
+#include "v8/include/v8.h"
+
+namespace content {
+class BrowserMessageFilter;
+}
+
+namespace atom {
+
+class SerializedValue;
+
+// Handles the messages of one channel sent by ipc.sendToWorker on a dedicated
+// thread, so a flood of them does not block the UI thread. The thread runs a
+// plain V8 isolate without Node, in which a script defines the |onmessage|
+// function and can answer the sender with the global |reply| function.
+class WorkerChannel : public base::RefCountedThreadSafe<
+                          WorkerChannel,
+                          content::BrowserThread::DeleteOnUIThread>,
+                      public WorkerHost::Delegate {
+ public:
+  // Starts a worker running |script| for |channel|, replacing the old one.
+  // Should be called on UI thread.
+  static void Register(const base::string16& channel,
+                       const base::FilePath& script);
+  static void Unregister(const base::string16& channel);
+
+  // Returns the worker registered for |channel|, can be called on any thread.
+  static scoped_refptr<WorkerChannel> FromChannel(
+      const base::string16& channel);
+
+  // Runs |onmessage| with |args| on the worker thread, replies are sent to
+  // the view |routing_id| through |filter|.
+  void PostMessage(scoped_refptr<content::BrowserMessageFilter> filter,
+                   int routing_id,
+                   scoped_ptr<SerializedValue> args);
+
+ private:
+  friend struct content::BrowserThread::DeleteOnThread<
+      content::BrowserThread::UI>;
+  friend class base::DeleteHelper<WorkerChannel>;
+
+  WorkerChannel(const base::string16& channel, const base::FilePath& script);
+  ~WorkerChannel() override;
+
+  // WorkerHost::Delegate:
+  void SetUpGlobal(v8::Isolate* isolate,
+                   v8::Local<v8::Object> global) override;
+  void OnScriptError(const std::string& message) override;
+
+  void HandleMessageOnWorkerThread(
+      scoped_refptr<content::BrowserMessageFilter> filter,
+      int routing_id,
+      scoped_ptr<SerializedValue> args);
+
+  // The |reply(channel, args...)| function of the script.
+  static void Reply(const v8::FunctionCallbackInfo<v8::Value>& info);
+
+  WorkerHost host_;
+
+  // The sender of the message being handled, |reply| only works while
+  // |onmessage| is running.
+  content::BrowserMessageFilter* current_filter_;
+  int current_routing_id_;
+
+  DISALLOW_COPY_AND_ASSIGN(WorkerChannel);
+};
+
+}  // namespace atom
+
+#endif  // ATOM_BROWSER_WORKER_CHANNEL_H_
@@ -0,0 +1,49 @@
+// Copyright (c) 2015 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#include "atom/browser/worker_channel_message_filter.h"
+
+#include "atom/browser/worker_channel.h"
+#include "atom/common/api/api_messages.h"
+#include "base/strings/utf_string_conversions.h"
+
+namespace atom {
+
+WorkerChannelMessageFilter::WorkerChannelMessageFilter()
+    : BrowserMessageFilter(ShellMsgStart),
+      routing_id_(MSG_ROUTING_NONE) {
+}
+
+WorkerChannelMessageFilter::~WorkerChannelMessageFilter() {
+}
+
+bool WorkerChannelMessageFilter::OnMessageReceived(
+    const IPC::Message& message) {
+  routing_id_ = message.routing_id();
+  bool handled = true;
+  IPC_BEGIN_MESSAGE_MAP(WorkerChannelMessageFilter, message)
+    IPC_MESSAGE_HANDLER(AtomViewHostMsg_WorkerMessage, OnWorkerMessage)
+    IPC_MESSAGE_UNHANDLED(handled = false)
+  IPC_END_MESSAGE_MAP()
+  routing_id_ = MSG_ROUTING_NONE;
+  return handled;
+}
+
+void WorkerChannelMessageFilter::OnWorkerMessage(
+    const base::string16& channel,
+    const SerializedValue& args) {
+  scoped_refptr<WorkerChannel> worker = WorkerChannel::FromChannel(channel);
+  if (!worker) {
+    LOG(WARNING) << "No worker registered for channel "
+                 << base::UTF16ToUTF8(channel);
+    return;
+  }
+
+  // The |args| only refers to the message, which is gone after dispatching.
+  scoped_ptr<SerializedValue> copy(new SerializedValue);
+  copy->CopyFrom(args);
+  worker->PostMessage(this, routing_id_, copy.Pass());
+}
+
+}  // namespace atom
@@ -0,0 +1,38 @@
+// Copyright (c) 2015 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#ifndef ATOM_BROWSER_WORKER_CHANNEL_MESSAGE_FILTER_H_
+#define ATOM_BROWSER_WORKER_CHANNEL_MESSAGE_FILTER_H_
+
+#include "base/strings/string16.h"
+#include "content/public/browser/browser_message_filter.h"
+
+namespace atom {
+
+class SerializedValue;
+
+// Receives the messages sent by ipc.sendToWorker on IO thread and passes them
+// to the registered WorkerChannel, without going through the UI thread.
+class WorkerChannelMessageFilter : public content::BrowserMessageFilter {
+ public:
+  WorkerChannelMessageFilter();
+
+  // content::BrowserMessageFilter:
+  bool OnMessageReceived(const IPC::Message& message) override;
+
+ private:
+  virtual ~WorkerChannelMessageFilter();
+
+  void OnWorkerMessage(const base::string16& channel,
+                       const SerializedValue& args);
+
+  // The routing ID of the message being dispatched.
+  int routing_id_;
+
+  DISALLOW_COPY_AND_ASSIGN(WorkerChannelMessageFilter);
+};
+
+}  // namespace atom
+
+#endif  // ATOM_BROWSER_WORKER_CHANNEL_MESSAGE_FILTER_H_
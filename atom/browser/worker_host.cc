@@ -0,0 +1,322 @@
+// Copyright (c) 2015 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#include "atom/browser/worker_host.h"
+
+#include "atom/common/native_mate_converters/v8_value_serializer.h"
+#include "base/files/file_util.h"
+#include "base/lazy_instance.h"
+#include "base/logging.h"
+#include "base/threading/thread_local.h"
+#include "base/threading/thread_restrictions.h"
+
+#include "atom/common/node_includes.h"
+
+namespace atom {
+
+namespace {
+
+// The host running on current thread, used to route the messages of the
+// exceptions nobody caught.
+base::LazyInstance<base::ThreadLocalPointer<WorkerHost>>::Leaky
+    g_current_host = LAZY_INSTANCE_INITIALIZER;
+
+// Node keeps process wide state, like the process object and the signal
+// handlers, that is not safe to share between environments running at the
+// same time on different threads. So besides the main thread, only one
+// worker thread at a time gets a Node environment.
+base::LazyInstance<base::Lock>::Leaky g_node_host_lock =
+    LAZY_INSTANCE_INITIALIZER;
+bool g_node_host_running = false;
+
+bool AcquireNodeHost() {
+  base::AutoLock auto_lock(g_node_host_lock.Get());
+  if (g_node_host_running)
+    return false;
+  g_node_host_running = true;
+  return true;
+}
+
+void ReleaseNodeHost() {
+  base::AutoLock auto_lock(g_node_host_lock.Get());
+  g_node_host_running = false;
+}
+
+// Run by Node as the eval script of the environment, so the worker script is
+// evaluated in global scope like the plain V8 workers, while still getting a
+// |require| that resolves modules relative to the script.
+const char kNodeBootstrap[] =
+    "(function() {\n"
+    "  var fs = require('fs');\n"
+    "  var path = require('path');\n"
+    "  var Module = require('module');\n"
+    "  var filename = path.resolve(process.argv[1]);\n"
+    "  var dirname = path.dirname(filename);\n"
+    "  var module = new Module(filename, null);\n"
+    "  module.filename = filename;\n"
+    "  module.paths = Module._nodeModulePaths(dirname);\n"
+    "  global.require = function(id) { return module.require(id); };\n"
+    "  global.module = module;\n"
+    "  global.exports = module.exports;\n"
+    "  global.__filename = filename;\n"
+    "  global.__dirname = dirname;\n"
+    "  process.exit = process.abort = function() {\n"
+    "    throw new Error('Workers can not end the process');\n"
+    "  };\n"
+    "  var source = fs.readFileSync(filename, 'utf8');\n"
+    "  require('vm').runInThisContext(source, {filename: filename});\n"
+    "})();\n";
+
+void CloseHandle(uv_handle_t* handle, void* arg) {
+  if (!uv_is_closing(handle))
+    uv_close(handle, nullptr);
+}
+
+}  // namespace
+
+WorkerHost::Scope::Scope(WorkerHost* host)
+    : isolate_scope_(host->isolate()),
+      handle_scope_(host->isolate()),
+      context_scope_(host->context()) {
+}
+
+WorkerHost::Scope::~Scope() {
+}
+
+WorkerHost::WorkerHost(const std::string& name,
+                       const base::FilePath& script,
+                       bool use_node,
+                       Delegate* delegate)
+    : name_(name),
+      script_(script),
+      use_node_(use_node),
+      delegate_(delegate),
+      started_(false),
+      stopping_(false),
+      isolate_(nullptr),
+      env_(nullptr) {
+}
+
+WorkerHost::~WorkerHost() {
+  Stop();
+}
+
+bool WorkerHost::Start() {
+  DCHECK(!started_);
+  if (use_node_ && !AcquireNodeHost())
+    return false;
+
+  uv_loop_init(&loop_);
+  uv_async_init(&loop_, &wakeup_, &WorkerHost::OnWakeup);
+  wakeup_.data = this;
+
+  v8::Isolate::CreateParams params;
+  isolate_ = v8::Isolate::New(params);
+
+  if (!base::PlatformThread::Create(0, this, &thread_)) {
+    uv_close(reinterpret_cast<uv_handle_t*>(&wakeup_), nullptr);
+    uv_run(&loop_, UV_RUN_DEFAULT);
+    uv_loop_close(&loop_);
+    isolate_->Dispose();
+    isolate_ = nullptr;
+    if (use_node_)
+      ReleaseNodeHost();
+    return false;
+  }
+
+  started_ = true;
+  return true;
+}
+
+void WorkerHost::Stop() {
+  {
+    base::AutoLock auto_lock(lock_);
+    if (!started_ || stopping_)
+      return;
+    stopping_ = true;
+    uv_async_send(&wakeup_);
+  }
+
+  // Abort the script if it is busy, the loop quits once it gets back. The
+  // isolate is only disposed after the thread is joined, so it is still
+  // alive here without holding |lock_|.
+  isolate_->TerminateExecution();
+
+  {
+    base::ThreadRestrictions::ScopedAllowIO allow_io;
+    base::PlatformThread::Join(thread_);
+  }
+
+  isolate_->Dispose();
+  isolate_ = nullptr;
+  if (use_node_)
+    ReleaseNodeHost();
+}
+
+bool WorkerHost::PostTask(const base::Closure& task) {
+  base::AutoLock auto_lock(lock_);
+  if (!started_ || stopping_)
+    return false;
+  pending_tasks_.push_back(task);
+  uv_async_send(&wakeup_);
+  return true;
+}
+
+v8::Local<v8::Context> WorkerHost::context() const {
+  return v8::Local<v8::Context>::New(isolate_, context_);
+}
+
+v8::Local<v8::Function> WorkerHost::GetFunction(const char* name) {
+  v8::Local<v8::Value> value =
+      context()->Global()->Get(v8::String::NewFromUtf8(isolate_, name));
+  if (value.IsEmpty() || !value->IsFunction())
+    return v8::Local<v8::Function>();
+  return v8::Local<v8::Function>::Cast(value);
+}
+
+bool WorkerHost::DeserializeArguments(
+    const SerializedValue& args,
+    std::vector<v8::Local<v8::Value>>* argv) {
+  v8::Local<v8::Value> value = DeserializeV8ValueWithoutNode(isolate_, args);
+  if (value.IsEmpty() || !value->IsArray())
+    return false;
+
+  v8::Local<v8::Array> array = v8::Local<v8::Array>::Cast(value);
+  argv->resize(array->Length());
+  for (uint32_t i = 0; i < array->Length(); ++i)
+    (*argv)[i] = array->Get(i);
+  return true;
+}
+
+v8::Local<v8::Value> WorkerHost::Call(
+    v8::Local<v8::Function> function,
+    const std::vector<v8::Local<v8::Value>>& argv) {
+  v8::TryCatch try_catch;
+  v8::Local<v8::Value> result = function->Call(
+      context()->Global(), static_cast<int>(argv.size()),
+      argv.empty() ? nullptr : const_cast<v8::Local<v8::Value>*>(&argv[0]));
+  if (try_catch.HasCaught()) {
+    ReportException(try_catch);
+    return v8::Local<v8::Value>();
+  }
+  return result;
+}
+
+void WorkerHost::ThreadMain() {
+  base::PlatformThread::SetName(name_.c_str());
+  g_current_host.Get().Set(this);
+
+  {
+    v8::Isolate::Scope isolate_scope(isolate_);
+    v8::HandleScope handle_scope(isolate_);
+    v8::Local<v8::Context> context = v8::Context::New(isolate_);
+    context_.Reset(isolate_, context);
+    v8::Context::Scope context_scope(context);
+
+    // Node reports the exceptions thrown in its callbacks to the message
+    // listeners, which are per isolate.
+    v8::V8::AddMessageListener(&WorkerHost::OnMessage);
+
+    delegate_->SetUpGlobal(isolate_, context->Global());
+    if (use_node_)
+      RunNodeScript();
+    else
+      RunScript();
+  }
+
+  uv_run(&loop_, UV_RUN_DEFAULT);
+
+  DisposeOnWorkerThread();
+  g_current_host.Get().Set(nullptr);
+}
+
+void WorkerHost::RunScript() {
+  std::string source;
+  if (!base::ReadFileToString(script_, &source)) {
+    delegate_->OnScriptError("Unable to read " + script_.AsUTF8Unsafe());
+    return;
+  }
+
+  v8::TryCatch try_catch;
+  v8::Local<v8::Script> script = v8::Script::Compile(
+      v8::String::NewFromUtf8(isolate_, source.data(),
+                              v8::String::kNormalString,
+                              static_cast<int>(source.size())),
+      v8::String::NewFromUtf8(isolate_, script_.AsUTF8Unsafe().c_str()));
+  if (script.IsEmpty() || script->Run().IsEmpty())
+    ReportException(try_catch);
+}
+
+void WorkerHost::RunNodeScript() {
+  std::string script = script_.AsUTF8Unsafe();
+  const char* argv[] = { "atom", script.c_str() };
+  env_ = node::CreateEnvironment(isolate_, &loop_, context(),
+                                 arraysize(argv), argv, 0, nullptr);
+
+  // Without an eval script Node would read the script from stdin or start a
+  // REPL, instead of running it in global scope.
+  env_->process_object()->Set(
+      v8::String::NewFromUtf8(isolate_, "_eval"),
+      v8::String::NewFromUtf8(isolate_, kNodeBootstrap));
+  node::LoadEnvironment(env_);
+}
+
+void WorkerHost::RunPendingTasks() {
+  std::vector<base::Closure> tasks;
+  bool stopping;
+  {
+    base::AutoLock auto_lock(lock_);
+    tasks.swap(pending_tasks_);
+    stopping = stopping_;
+  }
+
+  if (stopping) {
+    // Closing every handle lets the loop quit, including the handles of
+    // Node, the wakeup handle is never signaled again after |stopping_|.
+    uv_walk(&loop_, &CloseHandle, nullptr);
+    return;
+  }
+
+  for (size_t i = 0; i < tasks.size(); ++i)
+    tasks[i].Run();
+}
+
+void WorkerHost::ReportException(const v8::TryCatch& try_catch) {
+  // Being terminated is not an error of the script.
+  if (try_catch.HasTerminated())
+    return;
+  v8::String::Utf8Value message(try_catch.Exception());
+  delegate_->OnScriptError(*message ? *message : "<unknown>");
+}
+
+void WorkerHost::DisposeOnWorkerThread() {
+  {
+    v8::Isolate::Scope isolate_scope(isolate_);
+    v8::HandleScope handle_scope(isolate_);
+    v8::Context::Scope context_scope(context());
+    if (env_) {
+      env_->Dispose();
+      env_ = nullptr;
+    }
+  }
+  context_.Reset();
+  uv_loop_close(&loop_);
+}
+
+// static
+void WorkerHost::OnWakeup(uv_async_t* handle) {
+  static_cast<WorkerHost*>(handle->data)->RunPendingTasks();
+}
+
+// static
+void WorkerHost::OnMessage(v8::Handle<v8::Message> message,
+                           v8::Handle<v8::Value> error) {
+  WorkerHost* self = g_current_host.Get().Get();
+  if (!self || self->isolate_ != v8::Isolate::GetCurrent())
+    return;
+  v8::String::Utf8Value text(error);
+  self->delegate_->OnScriptError(*text ? *text : "<unknown>");
+}
+
+}  // namespace atom
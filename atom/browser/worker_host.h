@@ -0,0 +1,141 @@
+// Copyright (c) 2015 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#ifndef ATOM_BROWSER_WORKER_HOST_H_
+#define ATOM_BROWSER_WORKER_HOST_H_
+
+#include <string>
+#include <vector>
+
+#include "base/callback.h"
+#include "base/files/file_path.h"
+#include "base/synchronization/lock.h"
+#include "base/threading/platform_thread.h"
+#include "v8/include/v8.h"
+#include "vendor/node/deps/uv/include/uv.h"
+
+namespace node {
+class Environment;
+}
+
+namespace atom {
+
+class SerializedValue;
+
+// Runs a script in its own V8 isolate on a dedicated thread, it is what the
+// worker channels, the script workers and the protocol workers are built on.
+// The thread runs a libuv loop of its own, and when |use_node| is set the
+// script gets a Node environment on it, so it can use timers, require and
+// the other Node APIs, otherwise it runs in a plain V8 context. Only one host
+// with |use_node| can run at a time.
+class WorkerHost : public base::PlatformThread::Delegate {
+ public:
+  class Delegate {
+   public:
+    // Called on worker thread before the script runs, to add the functions
+    // of the worker to the |global| object.
+    virtual void SetUpGlobal(v8::Isolate* isolate,
+                             v8::Local<v8::Object> global) = 0;
+
+    // Called on worker thread with the uncaught exceptions of the script, or
+    // when the script can not be read.
+    virtual void OnScriptError(const std::string& message) = 0;
+
+   protected:
+    virtual ~Delegate() {}
+  };
+
+  // Enters the isolate and the context of the worker, only on worker thread.
+  class Scope {
+   public:
+    explicit Scope(WorkerHost* host);
+    ~Scope();
+
+   private:
+    v8::Isolate::Scope isolate_scope_;
+    v8::HandleScope handle_scope_;
+    v8::Context::Scope context_scope_;
+
+    DISALLOW_COPY_AND_ASSIGN(Scope);
+  };
+
+  WorkerHost(const std::string& name,
+             const base::FilePath& script,
+             bool use_node,
+             Delegate* delegate);
+  ~WorkerHost() override;
+
+  // Starts the thread and runs the script, can only be called once. Fails
+  // when |use_node| is set and another host with Node is running.
+  bool Start();
+
+  // Aborts the running script, drops the tasks that have not run and joins
+  // the thread.
+  void Stop();
+
+  // Runs |task| on worker thread, can be called on any thread. Returns false
+  // when the worker is not running.
+  bool PostTask(const base::Closure& task);
+
+  // The followings are only used on worker thread inside a Scope.
+  v8::Isolate* isolate() const { return isolate_; }
+  v8::Local<v8::Context> context() const;
+
+  // Returns the global function |name| defined by the script, or an empty
+  // handle when there is none.
+  v8::Local<v8::Function> GetFunction(const char* name);
+
+  // Unpacks the array of arguments sent to the worker into |argv|.
+  bool DeserializeArguments(const SerializedValue& args,
+                            std::vector<v8::Local<v8::Value>>* argv);
+
+  // Calls |function| on the global object, the exception it throws is
+  // reported to the delegate and an empty handle is returned.
+  v8::Local<v8::Value> Call(v8::Local<v8::Function> function,
+                            const std::vector<v8::Local<v8::Value>>& argv);
+
+ private:
+  // base::PlatformThread::Delegate:
+  void ThreadMain() override;
+
+  // Run on worker thread.
+  void RunScript();
+  void RunNodeScript();
+  void RunPendingTasks();
+  void ReportException(const v8::TryCatch& try_catch);
+  void DisposeOnWorkerThread();
+
+  static void OnWakeup(uv_async_t* handle);
+  static void OnMessage(v8::Handle<v8::Message> message,
+                        v8::Handle<v8::Value> error);
+
+  std::string name_;
+  base::FilePath script_;
+  bool use_node_;
+  Delegate* delegate_;
+
+  base::PlatformThreadHandle thread_;
+  bool started_;
+
+  // Guards the tasks and |stopping_|, the wakeup handle is only signaled
+  // with the lock held so it is never used after the worker closes it.
+  base::Lock lock_;
+  std::vector<base::Closure> pending_tasks_;
+  bool stopping_;
+
+  uv_loop_t loop_;
+  uv_async_t wakeup_;
+
+  // Created on the thread calling Start and disposed by Stop, so it can be
+  // terminated from there, but otherwise only used on worker thread.
+  v8::Isolate* isolate_;
+  v8::Persistent<v8::Context> context_;
+  node::Environment* env_;
+
+  DISALLOW_COPY_AND_ASSIGN(WorkerHost);
+};
+
+}  // namespace atom
+
+#endif  // ATOM_BROWSER_WORKER_HOST_H_
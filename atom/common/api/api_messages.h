@@ -5,8 +5,10 @@
 // Multiply-included file, no traditional include guard.
 
 #include "atom/common/draggable_region.h"
+#include "atom/common/native_mate_converters/v8_value_serializer.h"
+#include "base/files/file_path.h"
+#include "base/memory/shared_memory.h"
 #include "base/strings/string16.h"
-#include "base/values.h"
 #include "content/public/common/common_param_traits.h"
 #include "ipc/ipc_message_macros.h"
 #include "ui/gfx/ipc/gfx_param_traits.h"
@@ -23,17 +25,120 @@ IPC_STRUCT_TRAITS_END()
 
 IPC_MESSAGE_ROUTED2(AtomViewHostMsg_Message,
                     base::string16 /* channel */,
-                    base::ListValue /* arguments */)
+                    atom::SerializedValue /* arguments */)
 
 IPC_SYNC_MESSAGE_ROUTED2_1(AtomViewHostMsg_Message_Sync,
                            base::string16 /* channel */,
-                           base::ListValue /* arguments */,
+                           atom::SerializedValue /* arguments */,
                            base::string16 /* result (in JSON) */)
 
 IPC_MESSAGE_ROUTED2(AtomViewMsg_Message,
                     base::string16 /* channel */,
-                    base::ListValue /* arguments */)
+                    atom::SerializedValue /* arguments */)
 
-// Sent by the renderer when the draggable regions are updated.
-IPC_MESSAGE_ROUTED1(AtomViewHostMsg_UpdateDraggableRegions,
-                    std::vector<atom::DraggableRegion> /* regions */)
+// Same with AtomViewHostMsg_Message and AtomViewMsg_Message, but with the
+// arguments larger than kSharedMemoryThreshold in shared memory.
+IPC_MESSAGE_ROUTED3(AtomViewHostMsg_SharedMessage,
+                    base::string16 /* channel */,
+                    base::SharedMemoryHandle /* arguments */,
+                    uint32 /* size */)
+IPC_MESSAGE_ROUTED3(AtomViewMsg_SharedMessage,
+                    base::string16 /* channel */,
+                    base::SharedMemoryHandle /* arguments */,
+                    uint32 /* size */)
+
+// Sent by ipc.sendBulk and webContents.sendBulk, the receiver queues them and
+// only emits them after the other messages that have arrived.
+IPC_MESSAGE_ROUTED2(AtomViewHostMsg_BulkMessage,
+                    base::string16 /* channel */,
+                    atom::SerializedValue /* arguments */)
+IPC_MESSAGE_ROUTED2(AtomViewMsg_BulkMessage,
+                    base::string16 /* channel */,
+                    atom::SerializedValue /* arguments */)
+
+// Sent by webContents.executeJavaScriptBatch, the scripts are run in order in
+// the main world of page.
+IPC_MESSAGE_ROUTED2(AtomViewMsg_ExecuteScripts,
+                    int /* request_id */,
+                    std::vector<base::string16> /* scripts */)
+
+// Sent by the renderer in reply to AtomViewMsg_ExecuteScripts, the results
+// are an array with an object for each script, null when the page can not run
+// scripts.
+IPC_MESSAGE_ROUTED2(AtomViewHostMsg_ExecuteScriptsResult,
+                    int /* request_id */,
+                    atom::SerializedValue /* results */)
+
+// Sent by ipc.sendToWorker, handled on IO thread by the WorkerChannel
+// registered for the channel instead of the WebContents.
+IPC_MESSAGE_ROUTED2(AtomViewHostMsg_WorkerMessage,
+                    base::string16 /* channel */,
+                    atom::SerializedValue /* arguments */)
+
+// Sent by the renderer to create a stream, the browser replies with the shared
+// memory of a RingBuffer the renderer writes records to.
+IPC_SYNC_MESSAGE_ROUTED2_3(AtomViewHostMsg_OpenStream,
+                           base::string16 /* channel */,
+                           uint32 /* capacity */,
+                           int /* stream id */,
+                           base::SharedMemoryHandle /* memory */,
+                           uint32 /* memory size */)
+
+// Sent by the renderer after writing records when the browser is waiting.
+IPC_MESSAGE_ROUTED1(AtomViewHostMsg_StreamDoorbell,
+                    int /* stream id */)
+
+IPC_MESSAGE_ROUTED1(AtomViewHostMsg_CloseStream,
+                    int /* stream id */)
+
+// Sent by the browser to give one end of a message port to the view, the
+// memory holds two RingBuffers of equal size, the end with an even ID writes
+// into the first one and reads from the second one.
+IPC_MESSAGE_ROUTED4(AtomViewMsg_OpenPort,
+                    int /* port id */,
+                    base::string16 /* channel */,
+                    base::SharedMemoryHandle /* memory */,
+                    uint32 /* memory size */)
+
+// Sent by the renderer after writing messages when the peer is waiting, and
+// relayed by the browser on IO thread to the peer.
+IPC_MESSAGE_ROUTED1(AtomViewHostMsg_PortDoorbell,
+                    int /* port id */)
+IPC_MESSAGE_ROUTED1(AtomViewMsg_PortDoorbell,
+                    int /* port id */)
+
+IPC_MESSAGE_ROUTED1(AtomViewHostMsg_ClosePort,
+                    int /* port id */)
+IPC_MESSAGE_ROUTED1(AtomViewMsg_ClosePort,
+                    int /* port id */)
+
+// Sent by the browser to suspend or resume the timers and loaders of page.
+IPC_MESSAGE_ROUTED1(AtomViewMsg_SetPageSuspended,
+                    bool /* suspended */)
+
+// Sent by the renderer when the draggable regions are updated, the regions are
+// applied in order so only the ones after the unchanged leading ones are sent.
+IPC_MESSAGE_ROUTED2(AtomViewHostMsg_UpdateDraggableRegions,
+                    uint32 /* number of previous regions kept */,
+                    std::vector<atom::DraggableRegion> /* changed regions */)
+
+// Sent by the browser to share the parsed header of an asar archive, which is
+// written by asar::Archive::WriteSnapshot.
+IPC_MESSAGE_CONTROL3(AtomMsg_AsarHeader,
+                     base::FilePath /* path */,
+                     base::SharedMemoryHandle /* snapshot */,
+                     uint32 /* size */)
+
+// Asks the renderer for the statistics of its V8 heap.
+IPC_MESSAGE_CONTROL1(AtomMsg_GetV8HeapStats,
+                     int /* request id */)
+
+// Sent by the renderer in reply to AtomMsg_GetV8HeapStats.
+IPC_MESSAGE_CONTROL3(AtomHostMsg_V8HeapStats,
+                     int /* request id */,
+                     uint64 /* used heap size */,
+                     uint64 /* total heap size */)
+
+// Sent by the browser when the system is under memory pressure.
+IPC_MESSAGE_CONTROL1(AtomMsg_MemoryPressure,
+                     int /* memory pressure level */)
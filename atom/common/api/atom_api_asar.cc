@@ -4,34 +4,222 @@
 
 #include <stddef.h>
 
+#include <memory>
+#include <string>
 #include <vector>
 
 #include "atom_natives.h"  // NOLINT: This file is generated with coffee2c.
 #include "atom/common/asar/archive.h"
+#include "atom/common/asar/asar_util.h"
+#include "atom/common/code_cache.h"
 #include "atom/common/native_mate_converters/file_path_converter.h"
+#include "base/bind.h"
+#include "base/bind_helpers.h"
+#include "base/containers/scoped_ptr_hash_map.h"
+#include "base/files/file_enumerator.h"
+#include "base/files/file_util.h"
+#include "base/strings/stringprintf.h"
+#include "base/threading/thread_restrictions.h"
 #include "native_mate/arguments.h"
 #include "native_mate/callback.h"
 #include "native_mate/dictionary.h"
 #include "native_mate/object_template_builder.h"
+#include "native_mate/scoped_persistent.h"
 #include "native_mate/wrappable.h"
 
 #include "atom/common/node_includes.h"
 
 namespace {
 
+typedef base::Callback<void(v8::Handle<v8::Value>)> ResultCallback;
+typedef base::Callback<void(v8::Handle<v8::Value>,
+                            v8::Handle<v8::Value>)> ReadCallback;
+
+v8::Handle<v8::Value> FileInfoToV8(v8::Isolate* isolate,
+                                   const asar::Archive::FileInfo& info) {
+  mate::Dictionary dict(isolate, v8::Object::New(isolate));
+  dict.Set("size", info.size);
+  dict.Set("unpacked", info.unpacked);
+  dict.Set("offset", info.offset);
+  return dict.GetHandle();
+}
+
+v8::Handle<v8::Value> StatsToV8(v8::Isolate* isolate,
+                                const asar::Archive::Stats& stats) {
+  mate::Dictionary dict(isolate, v8::Object::New(isolate));
+  dict.Set("size", stats.size);
+  dict.Set("offset", stats.offset);
+  dict.Set("isFile", stats.is_file);
+  dict.Set("isDirectory", stats.is_directory);
+  dict.Set("isLink", stats.is_link);
+  return dict.GetHandle();
+}
+
+// Runs |work| on the libuv threadpool and then |reply| on the loop's thread,
+// which works in browser, renderer and node mode alike.
+struct UvWork {
+  uv_work_t request;
+  base::Closure work;
+  base::Closure reply;
+};
+
+void RunUvWork(uv_work_t* request) {
+  static_cast<UvWork*>(request->data)->work.Run();
+}
+
+void AfterUvWork(uv_work_t* request, int status) {
+  scoped_ptr<UvWork> uv_work(static_cast<UvWork*>(request->data));
+  uv_work->reply.Run();
+}
+
+// Removes everything under |root| except |current|, which are the code caches
+// of the older versions of an archive.
+void PruneCodeCaches(const base::FilePath& root,
+                     const base::FilePath& current) {
+  base::FileEnumerator enumerator(
+      root, false,
+      base::FileEnumerator::FILES | base::FileEnumerator::DIRECTORIES);
+  for (base::FilePath path = enumerator.Next(); !path.empty();
+       path = enumerator.Next()) {
+    if (path != current)
+      base::DeleteFile(path, true);
+  }
+}
+
+void PostUvWork(const base::Closure& work, const base::Closure& reply) {
+  UvWork* uv_work = new UvWork;
+  uv_work->request.data = uv_work;
+  uv_work->work = work;
+  uv_work->reply = reply;
+  uv_queue_work(uv_default_loop(), &uv_work->request, RunUvWork, AfterUvWork);
+}
+
+// The results of async operations, filled on the threadpool.
+struct StatResult {
+  StatResult() : success(false) {}
+  bool success;
+  asar::Archive::Stats stats;
+};
+
+struct ReaddirResult {
+  ReaddirResult() : success(false) {}
+  bool success;
+  std::vector<base::FilePath> files;
+};
+
+struct ReadResult {
+  ReadResult() : found(false), success(false) {}
+  bool found;
+  bool success;
+  asar::Archive::FileInfo info;
+  std::string contents;
+};
+
+struct CopyResult {
+  CopyResult() : success(false) {}
+  bool success;
+  base::FilePath path;
+};
+
+void DoStat(std::shared_ptr<asar::Archive> archive,
+            const base::FilePath& path,
+            StatResult* result) {
+  result->success = archive->Stat(path, &result->stats);
+}
+
+void DoReaddir(std::shared_ptr<asar::Archive> archive,
+               const base::FilePath& path,
+               ReaddirResult* result) {
+  result->success = archive->Readdir(path, &result->files);
+}
+
+void DoRead(std::shared_ptr<asar::Archive> archive,
+            const base::FilePath& path,
+            ReadResult* result) {
+  result->found = archive->GetFileInfo(path, &result->info);
+  if (!result->found || result->info.unpacked)
+    return;
+
+  result->success = archive->ReadContents(result->info, &result->contents);
+}
+
+void DoCopyFileOut(std::shared_ptr<asar::Archive> archive,
+                   const base::FilePath& path,
+                   CopyResult* result) {
+  result->success = archive->CopyFileOut(path, &result->path);
+}
+
+void AfterStat(node::Environment* env,
+               const ResultCallback& callback,
+               StatResult* result) {
+  v8::Locker locker(env->isolate());
+  v8::HandleScope handle_scope(env->isolate());
+  v8::Context::Scope context_scope(env->context());
+  if (result->success)
+    callback.Run(StatsToV8(env->isolate(), result->stats));
+  else
+    callback.Run(v8::False(env->isolate()));
+}
+
+void AfterReaddir(node::Environment* env,
+                  const ResultCallback& callback,
+                  ReaddirResult* result) {
+  v8::Locker locker(env->isolate());
+  v8::HandleScope handle_scope(env->isolate());
+  v8::Context::Scope context_scope(env->context());
+  if (result->success)
+    callback.Run(mate::ConvertToV8(env->isolate(), result->files));
+  else
+    callback.Run(v8::False(env->isolate()));
+}
+
+void AfterRead(node::Environment* env,
+               const ReadCallback& callback,
+               ReadResult* result) {
+  v8::Isolate* isolate = env->isolate();
+  v8::Locker locker(isolate);
+  v8::HandleScope handle_scope(isolate);
+  v8::Context::Scope context_scope(env->context());
+  if (!result->found) {
+    callback.Run(v8::False(isolate), v8::False(isolate));
+  } else if (!result->success) {
+    callback.Run(FileInfoToV8(isolate, result->info), v8::False(isolate));
+  } else {
+    callback.Run(FileInfoToV8(isolate, result->info),
+                 node::Buffer::New(isolate,
+                                   result->contents.data(),
+                                   result->contents.size()));
+  }
+}
+
+void AfterCopyFileOut(node::Environment* env,
+                      const ResultCallback& callback,
+                      CopyResult* result) {
+  v8::Locker locker(env->isolate());
+  v8::HandleScope handle_scope(env->isolate());
+  v8::Context::Scope context_scope(env->context());
+  if (result->success)
+    callback.Run(mate::ConvertToV8(env->isolate(), result->path));
+  else
+    callback.Run(v8::False(env->isolate()));
+}
+
 class Archive : public mate::Wrappable {
  public:
   static v8::Handle<v8::Value> Create(v8::Isolate* isolate,
                                       const base::FilePath& path) {
-    scoped_ptr<asar::Archive> archive(new asar::Archive(path));
-    if (!archive->Init())
+    // Share the archive with the protocol handlers, which may also have been
+    // initialized from the browser's snapshot.
+    std::shared_ptr<asar::Archive> archive =
+        asar::GetOrCreateAsarArchive(path);
+    if (!archive)
       return v8::False(isolate);
-    return (new Archive(archive.Pass()))->GetWrapper(isolate);
+    return (new Archive(archive))->GetWrapper(isolate);
   }
 
  protected:
-  explicit Archive(scoped_ptr<asar::Archive> archive)
-      : archive_(archive.Pass()) {}
+  explicit Archive(std::shared_ptr<asar::Archive> archive)
+      : archive_(archive) {}
 
   // Reads the offset and size of file.
   v8::Handle<v8::Value> GetFileInfo(v8::Isolate* isolate,
@@ -39,11 +227,7 @@ class Archive : public mate::Wrappable {
     asar::Archive::FileInfo info;
     if (!archive_ || !archive_->GetFileInfo(path, &info))
       return v8::False(isolate);
-    mate::Dictionary dict(isolate, v8::Object::New(isolate));
-    dict.Set("size", info.size);
-    dict.Set("unpacked", info.unpacked);
-    dict.Set("offset", info.offset);
-    return dict.GetHandle();
+    return FileInfoToV8(isolate, info);
   }
 
   // Returns a fake result of fs.stat(path).
@@ -52,22 +236,31 @@ class Archive : public mate::Wrappable {
     asar::Archive::Stats stats;
     if (!archive_ || !archive_->Stat(path, &stats))
       return v8::False(isolate);
-    mate::Dictionary dict(isolate, v8::Object::New(isolate));
-    dict.Set("size", stats.size);
-    dict.Set("offset", stats.offset);
-    dict.Set("isFile", stats.is_file);
-    dict.Set("isDirectory", stats.is_directory);
-    dict.Set("isLink", stats.is_link);
-    return dict.GetHandle();
+    return StatsToV8(isolate, stats);
   }
 
-  // Returns all files under a directory.
+  // Returns all files under a directory. The archive never changes, so the
+  // array is created once for each directory and copied afterwards.
   v8::Handle<v8::Value> Readdir(v8::Isolate* isolate,
                                 const base::FilePath& path) {
-    std::vector<base::FilePath> files;
-    if (!archive_ || !archive_->Readdir(path, &files))
+    if (!archive_)
       return v8::False(isolate);
-    return mate::ConvertToV8(isolate, files);
+
+    if (!readdir_cache_.contains(path)) {
+      const std::vector<std::string>* children =
+          archive_->GetDirectoryChildren(path);
+      if (!children)
+        return v8::False(isolate);
+
+      v8::Local<v8::Array> files = v8::Array::New(isolate, children->size());
+      for (size_t i = 0; i < children->size(); ++i)
+        files->Set(i, mate::StringToV8(isolate, (*children)[i]));
+      readdir_cache_.set(path, make_scoped_ptr(
+          new mate::ScopedPersistent<v8::Array>(isolate, files)));
+    }
+
+    // Callers are free to modify the returned array.
+    return readdir_cache_.get(path)->NewHandle()->Clone();
   }
 
   // Returns the path of file with symbol link resolved.
@@ -79,6 +272,56 @@ class Archive : public mate::Wrappable {
     return mate::ConvertToV8(isolate, realpath);
   }
 
+  // Returns the index and real path of the first file in |candidates|, so
+  // module resolution can probe all candidates with one call.
+  v8::Handle<v8::Value> ResolveFirst(
+      v8::Isolate* isolate,
+      const std::vector<base::FilePath>& candidates) {
+    if (!archive_)
+      return v8::False(isolate);
+
+    for (size_t i = 0; i < candidates.size(); ++i) {
+      asar::Archive::FileInfo info;
+      base::FilePath realpath;
+      if (archive_->GetFileInfo(candidates[i], &info) &&
+          archive_->Realpath(candidates[i], &realpath)) {
+        mate::Dictionary dict(isolate, v8::Object::New(isolate));
+        dict.Set("index", static_cast<uint32>(i));
+        dict.Set("path", realpath);
+        return dict.GetHandle();
+      }
+    }
+    return v8::False(isolate);
+  }
+
+  // The hash of the header, which identifies the version of the archive.
+  v8::Handle<v8::Value> GetHeaderHash(v8::Isolate* isolate) {
+    std::string hash;
+    if (!archive_ || !archive_->GetHeaderHash(&hash))
+      return v8::False(isolate);
+    return mate::StringToV8(isolate, hash);
+  }
+
+  // Reads the contents of a packed file, copying from the mapped archive when
+  // possible.
+  v8::Handle<v8::Value> Read(v8::Isolate* isolate,
+                             const base::FilePath& path) {
+    asar::Archive::FileInfo info;
+    if (!archive_ || !archive_->GetFileInfo(path, &info))
+      return v8::False(isolate);
+
+    const uint8* data;
+    if (archive_->GetMappedContents(info, &data))
+      return node::Buffer::New(isolate,
+                               reinterpret_cast<const char*>(data),
+                               info.size);
+
+    std::string contents;
+    if (!archive_->ReadContents(info, &contents))
+      return v8::False(isolate);
+    return node::Buffer::New(isolate, contents.data(), contents.size());
+  }
+
   // Copy the file out into a temporary file and returns the new path.
   v8::Handle<v8::Value> CopyFileOut(v8::Isolate* isolate,
                                     const base::FilePath& path) {
@@ -88,8 +331,117 @@ class Archive : public mate::Wrappable {
     return mate::ConvertToV8(isolate, new_path);
   }
 
+  // Copy the native module out for dlopen, which avoids the disk on Linux.
+  v8::Handle<v8::Value> CopyFileOutForDlopen(v8::Isolate* isolate,
+                                             const base::FilePath& path) {
+    base::FilePath new_path;
+    if (!archive_ || !archive_->CopyFileOutForDlopen(path, &new_path))
+      return v8::False(isolate);
+    return mate::ConvertToV8(isolate, new_path);
+  }
+
+  // Compiles and runs |source| of the packed file |path|, with the V8 code
+  // cache kept beside the archive. Files in an archive never change, so the
+  // cache is keyed by the offset and size of file, in a directory named by
+  // the hash of header. The directories of other versions of the archive are
+  // removed when it is first used. Returns false for unpacked files.
+  v8::Handle<v8::Value> RunScriptWithCodeCache(
+      v8::Isolate* isolate,
+      const base::FilePath& path,
+      v8::Handle<v8::String> source,
+      v8::Handle<v8::String> filename) {
+    asar::Archive::FileInfo info;
+    if (!archive_ || !archive_->GetFileInfo(path, &info) || info.unpacked)
+      return v8::False(isolate);
+
+    if (code_cache_dir_.empty()) {
+      base::ThreadRestrictions::ScopedAllowIO allow_io;
+      std::string hash;
+      if (!archive_->GetHeaderHash(&hash))
+        return v8::False(isolate);
+      base::FilePath root =
+          archive_->path().AddExtension(FILE_PATH_LITERAL("codecache"));
+      code_cache_dir_ = root.AppendASCII(hash.substr(0, 16));
+      PostUvWork(base::Bind(&PruneCodeCaches, root, code_cache_dir_),
+                 base::Bind(&base::DoNothing));
+    }
+
+    base::FilePath cache_path = code_cache_dir_.AppendASCII(
+        base::StringPrintf(
+            "%llx-%x.cache",
+            static_cast<unsigned long long>(info.offset),  // NOLINT
+            info.size));
+    return atom::RunScriptWithCodeCacheFile(isolate, source, filename,
+                                            cache_path, false);
+  }
+
+  // The async versions of above methods run on the libuv threadpool, and
+  // call |callback| with the same results.
+  void StatAsync(v8::Isolate* isolate,
+                 const base::FilePath& path,
+                 const ResultCallback& callback) {
+    if (!archive_) {
+      callback.Run(v8::False(isolate));
+      return;
+    }
+    StatResult* result = new StatResult;
+    PostUvWork(base::Bind(&DoStat, archive_, path, result),
+               base::Bind(&AfterStat,
+                          node::Environment::GetCurrent(isolate),
+                          callback,
+                          base::Owned(result)));
+  }
+
+  void ReaddirAsync(v8::Isolate* isolate,
+                    const base::FilePath& path,
+                    const ResultCallback& callback) {
+    if (!archive_) {
+      callback.Run(v8::False(isolate));
+      return;
+    }
+    ReaddirResult* result = new ReaddirResult;
+    PostUvWork(base::Bind(&DoReaddir, archive_, path, result),
+               base::Bind(&AfterReaddir,
+                          node::Environment::GetCurrent(isolate),
+                          callback,
+                          base::Owned(result)));
+  }
+
+  // Calls |callback| with the file info and the contents of file, the
+  // contents is false for unpacked files.
+  void ReadAsync(v8::Isolate* isolate,
+                 const base::FilePath& path,
+                 const ReadCallback& callback) {
+    if (!archive_) {
+      callback.Run(v8::False(isolate), v8::False(isolate));
+      return;
+    }
+    ReadResult* result = new ReadResult;
+    PostUvWork(base::Bind(&DoRead, archive_, path, result),
+               base::Bind(&AfterRead,
+                          node::Environment::GetCurrent(isolate),
+                          callback,
+                          base::Owned(result)));
+  }
+
+  void CopyFileOutAsync(v8::Isolate* isolate,
+                        const base::FilePath& path,
+                        const ResultCallback& callback) {
+    if (!archive_) {
+      callback.Run(v8::False(isolate));
+      return;
+    }
+    CopyResult* result = new CopyResult;
+    PostUvWork(base::Bind(&DoCopyFileOut, archive_, path, result),
+               base::Bind(&AfterCopyFileOut,
+                          node::Environment::GetCurrent(isolate),
+                          callback,
+                          base::Owned(result)));
+  }
+
   // Free the resources used by archive.
   void Destroy() {
+    readdir_cache_.clear();
     archive_.reset();
   }
 
@@ -101,12 +453,29 @@ class Archive : public mate::Wrappable {
         .SetMethod("stat", &Archive::Stat)
         .SetMethod("readdir", &Archive::Readdir)
         .SetMethod("realpath", &Archive::Realpath)
+        .SetMethod("resolveFirst", &Archive::ResolveFirst)
+        .SetMethod("getHeaderHash", &Archive::GetHeaderHash)
+        .SetMethod("read", &Archive::Read)
         .SetMethod("copyFileOut", &Archive::CopyFileOut)
+        .SetMethod("copyFileOutForDlopen", &Archive::CopyFileOutForDlopen)
+        .SetMethod("runScriptWithCodeCache", &Archive::RunScriptWithCodeCache)
+        .SetMethod("statAsync", &Archive::StatAsync)
+        .SetMethod("readdirAsync", &Archive::ReaddirAsync)
+        .SetMethod("readAsync", &Archive::ReadAsync)
+        .SetMethod("copyFileOutAsync", &Archive::CopyFileOutAsync)
         .SetMethod("destroy", &Archive::Destroy);
   }
 
  private:
-  scoped_ptr<asar::Archive> archive_;
+  std::shared_ptr<asar::Archive> archive_;
+
+  // Where the code caches of this version of archive are kept, set when first
+  // needed.
+  base::FilePath code_cache_dir_;
+
+  // Arrays returned by readdir, keyed by directory path.
+  base::ScopedPtrHashMap<base::FilePath,
+                         mate::ScopedPersistent<v8::Array>> readdir_cache_;
 
   DISALLOW_COPY_AND_ASSIGN(Archive);
 };
@@ -5,12 +5,20 @@
 #include <string>
 #include <vector>
 
+#include "atom/common/asar/asar_util.h"
+#include "atom/common/native_mate_converters/file_path_converter.h"
 #include "atom/common/native_mate_converters/image_converter.h"
 #include "atom/common/native_mate_converters/string16_converter.h"
+#include "base/bind.h"
+#include "base/task_runner_util.h"
+#include "base/threading/worker_pool.h"
+#include "native_mate/callback.h"
 #include "native_mate/dictionary.h"
 #include "third_party/skia/include/core/SkBitmap.h"
 #include "ui/base/clipboard/clipboard.h"
 #include "ui/base/clipboard/scoped_clipboard_writer.h"
+#include "ui/gfx/codec/jpeg_codec.h"
+#include "ui/gfx/codec/png_codec.h"
 #include "ui/gfx/image/image.h"
 
 #include "atom/common/node_includes.h"
@@ -74,6 +82,151 @@ void WriteImage(const gfx::Image& image, ui::ClipboardType type) {
   writer.WriteImage(image.AsBitmap());
 }
 
+// Writes all the formats in |data| in one transaction, so readers never see
+// a clipboard with only part of them.
+void Write(const mate::Dictionary& data, ui::ClipboardType type) {
+  ui::ScopedClipboardWriter writer(type);
+  base::string16 text, html;
+  gfx::Image image;
+  if (data.Get("text", &text))
+    writer.WriteText(text);
+  if (data.Get("html", &html))
+    writer.WriteHTML(html, std::string());
+  if (data.Get("image", &image))
+    writer.WriteImage(image.AsBitmap());
+}
+
+std::vector<base::string16> AvailableFormats(ui::ClipboardType type) {
+  std::vector<base::string16> types;
+  bool ignored;
+  ui::Clipboard::GetForCurrentThread()->ReadAvailableTypes(
+      type, &types, &ignored);
+  return types;
+}
+
+// The number changes whenever the content of clipboard changes, it is cheap
+// to read and does not transfer any data.
+double GetSequenceNumber(ui::ClipboardType type) {
+  return static_cast<double>(
+      ui::Clipboard::GetForCurrentThread()->GetSequenceNumber(type));
+}
+
+typedef base::Callback<void(v8::Handle<v8::Value>)> ImageCallback;
+
+#if defined(USE_X11)
+const char kMimeTypePNG[] = "image/png";
+#endif
+
+// Decodes PNG or JPEG |data|, runs on a worker thread.
+SkBitmap DecodeImage(const std::string& data) {
+  const unsigned char* bytes =
+      reinterpret_cast<const unsigned char*>(data.data());
+  SkBitmap bitmap;
+  if (gfx::PNGCodec::Decode(bytes, data.size(), &bitmap))
+    return bitmap;
+
+  scoped_ptr<SkBitmap> jpeg(gfx::JPEGCodec::Decode(bytes, data.size()));
+  return jpeg ? *jpeg : SkBitmap();
+}
+
+SkBitmap ReadAndDecodeImage(const base::FilePath& path) {
+  std::string data;
+  if (!asar::ReadFileToString(path, &data))
+    return SkBitmap();
+  return DecodeImage(data);
+}
+
+// Only reads the pixels of |bitmap|, which is safe on any thread.
+SkBitmap ToN32Bitmap(const SkBitmap& bitmap) {
+  if (bitmap.isNull() || bitmap.colorType() == kN32_SkColorType)
+    return bitmap;
+
+  SkBitmap converted;
+  bitmap.copyTo(&converted, kN32_SkColorType);
+  return converted;
+}
+
+void OnImageRead(v8::Isolate* isolate,
+                 const ImageCallback& callback,
+                 const SkBitmap& bitmap) {
+  v8::Locker locker(isolate);
+  v8::HandleScope handle_scope(isolate);
+  callback.Run(mate::ConvertToV8(isolate,
+                                 gfx::Image::CreateFrom1xBitmap(bitmap)));
+}
+
+void OnImageDecoded(v8::Isolate* isolate,
+                    ui::ClipboardType type,
+                    const ImageCallback& callback,
+                    const SkBitmap& bitmap) {
+  // The clipboard belongs to the thread that requested the write.
+  if (!bitmap.isNull()) {
+    ui::ScopedClipboardWriter writer(type);
+    writer.WriteImage(bitmap);
+  }
+
+  v8::Locker locker(isolate);
+  v8::HandleScope handle_scope(isolate);
+  callback.Run(v8::Boolean::New(isolate, !bitmap.isNull()));
+}
+
+// The clipboard can only be accessed on the thread it belongs to. On X11 the
+// clipboard stores PNG data, which is read here and decoded on a worker
+// thread. On other platforms ReadImage reads and decodes the image on this
+// thread, only its conversion to N32 pixels is moved to a worker thread.
+void ReadImageAsync(ui::ClipboardType type,
+                    const ImageCallback& callback,
+                    mate::Arguments* args) {
+  ui::Clipboard* clipboard = ui::Clipboard::GetForCurrentThread();
+  v8::Isolate* isolate = args->isolate();
+#if defined(USE_X11)
+  if (type == ui::CLIPBOARD_TYPE_COPY_PASTE) {
+    std::string png;
+    clipboard->ReadData(ui::Clipboard::GetFormatType(kMimeTypePNG), &png);
+    base::PostTaskAndReplyWithResult(
+        base::WorkerPool::GetTaskRunner(true).get(), FROM_HERE,
+        base::Bind(&DecodeImage, png),
+        base::Bind(&OnImageRead, isolate, callback));
+    return;
+  }
+#endif
+  base::PostTaskAndReplyWithResult(
+      base::WorkerPool::GetTaskRunner(true).get(), FROM_HERE,
+      base::Bind(&ToN32Bitmap, clipboard->ReadImage(type)),
+      base::Bind(&OnImageRead, isolate, callback));
+}
+
+// |image| can be a NativeImage, a path, or a Buffer of PNG or JPEG data, the
+// latter two are decoded on a worker thread before being written.
+void WriteImageAsync(v8::Handle<v8::Value> image,
+                     ui::ClipboardType type,
+                     const ImageCallback& callback,
+                     mate::Arguments* args) {
+  v8::Isolate* isolate = args->isolate();
+  base::FilePath path;
+  gfx::Image native_image;
+  if (node::Buffer::HasInstance(image)) {
+    std::string data(node::Buffer::Data(image), node::Buffer::Length(image));
+    base::PostTaskAndReplyWithResult(
+        base::WorkerPool::GetTaskRunner(true).get(), FROM_HERE,
+        base::Bind(&DecodeImage, data),
+        base::Bind(&OnImageDecoded, isolate, type, callback));
+  } else if (image->IsString() &&
+             mate::ConvertFromV8(isolate, image, &path)) {
+    base::PostTaskAndReplyWithResult(
+        base::WorkerPool::GetTaskRunner(true).get(), FROM_HERE,
+        base::Bind(&ReadAndDecodeImage, path),
+        base::Bind(&OnImageDecoded, isolate, type, callback));
+  } else if (mate::ConvertFromV8(isolate, image, &native_image)) {
+    base::PostTaskAndReplyWithResult(
+        base::WorkerPool::GetTaskRunner(true).get(), FROM_HERE,
+        base::Bind(&ToN32Bitmap, native_image.AsBitmap()),
+        base::Bind(&OnImageDecoded, isolate, type, callback));
+  } else {
+    args->ThrowError();
+  }
+}
+
 void Clear(ui::ClipboardType type) {
   ui::Clipboard::GetForCurrentThread()->Clear(type);
 }
@@ -87,6 +240,11 @@ void Initialize(v8::Handle<v8::Object> exports, v8::Handle<v8::Value> unused,
   dict.SetMethod("_writeText", &WriteText);
   dict.SetMethod("_readImage", &ReadImage);
   dict.SetMethod("_writeImage", &WriteImage);
+  dict.SetMethod("_readImageAsync", &ReadImageAsync);
+  dict.SetMethod("_writeImageAsync", &WriteImageAsync);
+  dict.SetMethod("_write", &Write);
+  dict.SetMethod("_availableFormats", &AvailableFormats);
+  dict.SetMethod("_getSequenceNumber", &GetSequenceNumber);
   dict.SetMethod("_clear", &Clear);
 }
 
@@ -5,6 +5,7 @@
 #include <map>
 #include <string>
 
+#include "atom/common/crash_reporter/breadcrumbs.h"
 #include "atom/common/crash_reporter/crash_reporter.h"
 #include "base/bind.h"
 #include "native_mate/dictionary.h"
@@ -35,6 +36,10 @@ struct Converter<std::map<std::string, std::string> > {
 
 namespace {
 
+void AddBreadcrumb(const std::string& detail) {
+  crash_reporter::Breadcrumbs::Add("app", detail);
+}
+
 void Initialize(v8::Handle<v8::Object> exports, v8::Handle<v8::Value> unused,
                 v8::Handle<v8::Context> context, void* priv) {
   using crash_reporter::CrashReporter;
@@ -42,6 +47,7 @@ void Initialize(v8::Handle<v8::Object> exports, v8::Handle<v8::Value> unused,
   dict.SetMethod("start",
                  base::Bind(&CrashReporter::Start,
                             base::Unretained(CrashReporter::GetInstance())));
+  dict.SetMethod("addBreadcrumb", &AddBreadcrumb);
 }
 
 }  // namespace
@@ -5,7 +5,9 @@
 #include "atom/common/api/atom_api_id_weak_map.h"
 
 #include <algorithm>
+#include <set>
 
+#include "base/lazy_instance.h"
 #include "base/logging.h"
 #include "native_mate/constructor.h"
 #include "native_mate/object_template_builder.h"
@@ -16,11 +18,36 @@ namespace atom {
 
 namespace api {
 
+namespace {
+
+const size_t kInitialCapacity = 64;
+
+// All living maps, only accessed on the thread of JS.
+base::LazyInstance<std::set<IDWeakMap*>>::Leaky g_id_weak_maps =
+    LAZY_INSTANCE_INITIALIZER;
+
+size_t Hash(int32_t key) {
+  // Knuth's multiplicative hash, IDs are sequential.
+  return static_cast<uint32_t>(key) * 2654435761u;
+}
+
+}  // namespace
+
 IDWeakMap::IDWeakMap()
-    : next_id_(0) {
+    : next_id_(0),
+      table_(new Entry[kInitialCapacity]),
+      capacity_(kInitialCapacity),
+      size_(0),
+      deleted_(0) {
+  g_id_weak_maps.Get().insert(this);
 }
 
 IDWeakMap::~IDWeakMap() {
+  g_id_weak_maps.Get().erase(this);
+
+  // Persistent handles are not reset when destroyed.
+  for (size_t i = 0; i < capacity_; ++i)
+    table_[i].object.Reset();
 }
 
 int32_t IDWeakMap::Add(v8::Isolate* isolate, v8::Handle<v8::Object> object) {
@@ -28,43 +55,107 @@ int32_t IDWeakMap::Add(v8::Isolate* isolate, v8::Handle<v8::Object> object) {
   object->SetHiddenValue(mate::StringToV8(isolate, "IDWeakMapKey"),
                          mate::Converter<int32_t>::ToV8(isolate, key));
 
-  map_[key] = new mate::RefCountedPersistent<v8::Object>(isolate, object);
-  map_[key]->SetWeak(this, WeakCallback);
+  // Keep at least a quarter of the table empty, so probing stays short. When
+  // most of used slots are deleted entries, they are cleared in one pass by
+  // rehashing into the same capacity.
+  if ((size_ + deleted_ + 1) * 4 > capacity_ * 3)
+    Rehash(isolate, (size_ + 1) * 2 > capacity_ ? capacity_ * 2 : capacity_);
+
+  Insert(isolate, key, object);
   return key;
 }
 
 v8::Handle<v8::Value> IDWeakMap::Get(v8::Isolate* isolate, int32_t key) {
-  if (!Has(key)) {
+  Entry* entry = Find(key);
+  if (!entry) {
     node::ThrowError("Invalid key");
     return v8::Undefined(isolate);
   }
 
-  return map_[key]->NewHandle();
+  return v8::Local<v8::Object>::New(isolate, entry->object);
 }
 
 bool IDWeakMap::Has(int32_t key) const {
-  return map_.find(key) != map_.end();
+  return Find(key) != nullptr;
 }
 
 std::vector<int32_t> IDWeakMap::Keys() const {
   std::vector<int32_t> keys;
-  keys.reserve(map_.size());
-  for (auto it = map_.begin(); it != map_.end(); ++it)
-    keys.push_back(it->first);
+  keys.reserve(size_);
+  for (size_t i = 0; i < capacity_; ++i)
+    if (table_[i].key > 0)
+      keys.push_back(table_[i].key);
+  std::sort(keys.begin(), keys.end());
   return keys;
 }
 
 void IDWeakMap::Remove(int32_t key) {
-  if (Has(key))
-    map_.erase(key);
-  else
+  Entry* entry = Find(key);
+  if (!entry) {
     LOG(WARNING) << "Object with key " << key << " is being GCed for twice.";
+    return;
+  }
+
+  entry->object.Reset();
+  entry->key = kDeletedKey;
+  --size_;
+  ++deleted_;
 }
 
 int IDWeakMap::GetNextID() {
   return ++next_id_;
 }
 
+IDWeakMap::Entry* IDWeakMap::Find(int32_t key) const {
+  if (key <= 0)
+    return nullptr;
+
+  size_t mask = capacity_ - 1;
+  for (size_t i = Hash(key) & mask; ; i = (i + 1) & mask) {
+    Entry* entry = &table_[i];
+    if (entry->key == key)
+      return entry;
+    if (entry->key == kEmptyKey)
+      return nullptr;
+  }
+}
+
+void IDWeakMap::Insert(v8::Isolate* isolate,
+                       int32_t key,
+                       v8::Handle<v8::Object> object) {
+  size_t mask = capacity_ - 1;
+  size_t i = Hash(key) & mask;
+  while (table_[i].key > 0)
+    i = (i + 1) & mask;
+
+  if (table_[i].key == kDeletedKey)
+    --deleted_;
+  table_[i].key = key;
+  table_[i].object.Reset(isolate, object);
+  table_[i].object.SetWeak(this, WeakCallback);
+  ++size_;
+}
+
+void IDWeakMap::Rehash(v8::Isolate* isolate, size_t capacity) {
+  v8::HandleScope handle_scope(isolate);
+
+  scoped_ptr<Entry[]> old_table(table_.Pass());
+  size_t old_capacity = capacity_;
+  table_.reset(new Entry[capacity]);
+  capacity_ = capacity;
+  size_ = 0;
+  deleted_ = 0;
+
+  for (size_t i = 0; i < old_capacity; ++i) {
+    Entry& entry = old_table[i];
+    if (entry.key <= 0)
+      continue;
+    Insert(isolate, entry.key,
+           v8::Local<v8::Object>::New(isolate, entry.object));
+    entry.object.Reset();
+  }
+}
+
 // static
 void IDWeakMap::BuildPrototype(v8::Isolate* isolate,
                                v8::Handle<v8::ObjectTemplate> prototype) {
@@ -76,6 +167,21 @@ void IDWeakMap::BuildPrototype(v8::Isolate* isolate,
       .SetMethod("remove", &IDWeakMap::Remove);
 }
 
+void IDWeakMap::Compact(v8::Isolate* isolate) {
+  // Leave the table a quarter full, but never grow it here.
+  size_t capacity = kInitialCapacity;
+  while (size_ * 4 > capacity && capacity < capacity_)
+    capacity *= 2;
+  if (deleted_ > 0 || capacity < capacity_)
+    Rehash(isolate, capacity);
+}
+
+// static
+void IDWeakMap::CompactAll(v8::Isolate* isolate) {
+  for (IDWeakMap* map : g_id_weak_maps.Get())
+    map->Compact(isolate);
+}
+
 // static
 void IDWeakMap::WeakCallback(
     const v8::WeakCallbackData<v8::Object, IDWeakMap>& data) {
@@ -6,11 +6,10 @@
 #ifndef ATOM_COMMON_API_ATOM_API_ID_WEAK_MAP_H_
 #define ATOM_COMMON_API_ATOM_API_ID_WEAK_MAP_H_
 
-#include <map>
 #include <vector>
 
 #include "base/basictypes.h"
-#include "native_mate/scoped_persistent.h"
+#include "base/memory/scoped_ptr.h"
 #include "native_mate/wrappable.h"
 
 namespace atom {
@@ -25,6 +24,10 @@ class IDWeakMap : public mate::Wrappable {
   static void BuildPrototype(v8::Isolate* isolate,
                              v8::Handle<v8::ObjectTemplate> prototype);
 
+  // Clears the entries removed by the GC from all maps, and shrinks the tables
+  // that have become mostly empty. Should be called on the thread of JS.
+  static void CompactAll(v8::Isolate* isolate);
+
  private:
   virtual ~IDWeakMap();
 
@@ -38,11 +41,35 @@ class IDWeakMap : public mate::Wrappable {
   static void WeakCallback(
       const v8::WeakCallbackData<v8::Object, IDWeakMap>& data);
 
+  // The objects are stored in an open addressing hash table with linear
+  // probing, so adding an object does not allocate a node.
+  enum {
+    kEmptyKey = 0,  // IDs start from 1.
+    kDeletedKey = -1,
+  };
+
+  struct Entry {
+    Entry() : key(kEmptyKey) {}
+
+    int32_t key;
+    v8::Persistent<v8::Object> object;
+  };
+
+  Entry* Find(int32_t key) const;
+  void Insert(v8::Isolate* isolate,
+              int32_t key,
+              v8::Handle<v8::Object> object);
+  void Rehash(v8::Isolate* isolate, size_t capacity);
+  void Compact(v8::Isolate* isolate);
+
   int32_t next_id_;
 
-  typedef scoped_refptr<mate::RefCountedPersistent<v8::Object> >
-      RefCountedV8Object;
-  std::map<int32_t, RefCountedV8Object> map_;
+  scoped_ptr<Entry[]> table_;
+  size_t capacity_;  // Always power of two.
+  size_t size_;
+  // The number of entries removed by the GC, they are only cleared when the
+  // table is rehashed.
+  size_t deleted_;
 
   DISALLOW_COPY_AND_ASSIGN(IDWeakMap);
 };
@@ -0,0 +1,47 @@
+// Copyright (c) 2015 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#include <string>
+
+#include "atom/common/async_logger.h"
+#include "atom/common/native_mate_converters/file_path_converter.h"
+#include "native_mate/dictionary.h"
+
+#include "atom/common/node_includes.h"
+
+namespace {
+
+bool Open(const base::FilePath& path, double max_size, int max_files) {
+  return atom::AsyncLogger::GetInstance()->Open(
+      path, static_cast<int64>(max_size), max_files);
+}
+
+void Log(int level, const std::string& message, const std::string& fields) {
+  if (level < atom::AsyncLogger::LEVEL_DEBUG ||
+      level > atom::AsyncLogger::LEVEL_ERROR)
+    level = atom::AsyncLogger::LEVEL_INFO;
+  atom::AsyncLogger::GetInstance()->Log(
+      static_cast<atom::AsyncLogger::Level>(level), message, fields);
+}
+
+void Flush() {
+  atom::AsyncLogger::GetInstance()->Flush();
+}
+
+bool IsOpen() {
+  return atom::AsyncLogger::GetInstance()->is_open();
+}
+
+void Initialize(v8::Handle<v8::Object> exports, v8::Handle<v8::Value> unused,
+                v8::Handle<v8::Context> context, void* priv) {
+  mate::Dictionary dict(context->GetIsolate(), exports);
+  dict.SetMethod("open", &Open);
+  dict.SetMethod("log", &Log);
+  dict.SetMethod("flush", &Flush);
+  dict.SetMethod("isOpen", &IsOpen);
+}
+
+}  // namespace
+
+NODE_MODULE_CONTEXT_AWARE_BUILTIN(atom_common_logger, Initialize)
@@ -4,23 +4,36 @@
 
 #include "atom/common/api/atom_api_native_image.h"
 
+#include <map>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "atom/common/asar/asar_util.h"
 #include "atom/common/native_mate_converters/file_path_converter.h"
 #include "atom/common/native_mate_converters/gfx_converter.h"
 #include "atom/common/native_mate_converters/gurl_converter.h"
-#include "base/base64.h"
+#include "base/bind.h"
+#include "base/containers/mru_cache.h"
+#include "base/files/file_util.h"
+#include "base/lazy_instance.h"
+#include "base/memory/ref_counted_memory.h"
 #include "base/strings/string_util.h"
+#include "base/synchronization/lock.h"
+#include "base/task_runner_util.h"
+#include "base/threading/worker_pool.h"
+#include "native_mate/callback.h"
 #include "native_mate/dictionary.h"
 #include "native_mate/object_template_builder.h"
 #include "net/base/data_url.h"
+#include "third_party/modp_b64/modp_b64.h"
+#include "third_party/skia/include/core/SkBitmap.h"
 #include "ui/base/layout.h"
 #include "ui/gfx/codec/jpeg_codec.h"
 #include "ui/gfx/codec/png_codec.h"
 #include "ui/gfx/geometry/size.h"
 #include "ui/gfx/image/image_skia.h"
+#include "ui/gfx/image/image_skia_source.h"
 #include "ui/gfx/image/image_util.h"
 
 #include "atom/common/node_includes.h"
@@ -82,34 +95,156 @@ bool AddImageSkiaRep(gfx::ImageSkia* image,
   return true;
 }
 
-bool AddImageSkiaRep(gfx::ImageSkia* image,
-                     const base::FilePath& path,
-                     double scale_factor) {
+// The decoded images read from files, so icons used again and again are only
+// decoded once. The entries are keyed by path and scale factor, and are
+// dropped when the modification time of file changes.
+const size_t kMaxDecodedImageCacheSize = 256;
+
+struct DecodedImage {
+  base::Time last_modified;
+  gfx::ImageSkiaRep rep;
+};
+
+typedef std::pair<base::FilePath, double> DecodedImageKey;
+
+struct DecodedImageCache {
+  DecodedImageCache() : images(kMaxDecodedImageCacheSize) {}
+
+  base::Lock lock;
+  base::MRUCache<DecodedImageKey, DecodedImage> images;
+};
+
+base::LazyInstance<DecodedImageCache> g_decoded_image_cache =
+    LAZY_INSTANCE_INITIALIZER;
+
+// Files inside asar archives are checked against the archive itself.
+bool GetLastModifiedTime(const base::FilePath& path, base::Time* time) {
+  base::FilePath asar_path, relative_path;
+  base::File::Info info;
+  if (asar::GetAsarArchivePath(path, &asar_path, &relative_path)) {
+    if (!base::GetFileInfo(asar_path, &info))
+      return false;
+  } else if (!base::GetFileInfo(path, &info) || info.is_directory) {
+    return false;
+  }
+  *time = info.last_modified;
+  return true;
+}
+
+bool DecodeImageSkiaRep(const base::FilePath& path,
+                        double scale_factor,
+                        gfx::ImageSkiaRep* rep) {
+  base::Time last_modified;
+  if (!GetLastModifiedTime(path, &last_modified))
+    return false;
+
+  DecodedImageCache& cache = g_decoded_image_cache.Get();
+  DecodedImageKey key(path, scale_factor);
+  {
+    base::AutoLock auto_lock(cache.lock);
+    auto it = cache.images.Get(key);
+    if (it != cache.images.end() &&
+        it->second.last_modified == last_modified) {
+      // The representation shares the pixels of the cached one.
+      *rep = it->second.rep;
+      return true;
+    }
+  }
+
   std::string file_contents;
   if (!asar::ReadFileToString(path, &file_contents))
     return false;
 
+  gfx::ImageSkia image;
   const unsigned char* data =
       reinterpret_cast<const unsigned char*>(file_contents.data());
   size_t size = file_contents.size();
-  return AddImageSkiaRep(image, data, size, scale_factor);
+  if (!AddImageSkiaRep(&image, data, size, scale_factor))
+    return false;
+
+  *rep = image.GetRepresentation(static_cast<float>(scale_factor));
+  DecodedImage decoded = { last_modified, *rep };
+  base::AutoLock auto_lock(cache.lock);
+  cache.images.Put(key, decoded);
+  return true;
 }
 
-bool PopulateImageSkiaRepsFromPath(gfx::ImageSkia* image,
-                                   const base::FilePath& path) {
-  bool succeed = false;
+bool AddImageSkiaRep(gfx::ImageSkia* image,
+                     const base::FilePath& path,
+                     double scale_factor) {
+  gfx::ImageSkiaRep rep;
+  if (!DecodeImageSkiaRep(path, scale_factor, &rep))
+    return false;
+  image->AddRepresentation(rep);
+  return true;
+}
+
+// Decodes the files of other scale factors only when they are drawn.
+class LazyImageSkiaSource : public gfx::ImageSkiaSource {
+ public:
+  typedef std::map<float, base::FilePath> PathMap;
+
+  explicit LazyImageSkiaSource(const PathMap& paths) : paths_(paths) {}
+
+  // gfx::ImageSkiaSource:
+  gfx::ImageSkiaRep GetImageForScale(float scale) override {
+    // Prefer the exact scale, then the closest larger one so downscaling
+    // keeps the details, then the largest one.
+    PathMap::const_iterator it = paths_.lower_bound(scale);
+    if (it == paths_.end())
+      --it;
+
+    gfx::ImageSkiaRep rep;
+    DecodeImageSkiaRep(it->second, it->first, &rep);
+    return rep;
+  }
+
+ private:
+  PathMap paths_;
+
+  DISALLOW_COPY_AND_ASSIGN(LazyImageSkiaSource);
+};
+
+gfx::ImageSkia CreateImageSkiaFromPath(const base::FilePath& path) {
+  gfx::ImageSkia image;
   std::string filename(path.BaseName().RemoveExtension().AsUTF8Unsafe());
-  if (MatchPattern(filename, "*@*x"))
+  if (MatchPattern(filename, "*@*x")) {
     // Don't search for other representations if the DPI has been specified.
-    return AddImageSkiaRep(image, path, GetScaleFactorFromPath(path));
-  else
-    succeed |= AddImageSkiaRep(image, path, 1.0f);
+    AddImageSkiaRep(&image, path, GetScaleFactorFromPath(path));
+    return image;
+  }
 
-  for (const ScaleFactorPair& pair : kScaleFactorPairs)
-    succeed |= AddImageSkiaRep(image,
-                               path.InsertBeforeExtensionASCII(pair.name),
-                               pair.scale);
-  return succeed;
+  // Only find out which representations exist without reading them.
+  base::Time last_modified;
+  LazyImageSkiaSource::PathMap paths;
+  if (GetLastModifiedTime(path, &last_modified))
+    paths[1.0f] = path;
+  for (const ScaleFactorPair& pair : kScaleFactorPairs) {
+    base::FilePath scaled_path = path.InsertBeforeExtensionASCII(pair.name);
+    if (GetLastModifiedTime(scaled_path, &last_modified))
+      paths[pair.scale] = scaled_path;
+  }
+
+  if (paths.empty())
+    return image;
+  if (paths.size() == 1) {
+    AddImageSkiaRep(&image, paths.begin()->second, paths.begin()->first);
+    return image;
+  }
+
+  // The size of image is taken from the representation of the largest scale
+  // the displays use, which is most likely to be drawn anyway.
+  scoped_ptr<LazyImageSkiaSource> source(new LazyImageSkiaSource(paths));
+  float scale =
+      ui::GetScaleForScaleFactor(ui::GetSupportedScaleFactors().back());
+  gfx::ImageSkiaRep rep = source->GetImageForScale(scale);
+  if (rep.is_null())
+    return image;
+
+  image = gfx::ImageSkia(source.release(),
+                         gfx::Size(rep.GetWidth(), rep.GetHeight()));
+  image.AddRepresentation(rep);
+  return image;
 }
 
 #if defined(OS_MACOSX)
@@ -119,6 +254,94 @@ bool IsTemplateImage(const base::FilePath& path) {
 }
 #endif
 
+// Returns the 1x representation of |image| in the BGRA (N32) format, the
+// pixels are shared with |image| whenever it is already in that format.
+SkBitmap GetN32Bitmap(const gfx::Image& image) {
+  if (image.IsEmpty())
+    return SkBitmap();
+
+  const SkBitmap& bitmap = image.AsBitmap();
+  if (bitmap.colorType() == kN32_SkColorType)
+    return bitmap;
+
+  SkBitmap converted;
+  bitmap.copyTo(&converted, kN32_SkColorType);
+  return converted;
+}
+
+typedef base::Callback<void(v8::Handle<v8::Value>)> EncodeCallback;
+
+const char kDataURLPrefix[] = "data:image/png;base64,";
+
+// The encoders only touch |bitmap|, which unlike gfx::Image can be used on
+// any thread.
+scoped_refptr<base::RefCountedBytes> EncodePNG(const SkBitmap& bitmap) {
+  scoped_refptr<base::RefCountedBytes> png(new base::RefCountedBytes);
+  if (!bitmap.isNull())
+    gfx::PNGCodec::EncodeBGRASkBitmap(bitmap, false, &png->data());
+  return png;
+}
+
+scoped_refptr<base::RefCountedBytes> EncodeJPEG(const SkBitmap& bitmap,
+                                                int quality) {
+  scoped_refptr<base::RefCountedBytes> jpeg(new base::RefCountedBytes);
+  SkAutoLockPixels lock(bitmap);
+  if (bitmap.getPixels())
+    gfx::JPEGCodec::Encode(
+        static_cast<const unsigned char*>(bitmap.getPixels()),
+        gfx::JPEGCodec::FORMAT_SkBitmap, bitmap.width(), bitmap.height(),
+        static_cast<int>(bitmap.rowBytes()), quality, &jpeg->data());
+  return jpeg;
+}
+
+// Encodes |png| as base64 straight into the string holding the data URL, so
+// the URL is allocated only once.
+std::string PNGToDataURL(const base::RefCountedMemory* png) {
+  size_t prefix_size = arraysize(kDataURLPrefix) - 1;
+  std::string data_url;
+  data_url.resize(prefix_size + modp_b64_encode_len(png->size()));
+  data_url.replace(0, prefix_size, kDataURLPrefix);
+  size_t size = modp_b64_encode(&data_url[prefix_size],
+                                reinterpret_cast<const char*>(png->front()),
+                                png->size());
+  data_url.resize(prefix_size + size);
+  return data_url;
+}
+
+std::string EncodeDataURL(const SkBitmap& bitmap) {
+  return PNGToDataURL(EncodePNG(bitmap).get());
+}
+
+v8::Handle<v8::Value> ToBuffer(v8::Isolate* isolate,
+                               const base::RefCountedMemory* data) {
+  return node::Buffer::New(isolate,
+                           reinterpret_cast<const char*>(data->front()),
+                           data->size());
+}
+
+void OnEncodeDone(v8::Isolate* isolate,
+                  const EncodeCallback& callback,
+                  scoped_refptr<base::RefCountedBytes> data) {
+  v8::Locker locker(isolate);
+  v8::HandleScope handle_scope(isolate);
+  callback.Run(ToBuffer(isolate, data.get()));
+}
+
+void OnEncodeDataURLDone(v8::Isolate* isolate,
+                         const EncodeCallback& callback,
+                         const std::string& data_url) {
+  v8::Locker locker(isolate);
+  v8::HandleScope handle_scope(isolate);
+  callback.Run(mate::StringToV8(isolate, data_url));
+}
+
+// Releases the bitmap kept alive by the Buffer returned from getBitmapBuffer.
+void FreeBitmap(char* data, void* hint) {
+  SkBitmap* bitmap = static_cast<SkBitmap*>(hint);
+  bitmap->unlockPixels();
+  delete bitmap;
+}
+
 v8::Persistent<v8::ObjectTemplate> template_;
 
 }  // namespace
@@ -136,6 +359,8 @@ mate::ObjectTemplateBuilder NativeImage::GetObjectTemplateBuilder(
         .SetMethod("toPng", &NativeImage::ToPNG)
         .SetMethod("toJpeg", &NativeImage::ToJPEG)
         .SetMethod("toDataUrl", &NativeImage::ToDataURL)
+        .SetMethod("toBitmap", &NativeImage::ToBitmap)
+        .SetMethod("getBitmapBuffer", &NativeImage::GetBitmapBuffer)
         .SetMethod("isEmpty", &NativeImage::IsEmpty)
         .SetMethod("getSize", &NativeImage::GetSize)
         .Build());
@@ -144,28 +369,80 @@ mate::ObjectTemplateBuilder NativeImage::GetObjectTemplateBuilder(
       isolate, v8::Local<v8::ObjectTemplate>::New(isolate, template_));
 }
 
-v8::Handle<v8::Value> NativeImage::ToPNG(v8::Isolate* isolate) {
+v8::Handle<v8::Value> NativeImage::ToPNG(mate::Arguments* args) {
+  EncodeCallback callback;
+  if (args->GetNext(&callback)) {
+    base::PostTaskAndReplyWithResult(
+        base::WorkerPool::GetTaskRunner(true).get(), FROM_HERE,
+        base::Bind(&EncodePNG, GetN32Bitmap(image_)),
+        base::Bind(&OnEncodeDone, args->isolate(), callback));
+    return v8::Undefined(args->isolate());
+  }
+
   scoped_refptr<base::RefCountedMemory> png = image_.As1xPNGBytes();
-  return node::Buffer::New(isolate,
-                           reinterpret_cast<const char*>(png->front()),
-                           png->size());
+  return ToBuffer(args->isolate(), png.get());
 }
 
-v8::Handle<v8::Value> NativeImage::ToJPEG(v8::Isolate* isolate, int quality) {
+v8::Handle<v8::Value> NativeImage::ToJPEG(mate::Arguments* args, int quality) {
+  EncodeCallback callback;
+  if (args->GetNext(&callback)) {
+    base::PostTaskAndReplyWithResult(
+        base::WorkerPool::GetTaskRunner(true).get(), FROM_HERE,
+        base::Bind(&EncodeJPEG, GetN32Bitmap(image_), quality),
+        base::Bind(&OnEncodeDone, args->isolate(), callback));
+    return v8::Undefined(args->isolate());
+  }
+
   std::vector<unsigned char> output;
   gfx::JPEG1xEncodedDataFromImage(image_, quality, &output);
-  return node::Buffer::New(isolate,
+  return node::Buffer::New(args->isolate(),
                            reinterpret_cast<const char*>(&output.front()),
                            output.size());
 }
 
-std::string NativeImage::ToDataURL() {
+v8::Handle<v8::Value> NativeImage::ToDataURL(mate::Arguments* args) {
+  EncodeCallback callback;
+  if (args->GetNext(&callback)) {
+    base::PostTaskAndReplyWithResult(
+        base::WorkerPool::GetTaskRunner(true).get(), FROM_HERE,
+        base::Bind(&EncodeDataURL, GetN32Bitmap(image_)),
+        base::Bind(&OnEncodeDataURLDone, args->isolate(), callback));
+    return v8::Undefined(args->isolate());
+  }
+
   scoped_refptr<base::RefCountedMemory> png = image_.As1xPNGBytes();
-  std::string data_url;
-  data_url.insert(data_url.end(), png->front(), png->front() + png->size());
-  base::Base64Encode(data_url, &data_url);
-  data_url.insert(0, "data:image/png;base64,");
-  return data_url;
+  return mate::StringToV8(args->isolate(), PNGToDataURL(png.get()));
+}
+
+v8::Handle<v8::Value> NativeImage::ToBitmap(v8::Isolate* isolate) {
+  SkBitmap bitmap = GetN32Bitmap(image_);
+  SkAutoLockPixels lock(bitmap);
+  if (!bitmap.getPixels())
+    return node::Buffer::New(isolate, 0);
+
+  size_t row_bytes = bitmap.width() * 4;
+  v8::Handle<v8::Object> buffer =
+      node::Buffer::New(isolate, row_bytes * bitmap.height());
+  char* data = node::Buffer::Data(buffer);
+  for (int y = 0; y < bitmap.height(); ++y)
+    memcpy(data + y * row_bytes, bitmap.getAddr32(0, y), row_bytes);
+  return buffer;
+}
+
+v8::Handle<v8::Value> NativeImage::GetBitmapBuffer(v8::Isolate* isolate) {
+  scoped_ptr<SkBitmap> bitmap(new SkBitmap(GetN32Bitmap(image_)));
+  bitmap->lockPixels();
+  // Padded rows can not be shared without breaking the layout of Buffer.
+  if (!bitmap->getPixels() ||
+      bitmap->rowBytes() != static_cast<size_t>(bitmap->width() * 4)) {
+    bitmap->unlockPixels();
+    return ToBitmap(isolate);
+  }
+
+  // The Buffer keeps a reference to the pixels of bitmap, so no copy is made.
+  char* data = static_cast<char*>(bitmap->getPixels());
+  size_t size = bitmap->getSize();
+  return node::Buffer::New(isolate, data, size, &FreeBitmap, bitmap.release());
 }
 
 bool NativeImage::IsEmpty() {
@@ -206,9 +483,7 @@ mate::Handle<NativeImage> NativeImage::CreateFromJPEG(
 // static
 mate::Handle<NativeImage> NativeImage::CreateFromPath(
     v8::Isolate* isolate, const base::FilePath& path) {
-  gfx::ImageSkia image_skia;
-  PopulateImageSkiaRepsFromPath(&image_skia, path);
-  gfx::Image image(image_skia);
+  gfx::Image image(CreateImageSkiaFromPath(path));
 #if defined(OS_MACOSX)
   if (IsTemplateImage(path))
     MakeTemplateImage(&image);
@@ -244,6 +519,45 @@ mate::Handle<NativeImage> NativeImage::CreateFromDataURL(
   return CreateEmpty(isolate);
 }
 
+// static
+mate::Handle<NativeImage> NativeImage::CreateFromBitmap(
+    mate::Arguments* args, v8::Handle<v8::Value> buffer,
+    const gfx::Size& size) {
+  double scale_factor = 1.;
+  args->GetNext(&scale_factor);
+
+  size_t row_bytes = size.width() * 4;
+  if (size.IsEmpty() || !node::Buffer::HasInstance(buffer) ||
+      node::Buffer::Length(buffer) != row_bytes * size.height()) {
+    args->ThrowError("The buffer does not match the size of bitmap");
+    return CreateEmpty(args->isolate());
+  }
+
+  SkBitmap bitmap;
+  if (!bitmap.tryAllocN32Pixels(size.width(), size.height()))
+    return CreateEmpty(args->isolate());
+
+  // The rows of bitmap might be padded, copy them one by one.
+  SkAutoLockPixels lock(bitmap);
+  const char* data = node::Buffer::Data(buffer);
+  for (int y = 0; y < size.height(); ++y)
+    memcpy(bitmap.getAddr32(0, y), data + y * row_bytes, row_bytes);
+
+  gfx::ImageSkia image_skia;
+  image_skia.AddRepresentation(gfx::ImageSkiaRep(bitmap, scale_factor));
+  return Create(args->isolate(), gfx::Image(image_skia));
+}
+
+// static
+void NativeImage::PurgeDecodedImageCache(bool all) {
+  DecodedImageCache& cache = g_decoded_image_cache.Get();
+  base::AutoLock auto_lock(cache.lock);
+  if (all)
+    cache.images.Clear();
+  else
+    cache.images.ShrinkToSize(cache.images.size() / 2);
+}
+
 }  // namespace api
 
 }  // namespace atom
@@ -259,6 +573,7 @@ void Initialize(v8::Handle<v8::Object> exports, v8::Handle<v8::Value> unused,
   dict.SetMethod("createFromBuffer", &atom::api::NativeImage::CreateFromBuffer);
   dict.SetMethod("createFromDataUrl",
                  &atom::api::NativeImage::CreateFromDataURL);
+  dict.SetMethod("createFromBitmap", &atom::api::NativeImage::CreateFromBitmap);
 }
 
 }  // namespace
@@ -44,6 +44,13 @@ class NativeImage : public mate::Wrappable {
       mate::Arguments* args, v8::Handle<v8::Value> buffer);
   static mate::Handle<NativeImage> CreateFromDataURL(
       v8::Isolate* isolate, const GURL& url);
+  static mate::Handle<NativeImage> CreateFromBitmap(
+      mate::Arguments* args, v8::Handle<v8::Value> buffer,
+      const gfx::Size& size);
+
+  // Drops the images decoded from files, |all| drops all of them, otherwise
+  // only the least recently used half. Safe to call on any thread.
+  static void PurgeDecodedImageCache(bool all);
 
   // The default constructor should only be used by image_converter.cc.
   NativeImage();
@@ -64,9 +71,12 @@ class NativeImage : public mate::Wrappable {
   static void MakeTemplateImage(gfx::Image* image);
 #endif
 
-  v8::Handle<v8::Value> ToPNG(v8::Isolate* isolate);
-  v8::Handle<v8::Value> ToJPEG(v8::Isolate* isolate, int quality);
-  std::string ToDataURL();
+  // The encoders run on a worker thread when a callback is passed.
+  v8::Handle<v8::Value> ToPNG(mate::Arguments* args);
+  v8::Handle<v8::Value> ToJPEG(mate::Arguments* args, int quality);
+  v8::Handle<v8::Value> ToDataURL(mate::Arguments* args);
+  v8::Handle<v8::Value> ToBitmap(v8::Isolate* isolate);
+  v8::Handle<v8::Value> GetBitmapBuffer(v8::Isolate* isolate);
   bool IsEmpty();
   gfx::Size GetSize();
 
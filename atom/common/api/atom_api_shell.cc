@@ -7,19 +7,114 @@
 #include "atom/common/platform_util.h"
 #include "atom/common/native_mate_converters/file_path_converter.h"
 #include "atom/common/native_mate_converters/gurl_converter.h"
+#include "base/bind.h"
+#include "base/files/file_path.h"
+#include "base/message_loop/message_loop.h"
+#include "base/task_runner_util.h"
+#include "base/threading/worker_pool.h"
+#include "native_mate/callback.h"
 #include "native_mate/dictionary.h"
+#include "url/gurl.h"
+
+#if defined(OS_WIN)
+#include "base/win/scoped_com_initializer.h"
+#endif
 
 #include "atom/common/node_includes.h"
 
 namespace {
 
+typedef base::Callback<bool()> ShellTask;
+typedef base::Callback<void(bool)> CompletionCallback;
+
+bool ShowItemInFolderTask(const base::FilePath& full_path) {
+  platform_util::ShowItemInFolder(full_path);
+  return true;
+}
+
+bool OpenItemTask(const base::FilePath& full_path) {
+  platform_util::OpenItem(full_path);
+  return true;
+}
+
+bool OpenExternalTask(const GURL& url) {
+  platform_util::OpenExternal(url);
+  return true;
+}
+
+bool RunShellTask(const ShellTask& task) {
+#if defined(OS_WIN)
+  // The shell functions need COM on the worker thread.
+  base::win::ScopedCOMInitializer com_initializer;
+#endif
+  return task.Run();
+}
+
+void OnShellTaskDone(v8::Isolate* isolate,
+                     const CompletionCallback& callback,
+                     bool result) {
+  v8::Locker locker(isolate);
+  v8::HandleScope handle_scope(isolate);
+  callback.Run(result);
+}
+
+void RunShellTaskAndReply(v8::Isolate* isolate,
+                          const ShellTask& task,
+                          const CompletionCallback& callback) {
+  OnShellTaskDone(isolate, callback, task.Run());
+}
+
+// Runs |task| now and returns its result, or runs it in the background when
+// a callback is passed in |args|. On Linux the shell operations wait for
+// xdg-open to exit and on Windows they can hang on network paths, so they
+// are run on a worker thread, while NSWorkspace does not block and has to be
+// used on the main thread.
+v8::Handle<v8::Value> RunShellTaskMaybeAsync(const ShellTask& task,
+                                             mate::Arguments* args) {
+  v8::Isolate* isolate = args->isolate();
+  CompletionCallback callback;
+  if (!args->GetNext(&callback))
+    return mate::ConvertToV8(isolate, task.Run());
+
+#if defined(OS_MACOSX)
+  base::MessageLoop::current()->PostTask(
+      FROM_HERE,
+      base::Bind(&RunShellTaskAndReply, isolate, task, callback));
+#else
+  base::PostTaskAndReplyWithResult(
+      base::WorkerPool::GetTaskRunner(true).get(),
+      FROM_HERE,
+      base::Bind(&RunShellTask, task),
+      base::Bind(&OnShellTaskDone, isolate, callback));
+#endif
+  return v8::Undefined(isolate);
+}
+
+void ShowItemInFolder(const base::FilePath& full_path, mate::Arguments* args) {
+  RunShellTaskMaybeAsync(base::Bind(&ShowItemInFolderTask, full_path), args);
+}
+
+void OpenItem(const base::FilePath& full_path, mate::Arguments* args) {
+  RunShellTaskMaybeAsync(base::Bind(&OpenItemTask, full_path), args);
+}
+
+void OpenExternal(const GURL& url, mate::Arguments* args) {
+  RunShellTaskMaybeAsync(base::Bind(&OpenExternalTask, url), args);
+}
+
+v8::Handle<v8::Value> MoveItemToTrash(const base::FilePath& full_path,
+                                      mate::Arguments* args) {
+  return RunShellTaskMaybeAsync(
+      base::Bind(&platform_util::MoveItemToTrash, full_path), args);
+}
+
 void Initialize(v8::Handle<v8::Object> exports, v8::Handle<v8::Value> unused,
                 v8::Handle<v8::Context> context, void* priv) {
   mate::Dictionary dict(context->GetIsolate(), exports);
-  dict.SetMethod("showItemInFolder", &platform_util::ShowItemInFolder);
-  dict.SetMethod("openItem", &platform_util::OpenItem);
-  dict.SetMethod("openExternal", &platform_util::OpenExternal);
-  dict.SetMethod("moveItemToTrash", &platform_util::MoveItemToTrash);
+  dict.SetMethod("showItemInFolder", &ShowItemInFolder);
+  dict.SetMethod("openItem", &OpenItem);
+  dict.SetMethod("openExternal", &OpenExternal);
+  dict.SetMethod("moveItemToTrash", &MoveItemToTrash);
   dict.SetMethod("beep", &platform_util::Beep);
 }
 
@@ -0,0 +1,147 @@
+// Copyright (c) 2015 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#include <map>
+#include <string>
+
+#include "atom/common/native_mate_converters/value_converter.h"
+#include "base/debug/trace_event.h"
+#include "base/hash.h"
+#include "base/json/json_writer.h"
+#include "base/lazy_instance.h"
+#include "base/values.h"
+#include "native_mate/arguments.h"
+#include "native_mate/dictionary.h"
+
+#include "atom/common/node_includes.h"
+
+namespace {
+
+// The enabled flags of the categories used by JS. The TRACE_EVENT macros
+// cache the flag in each call site, which only works for literal categories.
+typedef std::map<std::string, const unsigned char*> CategoryMap;
+base::LazyInstance<CategoryMap>::Leaky g_categories = LAZY_INSTANCE_INITIALIZER;
+
+const unsigned char* GetCategoryGroupEnabled(const std::string& category) {
+  CategoryMap& categories = g_categories.Get();
+  CategoryMap::iterator it = categories.find(category);
+  if (it != categories.end())
+    return it->second;
+
+  // The TraceLog keeps its own copy of the name.
+  const unsigned char* enabled =
+      TRACE_EVENT_API_GET_CATEGORY_GROUP_ENABLED(category.c_str());
+  categories[category] = enabled;
+  return enabled;
+}
+
+// Writes the |args| object of JS as it is into the trace.
+class JSONArgs : public base::debug::ConvertableToTraceFormat {
+ public:
+  explicit JSONArgs(const std::string& json) : json_(json) {}
+
+  void AppendAsTraceFormat(std::string* out) const override {
+    out->append(json_);
+  }
+
+ private:
+  ~JSONArgs() override {}
+
+  std::string json_;
+
+  DISALLOW_COPY_AND_ASSIGN(JSONArgs);
+};
+
+void AddTraceEvent(char phase, unsigned char flags, mate::Arguments* args) {
+  std::string category, name;
+  if (!args->GetNext(&category) || !args->GetNext(&name)) {
+    args->ThrowError();
+    return;
+  }
+
+  // Nothing else is done when the category is not being recorded.
+  const unsigned char* enabled = GetCategoryGroupEnabled(category);
+  if (!*enabled)
+    return;
+
+  flags |= TRACE_EVENT_FLAG_COPY;
+  base::DictionaryValue dict;
+  if (!args->GetNext(&dict)) {
+    TRACE_EVENT_API_ADD_TRACE_EVENT(
+        phase, enabled, name.c_str(), trace_event_internal::kNoEventId,
+        0, NULL, NULL, NULL, NULL, flags);
+    return;
+  }
+
+  std::string json;
+  base::JSONWriter::Write(&dict, &json);
+  const char* arg_names[] = { "args" };
+  const unsigned char arg_types[] = { TRACE_VALUE_TYPE_CONVERTABLE };
+  scoped_refptr<base::debug::ConvertableToTraceFormat> arg_values[] = {
+    new JSONArgs(json),
+  };
+  TRACE_EVENT_API_ADD_TRACE_EVENT(
+      phase, enabled, name.c_str(), trace_event_internal::kNoEventId,
+      1, arg_names, arg_types, NULL, arg_values, flags);
+}
+
+void TraceBegin(mate::Arguments* args) {
+  AddTraceEvent(TRACE_EVENT_PHASE_BEGIN, TRACE_EVENT_FLAG_NONE, args);
+}
+
+void TraceEnd(mate::Arguments* args) {
+  AddTraceEvent(TRACE_EVENT_PHASE_END, TRACE_EVENT_FLAG_NONE, args);
+}
+
+void TraceInstant(mate::Arguments* args) {
+  AddTraceEvent(TRACE_EVENT_PHASE_INSTANT, TRACE_EVENT_SCOPE_THREAD, args);
+}
+
+// The trace viewer only draws counters whose arguments are numbers, and an
+// event can only have two arguments, so each key of |values| is recorded as
+// a series of its own, told apart by the id of the event.
+void TraceCounter(mate::Arguments* args) {
+  std::string category, name;
+  if (!args->GetNext(&category) || !args->GetNext(&name)) {
+    args->ThrowError();
+    return;
+  }
+
+  const unsigned char* enabled = GetCategoryGroupEnabled(category);
+  if (!*enabled)
+    return;
+
+  base::DictionaryValue values;
+  if (!args->GetNext(&values))
+    return;
+
+  for (base::DictionaryValue::Iterator it(values); !it.IsAtEnd();
+       it.Advance()) {
+    double number;
+    if (!it.value().GetAsDouble(&number))
+      continue;
+    const char* arg_names[] = { it.key().c_str() };
+    unsigned char arg_types[1];
+    unsigned long long arg_values[1];  // NOLINT(runtime/int)
+    trace_event_internal::SetTraceValue(number, &arg_types[0],
+                                        &arg_values[0]);
+    TRACE_EVENT_API_ADD_TRACE_EVENT(
+        TRACE_EVENT_PHASE_COUNTER, enabled, name.c_str(),
+        base::Hash(it.key()), 1, arg_names, arg_types, arg_values, NULL,
+        TRACE_EVENT_FLAG_HAS_ID | TRACE_EVENT_FLAG_COPY);
+  }
+}
+
+void Initialize(v8::Handle<v8::Object> exports, v8::Handle<v8::Value> unused,
+                v8::Handle<v8::Context> context, void* priv) {
+  mate::Dictionary dict(context->GetIsolate(), exports);
+  dict.SetMethod("traceBegin", &TraceBegin);
+  dict.SetMethod("traceEnd", &TraceEnd);
+  dict.SetMethod("traceInstant", &TraceInstant);
+  dict.SetMethod("traceCounter", &TraceCounter);
+}
+
+}  // namespace
+
+NODE_MODULE_CONTEXT_AWARE_BUILTIN(atom_common_trace_event, Initialize)
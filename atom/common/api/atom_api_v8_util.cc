@@ -2,7 +2,12 @@
 // Use of this source code is governed by the MIT license that can be
 // found in the LICENSE file.
 
+#include <string>
+
 #include "atom/common/api/object_life_monitor.h"
+#include "atom/common/code_cache.h"
+#include "atom/common/native_mate_converters/file_path_converter.h"
+#include "base/atomic_sequence_num.h"
 #include "native_mate/dictionary.h"
 #include "v8/include/v8-profiler.h"
 
@@ -10,6 +15,8 @@
 
 namespace {
 
+base::StaticAtomicSequenceNumber g_next_unique_id;
+
 v8::Handle<v8::Object> CreateObjectWithName(v8::Isolate* isolate,
                                             v8::Handle<v8::String> name) {
   v8::Local<v8::FunctionTemplate> t = v8::FunctionTemplate::New(isolate);
@@ -38,11 +45,53 @@ void SetDestructor(v8::Isolate* isolate,
   atom::ObjectLifeMonitor::BindTo(isolate, object, callback);
 }
 
+// The IDs are unique in current process rather than in the context, so the
+// IDs of a page are never taken by the page that replaces it.
+int GetNextUniqueId() {
+  return g_next_unique_id.GetNext() + 1;
+}
+
 void TakeHeapSnapshot(v8::Isolate* isolate) {
   isolate->GetHeapProfiler()->TakeHeapSnapshot(
       mate::StringToV8(isolate, "test"));
 }
 
+v8::Handle<v8::Value> GetHeapStatistics(v8::Isolate* isolate) {
+  v8::HeapStatistics stats;
+  isolate->GetHeapStatistics(&stats);
+
+  mate::Dictionary dict = mate::Dictionary::CreateEmpty(isolate);
+  dict.Set("totalHeapSize", static_cast<double>(stats.total_heap_size()));
+  dict.Set("totalHeapSizeExecutable",
+           static_cast<double>(stats.total_heap_size_executable()));
+  dict.Set("totalPhysicalSize",
+           static_cast<double>(stats.total_physical_size()));
+  dict.Set("usedHeapSize", static_cast<double>(stats.used_heap_size()));
+  dict.Set("heapSizeLimit", static_cast<double>(stats.heap_size_limit()));
+  return dict.GetHandle();
+}
+
+void LowMemoryNotification(v8::Isolate* isolate) {
+  isolate->LowMemoryNotification();
+}
+
+v8::Handle<v8::Value> RunScriptWithCodeCache(v8::Isolate* isolate,
+                                             v8::Handle<v8::String> source,
+                                             v8::Handle<v8::String> filename,
+                                             const base::FilePath& cache_dir,
+                                             bool read_only) {
+  return atom::RunScriptWithCodeCache(isolate, source, filename, cache_dir,
+                                      read_only);
+}
+
+v8::Handle<v8::Value> ReadScriptFile(v8::Isolate* isolate,
+                                     const base::FilePath& path) {
+  std::string source;
+  if (!atom::ReadScriptFile(path, &source))
+    return v8::False(isolate);
+  return mate::StringToV8(isolate, source);
+}
+
 void Initialize(v8::Handle<v8::Object> exports, v8::Handle<v8::Value> unused,
                 v8::Handle<v8::Context> context, void* priv) {
   mate::Dictionary dict(context->GetIsolate(), exports);
@@ -51,7 +100,12 @@ void Initialize(v8::Handle<v8::Object> exports, v8::Handle<v8::Value> unused,
   dict.SetMethod("setHiddenValue", &SetHiddenValue);
   dict.SetMethod("getObjectHash", &GetObjectHash);
   dict.SetMethod("setDestructor", &SetDestructor);
+  dict.SetMethod("getNextUniqueId", &GetNextUniqueId);
   dict.SetMethod("takeHeapSnapshot", &TakeHeapSnapshot);
+  dict.SetMethod("getHeapStatistics", &GetHeapStatistics);
+  dict.SetMethod("lowMemoryNotification", &LowMemoryNotification);
+  dict.SetMethod("runScriptWithCodeCache", &RunScriptWithCodeCache);
+  dict.SetMethod("readScriptFile", &ReadScriptFile);
 }
 
 }  // namespace
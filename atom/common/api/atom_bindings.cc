@@ -6,12 +6,18 @@
 
 #include <algorithm>
 #include <string>
+#include <vector>
 
 #include "atom/common/atom_version.h"
 #include "atom/common/chrome_version.h"
+#include "atom/common/loop_stats.h"
 #include "atom/common/native_mate_converters/string16_converter.h"
+#include "atom/common/node_bindings.h"
+#include "atom/common/startup_timings.h"
 #include "base/logging.h"
+#include "base/message_loop/message_loop.h"
 #include "native_mate/dictionary.h"
+#include "native_mate/locker.h"
 
 #include "atom/common/node_includes.h"
 
@@ -33,14 +39,68 @@ void FatalErrorCallback(const char* location, const char* message) {
   Crash();
 }
 
+void SetTimerSlack(int ms) {
+  NodeBindings::SetTimerSlack(base::TimeDelta::FromMilliseconds(ms));
+}
+
 void Log(const base::string16& message) {
   logging::LogMessage("CONSOLE", 0, 0).stream() << message;
 }
 
+v8::Handle<v8::Value> GetLoopStats(v8::Isolate* isolate) {
+  LoopStats* stats = LoopStats::GetInstance();
+  mate::Dictionary dict(isolate, v8::Object::New(isolate));
+  dict.Set("uvRuns", static_cast<double>(stats->uv_runs()));
+  dict.Set("uvIterations", static_cast<double>(stats->uv_iterations()));
+  dict.Set("uvTime", stats->uv_time().InMillisecondsF());
+  dict.Set("tasks", static_cast<double>(stats->tasks()));
+  dict.Set("taskTime", stats->task_time().InMillisecondsF());
+
+  mate::Dictionary latency(isolate, v8::Object::New(isolate));
+  int64 wakeups = stats->wakeups();
+  latency.Set("count", static_cast<double>(wakeups));
+  latency.Set("mean", wakeups == 0 ? 0.0 :
+      stats->wakeup_latency_total().InMillisecondsF() / wakeups);
+  latency.Set("max", stats->wakeup_latency_max().InMillisecondsF());
+  v8::Local<v8::Array> buckets =
+      v8::Array::New(isolate, LoopStats::kLatencyBucketCount);
+  for (size_t i = 0; i < LoopStats::kLatencyBucketCount; ++i) {
+    mate::Dictionary bucket(isolate, v8::Object::New(isolate));
+    if (i < LoopStats::kLatencyBucketCount - 1)
+      bucket.Set("upTo", LoopStats::kLatencyBucketBounds[i] / 1000.0);
+    else
+      bucket.Set("upTo", v8::Null(isolate));
+    bucket.Set("count", static_cast<double>(stats->latency_bucket(i)));
+    buckets->Set(i, bucket.GetHandle());
+  }
+  latency.Set("buckets", buckets);
+  dict.Set("wakeupLatency", latency);
+  dict.Set("coalescedTimerWakeups",
+           static_cast<double>(stats->coalesced_timer_wakeups()));
+  return dict.GetHandle();
+}
+
+v8::Handle<v8::Value> GetStartupTimings(v8::Isolate* isolate) {
+  StartupTimings* timings = StartupTimings::GetInstance();
+  const std::vector<StartupTimings::Milestone>& milestones =
+      timings->milestones();
+  v8::Local<v8::Array> result = v8::Array::New(isolate, milestones.size());
+  for (size_t i = 0; i < milestones.size(); ++i) {
+    mate::Dictionary milestone(isolate, v8::Object::New(isolate));
+    milestone.Set("name", milestones[i].name);
+    milestone.Set("time",
+                  (milestones[i].time - timings->origin()).InMillisecondsF());
+    result->Set(i, milestone.GetHandle());
+  }
+  return result;
+}
+
 }  // namespace
 
 
-AtomBindings::AtomBindings() {
+AtomBindings::AtomBindings()
+    : next_tick_task_posted_(false),
+      weak_factory_(this) {
   uv_async_init(uv_default_loop(), &call_next_tick_async_, OnCallNextTick);
   call_next_tick_async_.data = this;
 }
@@ -55,8 +115,13 @@ void AtomBindings::BindTo(v8::Isolate* isolate,
   mate::Dictionary dict(isolate, process);
   dict.SetMethod("crash", &Crash);
   dict.SetMethod("log", &Log);
+  dict.SetMethod("getLoopStats", &GetLoopStats);
+  dict.SetMethod("setTimerSlack", &SetTimerSlack);
+  dict.SetMethod("getStartupTimings", &GetStartupTimings);
   dict.SetMethod("activateUvLoop",
       base::Bind(&AtomBindings::ActivateUVLoop, base::Unretained(this)));
+  dict.SetMethod("scheduleNextTick",
+      base::Bind(&AtomBindings::ScheduleNextTick, base::Unretained(this)));
 
   // Do not warn about deprecated APIs.
   dict.Set("noDeprecation", true);
@@ -69,21 +134,50 @@ void AtomBindings::BindTo(v8::Isolate* isolate,
 }
 
 void AtomBindings::ActivateUVLoop(v8::Isolate* isolate) {
-  node::Environment* env = node::Environment::GetCurrent(isolate);
-  if (std::find(pending_next_ticks_.begin(), pending_next_ticks_.end(), env) !=
-      pending_next_ticks_.end())
+  AddPendingNextTick(isolate);
+  uv_async_send(&call_next_tick_async_);
+}
+
+void AtomBindings::ScheduleNextTick(v8::Isolate* isolate) {
+  AddPendingNextTick(isolate);
+  if (next_tick_task_posted_)
     return;
 
-  pending_next_ticks_.push_back(env);
-  uv_async_send(&call_next_tick_async_);
+  next_tick_task_posted_ = true;
+  base::MessageLoop::current()->PostTask(
+      FROM_HERE, base::Bind(&AtomBindings::OnNextTickTask,
+                            weak_factory_.GetWeakPtr()));
+}
+
+void AtomBindings::AddPendingNextTick(v8::Isolate* isolate) {
+  node::Environment* env = node::Environment::GetCurrent(isolate);
+  if (std::find(pending_next_ticks_.begin(), pending_next_ticks_.end(), env) ==
+      pending_next_ticks_.end())
+    pending_next_ticks_.push_back(env);
 }
 
 // static
 void AtomBindings::OnCallNextTick(uv_async_t* handle) {
   AtomBindings* self = static_cast<AtomBindings*>(handle->data);
+  self->CallNextTicks();
+}
+
+void AtomBindings::OnNextTickTask() {
+  next_tick_task_posted_ = false;
+  if (pending_next_ticks_.empty())
+    return;
+
+  // Unlike uv callbacks, tasks are not run under the scopes of UvRunOnce.
+  v8::Isolate* isolate = pending_next_ticks_.front()->isolate();
+  mate::Locker locker(isolate);
+  v8::HandleScope handle_scope(isolate);
+  CallNextTicks();
+}
+
+void AtomBindings::CallNextTicks() {
   for (std::list<node::Environment*>::const_iterator it =
-           self->pending_next_ticks_.begin();
-       it != self->pending_next_ticks_.end(); ++it) {
+           pending_next_ticks_.begin();
+       it != pending_next_ticks_.end(); ++it) {
     node::Environment* env = *it;
     node::Environment::TickInfo* tick_info = env->tick_info();
 
@@ -101,7 +195,7 @@ void AtomBindings::OnCallNextTick(uv_async_t* handle) {
     tick_info->set_in_tick(false);
   }
 
-  self->pending_next_ticks_.clear();
+  pending_next_ticks_.clear();
 }
 
 }  // namespace atom
@@ -7,6 +7,7 @@
 
 #include <list>
 
+#include "base/memory/weak_ptr.h"
 #include "base/strings/string16.h"
 #include "v8/include/v8.h"
 #include "vendor/node/deps/uv/include/uv.h"
@@ -27,13 +28,28 @@ class AtomBindings {
   void BindTo(v8::Isolate* isolate, v8::Handle<v8::Object> process);
 
  private:
+  // Wakes up the uv loop, which also runs the pending nextTick callbacks.
   void ActivateUVLoop(v8::Isolate* isolate);
 
+  // Runs the pending nextTick callbacks in a task of main thread's message
+  // loop, which does not need to wake up the uv loop.
+  void ScheduleNextTick(v8::Isolate* isolate);
+
+  // Adds the environment of |isolate| to |pending_next_ticks_|.
+  void AddPendingNextTick(v8::Isolate* isolate);
+
   static void OnCallNextTick(uv_async_t* handle);
+  void OnNextTickTask();
+  void CallNextTicks();
 
   uv_async_t call_next_tick_async_;
   std::list<node::Environment*> pending_next_ticks_;
 
+  // Whether OnNextTickTask has been posted but not run yet.
+  bool next_tick_task_posted_;
+
+  base::WeakPtrFactory<AtomBindings> weak_factory_;
+
   DISALLOW_COPY_AND_ASSIGN(AtomBindings);
 };
 
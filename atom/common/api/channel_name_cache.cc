@@ -0,0 +1,60 @@
+// Copyright (c) 2015 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#include "atom/common/api/channel_name_cache.h"
+
+#include "base/containers/scoped_ptr_hash_map.h"
+#include "base/lazy_instance.h"
+#include "native_mate/scoped_persistent.h"
+
+namespace atom {
+
+namespace {
+
+// Channels are a handful of fixed names, the limit only guards against apps
+// using unique channel names.
+const size_t kMaxCachedChannels = 256;
+
+struct ChannelNameCache {
+  ChannelNameCache() : isolate(nullptr) {}
+
+  v8::Isolate* isolate;
+  base::ScopedPtrHashMap<base::string16,
+                         mate::ScopedPersistent<v8::String>> names;
+};
+
+base::LazyInstance<ChannelNameCache>::Leaky g_channel_name_cache =
+    LAZY_INSTANCE_INITIALIZER;
+
+v8::Local<v8::String> CreateChannelName(v8::Isolate* isolate,
+                                       const base::string16& channel) {
+  return v8::String::NewFromTwoByte(
+      isolate,
+      reinterpret_cast<const uint16_t*>(channel.data()),
+      v8::String::kInternalizedString,
+      static_cast<int>(channel.size()));
+}
+
+}  // namespace
+
+v8::Local<v8::String> GetChannelName(v8::Isolate* isolate,
+                                     const base::string16& channel) {
+  ChannelNameCache& cache = g_channel_name_cache.Get();
+  if (!cache.isolate)
+    cache.isolate = isolate;
+  if (cache.isolate != isolate)
+    return CreateChannelName(isolate, channel);
+
+  mate::ScopedPersistent<v8::String>* name = cache.names.get(channel);
+  if (name)
+    return name->NewHandle();
+
+  v8::Local<v8::String> result = CreateChannelName(isolate, channel);
+  if (cache.names.size() < kMaxCachedChannels)
+    cache.names.set(channel, make_scoped_ptr(
+        new mate::ScopedPersistent<v8::String>(isolate, result)));
+  return result;
+}
+
+}  // namespace atom
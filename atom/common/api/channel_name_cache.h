@@ -0,0 +1,22 @@
+// Copyright (c) 2015 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#ifndef ATOM_COMMON_API_CHANNEL_NAME_CACHE_H_
+#define ATOM_COMMON_API_CHANNEL_NAME_CACHE_H_
+
+#include "base/strings/string16.h"
+#include "v8/include/v8.h"
+
+namespace atom {
+
+// Returns the internalized V8 string of the IPC |channel|. The strings are
+// kept for the first isolate it is called with, so messages on the same
+// channel skip the string conversions. Must only be called on the thread of
+// the main isolate.
+v8::Local<v8::String> GetChannelName(v8::Isolate* isolate,
+                                     const base::string16& channel);
+
+}  // namespace atom
+
+#endif  // ATOM_COMMON_API_CHANNEL_NAME_CACHE_H_
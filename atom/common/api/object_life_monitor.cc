@@ -5,10 +5,24 @@
 
 #include "atom/common/api/object_life_monitor.h"
 
+#include <algorithm>
+#include <vector>
+
+#include "base/bind.h"
+#include "base/lazy_instance.h"
+#include "base/message_loop/message_loop.h"
 #include "native_mate/compat.h"
 
 namespace atom {
 
+namespace {
+
+// The monitors of collected objects waiting for their destructors to run.
+base::LazyInstance<std::vector<ObjectLifeMonitor*>>::Leaky g_collected =
+    LAZY_INSTANCE_INITIALIZER;
+
+}  // namespace
+
 // static
 void ObjectLifeMonitor::BindTo(v8::Isolate* isolate,
                                v8::Handle<v8::Object> target,
@@ -23,14 +37,65 @@ void ObjectLifeMonitor::BindTo(v8::Isolate* isolate,
 ObjectLifeMonitor::ObjectLifeMonitor() {
 }
 
+ObjectLifeMonitor::~ObjectLifeMonitor() {
+}
+
 // static
 void ObjectLifeMonitor::WeakCallback(
     const v8::WeakCallbackData<v8::Object, ObjectLifeMonitor>& data) {
-  // destructor.call(object, object);
-  v8::Local<v8::Object> obj = data.GetValue();
-  v8::Local<v8::Function>::Cast(obj->GetHiddenValue(
-      MATE_STRING_NEW(data.GetIsolate(), "destructor")))->Call(obj, 0, NULL);
-  delete data.GetParameter();
+  // Calling into JS from GC is slow, so only keep the object and its
+  // destructor alive here, the destructor is called on the object later.
+  v8::Isolate* isolate = data.GetIsolate();
+  ObjectLifeMonitor* olm = data.GetParameter();
+  v8::Local<v8::Object> object = data.GetValue();
+  v8::Local<v8::Value> destructor = object->GetHiddenValue(
+      MATE_STRING_NEW(isolate, "destructor"));
+  olm->handle_.reset();
+  if (destructor.IsEmpty() || !destructor->IsFunction()) {
+    delete olm;
+    return;
+  }
+  olm->object_.reset(isolate, object);
+  olm->destructor_.reset(isolate, v8::Local<v8::Function>::Cast(destructor));
+
+  std::vector<ObjectLifeMonitor*>& collected = g_collected.Get();
+  collected.push_back(olm);
+  if (collected.size() == 1)
+    base::MessageLoop::current()->PostTask(
+        FROM_HERE, base::Bind(&ObjectLifeMonitor::RunDestructors, isolate));
+}
+
+// static
+void ObjectLifeMonitor::RunDestructors(v8::Isolate* isolate) {
+  std::vector<ObjectLifeMonitor*> collected;
+  collected.swap(g_collected.Get());
+
+  v8::Locker locker(isolate);
+  v8::HandleScope handle_scope(isolate);
+  for (ObjectLifeMonitor* olm : collected) {
+    // destructor.call(object);
+    v8::Handle<v8::Function> destructor = olm->destructor_.NewHandle();
+    v8::Context::Scope context_scope(destructor->CreationContext());
+    destructor->Call(olm->object_.NewHandle(), 0, NULL);
+    delete olm;
+  }
+}
+
+// static
+void ObjectLifeMonitor::ReleaseContext(v8::Handle<v8::Context> context) {
+  std::vector<ObjectLifeMonitor*>& collected = g_collected.Get();
+  if (collected.empty())
+    return;
+
+  v8::HandleScope handle_scope(context->GetIsolate());
+  auto released = std::partition(
+      collected.begin(), collected.end(),
+      [&context](ObjectLifeMonitor* olm) {
+        return olm->destructor_.NewHandle()->CreationContext() != context;
+      });
+  for (auto it = released; it != collected.end(); ++it)
+    delete *it;
+  collected.erase(released, collected.end());
 }
 
 }  // namespace atom
@@ -10,20 +10,36 @@
 
 namespace atom {
 
+// Calls the destructor of an object after it is garbage collected, with the
+// object as |this|. The destructors of the objects collected by one GC are not
+// called inside the GC, but together in one task posted after it, the objects
+// are kept alive until then.
 class ObjectLifeMonitor {
  public:
   static void BindTo(v8::Isolate* isolate,
                      v8::Handle<v8::Object> target,
                      v8::Handle<v8::Value> destructor);
 
+  // Drops the pending destructors created in |context|, which is going away,
+  // so they never run.
+  static void ReleaseContext(v8::Handle<v8::Context> context);
+
  private:
   ObjectLifeMonitor();
+  ~ObjectLifeMonitor();
 
   static void WeakCallback(
       const v8::WeakCallbackData<v8::Object, ObjectLifeMonitor>& data);
 
+  // Runs the destructors of all the collected objects.
+  static void RunDestructors(v8::Isolate* isolate);
+
   mate::ScopedPersistent<v8::Object> handle_;
 
+  // Only kept alive when the object has been collected.
+  mate::ScopedPersistent<v8::Object> object_;
+  mate::ScopedPersistent<v8::Function> destructor_;
+
   DISALLOW_COPY_AND_ASSIGN(ObjectLifeMonitor);
 };
 
@@ -4,78 +4,123 @@
 
 #include "atom/common/asar/archive.h"
 
+#if defined(OS_POSIX)
+#include <fcntl.h>
+#endif
+
+#if defined(OS_LINUX)
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#include <algorithm>
 #include <string>
 #include <vector>
 
 #include "atom/common/asar/scoped_temporary_file.h"
+#include "atom/common/options_switches.h"
+#include "base/bind.h"
+#include "base/command_line.h"
+#include "base/debug/trace_event.h"
 #include "base/files/file.h"
+#include "base/files/file_util.h"
+#include "base/format_macros.h"
 #include "base/logging.h"
+#include "base/md5.h"
 #include "base/pickle.h"
-#include "base/json/json_string_value_serializer.h"
+#include "base/stl_util.h"
+#include "base/json/json_reader.h"
+#include "base/values.h"
 #include "base/strings/string_number_conversions.h"
+#include "base/strings/stringprintf.h"
+#include "base/threading/thread_restrictions.h"
+#include "base/threading/worker_pool.h"
+#include "crypto/sha2.h"
+#include "zlib.h"
 
 namespace asar {
 
 namespace {
 
-#if defined(OS_WIN)
-const char kSeparators[] = "\\/";
-#else
-const char kSeparators[] = "/";
+#if defined(OS_LINUX) && defined(__NR_memfd_create)
+// MFD_CLOEXEC, which older system headers do not define.
+const unsigned int kMemfdCloexec = 0x0001U;
 #endif
 
-bool GetNodeFromPath(std::string path,
-                     const base::DictionaryValue* root,
-                     const base::DictionaryValue** out);
-
-// Gets the "files" from "dir".
-bool GetFilesNode(const base::DictionaryValue* root,
-                  const base::DictionaryValue* dir,
-                  const base::DictionaryValue** out) {
-  // Test for symbol linked directory.
-  std::string link;
-  if (dir->GetStringWithoutPathExpansion("link", &link)) {
-    const base::DictionaryValue* linked_node = NULL;
-    if (!GetNodeFromPath(link, root, &linked_node))
-      return false;
-    dir = linked_node;
-  }
-
-  return dir->GetDictionaryWithoutPathExpansion("files", out);
+// The keys of index are always separated by "/".
+const char kSeparator = '/';
+
+// Max number of symbol links to follow in one lookup, mirrors ELOOP.
+const int kMaxLinkDepth = 32;
+
+// The binary header starts with this magic number instead of the length of
+// JSON string, followed by the format version.
+const uint32 kBinaryHeaderMagic = 0x42525341;  // "ASRB"
+const uint32 kBinaryHeaderVersion = 2;
+
+// Version 1 entries do not have the |compressed_size| and |hash_offset|
+// fields.
+const size_t kBinaryHeaderEntrySizeV1 = 32;
+
+// Layout of binary header:
+//   uint32 magic, uint32 version, uint32 entry_count, uint32 strings_size,
+//   BinaryHeaderEntry entries[entry_count], char strings[strings_size].
+// Entries are sorted by path with components compared one by one, so a
+// directory always comes before its children.
+struct BinaryHeaderEntry {
+  enum Flags {
+    DIRECTORY = 1 << 0,
+    LINK      = 1 << 1,
+    UNPACKED  = 1 << 2,
+    // The SHA-256 hash of the stored bytes is at |hash_offset| in the string
+    // table.
+    INTEGRITY = 1 << 3,
+  };
+
+  // Full path relative to archive root, in the string table.
+  uint32 path_offset;
+  uint32 path_size;
+  // Target of the symbol link, in the string table.
+  uint32 link_offset;
+  uint32 link_size;
+  uint32 flags;
+  uint32 size;
+  uint64 offset;
+  // Size of the zlib stream in the package, 0 for files stored as is.
+  uint32 compressed_size;
+  uint32 hash_offset;
+};
+static_assert(sizeof(BinaryHeaderEntry) == 40,
+              "BinaryHeaderEntry should be packed");
+
+// Whether |size| bytes at |offset| are within the first |limit| bytes, the
+// sizes come from the package so the check can not overflow.
+bool IsInRange(uint64 offset, uint64 size, uint64 limit) {
+  return offset <= limit && size <= limit - offset;
 }
 
-// Gets sub-file "name" from "dir".
-bool GetChildNode(const base::DictionaryValue* root,
-                  const std::string& name,
-                  const base::DictionaryValue* dir,
-                  const base::DictionaryValue** out) {
-  const base::DictionaryValue* files = NULL;
-  return GetFilesNode(root, dir, &files) &&
-         files->GetDictionaryWithoutPathExpansion(name, out);
+std::string PathToKey(const base::FilePath& path) {
+  std::string key = path.AsUTF8Unsafe();
+#if defined(OS_WIN)
+  std::replace(key.begin(), key.end(), '\\', kSeparator);
+#endif
+  return key;
 }
 
-// Gets the node of "path" from "root".
-bool GetNodeFromPath(std::string path,
-                     const base::DictionaryValue* root,
-                     const base::DictionaryValue** out) {
-  if (path == "") {
-    *out = root;
-    return true;
-  }
-
-  const base::DictionaryValue* dir = root;
-  for (size_t delimiter_position = path.find_first_of(kSeparators);
-       delimiter_position != std::string::npos;
-       delimiter_position = path.find_first_of(kSeparators)) {
-    const base::DictionaryValue* child = NULL;
-    if (!GetChildNode(root, path.substr(0, delimiter_position), dir, &child))
-      return false;
-
-    dir = child;
-    path.erase(0, delimiter_position + 1);
-  }
-
-  return GetChildNode(root, path, dir, out);
+// Reads the "integrity" of node, only SHA256 is supported.
+bool GetIntegrityHash(const base::DictionaryValue* node, std::string* hash) {
+  const base::DictionaryValue* integrity;
+  std::string algorithm, hex;
+  std::vector<uint8> bytes;
+  if (!node->GetDictionary("integrity", &integrity) ||
+      !integrity->GetString("algorithm", &algorithm) ||
+      algorithm != "SHA256" ||
+      !integrity->GetString("hash", &hex) ||
+      !base::HexStringToBytes(hex, &bytes) ||
+      bytes.size() != crypto::kSHA256Length)
+    return false;
+  hash->assign(bytes.begin(), bytes.end());
+  return true;
 }
 
 bool FillFileInfoWithNode(Archive::FileInfo* info,
@@ -90,143 +135,477 @@ bool FillFileInfoWithNode(Archive::FileInfo* info,
   if (node->GetBoolean("unpacked", &info->unpacked) && info->unpacked)
     return true;
 
+  int compressed_size;
+  if (node->GetInteger("compressedSize", &compressed_size))
+    info->compressed_size = static_cast<uint32>(compressed_size);
+
   std::string offset;
   if (!node->GetString("offset", &offset))
     return false;
-  if (!base::StringToUint64(offset, &info->offset))
+  if (!base::StringToUint64(offset, &info->offset) ||
+      info->offset > kuint64max - header_size)
     return false;
   info->offset += header_size;
 
   return true;
 }
 
+// Decompress the zlib stream in |data| into |out|, which must have exactly
+// |size| bytes.
+bool Inflate(const char* data, uint32 data_size, uint32 size,
+             std::string* out) {
+  out->resize(size);
+  if (size == 0)
+    return true;
+
+  z_stream stream = { 0 };
+  if (inflateInit(&stream) != Z_OK)
+    return false;
+  stream.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(data));
+  stream.avail_in = data_size;
+  stream.next_out = reinterpret_cast<Bytef*>(&(*out)[0]);
+  stream.avail_out = size;
+  int result = inflate(&stream, Z_FINISH);
+  inflateEnd(&stream);
+  return result == Z_STREAM_END && stream.total_out == size;
+}
+
+#if defined(OS_WIN)
+// Read |ranges| of |file| and drop the data, so they are in the page cache
+// when they are needed.
+void ReadRanges(base::File file, const std::vector<Archive::Range>& ranges) {
+  const int kChunkSize = 64 * 1024;
+  std::vector<char> buf(kChunkSize);
+  for (const Archive::Range& range : ranges) {
+    for (uint64 read = 0; read < range.size; read += kChunkSize) {
+      int size = static_cast<int>(
+          std::min(range.size - read, static_cast<uint64>(kChunkSize)));
+      if (file.Read(range.offset + read, buf.data(), size) <= 0)
+        break;
+    }
+  }
+}
+#endif
+
 }  // namespace
 
 Archive::Archive(const base::FilePath& path)
     : path_(path),
-      header_size_(0) {
+      header_size_(0),
+      has_links_(false),
+      record_access_(false) {
 }
 
 Archive::~Archive() {
 }
 
 bool Archive::Init() {
-  base::File file(path_, base::File::FLAG_OPEN | base::File::FLAG_READ);
-  if (!file.IsValid())
+  TRACE_EVENT1("atom", "Archive::Init", "path", path_.AsUTF8Unsafe());
+  std::vector<char> buf;
+  const char* data;
+  uint32 size;
+  if (mapped_file_) {
+    // Parse the header directly from the mapped memory.
+    if (mapped_file_->length() < 8) {
+      LOG(ERROR) << "Failed to read header size from " << path_.value();
+      return false;
+    }
+    data = reinterpret_cast<const char*>(mapped_file_->data());
+    if (!PickleIterator(Pickle(data, 8)).ReadUInt32(&size) ||
+        size > kuint32max - 8) {
+      LOG(ERROR) << "Failed to parse header size from " << path_.value();
+      return false;
+    }
+    if (!IsInRange(8, size, mapped_file_->length())) {
+      LOG(ERROR) << "Failed to read header from " << path_.value();
+      return false;
+    }
+    data += 8;
+  } else {
+    // The handle is kept for reading the files later.
+    if (!OpenFile())
+      return false;
+
+    int len;
+    buf.resize(8);
+    len = ReadAt(0, buf.data(), buf.size());
+    if (len != static_cast<int>(buf.size())) {
+      PLOG(ERROR) << "Failed to read header size from " << path_.value();
+      return false;
+    }
+
+    if (!PickleIterator(Pickle(buf.data(), buf.size())).ReadUInt32(&size) ||
+        size > kuint32max - 8) {
+      LOG(ERROR) << "Failed to parse header size from " << path_.value();
+      return false;
+    }
+
+    buf.resize(size);
+    len = ReadAt(8, buf.data(), buf.size());
+    if (len != static_cast<int>(buf.size())) {
+      PLOG(ERROR) << "Failed to read header from " << path_.value();
+      return false;
+    }
+    data = buf.data();
+  }
+
+  header_size_ = 8 + size;
+
+  Pickle pickle(data, size);
+  PickleIterator iter(pickle);
+  uint32 magic;
+  if (iter.ReadUInt32(&magic) && magic == kBinaryHeaderMagic) {
+    if (!ParseBinaryHeader(&iter)) {
+      LOG(ERROR) << "Failed to parse binary header from " << path_.value();
+      index_.clear();
+      return false;
+    }
+  } else {
+    std::string header;
+    if (!PickleIterator(pickle).ReadString(&header)) {
+      LOG(ERROR) << "Failed to parse header from " << path_.value();
+      return false;
+    }
+    if (!ParseJSONHeader(header)) {
+      index_.clear();
+      return false;
+    }
+  }
+
+  if (has_links_)
+    ResolveLinks();
+  return true;
+}
+
+bool Archive::InitFromSnapshot(const char* data, size_t size) {
+  Pickle pickle(data, static_cast<int>(size));
+  PickleIterator iter(pickle);
+  uint32 magic;
+  if (!iter.ReadUInt32(&header_size_) ||
+      !iter.ReadUInt32(&magic) || magic != kBinaryHeaderMagic ||
+      !ParseBinaryHeader(&iter)) {
+    LOG(ERROR) << "Failed to parse header snapshot of " << path_.value();
+    index_.clear();
     return false;
+  }
 
-  std::vector<char> buf;
-  int len;
+  if (has_links_)
+    ResolveLinks();
+  return true;
+}
+
+void Archive::WriteSnapshot(Pickle* pickle) const {
+  std::vector<BinaryHeaderEntry> records;
+  std::string strings;
+
+  // Write entries in breadth-first order so parents always come before
+  // children, and children keep their order.
+  std::vector<std::string> queue(1, std::string());
+  for (size_t i = 0; i < queue.size(); ++i) {
+    EntryMap::const_iterator dir = index_.find(queue[i]);
+    if (dir == index_.end())
+      continue;
+
+    for (const std::string& name : dir->second.children) {
+      std::string key = queue[i].empty() ? name :
+                                           queue[i] + kSeparator + name;
+      EntryMap::const_iterator it = index_.find(key);
+      if (it == index_.end())
+        continue;
+
+      const Entry& entry = it->second;
+      BinaryHeaderEntry record = { 0 };
+      record.path_offset = strings.size();
+      record.path_size = key.size();
+      strings.append(key);
+      if (entry.is_link) {
+        record.flags = BinaryHeaderEntry::LINK;
+        record.link_offset = strings.size();
+        record.link_size = entry.link_path.size();
+        strings.append(entry.link_path);
+      } else if (entry.is_directory) {
+        record.flags = BinaryHeaderEntry::DIRECTORY;
+        queue.push_back(key);
+      } else {
+        record.size = entry.info.size;
+        if (entry.info.unpacked) {
+          record.flags = BinaryHeaderEntry::UNPACKED;
+        } else {
+          record.offset = entry.info.offset - header_size_;
+          record.compressed_size = entry.info.compressed_size;
+          base::hash_map<uint64, std::string>::const_iterator hash =
+              integrity_hashes_.find(entry.info.offset);
+          if (hash != integrity_hashes_.end()) {
+            record.flags = BinaryHeaderEntry::INTEGRITY;
+            record.hash_offset = strings.size();
+            strings.append(hash->second);
+          }
+        }
+      }
+      records.push_back(record);
+    }
+  }
+
+  pickle->WriteUInt32(header_size_);
+  pickle->WriteUInt32(kBinaryHeaderMagic);
+  pickle->WriteUInt32(kBinaryHeaderVersion);
+  pickle->WriteUInt32(records.size());
+  pickle->WriteUInt32(strings.size());
+  pickle->WriteBytes(records.data(), records.size() * sizeof(records[0]));
+  pickle->WriteBytes(strings.data(), strings.size());
+}
 
-  buf.resize(8);
-  len = file.ReadAtCurrentPos(buf.data(), buf.size());
-  if (len != static_cast<int>(buf.size())) {
-    PLOG(ERROR) << "Failed to read header size from " << path_.value();
+bool Archive::MapIntoMemory() {
+  if (mapped_file_)
+    return true;
+
+  scoped_ptr<base::MemoryMappedFile> mapped_file(new base::MemoryMappedFile);
+  if (!mapped_file->Initialize(path_)) {
+    LOG(WARNING) << "Failed to map " << path_.value();
     return false;
   }
 
-  uint32 size;
-  if (!PickleIterator(Pickle(buf.data(), buf.size())).ReadUInt32(&size)) {
-    LOG(ERROR) << "Failed to parse header size from " << path_.value();
+  mapped_file_ = mapped_file.Pass();
+  return true;
+}
+
+bool Archive::GetMappedContents(const FileInfo& info,
+                                const uint8** data) const {
+  if (!mapped_file_ || info.unpacked || info.compressed_size > 0 ||
+      !IsInRange(info.offset, info.size, mapped_file_->length()))
+    return false;
+
+  const uint8* contents = mapped_file_->data() + info.offset;
+  if (!VerifyIntegrity(info, reinterpret_cast<const char*>(contents)))
     return false;
+
+  *data = contents;
+  return true;
+}
+
+bool Archive::ReadContents(const FileInfo& info, std::string* contents) {
+  TRACE_EVENT1("atom", "Archive::ReadContents", "size", info.size);
+  if (info.unpacked)
+    return false;
+
+  if (info.compressed_size == 0) {
+    const uint8* data;
+    if (GetMappedContents(info, &data)) {
+      contents->assign(reinterpret_cast<const char*>(data), info.size);
+      return true;
+    }
+    contents->resize(info.size);
+    return info.size == 0 ||
+           (ReadAt(info.offset, &(*contents)[0], info.size) ==
+                static_cast<int>(info.size) &&
+            VerifyIntegrity(info, contents->data()));
+  }
+
+  std::string compressed;
+  const char* data;
+  if (mapped_file_ &&
+      IsInRange(info.offset, info.compressed_size, mapped_file_->length())) {
+    data = reinterpret_cast<const char*>(mapped_file_->data() + info.offset);
+  } else {
+    compressed.resize(info.compressed_size);
+    if (ReadAt(info.offset, &compressed[0], info.compressed_size) !=
+        static_cast<int>(info.compressed_size))
+      return false;
+    data = compressed.data();
   }
 
-  buf.resize(size);
-  len = file.ReadAtCurrentPos(buf.data(), buf.size());
-  if (len != static_cast<int>(buf.size())) {
-    PLOG(ERROR) << "Failed to read header from " << path_.value();
+  if (!VerifyIntegrity(info, data))
+    return false;
+
+  if (!Inflate(data, info.compressed_size, info.size, contents)) {
+    LOG(ERROR) << "Failed to decompress file at " << info.offset << " of "
+               << path_.value();
     return false;
   }
+  return true;
+}
 
-  std::string header;
-  if (!PickleIterator(Pickle(buf.data(), buf.size())).ReadString(&header)) {
-    LOG(ERROR) << "Failed to parse header from " << path_.value();
+bool Archive::OpenFile() {
+  base::AutoLock auto_lock(file_lock_);
+  if (file_.IsValid())
+    return true;
+
+  base::ThreadRestrictions::ScopedAllowIO allow_io;
+  file_.Initialize(path_, base::File::FLAG_OPEN | base::File::FLAG_READ);
+  if (!file_.IsValid()) {
+    PLOG(ERROR) << "Failed to open " << path_.value();
     return false;
   }
+  return true;
+}
 
-  std::string error;
-  JSONStringValueSerializer serializer(&header);
-  base::Value* value = serializer.Deserialize(NULL, &error);
-  if (!value || !value->IsType(base::Value::TYPE_DICTIONARY)) {
-    LOG(ERROR) << "Failed to parse header: " << error;
+bool Archive::HasIntegrityHash(const FileInfo& info) const {
+  return !info.unpacked && ContainsKey(integrity_hashes_, info.offset);
+}
+
+bool Archive::VerifyIntegrity(const FileInfo& info, const char* data) const {
+  base::hash_map<uint64, std::string>::const_iterator it =
+      integrity_hashes_.find(info.offset);
+  if (info.unpacked || it == integrity_hashes_.end())
+    return true;
+
+  {
+    base::AutoLock auto_lock(verified_lock_);
+    if (ContainsKey(verified_offsets_, info.offset))
+      return true;
+  }
+
+  uint32 size = info.compressed_size > 0 ? info.compressed_size : info.size;
+  if (crypto::SHA256HashString(base::StringPiece(data, size)) != it->second) {
+    LOG(ERROR) << "Integrity check failed for file at " << info.offset
+               << " of " << path_.value();
     return false;
   }
 
-  header_size_ = 8 + size;
-  header_.reset(static_cast<base::DictionaryValue*>(value));
+  base::AutoLock auto_lock(verified_lock_);
+  verified_offsets_.insert(info.offset);
+  return true;
+}
+
+int Archive::ReadAt(uint64 offset, char* data, int size) {
+  if (!OpenFile())
+    return -1;
+
+  // The sync fs APIs read from the main thread.
+  base::ThreadRestrictions::ScopedAllowIO allow_io;
+
+  // The positional read does not move the file pointer, so concurrent reads
+  // do not need to be serialized.
+  return file_.Read(static_cast<int64>(offset), data, size);
+}
+
+bool Archive::GetHeaderHash(std::string* hash) {
+  TRACE_EVENT0("atom", "Archive::GetHeaderHash");
+  std::string header;
+  if (mapped_file_ && mapped_file_->length() >= header_size_) {
+    header.assign(reinterpret_cast<const char*>(mapped_file_->data()),
+                  header_size_);
+  } else {
+    header.resize(header_size_);
+    if (header.empty() ||
+        ReadAt(0, &header[0], header_size_) != static_cast<int>(header_size_))
+      return false;
+  }
+
+  std::string digest = crypto::SHA256HashString(header);
+  *hash = base::HexEncode(digest.data(), digest.size());
   return true;
 }
 
 bool Archive::GetFileInfo(const base::FilePath& path, FileInfo* info) {
-  if (!header_)
+  TRACE_EVENT0("atom", "Archive::GetFileInfo");
+  const Entry* entry = FindEntry(path);
+  if (entry && entry->is_link)
+    entry = entry->link;
+  if (!entry || entry->is_directory)
     return false;
 
-  const base::DictionaryValue* node;
-  if (!GetNodeFromPath(path.AsUTF8Unsafe(), header_.get(), &node))
-    return false;
+  *info = entry->info;
+
+  if (record_access_ && !info->unpacked) {
+    base::AutoLock auto_lock(access_lock_);
+    if (accessed_offsets_.insert(info->offset).second) {
+      Range range;
+      range.offset = info->offset;
+      range.size = info->compressed_size > 0 ? info->compressed_size :
+                                               info->size;
+      accessed_ranges_.push_back(range);
+    }
+  }
+  return true;
+}
 
-  std::string link;
-  if (node->GetString("link", &link))
-    return GetFileInfo(base::FilePath::FromUTF8Unsafe(link), info);
+void Archive::StartRecordingAccess() {
+  record_access_ = true;
+}
 
-  return FillFileInfoWithNode(info, header_size_, node);
+std::vector<Archive::Range> Archive::GetAccessedRanges() {
+  base::AutoLock auto_lock(access_lock_);
+  return accessed_ranges_;
 }
 
-bool Archive::Stat(const base::FilePath& path, Stats* stats) {
-  if (!header_)
-    return false;
+void Archive::Prefetch(const std::vector<Range>& ranges) {
+  if (ranges.empty() || !OpenFile())
+    return;
 
-  const base::DictionaryValue* node;
-  if (!GetNodeFromPath(path.AsUTF8Unsafe(), header_.get(), &node))
+#if defined(OS_WIN)
+  // There is no readahead hint on Windows, so read the ranges on a worker
+  // thread instead.
+  base::WorkerPool::PostTask(
+      FROM_HERE,
+      base::Bind(&ReadRanges, base::Passed(file_.Duplicate()), ranges),
+      true);
+#else
+  int fd = file_.GetPlatformFile();
+  for (const Range& range : ranges) {
+#if defined(OS_MACOSX)
+    struct radvisory advisory;
+    advisory.ra_offset = static_cast<off_t>(range.offset);
+    advisory.ra_count = static_cast<int>(range.size);
+    fcntl(fd, F_RDADVISE, &advisory);
+#else
+    posix_fadvise(fd, static_cast<off_t>(range.offset),
+                  static_cast<off_t>(range.size), POSIX_FADV_WILLNEED);
+#endif
+  }
+#endif
+}
+
+bool Archive::Stat(const base::FilePath& path, Stats* stats) {
+  TRACE_EVENT0("atom", "Archive::Stat");
+  const Entry* entry = FindEntry(path);
+  if (!entry)
     return false;
 
-  if (node->HasKey("link")) {
+  if (entry->is_link) {
     stats->is_file = false;
     stats->is_link = true;
     return true;
   }
 
-  if (node->HasKey("files")) {
+  if (entry->is_directory) {
     stats->is_file = false;
     stats->is_directory = true;
     return true;
   }
 
-  return FillFileInfoWithNode(stats, header_size_, node);
+  *static_cast<FileInfo*>(stats) = entry->info;
+  return true;
 }
 
 bool Archive::Readdir(const base::FilePath& path,
                       std::vector<base::FilePath>* list) {
-  if (!header_)
+  const std::vector<std::string>* children = GetDirectoryChildren(path);
+  if (!children)
     return false;
 
-  const base::DictionaryValue* node;
-  if (!GetNodeFromPath(path.AsUTF8Unsafe(), header_.get(), &node))
-    return false;
-
-  const base::DictionaryValue* files;
-  if (!GetFilesNode(header_.get(), node, &files))
-    return false;
-
-  base::DictionaryValue::Iterator iter(*files);
-  while (!iter.IsAtEnd()) {
-    list->push_back(base::FilePath::FromUTF8Unsafe(iter.key()));
-    iter.Advance();
-  }
+  for (const std::string& name : *children)
+    list->push_back(base::FilePath::FromUTF8Unsafe(name));
   return true;
 }
 
-bool Archive::Realpath(const base::FilePath& path, base::FilePath* realpath) {
-  if (!header_)
-    return false;
+const std::vector<std::string>* Archive::GetDirectoryChildren(
+    const base::FilePath& path) const {
+  const Entry* entry = FindEntry(path);
+  if (entry && entry->is_link)
+    entry = entry->link;
+  if (!entry || !entry->is_directory)
+    return NULL;
+  return &entry->children;
+}
 
-  const base::DictionaryValue* node;
-  if (!GetNodeFromPath(path.AsUTF8Unsafe(), header_.get(), &node))
+bool Archive::Realpath(const base::FilePath& path, base::FilePath* realpath) {
+  const Entry* entry = FindEntry(path);
+  if (!entry)
     return false;
 
-  std::string link;
-  if (node->GetString("link", &link)) {
-    *realpath = base::FilePath::FromUTF8Unsafe(link);
+  if (entry->is_link) {
+    *realpath = base::FilePath::FromUTF8Unsafe(entry->link_path);
     return true;
   }
 
@@ -235,6 +614,8 @@ bool Archive::Realpath(const base::FilePath& path, base::FilePath* realpath) {
 }
 
 bool Archive::CopyFileOut(const base::FilePath& path, base::FilePath* out) {
+  // May be called from the threadpool and the main thread at the same time.
+  base::AutoLock auto_lock(external_files_lock_);
   if (external_files_.contains(path)) {
     *out = external_files_.get(path)->path();
     return true;
@@ -249,8 +630,14 @@ bool Archive::CopyFileOut(const base::FilePath& path, base::FilePath* out) {
     return true;
   }
 
+  base::CommandLine* command_line = base::CommandLine::ForCurrentProcess();
+  base::FilePath cache_dir =
+      command_line->GetSwitchValuePath(atom::switches::kAsarCacheDir);
+  if (!cache_dir.empty() && CopyFileOutToCache(path, info, cache_dir, out))
+    return true;
+
   scoped_ptr<ScopedTemporaryFile> temp_file(new ScopedTemporaryFile);
-  if (!temp_file->InitFromFile(path_, info.offset, info.size))
+  if (!FillTemporaryFile(info, temp_file.get()))
     return false;
 
   *out = temp_file->path();
@@ -258,4 +645,303 @@ bool Archive::CopyFileOut(const base::FilePath& path, base::FilePath* out) {
   return true;
 }
 
+bool Archive::CopyFileOutForDlopen(const base::FilePath& path,
+                                   base::FilePath* out) {
+#if defined(OS_LINUX)
+  if (CopyFileOutToMemory(path, out))
+    return true;
+#endif
+  return CopyFileOut(path, out);
+}
+
+#if defined(OS_LINUX)
+bool Archive::CopyFileOutToMemory(const base::FilePath& path,
+                                  base::FilePath* out) {
+#if defined(__NR_memfd_create)
+  base::AutoLock auto_lock(external_files_lock_);
+  if (!memory_files_.contains(path)) {
+    FileInfo info;
+    if (!GetFileInfo(path, &info) || info.unpacked)
+      return false;
+
+    std::string contents;
+    const uint8* data;
+    if (!GetMappedContents(info, &data) ||
+        info.compressed_size > 0 || HasIntegrityHash(info)) {
+      // ReadContents also decompresses and verifies the file.
+      if (!ReadContents(info, &contents))
+        return false;
+      data = reinterpret_cast<const uint8*>(contents.data());
+    }
+
+    int fd = syscall(__NR_memfd_create, path.BaseName().value().c_str(),
+                     kMemfdCloexec);
+    if (fd < 0)
+      return false;
+    scoped_ptr<base::ScopedFD> memory_file(new base::ScopedFD(fd));
+    if (!base::WriteFileDescriptor(fd, reinterpret_cast<const char*>(data),
+                                   static_cast<int>(info.size)))
+      return false;
+    memory_files_.set(path, memory_file.Pass());
+  }
+
+  *out = base::FilePath(base::StringPrintf(
+      "/proc/self/fd/%d", memory_files_.get(path)->get()));
+  return true;
+#else
+  return false;
+#endif
+}
+#endif
+
+void Archive::ClearExternalFiles() {
+  base::AutoLock auto_lock(external_files_lock_);
+  external_files_.clear();
+}
+
+void Archive::ReleaseExternalFiles(std::vector<base::FilePath>* paths) {
+  base::AutoLock auto_lock(external_files_lock_);
+  for (auto it = external_files_.begin(); it != external_files_.end(); ++it)
+    paths->push_back(it->second->Release());
+  external_files_.clear();
+}
+
+bool Archive::CopyFileOutToCache(const base::FilePath& path,
+                                 const FileInfo& info,
+                                 const base::FilePath& cache_dir,
+                                 base::FilePath* out) {
+  base::ThreadRestrictions::ScopedAllowIO allow_io;
+
+  // The archive may be replaced by an update, so its modification time is
+  // part of the key.
+  base::File::Info archive_info;
+  if (!base::GetFileInfo(path_, &archive_info))
+    return false;
+  std::string key = base::StringPrintf(
+      "%s\n%s\n%" PRIu64 "\n%u\n%" PRId64,
+      path_.AsUTF8Unsafe().c_str(), path.AsUTF8Unsafe().c_str(),
+      info.offset, info.size,
+      archive_info.last_modified.ToInternalValue());
+
+  // Keep the base name, so the extracted executables still have the right
+  // extension on Windows.
+  base::FilePath cache_path = cache_dir.AppendASCII(base::MD5String(key))
+                                       .Append(path.BaseName());
+  int64 cached_size;
+  if (base::GetFileSize(cache_path, &cached_size) &&
+      cached_size == static_cast<int64>(info.size)) {
+    *out = cache_path;
+    return true;
+  }
+
+  if (!base::CreateDirectory(cache_path.DirName()))
+    return false;
+
+  // Write to a temporary file first and then rename it, so other processes
+  // never see a partially written file.
+  ScopedTemporaryFile temp_file;
+  if (!temp_file.InitInDir(cache_path.DirName()) ||
+      !FillTemporaryFile(info, &temp_file) ||
+      !temp_file.MoveTo(cache_path))
+    return false;
+
+  *out = cache_path;
+  return true;
+}
+
+bool Archive::FillTemporaryFile(const FileInfo& info,
+                                ScopedTemporaryFile* temp_file) {
+  const uint8* data;
+  if (GetMappedContents(info, &data)) {
+    return temp_file->InitFromData(data, info.size);
+  }
+
+  // Files with hash are read as a whole so they can be verified first.
+  if (info.compressed_size > 0 || HasIntegrityHash(info)) {
+    std::string contents;
+    return ReadContents(info, &contents) &&
+           temp_file->InitFromData(
+               reinterpret_cast<const uint8*>(contents.data()),
+               contents.size());
+  }
+
+  return temp_file->InitFromFile(path_, info.offset, info.size);
+}
+
+bool Archive::ParseJSONHeader(const std::string& header) {
+  std::string error;
+  scoped_ptr<base::Value> value(base::JSONReader::ReadAndReturnError(
+      header, base::JSON_PARSE_RFC, NULL, &error));
+  if (!value || !value->IsType(base::Value::TYPE_DICTIONARY)) {
+    LOG(ERROR) << "Failed to parse header: " << error;
+    return false;
+  }
+
+  const base::DictionaryValue* root;
+  const base::DictionaryValue* files;
+  if (!value->GetAsDictionary(&root) ||
+      !root->GetDictionaryWithoutPathExpansion("files", &files)) {
+    LOG(ERROR) << "Failed to find files in header of " << path_.value();
+    return false;
+  }
+
+  Entry& root_entry = index_[""];
+  root_entry.is_directory = true;
+  BuildIndex("", files, &root_entry);
+  return true;
+}
+
+bool Archive::ParseBinaryHeader(PickleIterator* iter) {
+  uint32 version, count, strings_size;
+  if (!iter->ReadUInt32(&version) ||
+      (version != 1 && version != kBinaryHeaderVersion) ||
+      !iter->ReadUInt32(&count) || !iter->ReadUInt32(&strings_size))
+    return false;
+
+  const size_t entry_size = version == 1 ? kBinaryHeaderEntrySizeV1 :
+                                           sizeof(BinaryHeaderEntry);
+  const char* entries;
+  const char* strings;
+  if (count > static_cast<uint32>(kint32max) / entry_size ||
+      !iter->ReadBytes(&entries, count * entry_size) ||
+      !iter->ReadBytes(&strings, strings_size))
+    return false;
+
+  Entry& root_entry = index_[""];
+  root_entry.is_directory = true;
+
+  // The header may not be aligned in the mapped memory, so copy each record.
+  // Fields missing in old versions are left as zero.
+  BinaryHeaderEntry record = { 0 };
+  for (uint32 i = 0; i < count; ++i) {
+    memcpy(&record, entries + i * entry_size, entry_size);
+    if (record.path_size == 0 ||
+        !IsInRange(record.path_offset, record.path_size, strings_size) ||
+        !IsInRange(record.link_offset, record.link_size, strings_size) ||
+        ((record.flags & BinaryHeaderEntry::INTEGRITY) &&
+         !IsInRange(record.hash_offset, crypto::kSHA256Length,
+                    strings_size)) ||
+        (!(record.flags & BinaryHeaderEntry::UNPACKED) &&
+         record.offset > kuint64max - header_size_))
+      return false;
+
+    std::string key(strings + record.path_offset, record.path_size);
+    size_t separator = key.rfind(kSeparator);
+    std::string parent_key = separator == std::string::npos ?
+        std::string() : key.substr(0, separator);
+
+    // Parents are always stored before children.
+    EntryMap::iterator parent = index_.find(parent_key);
+    if (parent == index_.end() || !parent->second.is_directory)
+      return false;
+    parent->second.children.push_back(separator == std::string::npos ?
+                                      key : key.substr(separator + 1));
+
+    Entry& entry = index_[key];
+    if (record.flags & BinaryHeaderEntry::LINK) {
+      entry.is_link = true;
+      entry.link_path.assign(strings + record.link_offset, record.link_size);
+      has_links_ = true;
+    } else if (record.flags & BinaryHeaderEntry::DIRECTORY) {
+      entry.is_directory = true;
+    } else {
+      entry.info.size = record.size;
+      entry.info.unpacked = (record.flags & BinaryHeaderEntry::UNPACKED) != 0;
+      entry.info.offset = entry.info.unpacked ? 0 :
+                                                record.offset + header_size_;
+      entry.info.compressed_size = entry.info.unpacked ? 0 :
+                                                         record.compressed_size;
+      if (!entry.info.unpacked &&
+          (record.flags & BinaryHeaderEntry::INTEGRITY))
+        integrity_hashes_[entry.info.offset].assign(
+            strings + record.hash_offset, crypto::kSHA256Length);
+    }
+  }
+  return true;
+}
+
+void Archive::BuildIndex(const std::string& prefix,
+                         const base::DictionaryValue* dir,
+                         Entry* dir_entry) {
+  for (base::DictionaryValue::Iterator iter(*dir); !iter.IsAtEnd();
+       iter.Advance()) {
+    const base::DictionaryValue* node;
+    if (!iter.value().GetAsDictionary(&node))
+      continue;
+
+    std::string key = prefix.empty() ? iter.key() :
+                                       prefix + kSeparator + iter.key();
+    Entry entry;
+    const base::DictionaryValue* files;
+    if (node->GetStringWithoutPathExpansion("link", &entry.link_path)) {
+      entry.is_link = true;
+      has_links_ = true;
+    } else if (node->GetDictionaryWithoutPathExpansion("files", &files)) {
+      entry.is_directory = true;
+      BuildIndex(key, files, &entry);
+    } else if (!FillFileInfoWithNode(&entry.info, header_size_, node)) {
+      continue;
+    } else if (!entry.info.unpacked) {
+      std::string hash;
+      if (GetIntegrityHash(node, &hash))
+        integrity_hashes_[entry.info.offset] = hash;
+    }
+
+    dir_entry->children.push_back(iter.key());
+    index_[key] = entry;
+  }
+}
+
+void Archive::ResolveLinks() {
+  for (auto& item : index_) {
+    Entry& entry = item.second;
+    if (!entry.is_link)
+      continue;
+
+    // Follow the chain of links until reaching a real node, the elements of
+    // hash_map never move so it is safe to keep pointers to them.
+    const Entry* target = FindEntryByKey(entry.link_path);
+    for (int depth = 0; target && target->is_link; ++depth) {
+      if (depth == kMaxLinkDepth) {
+        target = NULL;
+        break;
+      }
+      entry.link_path = target->link_path;
+      target = FindEntryByKey(target->link_path);
+    }
+    entry.link = target;
+  }
+}
+
+const Archive::Entry* Archive::FindEntry(const base::FilePath& path) const {
+  return FindEntryByKey(PathToKey(path));
+}
+
+const Archive::Entry* Archive::FindEntryByKey(std::string key) const {
+  for (int depth = 0; depth < kMaxLinkDepth; ++depth) {
+    EntryMap::const_iterator it = index_.find(key);
+    if (it != index_.end())
+      return &it->second;
+    if (!has_links_)
+      return NULL;
+
+    // Only paths going through a linked directory are not in the index, find
+    // the deepest existing parent and replace it with the link's target.
+    size_t pos = key.rfind(kSeparator);
+    for (; pos != std::string::npos && pos > 0;
+         pos = key.rfind(kSeparator, pos - 1)) {
+      it = index_.find(key.substr(0, pos));
+      if (it != index_.end())
+        break;
+    }
+    if (pos == std::string::npos || pos == 0 || !it->second.is_link)
+      return NULL;
+
+    const std::string& link_path = it->second.link_path;
+    key = link_path.empty() ? key.substr(pos + 1) :
+                              link_path + key.substr(pos);
+  }
+  return NULL;
+}
+
 }  // namespace asar
@@ -5,11 +5,20 @@
 #ifndef ATOM_COMMON_ASAR_ARCHIVE_H_
 #define ATOM_COMMON_ASAR_ARCHIVE_H_
 
+#include <string>
 #include <vector>
 
+#include "base/containers/hash_tables.h"
 #include "base/containers/scoped_ptr_hash_map.h"
+#include "base/files/file.h"
 #include "base/files/file_path.h"
+#include "base/files/memory_mapped_file.h"
+#include "base/files/scoped_file.h"
 #include "base/memory/scoped_ptr.h"
+#include "base/synchronization/lock.h"
+
+class Pickle;
+class PickleIterator;
 
 namespace base {
 class DictionaryValue;
@@ -24,10 +33,19 @@ class ScopedTemporaryFile;
 class Archive {
  public:
   struct FileInfo {
-    FileInfo() : size(0), offset(0) {}
+    FileInfo() : size(0), offset(0), compressed_size(0) {}
     bool unpacked;
     uint32 size;
     uint64 offset;
+    // Size of the zlib stream stored in the package when the file is
+    // compressed, 0 when the file is stored as is.
+    uint32 compressed_size;
+  };
+
+  // A range of bytes in the package.
+  struct Range {
+    uint64 offset;
+    uint64 size;
   };
 
   struct Stats : public FileInfo {
@@ -43,15 +61,66 @@ class Archive {
   // Read and parse the header.
   bool Init();
 
+  // Map the whole package into memory, afterwards the contents of packed files
+  // can be got with GetMappedContents without doing file IO. When called
+  // before Init the header is also parsed from the mapped memory.
+  bool MapIntoMemory();
+
+  // Initialize from a snapshot written by WriteSnapshot, the header is then
+  // not read or parsed.
+  bool InitFromSnapshot(const char* data, size_t size);
+
+  // Serialize the parsed header into |pickle|, so other processes can create
+  // an Archive of the same package with InitFromSnapshot.
+  void WriteSnapshot(Pickle* pickle) const;
+
+  // Get the mapped contents of a packed file, |info.size| bytes of |data| are
+  // valid for the lifetime of the archive. Always fails for compressed files,
+  // use ReadContents for them.
+  bool GetMappedContents(const FileInfo& info, const uint8** data) const;
+
+  // Read the whole contents of a packed file, decompressing it when needed.
+  // It does blocking IO when the package is not mapped into memory.
+  bool ReadContents(const FileInfo& info, std::string* contents);
+
+  // Whether the header has a hash for the file. Such files are verified the
+  // first time they are read with GetMappedContents or ReadContents, which
+  // fail when the contents do not match.
+  bool HasIntegrityHash(const FileInfo& info) const;
+
+  // Read |size| bytes at |offset| of the package into |data| with a file
+  // handle shared by all callers, returns the number of bytes read or -1 on
+  // error. It does blocking IO but is safe to call from any thread.
+  int ReadAt(uint64 offset, char* data, int size);
+
   // Get the info of a file.
   bool GetFileInfo(const base::FilePath& path, FileInfo* info);
 
+  // Computes the hex SHA-256 of the header, which changes with any file in
+  // the package. It reads the whole header, so callers should keep the result.
+  bool GetHeaderHash(std::string* hash);
+
+  // Remember the ranges of packed files looked up by GetFileInfo from now on,
+  // in the order they are first looked up. Must be called before the archive
+  // is used by other threads.
+  void StartRecordingAccess();
+  std::vector<Range> GetAccessedRanges();
+
+  // Ask the OS to read |ranges| of the package into the page cache ahead of
+  // use, it returns without waiting for the reads.
+  void Prefetch(const std::vector<Range>& ranges);
+
   // Fs.stat(path).
   bool Stat(const base::FilePath& path, Stats* stats);
 
   // Fs.readdir(path).
   bool Readdir(const base::FilePath& path, std::vector<base::FilePath>* files);
 
+  // Returns the sorted names of files under directory, which are kept in the
+  // index and never change, or NULL when |path| is not a directory.
+  const std::vector<std::string>* GetDirectoryChildren(
+      const base::FilePath& path) const;
+
   // Fs.realpath(path).
   bool Realpath(const base::FilePath& path, base::FilePath* realpath);
 
@@ -59,17 +128,115 @@ class Archive {
   // For unpacked file, this method will return its real path.
   bool CopyFileOut(const base::FilePath& path, base::FilePath* out);
 
+  // Like CopyFileOut, but for the native modules to be passed to dlopen. On
+  // Linux the file is copied into an anonymous memory file instead, and the
+  // returned path points to it under /proc/self/fd, so nothing is written to
+  // disk.
+  bool CopyFileOutForDlopen(const base::FilePath& path, base::FilePath* out);
+
+  // Delete the temporary files made by CopyFileOut, they are copied out again
+  // when asked next time.
+  void ClearExternalFiles();
+
+  // Forgets the temporary files made by CopyFileOut without deleting them,
+  // and appends their paths to |paths|.
+  void ReleaseExternalFiles(std::vector<base::FilePath>* paths);
+
   base::FilePath path() const { return path_; }
-  base::DictionaryValue* header() const { return header_.get(); }
+  bool is_mapped() const { return mapped_file_.get() != NULL; }
 
  private:
+  // A flattened node of the header, symbol links are resolved when the index
+  // is built so a lookup never needs to walk the tree.
+  struct Entry {
+    Entry() : is_directory(false), is_link(false), link(NULL) {}
+    bool is_directory;
+    bool is_link;
+    FileInfo info;
+    // The final target of a symbol link, NULL when the link is broken.
+    const Entry* link;
+    // The path of link target relative to archive root.
+    std::string link_path;
+    // The names of files under directory, both header formats store them
+    // sorted.
+    std::vector<std::string> children;
+  };
+  typedef base::hash_map<std::string, Entry> EntryMap;
+
+  // Builds |index_| from the JSON header.
+  bool ParseJSONHeader(const std::string& header);
+
+  // Builds |index_| from the binary header, see BinaryHeaderEntry in
+  // archive.cc for the format.
+  bool ParseBinaryHeader(PickleIterator* iter);
+
+  // Walks the JSON header and fills |index_| with every node under |dir|.
+  void BuildIndex(const std::string& prefix,
+                  const base::DictionaryValue* dir,
+                  Entry* dir_entry);
+
+  // Copy the file into the persistent cache under |cache_dir|, reusing the
+  // file extracted by earlier runs.
+  bool CopyFileOutToCache(const base::FilePath& path,
+                          const FileInfo& info,
+                          const base::FilePath& cache_dir,
+                          base::FilePath* out);
+
+#if defined(OS_LINUX)
+  // Copy the file into a memfd, returns false when memfd is not supported.
+  bool CopyFileOutToMemory(const base::FilePath& path, base::FilePath* out);
+#endif
+
+  // Fill |temp_file| with the contents of file.
+  bool FillTemporaryFile(const FileInfo& info, ScopedTemporaryFile* temp_file);
+
+  // Points every symbol link in |index_| to its final target.
+  void ResolveLinks();
+
+  // Opens |file_| if it has not been opened.
+  bool OpenFile();
+
+  // Checks the bytes stored in package for the file against its hash, the
+  // result is remembered so each file is only hashed once.
+  bool VerifyIntegrity(const FileInfo& info, const char* data) const;
+
+  // Finds the entry of |path|, which may go through linked directories.
+  const Entry* FindEntry(const base::FilePath& path) const;
+  const Entry* FindEntryByKey(std::string key) const;
+
   base::FilePath path_;
   uint32 header_size_;
-  scoped_ptr<base::DictionaryValue> header_;
+  scoped_ptr<base::MemoryMappedFile> mapped_file_;
+
+  // The file used by ReadAt, opened on first use.
+  base::Lock file_lock_;
+  base::File file_;
+
+  // Ranges looked up while recording access.
+  base::Lock access_lock_;
+  bool record_access_;
+  std::vector<Range> accessed_ranges_;
+  base::hash_set<uint64> accessed_offsets_;
+
+  // Maps the full relative path of each node to its entry.
+  EntryMap index_;
+  bool has_links_;
+
+  // The SHA-256 hashes of files keyed by their offsets, and the offsets of
+  // files that have been verified.
+  base::hash_map<uint64, std::string> integrity_hashes_;
+  mutable base::Lock verified_lock_;
+  mutable base::hash_set<uint64> verified_offsets_;
 
   // Cached external temporary files.
+  base::Lock external_files_lock_;
   base::ScopedPtrHashMap<base::FilePath, ScopedTemporaryFile> external_files_;
 
+#if defined(OS_LINUX)
+  // Cached memory files, they are kept open as long as the archive is alive.
+  base::ScopedPtrHashMap<base::FilePath, base::ScopedFD> memory_files_;
+#endif
+
   DISALLOW_COPY_AND_ASSIGN(Archive);
 };
 
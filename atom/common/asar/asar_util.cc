@@ -6,34 +6,237 @@
 
 #include <map>
 #include <string>
+#include <vector>
 
 #include "atom/common/asar/archive.h"
+#include "atom/common/options_switches.h"
+#include "base/command_line.h"
 #include "base/files/file_path.h"
 #include "base/files/file_util.h"
+#include "base/format_macros.h"
 #include "base/lazy_instance.h"
-#include "base/stl_util.h"
+#include "base/strings/string_number_conversions.h"
+#include "base/strings/string_split.h"
+#include "base/strings/stringprintf.h"
+#include "base/synchronization/lock.h"
 
 namespace asar {
 
 namespace {
 
-// The global instance of ArchiveMap, will be destroyed on exit.
+// The opened archives, guarded by |lock|. Archives are created outside of the
+// lock so lookups never wait for the IO of opening another archive.
 typedef std::map<base::FilePath, std::shared_ptr<Archive>> ArchiveMap;
-static base::LazyInstance<ArchiveMap> g_archive_map = LAZY_INSTANCE_INITIALIZER;
+struct ArchiveRegistry {
+  base::Lock lock;
+  ArchiveMap archives;
+};
+static base::LazyInstance<ArchiveRegistry> g_archive_registry =
+    LAZY_INSTANCE_INITIALIZER;
 
 const base::FilePath::CharType kAsarExtension[] = FILE_PATH_LITERAL(".asar");
 
+// The ranges to prefetch for each archive, parsed from the manifest.
+typedef std::map<base::FilePath, std::vector<Archive::Range>> PrefetchRanges;
+
+// Each line of the manifest is "<offset> <size> <archive path>".
+void LoadPrefetchManifest(const base::FilePath& path,
+                          PrefetchRanges* manifest) {
+  std::string contents;
+  if (!base::ReadFileToString(path, &contents))
+    return;
+
+  std::vector<std::string> lines;
+  base::SplitString(contents, '\n', &lines);
+  for (const std::string& line : lines) {
+    size_t first = line.find(' ');
+    size_t second = first == std::string::npos ? first :
+                                                 line.find(' ', first + 1);
+    if (second == std::string::npos)
+      continue;
+
+    Archive::Range range;
+    if (!base::StringToUint64(line.substr(0, first), &range.offset) ||
+        !base::StringToUint64(line.substr(first + 1, second - first - 1),
+                              &range.size))
+      continue;
+    base::FilePath archive_path =
+        base::FilePath::FromUTF8Unsafe(line.substr(second + 1));
+    (*manifest)[archive_path].push_back(range);
+  }
+}
+
+// Loaded on first use, LazyInstance makes it safe to do on any thread.
+struct PrefetchManifest {
+  PrefetchManifest() {
+    base::CommandLine* command_line = base::CommandLine::ForCurrentProcess();
+    LoadPrefetchManifest(
+        command_line->GetSwitchValuePath(atom::switches::kAsarPrefetchManifest),
+        &ranges);
+  }
+
+  PrefetchRanges ranges;
+};
+static base::LazyInstance<PrefetchManifest> g_prefetch_manifest =
+    LAZY_INSTANCE_INITIALIZER;
+
+// The archives opened while prefetching is paused, guarded by |lock|.
+struct PausedPrefetch {
+  PausedPrefetch() : paused(false) {}
+
+  base::Lock lock;
+  bool paused;
+  std::vector<std::weak_ptr<Archive>> archives;
+};
+static base::LazyInstance<PausedPrefetch> g_paused_prefetch =
+    LAZY_INSTANCE_INITIALIZER;
+
+void PrefetchFromManifest(std::shared_ptr<Archive> archive) {
+  base::CommandLine* command_line = base::CommandLine::ForCurrentProcess();
+  if (!command_line->HasSwitch(atom::switches::kAsarPrefetchManifest))
+    return;
+
+  {
+    PausedPrefetch& paused_prefetch = g_paused_prefetch.Get();
+    base::AutoLock auto_lock(paused_prefetch.lock);
+    if (paused_prefetch.paused) {
+      paused_prefetch.archives.push_back(archive);
+      return;
+    }
+  }
+
+  const PrefetchRanges& manifest = g_prefetch_manifest.Get().ranges;
+  PrefetchRanges::const_iterator it = manifest.find(archive->path());
+  if (it != manifest.end())
+    archive->Prefetch(it->second);
+}
+
+std::shared_ptr<Archive> FindOpenedArchive(const base::FilePath& path) {
+  ArchiveRegistry& registry = g_archive_registry.Get();
+  base::AutoLock auto_lock(registry.lock);
+  ArchiveMap::const_iterator it = registry.archives.find(path);
+  return it == registry.archives.end() ? nullptr : it->second;
+}
+
+// Adds |archive| unless another thread has opened the same archive first, in
+// which case the existing one is returned.
+std::shared_ptr<Archive> AddOpenedArchive(std::shared_ptr<Archive> archive) {
+  ArchiveRegistry& registry = g_archive_registry.Get();
+  base::AutoLock auto_lock(registry.lock);
+  std::shared_ptr<Archive>& slot = registry.archives[archive->path()];
+  if (!slot)
+    slot = archive;
+  return slot;
+}
+
 }  // namespace
 
 std::shared_ptr<Archive> GetOrCreateAsarArchive(const base::FilePath& path) {
-  ArchiveMap& archive_map = *g_archive_map.Pointer();
-  if (!ContainsKey(archive_map, path)) {
-    std::shared_ptr<Archive> archive(new Archive(path));
-    if (!archive->Init())
-      return nullptr;
-    archive_map[path] = archive;
+  std::shared_ptr<Archive> archive = FindOpenedArchive(path);
+  if (archive)
+    return archive;
+
+  archive.reset(new Archive(path));
+  archive->MapIntoMemory();
+  if (!archive->Init())
+    return nullptr;
+  if (base::CommandLine::ForCurrentProcess()->HasSwitch(
+          atom::switches::kRecordAsarPrefetchManifest))
+    archive->StartRecordingAccess();
+
+  std::shared_ptr<Archive> opened = AddOpenedArchive(archive);
+  if (opened == archive)
+    PrefetchFromManifest(archive);
+  return opened;
+}
+
+bool CreateAsarArchiveFromSnapshot(const base::FilePath& path,
+                                   const char* data,
+                                   size_t size) {
+  if (FindOpenedArchive(path))
+    return true;
+
+  std::shared_ptr<Archive> archive(new Archive(path));
+  archive->MapIntoMemory();
+  if (!archive->InitFromSnapshot(data, size))
+    return false;
+  AddOpenedArchive(archive);
+  return true;
+}
+
+std::vector<std::shared_ptr<Archive>> GetOpenedAsarArchives() {
+  ArchiveRegistry& registry = g_archive_registry.Get();
+  base::AutoLock auto_lock(registry.lock);
+  std::vector<std::shared_ptr<Archive>> archives;
+  for (const auto& item : registry.archives)
+    archives.push_back(item.second);
+  return archives;
+}
+
+void SetAsarPrefetchPaused(bool paused) {
+  std::vector<std::weak_ptr<Archive>> archives;
+  {
+    PausedPrefetch& paused_prefetch = g_paused_prefetch.Get();
+    base::AutoLock auto_lock(paused_prefetch.lock);
+    paused_prefetch.paused = paused;
+    if (!paused)
+      archives.swap(paused_prefetch.archives);
+  }
+
+  for (const std::weak_ptr<Archive>& weak_archive : archives) {
+    std::shared_ptr<Archive> archive = weak_archive.lock();
+    if (archive)
+      PrefetchFromManifest(archive);
   }
-  return archive_map[path];
+}
+
+bool WriteAsarPrefetchManifest(const base::FilePath& path) {
+  std::string contents;
+  for (const auto& archive : GetOpenedAsarArchives()) {
+    std::string archive_path = archive->path().AsUTF8Unsafe();
+    for (const Archive::Range& range : archive->GetAccessedRanges())
+      base::StringAppendF(&contents, "%" PRIu64 " %" PRIu64 " %s\n",
+                          range.offset, range.size, archive_path.c_str());
+  }
+  return base::WriteFile(path, contents.data(), contents.size()) ==
+      static_cast<int>(contents.size());
+}
+
+void ClearAsarExternalFiles() {
+#if !defined(OS_WIN)
+  for (const auto& archive : GetOpenedAsarArchives())
+    archive->ClearExternalFiles();
+#endif
+}
+
+bool DeferAsarExternalFilesDeletion(const base::FilePath& list_path) {
+  std::vector<base::FilePath> paths;
+  for (const auto& archive : GetOpenedAsarArchives())
+    archive->ReleaseExternalFiles(&paths);
+  if (paths.empty())
+    return true;
+
+  std::string contents;
+  for (const base::FilePath& path : paths)
+    contents += path.AsUTF8Unsafe() + "\n";
+  if (!base::PathExists(list_path))
+    return base::WriteFile(list_path, contents.data(), contents.size()) ==
+        static_cast<int>(contents.size());
+  return base::AppendToFile(list_path, contents.data(),
+                            static_cast<int>(contents.size()));
+}
+
+void DeletePendingAsarExternalFiles(const base::FilePath& list_path) {
+  std::string contents;
+  if (!base::ReadFileToString(list_path, &contents))
+    return;
+
+  std::vector<std::string> lines;
+  base::SplitString(contents, '\n', &lines);
+  for (const std::string& line : lines)
+    if (!line.empty())
+      base::DeleteFile(base::FilePath::FromUTF8Unsafe(line), false);
+  base::DeleteFile(list_path, false);
 }
 
 bool GetAsarArchivePath(const base::FilePath& full_path,
@@ -78,13 +281,7 @@ bool ReadFileToString(const base::FilePath& path, std::string* contents) {
     return base::ReadFileToString(real_path, contents);
   }
 
-  base::File src(asar_path, base::File::FLAG_OPEN | base::File::FLAG_READ);
-  if (!src.IsValid())
-    return false;
-
-  contents->resize(info.size);
-  return static_cast<int>(info.size) == src.Read(
-      info.offset, const_cast<char*>(contents->data()), contents->size());
+  return archive->ReadContents(info, contents);
 }
 
 }  // namespace asar
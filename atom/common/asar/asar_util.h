@@ -7,6 +7,7 @@
 
 #include <memory>
 #include <string>
+#include <vector>
 
 namespace base {
 class FilePath;
@@ -16,9 +17,40 @@ namespace asar {
 
 class Archive;
 
-// Gets or creates a new Archive from the path.
+// Gets or creates a new Archive from the path. The functions managing opened
+// archives are safe to call from any thread.
 std::shared_ptr<Archive> GetOrCreateAsarArchive(const base::FilePath& path);
 
+// Creates an Archive from the header snapshot written by the browser process
+// and adds it to the opened archives.
+bool CreateAsarArchiveFromSnapshot(const base::FilePath& path,
+                                   const char* data,
+                                   size_t size);
+
+// Returns all archives that have been opened in this process.
+std::vector<std::shared_ptr<Archive>> GetOpenedAsarArchives();
+
+// Writes the ranges accessed in opened archives into the prefetch manifest at
+// |path|, which can then be replayed with the --asar-prefetch-manifest switch.
+bool WriteAsarPrefetchManifest(const base::FilePath& path);
+
+// While paused, the archives opened are not prefetched from the manifest until
+// prefetching is resumed. Safe to call from any thread.
+void SetAsarPrefetchPaused(bool paused);
+
+// Deletes the temporary files copied out of opened archives, which may live in
+// memory when the temporary directory is a tmpfs. Does nothing on Windows,
+// where the files are only deleted after reboot.
+void ClearAsarExternalFiles();
+
+// Gives up the temporary files copied out of opened archives and appends their
+// paths to the list at |list_path|, which DeletePendingAsarExternalFiles later
+// deletes. Used when the process exits without the time to delete them.
+bool DeferAsarExternalFilesDeletion(const base::FilePath& list_path);
+
+// Deletes the files in the list at |list_path| and then the list.
+void DeletePendingAsarExternalFiles(const base::FilePath& list_path);
+
 // Separates the path to Archive out.
 bool GetAsarArchivePath(const base::FilePath& full_path,
                         base::FilePath* asar_path,
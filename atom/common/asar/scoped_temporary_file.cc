@@ -4,13 +4,54 @@
 
 #include "atom/common/asar/scoped_temporary_file.h"
 
+#if defined(OS_LINUX)
+#include <errno.h>
+#include <sys/sendfile.h>
+#endif
+
+#include <algorithm>
 #include <vector>
 
 #include "base/files/file_util.h"
 #include "base/threading/thread_restrictions.h"
 
+#if defined(OS_LINUX)
+#include "base/posix/eintr_wrapper.h"
+#endif
+
 namespace asar {
 
+namespace {
+
+// Max number of bytes copied at once when filling the temporary file.
+const uint64 kCopyChunkSize = 1024 * 1024;
+
+#if defined(OS_LINUX)
+// Copies the file in kernel with sendfile, |supported| is set to false when
+// sendfile can not be used for the two files and nothing has been copied.
+bool CopyWithSendFile(base::File* src, base::File* dest,
+                      uint64 offset, uint64 size, bool* supported) {
+  *supported = true;
+  off_t position = static_cast<off_t>(offset);
+  while (size > 0) {
+    size_t chunk = static_cast<size_t>(std::min<uint64>(size, kCopyChunkSize));
+    ssize_t sent = HANDLE_EINTR(sendfile(dest->GetPlatformFile(),
+                                         src->GetPlatformFile(),
+                                         &position,
+                                         chunk));
+    if (sent <= 0) {
+      *supported = static_cast<uint64>(position) != offset ||
+                   (errno != EINVAL && errno != ENOSYS);
+      return false;
+    }
+    size -= sent;
+  }
+  return true;
+}
+#endif
+
+}  // namespace
+
 ScopedTemporaryFile::ScopedTemporaryFile() {
 }
 
@@ -36,6 +77,29 @@ bool ScopedTemporaryFile::Init() {
   return base::CreateTemporaryFile(&path_);
 }
 
+bool ScopedTemporaryFile::InitInDir(const base::FilePath& dir) {
+  if (!path_.empty())
+    return true;
+
+  base::ThreadRestrictions::ScopedAllowIO allow_io;
+  return base::CreateTemporaryFileInDir(dir, &path_);
+}
+
+bool ScopedTemporaryFile::MoveTo(const base::FilePath& path) {
+  base::ThreadRestrictions::ScopedAllowIO allow_io;
+  if (!base::ReplaceFile(path_, path, NULL))
+    return false;
+
+  path_.clear();
+  return true;
+}
+
+base::FilePath ScopedTemporaryFile::Release() {
+  base::FilePath path = path_;
+  path_.clear();
+  return path;
+}
+
 bool ScopedTemporaryFile::InitFromFile(const base::FilePath& path,
                                        uint64 offset, uint64 size) {
   if (!Init())
@@ -45,17 +109,50 @@ bool ScopedTemporaryFile::InitFromFile(const base::FilePath& path,
   if (!src.IsValid())
     return false;
 
-  std::vector<char> buf(size);
-  int len = src.Read(offset, buf.data(), buf.size());
-  if (len != static_cast<int>(size))
+  base::File dest(path_, base::File::FLAG_OPEN | base::File::FLAG_WRITE);
+  if (!dest.IsValid())
+    return false;
+
+#if defined(OS_LINUX)
+  bool supported;
+  if (CopyWithSendFile(&src, &dest, offset, size, &supported))
+    return true;
+  if (supported)
+    return false;
+#endif
+
+  // Copy in chunks so extracting a huge file does not need a buffer of the
+  // same size.
+  std::vector<char> buf(static_cast<size_t>(std::min<uint64>(size,
+                                                             kCopyChunkSize)));
+  while (size > 0) {
+    int chunk = static_cast<int>(std::min<uint64>(size, buf.size()));
+    if (src.Read(offset, buf.data(), chunk) != chunk ||
+        dest.WriteAtCurrentPos(buf.data(), chunk) != chunk)
+      return false;
+    offset += chunk;
+    size -= chunk;
+  }
+  return true;
+}
+
+bool ScopedTemporaryFile::InitFromData(const uint8* data, uint64 size) {
+  if (!Init())
     return false;
 
   base::File dest(path_, base::File::FLAG_OPEN | base::File::FLAG_WRITE);
   if (!dest.IsValid())
     return false;
 
-  return dest.WriteAtCurrentPos(buf.data(), buf.size()) ==
-      static_cast<int>(size);
+  while (size > 0) {
+    int chunk = static_cast<int>(std::min<uint64>(size, kCopyChunkSize));
+    if (dest.WriteAtCurrentPos(reinterpret_cast<const char*>(data), chunk) !=
+        chunk)
+      return false;
+    data += chunk;
+    size -= chunk;
+  }
+  return true;
 }
 
 }  // namespace asar
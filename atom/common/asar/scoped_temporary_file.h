@@ -21,9 +21,21 @@ class ScopedTemporaryFile {
   // Init an empty temporary file.
   bool Init();
 
+  // Init an empty temporary file under |dir|.
+  bool InitInDir(const base::FilePath& dir);
+
   // Init an temporary file and fill it with content of |path|.
   bool InitFromFile(const base::FilePath& path, uint64 offset, uint64 size);
 
+  // Init an temporary file and fill it with |size| bytes of |data|.
+  bool InitFromData(const uint8* data, uint64 size);
+
+  // Move the file to |path|, it will then no longer be deleted.
+  bool MoveTo(const base::FilePath& path);
+
+  // Gives up the file without deleting it and returns its path.
+  base::FilePath Release();
+
   base::FilePath path() const { return path_; }
 
  private:
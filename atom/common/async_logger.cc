@@ -0,0 +1,280 @@
+// Copyright (c) 2015 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#include "atom/common/async_logger.h"
+
+#include <string.h>
+
+#include "atom/common/ring_buffer.h"
+#include "base/files/file_util.h"
+#include "base/memory/scoped_ptr.h"
+#include "base/process/process_handle.h"
+#include "base/strings/string_number_conversions.h"
+#include "base/strings/stringprintf.h"
+#include "base/threading/thread_restrictions.h"
+#include "base/time/time.h"
+
+namespace atom {
+
+namespace {
+
+// The memory of each thread's buffer, a burst of records larger than this
+// before the writer wakes up is dropped.
+const size_t kThreadBufferSize = 256 * 1024;
+
+// How long the writer sleeps when no producer has rung it, which bounds the
+// delay of the records from threads that have just got their buffers.
+const int kWriterIdleMs = 100;
+
+// The lines are written to the file in chunks of at least this size, unless
+// the buffers have run dry.
+const size_t kWriteChunkSize = 64 * 1024;
+
+const char* kLevelNames[] = { "DEBUG", "INFO", "WARNING", "ERROR" };
+
+// What is written into the ring buffer before the message and fields.
+struct RecordHeader {
+  int64 time;
+  uint32 level;
+  uint32 message_size;
+};
+
+// "<path>.<index>".
+base::FilePath GetRotatedPath(const base::FilePath& path, int index) {
+  return path.AddExtension(
+      base::FilePath::FromUTF8Unsafe(base::IntToString(index)).value());
+}
+
+base::LazyInstance<AsyncLogger>::Leaky g_async_logger =
+    LAZY_INSTANCE_INITIALIZER;
+
+}  // namespace
+
+struct AsyncLogger::ThreadBuffer {
+  ThreadBuffer()
+      : memory(new char[RingBuffer::RequiredMemorySize(kThreadBufferSize)]),
+        ring(memory.get(), RingBuffer::RequiredMemorySize(kThreadBufferSize)),
+        thread_id(base::PlatformThread::CurrentId()) {
+    ring.Initialize();
+  }
+
+  scoped_ptr<char[]> memory;
+  RingBuffer ring;
+  base::PlatformThreadId thread_id;
+};
+
+// static
+AsyncLogger* AsyncLogger::GetInstance() {
+  return g_async_logger.Pointer();
+}
+
+AsyncLogger::AsyncLogger()
+    : open_(0),
+      max_size_(0),
+      max_files_(0),
+      dropped_(0),
+      doorbell_(false, false),
+      flushed_(false, false),
+      flush_requested_(0),
+      file_size_(0) {
+}
+
+AsyncLogger::~AsyncLogger() {
+}
+
+bool AsyncLogger::Open(const base::FilePath& path,
+                       int64 max_size,
+                       int max_files) {
+  base::AutoLock auto_lock(open_lock_);
+  if (is_open())
+    return path == path_;
+
+  // Opening the file is the only IO done on the calling thread.
+  base::ThreadRestrictions::ScopedAllowIO allow_io;
+  file_.Initialize(path,
+                   base::File::FLAG_OPEN_ALWAYS | base::File::FLAG_APPEND);
+  if (!file_.IsValid())
+    return false;
+
+  path_ = path;
+  max_size_ = max_size;
+  max_files_ = max_files;
+  file_size_ = file_.GetLength();
+  if (!base::PlatformThread::Create(0, this, &writer_thread_)) {
+    file_.Close();
+    return false;
+  }
+
+  base::subtle::Release_Store(&open_, 1);
+  return true;
+}
+
+void AsyncLogger::Log(Level level,
+                      const std::string& message,
+                      const std::string& fields) {
+  if (!is_open())
+    return;
+
+  RecordHeader header;
+  header.time = base::Time::Now().ToInternalValue();
+  header.level = level;
+  header.message_size = static_cast<uint32>(message.size());
+
+  std::string record(sizeof(header) + message.size() + fields.size(), '\0');
+  memcpy(&record[0], &header, sizeof(header));
+  record.replace(sizeof(header), message.size(), message);
+  record.replace(sizeof(header) + message.size(), fields.size(), fields);
+
+  bool should_ring = false;
+  if (!GetThreadBuffer()->ring.Write(
+          record.data(), static_cast<uint32>(record.size()), &should_ring)) {
+    base::subtle::NoBarrier_AtomicIncrement(&dropped_, 1);
+    return;
+  }
+  if (should_ring)
+    doorbell_.Signal();
+}
+
+void AsyncLogger::Flush() {
+  if (!is_open())
+    return;
+
+  base::AutoLock auto_lock(flush_lock_);
+  base::subtle::Release_Store(&flush_requested_, 1);
+  doorbell_.Signal();
+  flushed_.Wait();
+}
+
+bool AsyncLogger::is_open() const {
+  return base::subtle::Acquire_Load(&open_) == 1;
+}
+
+AsyncLogger::ThreadBuffer* AsyncLogger::GetThreadBuffer() {
+  ThreadBuffer* buffer = thread_buffer_.Get();
+  if (buffer)
+    return buffer;
+
+  // Only the first record of each thread takes the lock.
+  buffer = new ThreadBuffer;
+  thread_buffer_.Set(buffer);
+  base::AutoLock auto_lock(buffers_lock_);
+  buffers_.push_back(make_linked_ptr(buffer));
+  return buffer;
+}
+
+void AsyncLogger::ThreadMain() {
+  base::PlatformThread::SetName("AtomLogWriter");
+
+  while (true) {
+    if (DrainBuffers())
+      continue;
+
+    // Everything logged before the flush request has been written now.
+    if (base::subtle::Acquire_Load(&flush_requested_) == 1) {
+      base::subtle::NoBarrier_Store(&flush_requested_, 0);
+      file_.Flush();
+      flushed_.Signal();
+    }
+
+    bool empty = true;
+    {
+      base::AutoLock auto_lock(buffers_lock_);
+      for (const auto& buffer : buffers_)
+        if (!buffer->ring.WaitForDoorbell())
+          empty = false;
+    }
+    if (empty)
+      doorbell_.TimedWait(base::TimeDelta::FromMilliseconds(kWriterIdleMs));
+  }
+}
+
+bool AsyncLogger::DrainBuffers() {
+  std::vector<ThreadBuffer*> buffers;
+  {
+    base::AutoLock auto_lock(buffers_lock_);
+    for (const auto& buffer : buffers_)
+      buffers.push_back(buffer.get());
+  }
+
+  std::string pid = base::IntToString(base::GetCurrentProcId());
+  bool drained = false;
+  for (ThreadBuffer* buffer : buffers) {
+    const char* data;
+    uint32 size;
+    while (buffer->ring.Peek(&data, &size)) {
+      drained = true;
+      RecordHeader header;
+      if (size >= sizeof(header)) {
+        memcpy(&header, data, sizeof(header));
+        if (header.message_size > size - sizeof(header))
+          header.message_size = size - sizeof(header);
+
+        base::Time::Exploded time;
+        base::Time::FromInternalValue(header.time).UTCExplode(&time);
+        std::string line = base::StringPrintf(
+            "%04d-%02d-%02dT%02d:%02d:%02d.%03dZ %s [%s:%d] ",
+            time.year, time.month, time.day_of_month, time.hour,
+            time.minute, time.second, time.millisecond,
+            kLevelNames[header.level % arraysize(kLevelNames)],
+            pid.c_str(), static_cast<int>(buffer->thread_id));
+        line.append(data + sizeof(header), header.message_size);
+        size_t fields_size = size - sizeof(header) - header.message_size;
+        if (fields_size > 0) {
+          line += ' ';
+          line.append(data + sizeof(header) + header.message_size,
+                      fields_size);
+        }
+        line += '\n';
+        WriteLine(line);
+      }
+      buffer->ring.Consume();
+    }
+  }
+
+  int dropped = base::subtle::NoBarrier_AtomicExchange(&dropped_, 0);
+  if (dropped > 0)
+    WriteLine(base::StringPrintf(
+        "%d log records were dropped because the writer fell behind\n",
+        dropped));
+
+  // The lines are held until the buffers are empty, so the file is written
+  // in large chunks when logging is heavy.
+  if (!pending_.empty() && (!drained || pending_.size() >= kWriteChunkSize)) {
+    file_.WriteAtCurrentPos(pending_.data(), static_cast<int>(pending_.size()));
+    file_size_ += pending_.size();
+    pending_.clear();
+  }
+  return drained;
+}
+
+void AsyncLogger::WriteLine(const std::string& line) {
+  if (max_size_ > 0 &&
+      file_size_ + static_cast<int64>(pending_.size() + line.size()) >
+          max_size_) {
+    if (!pending_.empty()) {
+      file_.WriteAtCurrentPos(pending_.data(),
+                              static_cast<int>(pending_.size()));
+      pending_.clear();
+    }
+    RotateFiles();
+  }
+  pending_ += line;
+}
+
+void AsyncLogger::RotateFiles() {
+  file_.Close();
+
+  if (max_files_ > 0) {
+    base::DeleteFile(GetRotatedPath(path_, max_files_), false);
+    for (int i = max_files_ - 1; i > 0; --i)
+      base::Move(GetRotatedPath(path_, i), GetRotatedPath(path_, i + 1));
+    base::Move(path_, GetRotatedPath(path_, 1));
+  }
+
+  file_.Initialize(path_, base::File::FLAG_CREATE_ALWAYS |
+                          base::File::FLAG_WRITE);
+  file_size_ = 0;
+}
+
+}  // namespace atom
@@ -0,0 +1,112 @@
+// Copyright (c) 2015 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#ifndef ATOM_COMMON_ASYNC_LOGGER_H_
+#define ATOM_COMMON_ASYNC_LOGGER_H_
+
+#include <string>
+#include <vector>
+
+#include "base/atomicops.h"
+#include "base/files/file.h"
+#include "base/files/file_path.h"
+#include "base/lazy_instance.h"
+#include "base/memory/linked_ptr.h"
+#include "base/synchronization/lock.h"
+#include "base/synchronization/waitable_event.h"
+#include "base/threading/platform_thread.h"
+#include "base/threading/thread_local.h"
+
+namespace atom {
+
+// Writes log records to a file without blocking the threads that log them.
+//
+// Each thread logs into its own RingBuffer, so logging is a copy into memory
+// that only the thread writes to, without taking any lock. A writer thread
+// drains the buffers into the file, and starts a new file when the current
+// one has reached the maximum size. When a buffer is full the record is
+// dropped instead of waiting for the writer, and the number of dropped
+// records is written to the file later.
+class AsyncLogger : public base::PlatformThread::Delegate {
+ public:
+  enum Level {
+    LEVEL_DEBUG,
+    LEVEL_INFO,
+    LEVEL_WARNING,
+    LEVEL_ERROR,
+  };
+
+  static AsyncLogger* GetInstance();
+
+  // Starts writing to |path|. When the file grows over |max_size| bytes it is
+  // renamed to "<path>.1", and the older ones to "<path>.2" and so on, until
+  // |max_files| of them are kept. The logger can only be opened once, later
+  // calls with the same |path| succeed without doing anything, and return
+  // false for other paths. Also returns false if the file can not be opened.
+  bool Open(const base::FilePath& path, int64 max_size, int max_files);
+
+  // Queues a record, |fields| is a JSON object appended to the line when not
+  // empty. Records logged before Open are discarded. Safe to call from any
+  // thread.
+  void Log(Level level, const std::string& message, const std::string& fields);
+
+  // Waits until the records logged so far have been written to the file.
+  void Flush();
+
+  bool is_open() const;
+
+ private:
+  friend struct base::DefaultLazyInstanceTraits<AsyncLogger>;
+
+  struct ThreadBuffer;
+
+  AsyncLogger();
+  ~AsyncLogger() override;
+
+  ThreadBuffer* GetThreadBuffer();
+
+  // base::PlatformThread::Delegate:
+  void ThreadMain() override;
+
+  // Run on writer thread.
+  bool DrainBuffers();
+  void WriteLine(const std::string& line);
+  void RotateFiles();
+
+  base::Lock open_lock_;
+  base::subtle::Atomic32 open_;
+
+  base::FilePath path_;
+  int64 max_size_;
+  int max_files_;
+
+  // The buffers of all threads that have logged, guarded by |buffers_lock_|.
+  // The buffers live as long as the logger, since their threads may still be
+  // writing to them.
+  base::Lock buffers_lock_;
+  std::vector<linked_ptr<ThreadBuffer>> buffers_;
+  base::ThreadLocalPointer<ThreadBuffer> thread_buffer_;
+
+  // The number of records dropped because their buffer was full.
+  base::subtle::Atomic32 dropped_;
+
+  // Signaled to wake up the writer, and by the writer when a flush is done.
+  base::WaitableEvent doorbell_;
+  base::WaitableEvent flushed_;
+  base::Lock flush_lock_;
+  base::subtle::Atomic32 flush_requested_;
+
+  // Only accessed on writer thread.
+  base::File file_;
+  int64 file_size_;
+  std::string pending_;
+
+  base::PlatformThreadHandle writer_thread_;
+
+  DISALLOW_COPY_AND_ASSIGN(AsyncLogger);
+};
+
+}  // namespace atom
+
+#endif  // ATOM_COMMON_ASYNC_LOGGER_H_
@@ -0,0 +1,170 @@
+// Copyright (c) 2015 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#include "atom/common/code_cache.h"
+
+#include <map>
+#include <string>
+
+#include "base/files/file.h"
+#include "base/files/file_path.h"
+#include "base/files/file_util.h"
+#include "base/files/important_file_writer.h"
+#include "base/hash.h"
+#include "base/lazy_instance.h"
+#include "base/strings/stringprintf.h"
+#include "base/synchronization/lock.h"
+#include "base/threading/thread_restrictions.h"
+#include "base/time/time.h"
+
+namespace atom {
+
+namespace {
+
+// V8 only checks the length of source when consuming a cache, so the content
+// is hashed into the name of cache file.
+base::FilePath GetCachePath(v8::Handle<v8::String> source,
+                            const base::FilePath& cache_dir) {
+  v8::String::Utf8Value utf8(source);
+  std::string content(*utf8, utf8.length());
+  return cache_dir.AppendASCII(base::StringPrintf(
+      "%08x-%x.cache", base::Hash(content),
+      static_cast<unsigned int>(content.size())));
+}
+
+// The contents of a script file and when it was modified.
+struct ScriptFile {
+  base::Time last_modified;
+  std::string source;
+};
+
+// The code caches and script files kept in memory, keyed by their paths. Both
+// are shared by all the contexts of process.
+struct MemoryCache {
+  base::Lock lock;
+  std::map<base::FilePath, std::string> code_caches;
+  std::map<base::FilePath, ScriptFile> script_files;
+};
+
+base::LazyInstance<MemoryCache>::Leaky g_memory_cache =
+    LAZY_INSTANCE_INITIALIZER;
+
+bool GetMemoryCodeCache(const base::FilePath& cache_path, std::string* data) {
+  MemoryCache* cache = g_memory_cache.Pointer();
+  base::AutoLock auto_lock(cache->lock);
+  auto it = cache->code_caches.find(cache_path);
+  if (it == cache->code_caches.end())
+    return false;
+  *data = it->second;
+  return true;
+}
+
+void SetMemoryCodeCache(const base::FilePath& cache_path,
+                        const std::string& data) {
+  MemoryCache* cache = g_memory_cache.Pointer();
+  base::AutoLock auto_lock(cache->lock);
+  if (data.empty())
+    cache->code_caches.erase(cache_path);
+  else
+    cache->code_caches[cache_path] = data;
+}
+
+}  // namespace
+
+v8::Local<v8::Value> RunScriptWithCodeCache(v8::Isolate* isolate,
+                                            v8::Handle<v8::String> source,
+                                            v8::Handle<v8::String> filename,
+                                            const base::FilePath& cache_dir,
+                                            bool read_only) {
+  return RunScriptWithCodeCacheFile(isolate, source, filename,
+                                    GetCachePath(source, cache_dir),
+                                    read_only);
+}
+
+v8::Local<v8::Value> RunScriptWithCodeCacheFile(
+    v8::Isolate* isolate,
+    v8::Handle<v8::String> source,
+    v8::Handle<v8::String> filename,
+    const base::FilePath& cache_path,
+    bool read_only) {
+  base::ThreadRestrictions::ScopedAllowIO allow_io;
+  // Without a directory the cache only lives in memory.
+  bool on_disk =
+      cache_path.DirName().value() != base::FilePath::kCurrentDirectory;
+  std::string data;
+  bool in_memory = GetMemoryCodeCache(cache_path, &data);
+  if (!in_memory && on_disk && base::ReadFileToString(cache_path, &data))
+    SetMemoryCodeCache(cache_path, data);
+
+  v8::ScriptCompiler::CachedData* cached_data = nullptr;
+  if (!data.empty())
+    cached_data = new v8::ScriptCompiler::CachedData(
+        reinterpret_cast<const uint8_t*>(data.data()),
+        static_cast<int>(data.size()));
+
+  // The |script_source| takes the ownership of |cached_data|.
+  v8::ScriptCompiler::Source script_source(
+      source, v8::ScriptOrigin(filename), cached_data);
+  v8::ScriptCompiler::CompileOptions options =
+      v8::ScriptCompiler::kNoCompileOptions;
+  if (cached_data)
+    options = v8::ScriptCompiler::kConsumeCodeCache;
+  else if (!read_only)
+    options = v8::ScriptCompiler::kProduceCodeCache;
+  v8::Local<v8::Script> script = v8::ScriptCompiler::Compile(
+      isolate, &script_source, options);
+  if (script.IsEmpty())
+    return v8::Local<v8::Value>();
+
+  if (cached_data) {
+    // The cache was written by another version of V8, it will be produced
+    // again next time.
+    if (cached_data->rejected) {
+      SetMemoryCodeCache(cache_path, std::string());
+      if (on_disk && !read_only)
+        base::DeleteFile(cache_path, false);
+    }
+  } else if (!read_only) {
+    const v8::ScriptCompiler::CachedData* produced =
+        script_source.GetCachedData();
+    if (produced) {
+      std::string contents(reinterpret_cast<const char*>(produced->data),
+                           produced->length);
+      SetMemoryCodeCache(cache_path, contents);
+      if (on_disk && base::CreateDirectory(cache_path.DirName()))
+        base::ImportantFileWriter::WriteFileAtomically(cache_path, contents);
+    }
+  }
+
+  return script->Run();
+}
+
+bool ReadScriptFile(const base::FilePath& path, std::string* source) {
+  base::ThreadRestrictions::ScopedAllowIO allow_io;
+  base::File::Info info;
+  if (!base::GetFileInfo(path, &info) || info.is_directory)
+    return false;
+
+  MemoryCache* cache = g_memory_cache.Pointer();
+  {
+    base::AutoLock auto_lock(cache->lock);
+    auto it = cache->script_files.find(path);
+    if (it != cache->script_files.end() &&
+        it->second.last_modified == info.last_modified) {
+      *source = it->second.source;
+      return true;
+    }
+  }
+
+  if (!base::ReadFileToString(path, source))
+    return false;
+
+  base::AutoLock auto_lock(cache->lock);
+  ScriptFile& file = cache->script_files[path];
+  file.last_modified = info.last_modified;
+  file.source = *source;
+  return true;
+}
+
+}  // namespace atom
@@ -0,0 +1,49 @@
+// Copyright (c) 2015 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#ifndef ATOM_COMMON_CODE_CACHE_H_
+#define ATOM_COMMON_CODE_CACHE_H_
+
+#include <string>
+
+#include "v8/include/v8.h"
+
+namespace base {
+class FilePath;
+}
+
+namespace atom {
+
+// Compiles and runs |source| in current context, consuming the V8 code cache
+// of the same source from |cache_dir|, or writing one there if there is none.
+// The cache files are keyed by the hash of source, so |cache_dir| can be
+// shared by different scripts and processes. When |read_only| is true the
+// caches are only consumed, which is used for the ones shipped with the app
+// that are produced at build time. The caches are also kept in memory, so
+// later runs of the same source in this process do not read them again, and
+// an empty |cache_dir| keeps them only in memory. Returns an empty handle when
+// the script throws.
+v8::Local<v8::Value> RunScriptWithCodeCache(v8::Isolate* isolate,
+                                            v8::Handle<v8::String> source,
+                                            v8::Handle<v8::String> filename,
+                                            const base::FilePath& cache_dir,
+                                            bool read_only);
+
+// Same with above but uses |cache_path| as the cache file, callers should make
+// sure the file is only used for the same source.
+v8::Local<v8::Value> RunScriptWithCodeCacheFile(
+    v8::Isolate* isolate,
+    v8::Handle<v8::String> source,
+    v8::Handle<v8::String> filename,
+    const base::FilePath& cache_path,
+    bool read_only);
+
+// Reads the script file |path| into |source|. The contents are kept in memory
+// for the process and only read again after the file is modified, which is
+// used for the scripts loaded by every page like the preload script.
+bool ReadScriptFile(const base::FilePath& path, std::string* source);
+
+}  // namespace atom
+
+#endif  // ATOM_COMMON_CODE_CACHE_H_
@@ -0,0 +1,107 @@
+// Copyright (c) 2015 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#include "atom/common/crash_reporter/breadcrumbs.h"
+
+#include "base/atomicops.h"
+
+namespace crash_reporter {
+
+namespace {
+
+struct Slot {
+  // The sequence number of the breadcrumb in |text|, 0 while it is written.
+  base::subtle::Atomic32 sequence;
+  char text[Breadcrumbs::kMaxLength];
+};
+
+// Plain zero initialized globals, so nothing has to be constructed before the
+// first breadcrumb or destroyed before the last crash.
+Slot g_slots[Breadcrumbs::kMaxCount];
+base::subtle::Atomic32 g_last_sequence = 0;
+
+// Claims the slot of a new breadcrumb and returns its sequence number.
+base::subtle::Atomic32 BeginSlot(Slot** slot) {
+  base::subtle::Atomic32 sequence =
+      base::subtle::NoBarrier_AtomicIncrement(&g_last_sequence, 1);
+  *slot = &g_slots[static_cast<uint32>(sequence - 1) % Breadcrumbs::kMaxCount];
+  base::subtle::NoBarrier_Store(&(*slot)->sequence, 0);
+  return sequence;
+}
+
+void EndSlot(Slot* slot, size_t length, base::subtle::Atomic32 sequence) {
+  slot->text[length] = '\0';
+  base::subtle::Release_Store(&slot->sequence, sequence);
+}
+
+size_t AppendCategory(Slot* slot, const char* category) {
+  size_t length = 0;
+  for (; *category && length < Breadcrumbs::kMaxLength - 2; ++category)
+    slot->text[length++] = *category;
+  slot->text[length++] = ' ';
+  return length;
+}
+
+}  // namespace
+
+const size_t Breadcrumbs::kMaxCount;
+const size_t Breadcrumbs::kMaxLength;
+
+// static
+void Breadcrumbs::Add(const char* category, const char* detail) {
+  Slot* slot;
+  base::subtle::Atomic32 sequence = BeginSlot(&slot);
+  size_t length = AppendCategory(slot, category);
+  for (; *detail && length < kMaxLength - 1; ++detail)
+    slot->text[length++] = *detail;
+  EndSlot(slot, length, sequence);
+}
+
+// static
+void Breadcrumbs::Add(const char* category, const base::string16& detail) {
+  Slot* slot;
+  base::subtle::Atomic32 sequence = BeginSlot(&slot);
+  size_t length = AppendCategory(slot, category);
+  for (size_t i = 0; i < detail.size() && length < kMaxLength - 1; ++i) {
+    base::char16 c = detail[i];
+    slot->text[length++] = c < 0x80 ? static_cast<char>(c) : '?';
+  }
+  EndSlot(slot, length, sequence);
+}
+
+// static
+bool Breadcrumbs::Get(size_t index, char* buffer, size_t size) {
+  uint32 last = static_cast<uint32>(
+      base::subtle::Acquire_Load(&g_last_sequence));
+  if (size == 0 || index >= kMaxCount || index >= last)
+    return false;
+
+  base::subtle::Atomic32 sequence = static_cast<base::subtle::Atomic32>(
+      last - index);
+  const Slot& slot =
+      g_slots[static_cast<uint32>(sequence - 1) % kMaxCount];
+  if (base::subtle::Acquire_Load(&slot.sequence) != sequence)
+    return false;
+
+  size_t i = 0;
+  for (; i < size - 1 && i < kMaxLength - 1 && slot.text[i]; ++i)
+    buffer[i] = slot.text[i];
+  buffer[i] = '\0';
+
+  // A writer may have taken the slot while it was copied.
+  return base::subtle::Acquire_Load(&slot.sequence) == sequence;
+}
+
+// static
+void Breadcrumbs::GetKeyName(size_t index, char* buffer) {
+  static const char kPrefix[] = "breadcrumb-";
+  size_t i = 0;
+  for (; kPrefix[i]; ++i)
+    buffer[i] = kPrefix[i];
+  buffer[i++] = static_cast<char>('0' + index / 10 % 10);
+  buffer[i++] = static_cast<char>('0' + index % 10);
+  buffer[i] = '\0';
+}
+
+}  // namespace crash_reporter
@@ -0,0 +1,49 @@
+// Copyright (c) 2015 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#ifndef ATOM_COMMON_CRASH_REPORTER_BREADCRUMBS_H_
+#define ATOM_COMMON_CRASH_REPORTER_BREADCRUMBS_H_
+
+#include <string>
+
+#include "base/basictypes.h"
+#include "base/strings/string16.h"
+
+namespace crash_reporter {
+
+// A fixed-size ring of the latest events of current process, like the IPC
+// messages, navigations and window operations, which the crash handler sends
+// with the crash report. Adding a breadcrumb neither allocates nor locks, so
+// it is cheap enough for hot paths and safe on any thread.
+class Breadcrumbs {
+ public:
+  // How many breadcrumbs are kept, and the longest text of one of them,
+  // including the terminating null.
+  static const size_t kMaxCount = 32;
+  static const size_t kMaxLength = 64;
+
+  // Records "<category> <detail>", truncated to kMaxLength - 1 bytes.
+  static void Add(const char* category, const char* detail);
+  static void Add(const char* category, const std::string& detail) {
+    Add(category, detail.c_str());
+  }
+  // Non-ASCII characters of |detail| are written as '?'.
+  static void Add(const char* category, const base::string16& detail);
+
+  // Copies the text of the |index|th latest breadcrumb into |buffer|, returns
+  // false when there is no such one or it is being overwritten. Only reads the
+  // memory of the ring, so the crash handlers can call it.
+  static bool Get(size_t index, char* buffer, size_t size);
+
+  // Writes the upload parameter name of the |index|th breadcrumb, like
+  // "breadcrumb-03", into |buffer| of at least 16 bytes.
+  static void GetKeyName(size_t index, char* buffer);
+
+ private:
+  DISALLOW_IMPLICIT_CONSTRUCTORS(Breadcrumbs);
+};
+
+}  // namespace crash_reporter
+
+#endif  // ATOM_COMMON_CRASH_REPORTER_BREADCRUMBS_H_
@@ -10,6 +10,7 @@
 
 #include <string>
 
+#include "atom/common/crash_reporter/breadcrumbs.h"
 #include "base/debug/crash_logging.h"
 #include "base/files/file_path.h"
 #include "base/files/file_util.h"
@@ -113,6 +114,16 @@ bool CrashReporterLinux::CrashDone(const MinidumpDescriptor& minidump,
 
   DCHECK(!minidump.IsFD());
 
+  // The key storage does not allocate, and nothing else uses it any more.
+  for (size_t i = 0; i < Breadcrumbs::kMaxCount; ++i) {
+    char key[16];
+    char value[Breadcrumbs::kMaxLength];
+    if (!Breadcrumbs::Get(i, value, sizeof(value)))
+      continue;
+    Breadcrumbs::GetKeyName(i, key);
+    self->crash_keys_.SetKeyValue(key, value);
+  }
+
   BreakpadInfo info = {0};
   info.filename = minidump.path();
   info.fd = minidump.fd();
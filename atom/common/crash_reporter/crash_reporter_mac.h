@@ -33,6 +33,12 @@ class CrashReporterMac : public CrashReporter {
   CrashReporterMac();
   virtual ~CrashReporterMac();
 
+  // Adds the breadcrumbs to the upload parameters before the dump is written.
+  static bool FilterCallback(int exception_type,
+                             int exception_code,
+                             mach_port_t crashing_thread,
+                             void* context);
+
   BreakpadRef breakpad_;
 
   DISALLOW_COPY_AND_ASSIGN(CrashReporterMac);
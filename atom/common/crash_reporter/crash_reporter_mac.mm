@@ -4,6 +4,7 @@
 
 #include "atom/common/crash_reporter/crash_reporter_mac.h"
 
+#include "atom/common/crash_reporter/breadcrumbs.h"
 #include "base/mac/mac_util.h"
 #include "base/memory/singleton.h"
 #include "base/strings/sys_string_conversions.h"
@@ -75,6 +76,33 @@ void CrashReporterMac::InitBreakpad(const std::string& product_name,
                                base::SysUTF8ToNSString(iter->first),
                                base::SysUTF8ToNSString(iter->second));
   }
+
+  BreakpadSetFilterCallback(breakpad_, FilterCallback, this);
+}
+
+// static
+bool CrashReporterMac::FilterCallback(int exception_type,
+                                      int exception_code,
+                                      mach_port_t crashing_thread,
+                                      void* context) {
+  // This runs on the exception handling thread of Breakpad while the crashed
+  // thread is suspended, the parameters of Breakpad can only be set with
+  // NSStrings.
+  CrashReporterMac* self = static_cast<CrashReporterMac*>(context);
+  @autoreleasepool {
+    for (size_t i = 0; i < Breadcrumbs::kMaxCount; ++i) {
+      char key[16];
+      char value[Breadcrumbs::kMaxLength];
+      if (!Breadcrumbs::Get(i, value, sizeof(value)))
+        continue;
+      Breadcrumbs::GetKeyName(i, key);
+      BreakpadAddUploadParameter(self->breakpad_,
+                                 [NSString stringWithUTF8String:key],
+                                 [NSString stringWithCString:value
+                                       encoding:NSISOLatin1StringEncoding]);
+    }
+  }
+  return true;
 }
 
 void CrashReporterMac::SetUploadParameters() {
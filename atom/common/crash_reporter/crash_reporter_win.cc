@@ -6,6 +6,7 @@
 
 #include <string>
 
+#include "atom/common/crash_reporter/breadcrumbs.h"
 #include "base/files/file_util.h"
 #include "base/logging.h"
 #include "base/memory/singleton.h"
@@ -25,7 +26,8 @@ const wchar_t kPipeNameFormat[] = L"\\\\.\\pipe\\$1 Crash Service";
 
 }  // namespace
 
-CrashReporterWin::CrashReporterWin() {
+CrashReporterWin::CrashReporterWin()
+    : first_breadcrumb_entry_(0) {
 }
 
 CrashReporterWin::~CrashReporterWin() {
@@ -78,6 +80,21 @@ void CrashReporterWin::SetUploadParameters() {
 bool CrashReporterWin::FilterCallback(void* context,
                                       EXCEPTION_POINTERS* exinfo,
                                       MDRawAssertionInfo* assertion) {
+  // The crash service reads the entries from this process after the filter
+  // returns, fill the breadcrumbs into them without allocating.
+  CrashReporterWin* self = static_cast<CrashReporterWin*>(context);
+  for (size_t i = 0; i < Breadcrumbs::kMaxCount; ++i) {
+    char text[Breadcrumbs::kMaxLength];
+    wchar_t value[Breadcrumbs::kMaxLength];
+    if (!Breadcrumbs::Get(i, text, sizeof(text)))
+      text[0] = '\0';
+    size_t j = 0;
+    for (; text[j]; ++j)
+      value[j] = static_cast<unsigned char>(text[j]);
+    value[j] = L'\0';
+    self->custom_info_entries_[self->first_breadcrumb_entry_ + i].set_value(
+        value);
+  }
   return true;
 }
 
@@ -100,7 +117,8 @@ google_breakpad::CustomClientInfo* CrashReporterWin::GetCustomInfo(
     const std::string& version,
     const std::string& company_name) {
   custom_info_entries_.clear();
-  custom_info_entries_.reserve(2 + upload_parameters_.size());
+  custom_info_entries_.reserve(
+      2 + upload_parameters_.size() + Breadcrumbs::kMaxCount);
 
   custom_info_entries_.push_back(google_breakpad::CustomInfoEntry(
       L"prod", L"Atom-Shell"));
@@ -114,6 +132,15 @@ google_breakpad::CustomClientInfo* CrashReporterWin::GetCustomInfo(
         base::UTF8ToWide(iter->second).c_str()));
   }
 
+  // Reserve the entries of breadcrumbs, the crash service skips empty ones.
+  first_breadcrumb_entry_ = custom_info_entries_.size();
+  for (size_t i = 0; i < Breadcrumbs::kMaxCount; ++i) {
+    char key[16];
+    Breadcrumbs::GetKeyName(i, key);
+    custom_info_entries_.push_back(google_breakpad::CustomInfoEntry(
+        base::UTF8ToWide(key).c_str(), L""));
+  }
+
   custom_info_.entries = &custom_info_entries_.front();
   custom_info_.count = custom_info_entries_.size();
   return &custom_info_;
@@ -52,8 +52,10 @@ class CrashReporterWin : public CrashReporter {
       const std::string& version,
       const std::string& company_name);
 
-  // Custom information to be passed to crash handler.
+  // Custom information to be passed to crash handler, the last
+  // Breadcrumbs::kMaxCount entries are filled with breadcrumbs on crash.
   std::vector<google_breakpad::CustomInfoEntry> custom_info_entries_;
+  size_t first_breadcrumb_entry_;
   google_breakpad::CustomClientInfo custom_info_;
 
   bool skip_system_crash_handler_;
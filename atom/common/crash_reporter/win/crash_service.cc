@@ -6,19 +6,24 @@
 
 #include <windows.h>
 
+#include <dbghelp.h>
 #include <sddl.h>
 #include <fstream>  // NOLINT
 #include <map>
 
 #include "base/command_line.h"
 #include "base/files/file_util.h"
+#include "base/format_macros.h"
 #include "base/logging.h"
+#include "base/memory/scoped_ptr.h"
 #include "base/strings/string_number_conversions.h"
-#include "base/time/time.h"
+#include "base/strings/stringprintf.h"
+#include "base/strings/utf_string_conversions.h"
 #include "base/win/windows_version.h"
 #include "vendor/breakpad/src/client/windows/crash_generation/client_info.h"
 #include "vendor/breakpad/src/client/windows/crash_generation/crash_generation_server.h"
 #include "vendor/breakpad/src/client/windows/sender/crash_report_sender.h"
+#include "zlib.h"
 
 namespace breakpad {
 
@@ -29,13 +34,145 @@ const wchar_t kTestPipeName[] = L"\\\\.\\pipe\\ChromeCrashServices";
 const wchar_t kGoogleReportURL[] = L"https://clients2.google.com/cr/report";
 const wchar_t kCheckPointFile[] = L"crash_checkpoint.txt";
 
+// The shortest interval between two uploads, so a crash storm does not
+// saturate the network.
+const DWORD kMinUploadInterval = 30 * 1000;
+
+// A dump is dropped when a dump of the same crash has been queued within this
+// many hours.
+const int kDuplicateWindowHours = 1;
+
 typedef std::map<std::wstring, std::wstring> CrashMap;
 
+// Returns the location of the first stream of |type| in |dump|, or NULL.
+const MINIDUMP_LOCATION_DESCRIPTOR* FindMinidumpStream(const std::string& dump,
+                                                       ULONG32 type) {
+  if (dump.size() < sizeof(MINIDUMP_HEADER))
+    return NULL;
+  const MINIDUMP_HEADER* header =
+      reinterpret_cast<const MINIDUMP_HEADER*>(dump.data());
+  if (header->Signature != MINIDUMP_SIGNATURE)
+    return NULL;
+
+  for (ULONG32 i = 0; i < header->NumberOfStreams; ++i) {
+    size_t offset = header->StreamDirectoryRva + i * sizeof(MINIDUMP_DIRECTORY);
+    if (offset + sizeof(MINIDUMP_DIRECTORY) > dump.size())
+      return NULL;
+    const MINIDUMP_DIRECTORY* directory =
+        reinterpret_cast<const MINIDUMP_DIRECTORY*>(dump.data() + offset);
+    if (directory->StreamType != type)
+      continue;
+    if (static_cast<uint64>(directory->Location.Rva) +
+        directory->Location.DataSize > dump.size())
+      return NULL;
+    return &directory->Location;
+  }
+  return NULL;
+}
+
+std::wstring ReadMinidumpString(const std::string& dump, RVA rva) {
+  if (static_cast<uint64>(rva) + sizeof(ULONG32) > dump.size())
+    return std::wstring();
+  const MINIDUMP_STRING* string =
+      reinterpret_cast<const MINIDUMP_STRING*>(dump.data() + rva);
+  if (static_cast<uint64>(rva) + sizeof(ULONG32) + string->Length >
+      dump.size())
+    return std::wstring();
+  return std::wstring(string->Buffer, string->Length / sizeof(WCHAR));
+}
+
+// The signature of a crash is the process type, the module and offset of the
+// crashing instruction and the exception code, so crashes of the same bug in
+// different processes have the same signature.
+bool GetCrashSignature(const std::wstring& dump_path,
+                       const CrashMap& map,
+                       std::string* signature) {
+  std::string dump;
+  if (!base::ReadFileToString(base::FilePath(dump_path), &dump))
+    return false;
+
+  const MINIDUMP_LOCATION_DESCRIPTOR* location =
+      FindMinidumpStream(dump, ExceptionStream);
+  if (!location || location->DataSize < sizeof(MINIDUMP_EXCEPTION_STREAM))
+    return false;
+  const MINIDUMP_EXCEPTION_STREAM* exception =
+      reinterpret_cast<const MINIDUMP_EXCEPTION_STREAM*>(
+          dump.data() + location->Rva);
+  ULONG64 address = exception->ExceptionRecord.ExceptionAddress;
+
+  // The modules are loaded at random addresses, use the offset in module.
+  std::wstring module = L"?";
+  ULONG64 offset = address;
+  location = FindMinidumpStream(dump, ModuleListStream);
+  if (location && location->DataSize >= sizeof(ULONG32)) {
+    const MINIDUMP_MODULE_LIST* modules =
+        reinterpret_cast<const MINIDUMP_MODULE_LIST*>(
+            dump.data() + location->Rva);
+    for (ULONG32 i = 0; i < modules->NumberOfModules; ++i) {
+      if (sizeof(ULONG32) + (i + 1) * sizeof(MINIDUMP_MODULE) >
+          location->DataSize)
+        break;
+      const MINIDUMP_MODULE& m = modules->Modules[i];
+      if (address >= m.BaseOfImage && address < m.BaseOfImage + m.SizeOfImage) {
+        module = base::FilePath(
+            ReadMinidumpString(dump, m.ModuleNameRva)).BaseName().value();
+        offset = address - m.BaseOfImage;
+        break;
+      }
+    }
+  }
+
+  std::wstring process_type;
+  CrashMap::const_iterator it = map.find(L"process_type");
+  if (it != map.end())
+    process_type = it->second;
+
+  *signature = base::StringPrintf(
+      "%s|%s+0x%" PRIx64 "|0x%08x",
+      base::WideToUTF8(process_type).c_str(),
+      base::WideToUTF8(module).c_str(),
+      offset,
+      static_cast<unsigned int>(exception->ExceptionRecord.ExceptionCode));
+  return true;
+}
+
+// Writes the gzip compressed |from| into |to|.
+bool GzipFile(const base::FilePath& from, const base::FilePath& to) {
+  std::string contents;
+  if (!base::ReadFileToString(from, &contents))
+    return false;
+
+  z_stream stream = {0};
+  // Adding 16 to window bits writes the gzip header and trailer.
+  if (deflateInit2(&stream, Z_DEFAULT_COMPRESSION, Z_DEFLATED, MAX_WBITS + 16,
+                   8, Z_DEFAULT_STRATEGY) != Z_OK)
+    return false;
+
+  std::string compressed;
+  compressed.resize(deflateBound(&stream, contents.size()));
+  stream.next_in =
+      reinterpret_cast<Bytef*>(const_cast<char*>(contents.data()));
+  stream.avail_in = static_cast<uInt>(contents.size());
+  stream.next_out = reinterpret_cast<Bytef*>(&compressed[0]);
+  stream.avail_out = static_cast<uInt>(compressed.size());
+  int result = deflate(&stream, Z_FINISH);
+  compressed.resize(stream.total_out);
+  deflateEnd(&stream);
+  if (result != Z_STREAM_END)
+    return false;
+
+  return base::WriteFile(to, compressed.data(), compressed.size()) ==
+      static_cast<int>(compressed.size());
+}
+
 bool CustomInfoToMap(const google_breakpad::ClientInfo* client_info,
                      const std::wstring& reporter_tag, CrashMap* map) {
   google_breakpad::CustomClientInfo info = client_info->GetCustomInfo();
 
   for (uintptr_t i = 0; i < info.count; ++i) {
+    // Like the unused breadcrumb entries.
+    if (info.entries[i].value[0] == L'\0')
+      continue;
     (*map)[info.entries[i].name] = info.entries[i].value;
   }
 
@@ -154,21 +291,32 @@ class ProcessingLock {
 
 volatile LONG ProcessingLock::op_count_ = 0;
 
+}  // namespace
+
 // This structure contains the information that the worker thread needs to
 // send a crash dump to the server.
-struct DumpJobInfo {
+struct CrashService::DumpJob {
   DWORD pid;
-  CrashService* self;
   CrashMap map;
   std::wstring dump_path;
+  // Empty when the dump could not be parsed.
+  std::string signature;
 
-  DumpJobInfo(DWORD process_id, CrashService* service,
-              const CrashMap& crash_map, const std::wstring& path)
-      : pid(process_id), self(service), map(crash_map), dump_path(path) {
+  DumpJob(DWORD process_id, const CrashMap& crash_map,
+          const std::wstring& path)
+      : pid(process_id), map(crash_map), dump_path(path) {
   }
 };
 
-}  // namespace
+// A dump written by breakpad that is waiting to be processed, it keeps the
+// service alive until then.
+struct CrashService::PendingDump {
+  CrashService* service;
+  DWORD pid;
+  CrashMap map;
+  std::wstring dump_path;
+  ProcessingLock lock;
+};
 
 // Command line switches:
 const char CrashService::kMaxReports[]        = "max-reports";
@@ -177,10 +325,13 @@ const char CrashService::kReporterTag[]       = "reporter";
 const char CrashService::kDumpsDir[]          = "dumps-dir";
 const char CrashService::kPipeName[]          = "pipe-name";
 const char CrashService::kReporterURL[]       = "reporter-url";
+const char CrashService::kCompressDumps[]     = "compress-dumps";
 
 CrashService::CrashService()
     : sender_(NULL),
       dumper_(NULL),
+      compress_dumps_(false),
+      uploader_running_(false),
       requests_handled_(0),
       requests_sent_(0),
       clients_connected_(0),
@@ -191,6 +342,11 @@ CrashService::~CrashService() {
   base::AutoLock lock(sending_);
   delete dumper_;
   delete sender_;
+
+  // The dumps not sent yet are left on disk.
+  base::AutoLock queue_lock(queue_lock_);
+  for (DumpJob* job : queue_)
+    delete job;
 }
 
 bool CrashService::Initialize(const base::FilePath& operating_dir,
@@ -275,6 +431,8 @@ bool CrashService::Initialize(const base::FilePath& operating_dir,
   if (cmd_line.HasSwitch(kReporterURL))
     reporter_url_ = cmd_line.GetSwitchValueNative(kReporterURL);
 
+  compress_dumps_ = cmd_line.HasSwitch(kCompressDumps);
+
   // Log basic information.
   VLOG(1) << "pipe name is " << pipe_name
           << "\ndumps at " << dumps_path_to_use.value();
@@ -365,11 +523,27 @@ void CrashService::OnClientDumpRequest(void* context,
     return;
   }
 
-  CrashMap map;
-  CustomInfoToMap(client_info, self->reporter_tag_, &map);
+  // The client waits until this returns, so only copy what is needed from the
+  // client info and leave the file operations to a worker thread.
+  PendingDump* dump = new PendingDump;
+  dump->service = self;
+  dump->pid = client_info->pid();
+  dump->dump_path = *file_path;
+  CustomInfoToMap(client_info, self->reporter_tag_, &dump->map);
+  if (!::QueueUserWorkItem(&CrashService::ProcessDump, dump,
+                           WT_EXECUTELONGFUNCTION)) {
+    LOG(ERROR) << "could not queue dump processing";
+    ProcessDump(dump);
+  }
+}
+
+DWORD CrashService::ProcessDump(void* context) {
+  scoped_ptr<PendingDump> dump(static_cast<PendingDump*>(context));
+  CrashService* self = dump->service;
+  const CrashMap& map = dump->map;
 
   // Move dump file to the directory under client breakpad dump location.
-  base::FilePath dump_location = base::FilePath(*file_path);
+  base::FilePath dump_location = base::FilePath(dump->dump_path);
   CrashMap::const_iterator it = map.find(L"breakpad-dump-location");
   if (it != map.end()) {
     base::FilePath alternate_dump_location = base::FilePath(it->second);
@@ -380,94 +554,181 @@ void CrashService::OnClientDumpRequest(void* context,
     dump_location = alternate_dump_location;
   }
 
-  DWORD pid = client_info->pid();
-  VLOG(1) << "dump for pid = " << pid << " is " << dump_location.value();
+  VLOG(1) << "dump for pid = " << dump->pid << " is "
+          << dump_location.value();
 
   if (!WriteCustomInfoToFile(dump_location.value(), map)) {
     LOG(ERROR) << "could not write custom info file";
   }
 
   if (!self->sender_)
+    return 0;
+
+  DumpJob* job = new DumpJob(dump->pid, map, dump_location.value());
+  if (!GetCrashSignature(job->dump_path, job->map, &job->signature))
+    LOG(WARNING) << "could not get the signature of " << job->dump_path;
+  self->QueueDump(job);
+  return 0;
+}
+
+void CrashService::QueueDump(DumpJob* job) {
+  base::AutoLock lock(queue_lock_);
+
+  if (!job->signature.empty()) {
+    base::Time now = base::Time::Now();
+    base::TimeDelta window = base::TimeDelta::FromHours(kDuplicateWindowHours);
+
+    // Forget the signatures that can no longer be duplicated, so the map does
+    // not grow with every distinct crash over the life of the service.
+    for (std::map<std::string, base::Time>::iterator it = signatures_.begin();
+         it != signatures_.end();) {
+      if (now - it->second >= window)
+        signatures_.erase(it++);
+      else
+        ++it;
+    }
+
+    std::map<std::string, base::Time>::iterator it =
+        signatures_.find(job->signature);
+    if (it != signatures_.end()) {
+      VLOG(1) << "dropped duplicate dump for pid = " << job->pid
+              << ", signature is " << job->signature;
+      ::DeleteFileW(job->dump_path.c_str());
+      delete job;
+      return;
+    }
+    signatures_[job->signature] = now;
+  }
+
+  queue_.push_back(job);
+  if (uploader_running_)
     return;
 
-  // Send the crash dump using a worker thread. This operation has retry
+  // Send the crash dumps using a worker thread. This operation has retry
   // logic in case there is no internet connection at the time.
-  DumpJobInfo* dump_job = new DumpJobInfo(pid, self, map,
-                                          dump_location.value());
-  if (!::QueueUserWorkItem(&CrashService::AsyncSendDump,
-                           dump_job, WT_EXECUTELONGFUNCTION)) {
+  uploader_running_ = ::QueueUserWorkItem(&CrashService::UploadQueuedDumps,
+                                          this, WT_EXECUTELONGFUNCTION) != 0;
+  if (!uploader_running_)
     LOG(ERROR) << "could not queue job";
-  }
 }
 
-// We are going to try sending the report several times. If we can't send,
-// we sleep from one minute to several hours depending on the retry round.
-DWORD CrashService::AsyncSendDump(void* context) {
-  if (!context)
-    return 0;
-
-  DumpJobInfo* info = static_cast<DumpJobInfo*>(context);
-
-  std::wstring report_id = L"<unsent>";
+// We are going to try sending the reports several times. If we can't send,
+// we sleep from 15 minutes to several hours depending on the retry round, and
+// then retry all the dumps queued so far.
+DWORD CrashService::UploadQueuedDumps(void* context) {
+  CrashService* self = static_cast<CrashService*>(context);
 
   const DWORD kOneMinute = 60*1000;
   const DWORD kOneHour = 60*kOneMinute;
 
   const DWORD kSleepSchedule[] = {
-      24*kOneHour,
-      8*kOneHour,
-      4*kOneHour,
-      kOneHour,
       15*kOneMinute,
-      0};
-
-  int retry_round = arraysize(kSleepSchedule) - 1;
+      kOneHour,
+      4*kOneHour,
+      8*kOneHour,
+      24*kOneHour};
 
-  do {
-    ::Sleep(kSleepSchedule[retry_round]);
+  size_t retry_round = 0;
+  while (true) {
+    std::deque<DumpJob*> batch;
     {
-      // Take the server lock while sending. This also prevent early
-      // termination of the service object.
-      base::AutoLock lock(info->self->sending_);
-      VLOG(1) << "trying to send report for pid = " << info->pid;
-      google_breakpad::ReportResult send_result
-          = info->self->sender_->SendCrashReport(info->self->reporter_url_,
-                                                 info->map,
-                                                 info->dump_path,
-                                                 &report_id);
-      switch (send_result) {
-        case google_breakpad::RESULT_FAILED:
-          report_id = L"<network issue>";
-          break;
-        case google_breakpad::RESULT_REJECTED:
-          report_id = L"<rejected>";
-          ++info->self->requests_handled_;
-          retry_round = 0;
-          break;
-        case google_breakpad::RESULT_SUCCEEDED:
-          ++info->self->requests_sent_;
-          ++info->self->requests_handled_;
-          retry_round = 0;
-          WriteReportIDToFile(info->dump_path, report_id);
-          break;
-        case google_breakpad::RESULT_THROTTLED:
-          report_id = L"<throttled>";
-          break;
-        default:
-          report_id = L"<unknown>";
-          break;
+      base::AutoLock lock(self->queue_lock_);
+      if (self->queue_.empty()) {
+        self->uploader_running_ = false;
+        return 0;
       }
+      batch.swap(self->queue_);
     }
 
-    VLOG(1) << "dump for pid =" << info->pid << " crash2 id =" << report_id;
-    --retry_round;
-  } while (retry_round >= 0);
+    // Stop at the first failure, the others would most likely fail too.
+    while (!batch.empty() && self->SendDump(batch.front())) {
+      delete batch.front();
+      batch.pop_front();
+    }
+    if (batch.empty()) {
+      retry_round = 0;
+      continue;
+    }
 
-  if (!::DeleteFileW(info->dump_path.c_str()))
-    LOG(WARNING) << "could not delete " << info->dump_path;
+    if (retry_round == arraysize(kSleepSchedule)) {
+      LOG(ERROR) << "giving up sending " << batch.size() << " dumps";
+      for (DumpJob* job : batch) {
+        ::DeleteFileW(job->dump_path.c_str());
+        delete job;
+      }
+      retry_round = 0;
+      continue;
+    }
 
-  delete info;
-  return 0;
+    // Put the failed ones back before the dumps queued meanwhile.
+    {
+      base::AutoLock lock(self->queue_lock_);
+      self->queue_.insert(self->queue_.begin(), batch.begin(), batch.end());
+    }
+    ::Sleep(kSleepSchedule[retry_round++]);
+  }
+}
+
+bool CrashService::SendDump(DumpJob* job) {
+  // Rate limit the uploads.
+  if (!last_upload_.is_null()) {
+    int64 elapsed = (base::TimeTicks::Now() - last_upload_).InMilliseconds();
+    if (elapsed < kMinUploadInterval)
+      ::Sleep(static_cast<DWORD>(kMinUploadInterval - elapsed));
+  }
+  last_upload_ = base::TimeTicks::Now();
+
+  std::wstring upload_path = job->dump_path;
+  if (compress_dumps_) {
+    base::FilePath compressed =
+        base::FilePath(job->dump_path).AddExtension(L"gz");
+    if (GzipFile(base::FilePath(job->dump_path), compressed))
+      upload_path = compressed.value();
+    else
+      LOG(WARNING) << "could not compress " << job->dump_path;
+  }
+
+  std::wstring report_id = L"<unsent>";
+  bool done = false;
+  {
+    // Take the server lock while sending. This also prevent early
+    // termination of the service object.
+    base::AutoLock lock(sending_);
+    VLOG(1) << "trying to send report for pid = " << job->pid;
+    google_breakpad::ReportResult send_result =
+        sender_->SendCrashReport(reporter_url_, job->map, upload_path,
+                                 &report_id);
+    switch (send_result) {
+      case google_breakpad::RESULT_FAILED:
+        report_id = L"<network issue>";
+        break;
+      case google_breakpad::RESULT_REJECTED:
+        report_id = L"<rejected>";
+        ++requests_handled_;
+        done = true;
+        break;
+      case google_breakpad::RESULT_SUCCEEDED:
+        ++requests_sent_;
+        ++requests_handled_;
+        done = true;
+        WriteReportIDToFile(job->dump_path, report_id);
+        break;
+      case google_breakpad::RESULT_THROTTLED:
+        report_id = L"<throttled>";
+        break;
+      default:
+        report_id = L"<unknown>";
+        break;
+    }
+  }
+
+  VLOG(1) << "dump for pid =" << job->pid << " crash2 id =" << report_id;
+
+  if (upload_path != job->dump_path)
+    ::DeleteFileW(upload_path.c_str());
+  if (done && !::DeleteFileW(job->dump_path.c_str()))
+    LOG(WARNING) << "could not delete " << job->dump_path;
+  return done;
 }
 
 int CrashService::ProcessingLoop() {
@@ -5,11 +5,14 @@
 #ifndef ATOM_COMMON_CRASH_REPORTER_WIN_CRASH_SERVICE_H_
 #define ATOM_COMMON_CRASH_REPORTER_WIN_CRASH_SERVICE_H_
 
+#include <deque>
+#include <map>
 #include <string>
 
 #include "base/basictypes.h"
 #include "base/files/file_path.h"
 #include "base/synchronization/lock.h"
+#include "base/time/time.h"
 
 namespace google_breakpad {
 
@@ -67,6 +70,9 @@ class CrashService {
   // --reporter-url=<string>
   // Override the URL to which crash reports will be sent to.
   static const char kReporterURL[];
+  // --compress-dumps
+  // Compresses the crash dumps with gzip before sending them.
+  static const char kCompressDumps[];
 
   // Returns number of crash dumps handled.
   int requests_handled() const {
@@ -87,6 +93,9 @@ class CrashService {
   int ProcessingLoop();
 
  private:
+  struct DumpJob;
+  struct PendingDump;
+
   static void OnClientConnected(void* context,
                                 const google_breakpad::ClientInfo* client_info);
 
@@ -98,9 +107,24 @@ class CrashService {
   static void OnClientExited(void* context,
                              const google_breakpad::ClientInfo* client_info);
 
-  // This routine sends the crash dump to the server. It takes the sending_
-  // lock when it is performing the send.
-  static DWORD __stdcall AsyncSendDump(void* context);
+  // Moves the dump written by breakpad to where the client wants it, writes
+  // its custom info and queues it for upload. Runs on a worker thread, so the
+  // crashing client is released as soon as breakpad has written the dump, and
+  // the dumps of clients crashing together are processed in parallel.
+  static DWORD __stdcall ProcessDump(void* context);
+
+  // Adds the dump to the upload queue, unless a dump of the same crash has
+  // been queued recently, and starts the uploader thread when needed.
+  void QueueDump(DumpJob* job);
+
+  // This routine runs on a worker thread and sends the queued crash dumps to
+  // the server one by one, at most one every kMinUploadInterval. When the
+  // network is down the remaining dumps are retried together later.
+  static DWORD __stdcall UploadQueuedDumps(void* context);
+
+  // Sends one crash dump, it takes the sending_ lock when it is performing the
+  // send. Returns false when the dump should be sent again later.
+  bool SendDump(DumpJob* job);
 
   // Returns the security descriptor which access to low integrity processes
   // The caller is supposed to free the security descriptor by calling
@@ -116,6 +140,20 @@ class CrashService {
   // receiver URL of crash reports.
   std::wstring reporter_url_;
 
+  bool compress_dumps_;
+
+  // The dumps waiting to be sent, guarded by queue_lock_ together with the
+  // other members below.
+  base::Lock queue_lock_;
+  std::deque<DumpJob*> queue_;
+  bool uploader_running_;
+  // When a dump of each crash signature was last queued, only the ones within
+  // the duplicate window are kept.
+  std::map<std::string, base::Time> signatures_;
+
+  // Only accessed by the uploader thread.
+  base::TimeTicks last_upload_;
+
   // clients serviced statistics:
   int requests_handled_;
   int requests_sent_;
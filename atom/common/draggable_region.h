@@ -14,6 +14,13 @@ struct DraggableRegion {
   gfx::Rect bounds;
 
   DraggableRegion();
+
+  bool operator==(const DraggableRegion& other) const {
+    return draggable == other.draggable && bounds == other.bounds;
+  }
+  bool operator!=(const DraggableRegion& other) const {
+    return !(*this == other);
+  }
 };
 
 }  // namespace atom
@@ -0,0 +1,81 @@
+// Copyright (c) 2015 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#include "atom/common/loop_stats.h"
+
+#include "base/lazy_instance.h"
+
+namespace atom {
+
+namespace {
+
+base::LazyInstance<LoopStats>::Leaky g_loop_stats = LAZY_INSTANCE_INITIALIZER;
+
+}  // namespace
+
+const size_t LoopStats::kLatencyBucketCount;
+const int LoopStats::kLatencyBucketBounds[] = {
+  50, 100, 250, 500, 1000, 2000, 5000, 10000, 25000, 50000, 100000,
+};
+
+// static
+LoopStats* LoopStats::GetInstance() {
+  return g_loop_stats.Pointer();
+}
+
+LoopStats::LoopStats()
+    : observing_(false),
+      uv_runs_(0),
+      uv_iterations_(0),
+      tasks_(0),
+      wakeups_(0),
+      coalesced_timer_wakeups_(0) {
+  for (size_t i = 0; i < kLatencyBucketCount; ++i)
+    latency_buckets_[i] = 0;
+}
+
+LoopStats::~LoopStats() {
+}
+
+void LoopStats::ObserveMessageLoop(base::MessageLoop* message_loop) {
+  if (observing_)
+    return;
+  observing_ = true;
+  message_loop->AddTaskObserver(this);
+}
+
+void LoopStats::RecordUvRun(int iterations, base::TimeDelta duration) {
+  ++uv_runs_;
+  uv_iterations_ += iterations;
+  uv_time_ += duration;
+}
+
+void LoopStats::RecordWakeupLatency(base::TimeDelta latency) {
+  ++wakeups_;
+  wakeup_latency_total_ += latency;
+  if (latency > wakeup_latency_max_)
+    wakeup_latency_max_ = latency;
+
+  int64 microseconds = latency.InMicroseconds();
+  size_t bucket = 0;
+  while (bucket < kLatencyBucketCount - 1 &&
+         microseconds > kLatencyBucketBounds[bucket])
+    ++bucket;
+  ++latency_buckets_[bucket];
+}
+
+void LoopStats::RecordCoalescedTimerWakeup() {
+  ++coalesced_timer_wakeups_;
+}
+
+void LoopStats::WillProcessTask(const base::PendingTask& pending_task) {
+  task_start_ = base::TimeTicks::Now();
+}
+
+void LoopStats::DidProcessTask(const base::PendingTask& pending_task) {
+  ++tasks_;
+  task_time_ += base::TimeTicks::Now() - task_start_;
+}
+
+}  // namespace atom
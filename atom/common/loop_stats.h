@@ -0,0 +1,82 @@
+// Copyright (c) 2015 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#ifndef ATOM_COMMON_LOOP_STATS_H_
+#define ATOM_COMMON_LOOP_STATS_H_
+
+#include "base/lazy_instance.h"
+#include "base/message_loop/message_loop.h"
+#include "base/time/time.h"
+
+namespace atom {
+
+// Counters of how the main thread splits its time between libuv and
+// Chromium's tasks, collected by NodeBindings. Only used on main thread.
+class LoopStats : public base::MessageLoop::TaskObserver {
+ public:
+  // Upper bounds of the buckets of wakeup latency, in microseconds, the last
+  // bucket holds everything larger.
+  static const size_t kLatencyBucketCount = 12;
+  static const int kLatencyBucketBounds[kLatencyBucketCount - 1];
+
+  static LoopStats* GetInstance();
+
+  // Starts counting the tasks of |message_loop|, can be called many times.
+  void ObserveMessageLoop(base::MessageLoop* message_loop);
+
+  // Records a UvRunOnce that called uv_run |iterations| times.
+  void RecordUvRun(int iterations, base::TimeDelta duration);
+
+  // Records the time between the embed thread seeing events and the main
+  // thread starting to run uv.
+  void RecordWakeupLatency(base::TimeDelta latency);
+
+  // Records a wakeup that was delayed by the timer slack of the embed thread
+  // so the timers expiring meanwhile are handled with it.
+  void RecordCoalescedTimerWakeup();
+
+  int64 uv_runs() const { return uv_runs_; }
+  int64 uv_iterations() const { return uv_iterations_; }
+  base::TimeDelta uv_time() const { return uv_time_; }
+  int64 tasks() const { return tasks_; }
+  base::TimeDelta task_time() const { return task_time_; }
+  int64 wakeups() const { return wakeups_; }
+  base::TimeDelta wakeup_latency_total() const { return wakeup_latency_total_; }
+  base::TimeDelta wakeup_latency_max() const { return wakeup_latency_max_; }
+  int64 latency_bucket(size_t index) const { return latency_buckets_[index]; }
+  int64 coalesced_timer_wakeups() const { return coalesced_timer_wakeups_; }
+
+ private:
+  LoopStats();
+  virtual ~LoopStats();
+
+  // base::MessageLoop::TaskObserver:
+  void WillProcessTask(const base::PendingTask& pending_task) override;
+  void DidProcessTask(const base::PendingTask& pending_task) override;
+
+  friend struct base::DefaultLazyInstanceTraits<LoopStats>;
+
+  bool observing_;
+
+  int64 uv_runs_;
+  int64 uv_iterations_;
+  base::TimeDelta uv_time_;
+
+  int64 tasks_;
+  base::TimeDelta task_time_;
+  base::TimeTicks task_start_;
+
+  int64 wakeups_;
+  base::TimeDelta wakeup_latency_total_;
+  base::TimeDelta wakeup_latency_max_;
+  int64 latency_buckets_[kLatencyBucketCount];
+
+  int64 coalesced_timer_wakeups_;
+
+  DISALLOW_COPY_AND_ASSIGN(LoopStats);
+};
+
+}  // namespace atom
+
+#endif  // ATOM_COMMON_LOOP_STATS_H_
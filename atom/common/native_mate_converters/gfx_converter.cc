@@ -4,7 +4,10 @@
 
 #include "atom/common/native_mate_converters/gfx_converter.h"
 
+#include "base/lazy_instance.h"
+#include "base/threading/thread_local.h"
 #include "native_mate/dictionary.h"
+#include "native_mate/scoped_persistent.h"
 #include "ui/gfx/geometry/point.h"
 #include "ui/gfx/geometry/rect.h"
 #include "ui/gfx/screen.h"
@@ -12,69 +15,158 @@
 
 namespace mate {
 
+namespace {
+
+enum GeometryKey {
+  KEY_X,
+  KEY_Y,
+  KEY_WIDTH,
+  KEY_HEIGHT,
+  KEY_COUNT,
+};
+
+const char* const kGeometryKeyNames[KEY_COUNT] = {
+  "x", "y", "width", "height",
+};
+
+// The internalized property names, and the templates giving the objects of
+// each type the same shape. Each thread keeps them for the first isolate it
+// runs, so the isolates of workers do not race with the main one, and other
+// isolates on the same thread create them on each call.
+struct GeometryCache {
+  GeometryCache() : isolate(nullptr) {}
+
+  v8::Isolate* isolate;
+  ScopedPersistent<v8::String> keys[KEY_COUNT];
+  ScopedPersistent<v8::ObjectTemplate> point_template;
+  ScopedPersistent<v8::ObjectTemplate> size_template;
+  ScopedPersistent<v8::ObjectTemplate> rect_template;
+};
+
+// The caches are leaked with their threads, a worker's isolate is disposed
+// before its thread exits so the handles can not be reset anymore.
+base::LazyInstance<base::ThreadLocalPointer<GeometryCache>>::Leaky
+    g_geometry_cache = LAZY_INSTANCE_INITIALIZER;
+
+GeometryCache* GetCache(v8::Isolate* isolate) {
+  GeometryCache* cache = g_geometry_cache.Get().Get();
+  if (!cache) {
+    cache = new GeometryCache;
+    cache->isolate = isolate;
+    g_geometry_cache.Get().Set(cache);
+  }
+  return cache->isolate == isolate ? cache : nullptr;
+}
+
+v8::Local<v8::String> GetKey(v8::Isolate* isolate, GeometryKey key) {
+  GeometryCache* cache = GetCache(isolate);
+  if (!cache)
+    return v8::String::NewFromUtf8(isolate, kGeometryKeyNames[key],
+                                   v8::String::kInternalizedString);
+  if (cache->keys[key].IsEmpty())
+    cache->keys[key].reset(isolate, v8::String::NewFromUtf8(
+        isolate, kGeometryKeyNames[key], v8::String::kInternalizedString));
+  return cache->keys[key].NewHandle();
+}
+
+// Creates an object with the |keys| set to |values|.
+v8::Local<v8::Object> CreateObject(
+    v8::Isolate* isolate,
+    ScopedPersistent<v8::ObjectTemplate> GeometryCache::* object_template,
+    const GeometryKey* keys,
+    const int* values,
+    size_t count) {
+  GeometryCache* cache = GetCache(isolate);
+  v8::Local<v8::Object> object;
+  if (cache) {
+    ScopedPersistent<v8::ObjectTemplate>& cached = cache->*object_template;
+    if (cached.IsEmpty()) {
+      v8::Local<v8::ObjectTemplate> templ = v8::ObjectTemplate::New(isolate);
+      for (size_t i = 0; i < count; ++i)
+        templ->Set(GetKey(isolate, keys[i]), v8::Integer::New(isolate, 0));
+      cached.reset(isolate, templ);
+    }
+    object = cached.NewHandle()->NewInstance();
+  } else {
+    object = v8::Object::New(isolate);
+  }
+
+  for (size_t i = 0; i < count; ++i)
+    object->Set(GetKey(isolate, keys[i]), v8::Integer::New(isolate, values[i]));
+  return object;
+}
+
+// Reads the |keys| of |val| into |values|, fails when one is not a number.
+bool ReadObject(v8::Isolate* isolate,
+                v8::Handle<v8::Value> val,
+                const GeometryKey* keys,
+                int* values,
+                size_t count) {
+  if (!val->IsObject())
+    return false;
+  v8::Handle<v8::Object> object = val->ToObject();
+  for (size_t i = 0; i < count; ++i) {
+    if (!ConvertFromV8(isolate, object->Get(GetKey(isolate, keys[i])),
+                       &values[i]))
+      return false;
+  }
+  return true;
+}
+
+const GeometryKey kPointKeys[] = { KEY_X, KEY_Y };
+const GeometryKey kSizeKeys[] = { KEY_WIDTH, KEY_HEIGHT };
+const GeometryKey kRectKeys[] = { KEY_X, KEY_Y, KEY_WIDTH, KEY_HEIGHT };
+
+}  // namespace
+
 v8::Handle<v8::Value> Converter<gfx::Point>::ToV8(v8::Isolate* isolate,
                                                   const gfx::Point& val) {
-  mate::Dictionary dict(isolate, v8::Object::New(isolate));
-  dict.Set("x", val.x());
-  dict.Set("y", val.y());
-  return dict.GetHandle();
+  int values[] = { val.x(), val.y() };
+  return CreateObject(isolate, &GeometryCache::point_template, kPointKeys,
+                      values, arraysize(values));
 }
 
 bool Converter<gfx::Point>::FromV8(v8::Isolate* isolate,
                                    v8::Handle<v8::Value> val,
                                    gfx::Point* out) {
-  mate::Dictionary dict;
-  if (!ConvertFromV8(isolate, val, &dict))
-    return false;
-  int x, y;
-  if (!dict.Get("x", &x) || !dict.Get("y", &y))
+  int values[arraysize(kPointKeys)];
+  if (!ReadObject(isolate, val, kPointKeys, values, arraysize(values)))
     return false;
-  *out = gfx::Point(x, y);
+  *out = gfx::Point(values[0], values[1]);
   return true;
 }
 
 v8::Handle<v8::Value> Converter<gfx::Size>::ToV8(v8::Isolate* isolate,
                                                   const gfx::Size& val) {
-  mate::Dictionary dict(isolate, v8::Object::New(isolate));
-  dict.Set("width", val.width());
-  dict.Set("height", val.height());
-  return dict.GetHandle();
+  int values[] = { val.width(), val.height() };
+  return CreateObject(isolate, &GeometryCache::size_template, kSizeKeys,
+                      values, arraysize(values));
 }
 
 bool Converter<gfx::Size>::FromV8(v8::Isolate* isolate,
                                   v8::Handle<v8::Value> val,
                                   gfx::Size* out) {
-  mate::Dictionary dict;
-  if (!ConvertFromV8(isolate, val, &dict))
+  int values[arraysize(kSizeKeys)];
+  if (!ReadObject(isolate, val, kSizeKeys, values, arraysize(values)))
     return false;
-  int width, height;
-  if (!dict.Get("width", &width) || !dict.Get("height", &height))
-    return false;
-  *out = gfx::Size(width, height);
+  *out = gfx::Size(values[0], values[1]);
   return true;
 }
 
 v8::Handle<v8::Value> Converter<gfx::Rect>::ToV8(v8::Isolate* isolate,
                                                  const gfx::Rect& val) {
-  mate::Dictionary dict(isolate, v8::Object::New(isolate));
-  dict.Set("x", val.x());
-  dict.Set("y", val.y());
-  dict.Set("width", val.width());
-  dict.Set("height", val.height());
-  return dict.GetHandle();
+  int values[] = { val.x(), val.y(), val.width(), val.height() };
+  return CreateObject(isolate, &GeometryCache::rect_template, kRectKeys,
+                      values, arraysize(values));
 }
 
 bool Converter<gfx::Rect>::FromV8(v8::Isolate* isolate,
                                   v8::Handle<v8::Value> val,
                                   gfx::Rect* out) {
-  mate::Dictionary dict;
-  if (!ConvertFromV8(isolate, val, &dict))
-    return false;
-  int x, y, width, height;
-  if (!dict.Get("x", &x) || !dict.Get("y", &y) ||
-      !dict.Get("width", &width) || !dict.Get("height", &height))
+  int values[arraysize(kRectKeys)];
+  if (!ReadObject(isolate, val, kRectKeys, values, arraysize(values)))
     return false;
-  *out = gfx::Rect(x, y, width, height);
+  *out = gfx::Rect(values[0], values[1], values[2], values[3]);
   return true;
 }
 
@@ -18,6 +18,29 @@ namespace {
 
 const int kMaxRecursionDepth = 20;
 
+// Converts null, booleans, numbers and strings, which need none of the
+// bookkeeping of objects. Returns NULL for other values.
+base::Value* FromV8Primitive(v8::Handle<v8::Value> val) {
+  if (val->IsNull())
+    return base::Value::CreateNullValue();
+
+  if (val->IsBoolean())
+    return new base::FundamentalValue(val->BooleanValue());
+
+  if (val->IsInt32())
+    return new base::FundamentalValue(val->Int32Value());
+
+  if (val->IsNumber())
+    return new base::FundamentalValue(val->NumberValue());
+
+  if (val->IsString()) {
+    v8::String::Utf8Value utf8(val);
+    return new base::StringValue(std::string(*utf8, utf8.length()));
+  }
+
+  return NULL;
+}
+
 }  // namespace
 
 // The state of a call to FromV8Value.
@@ -66,6 +89,11 @@ class V8ValueConverter::FromV8ValueState {
     return max_recursion_depth_ < 0;
   }
 
+  // Whether a child of current value would be within the recursion limit.
+  bool CanConvertChild() const {
+    return max_recursion_depth_ > 0;
+  }
+
  private:
   typedef std::multimap<int, v8::Handle<v8::Object> > HashToHandleMap;
   HashToHandleMap unique_map_;
@@ -111,6 +139,40 @@ base::Value* V8ValueConverter::FromV8Value(
   return FromV8ValueImpl(&state, val, context->GetIsolate());
 }
 
+bool V8ValueConverter::FromV8Value(v8::Local<v8::Value> val,
+                                   v8::Local<v8::Context> context,
+                                   base::DictionaryValue* out) const {
+  // The same checks of FromV8ValueImpl for the values becoming dictionaries.
+  if (!val->IsObject() || val->IsArray() ||
+      (val->IsDate() && date_allowed_) ||
+      (val->IsRegExp() && reg_exp_allowed_) ||
+      (val->IsFunction() && !function_allowed_))
+    return false;
+
+  v8::Context::Scope context_scope(context);
+  v8::HandleScope handle_scope(context->GetIsolate());
+  FromV8ValueState state;
+  FromV8ValueState::Level state_level(&state);
+  out->Clear();
+  FillDictionary(val->ToObject(), &state, context->GetIsolate(), out);
+  return true;
+}
+
+bool V8ValueConverter::FromV8Value(v8::Local<v8::Value> val,
+                                   v8::Local<v8::Context> context,
+                                   base::ListValue* out) const {
+  if (!val->IsArray())
+    return false;
+
+  v8::Context::Scope context_scope(context);
+  v8::HandleScope handle_scope(context->GetIsolate());
+  FromV8ValueState state;
+  FromV8ValueState::Level state_level(&state);
+  out->Clear();
+  FillList(val.As<v8::Array>(), &state, context->GetIsolate(), out);
+  return true;
+}
+
 v8::Local<v8::Value> V8ValueConverter::ToV8ValueImpl(
      v8::Isolate* isolate, const base::Value* value) const {
   CHECK(value);
@@ -210,22 +272,9 @@ base::Value* V8ValueConverter::FromV8ValueImpl(
   if (state->HasReachedMaxRecursionDepth())
     return NULL;
 
-  if (val->IsNull())
-    return base::Value::CreateNullValue();
-
-  if (val->IsBoolean())
-    return new base::FundamentalValue(val->ToBoolean()->Value());
-
-  if (val->IsInt32())
-    return new base::FundamentalValue(val->ToInt32()->Value());
-
-  if (val->IsNumber())
-    return new base::FundamentalValue(val->ToNumber()->Value());
-
-  if (val->IsString()) {
-    v8::String::Utf8Value utf8(val->ToString());
-    return new base::StringValue(std::string(*utf8, utf8.length()));
-  }
+  base::Value* primitive = FromV8Primitive(val);
+  if (primitive)
+    return primitive;
 
   if (val->IsUndefined())
     // JSON.stringify ignores undefined.
@@ -273,6 +322,15 @@ base::Value* V8ValueConverter::FromV8Array(
   if (!state->UpdateAndCheckUniqueness(val))
     return base::Value::CreateNullValue();
 
+  base::ListValue* result = new base::ListValue();
+  FillList(val, state, isolate, result);
+  return result;
+}
+
+void V8ValueConverter::FillList(v8::Handle<v8::Array> val,
+                                FromV8ValueState* state,
+                                v8::Isolate* isolate,
+                                base::ListValue* result) const {
   scoped_ptr<v8::Context::Scope> scope;
   // If val was created in a different context than our current one, change to
   // that context, but change back after val is converted.
@@ -280,21 +338,27 @@ base::Value* V8ValueConverter::FromV8Array(
       val->CreationContext() != isolate->GetCurrentContext())
     scope.reset(new v8::Context::Scope(val->CreationContext()));
 
-  base::ListValue* result = new base::ListValue();
+  bool can_convert_child = state->CanConvertChild();
 
   // Only fields with integer keys are carried over to the ListValue.
-  for (uint32 i = 0; i < val->Length(); ++i) {
-    v8::TryCatch try_catch;
+  v8::TryCatch try_catch;
+  uint32 length = val->Length();
+  for (uint32 i = 0; i < length; ++i) {
     v8::Local<v8::Value> child_v8 = val->Get(i);
     if (try_catch.HasCaught()) {
       LOG(ERROR) << "Getter for index " << i << " threw an exception.";
+      try_catch.Reset();
       child_v8 = v8::Null(isolate);
     }
 
     if (!val->HasRealIndexedProperty(i))
       continue;
 
-    base::Value* child = FromV8ValueImpl(state, child_v8, isolate);
+    // Arrays of numbers and strings are the common case, convert them without
+    // going through the recursion.
+    base::Value* child = can_convert_child ? FromV8Primitive(child_v8) : NULL;
+    if (!child)
+      child = FromV8ValueImpl(state, child_v8, isolate);
     if (child)
       result->Append(child);
     else
@@ -302,7 +366,6 @@ base::Value* V8ValueConverter::FromV8Array(
       // example undefined and functions. Emulate that behavior.
       result->Append(base::Value::CreateNullValue());
   }
-  return result;
 }
 
 base::Value* V8ValueConverter::FromV8Object(
@@ -312,6 +375,15 @@ base::Value* V8ValueConverter::FromV8Object(
   if (!state->UpdateAndCheckUniqueness(val))
     return base::Value::CreateNullValue();
 
+  base::DictionaryValue* result = new base::DictionaryValue();
+  FillDictionary(val, state, isolate, result);
+  return result;
+}
+
+void V8ValueConverter::FillDictionary(v8::Local<v8::Object> val,
+                                      FromV8ValueState* state,
+                                      v8::Isolate* isolate,
+                                      base::DictionaryValue* result) const {
   scoped_ptr<v8::Context::Scope> scope;
   // If val was created in a different context than our current one, change to
   // that context, but change back after val is converted.
@@ -319,10 +391,12 @@ base::Value* V8ValueConverter::FromV8Object(
       val->CreationContext() != isolate->GetCurrentContext())
     scope.reset(new v8::Context::Scope(val->CreationContext()));
 
-  scoped_ptr<base::DictionaryValue> result(new base::DictionaryValue());
   v8::Local<v8::Array> property_names(val->GetOwnPropertyNames());
+  bool can_convert_child = state->CanConvertChild();
 
-  for (uint32 i = 0; i < property_names->Length(); ++i) {
+  v8::TryCatch try_catch;
+  uint32 length = property_names->Length();
+  for (uint32 i = 0; i < length; ++i) {
     v8::Local<v8::Value> key(property_names->Get(i));
 
     // Extend this test to cover more types as necessary and if sensible.
@@ -334,21 +408,25 @@ base::Value* V8ValueConverter::FromV8Object(
     }
 
     // Skip all callbacks: crbug.com/139933
-    if (val->HasRealNamedCallbackProperty(key->ToString()))
+    v8::Local<v8::String> key_string = key->ToString();
+    if (val->HasRealNamedCallbackProperty(key_string))
       continue;
 
-    v8::String::Utf8Value name_utf8(key->ToString());
+    v8::String::Utf8Value name_utf8(key_string);
 
-    v8::TryCatch try_catch;
     v8::Local<v8::Value> child_v8 = val->Get(key);
 
     if (try_catch.HasCaught()) {
       LOG(ERROR) << "Getter for property " << *name_utf8
                  << " threw an exception.";
+      try_catch.Reset();
       child_v8 = v8::Null(isolate);
     }
 
-    scoped_ptr<base::Value> child(FromV8ValueImpl(state, child_v8, isolate));
+    scoped_ptr<base::Value> child(
+        can_convert_child ? FromV8Primitive(child_v8) : NULL);
+    if (!child)
+      child.reset(FromV8ValueImpl(state, child_v8, isolate));
     if (!child.get())
       // JSON.stringify skips properties whose values don't serialize, for
       // example undefined and functions. Emulate that behavior.
@@ -380,8 +458,6 @@ base::Value* V8ValueConverter::FromV8Object(
     result->SetWithoutPathExpansion(std::string(*name_utf8, name_utf8.length()),
                                     child.release());
   }
-
-  return result.release();
 }
 
 }  // namespace atom
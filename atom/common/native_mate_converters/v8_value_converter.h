@@ -31,6 +31,16 @@ class V8ValueConverter {
   base::Value* FromV8Value(v8::Local<v8::Value> value,
                            v8::Local<v8::Context> context) const;
 
+  // Converts |value| into |out| directly, which saves allocating the result
+  // and copying it. Returns false when |value| would not be converted to a
+  // dictionary or a list.
+  bool FromV8Value(v8::Local<v8::Value> value,
+                   v8::Local<v8::Context> context,
+                   base::DictionaryValue* out) const;
+  bool FromV8Value(v8::Local<v8::Value> value,
+                   v8::Local<v8::Context> context,
+                   base::ListValue* out) const;
+
  private:
   class FromV8ValueState;
 
@@ -53,6 +63,16 @@ class V8ValueConverter {
                             FromV8ValueState* state,
                             v8::Isolate* isolate) const;
 
+  // Fill |out| with the elements of |array| and the properties of |object|.
+  void FillList(v8::Handle<v8::Array> array,
+                FromV8ValueState* state,
+                v8::Isolate* isolate,
+                base::ListValue* out) const;
+  void FillDictionary(v8::Local<v8::Object> object,
+                      FromV8ValueState* state,
+                      v8::Isolate* isolate,
+                      base::DictionaryValue* out) const;
+
   // If true, we will convert Date JavaScript objects to doubles.
   bool date_allowed_;
 
@@ -0,0 +1,488 @@
+// Copyright (c) 2015 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#include "atom/common/native_mate_converters/v8_value_serializer.h"
+
+#include <string.h>
+#if defined(OS_POSIX)
+#include <sys/stat.h>
+#endif
+
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "base/logging.h"
+#include "ipc/ipc_message.h"
+
+#include "atom/common/node_includes.h"
+
+namespace atom {
+
+namespace {
+
+// Same limit with V8ValueConverter.
+const int kMaxRecursionDepth = 20;
+
+// Every value starts with a tag. Arrays are followed by their elements and
+// objects by pairs of TAG_STRING key and value, both end with TAG_END. Binary
+// data is written as a single blob.
+enum Tag {
+  TAG_END = 0,
+  TAG_NULL,
+  TAG_TRUE,
+  TAG_FALSE,
+  TAG_INT32,
+  TAG_DOUBLE,
+  TAG_STRING,
+  TAG_ARRAY,
+  TAG_OBJECT,
+  TAG_BUFFER,
+  TAG_ARRAY_BUFFER,
+};
+
+class Writer {
+ public:
+  Writer(v8::Isolate* isolate, Pickle* pickle)
+      : isolate_(isolate), pickle_(pickle), depth_(0) {}
+
+  // Returns false without writing anything when |value| does not serialize.
+  bool WriteValue(v8::Handle<v8::Value> value) {
+    if (!CanWrite(value))
+      return false;
+
+    ++depth_;
+    if (value->IsNull()) {
+      WriteTag(TAG_NULL);
+    } else if (value->IsBoolean()) {
+      WriteTag(value->BooleanValue() ? TAG_TRUE : TAG_FALSE);
+    } else if (value->IsInt32()) {
+      WriteTag(TAG_INT32);
+      pickle_->WriteInt(value->Int32Value());
+    } else if (value->IsNumber()) {
+      WriteTag(TAG_DOUBLE);
+      double number = value->NumberValue();
+      pickle_->WriteBytes(&number, sizeof(number));
+    } else if (value->IsString()) {
+      WriteTag(TAG_STRING);
+      WriteString(value);
+    } else if (node::Buffer::HasInstance(value)) {
+      WriteTag(TAG_BUFFER);
+      pickle_->WriteData(node::Buffer::Data(value),
+                         static_cast<int>(node::Buffer::Length(value)));
+    } else if (value->IsArrayBuffer()) {
+      WriteTag(TAG_ARRAY_BUFFER);
+      v8::ArrayBuffer::Contents contents =
+          value.As<v8::ArrayBuffer>()->GetContents();
+      pickle_->WriteData(static_cast<const char*>(contents.Data()),
+                         static_cast<int>(contents.ByteLength()));
+    } else if (value->IsArray()) {
+      WriteArray(value.As<v8::Array>());
+    } else {
+      // Dates and RegExps are converted to objects, like V8ValueConverter
+      // does by default.
+      WriteObject(value->ToObject());
+    }
+    --depth_;
+    return true;
+  }
+
+ private:
+  bool CanWrite(v8::Handle<v8::Value> value) const {
+    // JSON.stringify ignores undefined and refuses to convert functions.
+    return depth_ <= kMaxRecursionDepth &&
+           !value->IsUndefined() &&
+           !value->IsFunction();
+  }
+
+  void WriteTag(Tag tag) {
+    pickle_->WriteInt(tag);
+  }
+
+  void WriteString(v8::Handle<v8::Value> value) {
+    v8::String::Utf8Value utf8(value);
+    pickle_->WriteData(*utf8, utf8.length());
+  }
+
+  void WriteArray(v8::Handle<v8::Array> array) {
+    if (!UpdateAndCheckUniqueness(array)) {
+      WriteTag(TAG_NULL);
+      return;
+    }
+
+    scoped_ptr<v8::Context::Scope> scope;
+    // If array was created in a different context than our current one,
+    // change to that context, but change back after array is written.
+    if (!array->CreationContext().IsEmpty() &&
+        array->CreationContext() != isolate_->GetCurrentContext())
+      scope.reset(new v8::Context::Scope(array->CreationContext()));
+
+    WriteTag(TAG_ARRAY);
+    for (uint32 i = 0; i < array->Length(); ++i) {
+      v8::TryCatch try_catch;
+      v8::Local<v8::Value> child = array->Get(i);
+      if (try_catch.HasCaught()) {
+        LOG(ERROR) << "Getter for index " << i << " threw an exception.";
+        child = v8::Null(isolate_);
+      }
+
+      if (!array->HasRealIndexedProperty(i))
+        continue;
+
+      // JSON.stringify puts null in places where values don't serialize.
+      if (!WriteValue(child))
+        WriteTag(TAG_NULL);
+    }
+    WriteTag(TAG_END);
+  }
+
+  void WriteObject(v8::Handle<v8::Object> object) {
+    if (!UpdateAndCheckUniqueness(object)) {
+      WriteTag(TAG_NULL);
+      return;
+    }
+
+    scoped_ptr<v8::Context::Scope> scope;
+    if (!object->CreationContext().IsEmpty() &&
+        object->CreationContext() != isolate_->GetCurrentContext())
+      scope.reset(new v8::Context::Scope(object->CreationContext()));
+
+    WriteTag(TAG_OBJECT);
+    v8::Local<v8::Array> property_names(object->GetOwnPropertyNames());
+    for (uint32 i = 0; i < property_names->Length(); ++i) {
+      v8::Local<v8::Value> key(property_names->Get(i));
+      if (!key->IsString() && !key->IsNumber())
+        continue;
+
+      // Skip all callbacks: crbug.com/139933
+      if (object->HasRealNamedCallbackProperty(key->ToString()))
+        continue;
+
+      v8::TryCatch try_catch;
+      v8::Local<v8::Value> child = object->Get(key);
+      if (try_catch.HasCaught()) {
+        LOG(ERROR) << "Getter for property " << *v8::String::Utf8Value(key)
+                   << " threw an exception.";
+        child = v8::Null(isolate_);
+      }
+
+      // JSON.stringify skips properties whose values don't serialize.
+      if (!CanWrite(child))
+        continue;
+
+      WriteTag(TAG_STRING);
+      WriteString(key);
+      WriteValue(child);
+    }
+    WriteTag(TAG_END);
+  }
+
+  // Returns false if |object| has been written before.
+  bool UpdateAndCheckUniqueness(v8::Handle<v8::Object> object) {
+    typedef HashToHandleMap::const_iterator Iterator;
+    int hash = object->GetIdentityHash();
+    std::pair<Iterator, Iterator> range = unique_map_.equal_range(hash);
+    for (Iterator it = range.first; it != range.second; ++it) {
+      if (it->second == object)
+        return false;
+    }
+    unique_map_.insert(std::make_pair(hash, object));
+    return true;
+  }
+
+  v8::Isolate* isolate_;
+  Pickle* pickle_;
+  int depth_;
+
+  typedef std::multimap<int, v8::Handle<v8::Object>> HashToHandleMap;
+  HashToHandleMap unique_map_;
+
+  DISALLOW_COPY_AND_ASSIGN(Writer);
+};
+
+class Reader {
+ public:
+  Reader(v8::Isolate* isolate, PickleIterator* iter, bool node_buffers)
+      : isolate_(isolate),
+        iter_(iter),
+        node_buffers_(node_buffers),
+        depth_(0) {}
+
+  v8::Local<v8::Value> ReadValue() {
+    int tag;
+    if (!iter_->ReadInt(&tag))
+      return v8::Local<v8::Value>();
+    return ReadValueWithTag(tag);
+  }
+
+ private:
+  v8::Local<v8::Value> ReadValueWithTag(int tag) {
+    switch (tag) {
+      case TAG_NULL:
+        return v8::Null(isolate_);
+      case TAG_TRUE:
+        return v8::True(isolate_);
+      case TAG_FALSE:
+        return v8::False(isolate_);
+      case TAG_INT32: {
+        int value;
+        if (!iter_->ReadInt(&value))
+          return v8::Local<v8::Value>();
+        return v8::Integer::New(isolate_, value);
+      }
+      case TAG_DOUBLE: {
+        const char* data;
+        double value;
+        if (!iter_->ReadBytes(&data, sizeof(value)))
+          return v8::Local<v8::Value>();
+        memcpy(&value, data, sizeof(value));
+        return v8::Number::New(isolate_, value);
+      }
+      case TAG_STRING:
+        return ReadString();
+      case TAG_ARRAY:
+        return ReadArray();
+      case TAG_OBJECT:
+        return ReadObject();
+      case TAG_BUFFER: {
+        const char* data;
+        int length;
+        if (!iter_->ReadData(&data, &length))
+          return v8::Local<v8::Value>();
+        if (node_buffers_)
+          return node::Buffer::New(isolate_, data, length);
+        v8::Local<v8::ArrayBuffer> buffer = v8::ArrayBuffer::New(isolate_,
+                                                                 length);
+        memcpy(buffer->GetContents().Data(), data, length);
+        return v8::Uint8Array::New(buffer, 0, length);
+      }
+      case TAG_ARRAY_BUFFER: {
+        const char* data;
+        int length;
+        if (!iter_->ReadData(&data, &length))
+          return v8::Local<v8::Value>();
+        v8::Local<v8::ArrayBuffer> buffer = v8::ArrayBuffer::New(isolate_,
+                                                                 length);
+        memcpy(buffer->GetContents().Data(), data, length);
+        return buffer;
+      }
+      default:
+        return v8::Local<v8::Value>();
+    }
+  }
+
+  v8::Local<v8::Value> ReadString() {
+    const char* data;
+    int length;
+    if (!iter_->ReadData(&data, &length))
+      return v8::Local<v8::Value>();
+    return v8::String::NewFromUtf8(
+        isolate_, data, v8::String::kNormalString, length);
+  }
+
+  // The data may come from a compromised renderer, so never trust it. Like
+  // the Writer, only containers deeper than kMaxRecursionDepth are refused,
+  // the null written in place of a value that is too deep is still read.
+  bool CanReadContainer() const {
+    return depth_ <= kMaxRecursionDepth;
+  }
+
+  v8::Local<v8::Value> ReadArray() {
+    if (!CanReadContainer())
+      return v8::Local<v8::Value>();
+    ++depth_;
+    v8::Local<v8::Array> array = v8::Array::New(isolate_);
+    for (uint32 index = 0; ; ++index) {
+      int tag;
+      if (!iter_->ReadInt(&tag))
+        return v8::Local<v8::Value>();
+      if (tag == TAG_END)
+        break;
+
+      v8::Local<v8::Value> child = ReadValueWithTag(tag);
+      if (child.IsEmpty())
+        return v8::Local<v8::Value>();
+
+      v8::TryCatch try_catch;
+      array->Set(index, child);
+      if (try_catch.HasCaught())
+        LOG(ERROR) << "Setter for index " << index << " threw an exception.";
+    }
+    --depth_;
+    return array;
+  }
+
+  v8::Local<v8::Value> ReadObject() {
+    if (!CanReadContainer())
+      return v8::Local<v8::Value>();
+    ++depth_;
+    v8::Local<v8::Object> object = v8::Object::New(isolate_);
+    while (true) {
+      int tag;
+      if (!iter_->ReadInt(&tag))
+        return v8::Local<v8::Value>();
+      if (tag == TAG_END)
+        break;
+      if (tag != TAG_STRING)
+        return v8::Local<v8::Value>();
+
+      v8::Local<v8::Value> key = ReadString();
+      if (key.IsEmpty())
+        return v8::Local<v8::Value>();
+      v8::Local<v8::Value> child = ReadValue();
+      if (child.IsEmpty())
+        return v8::Local<v8::Value>();
+
+      v8::TryCatch try_catch;
+      object->Set(key, child);
+      if (try_catch.HasCaught()) {
+        LOG(ERROR) << "Setter for property " << *v8::String::Utf8Value(key)
+                   << " threw an exception.";
+      }
+    }
+    --depth_;
+    return object;
+  }
+
+  v8::Isolate* isolate_;
+  PickleIterator* iter_;
+  bool node_buffers_;
+  int depth_;
+
+  DISALLOW_COPY_AND_ASSIGN(Reader);
+};
+
+v8::Local<v8::Value> Deserialize(v8::Isolate* isolate,
+                                 const SerializedValue& value,
+                                 bool node_buffers) {
+  v8::EscapableHandleScope handle_scope(isolate);
+  PickleIterator iter(value.pickle());
+  Reader reader(isolate, &iter, node_buffers);
+  v8::Local<v8::Value> result = reader.ReadValue();
+  if (result.IsEmpty()) {
+    LOG(ERROR) << "Failed to deserialize V8 value";
+    return v8::Local<v8::Value>();
+  }
+  return handle_scope.Escape(result);
+}
+
+}  // namespace
+
+SerializedValue::SerializedValue() : pickle_(new Pickle) {
+}
+
+SerializedValue::~SerializedValue() {
+}
+
+bool SerializedValue::InitFromData(const char* data, int size) {
+  pickle_.reset(new Pickle(data, size));
+  // Pickle drops the data when its header is malformed.
+  return pickle_->data() != NULL;
+}
+
+void SerializedValue::CopyFrom(const SerializedValue& other) {
+  pickle_.reset(new Pickle(*other.pickle_));
+  shared_memory_.reset();
+}
+
+bool SerializedValue::CopyToSharedMemory(base::SharedMemory* memory) const {
+  if (!memory->CreateAndMapAnonymous(pickle_->size()))
+    return false;
+  memcpy(memory->memory(), pickle_->data(), pickle_->size());
+  return true;
+}
+
+bool SerializedValue::ShareToProcess(base::ProcessHandle process,
+                                     base::SharedMemoryHandle* handle) const {
+  base::SharedMemory memory;
+  return CopyToSharedMemory(&memory) &&
+         memory.ShareToProcess(process, handle);
+}
+
+bool SerializedValue::InitFromSharedMemory(
+    scoped_ptr<base::SharedMemory> memory, uint32 size) {
+  if (!MapSharedMemory(memory.get(), size))
+    return false;
+  shared_memory_ = memory.Pass();
+  return InitFromData(static_cast<const char*>(shared_memory_->memory()),
+                      static_cast<int>(size));
+}
+
+bool SerializedValue::CopyFromSharedMemory(
+    scoped_ptr<base::SharedMemory> memory, uint32 size) {
+  if (!MapSharedMemory(memory.get(), size))
+    return false;
+
+  // Pickle reads its header more than once, so it only parses the private
+  // copy, which then becomes owned by a Pickle of its own.
+  std::vector<char> data(size);
+  memcpy(&data[0], memory->memory(), size);
+  Pickle pickle(&data[0], static_cast<int>(size));
+  if (!pickle.data())
+    return false;
+  pickle_.reset(new Pickle(pickle));
+  shared_memory_.reset();
+  return true;
+}
+
+// static
+bool SerializedValue::MapSharedMemory(base::SharedMemory* memory,
+                                      uint32 size) {
+  if (size < sizeof(Pickle::Header) || size > static_cast<uint32>(kint32max))
+    return false;
+#if defined(OS_POSIX)
+  // Mapping past the end of the file would crash on the first access instead
+  // of failing here. On Windows mapping more than the section fails already.
+  struct stat info;
+  if (fstat(memory->handle().fd, &info) != 0 ||
+      static_cast<uint64>(info.st_size) < size)
+    return false;
+#endif
+  return memory->Map(size);
+}
+
+void SerializeV8Value(v8::Isolate* isolate,
+                      v8::Handle<v8::Value> value,
+                      SerializedValue* out) {
+  v8::HandleScope handle_scope(isolate);
+  Writer writer(isolate, out->pickle());
+  if (!writer.WriteValue(value))
+    out->pickle()->WriteInt(TAG_NULL);
+}
+
+v8::Local<v8::Value> DeserializeV8Value(v8::Isolate* isolate,
+                                        const SerializedValue& value) {
+  return Deserialize(isolate, value, true);
+}
+
+v8::Local<v8::Value> DeserializeV8ValueWithoutNode(
+    v8::Isolate* isolate, const SerializedValue& value) {
+  return Deserialize(isolate, value, false);
+}
+
+}  // namespace atom
+
+namespace IPC {
+
+void ParamTraits<atom::SerializedValue>::Write(Message* m,
+                                               const param_type& p) {
+  m->WriteData(static_cast<const char*>(p.pickle().data()),
+               static_cast<int>(p.pickle().size()));
+}
+
+bool ParamTraits<atom::SerializedValue>::Read(const Message* m,
+                                              PickleIterator* iter,
+                                              param_type* r) {
+  const char* data;
+  int size;
+  return iter->ReadData(&data, &size) && r->InitFromData(data, size);
+}
+
+void ParamTraits<atom::SerializedValue>::Log(const param_type& p,
+                                             std::string* l) {
+  l->append("<SerializedValue>");
+}
+
+}  // namespace IPC
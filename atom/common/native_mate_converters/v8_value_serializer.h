@@ -0,0 +1,108 @@
+// Copyright (c) 2015 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#ifndef ATOM_COMMON_NATIVE_MATE_CONVERTERS_V8_VALUE_SERIALIZER_H_
+#define ATOM_COMMON_NATIVE_MATE_CONVERTERS_V8_VALUE_SERIALIZER_H_
+
+#include <string>
+
+#include "base/memory/scoped_ptr.h"
+#include "base/memory/shared_memory.h"
+#include "base/pickle.h"
+#include "base/process/process_handle.h"
+#include "ipc/ipc_param_traits.h"
+#include "v8/include/v8.h"
+
+namespace IPC {
+class Message;
+}
+
+namespace atom {
+
+// The serialized values larger than this are sent in shared memory, instead of
+// being copied into the IPC message and through the pipe.
+const size_t kSharedMemoryThreshold = 256 * 1024;
+
+// A V8 value serialized into a compact tagged binary format, which can be
+// sent in IPC messages. The data is owned when it is written for sending, but
+// only refers to the IPC message when it is received.
+class SerializedValue {
+ public:
+  SerializedValue();
+  ~SerializedValue();
+
+  // Refers to |size| bytes of |data| without copying, the |data| must outlive
+  // this object.
+  bool InitFromData(const char* data, int size);
+
+  // Makes an owned copy of |other|, so it can outlive the IPC message.
+  void CopyFrom(const SerializedValue& other);
+
+  // Copies the data into a new shared memory |memory|, which can then be
+  // shared with many processes.
+  bool CopyToSharedMemory(base::SharedMemory* memory) const;
+
+  // Copies the data into a new shared memory, and shares it with |process|.
+  bool ShareToProcess(base::ProcessHandle process,
+                      base::SharedMemoryHandle* handle) const;
+
+  // Maps the |size| bytes of shared memory in |memory| and refers to them,
+  // the |memory| is kept as long as this object. The |size| comes from the
+  // peer, so it fails when the memory is smaller than that.
+  bool InitFromSharedMemory(scoped_ptr<base::SharedMemory> memory,
+                            uint32 size);
+
+  // Like InitFromSharedMemory but copies the |size| bytes out of |memory|
+  // before parsing them, for memory that its sender can still write to.
+  bool CopyFromSharedMemory(scoped_ptr<base::SharedMemory> memory,
+                            uint32 size);
+
+  size_t size() const { return pickle_->size(); }
+
+  Pickle* pickle() { return pickle_.get(); }
+  const Pickle& pickle() const { return *pickle_; }
+
+ private:
+  static bool MapSharedMemory(base::SharedMemory* memory, uint32 size);
+
+  scoped_ptr<Pickle> pickle_;
+  scoped_ptr<base::SharedMemory> shared_memory_;
+
+  DISALLOW_COPY_AND_ASSIGN(SerializedValue);
+};
+
+// Writes |value| into |out| directly without building a base::Value tree,
+// following the same conversion rules as V8ValueConverter: undefined and
+// functions are skipped in objects and become null in arrays, repeated
+// objects become null and nesting is limited. Buffers and ArrayBuffers are
+// copied as raw bytes and keep their types.
+void SerializeV8Value(v8::Isolate* isolate,
+                      v8::Handle<v8::Value> value,
+                      SerializedValue* out);
+
+// Creates the V8 value written by SerializeV8Value in current context, returns
+// an empty handle when |value| is malformed.
+v8::Local<v8::Value> DeserializeV8Value(v8::Isolate* isolate,
+                                        const SerializedValue& value);
+
+// Like DeserializeV8Value but creates Uint8Arrays instead of Buffers, for
+// isolates that do not run Node.
+v8::Local<v8::Value> DeserializeV8ValueWithoutNode(
+    v8::Isolate* isolate, const SerializedValue& value);
+
+}  // namespace atom
+
+namespace IPC {
+
+template <>
+struct ParamTraits<atom::SerializedValue> {
+  typedef atom::SerializedValue param_type;
+  static void Write(Message* m, const param_type& p);
+  static bool Read(const Message* m, PickleIterator* iter, param_type* r);
+  static void Log(const param_type& p, std::string* l);
+};
+
+}  // namespace IPC
+
+#endif  // ATOM_COMMON_NATIVE_MATE_CONVERTERS_V8_VALUE_SERIALIZER_H_
@@ -9,39 +9,35 @@
 
 namespace mate {
 
+// The converter only holds its options, so it lives on the stack, and the
+// results are written into |out| without an intermediate base::Value.
+
 bool Converter<base::DictionaryValue>::FromV8(v8::Isolate* isolate,
                                               v8::Handle<v8::Value> val,
                                               base::DictionaryValue* out) {
-  scoped_ptr<atom::V8ValueConverter> converter(new atom::V8ValueConverter);
-  scoped_ptr<base::Value> value(converter->FromV8Value(
-      val, isolate->GetCurrentContext()));
-  if (value && value->IsType(base::Value::TYPE_DICTIONARY)) {
-    out->Swap(static_cast<base::DictionaryValue*>(value.get()));
-    return true;
-  } else {
-    return false;
-  }
+  atom::V8ValueConverter converter;
+  return converter.FromV8Value(val, isolate->GetCurrentContext(), out);
+}
+
+v8::Handle<v8::Value> Converter<base::DictionaryValue>::ToV8(
+    v8::Isolate* isolate,
+    const base::DictionaryValue& val) {
+  atom::V8ValueConverter converter;
+  return converter.ToV8Value(&val, isolate->GetCurrentContext());
 }
 
 bool Converter<base::ListValue>::FromV8(v8::Isolate* isolate,
                                         v8::Handle<v8::Value> val,
                                         base::ListValue* out) {
-  scoped_ptr<atom::V8ValueConverter> converter(new atom::V8ValueConverter);
-  scoped_ptr<base::Value> value(converter->FromV8Value(
-      val, isolate->GetCurrentContext()));
-  if (value->IsType(base::Value::TYPE_LIST)) {
-    out->Swap(static_cast<base::ListValue*>(value.get()));
-    return true;
-  } else {
-    return false;
-  }
+  atom::V8ValueConverter converter;
+  return converter.FromV8Value(val, isolate->GetCurrentContext(), out);
 }
 
 v8::Handle<v8::Value> Converter<base::ListValue>::ToV8(
     v8::Isolate* isolate,
     const base::ListValue& val) {
-  scoped_ptr<atom::V8ValueConverter> converter(new atom::V8ValueConverter);
-  return converter->ToV8Value(&val, isolate->GetCurrentContext());
+  atom::V8ValueConverter converter;
+  return converter.ToV8Value(&val, isolate->GetCurrentContext());
 }
 
 }  // namespace mate
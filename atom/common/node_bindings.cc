@@ -4,13 +4,17 @@
 
 #include "atom/common/node_bindings.h"
 
+#include <algorithm>
 #include <string>
 #include <vector>
 
 #include "atom/app/atom_main_args.h"
+#include "atom/common/loop_stats.h"
 #include "atom/common/native_mate_converters/file_path_converter.h"
+#include "atom/common/startup_timings.h"
 #include "base/command_line.h"
 #include "base/base_paths.h"
+#include "base/debug/trace_event.h"
 #include "base/files/file_path.h"
 #include "base/message_loop/message_loop.h"
 #include "base/path_service.h"
@@ -31,6 +35,7 @@ using content::BrowserThread;
 REFERENCE_MODULE(atom_browser_app);
 REFERENCE_MODULE(atom_browser_auto_updater);
 REFERENCE_MODULE(atom_browser_content_tracing);
+REFERENCE_MODULE(atom_browser_desktop_capturer);
 REFERENCE_MODULE(atom_browser_dialog);
 REFERENCE_MODULE(atom_browser_menu);
 REFERENCE_MODULE(atom_browser_power_monitor);
@@ -40,13 +45,17 @@ REFERENCE_MODULE(atom_browser_tray);
 REFERENCE_MODULE(atom_browser_web_contents);
 REFERENCE_MODULE(atom_browser_web_view_manager);
 REFERENCE_MODULE(atom_browser_window);
+REFERENCE_MODULE(atom_browser_worker);
+REFERENCE_MODULE(atom_browser_worker_channel);
 REFERENCE_MODULE(atom_common_asar);
 REFERENCE_MODULE(atom_common_clipboard);
 REFERENCE_MODULE(atom_common_crash_reporter);
 REFERENCE_MODULE(atom_common_id_weak_map);
+REFERENCE_MODULE(atom_common_logger);
 REFERENCE_MODULE(atom_common_native_image);
 REFERENCE_MODULE(atom_common_screen);
 REFERENCE_MODULE(atom_common_shell);
+REFERENCE_MODULE(atom_common_trace_event);
 REFERENCE_MODULE(atom_common_v8_util);
 REFERENCE_MODULE(atom_renderer_ipc);
 REFERENCE_MODULE(atom_renderer_web_frame);
@@ -56,6 +65,22 @@ namespace atom {
 
 namespace {
 
+// How long a UvRunOnce task can keep running the uv loop while events keep
+// arriving, so event storms are handled in few tasks without starving
+// Chromium's tasks.
+const int kUvRunBudgetMs = 4;
+
+// The timer slacks set by process.setTimerSlack and by the power policy, in
+// milliseconds, the embed thread uses the larger one, and zero means timers
+// are not delayed, which is the default.
+base::subtle::Atomic32 g_timer_slack_ms = 0;
+base::subtle::Atomic32 g_power_policy_timer_slack_ms = 0;
+
+base::subtle::Atomic32 ToSlackMs(base::TimeDelta slack) {
+  int64 ms = slack.InMilliseconds();
+  return static_cast<base::subtle::Atomic32>(std::max<int64>(ms, 0));
+}
+
 // Empty callback for async handle.
 void UvNoOp(uv_async_t* handle) {
 }
@@ -72,7 +97,27 @@ scoped_ptr<const char*[]> StringVectorToArgArray(
   return array.Pass();
 }
 
-base::FilePath GetResourcesPath(bool is_browser) {
+// The environment being destroyed, and how many of its handles are still
+// being closed.
+struct EnvironmentCleanup {
+  node::Environment* env;
+  size_t pending_handles;
+};
+
+void OnEnvironmentHandleClosed(uv_handle_t* handle) {
+  EnvironmentCleanup* cleanup = static_cast<EnvironmentCleanup*>(handle->data);
+  if (--cleanup->pending_handles > 0)
+    return;
+  cleanup->env->Dispose();
+  delete cleanup;
+}
+
+}  // namespace
+
+node::Environment* global_env = nullptr;
+
+// static
+base::FilePath NodeBindings::GetResourcesPath(bool is_browser) {
   auto command_line = base::CommandLine::ForCurrentProcess();
   base::FilePath exec_path(command_line->GetProgram());
   PathService::Get(base::FILE_EXE, &exec_path);
@@ -88,20 +133,22 @@ base::FilePath GetResourcesPath(bool is_browser) {
   return resources_path;
 }
 
-}  // namespace
-
-node::Environment* global_env = nullptr;
-
 NodeBindings::NodeBindings(bool is_browser)
     : is_browser_(is_browser),
       message_loop_(nullptr),
       uv_loop_(uv_default_loop()),
+      timer_coalesced_(0),
+      uv_run_scheduled_(0),
+      use_embed_thread_(false),
       embed_closed_(false),
       uv_env_(nullptr),
       weak_factory_(this) {
 }
 
 NodeBindings::~NodeBindings() {
+  if (!use_embed_thread_)
+    return;
+
   // Quit the embed thread.
   embed_closed_ = true;
   uv_sem_post(&embed_sem_);
@@ -149,11 +196,63 @@ node::Environment* NodeBindings::CreateEnvironment(
   mate::Dictionary process(context->GetIsolate(), env->process_object());
   process.Set("type", process_type);
   process.Set("resourcesPath", resources_path);
+
+  StartupTimings::GetInstance()->Record("node-environment-created");
   return env;
 }
 
 void NodeBindings::LoadEnvironment(node::Environment* env) {
   node::LoadEnvironment(env);
+  StartupTimings::GetInstance()->Record("init-script-loaded");
+}
+
+void NodeBindings::DestroyEnvironment(node::Environment* env) {
+  if (uv_env_ == env)
+    uv_env_ = nullptr;
+
+  v8::Isolate* isolate = env->isolate();
+  v8::HandleScope handle_scope(isolate);
+  v8::Context::Scope context_scope(env->context());
+
+  // Node only frees the handles of an environment when the process exits, so
+  // close them here and free the environment after the last one is closed.
+  uv_handle_t* handles[] = {
+    reinterpret_cast<uv_handle_t*>(env->immediate_check_handle()),
+    reinterpret_cast<uv_handle_t*>(env->immediate_idle_handle()),
+    reinterpret_cast<uv_handle_t*>(env->idle_prepare_handle()),
+    reinterpret_cast<uv_handle_t*>(env->idle_check_handle()),
+  };
+  EnvironmentCleanup* cleanup = new EnvironmentCleanup;
+  cleanup->env = env;
+  cleanup->pending_handles = arraysize(handles);
+  for (uv_handle_t* handle : handles) {
+    handle->data = cleanup;
+    uv_close(handle, &OnEnvironmentHandleClosed);
+  }
+
+  // Then close the handles opened by the page, like timers and sockets. libuv
+  // finishes the closes in reverse order, so their callbacks, which still use
+  // the environment, run before it is freed.
+  v8::Local<v8::Object> process = env->process_object();
+  v8::Local<v8::Value> get_handles =
+      process->Get(mate::StringToV8(isolate, "_getActiveHandles"));
+  if (!get_handles->IsFunction())
+    return;
+  v8::TryCatch try_catch;
+  v8::Local<v8::Value> active =
+      v8::Local<v8::Function>::Cast(get_handles)->Call(process, 0, nullptr);
+  if (active.IsEmpty() || !active->IsArray())
+    return;
+  v8::Local<v8::Array> array = v8::Local<v8::Array>::Cast(active);
+  for (uint32_t i = 0; i < array->Length(); ++i) {
+    v8::Local<v8::Value> handle = array->Get(i);
+    if (!handle->IsObject())
+      continue;
+    v8::Local<v8::Value> close =
+        handle->ToObject()->Get(mate::StringToV8(isolate, "close"));
+    if (close->IsFunction())
+      v8::Local<v8::Function>::Cast(close)->Call(handle, 0, nullptr);
+  }
 }
 
 void NodeBindings::PrepareMessageLoop() {
@@ -163,7 +262,13 @@ void NodeBindings::PrepareMessageLoop() {
   // nothing to do.
   uv_async_init(uv_loop_, &dummy_uv_handle_, UvNoOp);
 
+  // Decided here instead of in constructor so switches appended by the main
+  // script are respected.
+  if (PollOnMainThread())
+    return;
+
   // Start worker that will interrupt main loop when having uv events.
+  use_embed_thread_ = true;
   uv_sem_init(&embed_sem_, 0);
   uv_thread_create(&embed_thread_, EmbedThreadRunner, this);
 }
@@ -173,6 +278,7 @@ void NodeBindings::RunMessageLoop() {
 
   // The MessageLoop should have been created, remember the one in main thread.
   message_loop_ = base::MessageLoop::current();
+  LoopStats::GetInstance()->ObserveMessageLoop(message_loop_);
 
   // Run uv loop for once to give the uv__io_poll a chance to add all events.
   UvRunOnce();
@@ -180,6 +286,7 @@ void NodeBindings::RunMessageLoop() {
 
 void NodeBindings::UvRunOnce() {
   DCHECK(!is_browser_ || BrowserThread::CurrentlyOn(BrowserThread::UI));
+  TRACE_EVENT0("atom", "NodeBindings::UvRunOnce");
 
   // By default the global env would be used unless user specified another one
   // (this happens for renderer process, which wraps the uv loop with web page
@@ -193,17 +300,60 @@ void NodeBindings::UvRunOnce() {
   // Enter node context while dealing with uv events.
   v8::Context::Scope context_scope(env->context());
 
-  // Deal with uv events.
-  int r = uv_run(uv_loop_, UV_RUN_NOWAIT);
-  if (r == 0 || uv_loop_->stop_flag != 0)
-    message_loop_->QuitWhenIdle();  // Quit from uv.
+  base::subtle::NoBarrier_Store(&uv_run_scheduled_, 0);
+
+  LoopStats* stats = LoopStats::GetInstance();
+  base::TimeTicks start = base::TimeTicks::Now();
+  if (!wakeup_time_.is_null()) {
+    stats->RecordWakeupLatency(start - wakeup_time_);
+    wakeup_time_ = base::TimeTicks();
+  }
+
+  if (base::subtle::NoBarrier_AtomicExchange(&timer_coalesced_, 0) != 0)
+    stats->RecordCoalescedTimerWakeup();
+
+  // Deal with uv events, and keep dealing with the ones arrived meanwhile
+  // until the budget is used up.
+  base::TimeTicks deadline =
+      start + base::TimeDelta::FromMilliseconds(kUvRunBudgetMs);
+  int iterations = 0;
+  int r;
+  do {
+    ++iterations;
+    r = uv_run(uv_loop_, UV_RUN_NOWAIT);
+    if (r == 0 || uv_loop_->stop_flag != 0) {
+      message_loop_->QuitWhenIdle();  // Quit from uv.
+      break;
+    }
+  } while (HasPendingEvents() && base::TimeTicks::Now() < deadline);
+  TRACE_EVENT_INSTANT1("atom", "NodeBindings::UvRun", TRACE_EVENT_SCOPE_THREAD,
+                       "iterations", iterations);
+  stats->RecordUvRun(iterations, base::TimeTicks::Now() - start);
 
   // Tell the worker thread to continue polling.
-  uv_sem_post(&embed_sem_);
+  if (use_embed_thread_)
+    uv_sem_post(&embed_sem_);
+  else
+    DidRunUvLoop();
+}
+
+bool NodeBindings::PollOnMainThread() {
+  return false;
+}
+
+void NodeBindings::DidRunUvLoop() {
+}
+
+bool NodeBindings::HasPendingEvents() {
+  return uv_backend_timeout(uv_loop_) == 0;
 }
 
 void NodeBindings::WakeupMainThread() {
   DCHECK(message_loop_);
+  // A queued run would deal with the new events too.
+  if (base::subtle::NoBarrier_CompareAndSwap(&uv_run_scheduled_, 0, 1) != 0)
+    return;
+  wakeup_time_ = base::TimeTicks::Now();
   message_loop_->PostTask(FROM_HERE, base::Bind(&NodeBindings::UvRunOnce,
                                                 weak_factory_.GetWeakPtr()));
 }
@@ -212,6 +362,40 @@ void NodeBindings::WakeupEmbedThread() {
   uv_async_send(&dummy_uv_handle_);
 }
 
+int NodeBindings::GetCoalescedTimeout() {
+  int timeout = uv_backend_timeout(uv_loop_);
+  if (timeout <= 0)
+    return timeout;
+
+  uint64_t slack = std::max(
+      base::subtle::NoBarrier_Load(&g_timer_slack_ms),
+      base::subtle::NoBarrier_Load(&g_power_policy_timer_slack_ms));
+  if (slack == 0)
+    return timeout;
+
+  // The deadline is on the loop's clock, which is in milliseconds of
+  // uv_hrtime.
+  uint64_t deadline = uv_now(uv_loop_) + timeout;
+  uint64_t coalesced = (deadline + slack - 1) / slack * slack;
+  uint64_t now = uv_hrtime() / 1000000;
+  if (coalesced <= now)
+    return 0;
+  if (coalesced != deadline)
+    base::subtle::NoBarrier_Store(&timer_coalesced_, 1);
+  return static_cast<int>(coalesced - now);
+}
+
+// static
+void NodeBindings::SetTimerSlack(base::TimeDelta slack) {
+  base::subtle::NoBarrier_Store(&g_timer_slack_ms, ToSlackMs(slack));
+}
+
+// static
+void NodeBindings::SetPowerPolicyTimerSlack(base::TimeDelta slack) {
+  base::subtle::NoBarrier_Store(&g_power_policy_timer_slack_ms,
+                                ToSlackMs(slack));
+}
+
 // static
 void NodeBindings::EmbedThreadRunner(void *arg) {
   NodeBindings* self = static_cast<NodeBindings*>(arg);
@@ -5,8 +5,11 @@
 #ifndef ATOM_COMMON_NODE_BINDINGS_H_
 #define ATOM_COMMON_NODE_BINDINGS_H_
 
+#include "base/atomicops.h"
 #include "base/basictypes.h"
+#include "base/files/file_path.h"
 #include "base/memory/weak_ptr.h"
+#include "base/time/time.h"
 #include "v8/include/v8.h"
 #include "vendor/node/deps/uv/include/uv.h"
 
@@ -24,6 +27,17 @@ class NodeBindings {
  public:
   static NodeBindings* Create(bool is_browser);
 
+  // Sets how far the deadlines of timers can be delayed so they expire
+  // together, zero turns it off, which is the default.
+  static void SetTimerSlack(base::TimeDelta slack);
+
+  // Sets the timer slack asked by the power policy, the larger one of the two
+  // is used.
+  static void SetPowerPolicyTimerSlack(base::TimeDelta slack);
+
+  // Returns the resources directory of the app, where the asar archives are.
+  static base::FilePath GetResourcesPath(bool is_browser);
+
   virtual ~NodeBindings();
 
   // Setup V8, libuv.
@@ -35,6 +49,10 @@ class NodeBindings {
   // Load node.js in the environment.
   void LoadEnvironment(node::Environment* env);
 
+  // Closes the handles of |env| and frees it once libuv is done with them,
+  // should be called before its context is released.
+  void DestroyEnvironment(node::Environment* env);
+
   // Prepare for message loop integration.
   void PrepareMessageLoop();
 
@@ -51,6 +69,18 @@ class NodeBindings {
   // Called to poll events in new thread.
   virtual void PollEvents() = 0;
 
+  // Returns true if the derived class watches the uv loop in the main thread's
+  // message pump itself, so the embed thread is not needed.
+  virtual bool PollOnMainThread();
+
+  // Called after each UvRunOnce when polling on the main thread.
+  virtual void DidRunUvLoop();
+
+  // Returns true if uv has work to do immediately, used by UvRunOnce to keep
+  // draining events within its time budget. Only called on main thread while
+  // the embed thread is not polling.
+  virtual bool HasPendingEvents();
+
   // Run the libuv loop for once.
   void UvRunOnce();
 
@@ -60,6 +90,11 @@ class NodeBindings {
   // Interrupt the PollEvents.
   void WakeupEmbedThread();
 
+  // Returns the timeout of uv_backend_timeout with the deadline of timers
+  // rounded up to a multiple of the timer slack, so timers expiring close to
+  // each other are handled by one wakeup. Called by PollEvents.
+  int GetCoalescedTimeout();
+
   // Are we running in browser.
   bool is_browser_;
 
@@ -73,6 +108,20 @@ class NodeBindings {
   // Thread to poll uv events.
   static void EmbedThreadRunner(void *arg);
 
+  // Set by GetCoalescedTimeout when a timer deadline has been rounded up, so
+  // UvRunOnce would count the wakeups saved.
+  base::subtle::Atomic32 timer_coalesced_;
+
+  // Set when a UvRunOnce task has been posted but not run yet.
+  base::subtle::Atomic32 uv_run_scheduled_;
+
+  // When the embed thread last woke up the main thread, written before
+  // posting the task, so it is visible when the task runs.
+  base::TimeTicks wakeup_time_;
+
+  // Whether the embed thread is used for polling.
+  bool use_embed_thread_;
+
   // Whether the libuv loop has ended.
   bool embed_closed_;
 
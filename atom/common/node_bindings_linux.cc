@@ -6,11 +6,32 @@
 
 #include <sys/epoll.h>
 
+#if defined(USE_GLIB)
+#include <glib.h>
+#endif
+
+#include "atom/common/options_switches.h"
+#include "base/command_line.h"
+
 namespace atom {
 
+namespace {
+
+#if defined(USE_GLIB)
+gboolean OnBackendFdReadable(GIOChannel* channel,
+                             GIOCondition condition,
+                             gpointer data) {
+  static_cast<NodeBindingsLinux*>(data)->OnBackendFdReadable();
+  return TRUE;  // Keep watching.
+}
+#endif
+
+}  // namespace
+
 NodeBindingsLinux::NodeBindingsLinux(bool is_browser)
     : NodeBindings(is_browser),
-      epoll_(epoll_create(1)) {
+      epoll_(epoll_create(1)),
+      backend_watch_(0) {
   int backend_fd = uv_backend_fd(uv_loop_);
   struct epoll_event ev = { 0 };
   ev.events = EPOLLIN;
@@ -19,6 +40,10 @@ NodeBindingsLinux::NodeBindingsLinux(bool is_browser)
 }
 
 NodeBindingsLinux::~NodeBindingsLinux() {
+#if defined(USE_GLIB)
+  if (backend_watch_)
+    g_source_remove(backend_watch_);
+#endif
 }
 
 void NodeBindingsLinux::RunMessageLoop() {
@@ -34,12 +59,14 @@ void NodeBindingsLinux::OnWatcherQueueChanged(uv_loop_t* loop) {
   NodeBindingsLinux* self = static_cast<NodeBindingsLinux*>(loop->data);
 
   // We need to break the io polling in the epoll thread when loop's watcher
-  // queue changes, otherwise new events cannot be notified.
+  // queue changes, otherwise new events cannot be notified. When polling on
+  // main thread this makes the backend fd readable, so uv runs again and adds
+  // the new watchers to its epoll.
   self->WakeupEmbedThread();
 }
 
 void NodeBindingsLinux::PollEvents() {
-  int timeout = uv_backend_timeout(uv_loop_);
+  int timeout = GetCoalescedTimeout();
 
   // Wait for new libuv events.
   int r;
@@ -49,6 +76,48 @@ void NodeBindingsLinux::PollEvents() {
   } while (r == -1 && errno == EINTR);
 }
 
+bool NodeBindingsLinux::PollOnMainThread() {
+#if defined(USE_GLIB)
+  // Only the browser's UI thread runs a glib message pump.
+  if (!is_browser_ || !base::CommandLine::ForCurrentProcess()->HasSwitch(
+          switches::kIntegratedUvLoop))
+    return false;
+
+  GIOChannel* channel = g_io_channel_unix_new(uv_backend_fd(uv_loop_));
+  backend_watch_ = g_io_add_watch(channel, G_IO_IN, &OnBackendFdReadable,
+                                  this);
+  // The watch keeps its own reference.
+  g_io_channel_unref(channel);
+  return true;
+#else
+  return false;
+#endif
+}
+
+void NodeBindingsLinux::DidRunUvLoop() {
+  int timeout = uv_backend_timeout(uv_loop_);
+  if (timeout < 0)
+    uv_timer_.Stop();
+  else
+    uv_timer_.Start(FROM_HERE, base::TimeDelta::FromMilliseconds(timeout),
+                    this, &NodeBindingsLinux::OnUvTimeout);
+}
+
+bool NodeBindingsLinux::HasPendingEvents() {
+  if (NodeBindings::HasPendingEvents())
+    return true;
+  struct epoll_event ev;
+  return epoll_wait(epoll_, &ev, 1, 0) > 0;
+}
+
+void NodeBindingsLinux::OnBackendFdReadable() {
+  UvRunOnce();
+}
+
+void NodeBindingsLinux::OnUvTimeout() {
+  UvRunOnce();
+}
+
 // static
 NodeBindings* NodeBindings::Create(bool is_browser) {
   return new NodeBindingsLinux(is_browser);
@@ -6,6 +6,7 @@
 #define ATOM_COMMON_NODE_BINDINGS_LINUX_H_
 
 #include "base/compiler_specific.h"
+#include "base/timer/timer.h"
 #include "atom/common/node_bindings.h"
 
 namespace atom {
@@ -17,15 +18,29 @@ class NodeBindingsLinux : public NodeBindings {
 
   void RunMessageLoop() override;
 
+  // Called by the glib watch on main thread when uv's backend fd is readable.
+  void OnBackendFdReadable();
+
  private:
   // Called when uv's watcher queue changes.
   static void OnWatcherQueueChanged(uv_loop_t* loop);
 
   void PollEvents() override;
+  bool PollOnMainThread() override;
+  void DidRunUvLoop() override;
+  bool HasPendingEvents() override;
+
+  void OnUvTimeout();
 
   // Epoll to poll for uv's backend fd.
   int epoll_;
 
+  // The glib source watching the backend fd in main thread.
+  unsigned int backend_watch_;
+
+  // Wakes up uv for its timers when polling on main thread.
+  base::OneShotTimer<NodeBindingsLinux> uv_timer_;
+
   DISALLOW_COPY_AND_ASSIGN(NodeBindingsLinux);
 };
 
@@ -45,7 +45,7 @@ void NodeBindingsMac::OnWatcherQueueChanged(uv_loop_t* loop) {
 
 void NodeBindingsMac::PollEvents() {
   struct timespec spec;
-  int timeout = uv_backend_timeout(uv_loop_);
+  int timeout = GetCoalescedTimeout();
   if (timeout != -1) {
     spec.tv_sec = timeout / 1000;
     spec.tv_nsec = (timeout % 1000) * 1000000;
@@ -60,6 +60,14 @@ void NodeBindingsMac::PollEvents() {
   } while (r == -1 && errno == EINTR);
 }
 
+bool NodeBindingsMac::HasPendingEvents() {
+  if (NodeBindings::HasPendingEvents())
+    return true;
+  struct timespec spec = { 0, 0 };
+  struct kevent ev;
+  return ::kevent(kqueue_, NULL, 0, &ev, 1, &spec) > 0;
+}
+
 // static
 NodeBindings* NodeBindings::Create(bool is_browser) {
   return new NodeBindingsMac(is_browser);
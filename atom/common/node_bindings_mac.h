@@ -22,6 +22,7 @@ class NodeBindingsMac : public NodeBindings {
   static void OnWatcherQueueChanged(uv_loop_t* loop);
 
   void PollEvents() override;
+  bool HasPendingEvents() override;
 
   // Kqueue to poll for uv's backend fd.
   int kqueue_;
@@ -36,6 +36,12 @@ const char kAlwaysOnTop[] = "always-on-top";
 
 const char kNodeIntegration[] = "node-integration";
 
+// Create the node environment when page first uses it.
+const char kLazyNodeIntegration[] = "lazy-node-integration";
+
+// Let window.open create the popups natively instead of in JS.
+const char kNativeWindowOpen[] = "native-window-open";
+
 // Enable the NSView to accept first mouse event.
 const char kAcceptFirstMouse[] = "accept-first-mouse";
 
@@ -75,6 +81,27 @@ const char kTransparent[] = "transparent";
 // Window type hint.
 const char kType[] = "type";
 
+// Emit at most one move and resize event for each frame.
+const char kCoalesceBoundsEvents[] = "coalesce-bounds-events";
+
+// How the page runs when the window is hidden or minimized.
+const char kBackgroundThrottling[] = "background-throttling";
+
+// Keep the window for a new window with the same options when it is closed.
+const char kRecyclable[] = "recyclable";
+
+// Windows with the same process group share one renderer process.
+const char kProcessGroup[] = "process-group";
+
+// The limit of V8's heap in MB of the renderer process.
+const char kMaxHeapSize[] = "max-heap-size";
+
+// Render the page without showing the window, delivering frames with "paint".
+const char kOffscreen[] = "offscreen";
+
+// The maximum number of frames per second of an offscreen window.
+const char kOffscreenFrameRate[] = "offscreen-frame-rate";
+
 // Web runtime features.
 const char kExperimentalFeatures[]       = "experimental-features";
 const char kExperimentalCanvasFeatures[] = "experimental-canvas-features";
@@ -86,6 +113,48 @@ const char kSharedWorker[]               = "shared-worker";
 // Disable HTTP cache.
 const char kDisableHttpCache[] = "disable-http-cache";
 
+// Keep the HTTP cache in memory instead of on disk.
+const char kInMemoryHttpCache[] = "in-memory-http-cache";
+
+// The directory and the maximum size in bytes of the HTTP cache.
+const char kDiskCacheDir[]  = "disk-cache-dir";
+const char kDiskCacheSize[] = "disk-cache-size";
+
+// Directory to keep files extracted from asar archives across restarts.
+const char kAsarCacheDir[] = "asar-cache-dir";
+
+// Directory to keep V8 code cache of the built-in scripts.
+const char kJsCodeCacheDir[] = "js-code-cache-dir";
+
+// Keep V8 code cache of the modules in asar archives beside the archives.
+const char kAsarCodeCache[] = "asar-code-cache";
+
+// Keep the module resolutions of searches in asar archives beside them.
+const char kAsarResolveCache[] = "asar-resolve-cache";
+
+// Prefetch the asar ranges listed in the manifest when opening archives.
+const char kAsarPrefetchManifest[] = "asar-prefetch-manifest";
+
+// Record the asar ranges being read and write them into the manifest on exit.
+const char kRecordAsarPrefetchManifest[] = "record-asar-prefetch-manifest";
+
+// Poll libuv's events in the main thread's message pump instead of a separate
+// thread, only supported by the browser process on Linux.
+const char kIntegratedUvLoop[] = "integrated-uv-loop";
+
+// Write the startup milestones of browser to the file when the first window
+// paints.
+const char kTraceStartup[] = "trace-startup";
+
+// The renderer is started by the process pool before any window uses it.
+const char kPrewarmedRenderer[] = "prewarmed-renderer";
+
+// Initialize the platform speech synthesis and load its voices at startup.
+const char kPrewarmSpeechSynthesis[] = "prewarm-speech-synthesis";
+
+// Refuse to show dialogs that block in a nested message loop.
+const char kDisableSyncDialogs[] = "disable-sync-dialogs";
+
 }  // namespace switches
 
 }  // namespace atom
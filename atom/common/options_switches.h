@@ -28,6 +28,8 @@ extern const char kSkipTaskbar[];
 extern const char kKiosk[];
 extern const char kAlwaysOnTop[];
 extern const char kNodeIntegration[];
+extern const char kLazyNodeIntegration[];
+extern const char kNativeWindowOpen[];
 extern const char kAcceptFirstMouse[];
 extern const char kUseContentSize[];
 extern const char kWebPreferences[];
@@ -41,6 +43,13 @@ extern const char kGuestInstanceID[];
 extern const char kPreloadScript[];
 extern const char kTransparent[];
 extern const char kType[];
+extern const char kCoalesceBoundsEvents[];
+extern const char kBackgroundThrottling[];
+extern const char kRecyclable[];
+extern const char kProcessGroup[];
+extern const char kMaxHeapSize[];
+extern const char kOffscreen[];
+extern const char kOffscreenFrameRate[];
 
 extern const char kExperimentalFeatures[];
 extern const char kExperimentalCanvasFeatures[];
@@ -50,6 +59,25 @@ extern const char kOverlayFullscreenVideo[];
 extern const char kSharedWorker[];
 
 extern const char kDisableHttpCache[];
+extern const char kInMemoryHttpCache[];
+extern const char kDiskCacheDir[];
+extern const char kDiskCacheSize[];
+extern const char kAsarCacheDir[];
+extern const char kJsCodeCacheDir[];
+extern const char kAsarCodeCache[];
+extern const char kAsarResolveCache[];
+extern const char kAsarPrefetchManifest[];
+extern const char kRecordAsarPrefetchManifest[];
+
+extern const char kIntegratedUvLoop[];
+
+extern const char kTraceStartup[];
+
+extern const char kPrewarmedRenderer[];
+
+extern const char kPrewarmSpeechSynthesis[];
+
+extern const char kDisableSyncDialogs[];
 
 }  // namespace switches
 
@@ -0,0 +1,30 @@
+// Copyright (c) 2015 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#include "atom/common/purge_memory.h"
+
+#include "atom/common/api/atom_api_id_weak_map.h"
+#include "atom/common/api/atom_api_native_image.h"
+#include "atom/common/asar/asar_util.h"
+#include "base/debug/trace_event.h"
+#include "v8/include/v8.h"
+
+namespace atom {
+
+void PurgeMemory(base::MemoryPressureListener::MemoryPressureLevel level) {
+  bool critical =
+      level == base::MemoryPressureListener::MEMORY_PRESSURE_LEVEL_CRITICAL;
+  TRACE_EVENT1("atom", "PurgeMemory", "critical", critical);
+
+  api::NativeImage::PurgeDecodedImageCache(critical);
+
+  v8::Isolate* isolate = v8::Isolate::GetCurrent();
+  if (isolate)
+    api::IDWeakMap::CompactAll(isolate);
+
+  if (critical)
+    asar::ClearAsarExternalFiles();
+}
+
+}  // namespace atom
@@ -0,0 +1,19 @@
+// Copyright (c) 2015 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#ifndef ATOM_COMMON_PURGE_MEMORY_H_
+#define ATOM_COMMON_PURGE_MEMORY_H_
+
+#include "base/memory/memory_pressure_listener.h"
+
+namespace atom {
+
+// Drops the caches of the modules shared by browser and renderer processes,
+// the critical level drops everything that can be rebuilt. Should be called on
+// the main thread, which runs JS.
+void PurgeMemory(base::MemoryPressureListener::MemoryPressureLevel level);
+
+}  // namespace atom
+
+#endif  // ATOM_COMMON_PURGE_MEMORY_H_
@@ -0,0 +1,167 @@
+// Copyright (c) 2015 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#include "atom/common/ring_buffer.h"
+
+#include <string.h>
+
+#include "base/logging.h"
+
+namespace atom {
+
+namespace {
+
+// Records are aligned so their length prefixes are never split by the end of
+// buffer.
+const uint32 kAlignment = sizeof(uint32);
+
+// Written instead of a length when the record does not fit at the end of the
+// buffer, the consumer then skips to the start.
+const uint32 kPaddingMarker = 0xFFFFFFFF;
+
+const uint32 kMinCapacity = 4096;
+const uint32 kMaxCapacity = 1 << 26;
+
+uint32 Align(uint32 size) {
+  return (size + kAlignment - 1) & ~(kAlignment - 1);
+}
+
+}  // namespace
+
+// The positions are counters that only grow and wrap around at 2^32, which
+// works because the capacity is a power of two.
+struct RingBuffer::Header {
+  base::subtle::Atomic32 write_position;
+  base::subtle::Atomic32 read_position;
+  // Set to 1 by the consumer when it needs a doorbell for new records.
+  base::subtle::Atomic32 waiting;
+  base::subtle::Atomic32 reserved;
+};
+
+// static
+size_t RingBuffer::RequiredMemorySize(size_t capacity) {
+  uint32 result = kMinCapacity;
+  while (result < capacity && result < kMaxCapacity)
+    result <<= 1;
+  return sizeof(Header) + result;
+}
+
+RingBuffer::RingBuffer(void* memory, size_t size)
+    : header_(static_cast<Header*>(memory)),
+      data_(static_cast<char*>(memory) + sizeof(Header)),
+      capacity_(0),
+      peeked_size_(0),
+      corrupted_(false) {
+  DCHECK_GE(size, RequiredMemorySize(0));
+  // The largest power of two that fits.
+  capacity_ = kMinCapacity;
+  while (capacity_ < kMaxCapacity && sizeof(Header) + capacity_ * 2 <= size)
+    capacity_ <<= 1;
+}
+
+RingBuffer::~RingBuffer() {
+}
+
+void RingBuffer::Initialize() {
+  base::subtle::NoBarrier_Store(&header_->write_position, 0);
+  base::subtle::NoBarrier_Store(&header_->read_position, 0);
+  // The consumer starts with waiting for the first doorbell.
+  base::subtle::NoBarrier_Store(&header_->waiting, 1);
+  base::subtle::NoBarrier_Store(&header_->reserved, 0);
+}
+
+bool RingBuffer::Write(const char* data, uint32 size, bool* should_ring) {
+  *should_ring = false;
+  if (size > capacity_ - kAlignment)
+    return false;
+
+  uint32 record = kAlignment + Align(size);
+  uint32 write = base::subtle::NoBarrier_Load(&header_->write_position);
+  uint32 read = base::subtle::Acquire_Load(&header_->read_position);
+  uint32 available = capacity_ - (write - read);
+  uint32 offset = write & (capacity_ - 1);
+  uint32 padding = offset + record > capacity_ ? capacity_ - offset : 0;
+  if (write - read > capacity_ || padding + record > available)
+    return false;
+
+  if (padding > 0) {
+    memcpy(data_ + offset, &kPaddingMarker, sizeof(kPaddingMarker));
+    write += padding;
+    offset = 0;
+  }
+  memcpy(data_ + offset, &size, sizeof(size));
+  memcpy(data_ + offset + kAlignment, data, size);
+  base::subtle::Release_Store(&header_->write_position, write + record);
+
+  // The new position must be visible before checking whether the consumer is
+  // waiting, otherwise both sides could miss each other.
+  base::subtle::MemoryBarrier();
+  *should_ring =
+      base::subtle::NoBarrier_CompareAndSwap(&header_->waiting, 1, 0) == 1;
+  return true;
+}
+
+bool RingBuffer::Peek(const char** data, uint32* size) {
+  uint32 read = base::subtle::NoBarrier_Load(&header_->read_position);
+  uint32 write = base::subtle::Acquire_Load(&header_->write_position);
+  uint32 used = write - read;
+  if (used == 0)
+    return false;
+  if (used > capacity_ || used % kAlignment != 0) {
+    corrupted_ = true;
+    return false;
+  }
+
+  uint32 offset = read & (capacity_ - 1);
+  uint32 length;
+  memcpy(&length, data_ + offset, sizeof(length));
+  if (length == kPaddingMarker) {
+    uint32 padding = capacity_ - offset;
+    // The producer writes the padding and the next record at once.
+    if (padding >= used) {
+      corrupted_ = true;
+      return false;
+    }
+    read += padding;
+    used -= padding;
+    offset = 0;
+    base::subtle::Release_Store(&header_->read_position, read);
+    memcpy(&length, data_, sizeof(length));
+  }
+
+  // Copy of the length is checked, so the producer can not make us read out
+  // of bounds by changing it later.
+  if (length > capacity_ - kAlignment ||
+      kAlignment + Align(length) > used ||
+      offset + kAlignment + Align(length) > capacity_) {
+    corrupted_ = true;
+    return false;
+  }
+
+  *data = data_ + offset + kAlignment;
+  *size = length;
+  peeked_size_ = kAlignment + Align(length);
+  return true;
+}
+
+void RingBuffer::Consume() {
+  DCHECK_GT(peeked_size_, 0u);
+  uint32 read = base::subtle::NoBarrier_Load(&header_->read_position);
+  base::subtle::Release_Store(&header_->read_position, read + peeked_size_);
+  peeked_size_ = 0;
+}
+
+bool RingBuffer::WaitForDoorbell() {
+  base::subtle::NoBarrier_Store(&header_->waiting, 1);
+  base::subtle::MemoryBarrier();
+  uint32 read = base::subtle::NoBarrier_Load(&header_->read_position);
+  uint32 write = base::subtle::Acquire_Load(&header_->write_position);
+  if (read == write)
+    return true;
+
+  // If the producer has already taken the flag, a doorbell is on its way.
+  return base::subtle::NoBarrier_CompareAndSwap(&header_->waiting, 1, 0) != 1;
+}
+
+}  // namespace atom
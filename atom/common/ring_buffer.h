@@ -0,0 +1,66 @@
+// Copyright (c) 2015 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#ifndef ATOM_COMMON_RING_BUFFER_H_
+#define ATOM_COMMON_RING_BUFFER_H_
+
+#include "base/atomicops.h"
+#include "base/basictypes.h"
+
+namespace atom {
+
+// A single-producer single-consumer queue of variable sized records, living
+// in memory shared between two processes. The producer and consumer wrap the
+// same memory and coordinate only through the atomic positions in its header,
+// so records can be passed without any IPC message except the doorbell which
+// wakes up a waiting consumer.
+class RingBuffer {
+ public:
+  // Returns the number of bytes of memory needed for a buffer that can hold
+  // |capacity| bytes of records, |capacity| is rounded up to power of two.
+  static size_t RequiredMemorySize(size_t capacity);
+
+  // Wraps |memory| of |size| bytes, which should be the size returned by
+  // RequiredMemorySize. Only the side creating the memory should call
+  // Initialize. The capacity is computed from |size| instead of being read
+  // from the memory, since the memory may be written by an untrusted process.
+  RingBuffer(void* memory, size_t size);
+  ~RingBuffer();
+
+  void Initialize();
+
+  // Producer: appends a record, returns false when there is not enough room.
+  // |should_ring| is set to true when the consumer is waiting for a doorbell.
+  bool Write(const char* data, uint32 size, bool* should_ring);
+
+  // Consumer: points |data| to the next record without copying it, returns
+  // false when the buffer is empty or corrupted. The record is valid until
+  // Consume is called.
+  bool Peek(const char** data, uint32* size);
+  void Consume();
+
+  // Consumer: marks that the consumer is going to wait for a doorbell, returns
+  // false if data arrived meanwhile and the consumer should keep reading.
+  bool WaitForDoorbell();
+
+  // Consumer: whether the last Peek failed because of malformed records.
+  bool corrupted() const { return corrupted_; }
+
+ private:
+  struct Header;
+
+  Header* header_;
+  char* data_;
+  uint32 capacity_;
+
+  // The length of the record returned by last Peek, including its padding.
+  uint32 peeked_size_;
+  bool corrupted_;
+
+  DISALLOW_COPY_AND_ASSIGN(RingBuffer);
+};
+
+}  // namespace atom
+
+#endif  // ATOM_COMMON_RING_BUFFER_H_
@@ -0,0 +1,90 @@
+// Copyright (c) 2015 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#include "atom/common/startup_timings.h"
+
+#include <string.h>
+
+#include "base/bind.h"
+#include "base/files/file_util.h"
+#include "base/json/json_writer.h"
+#include "base/logging.h"
+#include "base/memory/scoped_ptr.h"
+#include "base/process/process_handle.h"
+#include "base/process/process_info.h"
+#include "base/threading/worker_pool.h"
+#include "base/values.h"
+
+namespace atom {
+
+namespace {
+
+base::LazyInstance<StartupTimings>::Leaky g_startup_timings =
+    LAZY_INSTANCE_INITIALIZER;
+
+void WriteTrace(const base::FilePath& path, const std::string& json) {
+  if (base::WriteFile(path, json.data(), json.size()) !=
+      static_cast<int>(json.size()))
+    LOG(ERROR) << "Failed to write startup trace to " << path.AsUTF8Unsafe();
+}
+
+}  // namespace
+
+// static
+StartupTimings* StartupTimings::GetInstance() {
+  return g_startup_timings.Pointer();
+}
+
+StartupTimings::StartupTimings() {
+  // Convert the creation time to the monotonic clock, fall back to the first
+  // record when it is not available.
+  base::TimeTicks now = base::TimeTicks::Now();
+  base::Time creation_time = base::CurrentProcessInfo::CreationTime();
+  if (creation_time.is_null())
+    origin_ = now;
+  else
+    origin_ = now - (base::Time::Now() - creation_time);
+}
+
+StartupTimings::~StartupTimings() {
+}
+
+bool StartupTimings::Record(const char* name) {
+  for (const Milestone& milestone : milestones_)
+    if (strcmp(milestone.name, name) == 0)
+      return false;
+
+  Milestone milestone = { name, base::TimeTicks::Now() };
+  milestones_.push_back(milestone);
+  return true;
+}
+
+std::string StartupTimings::ToTraceJSON() const {
+  int pid = static_cast<int>(base::GetCurrentProcId());
+  scoped_ptr<base::ListValue> events(new base::ListValue);
+  for (const Milestone& milestone : milestones_) {
+    scoped_ptr<base::DictionaryValue> event(new base::DictionaryValue);
+    event->SetString("name", milestone.name);
+    event->SetString("cat", "startup");
+    event->SetString("ph", "I");
+    event->SetString("s", "p");
+    event->SetDouble("ts", (milestone.time - origin_).InMicroseconds());
+    event->SetInteger("pid", pid);
+    event->SetInteger("tid", 0);
+    events->Append(event.release());
+  }
+
+  base::DictionaryValue trace;
+  trace.Set("traceEvents", events.release());
+  std::string json;
+  base::JSONWriter::Write(&trace, &json);
+  return json;
+}
+
+void StartupTimings::WriteTraceFile(const base::FilePath& path) const {
+  base::WorkerPool::PostTask(
+      FROM_HERE, base::Bind(&WriteTrace, path, ToTraceJSON()), true);
+}
+
+}  // namespace atom
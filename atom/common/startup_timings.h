@@ -0,0 +1,56 @@
+// Copyright (c) 2015 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#ifndef ATOM_COMMON_STARTUP_TIMINGS_H_
+#define ATOM_COMMON_STARTUP_TIMINGS_H_
+
+#include <string>
+#include <vector>
+
+#include "base/files/file_path.h"
+#include "base/lazy_instance.h"
+#include "base/time/time.h"
+
+namespace atom {
+
+// The milestones of starting current process, recorded with monotonic
+// timestamps. Only used on main thread.
+class StartupTimings {
+ public:
+  struct Milestone {
+    const char* name;
+    base::TimeTicks time;
+  };
+
+  static StartupTimings* GetInstance();
+
+  // Records that |name| is reached now, only the first time is kept, returns
+  // false if it has been recorded.
+  bool Record(const char* name);
+
+  // The time the process was created, the milestones are relative to it.
+  base::TimeTicks origin() const { return origin_; }
+  const std::vector<Milestone>& milestones() const { return milestones_; }
+
+  // Returns the milestones in the trace event format of chrome://tracing.
+  std::string ToTraceJSON() const;
+
+  // Writes the trace to |path| on a worker thread.
+  void WriteTraceFile(const base::FilePath& path) const;
+
+ private:
+  StartupTimings();
+  ~StartupTimings();
+
+  friend struct base::DefaultLazyInstanceTraits<StartupTimings>;
+
+  base::TimeTicks origin_;
+  std::vector<Milestone> milestones_;
+
+  DISALLOW_COPY_AND_ASSIGN(StartupTimings);
+};
+
+}  // namespace atom
+
+#endif  // ATOM_COMMON_STARTUP_TIMINGS_H_
@@ -4,9 +4,16 @@
 
 #include "atom/common/api/api_messages.h"
 #include "atom/common/native_mate_converters/string16_converter.h"
-#include "atom/common/native_mate_converters/value_converter.h"
+#include "atom/common/native_mate_converters/v8_value_serializer.h"
+#include "atom/common/ring_buffer.h"
+#include "atom/renderer/renderer_message_port.h"
+#include "base/memory/shared_memory.h"
+#include "content/public/renderer/render_thread.h"
 #include "content/public/renderer/render_view.h"
+#include "native_mate/arguments.h"
 #include "native_mate/dictionary.h"
+#include "native_mate/object_template_builder.h"
+#include "native_mate/wrappable.h"
 #include "third_party/WebKit/public/web/WebLocalFrame.h"
 #include "third_party/WebKit/public/web/WebView.h"
 
@@ -30,28 +37,78 @@ RenderView* GetCurrentRenderView() {
   return RenderView::FromWebView(view);
 }
 
-void Send(const base::string16& channel, const base::ListValue& arguments) {
+void Send(v8::Isolate* isolate,
+          const base::string16& channel,
+          v8::Handle<v8::Value> arguments) {
   RenderView* render_view = GetCurrentRenderView();
   if (render_view == NULL)
     return;
 
-  bool success = render_view->Send(new AtomViewHostMsg_Message(
-      render_view->GetRoutingID(), channel, arguments));
+  atom::SerializedValue args;
+  atom::SerializeV8Value(isolate, arguments, &args);
+  base::SharedMemoryHandle handle;
+  bool success;
+  // Large arguments are passed in shared memory, which the browser duplicates
+  // from this process.
+  if (args.size() > atom::kSharedMemoryThreshold &&
+      args.ShareToProcess(base::GetCurrentProcessHandle(), &handle))
+    success = render_view->Send(new AtomViewHostMsg_SharedMessage(
+        render_view->GetRoutingID(), channel, handle,
+        static_cast<uint32>(args.size())));
+  else
+    success = render_view->Send(new AtomViewHostMsg_Message(
+        render_view->GetRoutingID(), channel, args));
 
   if (!success)
     node::ThrowError("Unable to send AtomViewHostMsg_Message");
 }
 
-base::string16 SendSync(const base::string16& channel,
-                        const base::ListValue& arguments) {
+void SendBulk(v8::Isolate* isolate,
+              const base::string16& channel,
+              v8::Handle<v8::Value> arguments) {
+  RenderView* render_view = GetCurrentRenderView();
+  if (render_view == NULL)
+    return;
+
+  atom::SerializedValue args;
+  atom::SerializeV8Value(isolate, arguments, &args);
+  bool success = render_view->Send(new AtomViewHostMsg_BulkMessage(
+      render_view->GetRoutingID(), channel, args));
+
+  if (!success)
+    node::ThrowError("Unable to send AtomViewHostMsg_BulkMessage");
+}
+
+void SendToWorker(v8::Isolate* isolate,
+                  const base::string16& channel,
+                  v8::Handle<v8::Value> arguments) {
+  RenderView* render_view = GetCurrentRenderView();
+  if (render_view == NULL)
+    return;
+
+  atom::SerializedValue args;
+  atom::SerializeV8Value(isolate, arguments, &args);
+  bool success = render_view->Send(new AtomViewHostMsg_WorkerMessage(
+      render_view->GetRoutingID(), channel, args));
+
+  if (!success)
+    node::ThrowError("Unable to send AtomViewHostMsg_WorkerMessage");
+}
+
+base::string16 SendSync(v8::Isolate* isolate,
+                        const base::string16& channel,
+                        v8::Handle<v8::Value> arguments) {
   base::string16 json;
 
   RenderView* render_view = GetCurrentRenderView();
   if (render_view == NULL)
     return json;
 
+  atom::SerializedValue args;
+  atom::SerializeV8Value(isolate, arguments, &args);
+
   IPC::SyncMessage* message = new AtomViewHostMsg_Message_Sync(
-      render_view->GetRoutingID(), channel, arguments, &json);
+      render_view->GetRoutingID(), channel, args, &json);
   // Enable the UI thread in browser to receive messages.
   message->EnableMessagePumping();
   bool success = render_view->Send(message);
@@ -62,11 +119,131 @@ base::string16 SendSync(const base::string16& channel,
   return json;
 }
 
+// The writing side of a stream, records are written into the shared memory and
+// a doorbell message is only sent when the browser is waiting for data.
+class IPCStream : public mate::Wrappable {
+ public:
+  IPCStream(int routing_id,
+            int id,
+            scoped_ptr<base::SharedMemory> memory,
+            uint32 size)
+      : routing_id_(routing_id),
+        id_(id),
+        memory_(memory.Pass()),
+        ring_(new atom::RingBuffer(memory_->memory(), size)) {
+  }
+
+  bool Write(mate::Arguments* args, v8::Handle<v8::Value> data) {
+    if (!ring_) {
+      args->ThrowError("The stream has been closed");
+      return false;
+    }
+
+    bool should_ring = false;
+    bool success;
+    if (node::Buffer::HasInstance(data)) {
+      success = ring_->Write(node::Buffer::Data(data),
+                             node::Buffer::Length(data),
+                             &should_ring);
+    } else if (data->IsString()) {
+      v8::String::Utf8Value utf8(data);
+      success = ring_->Write(*utf8, utf8.length(), &should_ring);
+    } else {
+      args->ThrowError("Only Buffer and String can be written to stream");
+      return false;
+    }
+
+    if (should_ring)
+      content::RenderThread::Get()->Send(
+          new AtomViewHostMsg_StreamDoorbell(routing_id_, id_));
+    return success;
+  }
+
+  void Close() {
+    if (!ring_)
+      return;
+    ring_.reset();
+    memory_.reset();
+    content::RenderThread::Get()->Send(
+        new AtomViewHostMsg_CloseStream(routing_id_, id_));
+  }
+
+ private:
+  virtual ~IPCStream() {
+    Close();
+  }
+
+  // mate::Wrappable:
+  mate::ObjectTemplateBuilder GetObjectTemplateBuilder(v8::Isolate* isolate) {
+    return mate::ObjectTemplateBuilder(isolate)
+        .SetMethod("write", &IPCStream::Write)
+        .SetMethod("close", &IPCStream::Close);
+  }
+
+  int routing_id_;
+  int id_;
+  scoped_ptr<base::SharedMemory> memory_;
+  scoped_ptr<atom::RingBuffer> ring_;
+
+  DISALLOW_COPY_AND_ASSIGN(IPCStream);
+};
+
+v8::Handle<v8::Value> OpenStream(v8::Isolate* isolate,
+                                 const base::string16& channel,
+                                 uint32 capacity) {
+  RenderView* render_view = GetCurrentRenderView();
+  if (render_view == NULL)
+    return v8::Null(isolate);
+
+  int id = -1;
+  base::SharedMemoryHandle handle;
+  uint32 size = 0;
+  bool success = render_view->Send(new AtomViewHostMsg_OpenStream(
+      render_view->GetRoutingID(), channel, capacity, &id, &handle, &size));
+  if (!success || id < 0) {
+    node::ThrowError("Unable to open stream");
+    return v8::Null(isolate);
+  }
+
+  scoped_ptr<base::SharedMemory> memory(new base::SharedMemory(handle, false));
+  if (!memory->Map(size)) {
+    node::ThrowError("Unable to map the memory of stream");
+    return v8::Null(isolate);
+  }
+
+  return (new IPCStream(render_view->GetRoutingID(), id, memory.Pass(), size))
+      ->GetWrapper(isolate);
+}
+
+bool PostPortMessage(mate::Arguments* args,
+                     int id,
+                     v8::Handle<v8::Value> arguments) {
+  atom::RendererMessagePort* port = atom::RendererMessagePort::FromID(id);
+  if (!port) {
+    args->ThrowError("The port has been closed");
+    return false;
+  }
+
+  atom::SerializedValue value;
+  atom::SerializeV8Value(args->isolate(), arguments, &value);
+  return port->Post(static_cast<const char*>(value.pickle().data()),
+                    value.pickle().size());
+}
+
+void ClosePort(int id) {
+  atom::RendererMessagePort::Destroy(id, true);
+}
+
 void Initialize(v8::Handle<v8::Object> exports, v8::Handle<v8::Value> unused,
                 v8::Handle<v8::Context> context, void* priv) {
   mate::Dictionary dict(context->GetIsolate(), exports);
   dict.SetMethod("send", &Send);
+  dict.SetMethod("sendBulk", &SendBulk);
   dict.SetMethod("sendSync", &SendSync);
+  dict.SetMethod("sendToWorker", &SendToWorker);
+  dict.SetMethod("openStream", &OpenStream);
+  dict.SetMethod("postPortMessage", &PostPortMessage);
+  dict.SetMethod("closePort", &ClosePort);
 }
 
 }  // namespace
@@ -5,10 +5,15 @@
 #include "atom/renderer/api/atom_api_spell_check_client.h"
 
 #include <algorithm>
+#include <set>
 #include <vector>
 
 #include "atom/common/native_mate_converters/string16_converter.h"
+#include "atom/renderer/spell_check_dictionary.h"
+#include "base/bind.h"
 #include "base/logging.h"
+#include "base/stl_util.h"
+#include "base/threading/worker_pool.h"
 #include "native_mate/converter.h"
 #include "native_mate/dictionary.h"
 #include "third_party/icu/source/common/unicode/uscript.h"
@@ -23,6 +28,18 @@ namespace {
 
 const int kMaxAutoCorrectWordSize = 8;
 
+// Forget the cached results when there are too many of them.
+const size_t kMaxCachedWords = 10000;
+const size_t kMaxCachedSuggestions = 1000;
+
+const size_t kMaxSuggestions = 5;
+
+struct Word {
+  base::string16 text;
+  int start;
+  int length;
+};
+
 bool HasWordCharacters(const base::string16& text, int index) {
   const base::char16* data = text.data();
   int length = text.length();
@@ -36,23 +53,112 @@ bool HasWordCharacters(const base::string16& text, int index) {
   return false;
 }
 
+// Appends the words |iterator| finds in |text| to |words|.
+void SplitWords(SpellcheckWordIterator* iterator,
+                const base::string16& text,
+                std::vector<base::string16>* words) {
+  base::string16 word;
+  int word_start;
+  int word_length;
+  iterator->SetText(text.c_str(), text.length());
+  while (iterator->GetNextWord(&word, &word_start, &word_length))
+    words->push_back(word);
+}
+
+// Returns whether or not the given string is a valid contraction, which is a
+// fall-back when the SpellcheckWordIterator class returns a concatenated word
+// which is not in the selected dictionary (e.g. "in'n'out") but each word is
+// valid according to |is_correct|. The words are split before any of them is
+// checked, since |is_correct| may call JavaScript.
+template <typename IsCorrect>
+bool IsValidContraction(SpellcheckWordIterator* iterator,
+                        const base::string16& contraction,
+                        IsCorrect is_correct) {
+  std::vector<base::string16> words;
+  SplitWords(iterator, contraction, &words);
+  return std::all_of(words.begin(), words.end(), is_correct);
+}
+
 }  // namespace
 
-SpellCheckClient::SpellCheckClient(const std::string& language,
-                                   bool auto_spell_correct_turned_on,
-                                   v8::Isolate* isolate,
-                                   v8::Handle<v8::Object> provider)
-    : auto_spell_correct_turned_on_(auto_spell_correct_turned_on),
+// Checks a text against the dictionary on a worker thread. The word iterators
+// of the client can not be shared between threads, so it creates its own.
+class SpellCheckJob : public base::RefCountedThreadSafe<SpellCheckJob> {
+ public:
+  SpellCheckJob(const std::string& language,
+                scoped_refptr<SpellCheckDictionary> dictionary,
+                const base::string16& text)
+      : language_(language), dictionary_(dictionary), text_(text) {}
+
+  // Called on the worker thread.
+  void Run() {
+    SpellcheckCharAttribute attributes;
+    attributes.SetDefaultLanguage(language_);
+    SpellcheckWordIterator text_iterator;
+    SpellcheckWordIterator contraction_iterator;
+    if (!text_iterator.Initialize(&attributes, true) ||
+        !contraction_iterator.Initialize(&attributes, false)) {
+      VLOG(1) << "Failed to initialize SpellcheckWordIterator";
+      return;
+    }
+
+    base::string16 word;
+    int word_start;
+    int word_length;
+    auto has_word = [this](const base::string16& component) {
+      return dictionary_->HasWord(component);
+    };
+    text_iterator.SetText(text_.c_str(), text_.size());
+    while (text_iterator.GetNextWord(&word, &word_start, &word_length)) {
+      if (dictionary_->HasWord(word) ||
+          IsValidContraction(&contraction_iterator, word, has_word))
+        continue;
+      Word misspelling = { word, word_start, word_length };
+      misspellings_.push_back(misspelling);
+    }
+  }
+
+  const std::vector<Word>& misspellings() const { return misspellings_; }
+
+ private:
+  friend class base::RefCountedThreadSafe<SpellCheckJob>;
+  ~SpellCheckJob() {}
+
+  std::string language_;
+  scoped_refptr<SpellCheckDictionary> dictionary_;
+  base::string16 text_;
+
+  std::vector<Word> misspellings_;
+
+  DISALLOW_COPY_AND_ASSIGN(SpellCheckJob);
+};
+
+SpellCheckClient::SpellCheckClient(
+    const std::string& language,
+    bool auto_spell_correct_turned_on,
+    v8::Isolate* isolate,
+    v8::Handle<v8::Object> provider,
+    scoped_refptr<SpellCheckDictionary> dictionary)
+    : language_(language),
+      auto_spell_correct_turned_on_(auto_spell_correct_turned_on),
       isolate_(isolate),
-      provider_(isolate, provider) {
+      provider_(isolate, provider),
+      dictionary_(dictionary),
+      weak_factory_(this) {
   character_attributes_.SetDefaultLanguage(language);
 
   // Persistent the method.
   mate::Dictionary dict(isolate, provider);
   dict.Get("spellCheck", &spell_check_);
+  dict.Get("spellCheckWords", &spell_check_words_);
 }
 
-SpellCheckClient::~SpellCheckClient() {}
+SpellCheckClient::~SpellCheckClient() {
+  // Blink waits for the checks handed to the worker, while their replies
+  // would never arrive.
+  for (blink::WebTextCheckingCompletion* completion : pending_completions_)
+    completion->didCancelCheckingText();
+}
 
 void SpellCheckClient::spellCheck(
     const blink::WebString& text,
@@ -64,6 +170,15 @@ void SpellCheckClient::spellCheck(
   if (results.size() == 1) {
     misspelling_start = results[0].location;
     misspelling_len = results[0].length;
+
+    if (optional_suggestions && dictionary_.get()) {
+      base::string16 word = base::string16(text).substr(misspelling_start,
+                                                        misspelling_len);
+      std::vector<blink::WebString> suggestions;
+      for (const base::string16& suggestion : GetSuggestions(word))
+        suggestions.push_back(suggestion);
+      *optional_suggestions = suggestions;
+    }
   }
 }
 
@@ -91,6 +206,21 @@ void SpellCheckClient::requestCheckingOfText(
     return;
   }
 
+  // Checking against only the dictionary does not need the main thread.
+  if (dictionary_.get() && spell_check_.IsEmpty() &&
+      spell_check_words_.IsEmpty()) {
+    scoped_refptr<SpellCheckJob> job(
+        new SpellCheckJob(language_, dictionary_, text));
+    pending_completions_.insert(completionCallback);
+    base::WorkerPool::PostTaskAndReply(
+        FROM_HERE,
+        base::Bind(&SpellCheckJob::Run, job),
+        base::Bind(&SpellCheckClient::OnWorkerCheckDone,
+                   weak_factory_.GetWeakPtr(), job, completionCallback),
+        false);
+    return;
+  }
+
   std::vector<blink::WebTextCheckingResult> results;
   SpellCheckText(text, false, &results);
   completionCallback->didFinishCheckingText(results);
@@ -115,16 +245,28 @@ void SpellCheckClient::updateSpellingUIWithMisspelledWord(
     const blink::WebString& word) {
 }
 
+void SpellCheckClient::OnWorkerCheckDone(
+    scoped_refptr<SpellCheckJob> job,
+    blink::WebTextCheckingCompletion* completion) {
+  pending_completions_.erase(completion);
+  std::vector<blink::WebTextCheckingResult> results;
+  for (const Word& word : job->misspellings()) {
+    blink::WebTextCheckingResult result;
+    result.location = word.start;
+    result.length = word.length;
+    results.push_back(result);
+  }
+  completion->didFinishCheckingText(results);
+}
+
 void SpellCheckClient::SpellCheckText(
     const base::string16& text,
     bool stop_at_first_result,
     std::vector<blink::WebTextCheckingResult>* results) {
-  if (text.length() == 0 || spell_check_.IsEmpty())
+  if (text.length() == 0 ||
+      (!dictionary_ && spell_check_.IsEmpty() && spell_check_words_.IsEmpty()))
     return;
 
-  base::string16 word;
-  int word_start;
-  int word_length;
   if (!text_iterator_.IsInitialized() &&
       !text_iterator_.Initialize(&character_attributes_, true)) {
       // We failed to initialize text_iterator_, return as spelled correctly.
@@ -132,42 +274,113 @@ void SpellCheckClient::SpellCheckText(
       return;
   }
 
+  std::vector<Word> words;
+  Word current;
   base::string16 in_word(text);
   text_iterator_.SetText(in_word.c_str(), in_word.size());
-  while (text_iterator_.GetNextWord(&word, &word_start, &word_length)) {
+  while (text_iterator_.GetNextWord(&current.text, &current.start,
+                                    &current.length))
+    words.push_back(current);
+
+  // Ask JavaScript about all the words which may be checked at once, which
+  // includes the components of contractions.
+  if (!spell_check_words_.IsEmpty()) {
+    std::set<base::string16> unique_words;
+    std::vector<base::string16> components;
+    for (const Word& word : words) {
+      if (dictionary_.get() && dictionary_->HasWord(word.text))
+        continue;
+      components.clear();
+      components.push_back(word.text);
+      SplitContraction(word.text, &components);
+      for (const base::string16& component : components)
+        if (!ContainsKey(word_cache_, component))
+          unique_words.insert(component);
+    }
+    SpellCheckWords(std::vector<base::string16>(unique_words.begin(),
+                                                unique_words.end()));
+  }
+
+  for (const Word& word : words) {
     // Found a word (or a contraction) that the spellchecker can check the
     // spelling of.
-    if (SpellCheckWord(word))
+    if (SpellCheckWord(word.text))
       continue;
 
     // If the given word is a concatenated word of two or more valid words
     // (e.g. "hello:hello"), we should treat it as a valid word.
-    if (IsValidContraction(word))
+    if (IsValidContraction(word.text))
       continue;
 
     blink::WebTextCheckingResult result;
-    result.location = word_start;
-    result.length = word_length;
+    result.location = word.start;
+    result.length = word.length;
     results->push_back(result);
 
     if (stop_at_first_result)
-      return;
+      break;
   }
 }
 
 bool SpellCheckClient::SpellCheckWord(const base::string16& word_to_check) {
-  if (spell_check_.IsEmpty())
+  if (dictionary_.get() && dictionary_->HasWord(word_to_check))
     return true;
 
+  std::map<base::string16, bool>::const_iterator iter =
+      word_cache_.find(word_to_check);
+  if (iter != word_cache_.end())
+    return iter->second;
+
+  // Without a JavaScript provider the dictionary has the final word.
+  if (spell_check_.IsEmpty())
+    return !dictionary_.get();
+
   v8::HandleScope handle_scope(isolate_);
   v8::Handle<v8::Value> word = mate::ConvertToV8(isolate_, word_to_check);
   v8::Handle<v8::Value> result = spell_check_.NewHandle()->Call(
       provider_.NewHandle(), 1, &word);
 
-  if (result->IsBoolean())
-    return result->BooleanValue();
-  else
-    return true;
+  bool correct = !result->IsBoolean() || result->BooleanValue();
+  if (word_cache_.size() >= kMaxCachedWords)
+    word_cache_.clear();
+  word_cache_[word_to_check] = correct;
+  return correct;
+}
+
+void SpellCheckClient::SpellCheckWords(
+    const std::vector<base::string16>& words) {
+  if (words.empty())
+    return;
+
+  v8::HandleScope handle_scope(isolate_);
+  v8::Handle<v8::Value> array = mate::ConvertToV8(isolate_, words);
+  v8::Handle<v8::Value> result = spell_check_words_.NewHandle()->Call(
+      provider_.NewHandle(), 1, &array);
+
+  // Words without a boolean result are treated as correctly spelled.
+  if (!result->IsArray())
+    return;
+  if (word_cache_.size() + words.size() > kMaxCachedWords)
+    word_cache_.clear();
+  v8::Handle<v8::Array> results = v8::Handle<v8::Array>::Cast(result);
+  for (size_t i = 0; i < words.size(); ++i) {
+    v8::Handle<v8::Value> value = results->Get(static_cast<uint32>(i));
+    word_cache_[words[i]] = !value->IsBoolean() || value->BooleanValue();
+  }
+}
+
+std::vector<base::string16> SpellCheckClient::GetSuggestions(
+    const base::string16& word) {
+  SuggestionsCache::iterator iter = suggestions_cache_.find(word);
+  if (iter != suggestions_cache_.end())
+    return iter->second;
+
+  if (suggestions_cache_.size() >= kMaxCachedSuggestions)
+    suggestions_cache_.clear();
+  std::vector<base::string16>& suggestions = suggestions_cache_[word];
+  if (dictionary_.get())
+    suggestions = dictionary_->GetSuggestions(word, kMaxSuggestions);
+  return suggestions;
 }
 
 base::string16 SpellCheckClient::GetAutoCorrectionWord(
@@ -178,6 +391,34 @@ base::string16 SpellCheckClient::GetAutoCorrectionWord(
   if (word_length < 2 || word_length > kMaxAutoCorrectWordSize)
     return autocorrect_word;
 
+  std::vector<base::string16> swapped_words;
+  for (int i = 0; i < word_length - 1; i++) {
+    swapped_words.push_back(word);
+    std::swap(swapped_words[i][i], swapped_words[i][i + 1]);
+  }
+
+  // The dictionary decides without calling JavaScript.
+  if (dictionary_.get()) {
+    for (const base::string16& swapped_word : swapped_words) {
+      if (!dictionary_->HasWord(swapped_word))
+        continue;
+      if (!autocorrect_word.empty())
+        return base::string16();
+      autocorrect_word = swapped_word;
+    }
+    return autocorrect_word;
+  }
+
+  // Ask JavaScript about all the candidates at once, spellCheck below would
+  // then find them in the cache.
+  if (!spell_check_words_.IsEmpty()) {
+    std::vector<base::string16> unchecked;
+    for (const base::string16& swapped_word : swapped_words)
+      if (!ContainsKey(word_cache_, swapped_word))
+        unchecked.push_back(swapped_word);
+    SpellCheckWords(unchecked);
+  }
+
   base::char16 misspelled_word[kMaxAutoCorrectWordSize + 1];
   const base::char16* word_char = word.c_str();
   for (int i = 0; i <= kMaxAutoCorrectWordSize; ++i) {
@@ -217,27 +458,29 @@ base::string16 SpellCheckClient::GetAutoCorrectionWord(
   return autocorrect_word;
 }
 
-// Returns whether or not the given string is a valid contraction.
-// This function is a fall-back when the SpellcheckWordIterator class
-// returns a concatenated word which is not in the selected dictionary
-// (e.g. "in'n'out") but each word is valid.
 bool SpellCheckClient::IsValidContraction(const base::string16& contraction) {
-  if (!contraction_iterator_.IsInitialized() &&
-      !contraction_iterator_.Initialize(&character_attributes_, false)) {
-    // We failed to initialize the word iterator, return as spelled correctly.
-    VLOG(1) << "Failed to initialize contraction_iterator_";
+  // We failed to initialize the word iterator, return as spelled correctly.
+  if (!InitializeContractionIterator())
     return true;
-  }
 
-  contraction_iterator_.SetText(contraction.c_str(), contraction.length());
+  return api::IsValidContraction(
+      &contraction_iterator_, contraction,
+      [this](const base::string16& word) { return SpellCheckWord(word); });
+}
 
-  base::string16 word;
-  int word_start;
-  int word_length;
+bool SpellCheckClient::SplitContraction(const base::string16& contraction,
+                                        std::vector<base::string16>* words) {
+  if (!InitializeContractionIterator())
+    return false;
+  SplitWords(&contraction_iterator_, contraction, words);
+  return true;
+}
 
-  while (contraction_iterator_.GetNextWord(&word, &word_start, &word_length)) {
-    if (!SpellCheckWord(word))
-      return false;
+bool SpellCheckClient::InitializeContractionIterator() {
+  if (!contraction_iterator_.IsInitialized() &&
+      !contraction_iterator_.Initialize(&character_attributes_, false)) {
+    VLOG(1) << "Failed to initialize contraction_iterator_";
+    return false;
   }
   return true;
 }
@@ -5,26 +5,47 @@
 #ifndef ATOM_RENDERER_API_ATOM_API_SPELL_CHECK_CLIENT_H_
 #define ATOM_RENDERER_API_ATOM_API_SPELL_CHECK_CLIENT_H_
 
+#include <map>
+#include <set>
 #include <string>
 #include <vector>
 
 #include "base/callback.h"
+#include "base/memory/ref_counted.h"
+#include "base/memory/weak_ptr.h"
 #include "chrome/renderer/spellchecker/spellcheck_worditerator.h"
 #include "native_mate/scoped_persistent.h"
 #include "third_party/WebKit/public/web/WebSpellCheckClient.h"
 
 namespace atom {
 
+class SpellCheckDictionary;
+
 namespace api {
 
+class SpellCheckJob;
+
 class SpellCheckClient : public blink::WebSpellCheckClient {
  public:
+  // The words in |dictionary| are treated as correctly spelled without
+  // calling the |spellCheck| method of |provider|, which is only asked about
+  // the other words when it exists. When |provider| has a |spellCheckWords|
+  // method, it is called once for all the words of a text instead.
+  //
+  // With only a dictionary the requested checks run on a worker thread,
+  // otherwise they run on the main thread since they call JavaScript.
   SpellCheckClient(const std::string& language,
                    bool auto_spell_correct_turned_on,
                    v8::Isolate* isolate,
-                   v8::Handle<v8::Object> provider);
+                   v8::Handle<v8::Object> provider,
+                   scoped_refptr<SpellCheckDictionary> dictionary);
   virtual ~SpellCheckClient();
 
+  // Returns the words in the dictionary close to |word|, empty when there is
+  // no dictionary.
+  std::vector<base::string16> GetSuggestions(
+      const base::string16& word);
+
  private:
   // blink::WebSpellCheckClient:
   void spellCheck(
@@ -48,14 +69,23 @@ class SpellCheckClient : public blink::WebSpellCheckClient {
   void updateSpellingUIWithMisspelledWord(
       const blink::WebString& word) override;
 
+  // Called on main thread when the worker has checked a requested text.
+  void OnWorkerCheckDone(scoped_refptr<SpellCheckJob> job,
+                         blink::WebTextCheckingCompletion* completion);
+
   // Check the spelling of text.
   void SpellCheckText(const base::string16& text,
                       bool stop_at_first_result,
                       std::vector<blink::WebTextCheckingResult>* results);
 
-  // Call JavaScript to check spelling a word.
+  // Looks up the dictionary, and then call JavaScript to check spelling a
+  // word.
   bool SpellCheckWord(const base::string16& word_to_check);
 
+  // Calls JavaScript once to check spelling all of |words|, the results are
+  // kept in |word_cache_| for SpellCheckWord.
+  void SpellCheckWords(const std::vector<base::string16>& words);
+
   // Find a possible correctly spelled word for a misspelled word. Computes an
   // empty string if input misspelled word is too long, there is ambiguity, or
   // the correct spelling cannot be determined.
@@ -65,6 +95,12 @@ class SpellCheckClient : public blink::WebSpellCheckClient {
   // (e.g. "word:word").
   bool IsValidContraction(const base::string16& word);
 
+  // Splits a concatenated word into its components, returns false when the
+  // word iterator can not be initialized.
+  bool SplitContraction(const base::string16& contraction,
+                        std::vector<base::string16>* words);
+  bool InitializeContractionIterator();
+
   // Represents character attributes used for filtering out characters which
   // are not supported by this SpellCheck object.
   SpellcheckCharAttribute character_attributes_;
@@ -77,11 +113,29 @@ class SpellCheckClient : public blink::WebSpellCheckClient {
   SpellcheckWordIterator text_iterator_;
   SpellcheckWordIterator contraction_iterator_;
 
+  std::string language_;
   bool auto_spell_correct_turned_on_;
 
   v8::Isolate* isolate_;
   mate::ScopedPersistent<v8::Object> provider_;
   mate::ScopedPersistent<v8::Function> spell_check_;
+  mate::ScopedPersistent<v8::Function> spell_check_words_;
+
+  // The results of JavaScript for the words checked recently, so checking an
+  // edited paragraph again only calls JavaScript for the changed words.
+  std::map<base::string16, bool> word_cache_;
+
+  typedef std::map<base::string16, std::vector<base::string16>>
+      SuggestionsCache;
+  SuggestionsCache suggestions_cache_;
+
+  scoped_refptr<SpellCheckDictionary> dictionary_;
+
+  // The requests being checked on the worker, they are canceled when we go
+  // away before the worker replies.
+  std::set<blink::WebTextCheckingCompletion*> pending_completions_;
+
+  base::WeakPtrFactory<SpellCheckClient> weak_factory_;
 
   DISALLOW_COPY_AND_ASSIGN(SpellCheckClient);
 };
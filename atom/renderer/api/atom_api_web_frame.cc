@@ -10,8 +10,10 @@
 #define USE(WTF_FEATURE) (defined WTF_USE_##WTF_FEATURE  && WTF_USE_##WTF_FEATURE)  // NOLINT
 #define ENABLE(WTF_FEATURE) (defined ENABLE_##WTF_FEATURE  && ENABLE_##WTF_FEATURE)  // NOLINT
 
+#include "atom/common/native_mate_converters/file_path_converter.h"
 #include "atom/common/native_mate_converters/string16_converter.h"
 #include "atom/renderer/api/atom_api_spell_check_client.h"
+#include "atom/renderer/spell_check_dictionary.h"
 #include "content/public/renderer/render_frame.h"
 #include "native_mate/dictionary.h"
 #include "native_mate/object_template_builder.h"
@@ -86,16 +88,37 @@ void WebFrame::SetSpellCheckProvider(mate::Arguments* args,
                                      const std::string& language,
                                      bool auto_spell_correct_turned_on,
                                      v8::Handle<v8::Object> provider) {
-  if (!provider->Has(mate::StringToV8(args->isolate(), "spellCheck"))) {
-    args->ThrowError("\"spellCheck\" has to be defined");
+  mate::Dictionary dict(args->isolate(), provider);
+  base::FilePath dictionary_path;
+  if (!dict.Get("dictionary", &dictionary_path) &&
+      !provider->Has(mate::StringToV8(args->isolate(), "spellCheck")) &&
+      !provider->Has(mate::StringToV8(args->isolate(), "spellCheckWords"))) {
+    args->ThrowError("\"spellCheck\" or \"dictionary\" has to be defined");
     return;
   }
 
+  scoped_refptr<SpellCheckDictionary> dictionary;
+  if (!dictionary_path.empty()) {
+    dictionary = SpellCheckDictionary::Load(dictionary_path);
+    if (!dictionary.get()) {
+      args->ThrowError("Unable to load dictionary");
+      return;
+    }
+  }
+
   spell_check_client_.reset(new SpellCheckClient(
-      language, auto_spell_correct_turned_on, args->isolate(), provider));
+      language, auto_spell_correct_turned_on, args->isolate(), provider,
+      dictionary));
   web_frame_->view()->setSpellCheckClient(spell_check_client_.get());
 }
 
+std::vector<base::string16> WebFrame::GetSpellingSuggestions(
+    const base::string16& word) {
+  if (!spell_check_client_)
+    return std::vector<base::string16>();
+  return spell_check_client_->GetSuggestions(word);
+}
+
 mate::ObjectTemplateBuilder WebFrame::GetObjectTemplateBuilder(
     v8::Isolate* isolate) {
   return mate::ObjectTemplateBuilder(isolate)
@@ -108,6 +131,7 @@ mate::ObjectTemplateBuilder WebFrame::GetObjectTemplateBuilder(
                  &WebFrame::RegisterEmbedderCustomElement)
       .SetMethod("attachGuest", &WebFrame::AttachGuest)
       .SetMethod("setSpellCheckProvider", &WebFrame::SetSpellCheckProvider)
+      .SetMethod("getSpellingSuggestions", &WebFrame::GetSpellingSuggestions)
       .SetMethod("registerUrlSchemeAsSecure",
                  &blink::SchemeRegistry::registerURLSchemeAsSecure);
 }
@@ -6,6 +6,7 @@
 #define ATOM_RENDERER_API_ATOM_API_WEB_FRAME_H_
 
 #include <string>
+#include <vector>
 
 #include "base/memory/scoped_ptr.h"
 #include "native_mate/handle.h"
@@ -50,6 +51,11 @@ class WebFrame : public mate::Wrappable {
                              bool auto_spell_correct_turned_on,
                              v8::Handle<v8::Object> provider);
 
+  // Returns the corrections of |word| in the dictionary of spell check
+  // provider.
+  std::vector<base::string16> GetSpellingSuggestions(
+      const base::string16& word);
+
   // mate::Wrappable:
   virtual mate::ObjectTemplateBuilder GetObjectTemplateBuilder(
       v8::Isolate* isolate);
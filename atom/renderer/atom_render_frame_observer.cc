@@ -0,0 +1,24 @@
+// Copyright (c) 2015 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#include "atom/renderer/atom_render_frame_observer.h"
+
+#include "atom/renderer/atom_renderer_client.h"
+
+namespace atom {
+
+AtomRenderFrameObserver::AtomRenderFrameObserver(
+    content::RenderFrame* render_frame,
+    AtomRendererClient* renderer_client)
+    : content::RenderFrameObserver(render_frame),
+      renderer_client_(renderer_client) {
+}
+
+void AtomRenderFrameObserver::WillReleaseScriptContext(
+    v8::Handle<v8::Context> context,
+    int world_id) {
+  renderer_client_->WillReleaseScriptContext(context);
+}
+
+}  // namespace atom
@@ -8,18 +8,26 @@
 #include <vector>
 
 #include "atom/common/api/api_messages.h"
+#include "atom/common/api/channel_name_cache.h"
+#include "atom/common/crash_reporter/breadcrumbs.h"
 #include "atom/common/native_mate_converters/string16_converter.h"
-#include "atom/common/native_mate_converters/value_converter.h"
+#include "atom/common/native_mate_converters/v8_value_serializer.h"
 #include "atom/common/options_switches.h"
 #include "atom/renderer/atom_renderer_client.h"
+#include "atom/renderer/renderer_message_port.h"
+#include "base/bind.h"
 #include "base/command_line.h"
+#include "base/debug/trace_event.h"
+#include "base/message_loop/message_loop.h"
 #include "base/strings/string_number_conversions.h"
+#include "base/strings/utf_string_conversions.h"
 #include "content/public/renderer/render_view.h"
 #include "ipc/ipc_message_macros.h"
 #include "third_party/WebKit/public/web/WebDraggableRegion.h"
 #include "third_party/WebKit/public/web/WebDocument.h"
 #include "third_party/WebKit/public/web/WebFrame.h"
 #include "third_party/WebKit/public/web/WebLocalFrame.h"
+#include "third_party/WebKit/public/web/WebScriptSource.h"
 #include "third_party/WebKit/public/web/WebKit.h"
 #include "third_party/WebKit/public/web/WebView.h"
 
@@ -29,6 +37,17 @@ namespace atom {
 
 namespace {
 
+// Records the message of an exception thrown by a script of
+// webContents.executeJavaScriptBatch.
+void OnScriptMessage(v8::Handle<v8::Message> message,
+                     v8::Handle<v8::Value> data) {
+  base::string16* error =
+      static_cast<base::string16*>(v8::External::Cast(*data)->Value());
+  if (error->empty() &&
+      !mate::ConvertFromV8(v8::Isolate::GetCurrent(), message->Get(), error))
+    *error = base::ASCIIToUTF16("Uncaught exception");
+}
+
 bool GetIPCObject(v8::Isolate* isolate,
                   v8::Handle<v8::Context> context,
                   v8::Handle<v8::Object>* ipc) {
@@ -40,13 +59,49 @@ bool GetIPCObject(v8::Isolate* isolate,
   return true;
 }
 
-std::vector<v8::Handle<v8::Value>> ListValueToVector(
-    v8::Isolate* isolate,
-    const base::ListValue& list) {
-  v8::Handle<v8::Value> array = mate::ConvertToV8(isolate, list);
-  std::vector<v8::Handle<v8::Value>> result;
-  mate::ConvertFromV8(isolate, array, &result);
-  return result;
+// Whether the page listens to |channel|, which is assumed when the channels
+// are not tracked.
+bool HasIPCListener(v8::Isolate* isolate,
+                    v8::Handle<v8::Context> context,
+                    v8::Handle<v8::String> channel) {
+  v8::Handle<v8::Object> ipc;
+  if (!GetIPCObject(isolate, context, &ipc))
+    return false;
+  v8::Handle<v8::Value> channels =
+      ipc->GetHiddenValue(mate::StringToV8(isolate, "channels"));
+  if (channels.IsEmpty() || !channels->IsObject())
+    return true;
+  return channels->ToObject()->Has(channel);
+}
+
+void EmitIPCEvent(v8::Isolate* isolate,
+                  v8::Handle<v8::Context> context,
+                  std::vector<v8::Handle<v8::Value>>* arguments) {
+  v8::Handle<v8::Object> ipc;
+  if (GetIPCObject(isolate, context, &ipc))
+    node::MakeCallback(isolate, ipc, "emit", arguments->size(),
+                       &arguments->front());
+}
+
+// The bulk messages emitted in one task.
+const int kBulkMessagesPerTask = 16;
+
+// The views in this process and how many of them are suspended. Blink can only
+// suspend all pages of a process together, so this is done only when every
+// view has been asked to.
+int g_view_count = 0;
+int g_suspended_view_count = 0;
+bool g_pages_suspended = false;
+
+void UpdatePagesSuspended() {
+  bool suspended = g_view_count > 0 && g_suspended_view_count == g_view_count;
+  if (suspended == g_pages_suspended)
+    return;
+  g_pages_suspended = suspended;
+  if (suspended)
+    blink::WebView::willEnterModalLoop();
+  else
+    blink::WebView::didExitModalLoop();
 }
 
 }  // namespace
@@ -56,10 +111,19 @@ AtomRenderViewObserver::AtomRenderViewObserver(
     AtomRendererClient* renderer_client)
     : content::RenderViewObserver(render_view),
       renderer_client_(renderer_client),
-      document_created_(false) {
+      document_created_(false),
+      page_suspended_(false),
+      bulk_messages_scheduled_(false),
+      weak_factory_(this) {
+  ++g_view_count;
+  UpdatePagesSuspended();
 }
 
 AtomRenderViewObserver::~AtomRenderViewObserver() {
+  if (page_suspended_)
+    --g_suspended_view_count;
+  --g_view_count;
+  UpdatePagesSuspended();
 }
 
 void AtomRenderViewObserver::DidCreateDocumentElement(
@@ -88,29 +152,61 @@ void AtomRenderViewObserver::DraggableRegionsChanged(blink::WebFrame* frame) {
     region.draggable = webregions[i].draggable;
     regions.push_back(region);
   }
-  Send(new AtomViewHostMsg_UpdateDraggableRegions(routing_id(), regions));
+
+  // Pages send this on every layout, skip it when nothing has changed.
+  size_t kept = 0;
+  while (kept < regions.size() && kept < draggable_regions_.size() &&
+         regions[kept] == draggable_regions_[kept])
+    ++kept;
+  if (kept == regions.size() && kept == draggable_regions_.size())
+    return;
+
+  std::vector<DraggableRegion> changed(regions.begin() + kept, regions.end());
+  draggable_regions_.swap(regions);
+  Send(new AtomViewHostMsg_UpdateDraggableRegions(
+      routing_id(), static_cast<uint32>(kept), changed));
 }
 
 bool AtomRenderViewObserver::OnMessageReceived(const IPC::Message& message) {
   bool handled = true;
   IPC_BEGIN_MESSAGE_MAP(AtomRenderViewObserver, message)
     IPC_MESSAGE_HANDLER(AtomViewMsg_Message, OnBrowserMessage)
+    IPC_MESSAGE_HANDLER(AtomViewMsg_SharedMessage, OnBrowserSharedMessage)
+    IPC_MESSAGE_HANDLER(AtomViewMsg_BulkMessage, OnBrowserBulkMessage)
+    IPC_MESSAGE_HANDLER(AtomViewMsg_OpenPort, OnOpenPort)
+    IPC_MESSAGE_HANDLER(AtomViewMsg_PortDoorbell, OnPortDoorbell)
+    IPC_MESSAGE_HANDLER(AtomViewMsg_ClosePort, OnClosePort)
+    IPC_MESSAGE_HANDLER(AtomViewMsg_SetPageSuspended, OnSetPageSuspended)
+    IPC_MESSAGE_HANDLER(AtomViewMsg_ExecuteScripts, OnExecuteScripts)
     IPC_MESSAGE_UNHANDLED(handled = false)
   IPC_END_MESSAGE_MAP()
 
   return handled;
 }
 
-void AtomRenderViewObserver::OnBrowserMessage(const base::string16& channel,
-                                              const base::ListValue& args) {
+blink::WebFrame* AtomRenderViewObserver::GetMainFrame() {
   if (!document_created_)
-    return;
+    return NULL;
 
   if (!render_view()->GetWebView())
-    return;
+    return NULL;
 
   blink::WebFrame* frame = render_view()->GetWebView()->mainFrame();
   if (!frame || frame->isWebRemoteFrame())
+    return NULL;
+
+  // Messages are dispatched by the ipc module of node environment.
+  renderer_client_->EnsureNodeEnvironment();
+  return frame;
+}
+
+void AtomRenderViewObserver::OnBrowserMessage(const base::string16& channel,
+                                              const SerializedValue& args) {
+  TRACE_EVENT1("atom", "AtomRenderViewObserver::OnBrowserMessage",
+               "channel", base::UTF16ToUTF8(channel));
+  crash_reporter::Breadcrumbs::Add("ipc", channel);
+  blink::WebFrame* frame = GetMainFrame();
+  if (!frame)
     return;
 
   v8::Isolate* isolate = blink::mainThreadIsolate();
@@ -119,13 +215,213 @@ void AtomRenderViewObserver::OnBrowserMessage(const base::string16& channel,
   v8::Local<v8::Context> context = frame->mainWorldScriptContext();
   v8::Context::Scope context_scope(context);
 
-  std::vector<v8::Handle<v8::Value>> arguments = ListValueToVector(
-      isolate, args);
-  arguments.insert(arguments.begin(), mate::ConvertToV8(isolate, channel));
+  // Broadcasts reach many pages that do not care about them.
+  v8::Local<v8::String> channel_name = GetChannelName(isolate, channel);
+  if (!HasIPCListener(isolate, context, channel_name))
+    return;
+
+  v8::Local<v8::Value> array = DeserializeV8Value(isolate, args);
+  std::vector<v8::Handle<v8::Value>> arguments;
+  if (array.IsEmpty() || !mate::ConvertFromV8(isolate, array, &arguments))
+    return;
+  arguments.insert(arguments.begin(), channel_name);
+  EmitIPCEvent(isolate, context, &arguments);
+}
 
-  v8::Handle<v8::Object> ipc;
-  if (GetIPCObject(isolate, context, &ipc))
-    node::MakeCallback(isolate, ipc, "emit", arguments.size(), &arguments[0]);
+void AtomRenderViewObserver::OnBrowserSharedMessage(
+    const base::string16& channel,
+    base::SharedMemoryHandle handle,
+    uint32 size) {
+  scoped_ptr<base::SharedMemory> memory(new base::SharedMemory(handle, true));
+  SerializedValue args;
+  if (!args.InitFromSharedMemory(memory.Pass(), size))
+    return;
+  OnBrowserMessage(channel, args);
+}
+
+void AtomRenderViewObserver::OnBrowserBulkMessage(
+    const base::string16& channel,
+    const SerializedValue& args) {
+  // The |args| only refers to the message, which is gone after dispatching.
+  linked_ptr<BulkMessage> message(new BulkMessage);
+  message->channel = channel;
+  message->args.CopyFrom(args);
+  bulk_messages_.push_back(message);
+  if (bulk_messages_scheduled_)
+    return;
+
+  // Same with the browser, the messages already queued are emitted first.
+  bulk_messages_scheduled_ = true;
+  base::MessageLoop::current()->PostTask(
+      FROM_HERE,
+      base::Bind(&AtomRenderViewObserver::EmitBulkMessages,
+                 weak_factory_.GetWeakPtr()));
+}
+
+void AtomRenderViewObserver::EmitBulkMessages() {
+  bulk_messages_scheduled_ = false;
+
+  for (int i = 0; i < kBulkMessagesPerTask && !bulk_messages_.empty(); ++i) {
+    linked_ptr<BulkMessage> message = bulk_messages_.front();
+    bulk_messages_.pop_front();
+    OnBrowserMessage(message->channel, message->args);
+  }
+
+  if (!bulk_messages_.empty() && !bulk_messages_scheduled_) {
+    bulk_messages_scheduled_ = true;
+    base::MessageLoop::current()->PostTask(
+        FROM_HERE,
+        base::Bind(&AtomRenderViewObserver::EmitBulkMessages,
+                   weak_factory_.GetWeakPtr()));
+  }
+}
+
+void AtomRenderViewObserver::OnOpenPort(int id,
+                                        const base::string16& channel,
+                                        base::SharedMemoryHandle handle,
+                                        uint32 size) {
+  if (!RendererMessagePort::Create(routing_id(), id, handle, size)) {
+    Send(new AtomViewHostMsg_ClosePort(routing_id(), id));
+    return;
+  }
+
+  // Nobody would receive the port.
+  blink::WebFrame* frame = GetMainFrame();
+  if (!frame) {
+    RendererMessagePort::Destroy(id, true);
+    return;
+  }
+
+  v8::Isolate* isolate = blink::mainThreadIsolate();
+  v8::HandleScope handle_scope(isolate);
+
+  v8::Local<v8::Context> context = frame->mainWorldScriptContext();
+  v8::Context::Scope context_scope(context);
+
+  std::vector<v8::Handle<v8::Value>> arguments;
+  arguments.push_back(mate::StringToV8(isolate, "ATOM_MESSAGE_PORT"));
+  arguments.push_back(mate::ConvertToV8(isolate, channel));
+  arguments.push_back(v8::Integer::New(isolate, id));
+  EmitIPCEvent(isolate, context, &arguments);
+}
+
+void AtomRenderViewObserver::OnPortDoorbell(int id) {
+  RendererMessagePort* port = RendererMessagePort::FromID(id);
+  if (!port)
+    return;
+
+  std::vector<std::string> messages;
+  bool success = port->Drain(&messages);
+  if (!success)
+    RendererMessagePort::Destroy(id, true);
+
+  blink::WebFrame* frame = GetMainFrame();
+  if (!frame)
+    return;
+
+  v8::Isolate* isolate = blink::mainThreadIsolate();
+  v8::HandleScope handle_scope(isolate);
+
+  v8::Local<v8::Context> context = frame->mainWorldScriptContext();
+  v8::Context::Scope context_scope(context);
+
+  v8::Handle<v8::String> name = GetChannelName(
+      isolate, base::ASCIIToUTF16("ATOM_PORT_MESSAGE"));
+  for (const std::string& message : messages) {
+    SerializedValue value;
+    if (!value.InitFromData(message.data(), static_cast<int>(message.size())))
+      continue;
+    v8::Local<v8::Value> args = DeserializeV8Value(isolate, value);
+    if (args.IsEmpty())
+      continue;
+
+    std::vector<v8::Handle<v8::Value>> arguments;
+    arguments.push_back(name);
+    arguments.push_back(v8::Integer::New(isolate, id));
+    arguments.push_back(args);
+    EmitIPCEvent(isolate, context, &arguments);
+  }
+
+  if (!success) {
+    std::vector<v8::Handle<v8::Value>> arguments;
+    arguments.push_back(mate::StringToV8(isolate, "ATOM_PORT_CLOSED"));
+    arguments.push_back(v8::Integer::New(isolate, id));
+    EmitIPCEvent(isolate, context, &arguments);
+  }
+}
+
+void AtomRenderViewObserver::OnClosePort(int id) {
+  if (!RendererMessagePort::FromID(id))
+    return;
+  RendererMessagePort::Destroy(id, false);
+
+  blink::WebFrame* frame = GetMainFrame();
+  if (!frame)
+    return;
+
+  v8::Isolate* isolate = blink::mainThreadIsolate();
+  v8::HandleScope handle_scope(isolate);
+
+  v8::Local<v8::Context> context = frame->mainWorldScriptContext();
+  v8::Context::Scope context_scope(context);
+
+  std::vector<v8::Handle<v8::Value>> arguments;
+  arguments.push_back(mate::StringToV8(isolate, "ATOM_PORT_CLOSED"));
+  arguments.push_back(v8::Integer::New(isolate, id));
+  EmitIPCEvent(isolate, context, &arguments);
+}
+
+void AtomRenderViewObserver::OnSetPageSuspended(bool suspended) {
+  if (suspended == page_suspended_)
+    return;
+  page_suspended_ = suspended;
+  g_suspended_view_count += suspended ? 1 : -1;
+  UpdatePagesSuspended();
+}
+
+void AtomRenderViewObserver::OnExecuteScripts(
+    int request_id, const std::vector<base::string16>& scripts) {
+  TRACE_EVENT1("atom", "AtomRenderViewObserver::OnExecuteScripts",
+               "count", scripts.size());
+  v8::Isolate* isolate = blink::mainThreadIsolate();
+  v8::HandleScope handle_scope(isolate);
+
+  SerializedValue results;
+  blink::WebFrame* frame = GetMainFrame();
+  if (!frame) {
+    SerializeV8Value(isolate, v8::Null(isolate), &results);
+    Send(new AtomViewHostMsg_ExecuteScriptsResult(routing_id(), request_id,
+                                                  results));
+    return;
+  }
+
+  v8::Local<v8::Context> context = frame->mainWorldScriptContext();
+  v8::Context::Scope context_scope(context);
+
+  // A throwing script does not stop the ones after it, each gets either the
+  // value it evaluates to or the message of its exception. The scripts are
+  // run by the frame, which catches and reports the exceptions itself, so
+  // the message is taken from the listener it reports to.
+  v8::Local<v8::Array> array = v8::Array::New(isolate, scripts.size());
+  for (size_t i = 0; i < scripts.size(); ++i) {
+    v8::Local<v8::Object> result = v8::Object::New(isolate);
+    base::string16 error;
+    v8::V8::AddMessageListener(OnScriptMessage,
+                               v8::External::New(isolate, &error));
+    v8::Local<v8::Value> value = frame->executeScriptAndReturnValue(
+        blink::WebScriptSource(scripts[i]));
+    v8::V8::RemoveMessageListeners(OnScriptMessage);
+    if (!error.empty()) {
+      result->Set(mate::StringToV8(isolate, "error"),
+                  mate::ConvertToV8(isolate, error));
+    } else if (!value.IsEmpty()) {
+      result->Set(mate::StringToV8(isolate, "result"), value);
+    }
+    array->Set(static_cast<uint32>(i), result);
+  }
+  SerializeV8Value(isolate, array, &results);
+  Send(new AtomViewHostMsg_ExecuteScriptsResult(routing_id(), request_id,
+                                                results));
 }
 
 }  // namespace atom
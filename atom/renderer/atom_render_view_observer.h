@@ -5,13 +5,17 @@
 #ifndef ATOM_RENDERER_ATOM_RENDER_VIEW_OBSERVER_H_
 #define ATOM_RENDERER_ATOM_RENDER_VIEW_OBSERVER_H_
 
+#include <deque>
+#include <vector>
+
+#include "atom/common/draggable_region.h"
+#include "atom/common/native_mate_converters/v8_value_serializer.h"
+#include "base/memory/linked_ptr.h"
+#include "base/memory/shared_memory.h"
+#include "base/memory/weak_ptr.h"
 #include "base/strings/string16.h"
 #include "content/public/renderer/render_view_observer.h"
 
-namespace base {
-class ListValue;
-}
-
 namespace atom {
 
 class AtomRendererClient;
@@ -30,8 +34,27 @@ class AtomRenderViewObserver : public content::RenderViewObserver {
   void DraggableRegionsChanged(blink::WebFrame* frame) override;
   bool OnMessageReceived(const IPC::Message& message) override;
 
+  // Returns the main frame if it can receive IPC events, its deferred node
+  // environment is created on the way.
+  blink::WebFrame* GetMainFrame();
+
   void OnBrowserMessage(const base::string16& channel,
-                        const base::ListValue& args);
+                        const SerializedValue& args);
+  void OnBrowserSharedMessage(const base::string16& channel,
+                              base::SharedMemoryHandle handle,
+                              uint32 size);
+  void OnBrowserBulkMessage(const base::string16& channel,
+                            const SerializedValue& args);
+  void EmitBulkMessages();
+  void OnOpenPort(int id,
+                  const base::string16& channel,
+                  base::SharedMemoryHandle handle,
+                  uint32 size);
+  void OnPortDoorbell(int id);
+  void OnClosePort(int id);
+  void OnSetPageSuspended(bool suspended);
+  void OnExecuteScripts(int request_id,
+                        const std::vector<base::string16>& scripts);
 
   // Weak reference to renderer client.
   AtomRendererClient* renderer_client_;
@@ -39,6 +62,22 @@ class AtomRenderViewObserver : public content::RenderViewObserver {
   // Whether the document object has been created.
   bool document_created_;
 
+  // Whether the browser has asked to suspend the page.
+  bool page_suspended_;
+
+  // The draggable regions last sent to browser.
+  std::vector<DraggableRegion> draggable_regions_;
+
+  // Bulk messages from browser waiting to be emitted.
+  struct BulkMessage {
+    base::string16 channel;
+    SerializedValue args;
+  };
+  std::deque<linked_ptr<BulkMessage>> bulk_messages_;
+  bool bulk_messages_scheduled_;
+
+  base::WeakPtrFactory<AtomRenderViewObserver> weak_factory_;
+
   DISALLOW_COPY_AND_ASSIGN(AtomRenderViewObserver);
 };
 
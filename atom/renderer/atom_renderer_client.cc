@@ -4,18 +4,30 @@
 
 #include "atom/renderer/atom_renderer_client.h"
 
+#include <algorithm>
 #include <string>
+#include <utility>
 
+#include "atom/common/api/api_messages.h"
 #include "atom/common/api/atom_bindings.h"
+#include "atom/common/api/object_life_monitor.h"
+#include "atom/common/asar/asar_util.h"
+#include "atom/common/async_logger.h"
 #include "atom/common/node_bindings.h"
 #include "atom/common/options_switches.h"
+#include "atom/common/purge_memory.h"
+#include "atom/common/startup_timings.h"
+#include "atom/renderer/atom_render_frame_observer.h"
 #include "atom/renderer/atom_render_view_observer.h"
 #include "atom/renderer/guest_view_container.h"
 #include "chrome/renderer/printing/print_web_view_helper.h"
 #include "chrome/renderer/tts_dispatcher.h"
 #include "content/public/common/content_constants.h"
 #include "content/public/renderer/render_thread.h"
+#include "base/bind.h"
 #include "base/command_line.h"
+#include "base/message_loop/message_loop.h"
+#include "native_mate/converter.h"
 #include "third_party/WebKit/public/web/WebCustomElement.h"
 #include "third_party/WebKit/public/web/WebFrame.h"
 #include "third_party/WebKit/public/web/WebPluginParams.h"
@@ -41,6 +53,12 @@ bool IsSwitchEnabled(base::CommandLine* command_line,
   return true;
 }
 
+// Reading |process| creates the deferred node environment, while |require|
+// is a function that does it when called, so checking the type of node's
+// globals does not load node. The other globals only appear after that.
+const char kLazyProcess[] = "process";
+const char kLazyRequire[] = "require";
+
 bool IsGuestFrame(blink::WebFrame* frame) {
   return frame->uniqueName().utf8() == "ATOM_SHELL_GUEST_WEB_VIEW";
 }
@@ -50,13 +68,27 @@ bool IsGuestFrame(blink::WebFrame* frame) {
 AtomRendererClient::AtomRendererClient()
     : node_bindings_(NodeBindings::Create(false)),
       atom_bindings_(new AtomBindings),
-      main_frame_(nullptr) {
+      main_frame_(nullptr),
+      node_environment_pending_(false) {
 }
 
 AtomRendererClient::~AtomRendererClient() {
 }
 
+bool AtomRendererClient::OnControlMessageReceived(
+    const IPC::Message& message) {
+  bool handled = true;
+  IPC_BEGIN_MESSAGE_MAP(AtomRendererClient, message)
+    IPC_MESSAGE_HANDLER(AtomMsg_AsarHeader, OnAsarHeader)
+    IPC_MESSAGE_HANDLER(AtomMsg_GetV8HeapStats, OnGetV8HeapStats)
+    IPC_MESSAGE_HANDLER(AtomMsg_MemoryPressure, OnMemoryPressure)
+    IPC_MESSAGE_UNHANDLED(handled = false)
+  IPC_END_MESSAGE_MAP()
+  return handled;
+}
+
 void AtomRendererClient::WebKitInitialized() {
+  StartupTimings::GetInstance()->Record("webkit-initialized");
   EnableWebRuntimeFeatures();
 
   blink::WebCustomElement::addEmbedderCustomElementName("webview");
@@ -75,8 +107,29 @@ void AtomRendererClient::WebKitInitialized() {
   global_env = node::Environment::New(context, uv_default_loop());
 }
 
+void AtomRendererClient::OnRenderProcessShutdown() {
+  AsyncLogger::GetInstance()->Flush();
+}
+
 void AtomRendererClient::RenderThreadStarted() {
-  content::RenderThread::Get()->AddObserver(this);
+  StartupTimings::GetInstance()->Record("render-thread-started");
+
+  content::RenderThread* thread = content::RenderThread::Get();
+  thread->AddObserver(this);
+
+  // A pre-started renderer initializes WebKit and node before it is given to
+  // a window, instead of doing it when the first page is created.
+  if (base::CommandLine::ForCurrentProcess()->HasSwitch(
+          switches::kPrewarmedRenderer))
+    base::MessageLoop::current()->PostTask(
+        FROM_HERE,
+        base::Bind(&content::RenderThread::EnsureWebKitInitialized,
+                   base::Unretained(thread)));
+}
+
+void AtomRendererClient::RenderFrameCreated(
+    content::RenderFrame* render_frame) {
+  new AtomRenderFrameObserver(render_frame, this);
 }
 
 void AtomRendererClient::RenderViewCreated(content::RenderView* render_view) {
@@ -109,13 +162,67 @@ void AtomRendererClient::DidCreateScriptContext(blink::WebFrame* frame,
                                                 int world_id) {
   // Only attach node bindings in main frame or guest frame.
   if (!IsGuestFrame(frame)) {
+    // A process shared by a process group hosts many windows, each of their
+    // top frames gets its own environment, and it is never deferred.
+    if (base::CommandLine::ForCurrentProcess()->HasSwitch(
+            switches::kProcessGroup)) {
+      if (!frame->parent())
+        CreateNodeEnvironment(context);
+      return;
+    }
+
     if (main_frame_)
       return;
 
     // The first web frame is the main frame.
     main_frame_ = frame;
+
+    // Defer the environment until the page touches one of node's globals.
+    if (base::CommandLine::ForCurrentProcess()->HasSwitch(
+            switches::kLazyNodeIntegration)) {
+      InstallLazyGlobals(context);
+      return;
+    }
   }
 
+  CreateNodeEnvironment(context);
+}
+
+void AtomRendererClient::EnsureNodeEnvironment() {
+  if (!node_environment_pending_)
+    return;
+
+  v8::Isolate* isolate = blink::mainThreadIsolate();
+  v8::HandleScope handle_scope(isolate);
+  v8::Local<v8::Context> context = main_frame_->mainWorldScriptContext();
+  v8::Context::Scope context_scope(context);
+
+  // The globals would be assigned by init.js, but the ones the page has
+  // replaced with its own are kept.
+  node_environment_pending_ = false;
+  v8::Local<v8::Object> global = context->Global();
+  std::vector<std::pair<v8::Local<v8::String>, v8::Local<v8::Value>>> kept;
+  v8::Local<v8::String> process = mate::StringToV8(isolate, kLazyProcess);
+  if (global->HasRealNamedCallbackProperty(process))
+    global->Delete(process);
+  else
+    kept.push_back(std::make_pair(process, global->Get(process)));
+  v8::Local<v8::String> require = mate::StringToV8(isolate, kLazyRequire);
+  v8::Local<v8::Value> value = global->Get(require);
+  if (value == v8::Local<v8::Function>::New(isolate, lazy_require_))
+    global->Delete(require);
+  else
+    kept.push_back(std::make_pair(require, value));
+  lazy_require_.Reset();
+
+  CreateNodeEnvironment(context);
+
+  for (const auto& page_global : kept)
+    global->Set(page_global.first, page_global.second);
+}
+
+void AtomRendererClient::CreateNodeEnvironment(
+    v8::Handle<v8::Context> context) {
   // Give the node loop a run to make sure everything is ready.
   node_bindings_->RunMessageLoop();
 
@@ -125,14 +232,96 @@ void AtomRendererClient::DidCreateScriptContext(blink::WebFrame* frame,
   // Add atom-shell extended APIs.
   atom_bindings_->BindTo(env->isolate(), env->process_object());
 
-  // Make uv loop being wrapped by window context.
-  if (node_bindings_->uv_env() == nullptr)
-    node_bindings_->set_uv_env(env);
+  // Make uv loop being wrapped by the newest window context.
+  environments_.push_back(env);
+  node_bindings_->set_uv_env(env);
 
   // Load everything.
   node_bindings_->LoadEnvironment(env);
 }
 
+void AtomRendererClient::WillReleaseScriptContext(
+    v8::Handle<v8::Context> context) {
+  ObjectLifeMonitor::ReleaseContext(context);
+
+  auto iter = std::find_if(
+      environments_.begin(), environments_.end(),
+      [&context](node::Environment* env) { return env->context() == context; });
+  if (iter == environments_.end())
+    return;
+
+  node::Environment* env = *iter;
+  environments_.erase(iter);
+  node_bindings_->DestroyEnvironment(env);
+
+  // The renderer may be killed without shutting down after its last page is
+  // gone, so write what the page has logged now.
+  AsyncLogger::GetInstance()->Flush();
+
+  // Hand the uv loop to the environment of a remaining window, the contexts
+  // without one fall back to the global environment.
+  if (!node_bindings_->uv_env() && !environments_.empty())
+    node_bindings_->set_uv_env(environments_.back());
+}
+
+void AtomRendererClient::InstallLazyGlobals(v8::Handle<v8::Context> context) {
+  v8::Isolate* isolate = context->GetIsolate();
+  v8::Local<v8::External> self = v8::External::New(isolate, this);
+  v8::Local<v8::Object> global = context->Global();
+  global->SetAccessor(mate::StringToV8(isolate, kLazyProcess),
+                      &AtomRendererClient::LazyGlobalGetter,
+                      &AtomRendererClient::LazyGlobalSetter,
+                      self);
+  v8::Local<v8::Function> require = v8::FunctionTemplate::New(
+      isolate, &AtomRendererClient::LazyRequire, self)->GetFunction();
+  lazy_require_.Reset(isolate, require);
+  global->Set(mate::StringToV8(isolate, kLazyRequire), require);
+  node_environment_pending_ = true;
+}
+
+// static
+void AtomRendererClient::LazyRequire(
+    const v8::FunctionCallbackInfo<v8::Value>& info) {
+  AtomRendererClient* self = static_cast<AtomRendererClient*>(
+      v8::Local<v8::External>::Cast(info.Data())->Value());
+  self->EnsureNodeEnvironment();
+
+  // Forward to the real require, the page may have kept a reference to us.
+  v8::Isolate* isolate = info.GetIsolate();
+  v8::Local<v8::Object> global = isolate->GetCurrentContext()->Global();
+  v8::Local<v8::Value> require =
+      global->Get(mate::StringToV8(isolate, kLazyRequire));
+  if (!require->IsFunction() || require == info.Callee())
+    return;
+  std::vector<v8::Local<v8::Value>> args;
+  for (int i = 0; i < info.Length(); ++i)
+    args.push_back(info[i]);
+  info.GetReturnValue().Set(v8::Local<v8::Function>::Cast(require)->Call(
+      global, static_cast<int>(args.size()),
+      args.empty() ? nullptr : &args.front()));
+}
+
+// static
+void AtomRendererClient::LazyGlobalGetter(
+    v8::Local<v8::String> property,
+    const v8::PropertyCallbackInfo<v8::Value>& info) {
+  AtomRendererClient* self = static_cast<AtomRendererClient*>(
+      v8::Local<v8::External>::Cast(info.Data())->Value());
+  self->EnsureNodeEnvironment();
+  info.GetReturnValue().Set(info.Holder()->Get(property));
+}
+
+// static
+void AtomRendererClient::LazyGlobalSetter(
+    v8::Local<v8::String> property,
+    v8::Local<v8::Value> value,
+    const v8::PropertyCallbackInfo<void>& info) {
+  // The page defines its own global with the same name, which should not
+  // load node.
+  info.Holder()->Delete(property);
+  info.Holder()->Set(property, value);
+}
+
 bool AtomRendererClient::ShouldFork(blink::WebFrame* frame,
                                     const GURL& url,
                                     const std::string& http_method,
@@ -178,4 +367,32 @@ void AtomRendererClient::EnableWebRuntimeFeatures() {
     blink::WebRuntimeFeatures::enableSharedWorker(b);
 }
 
+void AtomRendererClient::OnAsarHeader(const base::FilePath& path,
+                                      base::SharedMemoryHandle handle,
+                                      uint32 size) {
+  base::SharedMemory memory(handle, true);
+  if (!memory.Map(size))
+    return;
+
+  asar::CreateAsarArchiveFromSnapshot(
+      path, static_cast<const char*>(memory.memory()), size);
+}
+
+void AtomRendererClient::OnGetV8HeapStats(int request_id) {
+  v8::HeapStatistics stats;
+  blink::mainThreadIsolate()->GetHeapStatistics(&stats);
+  content::RenderThread::Get()->Send(new AtomHostMsg_V8HeapStats(
+      request_id, stats.used_heap_size(), stats.total_heap_size()));
+}
+
+void AtomRendererClient::OnMemoryPressure(int level) {
+  base::MemoryPressureListener::MemoryPressureLevel pressure_level =
+      static_cast<base::MemoryPressureListener::MemoryPressureLevel>(level);
+  PurgeMemory(pressure_level);
+
+  // The listeners of Chromium in this process, like the ones of V8 and Skia,
+  // only hear about the pressure from us.
+  base::MemoryPressureListener::NotifyMemoryPressure(pressure_level);
+}
+
 }  // namespace atom
@@ -6,9 +6,20 @@
 #define ATOM_RENDERER_ATOM_RENDERER_CLIENT_H_
 
 #include <string>
+#include <vector>
 
 #include "content/public/renderer/content_renderer_client.h"
+#include "base/memory/shared_memory.h"
 #include "content/public/renderer/render_process_observer.h"
+#include "v8/include/v8.h"
+
+namespace base {
+class FilePath;
+}
+
+namespace node {
+class Environment;
+}
 
 namespace atom {
 
@@ -21,6 +32,13 @@ class AtomRendererClient : public content::ContentRendererClient,
   AtomRendererClient();
   virtual ~AtomRendererClient();
 
+  // Creates the node environment of main frame now if it was deferred by the
+  // "lazy-node-integration" option.
+  void EnsureNodeEnvironment();
+
+  // Frees the node environment created in |context|, if there is one.
+  void WillReleaseScriptContext(v8::Handle<v8::Context> context);
+
  private:
   enum NodeIntegration {
     ALL,
@@ -30,10 +48,13 @@ class AtomRendererClient : public content::ContentRendererClient,
   };
 
   // content::RenderProcessObserver:
+  bool OnControlMessageReceived(const IPC::Message& message) override;
   void WebKitInitialized() override;
+  void OnRenderProcessShutdown() override;
 
   // content::ContentRendererClient:
   void RenderThreadStarted() override;
+  void RenderFrameCreated(content::RenderFrame* render_frame) override;
   void RenderViewCreated(content::RenderView*) override;
   blink::WebSpeechSynthesizer* OverrideSpeechSynthesizer(
       blink::WebSpeechSynthesizerClient* client) override;
@@ -58,12 +79,40 @@ class AtomRendererClient : public content::ContentRendererClient,
 
   void EnableWebRuntimeFeatures();
 
+  void CreateNodeEnvironment(v8::Handle<v8::Context> context);
+
+  // Defines the globals that create the environment when node is first used.
+  void InstallLazyGlobals(v8::Handle<v8::Context> context);
+  static void LazyRequire(const v8::FunctionCallbackInfo<v8::Value>& info);
+  static void LazyGlobalGetter(v8::Local<v8::String> property,
+                               const v8::PropertyCallbackInfo<v8::Value>& info);
+  static void LazyGlobalSetter(v8::Local<v8::String> property,
+                               v8::Local<v8::Value> value,
+                               const v8::PropertyCallbackInfo<void>& info);
+
+  void OnGetV8HeapStats(int request_id);
+  void OnMemoryPressure(int level);
+
+  // Creates the asar archive from header snapshot sent by browser.
+  void OnAsarHeader(const base::FilePath& path,
+                    base::SharedMemoryHandle handle,
+                    uint32 size);
+
   scoped_ptr<NodeBindings> node_bindings_;
   scoped_ptr<AtomBindings> atom_bindings_;
 
   // The main frame.
   blink::WebFrame* main_frame_;
 
+  // Whether the environment of main frame is waiting to be created.
+  bool node_environment_pending_;
+
+  // The |require| stub of the deferred environment.
+  v8::Persistent<v8::Function> lazy_require_;
+
+  // The environments of the live contexts, the last one wraps the uv loop.
+  std::vector<node::Environment*> environments_;
+
   DISALLOW_COPY_AND_ASSIGN(AtomRendererClient);
 };
 
@@ -0,0 +1,93 @@
+// Copyright (c) 2015 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#include "atom/renderer/renderer_message_port.h"
+
+#include "atom/common/api/api_messages.h"
+#include "atom/common/ring_buffer.h"
+#include "base/containers/scoped_ptr_hash_map.h"
+#include "base/lazy_instance.h"
+#include "content/public/renderer/render_thread.h"
+
+namespace atom {
+
+namespace {
+
+typedef base::ScopedPtrHashMap<int, RendererMessagePort> PortMap;
+base::LazyInstance<PortMap>::Leaky g_ports = LAZY_INSTANCE_INITIALIZER;
+
+}  // namespace
+
+// static
+bool RendererMessagePort::Create(int routing_id,
+                                 int id,
+                                 base::SharedMemoryHandle handle,
+                                 uint32 size) {
+  scoped_ptr<base::SharedMemory> memory(new base::SharedMemory(handle, false));
+  if (size < 2 * RingBuffer::RequiredMemorySize(0) || !memory->Map(size))
+    return false;
+  g_ports.Get().set(id, make_scoped_ptr(
+      new RendererMessagePort(routing_id, id, memory.Pass(), size)));
+  return true;
+}
+
+// static
+RendererMessagePort* RendererMessagePort::FromID(int id) {
+  return g_ports.Get().get(id);
+}
+
+// static
+void RendererMessagePort::Destroy(int id, bool notify_peer) {
+  RendererMessagePort* port = FromID(id);
+  if (!port)
+    return;
+  if (notify_peer)
+    content::RenderThread::Get()->Send(
+        new AtomViewHostMsg_ClosePort(port->routing_id_, id));
+  g_ports.Get().erase(id);
+}
+
+RendererMessagePort::RendererMessagePort(int routing_id,
+                                         int id,
+                                         scoped_ptr<base::SharedMemory> memory,
+                                         uint32 size)
+    : routing_id_(routing_id),
+      id_(id),
+      memory_(memory.Pass()) {
+  uint32 ring_size = size / 2;
+  char* first = static_cast<char*>(memory_->memory());
+  char* second = first + ring_size;
+  bool is_even = (id % 2) == 0;
+  write_ring_.reset(new RingBuffer(is_even ? first : second, ring_size));
+  read_ring_.reset(new RingBuffer(is_even ? second : first, ring_size));
+}
+
+RendererMessagePort::~RendererMessagePort() {
+}
+
+bool RendererMessagePort::Post(const char* data, uint32 size) {
+  bool should_ring = false;
+  if (!write_ring_->Write(data, size, &should_ring))
+    return false;
+  if (should_ring)
+    content::RenderThread::Get()->Send(
+        new AtomViewHostMsg_PortDoorbell(routing_id_, id_));
+  return true;
+}
+
+bool RendererMessagePort::Drain(std::vector<std::string>* messages) {
+  do {
+    const char* data;
+    uint32 size;
+    while (read_ring_->Peek(&data, &size)) {
+      messages->push_back(std::string(data, size));
+      read_ring_->Consume();
+    }
+    if (read_ring_->corrupted())
+      return false;
+  } while (!read_ring_->WaitForDoorbell());
+  return true;
+}
+
+}  // namespace atom
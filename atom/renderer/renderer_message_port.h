@@ -0,0 +1,60 @@
+// Copyright (c) 2015 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#ifndef ATOM_RENDERER_RENDERER_MESSAGE_PORT_H_
+#define ATOM_RENDERER_RENDERER_MESSAGE_PORT_H_
+
+#include <string>
+#include <vector>
+
+#include "base/memory/scoped_ptr.h"
+#include "base/memory/shared_memory.h"
+
+namespace atom {
+
+class RingBuffer;
+
+// One end of a message port created by MessagePortMessageFilter, messages are
+// exchanged with the peer through shared memory. Only used on the main thread
+// of renderer.
+class RendererMessagePort {
+ public:
+  // Creates the end |id| for the view |routing_id|.
+  static bool Create(int routing_id,
+                     int id,
+                     base::SharedMemoryHandle handle,
+                     uint32 size);
+  static RendererMessagePort* FromID(int id);
+
+  // Closes the port, |notify_peer| should be false when the peer has already
+  // been closed.
+  static void Destroy(int id, bool notify_peer);
+
+  // Returns false when there is no room for the message.
+  bool Post(const char* data, uint32 size);
+
+  // Copies the messages from peer into |messages| until no more is available,
+  // returns false if the peer wrote malformed data. The messages are copied
+  // so handling them can close the port.
+  bool Drain(std::vector<std::string>* messages);
+
+ private:
+  RendererMessagePort(int routing_id,
+                      int id,
+                      scoped_ptr<base::SharedMemory> memory,
+                      uint32 size);
+  ~RendererMessagePort();
+
+  int routing_id_;
+  int id_;
+  scoped_ptr<base::SharedMemory> memory_;
+  scoped_ptr<RingBuffer> write_ring_;
+  scoped_ptr<RingBuffer> read_ring_;
+
+  DISALLOW_COPY_AND_ASSIGN(RendererMessagePort);
+};
+
+}  // namespace atom
+
+#endif  // ATOM_RENDERER_RENDERER_MESSAGE_PORT_H_
@@ -0,0 +1,180 @@
+// Copyright (c) 2015 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#include "atom/renderer/spell_check_dictionary.h"
+
+#include <string.h>
+
+#include <algorithm>
+#include <map>
+#include <set>
+
+#include "base/files/file_path.h"
+#include "base/files/file_util.h"
+#include "base/i18n/case_conversion.h"
+#include "base/strings/string_util.h"
+#include "base/strings/utf_string_conversions.h"
+
+namespace atom {
+
+namespace {
+
+// Only try this many characters when generating suggestions, which keeps the
+// number of candidates bounded for languages with large alphabets.
+const size_t kMaxAlphabetSize = 64;
+
+// Orders the offsets into |words| by the '\0' terminated words they point to.
+class WordLess {
+ public:
+  explicit WordLess(const std::string& words) : words_(words.c_str()) {}
+
+  bool operator()(uint32 a, uint32 b) const {
+    return strcmp(words_ + a, words_ + b) < 0;
+  }
+  bool operator()(uint32 a, const char* b) const {
+    return strcmp(words_ + a, b) < 0;
+  }
+
+ private:
+  const char* words_;
+};
+
+class WordEqual {
+ public:
+  explicit WordEqual(const std::string& words) : words_(words.c_str()) {}
+
+  bool operator()(uint32 a, uint32 b) const {
+    return strcmp(words_ + a, words_ + b) == 0;
+  }
+
+ private:
+  const char* words_;
+};
+
+}  // namespace
+
+// static
+scoped_refptr<SpellCheckDictionary> SpellCheckDictionary::Load(
+    const base::FilePath& path) {
+  std::string content;
+  if (!base::ReadFileToString(path, &content))
+    return nullptr;
+
+  scoped_refptr<SpellCheckDictionary> dictionary(new SpellCheckDictionary);
+  std::string& words = dictionary->words_;
+  words.reserve(content.size() + 1);
+  bool is_hunspell = path.MatchesExtension(FILE_PATH_LITERAL(".dic"));
+  bool first_line = true;
+  std::map<base::char16, size_t> frequencies;
+  size_t start = 0;
+  while (start < content.size()) {
+    size_t end = content.find('\n', start);
+    if (end == std::string::npos)
+      end = content.size();
+    std::string line = content.substr(start, end - start);
+    start = end + 1;
+
+    if (is_hunspell) {
+      line = line.substr(0, line.find('/'));
+      // The first line of a Hunspell dictionary is the number of words.
+      if (first_line && line.find_first_not_of("0123456789 \t\r") ==
+                            std::string::npos) {
+        first_line = false;
+        continue;
+      }
+    }
+    first_line = false;
+
+    base::TrimWhitespaceASCII(line, base::TRIM_ALL, &line);
+    if (line.empty() || line.find('\0') != std::string::npos)
+      continue;
+    dictionary->offsets_.push_back(static_cast<uint32>(words.size()));
+    words.append(line);
+    words.push_back('\0');
+
+    base::string16 word = base::i18n::ToLower(base::UTF8ToUTF16(line));
+    for (base::char16 c : word)
+      ++frequencies[c];
+  }
+
+  if (dictionary->offsets_.empty())
+    return nullptr;
+
+  std::vector<uint32>& offsets = dictionary->offsets_;
+  std::sort(offsets.begin(), offsets.end(), WordLess(words));
+  offsets.erase(std::unique(offsets.begin(), offsets.end(), WordEqual(words)),
+                offsets.end());
+  // Give back the memory reserved for duplicates and the ignored lines.
+  std::vector<uint32>(offsets).swap(offsets);
+  std::string(words).swap(words);
+
+  std::vector<std::pair<size_t, base::char16>> by_frequency;
+  for (const auto& frequency : frequencies)
+    by_frequency.push_back(std::make_pair(frequency.second, frequency.first));
+  std::sort(by_frequency.rbegin(), by_frequency.rend());
+  for (size_t i = 0; i < by_frequency.size() && i < kMaxAlphabetSize; ++i)
+    dictionary->alphabet_.push_back(by_frequency[i].second);
+  return dictionary;
+}
+
+SpellCheckDictionary::SpellCheckDictionary() {
+}
+
+SpellCheckDictionary::~SpellCheckDictionary() {
+}
+
+bool SpellCheckDictionary::HasWord(const base::string16& word) const {
+  if (Contains(base::UTF16ToUTF8(word)))
+    return true;
+
+  base::string16 lower = base::i18n::ToLower(word);
+  return lower != word && Contains(base::UTF16ToUTF8(lower));
+}
+
+std::vector<base::string16> SpellCheckDictionary::GetSuggestions(
+    const base::string16& word, size_t max_count) const {
+  std::vector<base::string16> suggestions;
+  std::set<base::string16> tried;
+  tried.insert(word);
+
+  std::vector<base::string16> candidates;
+  for (size_t i = 0; i + 1 < word.size(); ++i) {
+    base::string16 candidate(word);
+    std::swap(candidate[i], candidate[i + 1]);
+    candidates.push_back(candidate);
+  }
+  for (size_t i = 0; i < word.size(); ++i) {
+    for (base::char16 c : alphabet_) {
+      base::string16 candidate(word);
+      candidate[i] = c;
+      candidates.push_back(candidate);
+    }
+  }
+  for (size_t i = 0; word.size() > 1 && i < word.size(); ++i)
+    candidates.push_back(base::string16(word).erase(i, 1));
+  for (size_t i = 0; i <= word.size(); ++i) {
+    for (base::char16 c : alphabet_)
+      candidates.push_back(base::string16(word).insert(i, 1, c));
+  }
+
+  for (const base::string16& candidate : candidates) {
+    if (suggestions.size() >= max_count)
+      break;
+    if (tried.insert(candidate).second && HasWord(candidate))
+      suggestions.push_back(candidate);
+  }
+  return suggestions;
+}
+
+bool SpellCheckDictionary::Contains(const std::string& word) const {
+  if (word.empty())
+    return false;
+
+  std::vector<uint32>::const_iterator iter = std::lower_bound(
+      offsets_.begin(), offsets_.end(), word.c_str(), WordLess(words_));
+  return iter != offsets_.end() &&
+         strcmp(words_.c_str() + *iter, word.c_str()) == 0;
+}
+
+}  // namespace atom
@@ -0,0 +1,67 @@
+// Copyright (c) 2015 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#ifndef ATOM_RENDERER_SPELL_CHECK_DICTIONARY_H_
+#define ATOM_RENDERER_SPELL_CHECK_DICTIONARY_H_
+
+#include <string>
+#include <vector>
+
+#include "base/basictypes.h"
+#include "base/memory/ref_counted.h"
+#include "base/strings/string16.h"
+
+namespace base {
+class FilePath;
+}
+
+namespace atom {
+
+// A read-only set of correctly spelled words, so the SpellCheckClient can
+// check words without calling into JavaScript. All words are stored as UTF-8
+// in one buffer separated by '\0', with a sorted table of their offsets for
+// binary search, which costs about 4 bytes per word besides the text itself.
+// It is never changed after being loaded, so it can be read on any thread.
+class SpellCheckDictionary
+    : public base::RefCountedThreadSafe<SpellCheckDictionary> {
+ public:
+  // Loads a plain word list with one word per line, or a Hunspell .dic file,
+  // of which the word count at first line and the affix flags after '/' are
+  // ignored. Returns NULL when the file can not be read or has no words.
+  static scoped_refptr<SpellCheckDictionary> Load(const base::FilePath& path);
+
+  // Whether |word| is in the dictionary, a capitalized word is also accepted
+  // when its lowercase form is.
+  bool HasWord(const base::string16& word) const;
+
+  // Returns at most |max_count| words of the dictionary that are one edit
+  // away from |word|: a swap of adjacent characters, a replaced, removed or
+  // inserted character. The swaps come first since they are the most common
+  // typos.
+  std::vector<base::string16> GetSuggestions(const base::string16& word,
+                                             size_t max_count) const;
+
+  size_t size() const { return offsets_.size(); }
+
+ private:
+  friend class base::RefCountedThreadSafe<SpellCheckDictionary>;
+
+  SpellCheckDictionary();
+  ~SpellCheckDictionary();
+
+  bool Contains(const std::string& word) const;
+
+  std::string words_;
+  std::vector<uint32> offsets_;
+
+  // The most common characters of the words, which are tried when replacing
+  // or inserting characters.
+  base::string16 alphabet_;
+
+  DISALLOW_COPY_AND_ASSIGN(SpellCheckDictionary);
+};
+
+}  // namespace atom
+
+#endif  // ATOM_RENDERER_SPELL_CHECK_DICTIONARY_H_
@@ -0,0 +1,292 @@
+var app = require('app');
+var ipc = require('ipc');
+var fs = require('fs');
+var originalFs = require('original-fs');
+var os = require('os');
+var path = require('path');
+var BrowserWindow = require('browser-window');
+
+var asar = process.atomBinding('asar');
+
+// The synthetic archive has DIRECTORIES * FILES_PER_DIRECTORY small files,
+// which makes a header of a few megabytes, and one large file.
+var DIRECTORIES = 200;
+var FILES_PER_DIRECTORY = 100;
+var SMALL_FILE_SIZE = 512;
+var LARGE_FILE_SIZE = 8 * 1024 * 1024;
+
+// How many copies of the archive are opened to measure Init, each path can
+// only be opened once in a process.
+var INIT_COPIES = 20;
+// Calls of the lookup cases, and of the read cases.
+var LOOKUPS = 100000;
+var READS = 10000;
+// Requests sent by the renderer, and how many of them are in flight at once.
+var REQUESTS = 2000;
+var CONCURRENCY = 16;
+// Sequential loads of a page from the archive in a window.
+var PAGE_LOADS = 50;
+
+var output = null;
+
+process.argv.forEach(function(arg) {
+  if (arg.indexOf('--output=') === 0)
+    output = arg.substr('--output='.length);
+});
+
+var workDir = path.join(os.tmpdir(), 'atom-shell-asar-benchmark-' +
+                        process.pid);
+var archivePath = path.join(workDir, 'bench.asar');
+
+function now() {
+  var time = process.hrtime();
+  return time[0] * 1e3 + time[1] / 1e6;
+}
+
+function smallFilePath(i) {
+  var directory = Math.floor(i / FILES_PER_DIRECTORY) % DIRECTORIES;
+  return 'd' + directory + '/f' + (i % FILES_PER_DIRECTORY) + '.js';
+}
+
+// Writes an archive with the JSON header produced by the asar tool.
+function createArchive() {
+  var files = {};
+  var chunks = [];
+  var offset = 0;
+  var addFile = function(node, name, data) {
+    node[name] = {size: data.length, offset: String(offset)};
+    chunks.push(data);
+    offset += data.length;
+  };
+
+  var small = new Buffer(SMALL_FILE_SIZE);
+  small.fill('s');
+  for (var d = 0; d < DIRECTORIES; ++d) {
+    var directory = {};
+    for (var f = 0; f < FILES_PER_DIRECTORY; ++f)
+      addFile(directory, 'f' + f + '.js', small);
+    files['d' + d] = {files: directory};
+  }
+
+  var large = new Buffer(LARGE_FILE_SIZE);
+  large.fill('l');
+  addFile(files, 'large.bin', large);
+
+  var page = {};
+  addFile(page, 'index.html', new Buffer(
+      '<html><body><script src="script.js"></script></body></html>'));
+  addFile(page, 'script.js', new Buffer('document.title = "loaded";'));
+  files.page = {files: page};
+
+  // The header pickle is the payload size, the string length and the string
+  // padded to 4 bytes. The size pickle holds the size of the header pickle.
+  var json = new Buffer(JSON.stringify({files: files}));
+  var padding = (4 - json.length % 4) % 4;
+  var headerPickle = new Buffer(8 + json.length + padding);
+  headerPickle.fill(0);
+  headerPickle.writeUInt32LE(4 + json.length + padding, 0);
+  headerPickle.writeInt32LE(json.length, 4);
+  json.copy(headerPickle, 8);
+  var sizePickle = new Buffer(8);
+  sizePickle.writeUInt32LE(4, 0);
+  sizePickle.writeUInt32LE(headerPickle.length, 4);
+
+  originalFs.mkdirSync(workDir);
+  originalFs.writeFileSync(archivePath, Buffer.concat(
+      [sizePickle, headerPickle].concat(chunks)));
+  return headerPickle.length;
+}
+
+function memory() {
+  var usage = process.memoryUsage();
+  return {rss: usage.rss, heapUsed: usage.heapUsed};
+}
+
+function result(name, operations, elapsed, before) {
+  var after = memory();
+  return {
+    name: name,
+    operations: operations,
+    opsPerSecond: operations / (elapsed / 1e3),
+    averageUs: elapsed * 1e3 / operations,
+    rssDelta: after.rss - before.rss,
+    heapUsedDelta: after.heapUsed - before.heapUsed,
+  };
+}
+
+// The calls that only do their work once for each argument are not warmed
+// up, otherwise they would only be measured returning cached results.
+function measure(name, operations, call, noWarmUp) {
+  // Warm up, so the results do not include the first compilations.
+  for (var i = 0; !noWarmUp && i < Math.min(100, operations); ++i)
+    call(i);
+  var before = memory();
+  var start = now();
+  for (var j = 0; j < operations; ++j)
+    call(j);
+  return result(name, operations, now() - start, before);
+}
+
+// Runs |operations| asynchronous calls keeping |concurrency| of them pending.
+function measureAsync(name, operations, concurrency, call, callback) {
+  var before = memory();
+  var start = now();
+  var started = 0;
+  var finished = 0;
+  var next = function() {
+    if (started === operations)
+      return;
+    call(started++, function() {
+      if (++finished === operations)
+        callback(result(name, operations, now() - start, before));
+      else
+        next();
+    });
+  };
+  for (var i = 0; i < concurrency; ++i)
+    next();
+}
+
+function runSyncCases(headerSize) {
+  var results = [];
+
+  // Each copy is a new path, so Init parses the header of every one.
+  var copies = [];
+  for (var i = 0; i < INIT_COPIES; ++i) {
+    var copy = path.join(workDir, 'copy' + i + '.asar');
+    originalFs.writeFileSync(copy, originalFs.readFileSync(archivePath));
+    copies.push(copy);
+  }
+  var init = measure('Archive::Init', INIT_COPIES, function(i) {
+    if (!asar.createArchive(copies[i]))
+      throw new Error('Failed to open ' + copies[i]);
+  }, true);
+  init.headerSize = headerSize;
+  init.entries = DIRECTORIES * FILES_PER_DIRECTORY + DIRECTORIES + 4;
+  results.push(init);
+
+  var archive = asar.createArchive(archivePath);
+  results.push(measure('Archive::GetFileInfo', LOOKUPS, function(i) {
+    archive.getFileInfo(smallFilePath(i));
+  }));
+  results.push(measure('Archive::Stat', LOOKUPS, function(i) {
+    archive.stat(smallFilePath(i));
+  }));
+  results.push(measure('Archive::Readdir', LOOKUPS, function(i) {
+    archive.readdir('d' + (i % DIRECTORIES));
+  }));
+  results.push(measure('fs.statSync', LOOKUPS, function(i) {
+    fs.statSync(path.join(archivePath, smallFilePath(i)));
+  }));
+  results.push(measure('fs.readFileSync small', READS, function(i) {
+    fs.readFileSync(path.join(archivePath, smallFilePath(i)));
+  }));
+
+  var largePath = path.join(archivePath, 'large.bin');
+  var largeReads = 50;
+  var large = measure('fs.readFileSync large', largeReads, function() {
+    fs.readFileSync(largePath);
+  });
+  large.bytesPerSecond = LARGE_FILE_SIZE * large.opsPerSecond;
+  results.push(large);
+
+  // Every file is only copied out once, so each call is a distinct file.
+  results.push(measure('Archive::CopyFileOut', READS, function(i) {
+    archive.copyFileOut(smallFilePath(i));
+  }, true));
+  return results;
+}
+
+function runAsyncCases(results, callback) {
+  measureAsync('fs.readFile small', READS, CONCURRENCY, function(i, done) {
+    fs.readFile(path.join(archivePath, smallFilePath(i)), function(error) {
+      if (error)
+        throw error;
+      done();
+    });
+  }, function(report) {
+    results.push(report);
+    callback();
+  });
+}
+
+// The requests of the renderer to file:// URLs inside the archive are served
+// by URLRequestAsarJob.
+function runRendererCases(results, callback) {
+  var window = new BrowserWindow({show: false});
+  ipc.on('bench-error', function(event, message) {
+    console.error(message);
+    process.exit(1);
+  });
+  ipc.once('bench-ready', function() {
+    var urls = [];
+    for (var i = 0; i < REQUESTS; ++i)
+      urls.push('file://' + path.join(archivePath, smallFilePath(i)));
+    window.webContents.send('bench-run', 'URLRequestAsarJob', urls,
+                            CONCURRENCY);
+  });
+  ipc.once('bench-report', function(event, name, report) {
+    results.push({
+      name: name,
+      operations: report.requests,
+      opsPerSecond: report.requests / (report.elapsed / 1e3),
+      bytesPerSecond: report.bytes / (report.elapsed / 1e3),
+    });
+
+    // Then whole pages, which also load their scripts from the archive.
+    var pageUrl = 'file://' + path.join(archivePath, 'page', 'index.html');
+    var loads = 0;
+    var start = now();
+    window.webContents.on('did-finish-load', function() {
+      if (++loads < PAGE_LOADS)
+        return window.loadUrl(pageUrl);
+      var elapsed = now() - start;
+      results.push({
+        name: 'page load',
+        operations: loads,
+        opsPerSecond: loads / (elapsed / 1e3),
+        averageMs: elapsed / loads,
+      });
+      window.destroy();
+      callback();
+    });
+    window.loadUrl(pageUrl);
+  });
+  window.loadUrl('file://' + __dirname + '/index.html');
+}
+
+// The archives are still mapped, which keeps them from being deleted on
+// Windows, the leftovers are in the temporary directory anyway.
+function removeWorkDir() {
+  try {
+    originalFs.readdirSync(workDir).forEach(function(name) {
+      originalFs.unlinkSync(path.join(workDir, name));
+    });
+    originalFs.rmdirSync(workDir);
+  } catch (error) {
+  }
+}
+
+function finish(results) {
+  var report = JSON.stringify({
+    version: process.versions['atom-shell'],
+    platform: process.platform,
+    arch: process.arch,
+    results: results,
+  }, null, 2);
+  if (output)
+    fs.writeFileSync(output, report);
+  else
+    console.log(report);
+  removeWorkDir();
+  app.quit();
+}
+
+app.on('ready', function() {
+  var results = runSyncCases(createArchive());
+  runAsyncCases(results, function() {
+    runRendererCases(results, function() {
+      finish(results);
+    });
+  });
+});
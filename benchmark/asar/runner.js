@@ -0,0 +1,58 @@
+var ipc = require('ipc');
+
+function now() {
+  var time = process.hrtime();
+  return time[0] * 1e3 + time[1] / 1e6;
+}
+
+function load(url, callback) {
+  var xhr = new XMLHttpRequest();
+  xhr.open('GET', url);
+  xhr.responseType = 'arraybuffer';
+  xhr.onload = function() {
+    callback(null, xhr.response ? xhr.response.byteLength : 0);
+  };
+  xhr.onerror = function() {
+    callback(new Error('Failed to load ' + url));
+  };
+  xhr.send();
+}
+
+// Loads the |urls| from the archive keeping |concurrency| of them in flight.
+function runCase(name, urls, concurrency) {
+  var bytes = 0;
+  var sent = 0;
+  var finished = 0;
+  var failed = false;
+  var start = now();
+
+  var next = function() {
+    if (sent === urls.length)
+      return;
+    load(urls[sent++], function(error, length) {
+      if (failed)
+        return;
+      if (error) {
+        failed = true;
+        return ipc.send('bench-error', error.message);
+      }
+      bytes += length;
+      if (++finished === urls.length)
+        ipc.send('bench-report', name, {
+          requests: finished,
+          bytes: bytes,
+          elapsed: now() - start,
+        });
+      else
+        next();
+    });
+  };
+
+  for (var i = 0; i < concurrency; ++i)
+    next();
+}
+
+exports.run = function() {
+  ipc.on('bench-run', runCase);
+  ipc.send('bench-ready');
+};
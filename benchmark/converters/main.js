@@ -0,0 +1,77 @@
+var app = require('app');
+var fs = require('fs');
+var BrowserWindow = require('browser-window');
+
+// Number of calls of each case, keeps every case around one second.
+var ITERATIONS = 100000;
+
+var window = null;
+var output = null;
+
+process.argv.forEach(function(arg) {
+  if (arg.indexOf('--output=') === 0)
+    output = arg.substr('--output='.length);
+});
+
+function now() {
+  var time = process.hrtime();
+  return time[0] * 1e3 + time[1] / 1e6;
+}
+
+function measure(name, call) {
+  // Warm up, so the results do not include the first compilations.
+  for (var i = 0; i < 100; ++i)
+    call(i);
+  var start = now();
+  for (var j = 0; j < ITERATIONS; ++j)
+    call(j);
+  var elapsed = now() - start;
+  return {
+    name: name,
+    iterations: ITERATIONS,
+    callsPerSecond: ITERATIONS / (elapsed / 1e3),
+    averageUs: elapsed * 1e3 / ITERATIONS,
+  };
+}
+
+// The calls going through the converters of gfx::Point, gfx::Rect and
+// gfx::Display, getSize returns an array for comparison.
+function run() {
+  var screen = require('screen');
+  var bounds = window.getBounds();
+  return [
+    measure('BrowserWindow.getBounds', function() {
+      window.getBounds();
+    }),
+    measure('BrowserWindow.setBounds', function() {
+      window.setBounds(bounds);
+    }),
+    measure('BrowserWindow.getSize', function() {
+      window.getSize();
+    }),
+    measure('screen.getCursorScreenPoint', function() {
+      screen.getCursorScreenPoint();
+    }),
+    measure('screen.getPrimaryDisplay', function() {
+      screen.getPrimaryDisplay();
+    }),
+    measure('screen.getDisplayNearestPoint', function(i) {
+      screen.getDisplayNearestPoint({x: i % 100, y: i % 100});
+    }),
+  ];
+}
+
+app.on('ready', function() {
+  window = new BrowserWindow({show: false, width: 400, height: 300});
+  var report = JSON.stringify({
+    version: process.versions['atom-shell'],
+    platform: process.platform,
+    arch: process.arch,
+    results: run(),
+  }, null, 2);
+  if (output)
+    fs.writeFileSync(output, report);
+  else
+    console.log(report);
+  app.quit();
+});
@@ -0,0 +1,54 @@
+var app = require('app');
+var ipc = require('ipc');
+var fs = require('fs');
+var BrowserWindow = require('browser-window');
+var payloads = require('./payloads');
+
+var window = null;
+var output = null;
+
+process.argv.forEach(function(arg) {
+  if (arg.indexOf('--output=') === 0)
+    output = arg.substr('--output='.length);
+});
+
+// ipc.send: acknowledge each message, so the renderer can measure both the
+// throughput and the round trip.
+ipc.on('bench-send', function(event, id) {
+  event.sender.send('bench-ack', id);
+});
+
+ipc.on('bench-send-sync', function(event) {
+  event.returnValue = null;
+});
+
+// webContents.send: push |count| messages of |name| payload.
+ipc.on('bench-push', function(event, name, count) {
+  var payload = payloads.create(name);
+  for (var i = 0; i < count; ++i)
+    event.sender.send('bench-pushed', i, payload);
+});
+
+ipc.on('bench-done', function(event, results) {
+  var report = JSON.stringify({
+    version: process.versions['atom-shell'],
+    platform: process.platform,
+    arch: process.arch,
+    results: results,
+  }, null, 2);
+  if (output)
+    fs.writeFileSync(output, report);
+  else
+    console.log(report);
+  app.quit();
+});
+
+ipc.on('bench-error', function(event, message) {
+  console.error(message);
+  process.exit(1);
+});
+
+app.on('ready', function() {
+  window = new BrowserWindow({show: false});
+  window.loadUrl('file://' + __dirname + '/index.html');
+});
@@ -0,0 +1,27 @@
+// Payload shapes shared by both sides of the benchmark.
+
+function deepObject(depth) {
+  var object = {value: depth, name: 'level' + depth};
+  if (depth > 0)
+    object.child = deepObject(depth - 1);
+  return object;
+}
+
+function largeArray(length) {
+  var array = new Array(length);
+  for (var i = 0; i < length; ++i)
+    array[i] = i;
+  return array;
+}
+
+exports.names = ['scalar', 'deep-object', 'large-array', 'buffer'];
+
+exports.create = function(name) {
+  switch (name) {
+    case 'scalar': return 42;
+    case 'deep-object': return deepObject(15);
+    case 'large-array': return largeArray(10000);
+    case 'buffer': return new Buffer(64 * 1024);
+  }
+  throw new Error('Unknown payload ' + name);
+};
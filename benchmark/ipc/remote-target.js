@@ -0,0 +1,3 @@
+exports.echo = function(value) {
+  return value;
+};
@@ -0,0 +1,164 @@
+var ipc = require('ipc');
+var remote = require('remote');
+var payloads = require('./payloads');
+
+var target = remote.require(__dirname + '/remote-target.js');
+
+// Number of messages of each payload, keeps every case around one second.
+var ITERATIONS = {
+  'scalar': 5000,
+  'deep-object': 2000,
+  'large-array': 200,
+  'buffer': 500,
+};
+
+function now() {
+  var time = process.hrtime();
+  return time[0] * 1e3 + time[1] / 1e6;
+}
+
+function percentile(sorted, p) {
+  var index = Math.min(sorted.length - 1, Math.floor(sorted.length * p));
+  return sorted[index];
+}
+
+function summarize(name, payload, count, elapsed, latencies) {
+  latencies.sort(function(a, b) { return a - b; });
+  return {
+    name: name,
+    payload: payload,
+    iterations: count,
+    messagesPerSecond: count / (elapsed / 1e3),
+    p50Ms: percentile(latencies, 0.5),
+    p99Ms: percentile(latencies, 0.99),
+  };
+}
+
+// Calls |call| |count| times one after another, |call| gets a callback to be
+// invoked when the round trip finishes.
+function measureRoundTrips(count, call, callback) {
+  var latencies = [];
+  var i = 0;
+  var next = function() {
+    if (i++ === count)
+      return callback(latencies);
+    var start = now();
+    call(function() {
+      latencies.push(now() - start);
+      next();
+    });
+  };
+  next();
+}
+
+function benchSend(name, count, callback) {
+  var payload = payloads.create(name);
+  var pending = {};
+  ipc.on('bench-ack', function(id) {
+    var done = pending[id];
+    delete pending[id];
+    if (done)
+      done();
+  });
+  var nextId = 0;
+  var send = function(done) {
+    var id = nextId++;
+    pending[id] = done;
+    ipc.send('bench-send', id, payload);
+  };
+
+  measureRoundTrips(count, send, function(latencies) {
+    // Throughput: send everything at once and wait for all the acks.
+    var received = 0;
+    var start = now();
+    for (var i = 0; i < count; ++i) {
+      send(function() {
+        if (++received !== count)
+          return;
+        ipc.removeAllListeners('bench-ack');
+        callback(summarize('ipc.send', name, count, now() - start, latencies));
+      });
+    }
+  });
+}
+
+function benchSendSync(name, count, callback) {
+  var payload = payloads.create(name);
+  var latencies = [];
+  var start = now();
+  for (var i = 0; i < count; ++i) {
+    var begin = now();
+    ipc.sendSync('bench-send-sync', payload);
+    latencies.push(now() - begin);
+  }
+  callback(summarize('ipc.sendSync', name, count, now() - start, latencies));
+}
+
+function benchWebContentsSend(name, count, callback) {
+  // Latency: a scalar ping answered with the payload.
+  var pushed = null;
+  ipc.on('bench-pushed', function() {
+    var done = pushed;
+    pushed = null;
+    if (done)
+      done();
+  });
+  var ping = function(done) {
+    pushed = done;
+    ipc.send('bench-push', name, 1);
+  };
+
+  measureRoundTrips(count, ping, function(latencies) {
+    ipc.removeAllListeners('bench-pushed');
+    var received = 0;
+    var start = now();
+    ipc.on('bench-pushed', function() {
+      if (++received !== count)
+        return;
+      ipc.removeAllListeners('bench-pushed');
+      callback(summarize('webContents.send', name, count, now() - start,
+                         latencies));
+    });
+    ipc.send('bench-push', name, count);
+  });
+}
+
+function benchRemote(name, count, callback) {
+  var payload = payloads.create(name);
+  var latencies = [];
+  var start = now();
+  for (var i = 0; i < count; ++i) {
+    var begin = now();
+    target.echo(payload);
+    latencies.push(now() - begin);
+  }
+  callback(summarize('remote', name, count, now() - start, latencies));
+}
+
+var BENCHMARKS = [benchSend, benchSendSync, benchWebContentsSend, benchRemote];
+
+exports.run = function() {
+  var cases = [];
+  BENCHMARKS.forEach(function(bench) {
+    payloads.names.forEach(function(name) {
+      cases.push({bench: bench, payload: name});
+    });
+  });
+
+  var results = [];
+  var next = function() {
+    var current = cases.shift();
+    if (!current)
+      return ipc.send('bench-done', results);
+    try {
+      current.bench(current.payload, ITERATIONS[current.payload],
+                    function(result) {
+        results.push(result);
+        setTimeout(next, 0);
+      });
+    } catch (error) {
+      ipc.send('bench-error', error.stack);
+    }
+  };
+  next();
+};
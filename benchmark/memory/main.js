@@ -0,0 +1,235 @@
+var app = require('app');
+var ipc = require('ipc');
+var fs = require('fs');
+var path = require('path');
+var BrowserWindow = require('browser-window');
+
+// The registry of the objects referenced by renderers through remote, it is
+// not public so it is loaded from next to the public modules.
+var objectsRegistry = require(path.resolve(
+    path.dirname(require.resolve('app')), '..', '..', 'lib',
+    'objects-registry'));
+
+// How many windows and guests are opened at once.
+var counts = [1, 10, 50];
+
+// The suite fails when a measurement is over its budget, the budgets can be
+// changed with --budgets=<JSON file>.
+var budgets = {
+  // Private memory of the renderer processes per window or guest.
+  rendererPrivateBytesPerInstance: 80 * 1024 * 1024,
+  // Growth of the browser's V8 heap per window or guest while they are open.
+  browserHeapPerInstance: 1024 * 1024,
+  // Growth of the browser's V8 heap that is left after all of them are
+  // closed.
+  browserHeapLeftAfterClose: 2 * 1024 * 1024,
+  // Objects the registry still references after all of them are closed.
+  referencedObjectsLeftAfterClose: 0,
+};
+
+// How long to wait after closing, so the render views have been released.
+var CLOSE_DELAY_MS = 1000;
+
+var output = null;
+
+process.argv.forEach(function(arg) {
+  if (arg.indexOf('--output=') === 0) {
+    output = arg.substr('--output='.length);
+  } else if (arg.indexOf('--counts=') === 0) {
+    counts = arg.substr('--counts='.length).split(',').map(Number);
+  } else if (arg.indexOf('--budgets=') === 0) {
+    var custom = JSON.parse(fs.readFileSync(arg.substr('--budgets='.length)));
+    for (var name in custom)
+      budgets[name] = custom[name];
+  }
+});
+
+var pageUrl = 'file://' + path.join(__dirname, 'page.html');
+var hostUrl = 'file://' + path.join(__dirname, 'host.html');
+
+// The pages that have loaded, they are asked to collect their garbage before
+// each measurement.
+var pages = [];
+var onPageReady = null;
+
+ipc.on('bench-ready', function(event) {
+  pages.push(event.sender);
+  if (onPageReady)
+    onPageReady();
+});
+
+// Collects the garbage of all pages, then of the browser, and samples the
+// memory of every process.
+function measure(callback) {
+  pages = pages.filter(function(page) { return page.isAlive(); });
+  var pending = pages.length;
+  var sample = function() {
+    ipc.removeListener('bench-gc-done', onGcDone);
+    process.lowMemoryNotification();
+    app.getProcessMetrics(function(processes) {
+      var renderers = {
+        processes: processes.length,
+        privateBytes: 0,
+        workingSetSize: 0,
+        heapUsed: 0,
+      };
+      processes.forEach(function(metrics) {
+        renderers.privateBytes += metrics.privateBytes;
+        renderers.workingSetSize += metrics.workingSetSize;
+        renderers.heapUsed += metrics.heapUsed || 0;
+      });
+      var heap = process.getHeapStatistics();
+      callback({
+        browser: {
+          rss: process.memoryUsage().rss,
+          heapUsed: heap.usedHeapSize,
+          heapTotal: heap.totalHeapSize,
+        },
+        renderers: renderers,
+        registry: objectsRegistry.getStats(),
+      });
+    });
+  };
+  var onGcDone = function() {
+    if (--pending === 0)
+      sample();
+  };
+  ipc.on('bench-gc-done', onGcDone);
+  if (pending === 0)
+    return sample();
+  pages.forEach(function(page) { page.send('bench-gc'); });
+}
+
+// Opens |count| windows, calls |callback| with a function closing them once
+// all have loaded.
+function openWindows(count, callback) {
+  var windows = [];
+  var ready = 0;
+  onPageReady = function() {
+    if (++ready < count)
+      return;
+    onPageReady = null;
+    callback(function() {
+      windows.forEach(function(window) { window.destroy(); });
+    });
+  };
+  for (var i = 0; i < count; ++i) {
+    var window = new BrowserWindow({show: false, width: 400, height: 300});
+    window.loadUrl(pageUrl);
+    windows.push(window);
+  }
+}
+
+// Opens one window with |count| <webview>s, closing the window closes the
+// guests too.
+function openGuests(count, callback) {
+  var host = new BrowserWindow({show: false, width: 800, height: 600});
+  var ready = 0;
+  onPageReady = function() {
+    if (++ready < count)
+      return;
+    onPageReady = null;
+    callback(function() { host.destroy(); });
+  };
+  ipc.once('bench-host-ready', function(event) {
+    pages.push(event.sender);
+    event.sender.send('bench-open-guests', count, pageUrl);
+  });
+  host.loadUrl(hostUrl);
+}
+
+function difference(after, before) {
+  return {
+    browserRss: after.browser.rss - before.browser.rss,
+    browserHeapUsed: after.browser.heapUsed - before.browser.heapUsed,
+    rendererPrivateBytes: after.renderers.privateBytes -
+                          before.renderers.privateBytes,
+    trackedObjects: after.registry.trackedObjects -
+                    before.registry.trackedObjects,
+    referencedObjects: after.registry.referencedObjects -
+                       before.registry.referencedObjects,
+  };
+}
+
+// Returns the budgets |result| is over.
+function checkBudgets(result) {
+  var failures = [];
+  var check = function(name, value) {
+    if (value > budgets[name])
+      failures.push(result.name + ': ' + name + ' is ' + value +
+                    ', the budget is ' + budgets[name]);
+  };
+  check('rendererPrivateBytesPerInstance',
+        result.opened.rendererPrivateBytes / result.count);
+  check('browserHeapPerInstance',
+        result.opened.browserHeapUsed / result.count);
+  check('browserHeapLeftAfterClose', result.closed.browserHeapUsed);
+  check('referencedObjectsLeftAfterClose', result.closed.referencedObjects);
+  return failures;
+}
+
+function runCase(name, open, count, callback) {
+  measure(function(baseline) {
+    open(count, function(close) {
+      measure(function(opened) {
+        close();
+        setTimeout(function() {
+          measure(function(closed) {
+            callback({
+              name: name + ' x' + count,
+              count: count,
+              samples: {baseline: baseline, opened: opened, closed: closed},
+              opened: difference(opened, baseline),
+              closed: difference(closed, baseline),
+            });
+          });
+        }, CLOSE_DELAY_MS);
+      });
+    });
+  });
+}
+
+function finish(results) {
+  var failures = [];
+  results.forEach(function(result) {
+    failures = failures.concat(checkBudgets(result));
+  });
+  var report = JSON.stringify({
+    version: process.versions['atom-shell'],
+    platform: process.platform,
+    arch: process.arch,
+    budgets: budgets,
+    results: results,
+    failures: failures,
+  }, null, 2);
+  if (output)
+    fs.writeFileSync(output, report);
+  else
+    console.log(report);
+
+  if (failures.length > 0) {
+    failures.forEach(function(failure) { console.error(failure); });
+    process.exit(1);
+  }
+  app.quit();
+}
+
+app.on('ready', function() {
+  var cases = [];
+  counts.forEach(function(count) {
+    cases.push(['BrowserWindow', openWindows, count]);
+    cases.push(['webview', openGuests, count]);
+  });
+
+  var results = [];
+  var next = function() {
+    if (cases.length === 0)
+      return finish(results);
+    var testCase = cases.shift();
+    runCase(testCase[0], testCase[1], testCase[2], function(result) {
+      results.push(result);
+      next();
+    });
+  };
+  next();
+});
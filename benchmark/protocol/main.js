@@ -0,0 +1,132 @@
+var app = require('app');
+var ipc = require('ipc');
+var fs = require('fs');
+var os = require('os');
+var path = require('path');
+var BrowserWindow = require('browser-window');
+
+// Number of renderers loading at the same time.
+var RENDERERS = 4;
+// Requests of each case sent by every renderer, and how many of them are in
+// flight at once.
+var REQUESTS = 500;
+var CONCURRENCY = 16;
+
+var windows = [];
+var output = null;
+
+process.argv.forEach(function(arg) {
+  if (arg.indexOf('--output=') === 0)
+    output = arg.substr('--output='.length);
+});
+
+var stringData = new Array(64 * 1024 + 1).join('x');
+var bufferData = new Buffer(1024 * 1024);
+bufferData.fill('y');
+var filePath = path.join(os.tmpdir(), 'atom-shell-protocol-benchmark.bin');
+var asarPath = path.join(__dirname, '..', '..', 'spec', 'fixtures', 'asar',
+                         'a.asar', 'file1');
+
+function registerHandlers() {
+  var protocol = require('protocol');
+  fs.writeFileSync(filePath, bufferData);
+
+  protocol.registerProtocol('bench-string', function() {
+    return new protocol.RequestStringJob({data: stringData});
+  });
+  protocol.registerProtocol('bench-buffer', function() {
+    return new protocol.RequestBufferJob({data: bufferData});
+  });
+  protocol.registerProtocol('bench-file', function() {
+    return new protocol.RequestFileJob(filePath);
+  });
+  protocol.registerProtocol('bench-asar', function() {
+    return new protocol.RequestFileJob(asarPath);
+  });
+}
+
+var CASES = ['bench-string', 'bench-buffer', 'bench-file', 'bench-asar'];
+
+function percentile(sorted, p) {
+  var index = Math.min(sorted.length - 1, Math.floor(sorted.length * p));
+  return sorted[index];
+}
+
+// Merges the reports of all renderers for one case.
+function summarize(scheme, reports) {
+  var latencies = [];
+  var bytes = 0;
+  var elapsed = 0;
+  reports.forEach(function(report) {
+    latencies = latencies.concat(report.latencies);
+    bytes += report.bytes;
+    elapsed = Math.max(elapsed, report.elapsed);
+  });
+  latencies.sort(function(a, b) { return a - b; });
+  return {
+    name: scheme,
+    renderers: reports.length,
+    requests: latencies.length,
+    requestsPerSecond: latencies.length / (elapsed / 1e3),
+    bytesPerSecond: bytes / (elapsed / 1e3),
+    p50Ms: percentile(latencies, 0.5),
+    p90Ms: percentile(latencies, 0.9),
+    p99Ms: percentile(latencies, 0.99),
+  };
+}
+
+var results = [];
+var reports = [];
+
+function runNextCase() {
+  var scheme = CASES[results.length];
+  if (!scheme)
+    return finish();
+  reports = [];
+  windows.forEach(function(window) {
+    window.webContents.send('bench-run', scheme, REQUESTS, CONCURRENCY);
+  });
+}
+
+function finish() {
+  var report = JSON.stringify({
+    version: process.versions['atom-shell'],
+    platform: process.platform,
+    arch: process.arch,
+    results: results,
+  }, null, 2);
+  if (output)
+    fs.writeFileSync(output, report);
+  else
+    console.log(report);
+  fs.unlinkSync(filePath);
+  app.quit();
+}
+
+var ready = 0;
+ipc.on('bench-ready', function() {
+  if (++ready === RENDERERS)
+    runNextCase();
+});
+
+ipc.on('bench-report', function(event, scheme, report) {
+  reports.push(report);
+  if (reports.length !== RENDERERS)
+    return;
+  results.push(summarize(scheme, reports));
+  runNextCase();
+});
+
+ipc.on('bench-error', function(event, message) {
+  console.error(message);
+  process.exit(1);
+});
+
+app.on('ready', function() {
+  registerHandlers();
+  for (var i = 0; i < RENDERERS; ++i) {
+    var window = new BrowserWindow({show: false});
+    window.loadUrl('file://' + __dirname + '/index.html');
+    windows.push(window);
+  }
+});
@@ -0,0 +1,63 @@
+var ipc = require('ipc');
+
+function now() {
+  var time = process.hrtime();
+  return time[0] * 1e3 + time[1] / 1e6;
+}
+
+function load(url, callback) {
+  var xhr = new XMLHttpRequest();
+  xhr.open('GET', url);
+  xhr.responseType = 'arraybuffer';
+  xhr.onload = function() {
+    callback(null, xhr.response ? xhr.response.byteLength : 0);
+  };
+  xhr.onerror = function() {
+    callback(new Error('Failed to load ' + url));
+  };
+  xhr.send();
+}
+
+// Sends |count| requests to |scheme| keeping |concurrency| of them in flight.
+function runCase(scheme, count, concurrency) {
+  var latencies = [];
+  var bytes = 0;
+  var sent = 0;
+  var finished = 0;
+  var failed = false;
+  var start = now();
+
+  var next = function() {
+    if (sent === count)
+      return;
+    // Unique URLs so nothing is served from the memory cache of renderer.
+    var url = scheme + '://host/' + (sent++) + '-' + Math.random();
+    var begin = now();
+    load(url, function(error, length) {
+      if (failed)
+        return;
+      if (error) {
+        failed = true;
+        return ipc.send('bench-error', error.message);
+      }
+      latencies.push(now() - begin);
+      bytes += length;
+      if (++finished === count)
+        ipc.send('bench-report', scheme, {
+          latencies: latencies,
+          bytes: bytes,
+          elapsed: now() - start,
+        });
+      else
+        next();
+    });
+  };
+
+  for (var i = 0; i < concurrency; ++i)
+    next();
+}
+
+exports.run = function() {
+  ipc.on('bench-run', runCase);
+  ipc.send('bench-ready');
+};
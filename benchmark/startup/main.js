@@ -0,0 +1,217 @@
+var app = require('app');
+var fs = require('fs');
+var os = require('os');
+var path = require('path');
+var childProcess = require('child_process');
+
+// Number of launches measured after the first one, which is reported on its
+// own since it is the only one that may read the binary from the disk.
+var launches = 10;
+// Number of windows opened by each launch, one after another.
+var windows = 5;
+
+var output = null;
+var report = null;
+
+process.argv.forEach(function(arg) {
+  if (arg.indexOf('--output=') === 0)
+    output = arg.substr('--output='.length);
+  else if (arg.indexOf('--report=') === 0)
+    report = arg.substr('--report='.length);
+  else if (arg.indexOf('--launches=') === 0)
+    launches = Math.max(1, parseInt(arg.substr('--launches='.length)));
+  else if (arg.indexOf('--windows=') === 0)
+    windows = Math.max(1, parseInt(arg.substr('--windows='.length)));
+});
+
+function now() {
+  var time = process.hrtime();
+  return time[0] * 1e3 + time[1] / 1e6;
+}
+
+// The launched app: opens the windows one by one, and reports the startup
+// milestones of both processes, how long each window took to load and the
+// memory used with each number of windows.
+function runLaunch() {
+  var ipc = require('ipc');
+  var BrowserWindow = require('browser-window');
+
+  // The milestones are relative to the creation of the process, the time
+  // |now| had then is known once the ready milestone has been reached.
+  var origin = 0;
+  var opened = [];
+  var pending = null;
+  var result = {windows: []};
+
+  var openWindow = function() {
+    var start = now();
+    var window = new BrowserWindow({width: 400, height: 300});
+    var loaded = null;
+    var renderer = null;
+    var done = function() {
+      if (loaded === null || renderer === null)
+        return;
+      var rendererRss = renderer.rss;
+      opened.forEach(function(previous) { rendererRss += previous.rss; });
+      opened.push(renderer);
+      result.windows.push({
+        openMs: loaded - start,
+        browserRss: process.memoryUsage().rss,
+        rendererRss: rendererRss,
+      });
+      if (opened.length === 1) {
+        result.firstLoad = loaded - origin;
+        result.renderer = renderer.timings;
+      }
+      next();
+    };
+    pending = function(rendererReport) {
+      renderer = rendererReport;
+      done();
+    };
+    window.webContents.once('did-finish-load', function() {
+      loaded = now();
+      done();
+    });
+    window.loadUrl('file://' + __dirname + '/index.html');
+  };
+
+  var next = function() {
+    if (opened.length < windows)
+      return openWindow();
+    // Give the first paint a chance to be recorded.
+    setTimeout(function() {
+      result.browser = process.getStartupTimings();
+      fs.writeFileSync(report, JSON.stringify(result));
+      app.quit();
+    }, 100);
+  };
+
+  ipc.on('bench-timings', function(event, rendererReport) {
+    pending(rendererReport);
+  });
+
+  app.on('ready', function() {
+    var milestones = process.getStartupTimings();
+    milestones.forEach(function(milestone) {
+      if (milestone.name === 'ready') {
+        origin = now() - milestone.time;
+        result.ready = milestone.time;
+      }
+    });
+    openWindow();
+  });
+}
+
+function percentile(sorted, p) {
+  var index = Math.min(sorted.length - 1, Math.floor(sorted.length * p));
+  return sorted[index];
+}
+
+function distribution(values) {
+  var sorted = values.slice().sort(function(a, b) { return a - b; });
+  return {
+    samples: sorted.length,
+    min: sorted[0],
+    p50: percentile(sorted, 0.5),
+    p90: percentile(sorted, 0.9),
+    p99: percentile(sorted, 0.99),
+    max: sorted[sorted.length - 1],
+  };
+}
+
+// Merges the milestones of all launches of one process type.
+function summarize(milestonesOfLaunches) {
+  var times = {};
+  var names = [];
+  milestonesOfLaunches.forEach(function(milestones) {
+    milestones.forEach(function(milestone) {
+      if (!times[milestone.name]) {
+        times[milestone.name] = [];
+        names.push(milestone.name);
+      }
+      times[milestone.name].push(milestone.time);
+    });
+  });
+  return names.map(function(name) {
+    var summary = distribution(times[name]);
+    summary.name = name;
+    return summary;
+  });
+}
+
+// The metrics of every launch, with the windows' ones grouped by how many
+// windows were open.
+function summarizeLaunches(results) {
+  var pick = function(key) {
+    return results.map(function(result) { return result[key]; });
+  };
+  var perWindow = [];
+  for (var i = 0; i < windows; ++i) {
+    var windowResults = results.map(function(result) {
+      return result.windows[i];
+    });
+    var pickWindow = function(key) {
+      return windowResults.map(function(result) { return result[key]; });
+    };
+    perWindow.push({
+      windows: i + 1,
+      openMs: distribution(pickWindow('openMs')),
+      browserRss: distribution(pickWindow('browserRss')),
+      rendererRss: distribution(pickWindow('rendererRss')),
+    });
+  }
+
+  var paints = [];
+  results.forEach(function(result) {
+    result.browser.forEach(function(milestone) {
+      if (milestone.name === 'first-window-paint')
+        paints.push(milestone.time);
+    });
+  });
+  return {
+    launches: results.length,
+    readyMs: distribution(pick('ready')),
+    firstLoadMs: distribution(pick('firstLoad')),
+    firstPaintMs: paints.length > 0 ? distribution(paints) : null,
+    windows: perWindow,
+    browser: summarize(pick('browser')),
+    renderer: summarize(pick('renderer')),
+  };
+}
+
+function runBenchmark() {
+  var reportPath = path.join(os.tmpdir(),
+                             'atom-shell-startup-benchmark-' + process.pid +
+                             '.json');
+  var results = [];
+  for (var i = 0; i <= launches; ++i) {
+    var launch = childProcess.spawnSync(
+        process.execPath, [__dirname, '--report=' + reportPath,
+                           '--windows=' + windows]);
+    if (launch.status !== 0) {
+      console.error('Launch failed: ' + launch.stderr);
+      process.exit(1);
+    }
+    results.push(JSON.parse(fs.readFileSync(reportPath)));
+  }
+  fs.unlinkSync(reportPath);
+
+  var json = JSON.stringify({
+    version: process.versions['atom-shell'],
+    platform: process.platform,
+    arch: process.arch,
+    cold: summarizeLaunches(results.slice(0, 1)),
+    warm: summarizeLaunches(results.slice(1)),
+  }, null, 2);
+  if (output)
+    fs.writeFileSync(output, json);
+  else
+    console.log(json);
+  app.quit();
+}
+
+if (report)
+  runLaunch();
+else
+  app.on('ready', runBenchmark);
@@ -11,8 +11,6 @@ BrowserProcess* g_browser_process = NULL;
 
 BrowserProcess::BrowserProcess() {
   g_browser_process = this;
-
-  print_job_manager_.reset(new printing::PrintJobManager);
 }
 
 BrowserProcess::~BrowserProcess() {
@@ -24,5 +22,7 @@ std::string BrowserProcess::GetApplicationLocale() {
 }
 
 printing::PrintJobManager* BrowserProcess::print_job_manager() {
+  if (!print_job_manager_)
+    print_job_manager_.reset(new printing::PrintJobManager);
   return print_job_manager_.get();
 }
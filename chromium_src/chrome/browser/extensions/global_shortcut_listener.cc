@@ -4,6 +4,8 @@
 
 #include "chrome/browser/extensions/global_shortcut_listener.h"
 
+#include <set>
+
 #include "base/logging.h"
 #include "content/public/browser/browser_thread.h"
 #include "ui/base/accelerators/accelerator.h"
@@ -47,6 +49,42 @@ bool GlobalShortcutListener::RegisterAccelerator(
   return true;
 }
 
+std::vector<bool> GlobalShortcutListener::RegisterAccelerators(
+    const std::vector<ui::Accelerator>& accelerators, Observer* observer) {
+  CHECK(BrowserThread::CurrentlyOn(BrowserThread::UI));
+  std::vector<bool> results(accelerators.size(), false);
+  if (IsShortcutHandlingSuspended())
+    return results;
+
+  // Skip the ones that have been registered, or appear more than once.
+  std::set<ui::Accelerator> seen;
+  std::vector<ui::Accelerator> to_register;
+  std::vector<size_t> indexes;
+  for (size_t i = 0; i < accelerators.size(); ++i) {
+    if (accelerator_map_.find(accelerators[i]) != accelerator_map_.end() ||
+        !seen.insert(accelerators[i]).second)
+      continue;
+    to_register.push_back(accelerators[i]);
+    indexes.push_back(i);
+  }
+  if (to_register.empty())
+    return results;
+
+  std::vector<bool> registered = RegisterAcceleratorsImpl(to_register);
+  DCHECK_EQ(registered.size(), to_register.size());
+
+  bool was_listening = !accelerator_map_.empty();
+  for (size_t i = 0; i < to_register.size(); ++i) {
+    if (!registered[i])
+      continue;
+    accelerator_map_[to_register[i]] = observer;
+    results[indexes[i]] = true;
+  }
+  if (!was_listening && !accelerator_map_.empty())
+    StartListening();
+  return results;
+}
+
 void GlobalShortcutListener::UnregisterAccelerator(
     const ui::Accelerator& accelerator, Observer* observer) {
   CHECK(BrowserThread::CurrentlyOn(BrowserThread::UI));
@@ -102,6 +140,14 @@ void GlobalShortcutListener::SetShortcutHandlingSuspended(bool suspended) {
   }
 }
 
+std::vector<bool> GlobalShortcutListener::RegisterAcceleratorsImpl(
+    const std::vector<ui::Accelerator>& accelerators) {
+  std::vector<bool> results;
+  for (size_t i = 0; i < accelerators.size(); ++i)
+    results.push_back(RegisterAcceleratorImpl(accelerators[i]));
+  return results;
+}
+
 bool GlobalShortcutListener::IsShortcutHandlingSuspended() const {
   return shortcut_handling_suspended_;
 }
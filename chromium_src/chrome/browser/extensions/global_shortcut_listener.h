@@ -6,6 +6,7 @@
 #define CHROME_BROWSER_EXTENSIONS_GLOBAL_SHORTCUT_LISTENER_H_
 
 #include <map>
+#include <vector>
 
 #include "base/basictypes.h"
 #include "ui/events/keycodes/keyboard_codes.h"
@@ -42,6 +43,13 @@ class GlobalShortcutListener {
   bool RegisterAccelerator(const ui::Accelerator& accelerator,
                            Observer* observer);
 
+  // Like RegisterAccelerator but registers all the |accelerators| at once,
+  // which is much faster on platforms that talk to a server. Returns whether
+  // each of them has been registered.
+  std::vector<bool> RegisterAccelerators(
+      const std::vector<ui::Accelerator>& accelerators,
+      Observer* observer);
+
   // Stop listening for the given |accelerator|, does nothing if shortcut
   // handling is suspended.
   void UnregisterAccelerator(const ui::Accelerator& accelerator,
@@ -83,6 +91,11 @@ class GlobalShortcutListener {
   virtual void UnregisterAcceleratorImpl(
       const ui::Accelerator& accelerator) = 0;
 
+  // Registers the |accelerators| that are known to be not registered, calls
+  // RegisterAcceleratorImpl for each of them by default.
+  virtual std::vector<bool> RegisterAcceleratorsImpl(
+      const std::vector<ui::Accelerator>& accelerators);
+
   // The map of accelerators that have been successfully registered as global
   // shortcuts and their observer.
   typedef std::map<ui::Accelerator, Observer*> AcceleratorMap;
@@ -39,6 +39,15 @@ int GetNativeModifiers(const ui::Accelerator& accelerator) {
   return modifiers;
 }
 
+// The serial numbers of the requests that failed while registering in bulk.
+std::vector<unsigned long>* g_failed_serials = NULL;  // NOLINT
+
+int OnGrabKeyError(Display* display, XErrorEvent* error) {
+  if (g_failed_serials)
+    g_failed_serials->push_back(error->serial);
+  return 0;
+}
+
 }  // namespace
 
 namespace extensions {
@@ -100,26 +109,12 @@ bool GlobalShortcutListenerX11::RegisterAcceleratorImpl(
     const ui::Accelerator& accelerator) {
   DCHECK(registered_hot_keys_.find(accelerator) == registered_hot_keys_.end());
 
-  int modifiers = GetNativeModifiers(accelerator);
-  KeyCode keycode = XKeysymToKeycode(x_display_,
-      XKeysymForWindowsKeyCode(accelerator.key_code(), false));
   gfx::X11ErrorTracker err_tracker;
-
-  // Because XGrabKey only works on the exact modifiers mask, we should register
-  // our hot keys with modifiers that we want to ignore, including Num lock,
-  // Caps lock, Scroll lock. See comment about |kModifiersMasks|.
-  for (size_t i = 0; i < arraysize(kModifiersMasks); ++i) {
-    XGrabKey(x_display_, keycode, modifiers | kModifiersMasks[i],
-             x_root_window_, False, GrabModeAsync, GrabModeAsync);
-  }
+  GrabKey(accelerator);
 
   if (err_tracker.FoundNewError()) {
     // We may have part of the hotkeys registered, clean up.
-    for (size_t i = 0; i < arraysize(kModifiersMasks); ++i) {
-      XUngrabKey(x_display_, keycode, modifiers | kModifiersMasks[i],
-                 x_root_window_);
-    }
-
+    UngrabKey(accelerator);
     return false;
   }
 
@@ -131,6 +126,71 @@ void GlobalShortcutListenerX11::UnregisterAcceleratorImpl(
     const ui::Accelerator& accelerator) {
   DCHECK(registered_hot_keys_.find(accelerator) != registered_hot_keys_.end());
 
+  UngrabKey(accelerator);
+  registered_hot_keys_.erase(accelerator);
+}
+
+std::vector<bool> GlobalShortcutListenerX11::RegisterAcceleratorsImpl(
+    const std::vector<ui::Accelerator>& accelerators) {
+  // Flush the errors of earlier requests before catching ours.
+  XSync(x_display_, False);
+  std::vector<unsigned long> failed_serials;  // NOLINT
+  g_failed_serials = &failed_serials;
+  XErrorHandler old_handler = XSetErrorHandler(OnGrabKeyError);
+
+  // Issue all the grabs and wait for the server only once, the failed grabs
+  // are told apart by the serial numbers of their requests.
+  std::vector<unsigned long> first_serials;  // NOLINT
+  for (size_t i = 0; i < accelerators.size(); ++i) {
+    DCHECK(registered_hot_keys_.find(accelerators[i]) ==
+           registered_hot_keys_.end());
+    first_serials.push_back(NextRequest(x_display_));
+    GrabKey(accelerators[i]);
+  }
+  first_serials.push_back(NextRequest(x_display_));
+  XSync(x_display_, False);
+
+  XSetErrorHandler(old_handler);
+  g_failed_serials = NULL;
+
+  std::vector<bool> results(accelerators.size(), true);
+  for (size_t i = 0; i < failed_serials.size(); ++i) {
+    for (size_t j = 0; j < accelerators.size(); ++j) {
+      if (failed_serials[i] >= first_serials[j] &&
+          failed_serials[i] < first_serials[j + 1]) {
+        results[j] = false;
+        break;
+      }
+    }
+  }
+
+  for (size_t i = 0; i < accelerators.size(); ++i) {
+    if (results[i]) {
+      registered_hot_keys_.insert(accelerators[i]);
+    } else {
+      // We may have part of the hotkeys registered, clean up.
+      UngrabKey(accelerators[i]);
+    }
+  }
+  XFlush(x_display_);
+  return results;
+}
+
+void GlobalShortcutListenerX11::GrabKey(const ui::Accelerator& accelerator) {
+  int modifiers = GetNativeModifiers(accelerator);
+  KeyCode keycode = XKeysymToKeycode(x_display_,
+      XKeysymForWindowsKeyCode(accelerator.key_code(), false));
+
+  // Because XGrabKey only works on the exact modifiers mask, we should register
+  // our hot keys with modifiers that we want to ignore, including Num lock,
+  // Caps lock, Scroll lock. See comment about |kModifiersMasks|.
+  for (size_t i = 0; i < arraysize(kModifiersMasks); ++i) {
+    XGrabKey(x_display_, keycode, modifiers | kModifiersMasks[i],
+             x_root_window_, False, GrabModeAsync, GrabModeAsync);
+  }
+}
+
+void GlobalShortcutListenerX11::UngrabKey(const ui::Accelerator& accelerator) {
   int modifiers = GetNativeModifiers(accelerator);
   KeyCode keycode = XKeysymToKeycode(x_display_,
       XKeysymForWindowsKeyCode(accelerator.key_code(), false));
@@ -139,7 +199,6 @@ void GlobalShortcutListenerX11::UnregisterAcceleratorImpl(
     XUngrabKey(x_display_, keycode, modifiers | kModifiersMasks[i],
                x_root_window_);
   }
-  registered_hot_keys_.erase(accelerator);
 }
 
 void GlobalShortcutListenerX11::OnXKeyPressEvent(::XEvent* x_event) {
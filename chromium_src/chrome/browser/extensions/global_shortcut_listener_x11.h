@@ -7,6 +7,7 @@
 
 #include <X11/Xlib.h>
 #include <set>
+#include <vector>
 
 #include "chrome/browser/extensions/global_shortcut_listener.h"
 #include "ui/events/platform/platform_event_dispatcher.h"
@@ -34,6 +35,12 @@ class GlobalShortcutListenerX11 : public GlobalShortcutListener,
       const ui::Accelerator& accelerator) override;
   virtual void UnregisterAcceleratorImpl(
       const ui::Accelerator& accelerator) override;
+  virtual std::vector<bool> RegisterAcceleratorsImpl(
+      const std::vector<ui::Accelerator>& accelerators) override;
+
+  // Grabs or ungrabs the key of |accelerator| with all the ignored modifiers.
+  void GrabKey(const ui::Accelerator& accelerator);
+  void UngrabKey(const ui::Accelerator& accelerator);
 
   // Invoked when a global shortcut is pressed.
   void OnXKeyPressEvent(::XEvent* x_event);
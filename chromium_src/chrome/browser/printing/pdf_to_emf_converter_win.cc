@@ -0,0 +1,163 @@
+// Copyright (c) 2015 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#include "chrome/browser/printing/pdf_to_emf_converter_win.h"
+
+#include "base/bind.h"
+#include "base/files/file_path.h"
+#include "base/lazy_instance.h"
+#include "base/location.h"
+#include "base/logging.h"
+#include "base/path_service.h"
+#include "base/scoped_native_library.h"
+#include "base/threading/sequenced_worker_pool.h"
+#include "base/thread_task_runner_handle.h"
+#include "content/public/browser/browser_thread.h"
+#include "printing/emf_win.h"
+#include "ui/gfx/gdi_util.h"
+
+namespace printing {
+
+namespace {
+
+typedef bool (*RenderPDFPageToDCProc)(
+    const unsigned char* pdf_buffer, int buffer_size, int page_number, HDC dc,
+    int dpi, int bounds_origin_x, int bounds_origin_y,
+    int bounds_width, int bounds_height, bool fit_to_bounds,
+    bool stretch_to_bounds, bool keep_aspect_ratio, bool center_in_bounds,
+    bool autorotate);
+
+typedef bool (*GetPDFDocInfoProc)(const unsigned char* pdf_buffer,
+                                  int buffer_size, int* page_count,
+                                  double* max_page_width);
+
+// The PDF library, which is loaded on first use and never unloaded. It keeps
+// global state of its own and is not thread-safe, so it is only called on
+// the sequence of |kPdfSequenceName|.
+class PdfLibrary {
+ public:
+  PdfLibrary() : render_page_(NULL), get_info_(NULL) {
+    base::FilePath module_path;
+    if (!PathService::Get(base::DIR_MODULE, &module_path))
+      return;
+    library_.Reset(base::LoadNativeLibrary(
+        module_path.Append(FILE_PATH_LITERAL("pdf.dll")), NULL));
+    if (!library_.is_valid()) {
+      LOG(ERROR) << "pdf.dll is not found beside the executable, "
+                    "printing is not available";
+      return;
+    }
+    render_page_ = reinterpret_cast<RenderPDFPageToDCProc>(
+        library_.GetFunctionPointer("RenderPDFPageToDC"));
+    get_info_ = reinterpret_cast<GetPDFDocInfoProc>(
+        library_.GetFunctionPointer("GetPDFDocInfo"));
+  }
+
+  bool IsValid() const { return render_page_ && get_info_; }
+
+  int GetPageCount(const base::RefCountedMemory* data) {
+    int page_count = 0;
+    if (!IsValid() ||
+        !get_info_(data->front(), static_cast<int>(data->size()),
+                   &page_count, NULL))
+      return 0;
+    return page_count;
+  }
+
+  bool RenderPage(const base::RefCountedMemory* data, int page_index,
+                  HDC dc, int dpi, const gfx::Rect& area) {
+    return IsValid() &&
+           render_page_(data->front(), static_cast<int>(data->size()),
+                        page_index, dc, dpi, area.x(), area.y(),
+                        area.width(), area.height(), true, false, true, true,
+                        true);
+  }
+
+ private:
+  base::ScopedNativeLibrary library_;
+  RenderPDFPageToDCProc render_page_;
+  GetPDFDocInfoProc get_info_;
+
+  DISALLOW_COPY_AND_ASSIGN(PdfLibrary);
+};
+
+base::LazyInstance<PdfLibrary>::Leaky g_pdf_library =
+    LAZY_INSTANCE_INITIALIZER;
+
+// All conversions, of all print jobs, share one sequence of the blocking pool.
+const char kPdfSequenceName[] = "PdfToEmfConverter";
+
+bool PostToBlockingPool(const base::Closure& task) {
+  base::SequencedWorkerPool* pool = content::BrowserThread::GetBlockingPool();
+  return pool->PostSequencedWorkerTaskWithShutdownBehavior(
+      pool->GetNamedSequenceToken(kPdfSequenceName), FROM_HERE, task,
+      base::SequencedWorkerPool::SKIP_ON_SHUTDOWN);
+}
+
+}  // namespace
+
+PdfToEmfConverter::PdfToEmfConverter(
+    const scoped_refptr<base::RefCountedMemory>& data,
+    const gfx::Rect& area,
+    int dpi)
+    : data_(data),
+      area_(area),
+      dpi_(dpi) {
+}
+
+PdfToEmfConverter::~PdfToEmfConverter() {
+}
+
+void PdfToEmfConverter::Start(const StartCallback& callback) {
+  PostToBlockingPool(base::Bind(&PdfToEmfConverter::GetPageCount, this,
+                                base::ThreadTaskRunnerHandle::Get(),
+                                callback));
+}
+
+void PdfToEmfConverter::ConvertPage(int page_index,
+                                    const PageCallback& callback) {
+  PostToBlockingPool(base::Bind(&PdfToEmfConverter::RenderPage, this,
+                                page_index,
+                                base::ThreadTaskRunnerHandle::Get(),
+                                callback));
+}
+
+void PdfToEmfConverter::GetPageCount(
+    scoped_refptr<base::SingleThreadTaskRunner> reply_runner,
+    const StartCallback& callback) {
+  int page_count = g_pdf_library.Get().GetPageCount(data_.get());
+  reply_runner->PostTask(FROM_HERE, base::Bind(callback, page_count));
+}
+
+void PdfToEmfConverter::RenderPage(
+    int page_index,
+    scoped_refptr<base::SingleThreadTaskRunner> reply_runner,
+    const PageCallback& callback) {
+  scoped_ptr<Emf> emf(new Emf);
+  float scale_factor = 1.0f;
+  if (emf->Init()) {
+    // The metafile is based on the screen DC, so the page is scaled down to
+    // fit in it. The original coordinates are still recorded, and the scale
+    // is countered when the page is played on the printer.
+    scale_factor = static_cast<float>(gfx::CalculatePageScale(
+        emf->context(), area_.right(), area_.bottom()));
+    gfx::ScaleDC(emf->context(), scale_factor);
+
+    // The arguments are ignored by EMF.
+    emf->StartPage(gfx::Size(), gfx::Rect(), 1);
+    bool rendered = g_pdf_library.Get().RenderPage(
+        data_.get(), page_index, emf->context(), dpi_, area_);
+    if (!emf->FinishPage() || !emf->FinishDocument() || !rendered)
+      emf.reset();
+  } else {
+    emf.reset();
+  }
+
+  scoped_ptr<MetafilePlayer> result(emf.Pass());
+  reply_runner->PostTask(
+      FROM_HERE,
+      base::Bind(callback, page_index, scale_factor, base::Passed(&result)));
+}
+
+}  // namespace printing
@@ -0,0 +1,70 @@
+// Copyright (c) 2015 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#ifndef CHROME_BROWSER_PRINTING_PDF_TO_EMF_CONVERTER_WIN_H_
+#define CHROME_BROWSER_PRINTING_PDF_TO_EMF_CONVERTER_WIN_H_
+
+#include "base/callback.h"
+#include "base/memory/ref_counted.h"
+#include "base/memory/ref_counted_memory.h"
+#include "base/memory/scoped_ptr.h"
+#include "ui/gfx/geometry/rect.h"
+
+namespace base {
+class SingleThreadTaskRunner;
+}
+
+namespace printing {
+
+class MetafilePlayer;
+
+// Converts the pages of a PDF document into EMF metafiles that can be played
+// on the printer's DC, with the PDF library of Chrome's PDF plugin. pdf.dll is
+// not built with atom-shell, apps that print on Windows have to put it beside
+// the executable, without it the document has no pages.
+//
+// The PDF library is not thread-safe, so the pages of all converters are
+// converted one by one on a single sequence of the blocking pool, and the
+// replies come in the order the pages were requested. Should be used on UI
+// thread.
+class PdfToEmfConverter
+    : public base::RefCountedThreadSafe<PdfToEmfConverter> {
+ public:
+  // |page_count| is 0 when the document can not be read.
+  typedef base::Callback<void(int page_count)> StartCallback;
+  // |emf| is NULL when the page can not be converted.
+  typedef base::Callback<void(int page_index,
+                              float scale_factor,
+                              scoped_ptr<MetafilePlayer> emf)> PageCallback;
+
+  // The pages are rendered into |area| of the printer in |dpi|.
+  PdfToEmfConverter(const scoped_refptr<base::RefCountedMemory>& data,
+                    const gfx::Rect& area,
+                    int dpi);
+
+  void Start(const StartCallback& callback);
+  void ConvertPage(int page_index, const PageCallback& callback);
+
+ private:
+  friend class base::RefCountedThreadSafe<PdfToEmfConverter>;
+
+  ~PdfToEmfConverter();
+
+  // Run on the blocking pool.
+  void GetPageCount(scoped_refptr<base::SingleThreadTaskRunner> reply_runner,
+                    const StartCallback& callback);
+  void RenderPage(int page_index,
+                  scoped_refptr<base::SingleThreadTaskRunner> reply_runner,
+                  const PageCallback& callback);
+
+  scoped_refptr<base::RefCountedMemory> data_;
+  gfx::Rect area_;
+  int dpi_;
+
+  DISALLOW_COPY_AND_ASSIGN(PdfToEmfConverter);
+};
+
+}  // namespace printing
+
+#endif  // CHROME_BROWSER_PRINTING_PDF_TO_EMF_CONVERTER_WIN_H_
@@ -17,6 +17,14 @@
 #include "printing/printed_document.h"
 #include "printing/printed_page.h"
 
+#if defined(OS_WIN)
+#include <vector>
+
+#include "chrome/browser/printing/pdf_to_emf_converter_win.h"
+#include "printing/metafile.h"
+#include "printing/page_number.h"
+#endif
+
 using base::TimeDelta;
 
 namespace {
@@ -27,10 +35,62 @@ void HoldRefCallback(const scoped_refptr<printing::PrintJobWorkerOwner>& owner,
   callback.Run();
 }
 
+#if defined(OS_WIN)
+// The DPI the PDF pages are rendered in.
+const int kPrinterDpi = 600;
+#endif
+
 }  // namespace
 
 namespace printing {
 
+#if defined(OS_WIN)
+// Converts the pages one after another, so the next page is converted while
+// the worker spools the last one.
+class PrintJob::PdfToEmfState {
+ public:
+  PdfToEmfState(const scoped_refptr<base::RefCountedMemory>& bytes,
+                const gfx::Size& page_size,
+                const gfx::Rect& content_area)
+      : converter_(new PdfToEmfConverter(bytes, content_area, kPrinterDpi)),
+        page_size_(page_size),
+        content_area_(content_area),
+        next_page_(0) {
+  }
+
+  PdfToEmfConverter* converter() const { return converter_.get(); }
+  const gfx::Size& page_size() const { return page_size_; }
+  const gfx::Rect& content_area() const { return content_area_; }
+
+  // The |page_numbers| of the document that the pages of PDF are for.
+  void set_page_numbers(const std::vector<int>& page_numbers) {
+    page_numbers_ = page_numbers;
+  }
+
+  bool IsDone() const {
+    return next_page_ == static_cast<int>(page_numbers_.size());
+  }
+
+  void ConvertNextPage(const PdfToEmfConverter::PageCallback& callback) {
+    converter_->ConvertPage(next_page_, callback);
+  }
+
+  // Returns the page number of the page that has just been converted.
+  int TakeConvertedPage() {
+    return page_numbers_[next_page_++];
+  }
+
+ private:
+  scoped_refptr<PdfToEmfConverter> converter_;
+  gfx::Size page_size_;
+  gfx::Rect content_area_;
+  std::vector<int> page_numbers_;
+  int next_page_;
+
+  DISALLOW_COPY_AND_ASSIGN(PdfToEmfState);
+};
+#endif  // defined(OS_WIN)
+
 PrintJob::PrintJob()
     : source_(NULL),
       worker_(),
@@ -214,6 +274,72 @@ PrintedDocument* PrintJob::document() const {
   return document_.get();
 }
 
+#if defined(OS_WIN)
+void PrintJob::StartPdfToEmfConversion(
+    const scoped_refptr<base::RefCountedMemory>& bytes,
+    const gfx::Size& page_size,
+    const gfx::Rect& content_area) {
+  DCHECK(!pdf_to_emf_state_);
+  pdf_to_emf_state_.reset(new PdfToEmfState(bytes, page_size, content_area));
+  pdf_to_emf_state_->converter()->Start(
+      base::Bind(&PrintJob::OnPdfToEmfStarted, this));
+}
+
+void PrintJob::OnPdfToEmfStarted(int page_count) {
+  if (!pdf_to_emf_state_)
+    return;
+  if (page_count <= 0 || !document_.get()) {
+    pdf_to_emf_state_.reset();
+    Cancel();
+    return;
+  }
+
+  // The PDF only has the pages that are printed, in the order they are
+  // printed.
+  std::vector<int> page_numbers;
+  PageNumber page_number(document_->settings(), document_->page_count());
+  for (; page_number != PageNumber::npos() &&
+         static_cast<int>(page_numbers.size()) < page_count;
+       ++page_number)
+    page_numbers.push_back(page_number.ToInt());
+  pdf_to_emf_state_->set_page_numbers(page_numbers);
+  pdf_to_emf_state_->ConvertNextPage(
+      base::Bind(&PrintJob::OnPdfToEmfPageConverted, this));
+}
+
+void PrintJob::OnPdfToEmfPageConverted(int page_index,
+                                       float scale_factor,
+                                       scoped_ptr<MetafilePlayer> emf) {
+  if (!pdf_to_emf_state_)
+    return;
+  if (!document_.get() || !emf) {
+    pdf_to_emf_state_.reset();
+    Cancel();
+    return;
+  }
+
+  // Update the rendered document. It will send notifications to the
+  // listener.
+  document_->SetPage(pdf_to_emf_state_->TakeConvertedPage(), emf.Pass(),
+                     scale_factor, pdf_to_emf_state_->page_size(),
+                     pdf_to_emf_state_->content_area());
+
+  // The worker would otherwise only look for the pages periodically.
+  if (worker_)
+    worker_->PostTask(FROM_HERE,
+                      base::Bind(&HoldRefCallback,
+                                 make_scoped_refptr(this),
+                                 base::Bind(&PrintJobWorker::OnNewPage,
+                                            base::Unretained(worker_.get()))));
+
+  if (pdf_to_emf_state_->IsDone())
+    pdf_to_emf_state_.reset();
+  else
+    pdf_to_emf_state_->ConvertNextPage(
+        base::Bind(&PrintJob::OnPdfToEmfPageConverted, this));
+}
+#endif  // defined(OS_WIN)
+
 void PrintJob::UpdatePrintedDocument(PrintedDocument* new_document) {
   if (document_.get() == new_document)
     return;
@@ -328,6 +454,9 @@ void PrintJob::ControlledWorkerShutdown() {
   is_job_pending_ = false;
   registrar_.RemoveAll();
   UpdatePrintedDocument(NULL);
+#if defined(OS_WIN)
+  pdf_to_emf_state_.reset();
+#endif
 }
 
 void PrintJob::HoldUntilStopIsCalled() {
@@ -19,6 +19,11 @@ namespace base {
 class RefCountedMemory;
 }
 
+namespace gfx {
+class Rect;
+class Size;
+}
+
 namespace printing {
 
 class JobEventDetails;
@@ -90,6 +95,16 @@ class PrintJob : public PrintJobWorkerOwner,
   // Access the current printed document. Warning: may be NULL.
   PrintedDocument* document() const;
 
+#if defined(OS_WIN)
+  // Converts the PDF printed by the renderer into the EMF pages of the
+  // document. The pages are converted one by one off the UI thread, each is
+  // handed to the document as soon as it is converted.
+  void StartPdfToEmfConversion(
+      const scoped_refptr<base::RefCountedMemory>& bytes,
+      const gfx::Size& page_size,
+      const gfx::Rect& content_area);
+#endif
+
  protected:
   virtual ~PrintJob();
 
@@ -113,6 +128,17 @@ class PrintJob : public PrintJobWorkerOwner,
 
   void HoldUntilStopIsCalled();
 
+#if defined(OS_WIN)
+  class PdfToEmfState;
+
+  void OnPdfToEmfStarted(int page_count);
+  void OnPdfToEmfPageConverted(int page_index,
+                               float scale_factor,
+                               scoped_ptr<MetafilePlayer> emf);
+
+  scoped_ptr<PdfToEmfState> pdf_to_emf_state_;
+#endif
+
   content::NotificationRegistrar registrar_;
 
   // Source that generates the PrintedPage's (i.e. a WebContents). It will be
@@ -4,22 +4,65 @@
 
 #include "chrome/browser/printing/print_job_manager.h"
 
+#if defined(OS_WIN)
+#include <winspool.h>
+#endif
+
+#include <algorithm>
+
+#include "base/bind.h"
+#include "base/message_loop/message_loop.h"
 #include "chrome/browser/chrome_notification_types.h"
 #include "chrome/browser/printing/print_job.h"
+#include "chrome/browser/printing/print_view_manager_basic.h"
 #include "chrome/browser/printing/printer_query.h"
 #include "content/public/browser/browser_thread.h"
 #include "content/public/browser/notification_service.h"
+#include "content/public/browser/render_process_host.h"
+#include "content/public/browser/render_view_host.h"
+#include "content/public/browser/web_contents.h"
 #include "printing/printed_document.h"
 #include "printing/printed_page.h"
 
 namespace printing {
 
+namespace {
+
+// The default settings are queried again after this long even when no change
+// of printers was noticed, since not every platform can tell it.
+const int kDefaultSettingsLifetimeInMinutes = 10;
+
+void StopPrinterQuery(const scoped_refptr<PrinterQuery>& query) {
+  if (query.get())
+    query->PostTask(FROM_HERE, base::Bind(&PrinterQuery::StopWorker, query));
+}
+
+#if defined(OS_WIN)
+bool IsDefaultPrinter(const base::string16& device_name) {
+  wchar_t name[MAX_PATH];
+  DWORD size = arraysize(name);
+  return ::GetDefaultPrinter(name, &size) && device_name == name;
+}
+#endif
+
+}  // namespace
+
 PrintQueriesQueue::PrintQueriesQueue() {
+#if defined(OS_WIN)
+  print_server_ = NULL;
+  printer_change_ = INVALID_HANDLE_VALUE;
+#endif
 }
 
 PrintQueriesQueue::~PrintQueriesQueue() {
   base::AutoLock lock(lock_);
   queued_queries_.clear();
+#if defined(OS_WIN)
+  if (printer_change_ != INVALID_HANDLE_VALUE)
+    ::FindClosePrinterChangeNotification(printer_change_);
+  if (print_server_)
+    ::ClosePrinter(print_server_);
+#endif
 }
 
 void PrintQueriesQueue::QueuePrinterQuery(PrinterQuery* job) {
@@ -52,11 +95,59 @@ scoped_refptr<PrinterQuery> PrintQueriesQueue::CreatePrinterQuery(
   return job;
 }
 
+scoped_refptr<PrinterQuery> PrintQueriesQueue::PopDefaultPrinterQuery() {
+  scoped_refptr<PrinterQuery> query;
+  {
+    base::AutoLock lock(lock_);
+    query.swap(default_query_);
+    if (!query.get())
+      return NULL;
+
+    bool changed = base::TimeTicks::Now() - default_query_time_ >
+        base::TimeDelta::FromMinutes(kDefaultSettingsLifetimeInMinutes);
+#if defined(OS_WIN)
+    // Polling the notification does not block, unlike querying the printer.
+    if (printer_change_ != INVALID_HANDLE_VALUE &&
+        ::WaitForSingleObject(printer_change_, 0) == WAIT_OBJECT_0) {
+      DWORD change = 0;
+      ::FindNextPrinterChangeNotification(printer_change_, &change, NULL,
+                                          NULL);
+      changed = true;
+    }
+    changed = changed || !IsDefaultPrinter(query->settings().device_name());
+#endif
+    if (!changed)
+      return query;
+  }
+  StopPrinterQuery(query);
+  return NULL;
+}
+
+void PrintQueriesQueue::SetDefaultPrinterQuery(PrinterQuery* job) {
+  DCHECK(job);
+  scoped_refptr<PrinterQuery> old_query;
+  {
+    base::AutoLock lock(lock_);
+#if defined(OS_WIN)
+    if (!print_server_ && ::OpenPrinter(NULL, &print_server_, NULL))
+      printer_change_ = ::FindFirstPrinterChangeNotification(
+          print_server_, PRINTER_CHANGE_PRINTER, 0, NULL);
+#endif
+    old_query.swap(default_query_);
+    default_query_ = job;
+    default_query_time_ = base::TimeTicks::Now();
+  }
+  StopPrinterQuery(old_query);
+}
+
 void PrintQueriesQueue::Shutdown() {
   PrinterQueries queries_to_stop;
   {
     base::AutoLock lock(lock_);
     queued_queries_.swap(queries_to_stop);
+    if (default_query_.get())
+      queries_to_stop.push_back(default_query_);
+    default_query_ = NULL;
   }
   // Stop all pending queries, requests to generate print preview do not have
   // corresponding PrintJob, so any pending preview requests are not covered
@@ -67,7 +158,22 @@ void PrintQueriesQueue::Shutdown() {
   }
 }
 
-PrintJobManager::PrintJobManager() : is_shutdown_(false) {
+PrintJobManager::QueuedJob::QueuedJob()
+    : id(0),
+      render_process_id(0),
+      render_view_id(0),
+      silent(false),
+      print_background(false) {
+}
+
+PrintJobManager::QueuedJob::~QueuedJob() {
+}
+
+PrintJobManager::PrintJobManager()
+    : is_shutdown_(false),
+      max_concurrent_jobs_(1),
+      next_job_id_(0),
+      weak_factory_(this) {
   registrar_.Add(this, chrome::NOTIFICATION_PRINT_JOB_EVENT,
                  content::NotificationService::AllSources());
 }
@@ -87,12 +193,133 @@ void PrintJobManager::Shutdown() {
   DCHECK(!is_shutdown_);
   is_shutdown_ = true;
   registrar_.RemoveAll();
+
+  // The queued jobs would never be started.
+  std::deque<QueuedJob> queued_jobs;
+  queued_jobs.swap(queued_jobs_);
+  for (const QueuedJob& job : queued_jobs)
+    job.done.Run(false);
+
   StopJobs(true);
   if (queue_.get())
     queue_->Shutdown();
   queue_ = NULL;
 }
 
+int PrintJobManager::QueuePrintJob(content::WebContents* web_contents,
+                                   bool silent,
+                                   bool print_background,
+                                   const PrintProgressCallback& progress,
+                                   const PrintDoneCallback& done) {
+  DCHECK(content::BrowserThread::CurrentlyOn(content::BrowserThread::UI));
+  // The page is looked up again when the job starts, since it may be gone
+  // while the job is waiting.
+  content::RenderViewHost* rvh = web_contents->GetRenderViewHost();
+  QueuedJob job;
+  job.id = ++next_job_id_;
+  job.render_process_id = rvh ? rvh->GetProcess()->GetID() : 0;
+  job.render_view_id = rvh ? rvh->GetRoutingID() : 0;
+  job.silent = silent;
+  job.print_background = print_background;
+  job.progress = progress;
+  job.done = done;
+  queued_jobs_.push_back(job);
+
+  // Callers get the ID before any callback of the job is called.
+  base::MessageLoop::current()->PostTask(
+      FROM_HERE,
+      base::Bind(&PrintJobManager::StartQueuedJobs,
+                 weak_factory_.GetWeakPtr()));
+  return job.id;
+}
+
+bool PrintJobManager::CancelPrintJob(int job_id) {
+  DCHECK(content::BrowserThread::CurrentlyOn(content::BrowserThread::UI));
+  for (std::deque<QueuedJob>::iterator it = queued_jobs_.begin();
+       it != queued_jobs_.end(); ++it) {
+    if (it->id == job_id) {
+      PrintDoneCallback done = it->done;
+      queued_jobs_.erase(it);
+      done.Run(false);
+      return true;
+    }
+  }
+
+  std::map<int, QueuedJob>::iterator it = running_jobs_.find(job_id);
+  if (it == running_jobs_.end())
+    return false;
+
+  // The manager reports the job as done, which frees the slot.
+  content::RenderViewHost* rvh = content::RenderViewHost::FromID(
+      it->second.render_process_id, it->second.render_view_id);
+  content::WebContents* web_contents =
+      rvh ? content::WebContents::FromRenderViewHost(rvh) : NULL;
+  PrintViewManagerBasic* manager =
+      web_contents ? PrintViewManagerBasic::FromWebContents(web_contents)
+                   : NULL;
+  if (manager)
+    manager->CancelPrinting();
+  else
+    OnQueuedJobDone(job_id, false);
+  return true;
+}
+
+void PrintJobManager::set_max_concurrent_jobs(int count) {
+  max_concurrent_jobs_ = std::max(count, 1);
+  StartQueuedJobs();
+}
+
+void PrintJobManager::StartQueuedJobs() {
+  std::deque<QueuedJob>::iterator it = queued_jobs_.begin();
+  while (!is_shutdown_ &&
+         static_cast<int>(running_jobs_.size()) < max_concurrent_jobs_ &&
+         it != queued_jobs_.end()) {
+    // A page can only print one job at a time, later jobs of it keep waiting.
+    bool page_busy = false;
+    for (const auto& running : running_jobs_) {
+      if (running.second.render_process_id == it->render_process_id &&
+          running.second.render_view_id == it->render_view_id)
+        page_busy = true;
+    }
+    if (page_busy) {
+      ++it;
+      continue;
+    }
+
+    QueuedJob job = *it;
+    it = queued_jobs_.erase(it);
+
+    content::RenderViewHost* rvh = content::RenderViewHost::FromID(
+        job.render_process_id, job.render_view_id);
+    content::WebContents* web_contents =
+        rvh ? content::WebContents::FromRenderViewHost(rvh) : NULL;
+    PrintViewManagerBasic* manager =
+        web_contents ? PrintViewManagerBasic::FromWebContents(web_contents)
+                     : NULL;
+    running_jobs_[job.id] = job;
+    if (!manager ||
+        !manager->PrintNow(job.silent, job.print_background, job.progress,
+                           base::Bind(&PrintJobManager::OnQueuedJobDone,
+                                      weak_factory_.GetWeakPtr(), job.id))) {
+      running_jobs_.erase(job.id);
+      job.done.Run(false);
+    }
+
+    // The callbacks may have changed the queue.
+    it = queued_jobs_.begin();
+  }
+}
+
+void PrintJobManager::OnQueuedJobDone(int job_id, bool success) {
+  std::map<int, QueuedJob>::iterator it = running_jobs_.find(job_id);
+  if (it == running_jobs_.end())
+    return;
+  PrintDoneCallback done = it->second.done;
+  running_jobs_.erase(it);
+  done.Run(success);
+  StartQueuedJobs();
+}
+
 void PrintJobManager::StopJobs(bool wait_for_finish) {
   DCHECK(content::BrowserThread::CurrentlyOn(content::BrowserThread::UI));
   // Copy the array since it can be modified in transit.
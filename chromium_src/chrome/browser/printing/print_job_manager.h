@@ -5,17 +5,30 @@
 #ifndef CHROME_BROWSER_PRINTING_PRINT_JOB_MANAGER_H_
 #define CHROME_BROWSER_PRINTING_PRINT_JOB_MANAGER_H_
 
+#if defined(OS_WIN)
+#include <windows.h>
+#endif
+
+#include <deque>
+#include <map>
 #include <set>
 #include <vector>
 
 #include "base/logging.h"
 #include "base/memory/ref_counted.h"
 #include "base/memory/scoped_ptr.h"
+#include "base/memory/weak_ptr.h"
 #include "base/synchronization/lock.h"
 #include "base/threading/non_thread_safe.h"
+#include "base/time/time.h"
+#include "chrome/browser/printing/print_view_manager_base.h"
 #include "content/public/browser/notification_observer.h"
 #include "content/public/browser/notification_registrar.h"
 
+namespace content {
+class WebContents;
+}
+
 namespace printing {
 
 class JobEventDetails;
@@ -39,6 +52,16 @@ class PrintQueriesQueue : public base::RefCountedThreadSafe<PrintQueriesQueue> {
   scoped_refptr<PrinterQuery> CreatePrinterQuery(int render_process_id,
                                                  int render_view_id);
 
+  // Pops the query that was initialized with the default settings in advance,
+  // returns NULL if there is none or the printers have changed since then.
+  // Querying the default printer can take seconds with network printers, so
+  // this keeps repeated printing fast. Can be called from any thread.
+  scoped_refptr<PrinterQuery> PopDefaultPrinterQuery();
+
+  // Keeps |job|, which has been initialized with the default settings, for the
+  // next PopDefaultPrinterQuery(). Can be called from any thread.
+  void SetDefaultPrinterQuery(PrinterQuery* job);
+
   void Shutdown();
 
  private:
@@ -52,6 +75,17 @@ class PrintQueriesQueue : public base::RefCountedThreadSafe<PrintQueriesQueue> {
 
   PrinterQueries queued_queries_;
 
+  // The query with default settings and when it was initialized, also guarded
+  // by |lock_|.
+  scoped_refptr<PrinterQuery> default_query_;
+  base::TimeTicks default_query_time_;
+
+#if defined(OS_WIN)
+  // Signaled when a printer is added, removed or changed.
+  HANDLE print_server_;
+  HANDLE printer_change_;
+#endif
+
   DISALLOW_COPY_AND_ASSIGN(PrintQueriesQueue);
 };
 
@@ -72,9 +106,43 @@ class PrintJobManager : public content::NotificationObserver {
   // Thread. Reference could be stored and used from any thread.
   scoped_refptr<PrintQueriesQueue> queue();
 
+  // Queues printing the page of |web_contents|, and returns the ID of the job.
+  // At most |max_concurrent_jobs| jobs are printed at the same time, so many
+  // jobs do not fight over the spooler. |done| is always called, with false
+  // when the job failed or was canceled. Must be called on UI thread.
+  int QueuePrintJob(content::WebContents* web_contents,
+                    bool silent,
+                    bool print_background,
+                    const PrintProgressCallback& progress,
+                    const PrintDoneCallback& done);
+
+  // Cancels the queued or running job |job_id|, returns false if there is no
+  // such job. Must be called on UI thread.
+  bool CancelPrintJob(int job_id);
+
+  void set_max_concurrent_jobs(int count);
+  int max_concurrent_jobs() const { return max_concurrent_jobs_; }
+
  private:
   typedef std::set<scoped_refptr<PrintJob> > PrintJobs;
 
+  struct QueuedJob {
+    QueuedJob();
+    ~QueuedJob();
+
+    int id;
+    int render_process_id;
+    int render_view_id;
+    bool silent;
+    bool print_background;
+    PrintProgressCallback progress;
+    PrintDoneCallback done;
+  };
+
+  // Starts the queued jobs while there are free slots.
+  void StartQueuedJobs();
+  void OnQueuedJobDone(int job_id, bool success);
+
   // Processes a NOTIFY_PRINT_JOB_EVENT notification.
   void OnPrintJobEvent(PrintJob* print_job,
                        const JobEventDetails& event_details);
@@ -92,6 +160,14 @@ class PrintJobManager : public content::NotificationObserver {
 
   bool is_shutdown_;
 
+  // The jobs waiting for a free slot, and the ones being printed.
+  std::deque<QueuedJob> queued_jobs_;
+  std::map<int, QueuedJob> running_jobs_;
+  int max_concurrent_jobs_;
+  int next_job_id_;
+
+  base::WeakPtrFactory<PrintJobManager> weak_factory_;
+
   DISALLOW_COPY_AND_ASSIGN(PrintJobManager);
 };
 
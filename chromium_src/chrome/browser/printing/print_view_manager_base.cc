@@ -47,6 +47,7 @@ PrintViewManagerBase::PrintViewManagerBase(content::WebContents* web_contents)
       printing_succeeded_(false),
       inside_inner_message_loop_(false),
       cookie_(0),
+      printed_pages_(0),
       queue_(g_browser_process->print_job_manager()->queue()) {
   DCHECK(queue_.get());
 #if !defined(OS_MACOSX)
@@ -58,6 +59,7 @@ PrintViewManagerBase::PrintViewManagerBase(content::WebContents* web_contents)
 PrintViewManagerBase::~PrintViewManagerBase() {
   ReleasePrinterQuery();
   DisconnectFromCurrentPrintJob();
+  ReportPrintingDone(false);
 }
 
 #if !defined(DISABLE_BASIC_PRINTING)
@@ -65,8 +67,28 @@ bool PrintViewManagerBase::PrintNow(bool silent, bool print_background) {
   return PrintNowInternal(new PrintMsg_PrintPages(
       routing_id(), silent, print_background));
 }
+
+bool PrintViewManagerBase::PrintNow(bool silent,
+                                    bool print_background,
+                                    const PrintProgressCallback& progress,
+                                    const PrintDoneCallback& done) {
+  // Only one job can be tracked at a time, the old one is considered gone.
+  ReportPrintingDone(false);
+  if (!PrintNow(silent, print_background))
+    return false;
+  progress_callback_ = progress;
+  done_callback_ = done;
+  printed_pages_ = 0;
+  return true;
+}
 #endif  // !DISABLE_BASIC_PRINTING
 
+void PrintViewManagerBase::CancelPrinting() {
+  TerminatePrintJob(true);
+  ReleasePrinterQuery();
+  ReportPrintingDone(false);
+}
+
 void PrintViewManagerBase::NavigationStopped() {
   // Cancel the current job, wait for the worker to finish.
   TerminatePrintJob(true);
@@ -75,8 +97,10 @@ void PrintViewManagerBase::NavigationStopped() {
 void PrintViewManagerBase::RenderProcessGone(base::TerminationStatus status) {
   ReleasePrinterQuery();
 
-  if (!print_job_.get())
+  if (!print_job_.get()) {
+    ReportPrintingDone(false);
     return;
+  }
 
   scoped_refptr<PrintedDocument> document(print_job_->document());
   if (document.get()) {
@@ -84,6 +108,8 @@ void PrintViewManagerBase::RenderProcessGone(base::TerminationStatus status) {
     // Since our renderer is gone, there's nothing to do, cancel it. Otherwise,
     // the print job may finish without problem.
     TerminatePrintJob(!document->IsComplete());
+  } else {
+    ReportPrintingDone(false);
   }
 }
 
@@ -156,6 +182,9 @@ void PrintViewManagerBase::OnDidPrintPage(
         params.data_size);
 
     document->DebugDumpData(bytes.get(), FILE_PATH_LITERAL(".pdf"));
+    // The whole document comes with the first page.
+    print_job_->StartPdfToEmfConversion(bytes, params.page_size,
+                                        params.content_area);
   }
 #endif  // !OS_WIN
 }
@@ -167,6 +196,7 @@ void PrintViewManagerBase::OnPrintingFailed(int cookie) {
   }
 
   ReleasePrinterQuery();
+  ReportPrintingDone(false);
 
   content::NotificationService::current()->Notify(
       chrome::NOTIFICATION_PRINT_JOB_RELEASED,
@@ -178,6 +208,21 @@ void PrintViewManagerBase::OnShowInvalidPrinterSettingsError() {
   LOG(ERROR) << "Invalid printer settings";
 }
 
+void PrintViewManagerBase::OnPrintingAborted() {
+  // A job that has been created is reported when it is released.
+  if (!print_job_.get())
+    ReportPrintingDone(false);
+}
+
+void PrintViewManagerBase::ReportPrintingDone(bool success) {
+  if (done_callback_.is_null())
+    return;
+  PrintDoneCallback done = done_callback_;
+  done_callback_.Reset();
+  progress_callback_.Reset();
+  done.Run(success);
+}
+
 bool PrintViewManagerBase::OnMessageReceived(const IPC::Message& message) {
   bool handled = true;
   IPC_BEGIN_MESSAGE_MAP(PrintViewManagerBase, message)
@@ -187,6 +232,7 @@ bool PrintViewManagerBase::OnMessageReceived(const IPC::Message& message) {
                         OnDidGetDocumentCookie)
     IPC_MESSAGE_HANDLER(PrintHostMsg_DidPrintPage, OnDidPrintPage)
     IPC_MESSAGE_HANDLER(PrintHostMsg_PrintingFailed, OnPrintingFailed)
+    IPC_MESSAGE_HANDLER(PrintHostMsg_PrintingAborted, OnPrintingAborted)
     IPC_MESSAGE_HANDLER(PrintHostMsg_ShowInvalidPrinterSettingsError,
                         OnShowInvalidPrinterSettingsError);
     IPC_MESSAGE_UNHANDLED(handled = false)
@@ -232,9 +278,13 @@ void PrintViewManagerBase::OnNotifyPrintJobEvent(
       ShouldQuitFromInnerMessageLoop();
       break;
     }
+    case JobEventDetails::PAGE_DONE: {
+      if (!progress_callback_.is_null())
+        progress_callback_.Run(++printed_pages_, number_pages_);
+      break;
+    }
     case JobEventDetails::NEW_DOC:
     case JobEventDetails::NEW_PAGE:
-    case JobEventDetails::PAGE_DONE:
     case JobEventDetails::DOC_DONE: {
       // Don't care about the actual printing process.
       break;
@@ -393,6 +443,7 @@ void PrintViewManagerBase::ReleasePrintJob() {
   print_job_->DisconnectSource();
   // Don't close the worker thread.
   print_job_ = NULL;
+  ReportPrintingDone(printing_succeeded_);
 }
 
 bool PrintViewManagerBase::RunInnerMessageLoop() {
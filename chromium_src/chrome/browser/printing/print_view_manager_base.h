@@ -5,6 +5,7 @@
 #ifndef CHROME_BROWSER_PRINTING_PRINT_VIEW_MANAGER_BASE_H_
 #define CHROME_BROWSER_PRINTING_PRINT_VIEW_MANAGER_BASE_H_
 
+#include "base/callback.h"
 #include "base/memory/ref_counted.h"
 #include "base/prefs/pref_member.h"
 #include "base/strings/string16.h"
@@ -28,6 +29,12 @@ class PrintJob;
 class PrintJobWorkerOwner;
 class PrintQueriesQueue;
 
+// Reports the pages spooled so far and the page count of a print job.
+typedef base::Callback<void(int printed_pages, int total_pages)>
+    PrintProgressCallback;
+// Reports whether a print job has been completed.
+typedef base::Callback<void(bool success)> PrintDoneCallback;
+
 // Base class for managing the print commands for a WebContents.
 class PrintViewManagerBase : public content::NotificationObserver,
                              public PrintedPagesSource,
@@ -40,8 +47,18 @@ class PrintViewManagerBase : public content::NotificationObserver,
   // asynchronous, the actual printing will not be completed on the return of
   // this function. Returns false if printing is impossible at the moment.
   virtual bool PrintNow(bool silent, bool print_background);
+
+  // Same with above, and reports the progress of the print job and when it is
+  // done. |done| is always called unless this returns false.
+  bool PrintNow(bool silent,
+                bool print_background,
+                const PrintProgressCallback& progress,
+                const PrintDoneCallback& done);
 #endif  // !DISABLE_BASIC_PRINTING
 
+  // Cancels the current print job.
+  void CancelPrinting();
+
   // PrintedPagesSource implementation.
   virtual base::string16 RenderSourceName() override;
 
@@ -74,6 +91,10 @@ class PrintViewManagerBase : public content::NotificationObserver,
   void OnDidGetDocumentCookie(int cookie);
   void OnDidPrintPage(const PrintHostMsg_DidPrintPage_Params& params);
   void OnShowInvalidPrinterSettingsError();
+  void OnPrintingAborted();
+
+  // Runs and resets the callbacks passed to PrintNow().
+  void ReportPrintingDone(bool success);
 
   // Processes a NOTIFY_PRINT_JOB_EVENT notification.
   void OnNotifyPrintJobEvent(const JobEventDetails& event_details);
@@ -153,6 +174,11 @@ class PrintViewManagerBase : public content::NotificationObserver,
   // Whether printing is enabled.
   bool printing_enabled_;
 
+  // The callbacks of the job started by PrintNow(), and its spooled pages.
+  PrintProgressCallback progress_callback_;
+  PrintDoneCallback done_callback_;
+  int printed_pages_;
+
   scoped_refptr<printing::PrintQueriesQueue> queue_;
 
   DISALLOW_COPY_AND_ASSIGN(PrintViewManagerBase);
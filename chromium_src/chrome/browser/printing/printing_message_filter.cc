@@ -261,6 +261,12 @@ void PrintingMessageFilter::OnGetDefaultPrintSettings(IPC::Message* reply_msg) {
     return;
   }
 #endif
+  printer_query = queue_->PopDefaultPrinterQuery();
+  if (printer_query.get()) {
+    OnGetDefaultPrintSettingsReply(printer_query, reply_msg);
+    return;
+  }
+
   printer_query = queue_->PopPrinterQuery(0);
   if (!printer_query.get()) {
     printer_query =
@@ -283,6 +289,7 @@ void PrintingMessageFilter::OnGetDefaultPrintSettings(IPC::Message* reply_msg) {
 void PrintingMessageFilter::OnGetDefaultPrintSettingsReply(
     scoped_refptr<PrinterQuery> printer_query,
     IPC::Message* reply_msg) {
+  int render_view_id = reply_msg->routing_id();
   PrintMsg_Print_Params params;
   if (!printer_query.get() ||
       printer_query->last_status() != PrintingContext::OK) {
@@ -298,12 +305,37 @@ void PrintingMessageFilter::OnGetDefaultPrintSettingsReply(
     // If user hasn't cancelled.
     if (printer_query->cookie() && printer_query->settings().dpi()) {
       queue_->QueuePrinterQuery(printer_query.get());
+      PrefetchDefaultPrintSettings(render_view_id);
     } else {
       printer_query->StopWorker();
     }
   }
 }
 
+void PrintingMessageFilter::PrefetchDefaultPrintSettings(int render_view_id) {
+  DCHECK_CURRENTLY_ON(BrowserThread::IO);
+  scoped_refptr<PrinterQuery> printer_query =
+      queue_->CreatePrinterQuery(render_process_id_, render_view_id);
+  printer_query->GetSettings(
+      PrinterQuery::DEFAULTS,
+      0,
+      false,
+      DEFAULT_MARGINS,
+      base::Bind(&PrintingMessageFilter::OnDefaultPrintSettingsPrefetched,
+                 this,
+                 printer_query));
+}
+
+void PrintingMessageFilter::OnDefaultPrintSettingsPrefetched(
+    scoped_refptr<PrinterQuery> printer_query) {
+  if (printer_query->last_status() == PrintingContext::OK &&
+      printer_query->cookie() && printer_query->settings().dpi()) {
+    queue_->SetDefaultPrinterQuery(printer_query.get());
+  } else {
+    printer_query->StopWorker();
+  }
+}
+
 void PrintingMessageFilter::OnScriptedPrint(
     const PrintHostMsg_ScriptedPrint_Params& params,
     IPC::Message* reply_msg) {
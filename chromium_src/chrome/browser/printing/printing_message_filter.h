@@ -88,6 +88,12 @@ class PrintingMessageFilter : public content::BrowserMessageFilter {
   void OnGetDefaultPrintSettingsReply(scoped_refptr<PrinterQuery> printer_query,
                                       IPC::Message* reply_msg);
 
+  // Initializes a query with the default settings in advance, so the next
+  // OnGetDefaultPrintSettings() does not have to wait for the printer.
+  void PrefetchDefaultPrintSettings(int render_view_id);
+  void OnDefaultPrintSettingsPrefetched(
+      scoped_refptr<PrinterQuery> printer_query);
+
   // The renderer host have to show to the user the print dialog and returns
   // the selected print settings. The task is handled by the print worker
   // thread and the UI thread. The reply occurs on the IO thread.
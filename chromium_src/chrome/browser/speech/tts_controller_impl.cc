@@ -7,7 +7,9 @@
 #include <string>
 #include <vector>
 
+#include "base/bind.h"
 #include "base/float_util.h"
+#include "base/message_loop/message_loop.h"
 #include "base/values.h"
 #include "chrome/browser/browser_process.h"
 #include "chrome/browser/speech/tts_platform.h"
@@ -16,6 +18,10 @@ namespace {
 // A value to be used to indicate that there is no char index available.
 const int kInvalidCharIndex = -1;
 
+// How often and how long to wait for the platform TTS when prewarming it.
+const int kPrewarmRetryDelayMs = 100;
+const int kMaxPrewarmRetries = 100;
+
 // Given a language/region code of the form 'fr-FR', returns just the basic
 // language portion, e.g. 'fr'.
 std::string TrimLanguageCode(std::string lang) {
@@ -117,9 +123,11 @@ TtsControllerImpl* TtsControllerImpl::GetInstance() {
 
 TtsControllerImpl::TtsControllerImpl()
     : current_utterance_(NULL),
+      pipelined_utterance_(NULL),
       paused_(false),
       platform_impl_(NULL),
-      tts_engine_delegate_(NULL) {
+      tts_engine_delegate_(NULL),
+      native_voices_cached_(false) {
 }
 
 TtsControllerImpl::~TtsControllerImpl() {
@@ -127,6 +135,10 @@ TtsControllerImpl::~TtsControllerImpl() {
     current_utterance_->Finish();
     delete current_utterance_;
   }
+  if (pipelined_utterance_) {
+    pipelined_utterance_->Finish();
+    delete pipelined_utterance_;
+  }
 
   // Clear any queued utterances too.
   ClearUtteranceQueue(false);  // Don't sent events.
@@ -144,6 +156,7 @@ void TtsControllerImpl::SpeakOrEnqueue(Utterance* utterance) {
 
   if (paused_ || (IsSpeaking() && utterance->can_enqueue())) {
     utterance_queue_.push(utterance);
+    PipelineNextUtterance();
   } else {
     Stop();
     SpeakNow(utterance);
@@ -156,43 +169,8 @@ void TtsControllerImpl::SpeakNow(Utterance* utterance) {
   bool loaded_built_in =
       GetPlatformImpl()->LoadBuiltInTtsExtension(utterance->browser_context());
 
-  // Get all available voices and try to find a matching voice.
-  std::vector<VoiceData> voices;
-  GetVoices(utterance->browser_context(), &voices);
-  int index = GetMatchingVoice(utterance, voices);
-
   VoiceData voice;
-  if (index != -1) {
-    // Select the matching voice.
-    voice = voices[index];
-  } else {
-    // However, if no match was found on a platform without native tts voices,
-    // attempt to get a voice based only on the current locale without respect
-    // to any supplied voice names.
-    std::vector<VoiceData> native_voices;
-
-    if (GetPlatformImpl()->PlatformImplAvailable())
-      GetPlatformImpl()->GetVoices(&native_voices);
-
-    if (native_voices.empty() && !voices.empty()) {
-      // TODO(dtseng): Notify extension caller of an error.
-      utterance->set_voice_name("");
-      // TODO(gaochun): Replace the global variable g_browser_process with
-      // GetContentClient()->browser() to eliminate the dependency of browser
-      // once TTS implementation was moved to content.
-      utterance->set_lang(g_browser_process->GetApplicationLocale());
-      index = GetMatchingVoice(utterance, voices);
-
-      // If even that fails, just take the first available voice.
-      if (index == -1)
-        index = 0;
-      voice = voices[index];
-    } else {
-      // Otherwise, simply give native voices a chance to handle this utterance.
-      voice.native = true;
-    }
-  }
-
+  SelectVoice(utterance, &voice);
   GetPlatformImpl()->WillSpeakUtteranceWithVoice(utterance, voice);
 
   if (!voice.native) {
@@ -238,6 +216,73 @@ void TtsControllerImpl::SpeakNow(Utterance* utterance) {
       delete utterance;
       return;
     }
+
+    PipelineNextUtterance();
+  }
+}
+
+void TtsControllerImpl::PipelineNextUtterance() {
+  if (paused_ || pipelined_utterance_ || utterance_queue_.empty() ||
+      !current_utterance_ || !current_utterance_->extension_id().empty() ||
+      !GetPlatformImpl()->SupportsEnqueue())
+    return;
+
+  Utterance* utterance = utterance_queue_.front();
+  VoiceData voice;
+  SelectVoice(utterance, &voice);
+  if (!voice.native)
+    return;
+
+  // Keep the utterance in the queue if the platform can not take it now, it
+  // will be spoken after the current one as usual.
+  GetPlatformImpl()->WillSpeakUtteranceWithVoice(utterance, voice);
+  GetPlatformImpl()->clear_error();
+  bool success = GetPlatformImpl()->Enqueue(
+      utterance->id(),
+      utterance->text(),
+      utterance->lang(),
+      voice,
+      utterance->continuous_parameters());
+  if (success) {
+    utterance_queue_.pop();
+    pipelined_utterance_ = utterance;
+  }
+}
+
+void TtsControllerImpl::SelectVoice(Utterance* utterance, VoiceData* out) {
+  // Get all available voices and try to find a matching voice.
+  std::vector<VoiceData> voices;
+  GetVoices(utterance->browser_context(), &voices);
+  int index = GetMatchingVoice(utterance, voices);
+
+  VoiceData& voice = *out;
+  if (index != -1) {
+    // Select the matching voice.
+    voice = voices[index];
+  } else {
+    // However, if no match was found on a platform without native tts voices,
+    // attempt to get a voice based only on the current locale without respect
+    // to any supplied voice names.
+    std::vector<VoiceData> native_voices;
+    GetNativeVoices(&native_voices);
+
+    if (native_voices.empty() && !voices.empty()) {
+      // TODO(dtseng): Notify extension caller of an error.
+      utterance->set_voice_name("");
+      // TODO(gaochun): Replace the global variable g_browser_process with
+      // GetContentClient()->browser() to eliminate the dependency of browser
+      // once TTS implementation was moved to content.
+      utterance->set_lang(g_browser_process->GetApplicationLocale());
+      index = GetMatchingVoice(utterance, voices);
+
+      // If even that fails, just take the first available voice.
+      if (index == -1)
+        index = 0;
+      voice = voices[index];
+    } else {
+      // Otherwise, simply give native voices a chance to handle this utterance.
+      voice.native = true;
+    }
   }
 }
 
@@ -257,6 +302,12 @@ void TtsControllerImpl::Stop() {
     current_utterance_->OnTtsEvent(TTS_EVENT_INTERRUPTED, kInvalidCharIndex,
                                    std::string());
   FinishCurrentUtterance();
+  if (pipelined_utterance_) {
+    pipelined_utterance_->OnTtsEvent(TTS_EVENT_CANCELLED, kInvalidCharIndex,
+                                     std::string());
+    delete pipelined_utterance_;
+    pipelined_utterance_ = NULL;
+  }
   ClearUtteranceQueue(true);  // Send events.
 }
 
@@ -296,6 +347,12 @@ void TtsControllerImpl::OnTtsEvent(int utterance_id,
   // already finished the utterance (for example because another utterance
   // interrupted or we got a call to Stop). This is normal and we can
   // safely just ignore these events.
+  if (pipelined_utterance_ && utterance_id == pipelined_utterance_->id()) {
+    // The platform has moved on to the pipelined utterance, which means the
+    // current one has ended even if we missed its end event.
+    FinishCurrentUtterance();
+    SpeakNextUtterance();
+  }
   if (!current_utterance_ || utterance_id != current_utterance_->id()) {
     return;
   }
@@ -318,11 +375,45 @@ void TtsControllerImpl::GetVoices(content::BrowserContext* browser_context,
     // Ensure we have all built-in voices loaded. This is a no-op if already
     // loaded.
     platform_impl->LoadBuiltInTtsExtension(browser_context);
-    if (platform_impl->PlatformImplAvailable())
-      platform_impl->GetVoices(out_voices);
+    GetNativeVoices(out_voices);
   }
 }
 
+bool TtsControllerImpl::GetNativeVoices(std::vector<VoiceData>* out_voices) {
+  TtsPlatformImpl* platform_impl = GetPlatformImpl();
+  if (!platform_impl || !platform_impl->PlatformImplAvailable())
+    return false;
+
+  if (!native_voices_cached_) {
+    native_voices_.clear();
+    platform_impl->GetVoices(&native_voices_);
+    native_voices_cached_ = true;
+  }
+  out_voices->insert(out_voices->end(),
+                     native_voices_.begin(),
+                     native_voices_.end());
+  return true;
+}
+
+void TtsControllerImpl::Prewarm() {
+  // Creating the platform TTS starts its initialization, which is done on the
+  // FILE thread on Linux.
+  if (GetPlatformImpl())
+    PrewarmNativeVoices(kMaxPrewarmRetries);
+}
+
+void TtsControllerImpl::PrewarmNativeVoices(int retries) {
+  std::vector<VoiceData> voices;
+  if (GetNativeVoices(&voices) || retries <= 0)
+    return;
+
+  base::MessageLoop::current()->PostDelayedTask(
+      FROM_HERE,
+      base::Bind(&TtsControllerImpl::PrewarmNativeVoices,
+                 base::Unretained(this), retries - 1),
+      base::TimeDelta::FromMilliseconds(kPrewarmRetryDelayMs));
+}
+
 bool TtsControllerImpl::IsSpeaking() {
   return current_utterance_ != NULL || GetPlatformImpl()->IsSpeaking();
 }
@@ -338,6 +429,14 @@ void TtsControllerImpl::FinishCurrentUtterance() {
 }
 
 void TtsControllerImpl::SpeakNextUtterance() {
+  // The pipelined utterance is already being spoken by the platform.
+  if (pipelined_utterance_ && !current_utterance_) {
+    current_utterance_ = pipelined_utterance_;
+    pipelined_utterance_ = NULL;
+    PipelineNextUtterance();
+    return;
+  }
+
   if (paused_)
     return;
 
@@ -366,6 +465,8 @@ void TtsControllerImpl::ClearUtteranceQueue(bool send_events) {
 void TtsControllerImpl::SetPlatformImpl(
     TtsPlatformImpl* platform_impl) {
   platform_impl_ = platform_impl;
+  native_voices_cached_ = false;
+  native_voices_.clear();
 }
 
 int TtsControllerImpl::QueueSize() {
@@ -437,6 +538,8 @@ int TtsControllerImpl::GetMatchingVoice(
 }
 
 void TtsControllerImpl::VoicesChanged() {
+  native_voices_cached_ = false;
+  native_voices_.clear();
   for (std::set<VoicesChangedDelegate*>::iterator iter =
            voices_changed_delegates_.begin();
        iter != voices_changed_delegates_.end(); ++iter) {
@@ -50,6 +50,10 @@ class TtsControllerImpl : public TtsController {
   virtual void SetPlatformImpl(TtsPlatformImpl* platform_impl) override;
   virtual int QueueSize() override;
 
+  // Initializes the platform TTS and loads its voices in advance, so the first
+  // use of speech synthesis does not have to wait for them.
+  void Prewarm();
+
  protected:
   TtsControllerImpl();
   virtual ~TtsControllerImpl();
@@ -58,10 +62,25 @@ class TtsControllerImpl : public TtsController {
   // Get the platform TTS implementation (or injected mock).
   TtsPlatformImpl* GetPlatformImpl();
 
+  // Appends the voices of the platform TTS, which are only enumerated again
+  // after they have changed. Returns false if the platform TTS is not ready.
+  bool GetNativeVoices(std::vector<VoiceData>* out_voices);
+
+  // Loads the native voices once the platform TTS has been initialized, which
+  // may happen on another thread.
+  void PrewarmNativeVoices(int retries);
+
   // Start speaking the given utterance. Will either take ownership of
   // |utterance| or delete it if there's an error. Returns true on success.
   void SpeakNow(Utterance* utterance);
 
+  // Hands the next utterance in the queue to the platform TTS while the
+  // current one is still being spoken, if the platform can queue it.
+  void PipelineNextUtterance();
+
+  // Picks the voice to speak |utterance| with.
+  void SelectVoice(Utterance* utterance, VoiceData* out);
+
   // Clear the utterance queue. If send_events is true, will send
   // TTS_EVENT_CANCELLED events on each one.
   void ClearUtteranceQueue(bool send_events);
@@ -82,6 +101,9 @@ class TtsControllerImpl : public TtsController {
   // The current utterance being spoken.
   Utterance* current_utterance_;
 
+  // The utterance after the current one, already queued in the platform TTS.
+  Utterance* pipelined_utterance_;
+
   // Whether the queue is paused or not.
   bool paused_;
 
@@ -98,6 +120,10 @@ class TtsControllerImpl : public TtsController {
   // The delegate that processes TTS requests with user-installed extensions.
   TtsEngineDelegate* tts_engine_delegate_;
 
+  // The voices of the platform TTS, valid until VoicesChanged() is called.
+  std::vector<VoiceData> native_voices_;
+  bool native_voices_cached_;
+
   DISALLOW_COPY_AND_ASSIGN(TtsControllerImpl);
 };
 
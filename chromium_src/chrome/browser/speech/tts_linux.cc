@@ -60,6 +60,10 @@ class TtsPlatformImplLinux : public TtsPlatformImpl {
   // Resets the connection with speech dispatcher.
   void Reset();
 
+  // Enumerates the voices of all modules, which are kept since then. Should be
+  // called with |initialization_lock_| held or after initialization.
+  void LoadNativeVoices();
+
   static void NotificationCallback(size_t msg_id,
                                    size_t client_id,
                                    SPDNotificationType type);
@@ -131,6 +135,10 @@ void TtsPlatformImplLinux::Initialize() {
   libspeechd_loader_.spd_set_notification_on(conn_, SPD_CANCEL);
   libspeechd_loader_.spd_set_notification_on(conn_, SPD_PAUSE);
   libspeechd_loader_.spd_set_notification_on(conn_, SPD_RESUME);
+
+  // Talking to the speech dispatcher for every module is slow, so do it here
+  // instead of on UI thread when the voices are first requested.
+  LoadNativeVoices();
 }
 
 TtsPlatformImplLinux::~TtsPlatformImplLinux() {
@@ -223,8 +231,7 @@ bool TtsPlatformImplLinux::IsSpeaking() {
   return current_notification_ == SPD_EVENT_BEGIN;
 }
 
-void TtsPlatformImplLinux::GetVoices(
-    std::vector<VoiceData>* out_voices) {
+void TtsPlatformImplLinux::LoadNativeVoices() {
   if (!all_native_voices_.get()) {
     all_native_voices_.reset(new std::map<std::string, SPDChromeVoice>());
     char** modules = libspeechd_loader_.spd_list_modules(conn_);
@@ -255,7 +262,11 @@ void TtsPlatformImplLinux::GetVoices(
       free(modules[i]);
     }
   }
+}
 
+void TtsPlatformImplLinux::GetVoices(
+    std::vector<VoiceData>* out_voices) {
+  LoadNativeVoices();
   for (std::map<std::string, SPDChromeVoice>::iterator it =
            all_native_voices_->begin();
        it != all_native_voices_->end();
@@ -11,14 +11,23 @@
 
 using content::BrowserThread;
 
+namespace {
+
+// The minimum interval between two word boundary events sent to renderer.
+const int kWordBoundaryIntervalMs = 50;
+
+}  // namespace
+
 TtsMessageFilter::TtsMessageFilter(int render_process_id,
                                    content::BrowserContext* browser_context)
     : BrowserMessageFilter(TtsMsgStart),
       render_process_id_(render_process_id),
       browser_context_(browser_context),
+      observing_voices_(false),
+      pending_word_src_id_(-1),
+      pending_word_char_index_(0),
       weak_ptr_factory_(this) {
   CHECK(BrowserThread::CurrentlyOn(BrowserThread::UI));
-  TtsController::GetInstance()->AddVoicesChangedDelegate(this);
 
   // Balanced in OnChannelClosingInUIThread() to keep the ref-count be non-zero
   // until all WeakPtr's are invalidated.
@@ -64,6 +73,14 @@ void TtsMessageFilter::OnDestruct() const {
 void TtsMessageFilter::OnInitializeVoiceList() {
   CHECK(BrowserThread::CurrentlyOn(BrowserThread::UI));
   TtsController* tts_controller = TtsController::GetInstance();
+
+  // The TtsController is only created when the page starts to use speech
+  // synthesis, which always asks for the voice list first.
+  if (!observing_voices_) {
+    tts_controller->AddVoicesChangedDelegate(this);
+    observing_voices_ = true;
+  }
+
   std::vector<VoiceData> voices;
   tts_controller->GetVoices(browser_context_, &voices);
 
@@ -121,6 +138,13 @@ void TtsMessageFilter::OnTtsEvent(Utterance* utterance,
                                   int char_index,
                                   const std::string& error_message) {
   CHECK(BrowserThread::CurrentlyOn(BrowserThread::UI));
+  if (event_type == TTS_EVENT_WORD) {
+    SendWordBoundary(utterance->src_id(), char_index);
+    return;
+  }
+
+  // Keep the events in order.
+  FlushWordBoundary();
   switch (event_type) {
     case TTS_EVENT_START:
       Send(new TtsMsg_DidStartSpeaking(utterance->src_id()));
@@ -129,7 +153,7 @@ void TtsMessageFilter::OnTtsEvent(Utterance* utterance,
       Send(new TtsMsg_DidFinishSpeaking(utterance->src_id()));
       break;
     case TTS_EVENT_WORD:
-      Send(new TtsMsg_WordBoundary(utterance->src_id(), char_index));
+      NOTREACHED();
       break;
     case TTS_EVENT_SENTENCE:
       Send(new TtsMsg_SentenceBoundary(utterance->src_id(), char_index));
@@ -156,6 +180,32 @@ void TtsMessageFilter::OnTtsEvent(Utterance* utterance,
   }
 }
 
+void TtsMessageFilter::SendWordBoundary(int src_id, int char_index) {
+  if (word_boundary_timer_.IsRunning() &&
+      (pending_word_src_id_ == -1 || pending_word_src_id_ == src_id)) {
+    pending_word_src_id_ = src_id;
+    pending_word_char_index_ = char_index;
+    return;
+  }
+
+  FlushWordBoundary();
+  Send(new TtsMsg_WordBoundary(src_id, char_index));
+  word_boundary_timer_.Start(
+      FROM_HERE,
+      base::TimeDelta::FromMilliseconds(kWordBoundaryIntervalMs),
+      this, &TtsMessageFilter::FlushWordBoundary);
+}
+
+void TtsMessageFilter::FlushWordBoundary() {
+  word_boundary_timer_.Stop();
+  if (pending_word_src_id_ == -1)
+    return;
+
+  Send(new TtsMsg_WordBoundary(pending_word_src_id_,
+                               pending_word_char_index_));
+  pending_word_src_id_ = -1;
+}
+
 void TtsMessageFilter::OnVoicesChanged() {
   CHECK(BrowserThread::CurrentlyOn(BrowserThread::UI));
   OnInitializeVoiceList();
@@ -163,8 +213,10 @@ void TtsMessageFilter::OnVoicesChanged() {
 
 void TtsMessageFilter::OnChannelClosingInUIThread() {
   CHECK(BrowserThread::CurrentlyOn(BrowserThread::UI));
-  TtsController::GetInstance()->RemoveVoicesChangedDelegate(this);
+  StopObservingVoices();
 
+  word_boundary_timer_.Stop();
+  pending_word_src_id_ = -1;
   weak_ptr_factory_.InvalidateWeakPtrs();
   Release();  // Balanced in TtsMessageFilter().
 }
@@ -172,5 +224,12 @@ void TtsMessageFilter::OnChannelClosingInUIThread() {
 TtsMessageFilter::~TtsMessageFilter() {
   CHECK(BrowserThread::CurrentlyOn(BrowserThread::UI));
   DCHECK(!weak_ptr_factory_.HasWeakPtrs());
-  TtsController::GetInstance()->RemoveVoicesChangedDelegate(this);
+  StopObservingVoices();
+}
+
+void TtsMessageFilter::StopObservingVoices() {
+  if (observing_voices_) {
+    TtsController::GetInstance()->RemoveVoicesChangedDelegate(this);
+    observing_voices_ = false;
+  }
 }
\ No newline at end of file
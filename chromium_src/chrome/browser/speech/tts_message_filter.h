@@ -6,6 +6,7 @@
 #define CHROME_BROWSER_SPEECH_TTS_MESSAGE_FILTER_H_
 
 #include "base/memory/weak_ptr.h"
+#include "base/timer/timer.h"
 #include "chrome/browser/speech/tts_controller.h"
 #include "chrome/common/tts_messages.h"
 #include "content/public/browser/browser_message_filter.h"
@@ -52,10 +53,25 @@ class TtsMessageFilter
   void OnCancel();
 
   void OnChannelClosingInUIThread();
+  void StopObservingVoices();
+
+  // Word boundaries can come much faster than the page is able to handle,
+  // so at most one is sent in each interval, the latest one wins.
+  void SendWordBoundary(int src_id, int char_index);
+  void FlushWordBoundary();
 
   int render_process_id_;
   content::BrowserContext* browser_context_;
 
+  // Whether this is registered as VoicesChangedDelegate of TtsController.
+  bool observing_voices_;
+
+  // The word boundary waiting to be sent, |pending_word_src_id_| is -1 when
+  // there is none.
+  int pending_word_src_id_;
+  int pending_word_char_index_;
+  base::OneShotTimer<TtsMessageFilter> word_boundary_timer_;
+
   base::WeakPtrFactory<TtsMessageFilter> weak_ptr_factory_;
 
   DISALLOW_COPY_AND_ASSIGN(TtsMessageFilter);
@@ -11,6 +11,19 @@ bool TtsPlatformImpl::LoadBuiltInTtsExtension(
   return false;
 }
 
+bool TtsPlatformImpl::SupportsEnqueue() {
+  return false;
+}
+
+bool TtsPlatformImpl::Enqueue(
+    int utterance_id,
+    const std::string& utterance,
+    const std::string& lang,
+    const VoiceData& voice,
+    const UtteranceContinuousParameters& params) {
+  return false;
+}
+
 std::string TtsPlatformImpl::error() {
   return error_;
 }
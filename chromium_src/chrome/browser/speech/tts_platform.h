@@ -31,8 +31,8 @@ class TtsPlatformImpl {
   // If rate, pitch, or volume are -1.0, they will be ignored.
   //
   // The TtsController will only try to speak one utterance at
-  // a time. If it wants to interrupt speech, it will always call Stop
-  // before speaking again.
+  // a time, unless SupportsEnqueue returns true. If it wants to interrupt
+  // speech, it will always call Stop before speaking again.
   virtual bool Speak(
       int utterance_id,
       const std::string& utterance,
@@ -40,6 +40,19 @@ class TtsPlatformImpl {
       const VoiceData& voice,
       const UtteranceContinuousParameters& params) = 0;
 
+  // Returns true if the platform can queue utterances itself, so the next
+  // utterance can be handed to it before the current one ends.
+  virtual bool SupportsEnqueue();
+
+  // Like Speak, but the utterance is spoken after the ones already given to
+  // the platform, without changing the parameters of them.
+  virtual bool Enqueue(
+      int utterance_id,
+      const std::string& utterance,
+      const std::string& lang,
+      const VoiceData& voice,
+      const UtteranceContinuousParameters& params);
+
   // Stop speaking immediately and return true on success.
   virtual bool StopSpeaking() = 0;
 
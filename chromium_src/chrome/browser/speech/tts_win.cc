@@ -5,6 +5,8 @@
 #include <math.h>
 #include <sapi.h>
 
+#include <deque>
+
 #include "base/memory/singleton.h"
 #include "base/strings/string_number_conversions.h"
 #include "base/strings/utf_string_conversions.h"
@@ -26,6 +28,15 @@ class TtsPlatformImplWin : public TtsPlatformImpl {
       const VoiceData& voice,
       const UtteranceContinuousParameters& params);
 
+  virtual bool SupportsEnqueue() override;
+
+  virtual bool Enqueue(
+      int utterance_id,
+      const std::string& utterance,
+      const std::string& lang,
+      const VoiceData& voice,
+      const UtteranceContinuousParameters& params) override;
+
   virtual bool StopSpeaking();
 
   virtual void Pause();
@@ -45,15 +56,30 @@ class TtsPlatformImplWin : public TtsPlatformImpl {
   TtsPlatformImplWin();
   virtual ~TtsPlatformImplWin() {}
 
+  // An utterance given to SAPI, which speaks each one in its own stream.
+  struct QueuedUtterance {
+    int utterance_id;
+    int length;
+    int prefix_len;
+    ULONG stream_number;
+  };
+
+  // Adds the utterance to the queue of SAPI, the parameters are set in SAPI
+  // XML when |inline_params| is true so they only apply to this utterance.
+  bool SpeakInStream(int utterance_id,
+                     const std::string& utterance,
+                     const UtteranceContinuousParameters& params,
+                     bool inline_params);
+
   void OnSpeechEvent();
 
   base::win::ScopedComPtr<ISpVoice> speech_synthesizer_;
 
+  // The utterances being spoken or queued in SAPI, in the order they are
+  // spoken. The front one is the current utterance.
+  std::deque<QueuedUtterance> utterances_;
+
   // These apply to the current utterance only.
-  std::wstring utterance_;
-  int utterance_id_;
-  int prefix_len_;
-  ULONG stream_number_;
   int char_position_;
   bool paused_;
 
@@ -73,13 +99,39 @@ bool TtsPlatformImplWin::Speak(
     const std::string& lang,
     const VoiceData& voice,
     const UtteranceContinuousParameters& params) {
-  std::wstring prefix;
-  std::wstring suffix;
-
+  // TODO(dmazzoni): support languages other than the default: crbug.com/88059
   if (!speech_synthesizer_.get())
     return false;
 
-  // TODO(dmazzoni): support languages other than the default: crbug.com/88059
+  utterances_.clear();
+  char_position_ = 0;
+  return SpeakInStream(utterance_id, src_utterance, params, false);
+}
+
+bool TtsPlatformImplWin::SupportsEnqueue() {
+  return speech_synthesizer_.get() != NULL;
+}
+
+bool TtsPlatformImplWin::Enqueue(
+    int utterance_id,
+    const std::string& src_utterance,
+    const std::string& lang,
+    const VoiceData& voice,
+    const UtteranceContinuousParameters& params) {
+  if (!speech_synthesizer_.get() || utterances_.empty())
+    return false;
+
+  // Calling SetRate or SetVolume would change the utterance being spoken.
+  return SpeakInStream(utterance_id, src_utterance, params, true);
+}
+
+bool TtsPlatformImplWin::SpeakInStream(
+    int utterance_id,
+    const std::string& src_utterance,
+    const UtteranceContinuousParameters& params,
+    bool inline_params) {
+  std::wstring prefix;
+  std::wstring suffix;
 
   if (params.rate >= 0.0) {
     // Map our multiplicative range of 0.1x to 10.0x onto Microsoft's
@@ -87,7 +139,13 @@ bool TtsPlatformImplWin::Speak(
     //   0.1 -> -10
     //   1.0 -> 0
     //  10.0 -> 10
-    speech_synthesizer_->SetRate(static_cast<int32>(10 * log10(params.rate)));
+    int32 rate = static_cast<int32>(10 * log10(params.rate));
+    if (inline_params) {
+      prefix += L"<rate absspeed=\"" + base::IntToString16(rate) + L"\">";
+      suffix = L"</rate>" + suffix;
+    } else {
+      speech_synthesizer_->SetRate(rate);
+    }
   }
 
   if (params.pitch >= 0.0) {
@@ -96,35 +154,46 @@ bool TtsPlatformImplWin::Speak(
     // require xml.
     std::wstring pitch_value =
         base::IntToString16(static_cast<int>(params.pitch * 10 - 10));
-    prefix = L"<pitch absmiddle=\"" + pitch_value + L"\">";
-    suffix = L"</pitch>";
+    prefix += L"<pitch absmiddle=\"" + pitch_value + L"\">";
+    suffix = L"</pitch>" + suffix;
   }
 
   if (params.volume >= 0.0) {
     // The TTS api allows a range of 0 to 100 for speech volume.
-    speech_synthesizer_->SetVolume(static_cast<uint16>(params.volume * 100));
+    uint16 volume = static_cast<uint16>(params.volume * 100);
+    if (inline_params) {
+      prefix += L"<volume level=\"" + base::IntToString16(volume) + L"\">";
+      suffix = L"</volume>" + suffix;
+    } else {
+      speech_synthesizer_->SetVolume(volume);
+    }
   }
 
   // TODO(dmazzoni): convert SSML to SAPI xml. http://crbug.com/88072
 
-  utterance_ = base::UTF8ToWide(src_utterance);
-  utterance_id_ = utterance_id;
-  char_position_ = 0;
-  std::wstring merged_utterance = prefix + utterance_ + suffix;
-  prefix_len_ = prefix.size();
+  std::wstring utterance = base::UTF8ToWide(src_utterance);
+  std::wstring merged_utterance = prefix + utterance + suffix;
 
+  QueuedUtterance queued;
+  queued.utterance_id = utterance_id;
+  queued.length = utterance.size();
+  queued.prefix_len = prefix.size();
   HRESULT result = speech_synthesizer_->Speak(
       merged_utterance.c_str(),
       SPF_ASYNC,
-      &stream_number_);
-  return (result == S_OK);
+      &queued.stream_number);
+  if (result != S_OK)
+    return false;
+
+  utterances_.push_back(queued);
+  return true;
 }
 
 bool TtsPlatformImplWin::StopSpeaking() {
   if (speech_synthesizer_.get()) {
-    // Clear the stream number so that any further events relating to this
-    // utterance are ignored.
-    stream_number_ = 0;
+    // Forget the streams so that any further events relating to these
+    // utterances are ignored.
+    utterances_.clear();
 
     if (IsSpeaking()) {
       // Stop speech by speaking the empty string with the purge flag.
@@ -139,20 +208,21 @@ bool TtsPlatformImplWin::StopSpeaking() {
 }
 
 void TtsPlatformImplWin::Pause() {
-  if (speech_synthesizer_.get() && utterance_id_ && !paused_) {
+  if (speech_synthesizer_.get() && !utterances_.empty() && !paused_) {
     speech_synthesizer_->Pause();
     paused_ = true;
     TtsController::GetInstance()->OnTtsEvent(
-        utterance_id_, TTS_EVENT_PAUSE, char_position_, "");
+        utterances_.front().utterance_id, TTS_EVENT_PAUSE, char_position_, "");
   }
 }
 
 void TtsPlatformImplWin::Resume() {
-  if (speech_synthesizer_.get() && utterance_id_ && paused_) {
+  if (speech_synthesizer_.get() && !utterances_.empty() && paused_) {
     speech_synthesizer_->Resume();
     paused_ = false;
     TtsController::GetInstance()->OnTtsEvent(
-        utterance_id_, TTS_EVENT_RESUME, char_position_, "");
+        utterances_.front().utterance_id, TTS_EVENT_RESUME, char_position_,
+        "");
   }
 }
 
@@ -191,33 +261,46 @@ void TtsPlatformImplWin::OnSpeechEvent() {
   TtsController* controller = TtsController::GetInstance();
   SPEVENT event;
   while (S_OK == speech_synthesizer_->GetEvents(1, &event, NULL)) {
-    if (event.ulStreamNum != stream_number_)
+    // Streams are spoken in order, so the events of a stream mean the ones
+    // before it have ended.
+    while (!utterances_.empty() &&
+           utterances_.front().stream_number < event.ulStreamNum) {
+      utterances_.pop_front();
+      char_position_ = 0;
+    }
+    if (utterances_.empty() ||
+        utterances_.front().stream_number != event.ulStreamNum)
       continue;
 
+    const QueuedUtterance& current = utterances_.front();
+    int utterance_id = current.utterance_id;
     switch (event.eEventId) {
     case SPEI_START_INPUT_STREAM:
+      char_position_ = 0;
       controller->OnTtsEvent(
-          utterance_id_, TTS_EVENT_START, 0, std::string());
+          utterance_id, TTS_EVENT_START, 0, std::string());
       break;
     case SPEI_END_INPUT_STREAM:
-      char_position_ = utterance_.size();
+      char_position_ = current.length;
+      utterances_.pop_front();
       controller->OnTtsEvent(
-          utterance_id_, TTS_EVENT_END, char_position_, std::string());
+          utterance_id, TTS_EVENT_END, char_position_, std::string());
+      char_position_ = 0;
       break;
     case SPEI_TTS_BOOKMARK:
       controller->OnTtsEvent(
-          utterance_id_, TTS_EVENT_MARKER, char_position_, std::string());
+          utterance_id, TTS_EVENT_MARKER, char_position_, std::string());
       break;
     case SPEI_WORD_BOUNDARY:
-      char_position_ = static_cast<ULONG>(event.lParam) - prefix_len_;
+      char_position_ = static_cast<ULONG>(event.lParam) - current.prefix_len;
       controller->OnTtsEvent(
-          utterance_id_, TTS_EVENT_WORD, char_position_,
+          utterance_id, TTS_EVENT_WORD, char_position_,
           std::string());
       break;
     case SPEI_SENTENCE_BOUNDARY:
-      char_position_ = static_cast<ULONG>(event.lParam) - prefix_len_;
+      char_position_ = static_cast<ULONG>(event.lParam) - current.prefix_len;
       controller->OnTtsEvent(
-          utterance_id_, TTS_EVENT_SENTENCE, char_position_,
+          utterance_id, TTS_EVENT_SENTENCE, char_position_,
           std::string());
       break;
     }
@@ -225,10 +308,7 @@ void TtsPlatformImplWin::OnSpeechEvent() {
 }
 
 TtsPlatformImplWin::TtsPlatformImplWin()
-  : utterance_id_(0),
-    prefix_len_(0),
-    stream_number_(0),
-    char_position_(0),
+  : char_position_(0),
     paused_(false) {
   speech_synthesizer_.CreateInstance(CLSID_SpVoice);
   if (speech_synthesizer_.get()) {
@@ -191,6 +191,15 @@ IPC_MESSAGE_ROUTED2(PrintMsg_PrintPages,
 IPC_MESSAGE_ROUTED1(PrintMsg_PrintingDone,
                     bool /* success */)
 
+// Tells the render view to render the pages into a PDF with |settings|,
+// without asking for the print settings or printing it. When |pages_per_file|
+// is not 0, every |pages_per_file| pages are sent back as a separate PDF as
+// soon as they are rendered.
+IPC_MESSAGE_ROUTED3(PrintMsg_PrintToPDF,
+                    int /* request_id */,
+                    PrintMsg_PrintPages_Params /* settings */,
+                    int /* pages_per_file */)
+
 // Messages sent from the renderer to the browser.
 
 #if defined(OS_WIN)
@@ -239,3 +248,15 @@ IPC_MESSAGE_ROUTED0(PrintHostMsg_ShowInvalidPrinterSettingsError)
 // Tell the browser printing failed.
 IPC_MESSAGE_ROUTED1(PrintHostMsg_PrintingFailed,
                     int /* document cookie */)
+
+// Tell the browser printing ended before any page was printed, because the
+// user canceled it or it could not be started.
+IPC_MESSAGE_ROUTED0(PrintHostMsg_PrintingAborted)
+
+// Sends back a PDF rendered for PrintMsg_PrintToPDF, |data_size| is 0 when
+// it failed. |is_last| is true for the last PDF of the request.
+IPC_MESSAGE_ROUTED4(PrintHostMsg_DidPrintToPDF,
+                    int /* request_id */,
+                    base::SharedMemoryHandle /* pdf_data_handle */,
+                    uint32 /* data_size */,
+                    bool /* is_last */)
@@ -4,6 +4,7 @@
 
 #include "chrome/renderer/printing/print_web_view_helper.h"
 
+#include <algorithm>
 #include <string>
 
 #include "base/auto_reset.h"
@@ -22,8 +23,10 @@
 #include "content/public/renderer/render_thread.h"
 #include "content/public/renderer/render_view.h"
 #include "net/base/escape.h"
+#include "printing/metafile_skia_wrapper.h"
 #include "printing/pdf_metafile_skia.h"
 #include "printing/units.h"
+#include "skia/ext/platform_device.h"
 #include "third_party/WebKit/public/platform/WebSize.h"
 #include "third_party/WebKit/public/platform/WebURLRequest.h"
 #include "third_party/WebKit/public/web/WebConsoleMessage.h"
@@ -627,6 +630,8 @@ PrintWebViewHelper::PrintWebViewHelper(content::RenderView* render_view)
       is_scripted_printing_blocked_(false),
       notify_browser_of_print_failure_(true),
       print_for_preview_(false),
+      print_to_pdf_request_id_(-1),
+      print_to_pdf_pages_per_file_(0),
       print_node_in_progress_(false),
       is_loading_(false),
       is_scripted_preview_delayed_(false),
@@ -647,6 +652,7 @@ bool PrintWebViewHelper::OnMessageReceived(const IPC::Message& message) {
   IPC_BEGIN_MESSAGE_MAP(PrintWebViewHelper, message)
     IPC_MESSAGE_HANDLER(PrintMsg_PrintPages, OnPrintPages)
     IPC_MESSAGE_HANDLER(PrintMsg_PrintingDone, OnPrintingDone)
+    IPC_MESSAGE_HANDLER(PrintMsg_PrintToPDF, OnPrintToPDF)
     IPC_MESSAGE_UNHANDLED(handled = false)
     IPC_END_MESSAGE_MAP()
   return handled;
@@ -675,6 +681,33 @@ void PrintWebViewHelper::OnPrintPages(bool silent, bool print_background) {
   if (GetPrintFrame(&frame))
     Print(frame, blink::WebNode(), silent, print_background);
 }
+
+void PrintWebViewHelper::OnPrintToPDF(
+    int request_id,
+    const PrintMsg_PrintPages_Params& settings,
+    int pages_per_file) {
+  blink::WebView* web_view = render_view()->GetWebView();
+  if (prep_frame_view_ || !web_view || !web_view->mainFrame() ||
+      !PrintMsg_Print_Params_IsValid(settings.params)) {
+    Send(new PrintHostMsg_DidPrintToPDF(routing_id(), request_id,
+                                        base::SharedMemoryHandle(), 0, true));
+    return;
+  }
+
+  // The whole document is always printed, ignoring the selection.
+  ignore_css_margins_ = false;
+  print_to_pdf_request_id_ = request_id;
+  print_to_pdf_pages_per_file_ = std::max(pages_per_file, 0);
+  SetPrintPagesParams(settings);
+  print_pages_params_->params.selection_only = false;
+  if (!RenderPagesForPrint(web_view->mainFrame()->toWebLocalFrame(),
+                           blink::WebNode())) {
+    print_to_pdf_request_id_ = -1;
+    print_pages_params_.reset();
+    Send(new PrintHostMsg_DidPrintToPDF(routing_id(), request_id,
+                                        base::SharedMemoryHandle(), 0, true));
+  }
+}
 #endif  // !DISABLE_BASIC_PRINTING
 
 void PrintWebViewHelper::GetPageSizeAndContentAreaFromPageLayout(
@@ -735,20 +768,24 @@ void PrintWebViewHelper::Print(blink::WebLocalFrame* frame,
                                bool silent,
                                bool print_background) {
   // If still not finished with earlier print request simply ignore.
-  if (prep_frame_view_)
+  if (prep_frame_view_) {
+    Send(new PrintHostMsg_PrintingAborted(routing_id()));
     return;
+  }
 
   FrameReference frame_ref(frame);
 
   int expected_page_count = 0;
   if (!CalculateNumberOfPages(frame, node, &expected_page_count)) {
     DidFinishPrinting(FAIL_PRINT_INIT);
+    Send(new PrintHostMsg_PrintingAborted(routing_id()));
     return;  // Failed to init print page settings.
   }
 
   // Some full screen plugins can say they don't want to print.
   if (!expected_page_count) {
     DidFinishPrinting(FAIL_PRINT);
+    Send(new PrintHostMsg_PrintingAborted(routing_id()));
     return;
   }
 
@@ -756,6 +793,7 @@ void PrintWebViewHelper::Print(blink::WebLocalFrame* frame,
   if (!silent && !GetPrintSettingsFromUser(frame_ref.GetFrame(), node,
                                            expected_page_count)) {
     DidFinishPrinting(OK);  // Release resources and fail silently.
+    Send(new PrintHostMsg_PrintingAborted(routing_id()));
     return;
   }
 
@@ -790,6 +828,18 @@ void PrintWebViewHelper::DidFinishPrinting(PrintingResult result) {
 }
 
 void PrintWebViewHelper::OnFramePreparedForPrintPages() {
+  if (print_to_pdf_request_id_ >= 0) {
+    int request_id = print_to_pdf_request_id_;
+    if (!PrintPagesToPDF())
+      Send(new PrintHostMsg_DidPrintToPDF(routing_id(), request_id,
+                                          base::SharedMemoryHandle(), 0,
+                                          true));
+    print_to_pdf_request_id_ = -1;
+    prep_frame_view_.reset();
+    print_pages_params_.reset();
+    return;
+  }
+
   PrintPages();
   FinishFramePrinting();
 }
@@ -826,6 +876,87 @@ void PrintWebViewHelper::FinishFramePrinting() {
   prep_frame_view_.reset();
 }
 
+bool PrintWebViewHelper::PrintPagesToPDF() {
+  if (!prep_frame_view_)
+    return false;
+  prep_frame_view_->StartPrinting();
+
+  int page_count = prep_frame_view_->GetExpectedPageCount();
+  const std::vector<int>& pages = print_pages_params_->pages;
+  std::vector<int> printed_pages;
+  if (pages.empty()) {
+    for (int i = 0; i < page_count; ++i)
+      printed_pages.push_back(i);
+  } else {
+    for (size_t i = 0; i < pages.size(); ++i)
+      if (pages[i] >= 0 && pages[i] < page_count)
+        printed_pages.push_back(pages[i]);
+  }
+  if (printed_pages.empty())
+    return false;
+
+  // Only the pages of one file are kept in memory at a time, each file is
+  // sent as soon as it is rendered.
+  size_t pages_per_file = print_to_pdf_pages_per_file_ > 0 ?
+      print_to_pdf_pages_per_file_ : printed_pages.size();
+  for (size_t i = 0; i < printed_pages.size(); i += pages_per_file) {
+    size_t end = std::min(i + pages_per_file, printed_pages.size());
+    std::vector<int> pages(printed_pages.begin() + i,
+                           printed_pages.begin() + end);
+    if (!SendPagesAsPDF(pages, end == printed_pages.size()))
+      return false;
+  }
+  return true;
+}
+
+bool PrintWebViewHelper::SendPagesAsPDF(const std::vector<int>& pages,
+                                        bool is_last) {
+  PdfMetafileSkia metafile;
+  if (!metafile.Init())
+    return false;
+  for (size_t i = 0; i < pages.size(); ++i)
+    RenderPageForPDF(prep_frame_view_->frame(), pages[i], &metafile);
+
+  // blink::printEnd() for PDF should be called before metafile is closed.
+  if (is_last)
+    FinishFramePrinting();
+  if (!metafile.FinishDocument())
+    return false;
+
+  base::SharedMemoryHandle handle;
+  if (!CopyMetafileDataToSharedMem(&metafile, &handle))
+    return false;
+  Send(new PrintHostMsg_DidPrintToPDF(routing_id(), print_to_pdf_request_id_,
+                                      handle, metafile.GetDataSize(),
+                                      is_last));
+  return true;
+}
+
+void PrintWebViewHelper::RenderPageForPDF(blink::WebFrame* frame,
+                                          int page_number,
+                                          PdfMetafileSkia* metafile) {
+  const PrintMsg_Print_Params& params = print_pages_params_->params;
+  PageSizeMargins page_layout_in_points;
+  double scale_factor = 1.0f;
+  ComputePageLayoutInPointsForCss(frame, page_number, params,
+                                  ignore_css_margins_, &scale_factor,
+                                  &page_layout_in_points);
+  gfx::Size page_size;
+  gfx::Rect content_area;
+  GetPageSizeAndContentAreaFromPageLayout(page_layout_in_points, &page_size,
+                                          &content_area);
+
+  skia::PlatformCanvas* canvas = metafile->GetVectorCanvasForNewPage(
+      page_size, content_area, scale_factor);
+  if (!canvas)
+    return;
+
+  MetafileSkiaWrapper::SetMetafileOnCanvas(*canvas, metafile);
+  RenderPageContent(frame, page_number, content_area, content_area,
+                    scale_factor, canvas);
+  metafile->FinishPage();
+}
+
 #if defined(OS_MACOSX)
 bool PrintWebViewHelper::PrintPagesNative(blink::WebFrame* frame,
                                           int page_count) {
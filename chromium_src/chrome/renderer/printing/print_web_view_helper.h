@@ -87,6 +87,9 @@ class PrintWebViewHelper
 #if !defined(DISABLE_BASIC_PRINTING)
   void OnPrintPages(bool silent, bool print_background);
   void OnPrintingDone(bool success);
+  void OnPrintToPDF(int request_id,
+                    const PrintMsg_PrintPages_Params& settings,
+                    int pages_per_file);
 #endif  // !DISABLE_BASIC_PRINTING
 
   // Get |page_size| and |content_area| information from
@@ -130,6 +133,12 @@ class PrintWebViewHelper
 
   void OnFramePreparedForPrintPages();
   void PrintPages();
+  // Renders the pages into PDFs and sends them back for PrintMsg_PrintToPDF.
+  bool PrintPagesToPDF();
+  bool SendPagesAsPDF(const std::vector<int>& pages, bool is_last);
+  void RenderPageForPDF(blink::WebFrame* frame,
+                        int page_number,
+                        PdfMetafileSkia* metafile);
   bool PrintPagesNative(blink::WebFrame* frame, int page_count);
   void FinishFramePrinting();
 
@@ -213,6 +222,10 @@ class PrintWebViewHelper
   // True, when printing from print preview.
   bool print_for_preview_;
 
+  // The PrintMsg_PrintToPDF being handled, -1 when printing normally.
+  int print_to_pdf_request_id_;
+  int print_to_pdf_pages_per_file_;
+
   bool print_node_in_progress_;
   bool is_loading_;
   bool is_scripted_preview_delayed_;
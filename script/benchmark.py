@@ -0,0 +1,51 @@
+#!/usr/bin/env python
+
+import argparse
+import os
+import subprocess
+import sys
+
+
+SOURCE_ROOT = os.path.abspath(os.path.dirname(os.path.dirname(__file__)))
+
+
+def main():
+  os.chdir(SOURCE_ROOT)
+  args, suite_args = parse_args()
+
+  if sys.platform == 'darwin':
+    atom_shell = os.path.join(SOURCE_ROOT, 'out', args.configuration,
+                              'Atom.app', 'Contents', 'MacOS', 'Atom')
+  elif sys.platform == 'win32':
+    atom_shell = os.path.join(SOURCE_ROOT, 'out', args.configuration,
+                              'atom.exe')
+  else:
+    atom_shell = os.path.join(SOURCE_ROOT, 'out', args.configuration, 'atom')
+
+  command = [atom_shell, os.path.join('benchmark', args.suite)]
+  if args.output:
+    command.append('--output=' + os.path.abspath(args.output))
+  command += suite_args
+  subprocess.check_call(command)
+
+
+def parse_args():
+  parser = argparse.ArgumentParser(description='Run the benchmarks')
+  parser.add_argument('suite',
+                      help='Which benchmark to run',
+                      choices=['asar', 'converters', 'ipc', 'memory',
+                               'protocol', 'startup'],
+                      nargs='?', default='ipc')
+  parser.add_argument('-c', '--configuration',
+                      help='Build configuration to benchmark',
+                      default='Release', required=False)
+  parser.add_argument('-o', '--output',
+                      help='Write the JSON report into a file instead of '
+                           'printing it',
+                      required=False)
+  # The other arguments are options of the suite.
+  return parser.parse_known_args()
+
+
+if __name__ == '__main__':
+  sys.exit(main())
@@ -87,7 +87,12 @@ def main():
   force_build()
   download_libchromiumcontent_symbols(args.url)
   create_symbols()
+  create_code_cache()
   copy_binaries()
+  if args.locales:
+    strip_locales(args.locales.split(','))
+  if args.strip_resources:
+    strip_resources(os.path.abspath(args.strip_resources))
   copy_chromedriver()
   copy_license()
 
@@ -108,6 +113,13 @@ def parse_args():
                       'libchromiumcontent\'s script/upload script',
                       default=BASE_URL,
                       required=False)
+  parser.add_argument('--locales',
+                      help='Only ship these locales, separated by comma',
+                      required=False)
+  parser.add_argument('--strip-resources',
+                      help='A file listing the IDs of resources that should '
+                      'be removed from content_shell.pak, one per line',
+                      required=False)
   return parser.parse_args()
 
 
@@ -126,6 +138,41 @@ def copy_binaries():
                     symlinks=True)
 
 
+def strip_locales(locales):
+  if TARGET_PLATFORM == 'darwin':
+    locale_dir = os.path.join(DIST_DIR, 'Atom.app', 'Contents', 'Resources')
+    suffix = '.lproj'
+  else:
+    locale_dir = os.path.join(DIST_DIR, 'locales')
+    suffix = '.pak'
+
+  # The locale directories on OS X use '_' instead of '-', and 'en' for
+  # 'en-US', see tools/mac/apply_locales.py.
+  keep = set(locales)
+  if TARGET_PLATFORM == 'darwin':
+    keep = set(['en' if l == 'en-US' else l.replace('-', '_') for l in keep])
+  for name in os.listdir(locale_dir):
+    base, ext = os.path.splitext(name)
+    if ext != suffix or base in keep:
+      continue
+    path = os.path.join(locale_dir, name)
+    if os.path.isdir(path):
+      rm_rf(path)
+    else:
+      os.remove(path)
+
+
+def strip_resources(ids_file):
+  if TARGET_PLATFORM == 'darwin':
+    pak = os.path.join(DIST_DIR, 'Atom.app', 'Contents', 'Frameworks',
+                       'Atom Framework.framework', 'Resources',
+                       'content_shell.pak')
+  else:
+    pak = os.path.join(DIST_DIR, 'content_shell.pak')
+  strip_pak = os.path.join(SOURCE_ROOT, 'tools', 'strip_pak.py')
+  execute([sys.executable, strip_pak, pak, ids_file])
+
+
 def copy_chromedriver():
   build = os.path.join(SOURCE_ROOT, 'script', 'build.py')
   execute([sys.executable, build, '-c', 'Release', '-t', 'copy_chromedriver'])
@@ -185,6 +232,11 @@ def create_symbols():
                   symlinks=True)
 
 
+def create_code_cache():
+  build = os.path.join(SOURCE_ROOT, 'script', 'build.py')
+  execute([sys.executable, build, '-c', 'Release', '-t', 'atom_code_cache'])
+
+
 def create_dist_zip():
   dist_name = 'atom-shell-{0}-{1}-{2}.zip'.format(ATOM_SHELL_VERSION,
                                                   TARGET_PLATFORM, DIST_ARCH)
@@ -0,0 +1,5 @@
+// Keeps the main process busy for |ms| milliseconds.
+exports.run = function(ms) {
+  var start = Date.now();
+  while (Date.now() - start < ms) {}
+};
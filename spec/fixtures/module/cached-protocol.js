@@ -0,0 +1,14 @@
+var protocol = require('protocol');
+
+var calls = 0;
+
+exports.register = function(scheme, data) {
+  protocol.registerProtocol(scheme, function(request) {
+    calls++;
+    return new protocol.RequestStringJob({data: data, immutable: true});
+  }, {cache: true});
+};
+
+exports.getCalls = function() {
+  return calls;
+};
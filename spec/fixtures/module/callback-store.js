@@ -0,0 +1,13 @@
+var callbacks = [];
+
+exports.add = function(callback) {
+  callbacks.push(callback);
+};
+
+exports.call = function(index) {
+  callbacks[index]();
+};
+
+exports.clear = function() {
+  callbacks = [];
+};
@@ -0,0 +1,16 @@
+function Counter() {
+}
+
+Counter.prototype.one = function() {
+  return 1;
+};
+
+exports.create = function() {
+  return new Counter;
+};
+
+exports.addMethod = function() {
+  Counter.prototype.two = function() {
+    return 2;
+  };
+};
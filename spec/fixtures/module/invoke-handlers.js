@@ -0,0 +1,21 @@
+// Loaded with remote.require, so the handlers run in the browser process and
+// can return values and throw, which callbacks from the renderer can not.
+var ipc = require('ipc');
+
+exports.register = function() {
+  ipc.handle('invoke-add', function(event, a, b) {
+    return a + b;
+  });
+  ipc.handle('invoke-throw', function() {
+    throw new Error('failed');
+  });
+  ipc.handle('invoke-echo', function(event, value) {
+    return value;
+  });
+};
+
+exports.unregister = function() {
+  ipc.removeHandler('invoke-add');
+  ipc.removeHandler('invoke-throw');
+  ipc.removeHandler('invoke-echo');
+};
@@ -0,0 +1,3 @@
+function onmessage(a, b) {
+  reply('worker-reply', a + b);
+}
@@ -0,0 +1,5 @@
+var path = require('path');
+
+onmessage = function(a, b) {
+  postMessage(path.join(a, b));
+}
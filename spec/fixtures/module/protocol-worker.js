@@ -0,0 +1,3 @@
+function handleRequest(request) {
+  return {mimeType: 'text/plain', data: request.method + ' ' + request.url};
+}
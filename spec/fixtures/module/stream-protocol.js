@@ -0,0 +1,29 @@
+var protocol = require('protocol');
+
+exports.register = function(scheme, chunks) {
+  protocol.registerProtocol(scheme, function(request) {
+    var job = new protocol.RequestStreamJob({mimeType: 'text/plain'});
+    var i = 0;
+    (function writeNext() {
+      if (i == chunks.length)
+        return job.end();
+      job.write(chunks[i++]);
+      setTimeout(writeNext, 10);
+    })();
+    return job;
+  });
+};
+
+// Writes |chunk| after the request has been cancelled, and calls |callback|
+// with whether the job emitted "abort" and the write callback was called.
+exports.registerAborted = function(scheme, chunk, callback) {
+  protocol.registerProtocol(scheme, function(request) {
+    var job = new protocol.RequestStreamJob({mimeType: 'text/plain'});
+    var aborted = false;
+    job.on('abort', function() { aborted = true; });
+    setTimeout(function() {
+      job.write(chunk, function() { callback(aborted && job.aborted); });
+    }, 100);
+    return job;
+  });
+};
@@ -0,0 +1,3 @@
+function onmessage(a, b) {
+  postMessage('sum', a + b);
+}
@@ -0,0 +1,9 @@
+var path = require('path');
+
+function onmessage(file) {
+  if (file == 'exit')
+    process.exit(0);
+  setTimeout(function() {
+    postMessage(path.basename(file));
+  }, 0);
+}
@@ -0,0 +1,152 @@
+#!/usr/bin/env python
+
+# Rewrites the JSON header of an asar archive into the binary header format
+# understood by asar::Archive, see BinaryHeaderEntry in
+# atom/common/asar/archive.cc for the layout.
+#
+# With --compress, packed files that shrink are stored as zlib streams.
+# With --integrity, the SHA-256 hash of the stored bytes of each packed file is
+# written into the header.
+
+import binascii
+import hashlib
+import json
+import struct
+import sys
+import zlib
+
+
+BINARY_HEADER_MAGIC = 0x42525341  # "ASRB"
+BINARY_HEADER_VERSION = 2
+
+FLAG_DIRECTORY = 1 << 0
+FLAG_LINK      = 1 << 1
+FLAG_UNPACKED  = 1 << 2
+FLAG_INTEGRITY = 1 << 3
+
+OPTIONS = ['--compress', '--integrity']
+
+
+def main():
+  args = sys.argv[1:]
+  compress = '--compress' in args
+  integrity = '--integrity' in args
+  for archive in args:
+    if archive not in OPTIONS:
+      convert(archive, compress, integrity)
+
+
+def convert(archive, compress, integrity):
+  with open(archive, 'rb') as f:
+    data = f.read()
+
+  # The size pickle: uint32 payload size, uint32 header size.
+  header_size = struct.unpack('<I', data[4:8])[0]
+  header_pickle = data[8:8 + header_size]
+  content = data[8 + header_size:]
+
+  magic = struct.unpack('<I', header_pickle[4:8])[0]
+  if magic == BINARY_HEADER_MAGIC:
+    return
+
+  # The header pickle: uint32 payload size, int32 string length, string.
+  length = struct.unpack('<i', header_pickle[4:8])[0]
+  header = json.loads(header_pickle[8:8 + length].decode('utf-8'))
+
+  entries = []
+  collect_entries(header['files'], [], entries)
+  entries.sort(key=lambda entry: entry['components'])
+
+  if compress:
+    content = compress_entries(entries, content)
+
+  for entry in entries:
+    if 'offset' not in entry:
+      continue
+    if integrity:
+      size = entry.get('compressed_size', entry['size'])
+      data = content[entry['offset']:entry['offset'] + size]
+      entry['hash'] = hashlib.sha256(data).digest()
+
+  strings = bytearray()
+  records = bytearray()
+  for entry in entries:
+    path = '/'.join(entry['components']).encode('utf-8')
+    path_offset = len(strings)
+    strings += path
+    link = entry.get('link', u'').encode('utf-8')
+    link_offset = len(strings)
+    strings += link
+    hash_offset = 0
+    if 'hash' in entry:
+      entry['flags'] |= FLAG_INTEGRITY
+      hash_offset = len(strings)
+      strings += entry['hash']
+    records += struct.pack('<IIIIIIQII', path_offset, len(path),
+                           link_offset, len(link), entry['flags'],
+                           entry.get('size', 0), entry.get('offset', 0),
+                           entry.get('compressed_size', 0), hash_offset)
+
+  payload = struct.pack('<IIII', BINARY_HEADER_MAGIC, BINARY_HEADER_VERSION,
+                        len(entries), len(strings))
+  payload += bytes(records) + bytes(strings)
+  payload += b'\0' * (-len(payload) % 4)
+
+  # File offsets are relative to the end of header, so content can be kept
+  # untouched.
+  header_pickle = struct.pack('<I', len(payload)) + payload
+  size_pickle = struct.pack('<II', 4, len(header_pickle))
+  with open(archive, 'wb') as f:
+    f.write(size_pickle)
+    f.write(header_pickle)
+    f.write(content)
+
+
+def compress_entries(entries, content):
+  packed = [entry for entry in entries if 'offset' in entry]
+  packed.sort(key=lambda entry: entry['offset'])
+  output = bytearray()
+  for entry in packed:
+    size = entry.get('compressed_size', entry['size'])
+    data = content[entry['offset']:entry['offset'] + size]
+    entry['offset'] = len(output)
+    if 'compressed_size' in entry:
+      output += data
+      continue
+    compressed = zlib.compress(data, 9)
+    if len(compressed) < len(data):
+      # The hash is for the stored bytes, which have changed.
+      entry.pop('hash', None)
+      entry['compressed_size'] = len(compressed)
+      output += compressed
+    else:
+      output += data
+  return bytes(output)
+
+
+def collect_entries(files, parent, entries):
+  for name, node in files.items():
+    components = parent + [name]
+    entry = {'components': components, 'flags': 0}
+    if 'link' in node:
+      entry['flags'] |= FLAG_LINK
+      entry['link'] = node['link']
+    elif 'files' in node:
+      entry['flags'] |= FLAG_DIRECTORY
+      collect_entries(node['files'], components, entries)
+    else:
+      entry['size'] = node['size']
+      if node.get('unpacked', False):
+        entry['flags'] |= FLAG_UNPACKED
+      else:
+        entry['offset'] = int(node['offset'])
+        if 'compressedSize' in node:
+          entry['compressed_size'] = node['compressedSize']
+        integrity = node.get('integrity', {})
+        if integrity.get('algorithm') == 'SHA256':
+          entry['hash'] = binascii.unhexlify(integrity['hash'])
+    entries.append(entry)
+
+
+if __name__ == '__main__':
+  sys.exit(main())
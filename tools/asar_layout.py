@@ -0,0 +1,158 @@
+#!/usr/bin/env python
+
+# Lays out the packed files of an asar archive in the order they are first
+# read at startup, so a cold start reads the archive mostly sequentially.
+#
+#   asar_layout.py order <manifest> <archive> <order file>
+#     Turns the ranges recorded for <archive> in a prefetch manifest, see
+#     --record-asar-prefetch-manifest, into the list of the files read, in
+#     first-access order. The list has one path per line and, unlike the
+#     offsets in the manifest, stays valid when the archive is rebuilt.
+#
+#   asar_layout.py apply <order file> <archive>
+#     Moves the content of the files in the list to the beginning of the
+#     archive in that order, the other files follow in their original order.
+#
+# Only archives with the binary header written by asar_binary_header.py are
+# supported. The stored bytes of each file are moved untouched, so compressed
+# files and integrity hashes stay valid, but manifests recorded before a
+# relayout no longer match the archive and should be recorded again.
+
+import io
+import os
+import struct
+import sys
+
+
+BINARY_HEADER_MAGIC = 0x42525341  # "ASRB"
+
+FLAG_DIRECTORY = 1 << 0
+FLAG_LINK      = 1 << 1
+FLAG_UNPACKED  = 1 << 2
+
+RECORD_FORMAT = '<IIIIIIQII'
+RECORD_SIZE = struct.calcsize(RECORD_FORMAT)
+
+
+def main():
+  if len(sys.argv) != 5 and len(sys.argv) != 4:
+    print('Usage: asar_layout.py order <manifest> <archive> <order file>\n'
+          '       asar_layout.py apply <order file> <archive>')
+    return 1
+
+  command = sys.argv[1]
+  if command == 'order' and len(sys.argv) == 5:
+    write_order(sys.argv[2], sys.argv[3], sys.argv[4])
+  elif command == 'apply' and len(sys.argv) == 4:
+    apply_order(sys.argv[2], sys.argv[3])
+  else:
+    print('Unknown command: ' + command)
+    return 1
+
+
+def write_order(manifest, archive, order_file):
+  with open(archive, 'rb') as f:
+    header_end, entries, _ = read_archive(f.read())
+  by_offset = {}
+  for entry in entries:
+    if is_packed(entry):
+      by_offset[header_end + entry['offset']] = entry['path']
+
+  # Archives are recorded with their full path at runtime, which is hardly
+  # the path of the build, so they are matched by name.
+  name = os.path.basename(archive)
+  paths = []
+  seen = set()
+  with io.open(manifest, 'r', encoding='utf-8') as f:
+    for line in f:
+      fields = line.rstrip('\n').split(' ', 2)
+      if len(fields) != 3 or os.path.basename(fields[2]) != name:
+        continue
+      path = by_offset.get(int(fields[0]))
+      if path is not None and path not in seen:
+        seen.add(path)
+        paths.append(path)
+
+  with io.open(order_file, 'w', encoding='utf-8') as f:
+    for path in paths:
+      f.write(path + u'\n')
+
+
+def apply_order(order_file, archive):
+  with io.open(order_file, 'r', encoding='utf-8') as f:
+    order = [line.rstrip('\n') for line in f if line.strip()]
+
+  with open(archive, 'rb') as f:
+    data = f.read()
+  header_end, entries, records_start = read_archive(data)
+  content = data[header_end:]
+
+  rank = {}
+  for path in order:
+    rank.setdefault(path, len(rank))
+  packed = [entry for entry in entries if is_packed(entry)]
+  packed.sort(key=lambda entry: (rank.get(entry['path'], len(rank)),
+                                 entry['offset']))
+
+  output = bytearray()
+  for entry in packed:
+    start = entry['offset']
+    output += content[start:start + entry['stored_size']]
+    entry['offset'] = len(output) - entry['stored_size']
+
+  # Only the offsets change, so the header keeps its size.
+  header = bytearray(data[:header_end])
+  for entry in entries:
+    record = list(entry['record'])
+    record[6] = entry['offset']
+    start = records_start + entry['index'] * RECORD_SIZE
+    header[start:start + RECORD_SIZE] = struct.pack(RECORD_FORMAT, *record)
+
+  with open(archive, 'wb') as f:
+    f.write(bytes(header))
+    f.write(bytes(output))
+
+
+# Returns the offset of the content, the entries and where their records
+# start in the file.
+def read_archive(data):
+  # The size pickle: uint32 payload size, uint32 header size.
+  header_size = struct.unpack('<I', data[4:8])[0]
+  header_end = 8 + header_size
+
+  # The header pickle: uint32 payload size, then the binary header.
+  payload_start = 8 + 4
+  magic, _, count, strings_size = struct.unpack(
+      '<IIII', data[payload_start:payload_start + 16])
+  if magic != BINARY_HEADER_MAGIC:
+    raise Exception('The archive has no binary header, run '
+                    'asar_binary_header.py first')
+
+  records_start = payload_start + 16
+  strings_start = records_start + count * RECORD_SIZE
+  strings = data[strings_start:strings_start + strings_size]
+
+  entries = []
+  for index in range(count):
+    start = records_start + index * RECORD_SIZE
+    record = struct.unpack(RECORD_FORMAT, data[start:start + RECORD_SIZE])
+    (path_offset, path_size, _, _, flags, size, offset, compressed_size,
+     _) = record
+    path = strings[path_offset:path_offset + path_size].decode('utf-8')
+    entries.append({
+      'index': index,
+      'record': record,
+      'path': path,
+      'flags': flags,
+      'offset': offset,
+      'stored_size': compressed_size or size,
+    })
+  return header_end, entries, records_start
+
+
+def is_packed(entry):
+  return not entry['flags'] & (FLAG_DIRECTORY | FLAG_LINK | FLAG_UNPACKED)
+
+
+if __name__ == '__main__':
+  sys.exit(main())
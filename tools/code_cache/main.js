@@ -0,0 +1,34 @@
+var app = require('app');
+var ipc = require('ipc');
+var BrowserWindow = require('browser-window');
+
+// Load every built-in module so all of them are compiled once, some of them
+// are not available on all platforms.
+var modules = [
+  'atom-delegate', 'auto-updater', 'clipboard', 'content-tracing',
+  'crash-reporter', 'dialog', 'global-shortcut', 'menu', 'menu-item',
+  'native-image', 'power-monitor', 'protocol', 'screen', 'shell', 'tray',
+  'web-contents', 'worker',
+];
+
+var window = null;
+
+app.on('window-all-closed', function() {
+  app.quit();
+});
+
+app.on('ready', function() {
+  modules.forEach(function(name) {
+    try {
+      require(name);
+    } catch (e) {
+    }
+  });
+
+  // The renderer does the same with its own modules, and tells us when done.
+  ipc.on('done', function() {
+    window.close();
+  });
+  window = new BrowserWindow({show: false});
+  window.loadUrl('file://' + __dirname + '/index.html');
+});
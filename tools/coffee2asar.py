@@ -11,12 +11,20 @@ SOURCE_ROOT = os.path.dirname(os.path.dirname(__file__))
 
 
 def main():
-  archive = sys.argv[1]
-  coffee_source_files = sys.argv[2:]
+  args = sys.argv[1:]
+  # The order file for asar_layout.py, an empty one means no relayout.
+  layout = ''
+  if args[0].startswith('--layout='):
+    layout = args.pop(0)[len('--layout='):]
+  archive = args[0]
+  coffee_source_files = args[1:]
 
   output_dir = tempfile.mkdtemp()
   compile_coffee(coffee_source_files, output_dir)
   call_asar(archive, output_dir)
+  call_binary_header(archive)
+  if layout:
+    call_layout(layout, archive)
   shutil.rmtree(output_dir)
 
 
@@ -39,6 +47,16 @@ def call_asar(archive, output_dir):
   subprocess.check_call([find_node(), asar, 'pack', js_dir, archive])
 
 
+def call_binary_header(archive):
+  binary_header = os.path.join(SOURCE_ROOT, 'tools', 'asar_binary_header.py')
+  subprocess.check_call([sys.executable, binary_header, archive])
+
+
+def call_layout(order_file, archive):
+  layout = os.path.join(SOURCE_ROOT, 'tools', 'asar_layout.py')
+  subprocess.check_call([sys.executable, layout, 'apply', order_file, archive])
+
+
 def find_node():
   WINDOWS_NODE_PATHs = [
     'C:/Program Files (x86)/nodejs',
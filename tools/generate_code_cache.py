@@ -0,0 +1,43 @@
+#!/usr/bin/env python
+
+import argparse
+import os
+import shutil
+import subprocess
+import sys
+
+
+SOURCE_ROOT = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+
+
+def main():
+  args = parse_args()
+
+  # The caches are keyed by the content of scripts, remove the ones of old
+  # scripts so they would not be shipped.
+  if os.path.exists(args.cache_dir):
+    shutil.rmtree(args.cache_dir)
+
+  # Run the built-in scripts of both browser and renderer processes once, the
+  # caches produced by the V8 linked in the binary are written to |cache_dir|.
+  app = os.path.join(SOURCE_ROOT, 'tools', 'code_cache')
+  subprocess.check_call([args.binary, app,
+                         '--js-code-cache-dir=' + args.cache_dir])
+
+  if not os.path.isdir(args.cache_dir):
+    sys.stderr.write('No code cache is generated in ' + args.cache_dir + '\n')
+    return 1
+
+
+def parse_args():
+  parser = argparse.ArgumentParser(
+      description='Generate V8 code cache of built-in scripts')
+  parser.add_argument('--binary', help='Path to the atom-shell binary',
+                      required=True)
+  parser.add_argument('--cache-dir', help='Where to write the code cache',
+                      required=True)
+  return parser.parse_args()
+
+
+if __name__ == '__main__':
+  sys.exit(main())
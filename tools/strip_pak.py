@@ -0,0 +1,80 @@
+#!/usr/bin/env python
+
+# usage: strip_pak.py pak_file ids_file
+#
+# Removes the resources listed in ids_file, one numeric ID per line, from the
+# .pak file in place. Lines starting with '#' are ignored.
+
+import struct
+import sys
+
+
+PAK_VERSION = 4
+HEADER_FORMAT = '<IIB'
+ENTRY_FORMAT = '<HI'
+
+
+def main():
+  pak_file = sys.argv[1]
+  ids = read_ids(sys.argv[2])
+
+  encoding, resources = read_pak(pak_file)
+  kept = [(i, data) for i, data in resources if i not in ids]
+  write_pak(pak_file, encoding, kept)
+
+  saved = sum(len(data) for i, data in resources if i in ids)
+  print 'Stripped {0} resources ({1} bytes) from {2}'.format(
+      len(resources) - len(kept), saved, pak_file)
+
+
+def read_ids(ids_file):
+  ids = set()
+  with open(ids_file, 'r') as f:
+    for line in f:
+      line = line.strip()
+      if line and not line.startswith('#'):
+        ids.add(int(line))
+  return ids
+
+
+def read_pak(pak_file):
+  with open(pak_file, 'rb') as f:
+    content = f.read()
+
+  header_size = struct.calcsize(HEADER_FORMAT)
+  entry_size = struct.calcsize(ENTRY_FORMAT)
+  version, count, encoding = struct.unpack_from(HEADER_FORMAT, content)
+  if version != PAK_VERSION:
+    raise Exception('Unsupported pak version {0}'.format(version))
+
+  # There is one more entry at the end to mark where the last resource ends.
+  entries = []
+  for i in range(count + 1):
+    entries.append(struct.unpack_from(ENTRY_FORMAT, content,
+                                      header_size + i * entry_size))
+  resources = []
+  for i in range(count):
+    resource_id, offset = entries[i]
+    resources.append((resource_id, content[offset:entries[i + 1][1]]))
+  return encoding, resources
+
+
+def write_pak(pak_file, encoding, resources):
+  header_size = struct.calcsize(HEADER_FORMAT)
+  entry_size = struct.calcsize(ENTRY_FORMAT)
+  offset = header_size + (len(resources) + 1) * entry_size
+
+  index = [struct.pack(HEADER_FORMAT, PAK_VERSION, len(resources), encoding)]
+  for resource_id, data in resources:
+    index.append(struct.pack(ENTRY_FORMAT, resource_id, offset))
+    offset += len(data)
+  index.append(struct.pack(ENTRY_FORMAT, 0, offset))
+
+  with open(pak_file, 'wb') as f:
+    f.write(''.join(index))
+    for resource_id, data in resources:
+      f.write(data)
+
+
+if __name__ == '__main__':
+  sys.exit(main())